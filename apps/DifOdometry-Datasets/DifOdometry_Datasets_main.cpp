@@ -35,6 +35,39 @@ const char *default_cfg_txt =
 	//"filename = .../file.rawlog \n";
 
 
+// Mean runtime per frame, in total and for each coarse-to-fine level (see CDifodo::level_execution_time)
+struct TRuntimeStats
+{
+	unsigned int num_frames;
+	double total;
+	vector<double> levels;
+
+	TRuntimeStats() : num_frames(0), total(0) {}
+
+	void add(const CDifodoDatasets &odo)
+	{
+		num_frames++;
+		total += odo.execution_time;
+		levels.resize(odo.level_execution_time.size(),0);
+		for (unsigned int i=0; i<levels.size(); i++)
+			levels[i] += odo.level_execution_time[i];
+	}
+
+	void print(const CDifodoDatasets &odo) const
+	{
+		if (!num_frames) return;
+		unsigned int rows, cols;
+		odo.getRowsAndCols(rows,cols);
+		printf("\n Mean Difodo runtime of %u frames: %.02f ms", num_frames, total/num_frames);
+		for (unsigned int i=0; i<levels.size(); i++)
+		{
+			const unsigned int s = 1 << (levels.size()-i-1);
+			printf("\n   Level %u (%ux%u): %.02f ms", i, cols/s, rows/s, levels[i]/num_frames);
+		}
+		printf("\n");
+	}
+};
+
 // ------------------------------------------------------
 //						MAIN
 // ------------------------------------------------------
@@ -114,6 +147,7 @@ int main(int num_arg, char *argv[])
 
 		int pushed_key = 0;
 		bool working = 0, stop = 0;
+		TRuntimeStats runtime_stats;
 
 		//Necessary step before starting
 		odo.reset();
@@ -134,6 +168,7 @@ int main(int num_arg, char *argv[])
 				{
 					working = 0;
 					cout << endl << "End of dataset.";
+					runtime_stats.print(odo);
 					if (odo.f_res.is_open())
 						odo.f_res.close();
 				}
@@ -145,6 +180,7 @@ int main(int num_arg, char *argv[])
 						odo.writeTrajectoryFile();
 
 					cout << endl << "Difodo runtime(ms): " << odo.execution_time;
+					runtime_stats.add(odo);
 					odo.updateScene();
 				}
 
@@ -170,6 +206,7 @@ int main(int num_arg, char *argv[])
 				{
 					working = 0;
 					cout << endl << "End of dataset.";
+					runtime_stats.print(odo);
 					if (odo.f_res.is_open())
 						odo.f_res.close();
 				}
@@ -181,6 +218,7 @@ int main(int num_arg, char *argv[])
 						odo.writeTrajectoryFile();
 
 					cout << endl << "Difodo runtime(ms): " << odo.execution_time;
+					runtime_stats.add(odo);
 					odo.updateScene();
 				}
 			}
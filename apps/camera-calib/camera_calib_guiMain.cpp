@@ -377,6 +377,11 @@ camera_calib_guiDialog::camera_calib_guiDialog(wxWindow* parent,wxWindowID id)
 
 	camera_params.intrinsicParams(0,0) = 0; // Indicate calib didn't run yet.
 
+#if USE_EXTERNAL_STORAGE_IMGS
+	// Keep the decoded images in memory, since they are loaded again for each calibration and each time they are shown:
+	CImage::setExternalImagesCacheSize(256*1024*1024);
+#endif
+
 	wxIcon icon;
 	icon.CopyFromBitmap( wxBitmap(wxImage( icono_main_xpm )) );
 	this->SetIcon( icon );
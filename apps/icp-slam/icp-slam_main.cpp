@@ -168,6 +168,7 @@ void MapBuilding_ICP(const string &INI_FILENAME, const string &override_rawlog_f
 	printf(" RAWLOG file:'%s'\n", RAWLOG_FILE.c_str());
 	printf(" Output directory:\t\t\t'%s'\n",OUT_DIR);
 	printf(" matchAgainstTheGrid:\t\t\t%c\n", mapBuilder.ICP_options.matchAgainstTheGrid ? 'Y':'N');
+	printf(" useCorrelativeScanMatcher:\t\t%c\n", mapBuilder.ICP_options.useCorrelativeScanMatcher ? 'Y':'N');
 	printf(" Log record freq:\t\t\t%u\n",LOG_FREQUENCY);
 	printf("  SAVE_3D_SCENE:\t\t\t%c\n", SAVE_3D_SCENE ? 'Y':'N');
 	printf("  SAVE_POSE_LOG:\t\t\t%c\n", SAVE_POSE_LOG ? 'Y':'N');
@@ -30,17 +30,25 @@ void register_tests_graph();
 void register_tests_graphslam();
 void register_tests_CObservation3DRangeScan();
 void register_tests_atan2lut();
+void register_tests_octomap();
+void register_tests_mcl();
+void register_tests_rbpf();
+void register_tests_reactivenav();
+void register_tests_rawlog();
+void register_tests_pnp();
+void register_tests_opengl();
 // -------------------------------------------------
 
 typedef double (*TestFunctor)(int a1, int a2);  // return run-time in secs.
 
 struct TestData
 {
-	TestData(const char*nam,TestFunctor f,int a1=0,int a2=0) : name(nam),func(f),arg1(a1),arg2(a2) { }
+	TestData(const char*nam,TestFunctor f,int a1=0,int a2=0,bool reentrant_=false) : name(nam),func(f),arg1(a1),arg2(a2),reentrant(reentrant_) { }
 
 	const char *name;
 	TestFunctor func;
 	int arg1,arg2;
+	bool reentrant; //!< true if the test doesn't use any global state (e.g. mrpt::random::randomGenerator), so it can run in several threads at once (see `--threads`)
 };
 
 // Common data & functions available to all performance modules:
@@ -8,6 +8,7 @@
    +---------------------------------------------------------------------------+ */
 
 #include <mrpt/obs/CObservation3DRangeScan.h>
+#include <mrpt/maps/CColouredPointsMap.h>
 #include <mrpt/utils/CFileGZInputStream.h>
 #include <mrpt/random.h>
 #include <mrpt/utils/CTimeLogger.h>
@@ -73,6 +74,42 @@ double obs3d_test_depth_to_3d(int a, int b)
 	return t;
 }
 
+// Full pipeline: filter + project + color + 6D transform, into a colored point map
+double obs3d_test_depth_to_colored_3d(int decimation, int useMinMaxFilters)
+{
+	CObservation3DRangeScan obs1;
+	CFileGZInputStream(rgbd_test_rawlog_file) >> obs1;
+
+	CTimeLogger timlog;
+
+	const CPose3D robotPose(1.0,2.0,0.5, DEG2RAD(30.0),DEG2RAD(2.0),DEG2RAD(-1.0));
+	T3DPointsProjectionParams pp;
+	pp.takeIntoAccountSensorPoseOnRobot = true;
+	pp.robotPoseInTheWorld = &robotPose;
+	pp.decimation = decimation;
+
+	TRangeImageFilterParams fp;
+	mrpt::math::CMatrix minF, maxF;
+	if (useMinMaxFilters) {
+		generateRandomMaskImage(minF, obs1.rangeImage.rows(),obs1.rangeImage.cols());
+		generateRandomMaskImage(maxF, obs1.rangeImage.rows(),obs1.rangeImage.cols());
+		maxF+=minF;
+		fp.rangeMask_min = &minF;
+		fp.rangeMask_max = &maxF;
+	}
+
+	CColouredPointsMap pts;
+	for (int i=0;i<100;i++) {
+		if (i>0) { timlog.enter("run"); }
+		obs1.project3DPointsFromDepthImageInto(pts, pp, fp );
+		if (i>0) { timlog.leave("run"); }
+	}
+
+	const double t = timlog.getMeanTime("run");
+	timlog.clear(true);
+	return t;
+}
+
 double obs3d_test_depth_to_2d_scan(int useMinFilter, int useMaxFilter)
 {
 	CObservation3DRangeScan obs1;
@@ -132,6 +169,10 @@ void register_tests_CObservation3DRangeScan()
 		lstTests.push_back( TestData("3DRangeScan: 320x240 Depth->3D (LUT,w/o SSE2,min/maxFilter)",obs3d_test_depth_to_3d, 0x01,0x03) );
 		lstTests.push_back( TestData("3DRangeScan: 320x240 Depth->3D (LUT,w/SSE2,min/maxFilter)",obs3d_test_depth_to_3d, 0x03, 0x03) );
 
+		lstTests.push_back( TestData("3DRangeScan: 320x240 Depth->3D colored+6D pose",obs3d_test_depth_to_colored_3d, 1,0) );
+		lstTests.push_back( TestData("3DRangeScan: 320x240 Depth->3D colored+6D pose (min/maxFilter)",obs3d_test_depth_to_colored_3d, 1,1) );
+		lstTests.push_back( TestData("3DRangeScan: 320x240 Depth->3D colored+6D pose (decimation=2)",obs3d_test_depth_to_colored_3d, 2,0) );
+		lstTests.push_back( TestData("3DRangeScan: 320x240 Depth->3D colored+6D pose (decimation=4)",obs3d_test_depth_to_colored_3d, 4,0) );
 		lstTests.push_back( TestData("3DRangeScan: 320x240 Depth->2D scan",obs3d_test_depth_to_2d_scan ) );
 		lstTests.push_back( TestData("3DRangeScan: 320x240 Depth->2D scan + min_filter",obs3d_test_depth_to_2d_scan, 1, 0 ) );
 		lstTests.push_back( TestData("3DRangeScan: 320x240 Depth->2D scan + max_filter",obs3d_test_depth_to_2d_scan, 0, 1 ) );
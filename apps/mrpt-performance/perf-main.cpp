@@ -19,6 +19,13 @@
 #include <mrpt/utils/CFileInputStream.h>
 #include <mrpt/utils/stl_serialization.h>
 
+#ifdef MRPT_OS_WINDOWS
+#	include <windows.h>
+#elif defined(MRPT_OS_LINUX)
+#	include <pthread.h>
+#	include <sched.h>
+#endif
+
 #include "common.h"
 
 using namespace mrpt;
@@ -74,6 +81,128 @@ void getTestImage(unsigned int img_index, mrpt::utils::CImage &out_img )
 
 #include "run_build_tables.h"
 
+#include "test_statistics.h"
+
+
+// Settings of the statistical runs of each test:
+struct TRunSettings
+{
+	TRunSettings() : warmup(1), min_reps(3), max_reps(20), rel_ci(0.05), max_time(5.0), pin_cpu(-1) { }
+
+	int    warmup;   //!< Runs discarded before measuring (cold caches, lazy initializations,...)
+	int    min_reps, max_reps;
+	double rel_ci;   //!< Stop repeating once the 95% confidence interval is below this fraction of the mean
+	double max_time; //!< Stop repeating after this time (seconds) even if the confidence interval was not reached
+	int    pin_cpu;  //!< -1: don't pin threads to CPUs
+};
+
+// Pins the calling thread to one CPU core, to reduce the variance due to migrations between cores:
+bool pinCurrentThreadToCPU(int cpu)
+{
+#if defined(MRPT_OS_WINDOWS)
+	return 0!=SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1)<<cpu);
+#elif defined(MRPT_OS_LINUX)
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(cpu,&cpus);
+	return 0==pthread_setaffinity_np(pthread_self(),sizeof(cpus),&cpus);
+#else
+	MRPT_UNUSED_PARAM(cpu);
+	return false; // Not supported (e.g. OSX has no thread affinity API)
+#endif
+}
+
+// One instance of a test running in a thread of a multi-threaded measurement:
+struct TTestThread
+{
+	TTestThread() : test(NULL), cpu(-1), time(0) { }
+	const TestData *test;
+	int    cpu;
+	double time;
+};
+
+void runTestThread(TTestThread *t)
+{
+	if (t->cpu>=0) pinCurrentThreadToCPU(t->cpu);
+	t->time = t->test->func(t->test->arg1,t->test->arg2);
+}
+
+// One measurement: the time returned by the test, or its mean over "nThreads" threads running it at once.
+double runTestOnce(const TestData &test, int nThreads, const TRunSettings &settings)
+{
+	if (nThreads<=1)
+		return test.func(test.arg1,test.arg2);
+
+	vector<TTestThread> ths(nThreads);
+	vector<TThreadHandle> handles(nThreads);
+	for (int i=0;i<nThreads;i++)
+	{
+		ths[i].test = &test;
+		ths[i].cpu = settings.pin_cpu>=0 ? settings.pin_cpu+i : -1;
+		handles[i] = mrpt::system::createThread(&runTestThread, &ths[i]);
+	}
+	double sum=0;
+	for (int i=0;i<nThreads;i++)
+	{
+		mrpt::system::joinThread(handles[i]);
+		sum+=ths[i].time;
+	}
+	return sum/nThreads;
+}
+
+// Warm-up runs, then repetitions until the confidence interval is small enough:
+void runTestStatistics(const TestData &test, int nThreads, const TRunSettings &settings, TTestStats &stats)
+{
+	for (int i=0;i<settings.warmup;i++)
+		runTestOnce(test,nThreads,settings);
+
+	vector<double> samples;
+	CTicTac tictac;
+	for (;;)
+	{
+		samples.push_back( runTestOnce(test,nThreads,settings) );
+		computeTestStats(samples,stats);
+
+		const int n = static_cast<int>(samples.size());
+		if (n<settings.min_reps) continue;
+		if (n>=settings.max_reps || tictac.Tac()>=settings.max_time) break;
+		if (stats.ci95<=settings.rel_ci*stats.mean) break;
+	}
+	stats.threads = nThreads;
+}
+
+// Macros to create strings with the compiler version:
+#define ___STR2__(x) #x
+#define ___STR1__(x) ___STR2__(x)
+#define COMP_VER(NAME,MAJ,MIN,PATCH)  NAME ___STR1__(MAJ) ___STR1__(MIN)  ___STR1__(PATCH)
+
+const char* getCompilerName()
+{
+#if defined(_MSC_VER)
+#	if _MSC_VER<=1399
+	return "MSVC7";
+#	elif _MSC_VER<=1499
+	return "MSVC8";
+#	elif _MSC_VER<=1599
+	return "MSVC9";
+#	elif _MSC_VER<=1699
+	return "MSVC10";
+#	elif _MSC_VER<=1799
+	return "MSVC11";
+#	elif _MSC_VER<=1899
+	return "MSVC12";
+#	else
+	return "MSVC";
+#	endif
+#elif defined(__clang__)
+	return COMP_VER("CLANG",__clang_major__,__clang_minor__,__clang_patchlevel__);
+#elif defined(__GNUC__)
+	return COMP_VER("GCC",__GNUC__,__GNUC_MINOR__ ,__GNUC_PATCHLEVEL__);
+#else
+	return "unknowncompiler";
+#endif
+}
+
 
 // ------------------------------------------------------
 //						MAIN
@@ -89,6 +218,19 @@ int main(int argc, char **argv)
 		TCLAP::SwitchArg arg_build_tables("t","tables","Don't run any test, instead build the tables of compared performances in SOURCE_DIR/doc/",cmd,false);
 		TCLAP::SwitchArg arg_release("r","release","Don't use the postfix 'dev' in the performance stats file",cmd,false);
 
+		TCLAP::ValueArg<int>    arg_warmup("","warmup","Number of discarded runs of each test before measuring (Default=1)",false,1,"N",cmd);
+		TCLAP::ValueArg<int>    arg_min_reps("","min-reps","Minimum number of measurements of each test (Default=3)",false,3,"N",cmd);
+		TCLAP::ValueArg<int>    arg_max_reps("","max-reps","Maximum number of measurements of each test (Default=20)",false,20,"N",cmd);
+		TCLAP::ValueArg<double> arg_ci("","ci","Repeat each test until the 95% confidence interval of its mean time is below this fraction of the mean (Default=0.05)",false,0.05,"FRACTION",cmd);
+		TCLAP::ValueArg<double> arg_max_time("","max-time","Maximum time (seconds) spent repeating each test (Default=5)",false,5.0,"SECONDS",cmd);
+		TCLAP::ValueArg<int>    arg_pin_cpu("","pin-cpu","Pin the thread running the tests to this CPU core (and the i'th thread of multi-threaded tests to CPU+i)",false,0,"CPU",cmd);
+		TCLAP::ValueArg<int>    arg_threads("","threads","Also run those tests that support it in this number of concurrent threads",false,1,"N",cmd);
+
+		TCLAP::ValueArg<std::string> arg_json("j","json","Save the results in this JSON file",false,"","results.json",cmd);
+		TCLAP::ValueArg<std::string> arg_baseline("b","baseline","Compare the results against this baseline JSON file (saved with --json) and exit with code 1 if there are regressions",false,"","baseline.json",cmd);
+		TCLAP::ValueArg<double> arg_threshold("","threshold","Relative change in the median time to be considered a regression (Default=0.10)",false,0.10,"FRACTION",cmd);
+		TCLAP::ValueArg<std::string> arg_compare_json("","compare-json","Don't run any test, instead compare this JSON file against --baseline",false,"","results.json",cmd);
+
 		// Parse arguments:
 		if (!cmd.parse( argc, argv ))
 			throw std::runtime_error(""); // should exit.
@@ -96,13 +238,37 @@ int main(int argc, char **argv)
 		if (arg_build_tables.isSet())
 			return run_build_tables();
 
+		if (arg_compare_json.isSet())
+		{
+			if (!arg_baseline.isSet())
+				throw std::runtime_error("--compare-json requires --baseline");
+			vector<TTestStats> results;
+			if (!loadTestStatsFromJSON(arg_compare_json.getValue(),results))
+				THROW_EXCEPTION_CUSTOM_MSG1("Error loading file: '%s'",arg_compare_json.getValue().c_str())
+			return run_compare_baseline(results,arg_baseline.getValue(),arg_threshold.getValue())!=0 ? 1:0;
+		}
+
+		TRunSettings settings;
+		settings.warmup = std::max(0,arg_warmup.getValue());
+		settings.min_reps = std::max(1,arg_min_reps.getValue());
+		settings.max_reps = std::max(settings.min_reps,arg_max_reps.getValue());
+		settings.rel_ci = arg_ci.getValue();
+		settings.max_time = arg_max_time.getValue();
+		if (arg_pin_cpu.isSet())
+		{
+			settings.pin_cpu = arg_pin_cpu.getValue();
+			if (!pinCurrentThreadToCPU(settings.pin_cpu))
+				cerr << "Warning: could not pin the thread to CPU #" << settings.pin_cpu << endl;
+		}
+		const int nThreads = std::max(1,arg_threads.getValue());
+
 		const std::string filName = "./mrpt-performance.html";
 
 		std::string  match_contains;
 		if (arg_contains.isSet())
 		{
-			cout << "Using match filter: " << match_contains << endl;
 			match_contains = arg_contains.getValue();
+			cout << "Using match filter: " << match_contains << endl;
 		}
 
 
@@ -122,6 +288,8 @@ int main(int argc, char **argv)
 		else
 			cout << "Cannot save log, error opening " << filName << " for writing..." << endl;
 
+		cout << mrpt::format("Each test: %i warm-up runs, then %i to %i measurements (until CI95 < %.01f%% or %.01f s)\n",
+			settings.warmup, settings.min_reps, settings.max_reps, 100*settings.rel_ci, settings.max_time);
 		cout << endl;
 
 		if (doLog)
@@ -147,16 +315,28 @@ int main(int argc, char **argv)
 		register_tests_graphslam();
 		register_tests_CObservation3DRangeScan();
 		register_tests_atan2lut();
+		register_tests_octomap();
+		register_tests_mcl();
+		register_tests_rbpf();
+		register_tests_reactivenav();
+		register_tests_rawlog();
+		register_tests_pnp();
+		register_tests_opengl();
 
 		if (doLog)
 		{
 			fo.printf("<div align=\"center\"><h3>Results</h3></div><br>");
 			fo.printf("<div align=\"center\"><table border=\"1\">\n");
 			fo.printf("<tr> <td align=\"center\"><b>Test description</b></td> "
-					  "<td align=\"center\"><b>Execution time</b></td>"
+					  "<td align=\"center\"><b>Median time</b></td>"
+					  "<td align=\"center\"><b>Mean time &plusmn; CI95</b></td>"
+					  "<td align=\"center\"><b>P90 time</b></td>"
+					  "<td align=\"center\"><b>Runs</b></td>"
 					  "<td align=\"center\"><b>Execution rate (Hz)</b></td> </tr>\n");
 		}
 
+		vector<TTestStats> all_stats;
+
 		for (std::list<TestData>::const_iterator it=lstTests.begin();it!=lstTests.end();it++)
 		{
 			// Filter tests?
@@ -164,31 +344,52 @@ int main(int argc, char **argv)
 				if (string::npos==string(it->name).find(match_contains))
 					continue; // doesn't have the substring
 
-			printf("%-60s",it->name); cout.flush();
-
-			try
+			const int nVariants = (nThreads>1 && it->reentrant) ? 2:1;
+			for (int variant=0;variant<nVariants;variant++)
 			{
-				const double t = it->func(it->arg1,it->arg2); // Run it.
+				const int nThisThreads = variant==0 ? 1 : nThreads;
 
-				mrpt::system::setConsoleColor(CONCOL_GREEN);
-				cout << mrpt::system::intervalFormat(t);
-				mrpt::system::setConsoleColor(CONCOL_NORMAL);
-				cout << endl;
+				TTestStats stats;
+				stats.name = it->name;
+				if (nThisThreads>1)
+					stats.name+=mrpt::format(" [%i threads]",nThisThreads);
 
-				// Make list of all data:
-				all_perf_data.push_back( pair<string,double>(it->name, t) );
+				printf("%-60s",stats.name.c_str()); cout.flush();
 
-				if (doLog)
+				try
 				{
-					fo.printf("<tr> <td>%s</td> <td align=\"right\">%s</td> <td align=\"right\">%sHz</td>  </tr>\n",
-						it->name,
-						mrpt::system::intervalFormat(t).c_str(),
-						mrpt::system::unitsFormat(1.0/t).c_str());
+					runTestStatistics(*it,nThisThreads,settings,stats);
+
+					mrpt::system::setConsoleColor(CONCOL_GREEN);
+					cout << mrpt::system::intervalFormat(stats.median);
+					mrpt::system::setConsoleColor(CONCOL_NORMAL);
+					cout << mrpt::format(" (mean %s +- %.01f%%, p90 %s, %u runs)",
+						mrpt::system::intervalFormat(stats.mean).c_str(),
+						stats.mean>0 ? 100*stats.ci95/stats.mean : 0.0,
+						mrpt::system::intervalFormat(stats.p90).c_str(),
+						static_cast<unsigned int>(stats.n));
+					cout << endl;
+
+					// Make list of all data:
+					all_stats.push_back(stats);
+					all_perf_data.push_back( pair<string,double>(stats.name, stats.median) );
+
+					if (doLog)
+					{
+						fo.printf("<tr> <td>%s</td> <td align=\"right\">%s</td> <td align=\"right\">%s &plusmn; %s</td> <td align=\"right\">%s</td> <td align=\"right\">%u</td> <td align=\"right\">%sHz</td>  </tr>\n",
+							stats.name.c_str(),
+							mrpt::system::intervalFormat(stats.median).c_str(),
+							mrpt::system::intervalFormat(stats.mean).c_str(),
+							mrpt::system::intervalFormat(stats.ci95).c_str(),
+							mrpt::system::intervalFormat(stats.p90).c_str(),
+							static_cast<unsigned int>(stats.n),
+							mrpt::system::unitsFormat(1.0/stats.median).c_str());
+					}
+				}
+				catch (std::exception &e)
+				{
+					cerr << "Skipped due to exception:\n" << e.what() << endl;
 				}
-			}
-			catch (std::exception &e)
-			{
-				cerr << "Skipped due to exception:\n" << e.what() << endl;
 			}
 		}
 
@@ -232,35 +433,6 @@ int main(int argc, char **argv)
 		{
 			const char* version_postfix = arg_release.isSet() ? "":"dev";
 
-			// Macros to create strings with the compiler version:
-#define ___STR2__(x) #x
-#define ___STR1__(x) ___STR2__(x)
-#define COMP_VER(NAME,MAJ,MIN,PATCH)  NAME ___STR1__(MAJ) ___STR1__(MIN)  ___STR1__(PATCH)
-
-#if defined(_MSC_VER)
-#		if _MSC_VER<=1399
-			const char* compiler_name = "MSVC7";
-#		elif _MSC_VER<=1499
-			const char* compiler_name = "MSVC8";
-#		elif _MSC_VER<=1599
-			const char* compiler_name = "MSVC9";
-#		elif _MSC_VER<=1699
-			const char* compiler_name = "MSVC10";
-#		elif _MSC_VER<=1799
-			const char* compiler_name = "MSVC11";
-#		elif _MSC_VER<=1899
-			const char* compiler_name = "MSVC12";
-#		else
-			const char* compiler_name = "MSVC";
-#		endif
-#elif defined(__clang__)
-			const char* compiler_name = COMP_VER("CLANG",__clang_major__,__clang_minor__,__clang_patchlevel__);
-#elif defined(__GNUC__)
-			const char* compiler_name = COMP_VER("GCC",__GNUC__,__GNUC_MINOR__ ,__GNUC_PATCHLEVEL__);
-#else
-			const char* compiler_name = "unknowncompiler";
-#endif
-
 			const string fil_name =
 				PERF_DATA_DIR +
 				mrpt::format("/perf-results-%i.%i.%i%s-%s-%ibit.dat",
@@ -268,13 +440,36 @@ int main(int argc, char **argv)
 					int( (MRPT_VERSION >> 4) & 0x0F ),
 					int( (MRPT_VERSION >> 0) & 0x0F ),
 					version_postfix,
-					compiler_name,
+					getCompilerName(),
 					int(MRPT_WORD_SIZE) );
 			cout << "Saving perf-data to: " << fil_name << endl;
 			CFileOutputStream f( fil_name );
 			f << all_perf_data;
 		}
 
+		// Save as JSON?
+		if (arg_json.isSet())
+		{
+			map<string,string> run_info;
+			run_info["mrpt_version"] = MRPT_getVersion();
+			run_info["compiler"] = getCompilerName();
+			run_info["word_size"] = mrpt::format("%i",int(MRPT_WORD_SIZE));
+			run_info["date"] = mrpt::system::dateTimeLocalToString(now());
+			run_info["settings"] = mrpt::format("warmup=%i min_reps=%i max_reps=%i ci=%g max_time=%g pin_cpu=%i threads=%i",
+				settings.warmup, settings.min_reps, settings.max_reps, settings.rel_ci, settings.max_time, settings.pin_cpu, nThreads);
+
+			if (saveTestStatsToJSON(arg_json.getValue(),all_stats,run_info))
+			     cout << "Saved results to: " << arg_json.getValue() << endl;
+			else cerr << "Error saving results to: " << arg_json.getValue() << endl;
+		}
+
+		// Compare against a baseline?
+		if (arg_baseline.isSet())
+		{
+			if (run_compare_baseline(all_stats,arg_baseline.getValue(),arg_threshold.getValue())!=0)
+				return 1;
+		}
+
 		return 0;
 	}
 	catch (std::exception &e)
@@ -301,4 +496,3 @@ int main(int argc, char **argv)
 		return -1;
 	}
 }
-
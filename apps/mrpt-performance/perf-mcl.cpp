@@ -0,0 +1,167 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/slam/CMonteCarloLocalization2D.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CActionRobotMovement2D.h>
+#include <mrpt/obs/CActionCollection.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/random.h>
+
+#include "common.h"
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::bayes;
+using namespace mrpt::slam;
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+using namespace mrpt::random;
+using namespace std;
+
+// A 181 rays scan taken from "pose" inside the room [-5,7]x[-4,6]:
+static void simulateRoomScan(const CPose2D &pose, CObservation2DRangeScan &scan)
+{
+	const double x0=-5, x1=7, y0=-4, y1=6;
+	const size_t N = 181;
+	scan.aperture = M_PIf;
+	scan.rightToLeft = true;
+	scan.maxRange = 20;
+	scan.scan.resize(N);
+	scan.validRange.assign(N,1);
+	for (size_t i=0;i<N;i++)
+	{
+		const double a = pose.phi() - 0.5*M_PI + i*M_PI/(N-1);
+		const double c = cos(a), s = sin(a);
+		double r = 1e9;
+		if (c>1e-9)  r = std::min(r, (x1-pose.x())/c);
+		if (c<-1e-9) r = std::min(r, (x0-pose.x())/c);
+		if (s>1e-9)  r = std::min(r, (y1-pose.y())/s);
+		if (s<-1e-9) r = std::min(r, (y0-pose.y())/s);
+		scan.scan[i] = static_cast<float>(r + randomGenerator.drawGaussian1D(0,0.01));
+	}
+}
+
+// One complete MCL step (prediction, weighting and resampling) with "nParticles" particles.
+// If "adaptive"!=0, the standard proposal is used with a KLD-based dynamic sample size.
+static double mcl_run_steps(int nParticles, int PF_algorithm, bool adaptive)
+{
+	randomGenerator.randomize(123);
+
+	COccupancyGridMap2D grid(-6,8,-5,7,0.05f);
+	grid.likelihoodOptions.likelihoodMethod = COccupancyGridMap2D::lmLikelihoodField_Thrun;
+	grid.likelihoodOptions.LF_decimation = 10;
+	for (int i=0;i<4;i++)
+	{
+		CObservation2DRangeScan scan;
+		const CPose2D p(i*0.5,i*0.3,i*M_PI/2);
+		simulateRoomScan(p,scan);
+		const CPose3D p3(p);
+		grid.insertObservation(&scan,&p3);
+	}
+
+	CMonteCarloLocalization2D pdf;
+	pdf.options.metricMap = &grid;
+	pdf.resetUniform(-1,1,-1,1,-M_PI,M_PI,nParticles);
+
+	CParticleFilter PF;
+	PF.m_options.PF_algorithm = static_cast<CParticleFilter::TParticleFilterAlgorithm>(PF_algorithm);
+	PF.m_options.adaptiveSampleSize = adaptive;
+	PF.m_options.BETA = 1.1; // Always resample
+	PF.m_options.resamplingMethod = adaptive ? CParticleFilter::prMultinomial : CParticleFilter::prSystematic;
+	if (adaptive)
+	{
+		pdf.options.KLD_params.KLD_minSampleSize = nParticles/10;
+		pdf.options.KLD_params.KLD_maxSampleSize = nParticles;
+		pdf.options.KLD_params.KLD_binSize_XY = 0.05;
+		pdf.options.KLD_params.KLD_binSize_PHI = DEG2RAD(2.5);
+	}
+
+	CActionRobotMovement2D::TMotionModelOptions odoOpts;
+	odoOpts.modelSelection = CActionRobotMovement2D::mmGaussian;
+
+	const int NSTEPS = 5;
+	CPose2D realPose(0,0,0);
+	const CPose2D odoIncr(0.10,0,DEG2RAD(2));
+
+	CTicTac tictac;
+	double T=0;
+	for (int k=0;k<NSTEPS;k++)
+	{
+		realPose = realPose + odoIncr;
+
+		CActionCollection acts;
+		CActionRobotMovement2D odo;
+		odo.computeFromOdometry(odoIncr,odoOpts);
+		acts.insert(odo);
+
+		CSensoryFrame sf;
+		CObservation2DRangeScanPtr scan = CObservation2DRangeScan::Create();
+		simulateRoomScan(realPose,*scan);
+		sf.insert(scan);
+
+		tictac.Tic();
+		PF.executeOn(pdf,&acts,&sf);
+		T+=tictac.Tac();
+	}
+	return T/NSTEPS;
+}
+
+double mcl_test_step(int nParticles, int PF_algorithm)
+{
+	return mcl_run_steps(nParticles,PF_algorithm,false);
+}
+
+double mcl_test_step_KLD(int nParticles, int dummy)
+{
+	MRPT_UNUSED_PARAM(dummy);
+	return mcl_run_steps(nParticles,CParticleFilter::pfStandardProposal,true);
+}
+
+// Resampling alone (computing indices and replacing particles)
+double mcl_test_resampling(int nParticles, int dummy)
+{
+	MRPT_UNUSED_PARAM(dummy);
+	randomGenerator.randomize(123);
+
+	CPosePDFParticles pdf(nParticles);
+	CParticleFilter::TParticleFilterOptions opts;
+	opts.resamplingMethod = CParticleFilter::prSystematic;
+
+	const int NREPS = 10;
+	CTicTac tictac;
+	double T=0;
+	for (int k=0;k<NREPS;k++)
+	{
+		for (size_t i=0;i<pdf.m_particles.size();i++)
+			pdf.m_particles[i].log_w = randomGenerator.drawGaussian1D(0,1);
+
+		tictac.Tic();
+		pdf.performResampling(opts);
+		T+=tictac.Tac();
+	}
+	return T/NREPS;
+}
+
+// ------------------------------------------------------
+// register_tests_mcl
+// ------------------------------------------------------
+void register_tests_mcl()
+{
+	lstTests.push_back( TestData("mcl: resampling 1k particles",mcl_test_resampling, 1000) );
+	lstTests.push_back( TestData("mcl: resampling 10k particles",mcl_test_resampling, 10000) );
+	lstTests.push_back( TestData("mcl: resampling 100k particles",mcl_test_resampling, 100000) );
+	lstTests.push_back( TestData("mcl: 2D MCL step, pfStandardProposal, 1k particles",mcl_test_step, 1000, CParticleFilter::pfStandardProposal) );
+	lstTests.push_back( TestData("mcl: 2D MCL step, pfStandardProposal, 10k particles",mcl_test_step, 10000, CParticleFilter::pfStandardProposal) );
+	lstTests.push_back( TestData("mcl: 2D MCL step, pfStandardProposal, 100k particles",mcl_test_step, 100000, CParticleFilter::pfStandardProposal) );
+	lstTests.push_back( TestData("mcl: 2D MCL step, pfStandardProposal+KLD, max 10k particles",mcl_test_step_KLD, 10000) );
+	lstTests.push_back( TestData("mcl: 2D MCL step, pfStandardProposal+KLD, max 100k particles",mcl_test_step_KLD, 100000) );
+}
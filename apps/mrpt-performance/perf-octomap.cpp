@@ -0,0 +1,127 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/maps/COctoMap.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/obs/CObservation3DRangeScan.h>
+#include <mrpt/random.h>
+
+#include "common.h"
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::random;
+using namespace mrpt::poses;
+using namespace std;
+
+// A Velodyne HDL-32-like scan (32 layers x 1800 points) of a 20x12x4 m room, seen from the origin.
+static void generateVelodyneLikeScan(CSimplePointsMap &pts)
+{
+	const double x0=-8, x1=12, y0=-5, y1=7, z0=-1.8, z1=2.2;
+	pts.clear();
+	pts.reserve(32*1800);
+	for (int layer=0;layer<32;layer++)
+	{
+		const double pitch = DEG2RAD(-30.67 + layer*1.33);
+		for (int i=0;i<1800;i++)
+		{
+			const double yaw = i*2*M_PI/1800;
+			const double dx = cos(pitch)*cos(yaw), dy = cos(pitch)*sin(yaw), dz = sin(pitch);
+			double r = 1e9;
+			if (dx>1e-9)  r = std::min(r, x1/dx);
+			if (dx<-1e-9) r = std::min(r, x0/dx);
+			if (dy>1e-9)  r = std::min(r, y1/dy);
+			if (dy<-1e-9) r = std::min(r, y0/dy);
+			if (dz>1e-9)  r = std::min(r, z1/dz);
+			if (dz<-1e-9) r = std::min(r, z0/dz);
+			r += randomGenerator.drawGaussian1D(0,0.01);
+			pts.insertPoint(r*dx,r*dy,r*dz);
+		}
+	}
+}
+
+// The insertion path of the octomap library: one ray at a time, all in the calling thread.
+double octomap_test_insert_octomaplib(int nScans, int naive)
+{
+	CSimplePointsMap pts;
+	generateVelodyneLikeScan(pts);
+	octomap::Pointcloud cloud;
+	for (size_t i=0;i<pts.size();i++)
+	{
+		float x,y,z;
+		pts.getPoint(i,x,y,z);
+		cloud.push_back(x,y,z);
+	}
+
+	COctoMap map(0.10);
+	CTicTac tictac;
+	for (int k=0;k<nScans;k++)
+	{
+		const octomap::point3d sensorPt(0.01f*k,0,0);
+		if (naive)
+		     map.getOctomap().insertScanNaive(cloud, sensorPt, -1, true);
+		else map.getOctomap().insertScan(cloud, sensorPt, -1, true);
+	}
+	return tictac.Tac()/nScans;
+}
+
+double octomap_test_insertPointCloud(int nScans, int discretize)
+{
+	CSimplePointsMap pts;
+	generateVelodyneLikeScan(pts);
+
+	COctoMap map(0.10);
+	map.insertionOptions.discretizeScan = discretize!=0;
+	CTicTac tictac;
+	for (int k=0;k<nScans;k++)
+		map.insertPointCloud(pts, 0.01f*k,0,0);
+	return tictac.Tac()/nScans;
+}
+
+double octomap_test_likelihood(int N, int decimation)
+{
+	CSimplePointsMap pts;
+	generateVelodyneLikeScan(pts);
+
+	COctoMap map(0.10);
+	map.insertionOptions.discretizeScan = true;
+	map.insertPointCloud(pts, 0,0,0);
+	map.likelihoodOptions.decimation = decimation;
+
+	CObservation3DRangeScan obs;
+	obs.hasPoints3D = true;
+	pts.getAllPoints(obs.points3D_x,obs.points3D_y,obs.points3D_z);
+
+	double R=0;
+	CTicTac tictac;
+	for (int i=0;i<N;i++)
+	{
+		const CPose3D pose(
+			randomGenerator.drawUniform(-0.1,0.1),
+			randomGenerator.drawUniform(-0.1,0.1), 0,
+			randomGenerator.drawUniform(-0.05,0.05), 0,0 );
+		R+=map.computeObservationLikelihood(&obs,pose);
+	}
+	return tictac.Tac()/N;
+}
+
+// ------------------------------------------------------
+// register_tests_octomap
+// ------------------------------------------------------
+void register_tests_octomap()
+{
+	lstTests.push_back( TestData("octomap: insert 57.6k pts scan (octomap lib, insertScanNaive)",octomap_test_insert_octomaplib, 3, 1) );
+	lstTests.push_back( TestData("octomap: insert 57.6k pts scan (octomap lib, insertScan)",octomap_test_insert_octomaplib, 5, 0) );
+	lstTests.push_back( TestData("octomap: insertPointCloud 57.6k pts",octomap_test_insertPointCloud, 5, 0) );
+	lstTests.push_back( TestData("octomap: insertPointCloud 57.6k pts (discretizeScan)",octomap_test_insertPointCloud, 5, 1) );
+	lstTests.push_back( TestData("octomap: computeLikelihood 57.6k pts",octomap_test_likelihood, 20, 1) );
+	lstTests.push_back( TestData("octomap: computeLikelihood 57.6k pts (decimation=10)",octomap_test_likelihood, 100, 10) );
+}
@@ -0,0 +1,92 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/opengl/CFBORender.h>
+#include <mrpt/opengl/COpenGLScene.h>
+#include <mrpt/opengl/CPointCloud.h>
+#include <mrpt/opengl/CPointCloudColoured.h>
+#include <mrpt/opengl/CVertexBufferObject.h>
+#include <mrpt/random.h>
+#include <cstdlib>
+
+#include "common.h"
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::opengl;
+using namespace mrpt::random;
+using namespace std;
+
+// a1: number of points, a2: 0=CPointCloud, 1=CPointCloud colored by Z, 2=CPointCloudColoured. Negative a1: no VBOs
+double opengl_test_render_pointcloud(int a1, int a2)
+{
+	const bool use_vbo = a1>0;
+	const int N = std::abs(a1);
+
+	CRandomGenerator rng(123);
+	COpenGLScene scene;
+	if (a2<2)
+	{
+		CPointCloudPtr pc = CPointCloud::Create();
+		pc->reserve(N);
+		for (int i=0;i<N;i++)
+			pc->insertPoint(rng.drawUniform(-10.0,10.0),rng.drawUniform(-10.0,10.0),rng.drawUniform(-1.0,1.0));
+		if (a2==1) pc->enableColorFromZ();
+		scene.insert(pc);
+	}
+	else
+	{
+		CPointCloudColouredPtr pc = CPointCloudColoured::Create();
+		pc->reserve(N);
+		for (int i=0;i<N;i++)
+			pc->push_back(rng.drawUniform(-10.0,10.0),rng.drawUniform(-10.0,10.0),rng.drawUniform(-1.0,1.0), rng.drawUniform(0.0,1.0),rng.drawUniform(0.0,1.0),rng.drawUniform(0.0,1.0));
+		scene.insert(pc);
+	}
+	scene.getViewport("main")->getCamera().setZoomDistance(30);
+
+	const bool old_use_vbo = mrpt::global_settings::OPENGL_USE_VERTEX_BUFFER_OBJECTS;
+	mrpt::global_settings::OPENGL_USE_VERTEX_BUFFER_OBJECTS = use_vbo;
+
+	CFBORender render(640,480);
+	CImage img(640,480,CH_RGB);
+	render.getFrame2(scene,img); // First frame: build octree, upload buffers,...
+
+	const size_t N_FRAMES = 20;
+	CTicTac tictac;
+	for (size_t i=0;i<N_FRAMES;i++)
+	{
+		scene.getViewport("main")->getCamera().setAzimuthDegrees(i*2.0f);
+		render.getFrame2(scene,img);
+	}
+	const double T = tictac.Tac()/N_FRAMES;
+
+	mrpt::global_settings::OPENGL_USE_VERTEX_BUFFER_OBJECTS = old_use_vbo;
+	return T;
+}
+
+// ------------------------------------------------------
+// register_tests_opengl
+// ------------------------------------------------------
+void register_tests_opengl()
+{
+#if MRPT_HAS_OPENCV && MRPT_HAS_OPENGL_GLUT
+#	ifndef MRPT_OS_WINDOWS
+	if (!::getenv("DISPLAY")) return; // CFBORender needs an X server (it creates a hidden GLUT window)
+#	endif
+
+	lstTests.push_back( TestData("opengl: CFBORender CPointCloud 1M pts (immediate mode)", opengl_test_render_pointcloud, -1000000, 0 ) );
+	lstTests.push_back( TestData("opengl: CFBORender CPointCloud 1M pts (VBO)", opengl_test_render_pointcloud, 1000000, 0 ) );
+	lstTests.push_back( TestData("opengl: CFBORender CPointCloud 1M pts, color from Z (immediate mode)", opengl_test_render_pointcloud, -1000000, 1 ) );
+	lstTests.push_back( TestData("opengl: CFBORender CPointCloud 1M pts, color from Z (VBO)", opengl_test_render_pointcloud, 1000000, 1 ) );
+	lstTests.push_back( TestData("opengl: CFBORender CPointCloudColoured 1M pts (immediate mode)", opengl_test_render_pointcloud, -1000000, 2 ) );
+	lstTests.push_back( TestData("opengl: CFBORender CPointCloudColoured 1M pts (VBO)", opengl_test_render_pointcloud, 1000000, 2 ) );
+	lstTests.push_back( TestData("opengl: CFBORender CPointCloudColoured 10M pts (immediate mode)", opengl_test_render_pointcloud, -10000000, 2 ) );
+	lstTests.push_back( TestData("opengl: CFBORender CPointCloudColoured 10M pts (VBO)", opengl_test_render_pointcloud, 10000000, 2 ) );
+#endif
+}
@@ -0,0 +1,114 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/utils/types_math.h> // Eigen must be included first via MRPT to enable the plugin system
+#include <mrpt/vision/pnp_algos.h>
+#include <mrpt/utils/CTicTac.h>
+#include <mrpt/random.h>
+
+#include "common.h"
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::random;
+using namespace mrpt::vision::pnp;
+using namespace std;
+
+// K random problems with "n" correspondences each, in the layout of CPnP::solve_batch():
+static void pnp_make_problems(const int K, const int n, Eigen::MatrixXd &obj_pts, Eigen::MatrixXd &img_pts)
+{
+	CRandomGenerator rng(123);
+	obj_pts.resize(3,K*n);
+	img_pts.resize(3,K*n);
+	for (int k=0;k<K;k++)
+	{
+		const Eigen::Matrix3d R = Eigen::AngleAxisd(rng.drawUniform(-1.0,1.0), Eigen::Vector3d(rng.drawUniform(-1.0,1.0),rng.drawUniform(-1.0,1.0),1).normalized()).toRotationMatrix();
+		const Eigen::Vector3d t(rng.drawUniform(-1.0,1.0),rng.drawUniform(-1.0,1.0),rng.drawUniform(8.0,12.0));
+		for (int i=0;i<n;i++)
+		{
+			const Eigen::Vector3d p(rng.drawUniform(-1.0,1.0),rng.drawUniform(-1.0,1.0),rng.drawUniform(-1.0,1.0));
+			obj_pts.col(k*n+i) = p;
+			img_pts.col(k*n+i) = R*p+t;
+			img_pts.col(k*n+i) /= img_pts(2,k*n+i);
+		}
+	}
+}
+
+// a1: algorithm (CPnP::TAlgorithm), a2: 0=one call per problem, 1=CPnP::solve_batch()
+static double pnp_test_solve(int a1, int a2)
+{
+	const int K = 500, n = 6;
+	Eigen::MatrixXd obj_pts, img_pts;
+	pnp_make_problems(K,n,obj_pts,img_pts);
+
+	Eigen::MatrixXd I3 = Eigen::MatrixXd::Identity(3,3);
+	Eigen::MatrixXd pose_mats(6,K);
+	CPnP pnp;
+	const CPnP::TAlgorithm algo = static_cast<CPnP::TAlgorithm>(a1);
+
+	CTicTac tictac;
+	if (a2)
+	{
+		pnp.solve_batch(algo,obj_pts,img_pts,n,I3,pose_mats);
+	}
+	else
+	{
+		Eigen::MatrixXd obj, img, pose(6,1);
+		for (int k=0;k<K;k++)
+		{
+			obj = obj_pts.middleCols(k*n,n);
+			img = img_pts.middleCols(k*n,n);
+			switch (algo)
+			{
+			case CPnP::DLS:   pnp.dls  (obj,img,n,I3,pose); break;
+			case CPnP::EPNP:  pnp.epnp (obj,img,n,I3,pose); break;
+			case CPnP::UPNP:  pnp.upnp (obj,img,n,I3,pose); break;
+			case CPnP::P3P:   pnp.p3p  (obj,img,n,I3,pose); break;
+			case CPnP::RPNP:  pnp.rpnp (obj,img,n,I3,pose); break;
+			case CPnP::PPNP:  pnp.ppnp (obj,img,n,I3,pose); break;
+			case CPnP::POSIT: pnp.posit(obj,img,n,I3,pose); break;
+			case CPnP::LHM:   pnp.lhm  (obj,img,n,I3,pose); break;
+			case CPnP::SO3:   pnp.so3  (obj,img,n,I3,pose); break;
+			};
+			pose_mats.col(k) = pose;
+		}
+	}
+	const double T = tictac.Tac()/K;
+	dummy_do_nothing_with_string( mrpt::format("%f",pose_mats(0,0)) );
+	return T;
+}
+
+// ------------------------------------------------------
+// register_tests_pnp
+// ------------------------------------------------------
+void register_tests_pnp()
+{
+	static const struct { CPnP::TAlgorithm algo; const char *name_call, *name_batch; } algos[] = {
+#if MRPT_HAS_OPENCV
+		{ CPnP::DLS,   "pnp: DLS (n=6), one call per problem",   "pnp: DLS (n=6), solve_batch()" },
+		{ CPnP::UPNP,  "pnp: UPnP (n=6), one call per problem",  "pnp: UPnP (n=6), solve_batch()" },
+		{ CPnP::EPNP,  "pnp: EPnP (n=6), one call per problem",  "pnp: EPnP (n=6), solve_batch()" },
+#endif
+		{ CPnP::P3P,   "pnp: P3P (n=6), one call per problem",   "pnp: P3P (n=6), solve_batch()" },
+		{ CPnP::RPNP,  "pnp: RPnP (n=6), one call per problem",  "pnp: RPnP (n=6), solve_batch()" },
+		{ CPnP::PPNP,  "pnp: PPnP (n=6), one call per problem",  "pnp: PPnP (n=6), solve_batch()" },
+		{ CPnP::POSIT, "pnp: POSIT (n=6), one call per problem", "pnp: POSIT (n=6), solve_batch()" },
+		{ CPnP::LHM,   "pnp: LHM (n=6), one call per problem",   "pnp: LHM (n=6), solve_batch()" },
+		{ CPnP::SO3,   "pnp: SO3 (n=6), one call per problem",   "pnp: SO3 (n=6), solve_batch()" }
+	};
+	for (size_t i=0;i<sizeof(algos)/sizeof(algos[0]);i++)
+	{
+		lstTests.push_back( TestData(algos[i].name_call, pnp_test_solve, algos[i].algo, 0, true) );
+		lstTests.push_back( TestData(algos[i].name_batch, pnp_test_solve, algos[i].algo, 1, true) );
+	}
+#if !MRPT_HAS_OPENCV
+	// Without OpenCV, only the fixed-size EPnP kernel (n<=8) of solve_batch() is available:
+	lstTests.push_back( TestData("pnp: EPnP (n=6), solve_batch()", pnp_test_solve, CPnP::EPNP, 1, true) );
+#endif
+}
@@ -9,6 +9,7 @@
 
 #include <mrpt/math.h>
 #include <mrpt/poses.h>
+#include <mrpt/utils/aligned_containers.h>
 
 #include "common.h"
 
@@ -446,6 +447,98 @@ double poses_test_convert_quat_ypr_pdf(int a1, int a2)
 }
 
 
+// Batch kernels ======================
+// Time per point of transforming N points at once (a1=0: float, 1: double; a2=0: compose, 1: inverse compose)
+template <typename T, class POSE>
+double poses_test_batch_points3D_impl(const POSE &a, int a2)
+{
+	const size_t N = 10000;
+	const long REPS = 100;
+	vector<T> xs(N),ys(N),zs(N), gxs(N),gys(N),gzs(N);
+	for (size_t i=0;i<N;i++) { xs[i]=T(randomGenerator.drawUniform(-10,10)); ys[i]=T(randomGenerator.drawUniform(-10,10)); zs[i]=T(randomGenerator.drawUniform(-10,10)); }
+
+	CTicTac	 tictac;
+	for (long r=0;r<REPS;r++)
+	{
+		if (a2) a.inverseComposePoints(N,&xs[0],&ys[0],&zs[0],&gxs[0],&gys[0],&gzs[0]);
+		else    a.composePoints(N,&xs[0],&ys[0],&zs[0],&gxs[0],&gys[0],&gzs[0]);
+	}
+	double T_ = tictac.Tac()/(N*REPS);
+	dummy_do_nothing_with_string( mrpt::format("%f",double(gxs[0])) );
+	return T_;
+}
+
+double poses_test_batch_points3D(int a1, int a2)
+{
+	const CPose3D a(1.0,2.0,3.0,DEG2RAD(10),DEG2RAD(50),DEG2RAD(-30));
+	return a1 ? poses_test_batch_points3D_impl<double>(a,a2) : poses_test_batch_points3D_impl<float>(a,a2);
+}
+
+double poses_test_batch_points3DQuat(int a1, int a2)
+{
+	const CPose3DQuat a(CPose3D(1.0,2.0,3.0,DEG2RAD(10),DEG2RAD(50),DEG2RAD(-30)));
+	return a1 ? poses_test_batch_points3D_impl<double>(a,a2) : poses_test_batch_points3D_impl<float>(a,a2);
+}
+
+template <typename T>
+double poses_test_batch_points2D_impl(int a2)
+{
+	const size_t N = 10000;
+	const long REPS = 100;
+	const CPose2D a(1.0,2.0,DEG2RAD(10));
+	vector<T> xs(N),ys(N), gxs(N),gys(N);
+	for (size_t i=0;i<N;i++) { xs[i]=T(randomGenerator.drawUniform(-10,10)); ys[i]=T(randomGenerator.drawUniform(-10,10)); }
+
+	CTicTac	 tictac;
+	for (long r=0;r<REPS;r++)
+	{
+		if (a2) a.inverseComposePoints(N,&xs[0],&ys[0],&gxs[0],&gys[0]);
+		else    a.composePoints(N,&xs[0],&ys[0],&gxs[0],&gys[0]);
+	}
+	double T_ = tictac.Tac()/(N*REPS);
+	dummy_do_nothing_with_string( mrpt::format("%f",double(gxs[0])) );
+	return T_;
+}
+
+double poses_test_batch_points2D(int a1, int a2)
+{
+	return a1 ? poses_test_batch_points2D_impl<double>(a2) : poses_test_batch_points2D_impl<float>(a2);
+}
+
+// Time per pose of SE_traits<>::composePoses() (a2=0), inverseComposePoses() (a2=1) or jacobians_dP1DP2inv_depsilon() (a2=2)
+template <size_t DOF>
+double poses_test_batch_poses(int a1, int a2)
+{
+	typedef SE_traits<DOF> SE;
+	typedef typename SE::pose_t pose_t;
+	const size_t N = 1000;
+	const long REPS = 100;
+
+	typename mrpt::aligned_containers<pose_t>::vector_t A(N),B(N),R(N);
+	typename mrpt::aligned_containers<typename SE::matrix_VxV_t>::vector_t J1(N),J2(N);
+	for (size_t i=0;i<N;i++)
+	{
+		typename SE::array_t va,vb;
+		for (size_t k=0;k<SE::VECTOR_SIZE;k++) { va[k]=randomGenerator.drawUniform(-1,1); vb[k]=randomGenerator.drawUniform(-1,1); }
+		SE::exp(va,A[i]);
+		SE::exp(vb,B[i]);
+	}
+
+	CTicTac	 tictac;
+	for (long r=0;r<REPS;r++)
+	{
+		switch (a2)
+		{
+		case 0: SE::composePoses(N,&A[0],&B[0],&R[0]); break;
+		case 1: SE::inverseComposePoses(N,&A[0],&B[0],&R[0]); break;
+		default: SE::jacobians_dP1DP2inv_depsilon(N,&A[0],&J1[0],&J2[0]); break;
+		};
+	}
+	double T = tictac.Tac()/(N*REPS);
+	dummy_do_nothing_with_string( mrpt::format("%f",R[0].x()+J1[0](0,0)) );
+	return T;
+}
+
 
 // ------------------------------------------------------
 // register_tests_poses
@@ -486,4 +579,20 @@ void register_tests_poses()
 	lstTests.push_back( TestData("poses: Conv CPose3D Gauss <- CPose3DQuat Gauss (Lin)",poses_test_convert_ypr_quat_pdf, 0 ) );
 	lstTests.push_back( TestData("poses: Conv CPose3D Gauss <- CPose3DQuat Gauss (SUT)",poses_test_convert_ypr_quat_pdf, 1 ) );
 
+	lstTests.push_back( TestData("poses: CPose3D.composePoints() [float, per point]",poses_test_batch_points3D, 0,0 ) );
+	lstTests.push_back( TestData("poses: CPose3D.composePoints() [double, per point]",poses_test_batch_points3D, 1,0 ) );
+	lstTests.push_back( TestData("poses: CPose3D.inverseComposePoints() [float, per point]",poses_test_batch_points3D, 0,1 ) );
+	lstTests.push_back( TestData("poses: CPose3D.inverseComposePoints() [double, per point]",poses_test_batch_points3D, 1,1 ) );
+	lstTests.push_back( TestData("poses: CPose3DQuat.composePoints() [float, per point]",poses_test_batch_points3DQuat, 0,0 ) );
+	lstTests.push_back( TestData("poses: CPose3DQuat.inverseComposePoints() [float, per point]",poses_test_batch_points3DQuat, 0,1 ) );
+	lstTests.push_back( TestData("poses: CPose2D.composePoints() [float, per point]",poses_test_batch_points2D, 0,0 ) );
+	lstTests.push_back( TestData("poses: CPose2D.composePoints() [double, per point]",poses_test_batch_points2D, 1,0 ) );
+	lstTests.push_back( TestData("poses: CPose2D.inverseComposePoints() [float, per point]",poses_test_batch_points2D, 0,1 ) );
+	lstTests.push_back( TestData("poses: SE_traits<3>::composePoses() [per pose]",poses_test_batch_poses<3>, 0,0 ) );
+	lstTests.push_back( TestData("poses: SE_traits<3>::inverseComposePoses() [per pose]",poses_test_batch_poses<3>, 0,1 ) );
+	lstTests.push_back( TestData("poses: SE_traits<3>::jacobians_dP1DP2inv_depsilon() [per pose]",poses_test_batch_poses<3>, 0,2 ) );
+	lstTests.push_back( TestData("poses: SE_traits<2>::composePoses() [per pose]",poses_test_batch_poses<2>, 0,0 ) );
+	lstTests.push_back( TestData("poses: SE_traits<2>::inverseComposePoses() [per pose]",poses_test_batch_poses<2>, 0,1 ) );
+	lstTests.push_back( TestData("poses: SE_traits<2>::jacobians_dP1DP2inv_depsilon() [per pose]",poses_test_batch_poses<2>, 0,2 ) );
+
 }
@@ -0,0 +1,125 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/obs/CRawlog.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CActionRobotMovement2D.h>
+#include <mrpt/utils/CFileOutputStream.h>
+#include <mrpt/utils/CFileInputStream.h>
+#include <mrpt/utils/CFileGZOutputStream.h>
+#include <mrpt/utils/CFileGZInputStream.h>
+#include <mrpt/utils/CFileMMapInputStream.h>
+#include <mrpt/system/filesystem.h>
+
+#include "common.h"
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+using namespace std;
+
+// Note: all the tests in this file are reentrant (each one uses its own temporary file), so they can be run in several threads at once.
+
+// Writes "N" action-observation pairs (odometry + a 361 rays laser scan) to a stream, as in a typical rawlog.
+static void writeSampleRawlog(CStream &f, int N)
+{
+	CActionRobotMovement2D::TMotionModelOptions odoOpts;
+	odoOpts.modelSelection = CActionRobotMovement2D::mmGaussian;
+
+	for (int k=0;k<N;k++)
+	{
+		CActionCollection acts;
+		CActionRobotMovement2D odo;
+		odo.computeFromOdometry(CPose2D(0.1,0,DEG2RAD(1.0)),odoOpts);
+		acts.insert(odo);
+
+		CSensoryFrame sf;
+		CObservation2DRangeScanPtr scan = CObservation2DRangeScan::Create();
+		scan->aperture = M_PIf;
+		scan->sensorLabel = "LASER";
+		scan->scan.assign(SCAN_RANGES_1,SCAN_RANGES_1+361);
+		scan->validRange.assign(SCAN_VALID_1,SCAN_VALID_1+361);
+		sf.insert(scan);
+
+		f << acts << sf;
+	}
+}
+
+// Mean time per action-observation pair of writing a rawlog (compressed or not)
+double rawlog_test_write(int N, int compress)
+{
+	const string fil = mrpt::system::getTempFileName();
+	CTicTac tictac;
+	if (compress)
+	{
+		CFileGZOutputStream f(fil);
+		writeSampleRawlog(f,N);
+	}
+	else
+	{
+		CFileOutputStream f(fil);
+		writeSampleRawlog(f,N);
+	}
+	const double T = tictac.Tac()/N;
+	mrpt::system::deleteFile(fil);
+	return T;
+}
+
+// Mean time per action-observation pair of reading a rawlog with each kind of stream:
+//  0: CFileInputStream, 1: CFileGZInputStream (of a gz file), 2: CFileMMapInputStream
+double rawlog_test_read(int N, int stream_type)
+{
+	const string fil = mrpt::system::getTempFileName();
+	if (stream_type==1)
+	{
+		CFileGZOutputStream f(fil);
+		writeSampleRawlog(f,N);
+	}
+	else
+	{
+		CFileOutputStream f(fil);
+		writeSampleRawlog(f,N);
+	}
+
+	CTicTac tictac;
+	CStream *f = NULL;
+	switch (stream_type)
+	{
+	case 0: f = new CFileInputStream(fil); break;
+	case 1: f = new CFileGZInputStream(fil); break;
+	case 2: f = new CFileMMapInputStream(fil); break;
+	default: THROW_EXCEPTION("Invalid stream type")
+	};
+
+	CActionCollectionPtr acts;
+	CSensoryFramePtr sf;
+	size_t idx=0;
+	int nRead=0;
+	while (CRawlog::readActionObservationPair(*f,acts,sf,idx))
+		nRead++;
+	delete f;
+	const double T = tictac.Tac()/N;
+
+	mrpt::system::deleteFile(fil);
+	ASSERT_EQUAL_(nRead,N)
+	return T;
+}
+
+// ------------------------------------------------------
+// register_tests_rawlog
+// ------------------------------------------------------
+void register_tests_rawlog()
+{
+	lstTests.push_back( TestData("rawlog: write odometry+2D scan (CFileOutputStream)",rawlog_test_write, 2000, 0, true) );
+	lstTests.push_back( TestData("rawlog: write odometry+2D scan (CFileGZOutputStream)",rawlog_test_write, 2000, 1, true) );
+	lstTests.push_back( TestData("rawlog: read odometry+2D scan (CFileInputStream)",rawlog_test_read, 2000, 0, true) );
+	lstTests.push_back( TestData("rawlog: read odometry+2D scan (CFileGZInputStream)",rawlog_test_read, 2000, 1, true) );
+	lstTests.push_back( TestData("rawlog: read odometry+2D scan (CFileMMapInputStream)",rawlog_test_read, 2000, 2, true) );
+}
@@ -0,0 +1,135 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/slam/CMetricMapBuilderRBPF.h>
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CActionRobotMovement2D.h>
+#include <mrpt/obs/CActionCollection.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/random.h>
+
+#include "common.h"
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::bayes;
+using namespace mrpt::slam;
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+using namespace mrpt::random;
+using namespace std;
+
+// A 361 rays scan taken from "pose" inside the room [-5,7]x[-4,6] with a 1x1 m column at (2,1):
+static void simulateRoomScan(const CPose2D &pose, CObservation2DRangeScan &scan)
+{
+	const double x0=-5, x1=7, y0=-4, y1=6;
+	const size_t N = 361;
+	scan.aperture = M_PIf;
+	scan.rightToLeft = true;
+	scan.maxRange = 20;
+	scan.scan.resize(N);
+	scan.validRange.assign(N,1);
+	for (size_t i=0;i<N;i++)
+	{
+		const double a = pose.phi() - 0.5*M_PI + i*M_PI/(N-1);
+		const double c = cos(a), s = sin(a);
+		double r = 1e9;
+		if (c>1e-9)  r = std::min(r, (x1-pose.x())/c);
+		if (c<-1e-9) r = std::min(r, (x0-pose.x())/c);
+		if (s>1e-9)  r = std::min(r, (y1-pose.y())/s);
+		if (s<-1e-9) r = std::min(r, (y0-pose.y())/s);
+		// The column (slab method):
+		double tmin=0, tmax=1e9;
+		const double bmin[2]={1.5,0.5}, bmax[2]={2.5,1.5}, o[2]={pose.x(),pose.y()}, d[2]={c,s};
+		for (int k=0;k<2 && tmin<=tmax;k++)
+		{
+			if (std::abs(d[k])<1e-9) { if (o[k]<bmin[k] || o[k]>bmax[k]) tmin=1e10; continue; }
+			double t0=(bmin[k]-o[k])/d[k], t1=(bmax[k]-o[k])/d[k];
+			if (t0>t1) std::swap(t0,t1);
+			tmin = std::max(tmin,t0); tmax = std::min(tmax,t1);
+		}
+		if (tmin<=tmax && tmin>0) r = std::min(r,tmin);
+		scan.scan[i] = static_cast<float>(r + randomGenerator.drawGaussian1D(0,0.01));
+	}
+}
+
+// Mean time of one RBPF-SLAM step (prediction, weighting, resampling and map update of all the particles)
+// with "nParticles" particles and the particle filter algorithm "PF_algorithm".
+double rbpf_test_step(int nParticles, int PF_algorithm)
+{
+	randomGenerator.randomize(123);
+
+	CMetricMapBuilderRBPF::TConstructionOptions opts;
+	opts.insertionLinDistance = 0.05f; // Update the map in all the steps:
+	opts.insertionAngDistance = DEG2RAD(1.0f);
+	opts.localizeLinDistance  = 0.05f;
+	opts.localizeAngDistance  = DEG2RAD(1.0f);
+	opts.verbosity_level      = mrpt::utils::LVL_ERROR;
+	opts.PF_options.PF_algorithm = static_cast<CParticleFilter::TParticleFilterAlgorithm>(PF_algorithm);
+	opts.PF_options.sampleSize = nParticles;
+	opts.PF_options.resamplingMethod = CParticleFilter::prSystematic;
+	opts.PF_options.BETA = 1.1; // Always resample
+
+	COccupancyGridMap2D::TMapDefinition def;
+	def.min_x = -6; def.max_x = 8;
+	def.min_y = -5; def.max_y = 7;
+	def.resolution = 0.05f;
+	opts.mapsInitializers.push_back(def);
+
+	opts.predictionOptions.pfOptimalProposal_mapSelection = 0; // ICP against the grid
+	opts.predictionOptions.ICPGlobalAlign_MinQuality = 0.70f;
+
+	CMetricMapBuilderRBPF mapBuilder(opts);
+	mapBuilder.initialize();
+
+	CActionRobotMovement2D::TMotionModelOptions odoOpts;
+	odoOpts.modelSelection = CActionRobotMovement2D::mmGaussian;
+
+	const int NSTEPS = 10, NSTEPS_NOT_TIMED = 2; // The first steps build the initial map
+	CPose2D realPose(-2,-1,0);
+	const CPose2D odoIncr(0.10,0,DEG2RAD(2));
+
+	CTicTac tictac;
+	double T=0;
+	for (int k=0;k<NSTEPS;k++)
+	{
+		realPose = realPose + odoIncr;
+
+		CActionCollection acts;
+		CActionRobotMovement2D odo;
+		odo.computeFromOdometry(odoIncr,odoOpts);
+		acts.insert(odo);
+
+		CSensoryFrame sf;
+		CObservation2DRangeScanPtr scan = CObservation2DRangeScan::Create();
+		simulateRoomScan(realPose,*scan);
+		sf.insert(scan);
+
+		tictac.Tic();
+		mapBuilder.processActionObservation(acts,sf);
+		if (k>=NSTEPS_NOT_TIMED)
+			T+=tictac.Tac();
+	}
+	return T/(NSTEPS-NSTEPS_NOT_TIMED);
+}
+
+// ------------------------------------------------------
+// register_tests_rbpf
+// ------------------------------------------------------
+void register_tests_rbpf()
+{
+	lstTests.push_back( TestData("rbpf-slam: gridmap step, pfStandardProposal, 10 particles",rbpf_test_step, 10, CParticleFilter::pfStandardProposal) );
+	lstTests.push_back( TestData("rbpf-slam: gridmap step, pfStandardProposal, 50 particles",rbpf_test_step, 50, CParticleFilter::pfStandardProposal) );
+	lstTests.push_back( TestData("rbpf-slam: gridmap step, pfOptimalProposal (ICP), 10 particles",rbpf_test_step, 10, CParticleFilter::pfOptimalProposal) );
+	lstTests.push_back( TestData("rbpf-slam: gridmap step, pfOptimalProposal (ICP), 50 particles",rbpf_test_step, 50, CParticleFilter::pfOptimalProposal) );
+	lstTests.push_back( TestData("rbpf-slam: gridmap step, pfAuxiliaryPFOptimal, 10 particles",rbpf_test_step, 10, CParticleFilter::pfAuxiliaryPFOptimal) );
+}
@@ -0,0 +1,171 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/nav/tpspace/CPTG_DiffDrive_C.h>
+#include <mrpt/nav/holonomic/CHolonomicND.h>
+#include <mrpt/nav/holonomic/CHolonomicFullEval.h>
+#include <mrpt/utils/CConfigFileMemory.h>
+
+#include "common.h"
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::nav;
+using namespace mrpt::math;
+using namespace std;
+
+// Note: all the tests in this file are reentrant (no global state), so they can be run in several threads at once.
+
+// A C-PTG (circular arcs) for a 0.7x0.6 m differential-driven robot.
+static void createPTG(CPTG_DiffDrive_C &ptg, int num_paths, double resolution)
+{
+	CConfigFileMemory cfg;
+	cfg.write("PTG","num_paths",num_paths);
+	cfg.write("PTG","refDistance",3.0);
+	cfg.write("PTG","resolution",resolution);
+	cfg.write("PTG","v_max_mps",1.0);
+	cfg.write("PTG","w_max_dps",60.0);
+	cfg.write("PTG","K",1.0);
+	const double shape_x[4]={-0.2,0.5,0.5,-0.2}, shape_y[4]={0.3,0.3,-0.3,-0.3};
+	for (int i=0;i<4;i++)
+	{
+		cfg.write("PTG",mrpt::format("shape_x%i",i),shape_x[i]);
+		cfg.write("PTG",mrpt::format("shape_y%i",i),shape_y[i]);
+	}
+	ptg.loadFromConfigFile(cfg,"PTG");
+	ptg.initialize(std::string() /* no cache file */, false /*verbose*/);
+}
+
+// The obstacle points of a 361 rays scan in the room [-2,4]x[-2,2] with a 0.4 m wide column at (1.5,0.5):
+static void generateObstacles(std::vector<TPoint2D> &obs)
+{
+	obs.clear();
+	for (int i=0;i<361;i++)
+	{
+		const double a = -0.5*M_PI + i*M_PI/360;
+		const double c = cos(a), s = sin(a);
+		double r = 1e9;
+		if (c>1e-9)  r = std::min(r, 4/c);
+		if (s>1e-9)  r = std::min(r, 2/s);
+		if (s<-1e-9) r = std::min(r, -2/s);
+		// The column, approximated as a circle:
+		const double cx=1.5, cy=0.5, R=0.2;
+		const double b = c*cx+s*cy, disc = b*b - (cx*cx+cy*cy-R*R);
+		if (disc>=0 && b-std::sqrt(disc)>0) r = std::min(r, b-std::sqrt(disc));
+		obs.push_back(TPoint2D(r*c,r*s));
+	}
+}
+
+// Building the PTG collision look-up table (resolution in cm).
+double reactivenav_test_ptg_init(int num_paths, int resolution_cm)
+{
+	CTicTac tictac;
+	CPTG_DiffDrive_C ptg;
+	createPTG(ptg,num_paths,resolution_cm*0.01);
+	return tictac.Tac();
+}
+
+// Transforming the obstacles of one scan into TP-Space, as done in each navigation cycle.
+double reactivenav_test_tp_obstacles(int num_paths, int dummy)
+{
+	MRPT_UNUSED_PARAM(dummy);
+	CPTG_DiffDrive_C ptg;
+	createPTG(ptg,num_paths,0.05);
+	std::vector<TPoint2D> obs;
+	generateObstacles(obs);
+
+	const int N = 100;
+	std::vector<double> TP_obstacles;
+	CTicTac tictac;
+	for (int k=0;k<N;k++)
+	{
+		ptg.initTPObstacles(TP_obstacles);
+		for (size_t i=0;i<obs.size();i++)
+			ptg.updateTPObstacle(obs[i].x, obs[i].y, TP_obstacles);
+	}
+	const double T = tictac.Tac()/N;
+	dummy_do_nothing_with_string( mrpt::format("%f",TP_obstacles[0]) );
+	return T;
+}
+
+// Inverse map of the target point from Workspace to TP-Space.
+double reactivenav_test_inverseMap(int num_paths, int dummy)
+{
+	MRPT_UNUSED_PARAM(dummy);
+	CPTG_DiffDrive_C ptg;
+	createPTG(ptg,num_paths,0.05);
+
+	const int N = 10000;
+	int k=0;
+	double d=0, sum_d=0;
+	CTicTac tictac;
+	for (int i=0;i<N;i++)
+	{
+		const double a = -0.5*M_PI + i*M_PI/N;
+		ptg.inverseMap_WS2TP(2.0*cos(a), 2.0*sin(a), k, d);
+		sum_d+=d;
+	}
+	const double T = tictac.Tac()/N;
+	dummy_do_nothing_with_string( mrpt::format("%f",sum_d) );
+	return T;
+}
+
+// One holonomic method decision (0: ND, 1: Full-evaluation) from the TP-Space obstacles of one scan.
+double reactivenav_test_holonomic(int num_paths, int method)
+{
+	CPTG_DiffDrive_C ptg;
+	createPTG(ptg,num_paths,0.05);
+	std::vector<TPoint2D> obs;
+	generateObstacles(obs);
+
+	std::vector<double> TP_obstacles;
+	ptg.initTPObstacles(TP_obstacles);
+	for (size_t i=0;i<obs.size();i++)
+		ptg.updateTPObstacle(obs[i].x, obs[i].y, TP_obstacles);
+	// Normalize distances, as done in CAbstractPTGBasedReactive:
+	const double refDist = ptg.getRefDistance();
+	for (size_t i=0;i<TP_obstacles.size();i++)
+		TP_obstacles[i] = std::min(1.0, TP_obstacles[i]/refDist);
+
+	int target_k;
+	double target_d;
+	ptg.inverseMap_WS2TP(3.5,0.8,target_k,target_d);
+	const double target_alpha = ptg.index2alpha(target_k);
+	const TPoint2D target(cos(target_alpha)*target_d, sin(target_alpha)*target_d);
+
+	CHolonomicND nd;
+	CHolonomicFullEval fe;
+	CAbstractHolonomicReactiveMethod *holo = method==0 ? static_cast<CAbstractHolonomicReactiveMethod*>(&nd) : static_cast<CAbstractHolonomicReactiveMethod*>(&fe);
+
+	const int N = 1000;
+	double dir=0, speed=0;
+	CTicTac tictac;
+	for (int i=0;i<N;i++)
+	{
+		CHolonomicLogFileRecordPtr log;
+		holo->navigate(target, TP_obstacles, 1.0, dir, speed, log, 1.0);
+	}
+	const double T = tictac.Tac()/N;
+	dummy_do_nothing_with_string( mrpt::format("%f",dir) );
+	return T;
+}
+
+// ------------------------------------------------------
+// register_tests_reactivenav
+// ------------------------------------------------------
+void register_tests_reactivenav()
+{
+	lstTests.push_back( TestData("reactivenav: PTG C build collision grid, 101 paths, 10cm",reactivenav_test_ptg_init, 101, 10, true) );
+	lstTests.push_back( TestData("reactivenav: PTG C build collision grid, 201 paths, 5cm",reactivenav_test_ptg_init, 201, 5, true) );
+	lstTests.push_back( TestData("reactivenav: PTG C obstacles to TP-Space, 361 pts, 101 paths",reactivenav_test_tp_obstacles, 101, 0, true) );
+	lstTests.push_back( TestData("reactivenav: PTG C obstacles to TP-Space, 361 pts, 201 paths",reactivenav_test_tp_obstacles, 201, 0, true) );
+	lstTests.push_back( TestData("reactivenav: PTG C inverseMap_WS2TP",reactivenav_test_inverseMap, 101, 0, true) );
+	lstTests.push_back( TestData("reactivenav: holonomic CHolonomicND, 101 paths",reactivenav_test_holonomic, 101, 0, true) );
+	lstTests.push_back( TestData("reactivenav: holonomic CHolonomicFullEval, 101 paths",reactivenav_test_holonomic, 101, 1, true) );
+}
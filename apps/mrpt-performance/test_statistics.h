@@ -0,0 +1,270 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/system.h>
+#include <mrpt/system/vector_loadsave.h>
+#include <mrpt/utils/CFileOutputStream.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+
+/** Statistics of the repeated executions of one test (all times in seconds) */
+struct TTestStats
+{
+	TTestStats() : threads(1), n(0), mean(0), stddev(0), ci95(0), median(0), p90(0), min(0), max(0) { }
+
+	string name;
+	int    threads; //!< Number of threads running the test concurrently
+	size_t n;       //!< Number of measurements (warm-up runs not included)
+	double mean, stddev;
+	double ci95;    //!< Half-width of the 95% confidence interval of the mean
+	double median, p90, min, max;
+};
+
+// Two-tailed 95% quantiles of the Student's t distribution for 1 to 30 degrees of freedom:
+static const double STUDENT_T_95[30] = {
+	12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+// Percentile "p" (in [0,1]) of a sorted sequence, linearly interpolated between samples:
+double sortedPercentile(const vector<double> &v, double p)
+{
+	if (v.empty()) return 0;
+	const double idx = p*(v.size()-1);
+	const size_t i0 = static_cast<size_t>(idx);
+	if (i0+1>=v.size()) return v.back();
+	return v[i0] + (idx-i0)*(v[i0+1]-v[i0]);
+}
+
+void computeTestStats(const vector<double> &samples, TTestStats &s)
+{
+	s.n = samples.size();
+	if (!s.n) return;
+
+	vector<double> v = samples;
+	std::sort(v.begin(),v.end());
+	s.min = v.front();
+	s.max = v.back();
+	s.median = sortedPercentile(v,0.5);
+	s.p90 = sortedPercentile(v,0.9);
+
+	double sum=0;
+	for (size_t i=0;i<s.n;i++) sum+=v[i];
+	s.mean = sum/s.n;
+
+	if (s.n<2)
+	{
+		s.stddev = 0;
+		s.ci95 = s.mean; // We know nothing about the dispersion yet
+		return;
+	}
+	double sum2=0;
+	for (size_t i=0;i<s.n;i++) sum2+=mrpt::utils::square(v[i]-s.mean);
+	s.stddev = std::sqrt(sum2/(s.n-1));
+	const double t = (s.n-1)<=30 ? STUDENT_T_95[s.n-2] : 1.960;
+	s.ci95 = t*s.stddev/std::sqrt(double(s.n));
+}
+
+// ------------------------------------------------------
+//      JSON files of results: save & load
+// ------------------------------------------------------
+string jsonEscape(const string &s)
+{
+	string r;
+	r.reserve(s.size());
+	for (size_t i=0;i<s.size();i++)
+	{
+		const char c = s[i];
+		if (c=='"' || c=='\\') { r+='\\'; r+=c; }
+		else if (static_cast<unsigned char>(c)<0x20) r+=mrpt::format("\\u%04x",int(c));
+		else r+=c;
+	}
+	return r;
+}
+
+bool saveTestStatsToJSON(
+	const string &fil,
+	const vector<TTestStats> &results,
+	const map<string,string> &run_info)
+{
+	CFileOutputStream f;
+	if (!f.open(fil)) return false;
+
+	f.printf("{\n");
+	for (map<string,string>::const_iterator it=run_info.begin();it!=run_info.end();++it)
+		f.printf("\"%s\": \"%s\",\n",jsonEscape(it->first).c_str(), jsonEscape(it->second).c_str());
+	f.printf("\"tests\": [\n");
+	for (size_t i=0;i<results.size();i++)
+	{
+		const TTestStats &s = results[i];
+		f.printf(
+			"{\"name\": \"%s\", \"threads\": %i, \"n\": %u, \"median\": %e, \"mean\": %e, \"stddev\": %e, "
+			"\"ci95\": %e, \"p90\": %e, \"min\": %e, \"max\": %e}%s\n",
+			jsonEscape(s.name).c_str(), s.threads, static_cast<unsigned int>(s.n), s.median, s.mean, s.stddev,
+			s.ci95, s.p90, s.min, s.max,
+			i+1<results.size() ? ",":"");
+	}
+	f.printf("]\n}\n");
+	return true;
+}
+
+// Minimal parser for the files written by saveTestStatsToJSON() (not a generic JSON parser).
+namespace json_parser
+{
+	void skipSpaces(const string &s, size_t &p) { while (p<s.size() && isspace(static_cast<unsigned char>(s[p]))) p++; }
+
+	bool readString(const string &s, size_t &p, string &out)
+	{
+		skipSpaces(s,p);
+		if (p>=s.size() || s[p]!='"') return false;
+		out.clear();
+		for (p++;p<s.size() && s[p]!='"';p++)
+		{
+			if (s[p]=='\\' && p+1<s.size())
+			{
+				p++;
+				if (s[p]=='u' && p+4<s.size())
+				{
+					out+=static_cast<char>(strtol(s.substr(p+1,4).c_str(),NULL,16));
+					p+=4;
+				}
+				else out+=s[p];
+			}
+			else out+=s[p];
+		}
+		if (p>=s.size()) return false;
+		p++; // closing quotes
+		return true;
+	}
+}
+
+bool loadTestStatsFromJSON(const string &fil, vector<TTestStats> &results)
+{
+	using namespace json_parser;
+	results.clear();
+
+	mrpt::vector_byte buf;
+	if (!mrpt::system::loadBinaryFile(buf,fil)) return false;
+	const string s(buf.begin(),buf.end());
+
+	size_t p = s.find("\"tests\"");
+	if (p==string::npos) return false;
+	p = s.find('[',p);
+	if (p==string::npos) return false;
+	p++;
+
+	for (;;)
+	{
+		skipSpaces(s,p);
+		if (p>=s.size()) return false;
+		if (s[p]==']') break;
+		if (s[p]==',') { p++; continue; }
+		if (s[p]!='{') return false;
+		p++;
+
+		TTestStats st;
+		for (;;)
+		{
+			skipSpaces(s,p);
+			if (p>=s.size()) return false;
+			if (s[p]=='}') { p++; break; }
+			if (s[p]==',') { p++; continue; }
+
+			string key;
+			if (!readString(s,p,key)) return false;
+			skipSpaces(s,p);
+			if (p>=s.size() || s[p]!=':') return false;
+			p++;
+			skipSpaces(s,p);
+			if (p<s.size() && s[p]=='"')
+			{
+				string val;
+				if (!readString(s,p,val)) return false;
+				if (key=="name") st.name=val;
+			}
+			else
+			{
+				const char *start = s.c_str()+p;
+				char *end=NULL;
+				const double val = strtod(start,&end);
+				if (end==start) return false;
+				p+= end-start;
+				if      (key=="threads") st.threads = static_cast<int>(val);
+				else if (key=="n")       st.n = static_cast<size_t>(val);
+				else if (key=="median")  st.median = val;
+				else if (key=="mean")    st.mean = val;
+				else if (key=="stddev")  st.stddev = val;
+				else if (key=="ci95")    st.ci95 = val;
+				else if (key=="p90")     st.p90 = val;
+				else if (key=="min")     st.min = val;
+				else if (key=="max")     st.max = val;
+			}
+		}
+		results.push_back(st);
+	}
+	return true;
+}
+
+// ------------------------------------------------------
+//                  run_compare_baseline
+// A test is flagged as a regression (or improvement) if its median
+// changes more than "threshold" (relative), and the change is also larger
+// than the sum of the confidence intervals of both measurements.
+// Returns the number of regressions.
+// ------------------------------------------------------
+int run_compare_baseline(
+	const vector<TTestStats> &results,
+	const string &baseline_file,
+	const double threshold)
+{
+	vector<TTestStats> baseline;
+	if (!loadTestStatsFromJSON(baseline_file,baseline))
+		THROW_EXCEPTION_CUSTOM_MSG1("Error loading baseline file: '%s'",baseline_file.c_str())
+
+	map<string,const TTestStats*> base_by_name;
+	for (size_t i=0;i<baseline.size();i++)
+		base_by_name[baseline[i].name] = &baseline[i];
+
+	cout << "\nComparing against baseline: " << baseline_file << " (threshold: " << 100*threshold << "%)\n";
+	printf("%-60s %12s %12s %9s\n","Test","baseline","current","change");
+
+	int nRegressions=0, nImprovements=0, nMissing=0;
+	for (size_t i=0;i<results.size();i++)
+	{
+		const TTestStats &cur = results[i];
+		map<string,const TTestStats*>::const_iterator it = base_by_name.find(cur.name);
+		if (it==base_by_name.end())
+		{
+			nMissing++;
+			continue;
+		}
+		const TTestStats &base = *it->second;
+		if (base.median<=0) continue;
+
+		const double ratio = cur.median/base.median;
+		const bool significant = std::abs(cur.median-base.median) > cur.ci95+base.ci95;
+
+		TConsoleColor col = CONCOL_NORMAL;
+		const char *verdict = "";
+		if (significant && ratio>1+threshold) { col=CONCOL_RED; verdict="REGRESSION"; nRegressions++; }
+		else if (significant && ratio<1-threshold) { col=CONCOL_GREEN; verdict="improved"; nImprovements++; }
+
+		printf("%-60s %12s %12s ",cur.name.c_str(), mrpt::system::intervalFormat(base.median).c_str(), mrpt::system::intervalFormat(cur.median).c_str());
+		mrpt::system::setConsoleColor(col);
+		printf("%+8.1f%% %s",100*(ratio-1),verdict);
+		mrpt::system::setConsoleColor(CONCOL_NORMAL);
+		printf("\n");
+	}
+
+	cout << "\nSummary: " << nRegressions << " regressions, " << nImprovements << " improvements, "
+		<< nMissing << " tests not in the baseline.\n";
+	return nRegressions;
+}
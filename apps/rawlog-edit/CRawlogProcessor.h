@@ -14,6 +14,13 @@
 #include <mrpt/utils/CFileGZInputStream.h>
 #include <mrpt/utils/CTicTac.h>
 #include <mrpt/system/os.h>
+#include <mrpt/system/threads.h>
+#include <mrpt/system/CThreadPool.h>
+#include <mrpt/synch/CSemaphore.h>
+#include <mrpt/synch/CCriticalSection.h>
+#include <mrpt/synch/CLockFreeQueue.h>
+#include <mrpt/synch/atomic_incr.h>
+#include <map>
 
 // Aparently, TCLAP headers can't be included in more than one source file
 //  or duplicated linking symbols appear! -> Use forward declarations instead:
@@ -21,6 +28,8 @@
 namespace TCLAP {
 	class CmdLine;
 }
+template <typename T>
+bool getArgValue(TCLAP::CmdLine &cmdline, const std::string &arg_name, T &out_val);
 
 namespace mrpt
 {
@@ -28,6 +37,11 @@ namespace mrpt
 	{
 		/** A virtual class that implements the common stuff around parsing a rawlog file
 		  * and (optionally) display a progress indicator to the console.
+		  *
+		  * Operations that reimplement supportsParallelProcessing() to return true are run as a pipeline
+		  * when the user passes `--threads N` (N!=1): a reader thread parses the rawlog, a pool of N
+		  * threads run processOneEntry() on different entries at once, and this thread calls OnPostProcess()
+		  * for each entry in the original order of the file.
 		  */
 		class CRawlogProcessor
 		{
@@ -37,23 +51,51 @@ namespace mrpt
 			bool					verbose;
 			mrpt::system::TTimeStamp m_last_console_update;
 			mrpt::utils::CTicTac	m_timParse;
+			size_t					m_num_threads; //!< From "--threads" (default=1)
 
 		public:
 			uint64_t		m_filSize;
-			size_t			m_rawlogEntry;
+			size_t			m_rawlogEntry; //!< Index of the entry being processed. With parallel processing, use getCurrentEntryIndex() instead.
 			double 			m_timToParse; // Public variable, at end will hold ellapsed time.
 
 			// Ctor
 			CRawlogProcessor(mrpt::utils::CFileGZInputStream &_in_rawlog, TCLAP::CmdLine &_cmdline, bool _verbose) :
-				m_in_rawlog(_in_rawlog),m_cmdline(_cmdline), verbose(_verbose), m_last_console_update( mrpt::system::now() ), m_rawlogEntry(0)
+				m_in_rawlog(_in_rawlog),m_cmdline(_cmdline), verbose(_verbose), m_last_console_update( mrpt::system::now() ), m_num_threads(1), m_rawlogEntry(0), m_pipeline(NULL)
 			{
 				m_filSize = _in_rawlog.getTotalBytesCount();
+
+				if (getArgValue<size_t>(m_cmdline,"threads",m_num_threads) && m_num_threads==0)
+					m_num_threads = mrpt::system::getNumberOfProcessors();
 			}
 
+			virtual ~CRawlogProcessor() { }
+
+			/** Reimplement to return true if processOneEntry() can be safely invoked for different entries from
+			  * different threads at once, i.e. it only modifies the objects it receives and thread-safe counters.
+			  * OnPostProcess() is always called from one thread and in the order of the rawlog. Default: false */
+			virtual bool supportsParallelProcessing() const { return false; }
+
+			/** The number of threads actually used to run processOneEntry() */
+			size_t getThreadCount() const { return supportsParallelProcessing() ? m_num_threads : 1; }
+
+			/** Like \a m_rawlogEntry, but also valid from processOneEntry() while processing in parallel */
+			size_t getCurrentEntryIndex() const
+			{
+				if (!m_pipeline) return m_rawlogEntry;
+				mrpt::synch::CCriticalSectionLocker lock(&m_pipeline->cs_entry_idxs);
+				std::map<unsigned long,size_t>::const_iterator it = m_pipeline->entry_idxs.find(mrpt::system::getCurrentThreadId());
+				return it!=m_pipeline->entry_idxs.end() ? it->second : m_rawlogEntry;
+			}
 
 			// The main method:
 			void doProcessRawlog()
 			{
+				if (getThreadCount()>1)
+				{
+					doProcessRawlogParallel();
+					return;
+				}
+
 				// The 3 different objects we can read from a rawlog:
 				mrpt::obs::CActionCollectionPtr actions;
 				mrpt::obs::CSensoryFramePtr     SF;
@@ -119,6 +161,184 @@ namespace mrpt
 
 			} // end doProcessRawlog
 
+		private:
+			/** One rawlog entry travelling through the pipeline */
+			struct TPipelineEntry
+			{
+				mrpt::obs::CActionCollectionPtr actions;
+				mrpt::obs::CSensoryFramePtr     SF;
+				mrpt::obs::CObservationPtr      obs;
+				size_t   rawlogEntry;
+				uint64_t file_pos;
+				bool     process_ret;
+				std::string error_msg; //!< Non-empty if processOneEntry() raised an exception
+				mrpt::synch::CSemaphore done; //!< Signaled by the worker after processOneEntry()
+				CRawlogProcessor *parent;
+
+				TPipelineEntry(CRawlogProcessor *_parent) : rawlogEntry(0), file_pos(0), process_ret(true), done(0,1), parent(_parent) {}
+			};
+
+			struct TPipeline
+			{
+				mrpt::system::CThreadPool  pool;
+				mrpt::synch::CSemaphore    window;  //!< Limits the number of entries in memory
+				mrpt::synch::CLockFreeQueueSPSC<TPipelineEntry*> queue; //!< Reader -> writer, in file order. NULL marks the end.
+				size_t  abort;  //!< Set by the writer to stop the reader
+				mutable mrpt::synch::CCriticalSection cs_entry_idxs;
+				std::map<unsigned long,size_t>       entry_idxs; //!< Thread ID -> entry being processed
+
+				TPipeline(size_t num_threads, size_t max_entries) :
+					pool(static_cast<unsigned int>(num_threads),max_entries),
+					window(static_cast<unsigned int>(max_entries),static_cast<unsigned int>(max_entries)),
+					queue(max_entries+1),
+					abort(0)
+				{ }
+			};
+			TPipeline *m_pipeline; //!< Only while running doProcessRawlogParallel()
+
+			void thread_pipeline_reader()
+			{
+				TPipeline &pipe = *m_pipeline;
+				for (;;)
+				{
+					pipe.window.waitForSignal();
+					if (mrpt::synch::atomic_load_acquire(&pipe.abort))
+						break;
+
+					TPipelineEntry *e = new TPipelineEntry(this);
+					bool read_ok = false;
+					try
+					{
+						read_ok = mrpt::obs::CRawlog::getActionObservationPairOrObservation(m_in_rawlog, e->actions,e->SF,e->obs, m_rawlogEntry);
+					}
+					catch (std::exception &ex)
+					{
+						std::cerr << "\nError reading rawlog: " << ex.what() << std::endl;
+					}
+					if (!read_ok)
+					{
+						delete e;
+						break;
+					}
+					e->rawlogEntry = m_rawlogEntry;
+					e->file_pos = m_in_rawlog.getPosition();
+
+					pipe.queue.push(e); // Never full, thanks to "window"
+					pipe.pool.enqueue(&CRawlogProcessor::pipeline_worker, e);
+				}
+				pipe.queue.push(NULL);
+			}
+
+			static void pipeline_worker(TPipelineEntry *e)
+			{
+				CRawlogProcessor *me = e->parent;
+				const unsigned long thread_id = mrpt::system::getCurrentThreadId();
+				{
+					mrpt::synch::CCriticalSectionLocker lock(&me->m_pipeline->cs_entry_idxs);
+					me->m_pipeline->entry_idxs[thread_id] = e->rawlogEntry;
+				}
+				try
+				{
+					e->process_ret = me->processOneEntry(e->actions,e->SF,e->obs);
+				}
+				catch (std::exception &ex)
+				{
+					e->error_msg = ex.what();
+					if (e->error_msg.empty()) e->error_msg = "Unknown error";
+				}
+				e->done.release(); // "e" may be deleted from now on
+			}
+
+			void doProcessRawlogParallel()
+			{
+				m_timParse.Tic();
+				if (verbose) std::cout << "[rawlog-edit] Processing with " << m_num_threads << " threads.\n";
+
+				TPipeline pipe(m_num_threads, 4*m_num_threads);
+				m_pipeline = &pipe;
+
+				mrpt::system::TThreadHandle th_reader = mrpt::system::createThreadFromObjectMethod(this, &CRawlogProcessor::thread_pipeline_reader);
+
+				bool aborted = false;
+				std::string error_msg;
+				for (;;)
+				{
+					TPipelineEntry *e = NULL;
+					pipe.queue.pop_wait(e);
+					if (!e) break; // End of the rawlog (or abort)
+
+					e->done.waitForSignal();
+
+					// After an abort, just drain the entries already read:
+					if (!aborted)
+					{
+						if (!e->error_msg.empty())
+						{
+							error_msg = e->error_msg;
+							aborted = true;
+						}
+						else
+						{
+							try
+							{
+								OnPostProcess(e->actions,e->SF,e->obs);
+							}
+							catch (std::exception &ex)
+							{
+								error_msg = ex.what();
+								aborted = true;
+							}
+
+							if (!aborted && !e->process_ret)
+							{
+								std::cerr << "\nParsing stopped due to request from Rawlog filter implementation.\n";
+								aborted = true;
+							}
+						}
+
+						// Abort if the user presses ESC:
+						if (!aborted && mrpt::system::os::kbhit())
+							if (27 == mrpt::system::os::getch())
+							{
+								std::cerr << "Aborted since user pressed ESC.\n";
+								aborted = true;
+							}
+
+						// Update status to the console?
+						const mrpt::system::TTimeStamp tNow = mrpt::system::now();
+						if (verbose && mrpt::system::timeDifference(m_last_console_update,tNow)>0.25)
+						{
+							m_last_console_update = tNow;
+							std::cout << mrpt::format("Progress: %7u objects --- Pos: %9sB/%c%9sB \r",
+								(unsigned int)e->rawlogEntry,
+								mrpt::system::unitsFormat(e->file_pos).c_str(),
+								(e->file_pos>m_filSize ? '>':' '),
+								mrpt::system::unitsFormat(m_filSize).c_str()
+								);  // \r -> don't go to the next line...
+							std::cout.flush();
+						}
+
+						if (aborted)
+							mrpt::synch::atomic_store_release(&pipe.abort, size_t(1));
+					}
+
+					delete e;
+					pipe.window.release();
+				}
+
+				mrpt::system::joinThread(th_reader);
+				pipe.pool.wait();
+				m_pipeline = NULL;
+
+				if(verbose) std::cout << "\n"; // new line after the "\r".
+
+				m_timToParse = m_timParse.Tac();
+
+				if (!error_msg.empty())
+					throw std::runtime_error(error_msg);
+			}
+
+		public:
 
 			// The virtual method of the user to be invoked for each read object:
 			//  Return false to abort and stop the read loop.
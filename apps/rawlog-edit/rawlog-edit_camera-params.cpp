@@ -39,13 +39,12 @@ DECLARE_OP_FUNCTION(op_camera_params)
 		bool   is_stereo;
 
 	public:
-		size_t  m_changedCams;
+		mrpt::synch::CAtomicCounter  m_changedCams;
 
 		CRawlogProcessor_CamParams(CFileGZInputStream &in_rawlog, TCLAP::CmdLine &cmdline, bool verbose) :
-			CRawlogProcessorOnEachObservation(in_rawlog,cmdline,verbose)
+			CRawlogProcessorOnEachObservation(in_rawlog,cmdline,verbose),
+			m_changedCams(0)
 		{
-			m_changedCams = 0;
-
 			// Load .ini file with poses:
 			string   str;
 			getArgValue<string>(cmdline,"camera-params",str);
@@ -86,6 +85,8 @@ DECLARE_OP_FUNCTION(op_camera_params)
 			VERBOSE_COUT << "Type of camera configuration file found: " << (is_stereo ? "stereo":"monocular") << "\n";
 		}
 
+		bool supportsParallelProcessing() const { return true; }
+
 		bool processOneObservation(CObservationPtr  &obs)
 		{
 			if ( strCmpI(obs->sensorLabel,target_label))
@@ -94,14 +95,14 @@ DECLARE_OP_FUNCTION(op_camera_params)
 				{
 					CObservationImagePtr o = CObservationImagePtr(obs);
 					o->cameraParams = new_cam_params;
-					m_changedCams++;
+					++m_changedCams;
 				}
 				else
 				if (IS_CLASS(obs,CObservationStereoImages))
 				{
 					CObservationStereoImagesPtr o = CObservationStereoImagesPtr(obs);
 					o->setStereoCameraParams(new_stereo_cam_params);
-					m_changedCams++;
+					++m_changedCams;
 				}
 			}
 			return true;
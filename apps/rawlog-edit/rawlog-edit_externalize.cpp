@@ -35,14 +35,14 @@ DECLARE_OP_FUNCTION(op_externalize)
 		string outDir;
 
 	public:
-		size_t  entries_converted;
-		size_t  entries_skipped; // Already external
+		mrpt::synch::CAtomicCounter  entries_converted;
+		mrpt::synch::CAtomicCounter  entries_skipped; // Already external
 
 		CRawlogProcessor_Externalize(CFileGZInputStream &in_rawlog, TCLAP::CmdLine &cmdline, bool verbose) :
-			CRawlogProcessorOnEachObservation(in_rawlog,cmdline,verbose)
+			CRawlogProcessorOnEachObservation(in_rawlog,cmdline,verbose),
+			entries_converted(0),
+			entries_skipped(0)
 		{
-			entries_converted = 0;
-			entries_skipped  = 0;
 			getArgValue<string>(cmdline,"image-format",imgFileExtension);
 
 			mrpt::obs::CObservation3DRangeScan::EXTERNALS_AS_TEXT = isFlagSet(cmdline,"txt-externals");
@@ -64,6 +64,9 @@ DECLARE_OP_FUNCTION(op_externalize)
 			outDir+="/";
 		}
 
+		// Each observation is saved to different files:
+		bool supportsParallelProcessing() const { return true; }
+
 		bool processOneObservation(CObservationPtr  &obs)
 		{
 			const string label_time = format("%s_%f", obs->sensorLabel.c_str(), timestampTotime_t(obs->timestamp) );
@@ -76,18 +79,18 @@ DECLARE_OP_FUNCTION(op_externalize)
 					const string fileName = string("img_") + label_time + string("_left.") + imgFileExtension;
 					obsSt->imageLeft.saveToFile( outDir + fileName );
 					obsSt->imageLeft.setExternalStorage( fileName );
-					entries_converted++;
+					++entries_converted;
 				}
-				else entries_skipped++;
+				else ++entries_skipped;
 
 				if (!obsSt->imageRight.isExternallyStored())
 				{
 					const string fileName = string("img_") + label_time + string("_right.") + imgFileExtension;
 					obsSt->imageRight.saveToFile( outDir + fileName );
 					obsSt->imageRight.setExternalStorage( fileName );
-					entries_converted++;
+					++entries_converted;
 				}
-				else entries_skipped++;
+				else ++entries_skipped;
 			}
 			else if (IS_CLASS(obs, CObservationImage ) )
 			{
@@ -98,9 +101,9 @@ DECLARE_OP_FUNCTION(op_externalize)
 					const string fileName = string("img_") + label_time +string(".")+ imgFileExtension;
 					obsIm->image.saveToFile( outDir + fileName );
 					obsIm->image.setExternalStorage( fileName );
-					entries_converted++;
+					++entries_converted;
 				}
-				else entries_skipped++;
+				else ++entries_skipped;
 			}
 			else if (IS_CLASS(obs, CObservation3DRangeScan ) )
 			{
@@ -113,9 +116,9 @@ DECLARE_OP_FUNCTION(op_externalize)
 					const string fileName = string("3DCAM_") + label_time + string("_INT.") + imgFileExtension;
 					obs3D->intensityImage.saveToFile( outDir + fileName );
 					obs3D->intensityImage.setExternalStorage( fileName );
-					entries_converted++;
+					++entries_converted;
 				}
-				else entries_skipped++;
+				else ++entries_skipped;
 
 				// Confidence channel:
 				if (obs3D->hasConfidenceImage && !obs3D->confidenceImage.isExternallyStored())
@@ -123,27 +126,27 @@ DECLARE_OP_FUNCTION(op_externalize)
 					const string fileName = string("3DCAM_") + label_time + string("_CONF.") + imgFileExtension;
 					obs3D->confidenceImage.saveToFile( outDir + fileName );
 					obs3D->confidenceImage.setExternalStorage( fileName );
-					entries_converted++;
+					++entries_converted;
 				}
-				else entries_skipped++;
+				else ++entries_skipped;
 
 				// 3D points:
 				if (obs3D->hasPoints3D && !obs3D->points3D_isExternallyStored())
 				{
 					const string fileName = string("3DCAM_") + label_time + string("_3D.bin");
 					obs3D->points3D_convertToExternalStorage(fileName, outDir);
-					entries_converted++;
+					++entries_converted;
 				}
-				else entries_skipped++;
+				else ++entries_skipped;
 
 				// Range image:
 				if (obs3D->hasRangeImage  && !obs3D->rangeImage_isExternallyStored())
 				{
 					const string fileName = string("3DCAM_") + label_time + string("_RANGES.bin");
 					obs3D->rangeImage_convertToExternalStorage(fileName, outDir);
-					entries_converted++;
+					++entries_converted;
 				}
-				else entries_skipped++;
+				else ++entries_skipped;
 			}
 
 			return true;
@@ -30,14 +30,16 @@ DECLARE_OP_FUNCTION(op_generate_3d_pointclouds)
 		TOutputRawlogCreator	outrawlog;
 
 	public:
-		size_t  entries_modified;
+		mrpt::synch::CAtomicCounter  entries_modified;
 
 		CRawlogProcessor_Generate3DPointClouds(CFileGZInputStream &in_rawlog, TCLAP::CmdLine &cmdline, bool verbose) :
-			CRawlogProcessorOnEachObservation(in_rawlog,cmdline,verbose)
+			CRawlogProcessorOnEachObservation(in_rawlog,cmdline,verbose),
+			entries_modified(0)
 		{
-			entries_modified = 0;
 		}
 
+		bool supportsParallelProcessing() const { return true; }
+
 		bool processOneObservation(CObservationPtr  &obs)
 		{
 			if (IS_CLASS(obs, CObservation3DRangeScan ) )
@@ -46,8 +48,9 @@ DECLARE_OP_FUNCTION(op_generate_3d_pointclouds)
 				if (obs3D->hasRangeImage)
 				{
 					obs3D->load();  // We must be sure that depth has been loaded, if stored separately.
-					obs3D->project3DPointsFromDepthImage();
-					entries_modified++;
+					// The projection LUT is shared by all objects: don't use it from several threads, in case there are different cameras
+					obs3D->project3DPointsFromDepthImage(getThreadCount()==1);
+					++entries_modified;
 				}
 			}
 
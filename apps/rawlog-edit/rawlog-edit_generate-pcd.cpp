@@ -34,31 +34,33 @@ DECLARE_OP_FUNCTION(op_generate_pcd)
 	protected:
 
 	public:
-		size_t  entries_done;
+		mrpt::synch::CAtomicCounter  entries_done;
 		std::string  m_outdir;
 
 		CRawlogProcessor_GeneratePCD(CFileGZInputStream &in_rawlog, TCLAP::CmdLine &cmdline, bool verbose) :
-			CRawlogProcessorOnEachObservation(in_rawlog,cmdline,verbose)
+			CRawlogProcessorOnEachObservation(in_rawlog,cmdline,verbose),
+			entries_done(0)
 		{
-			entries_done = 0;
 			getArgValue<std::string>(cmdline,"out-dir",  m_outdir);
 
 			if (!mrpt::system::directoryExists(m_outdir))
 				throw std::runtime_error(string("ERROR: Output directory does not exist: ")+m_outdir);
 		}
 
+		bool supportsParallelProcessing() const { return true; }
+
 		bool processOneObservation(CObservationPtr  &obs)
 		{
 			const string label_time = format("%s/%06u_%s_%f.pcd",
 				m_outdir.c_str(),
-				static_cast<unsigned int>(m_rawlogEntry),
+				static_cast<unsigned int>(getCurrentEntryIndex()),
 				obs->sensorLabel.empty() ? "NOLABEL" : obs->sensorLabel.c_str(),
 				timestampTotime_t(obs->timestamp) );
 			if (IS_CLASS(obs, CObservation3DRangeScan ) )
 			{
 				CObservation3DRangeScanPtr obs3D = CObservation3DRangeScanPtr(obs);
 				if (obs3D->hasRangeImage && !obs3D->hasPoints3D)
-					obs3D->project3DPointsFromDepthImage();
+					obs3D->project3DPointsFromDepthImage(getThreadCount()==1); // See op_generate_3d_pointclouds
 
 				if (obs3D->hasPoints3D)
 				{
@@ -68,7 +70,7 @@ DECLARE_OP_FUNCTION(op_generate_pcd)
 					map.insertObservation(obs3D.pointer());
 					if (!map.savePCDFile(label_time,false /* not bin format*/))
 						throw std::runtime_error(string("ERROR: While saving file: ")+label_time);
-					entries_done++;
+					++entries_done;
 				}
 			}
 			else
@@ -82,7 +84,7 @@ DECLARE_OP_FUNCTION(op_generate_pcd)
 				map.insertObservation(obs2D.pointer());
 				if (!map.savePCDFile(label_time,false /* not bin format*/))
 					throw std::runtime_error(string("ERROR: While saving file: ")+label_time);
-				entries_done++;
+				++entries_done;
 			}
 
 			return true;
@@ -292,6 +292,7 @@ DECLARE_OP_FUNCTION(op_export_gps_txt)
 
 		map<string, FILE*>	lstFiles;
 		TGeodeticCoords 	refCoords;
+		CGeodeticToENU_WGS84	refCoords_ENU; //!< Cached ENU transformation around refCoords
 		CPose3D 			local_ENU;
 		string				m_filPrefix;
 
@@ -445,19 +446,16 @@ DECLARE_OP_FUNCTION(op_export_gps_txt)
 					TPose3D _local_ENU;
 					mrpt::topography::ENU_axes_from_WGS84(refCoords, _local_ENU, true);
 					local_ENU = _local_ENU;
-				}
 
-				// Local XYZ coordinates transform:
-				mrpt::topography::geodeticToENU_WGS84(
-					gga.getAsStruct<TGeodeticCoords>(),
-					p,
-					refCoords);
+					refCoords_ENU.setOrigin(refCoords);
+				}
 
-				// Geocentric XYZ:
+				// Local XYZ coordinates transform, and geocentric XYZ:
 				TPoint3D geo;
-				mrpt::topography::geodeticToGeocentric_WGS84(
+				refCoords_ENU.convert(
 					gga.getAsStruct<TGeodeticCoords>(),
-					geo );
+					p,
+					&geo);
 
 				// Save file:
 				double 	tim = mrpt::system::timestampTotime_t(obs->timestamp);
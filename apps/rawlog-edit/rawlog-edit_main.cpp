@@ -91,8 +91,14 @@ TCLAP::ValueArg<double> arg_odo_KL  ("","odo-KL",  "Constant from encoder ticks
 TCLAP::ValueArg<double> arg_odo_KR  ("","odo-KR",  "Constant from encoder ticks to meters (right wheel), used in --recalc-odometry.",false,0,"KR",cmd);
 TCLAP::ValueArg<double> arg_odo_D   ("","odo-D",   "Distance between left-right wheels (meters), used in --recalc-odometry.",false,0,"D",cmd);
 
+TCLAP::ValueArg<size_t> arg_threads("","threads","Number of threads for the operations that can process several entries in parallel: --externalize, --camera-params, --stereo-rectify, --generate-3d-pointclouds, --generate-pcd. 0 means one per CPU core (default=1)",false,1,"N",cmd);
+
 TCLAP::SwitchArg arg_overwrite("w","overwrite","Force overwrite target file without prompting.",cmd, false);
 
+TCLAP::SwitchArg arg_legacy_format("","legacy-format","Write the output rawlog without the dictionary of class IDs (which only writes the name of each class once), so it can be read by MRPT versions older than 1.5.0.",cmd, false);
+
+TCLAP::ValueArg<size_t> arg_image_cache("","image-cache-size","Memory (in MiB) for the cache of decoded delayed-load images, which are also decoded in advance in worker threads while reading the rawlog. 0 disables it (default=128)",false,128,"MiB",cmd);
+
 TCLAP::SwitchArg arg_quiet("q","quiet","Terse output",cmd, false);
 
 
@@ -351,6 +357,7 @@ int main(int argc, char **argv)
 		else {
 			VERBOSE_COUT << "Warning: No external storage directory was found (not an issue if the rawlog does not contain delayed-load images).\n";
 		}
+		CImage::setExternalImagesCacheSize(arg_image_cache.getValue()*1024*1024);
 
 
 		// ------------------------------------
@@ -394,6 +401,7 @@ TOutputRawlogCreator::TOutputRawlogCreator()
 
 	if (!out_rawlog.open(out_rawlog_filename))
 		throw runtime_error(string("*ABORTING*: Cannot open output file: ") + out_rawlog_filename );
+	out_rawlog.enableClassIDDictionary( !arg_legacy_format.getValue() );
 }
 
 bool isFlagSet(TCLAP::CmdLine &cmdline, const std::string &arg_name)
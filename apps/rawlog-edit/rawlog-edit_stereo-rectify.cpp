@@ -34,20 +34,19 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 		string   imgFileExtension;
 		double   rectify_alpha; // [0,1] see cvStereoRectify()
 
-		bool     m_this_obs_is_ok;
-
 		mrpt::vision::CStereoRectifyMap   rectify_map;
+		mrpt::synch::CCriticalSection     rectify_map_cs; //!< Protects the initialization of rectify_map
 
-		size_t  m_num_external_files_failures;
+		mrpt::synch::CAtomicCounter  m_num_external_files_failures;
 
 	public:
-		size_t  m_changedCams;
+		mrpt::synch::CAtomicCounter  m_changedCams;
 
 		CRawlogProcessor_StereoRectify(CFileGZInputStream &in_rawlog, TCLAP::CmdLine &cmdline, bool verbose) :
-			CRawlogProcessorOnEachObservation(in_rawlog,cmdline,verbose)
+			CRawlogProcessorOnEachObservation(in_rawlog,cmdline,verbose),
+			m_num_external_files_failures(0),
+			m_changedCams(0)
 		{
-			m_changedCams = 0;
-			m_num_external_files_failures = 0;
 
 			// Load .ini file with poses:
 			string   str;
@@ -107,10 +106,10 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 			}
 		}
 
+		bool supportsParallelProcessing() const { return true; }
+
 		bool processOneObservation(CObservationPtr  &obs)
 		{
-		    m_this_obs_is_ok = true;
-
 			if ( strCmpI(obs->sensorLabel,target_label))
 			{
 				if (IS_CLASS(obs,CObservationStereoImages))
@@ -120,11 +119,14 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 					try
 					{
                         // Already initialized the rectification map?
-                        if (!rectify_map.isSet())
                         {
-                            // On the first ocassion, initialize map:
-                            rectify_map.setAlpha( rectify_alpha );
-                            rectify_map.setFromCamParams( *o );
+                            mrpt::synch::CCriticalSectionLocker lock(&rectify_map_cs);
+                            if (!rectify_map.isSet())
+                            {
+                                // On the first ocassion, initialize map:
+                                rectify_map.setAlpha( rectify_alpha );
+                                rectify_map.setFromCamParams( *o );
+                            }
                         }
 
 			// This is needed to raise an exception of the correct type that reveal any missing external file:
@@ -132,8 +134,9 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 			o->imageRight.getWidth();
 
                         // This call rectifies the images in-place and also updates
-                        // all the camera parameters as needed:
-                        rectify_map.rectify(*o);
+                        // all the camera parameters as needed.
+                        // The internal memory cache can't be shared between threads:
+                        rectify_map.rectify(*o, getThreadCount()==1);
 
                         const string label_time = format("%s_%f", o->sensorLabel.c_str(), timestampTotime_t(o->timestamp) );
                         {
@@ -146,17 +149,17 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
                             o->imageRight.saveToFile( outDir + fileName );
                             o->imageRight.setExternalStorage( fileName );
                         }
-                        m_changedCams++;
+                        ++m_changedCams;
 					}
 					catch (mrpt::utils::CExceptionExternalImageNotFound &)
 					{
 					    const size_t MAX_FAILURES = 1000;
-					    m_num_external_files_failures++;
+					    ++m_num_external_files_failures;
 
-					    if (m_num_external_files_failures<MAX_FAILURES)
+					    if (size_t(m_num_external_files_failures)<MAX_FAILURES)
 					    {
-					        m_this_obs_is_ok = false;
-                            cerr << "\n *WARNING*: Dropping one observation due to missing external image file at rawlog entry " << m_rawlogEntry << endl;
+					        obs.clear(); // Free object (all aliases), so it's not saved.
+                            cerr << "\n *WARNING*: Dropping one observation due to missing external image file at rawlog entry " << getCurrentEntryIndex() << endl;
 					    }
 					    else
 					    {
@@ -174,12 +177,21 @@ DECLARE_OP_FUNCTION(op_stereo_rectify)
 			mrpt::obs::CSensoryFramePtr     &SF,
 			mrpt::obs::CObservationPtr      &obs)
 		{
-		    if (!m_this_obs_is_ok) return;
-
-			ASSERT_((actions && SF) || obs)
 			if (actions)
-					outrawlog.out_rawlog << actions << SF;
-			else	outrawlog.out_rawlog << obs;
+			{
+				ASSERT_(SF)
+				// Remove from SF those observations dropped:
+				mrpt::obs::CSensoryFrame::iterator it = SF->begin();
+				while (it!=SF->end())
+				{
+					if ( (*it).present() )
+						it++;
+					else it = SF->erase(it);
+				}
+				outrawlog.out_rawlog << actions << SF;
+			}
+			else if (obs)
+				outrawlog.out_rawlog << obs;
 		}
 
 	};
@@ -21,6 +21,7 @@
 #include <mrpt/utils/CFileGZOutputStream.h>
 #include <mrpt/utils/CImage.h>
 #include <mrpt/utils/round.h>
+#include <mrpt/utils/CTicTac.h>
 #include <mrpt/obs/CActionCollection.h>
 #include <mrpt/obs/CSensoryFrame.h>
 #include <mrpt/obs/CObservationOdometry.h>
@@ -29,6 +30,7 @@
 #include <mrpt/obs/CActionRobotMovement2D.h>
 #include <mrpt/system/os.h>
 #include <mrpt/system/filesystem.h>
+#include <mrpt/synch/CLockFreeQueue.h>
 
 #ifdef RAWLOGGRABBER_PLUGIN
 #	include "rawloggrabber_plugin.h"
@@ -57,8 +59,8 @@ void SensorThread(TThreadParams params);
 
 
 
-CGenericSensor::TListObservations		global_list_obs;
-synch::CCriticalSection					cs_global_list_obs;
+// All sensor threads push here their observations, which are written to disk by the main thread as soon as they arrive:
+synch::CLockFreeQueueMPMC<CGenericSensor::TListObsPair>	global_obs_queue(4096);
 
 bool									allThreadsMustExit = false;
 
@@ -169,24 +171,36 @@ int main(int argc, char **argv)
 		out_file.open( rawlog_filename, rawlog_GZ_compress_level );
 
 		CSensoryFrame						curSF;
+		CGenericSensor::TListObservations	global_list_obs;  // Objects received, sorted by timestamp, not saved yet.
 		CGenericSensor::TListObservations	copy_of_global_list_obs;
+		CTicTac								timeSinceLastObs;
 
 		cout << endl << "Press any key to exit program" << endl;
-		while (!os::kbhit() && !allThreadsMustExit)
+		for (;;)
 		{
-			// See if we have observations and process them:
+			const bool must_exit = os::kbhit() || allThreadsMustExit;
+
+			// Sleep until new observations arrive (the timeout is only to check the keyboard):
+			CGenericSensor::TListObsPair newObs;
+			if (!must_exit && global_obs_queue.pop_wait(newObs, 100))
 			{
-				synch::CCriticalSectionLocker	lock (&cs_global_list_obs);
-				copy_of_global_list_obs.clear();
+				global_list_obs.insert(newObs);
+				while (global_obs_queue.pop(newObs))
+					global_list_obs.insert(newObs);
+				timeSinceLastObs.Tic();
+			}
 
-				if (!global_list_obs.empty())
-				{
-					CGenericSensor::TListObservations::iterator itEnd = global_list_obs.begin();
-					std::advance( itEnd, global_list_obs.size() / 2 );
-					copy_of_global_list_obs.insert(global_list_obs.begin(),itEnd );
-					global_list_obs.erase(global_list_obs.begin(), itEnd);
-				}
-			}	// End of cs lock
+			// Objects from different sensors may arrive out of order: only save those older than the
+			//  newest one by GRABBER_PERIOD_MS, or all of them if nothing has arrived for that time or we are exiting.
+			copy_of_global_list_obs.clear();
+			if (!global_list_obs.empty())
+			{
+				CGenericSensor::TListObservations::iterator itEnd = global_list_obs.end();
+				if (!must_exit && timeSinceLastObs.Tac()*1000<GRABBER_PERIOD_MS)
+					itEnd = global_list_obs.upper_bound( mrpt::system::timestampAdd(global_list_obs.rbegin()->first, -1e-3*GRABBER_PERIOD_MS) );
+				copy_of_global_list_obs.insert(global_list_obs.begin(),itEnd );
+				global_list_obs.erase(global_list_obs.begin(), itEnd);
+			}
 
 			if (use_sensoryframes)
 			{
@@ -348,7 +362,9 @@ int main(int argc, char **argv)
 					cout << "[" << dateTimeToString(now()) << "] Saved " << copy_of_global_list_obs.size() << " objects." << endl;
 				}
 			}
-			sleep(GRABBER_PERIOD_MS);
+
+			if (must_exit)
+				break;
 		}
 
 		if (allThreadsMustExit) {
@@ -424,10 +440,9 @@ void SensorThread(TThreadParams params)
 			CGenericSensor::TListObservations	lstObjs;
 			sensor->getObservations( lstObjs );
 
-			{
-				synch::CCriticalSectionLocker	lock (&cs_global_list_obs);
-				global_list_obs.insert( lstObjs.begin(), lstObjs.end() );
-			}
+			for (CGenericSensor::TListObservations::const_iterator it=lstObjs.begin();it!=lstObjs.end();++it)
+				while (!global_obs_queue.push(*it) && !allThreadsMustExit)
+					sleep(1);  // The main thread is saving to disk slower than we grab: wait for it.
 
 			lstObjs.clear();
 
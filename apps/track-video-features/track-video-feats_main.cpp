@@ -417,6 +417,8 @@ int main(int argc, char **argv)
 
 				// For delayed-load images:
 				CImage::IMAGES_PATH_BASE = CRawlog::detectImagesDirectory(fil);
+				// Let the camera decode the images of each observation in parallel, in worker threads:
+				CImage::setExternalImagesCacheSize(128*1024*1024);
 
 				cam->loadConfig(cfg,"CONFIG");
 				cam->initialize();	// This will raise an exception if neccesary
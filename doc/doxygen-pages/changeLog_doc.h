@@ -22,11 +22,30 @@
 			- Now displays a textual and graphical representation of all observation timestamps, useful to quickly detect sensor "shortages" or temporary failures.
 			- New menu operation: "Edit" -> "Rename selected observation"
 			- mrpt::obs::CObservation3DRangeScan pointclouds are now shown in local coordinates wrt to the vehicle/robot, not to the sensor.
-		- [rawlog-edit](http://www.mrpt.org/list-of-mrpt-apps/application-rawlog-edit/): New flag: `--txt-externals`
+		- [rawlog-edit](http://www.mrpt.org/list-of-mrpt-apps/application-rawlog-edit/):
+			- New flag: `--txt-externals`
+			- New flag `--threads N`: operations which process each entry independently (`--externalize`, `--camera-params`, `--stereo-rectify`, `--generate-3d-pointclouds`, `--generate-pcd`) run in N threads, while a reader thread parses the input and the output keeps the original order of entries.
+		- mrpt-performance:
+			- Each test is now run several times after warm-up runs, until the 95% confidence interval of its mean time is small enough. Median, mean, CI and 90th percentile times are reported.
+			- New flags: `--warmup`, `--min-reps`, `--max-reps`, `--ci`, `--max-time`, `--pin-cpu`, `--threads` (run reentrant tests in several threads at once).
+			- Results can be saved as JSON (`--json`) and compared against a baseline (`--baseline`, `--threshold`, `--compare-json`), flagging significant regressions.
+			- New test suites: RBPF-SLAM steps, reactive navigation steps (PTGs and holonomic methods) and rawlog I/O.
+		- [rawlog-grabber](http://www.mrpt.org/list-of-mrpt-apps/application-rawlog-grabber/): sensor threads pass observations to the main thread through a lock-free queue, and the main thread saves them as soon as they arrive instead of polling every `GRABBER_PERIOD_MS`. This parameter is now the time window used to sort observations from different sensors by timestamp.
 	- Changes in libraries:
 		- \ref mrpt_base_grp
 			- New API to interface ZeroMQ: \ref noncstream_serialization_zmq
 			- Deprecated function (since 1.3.0) deleted: mrpt::system::registerFatalExceptionHandlers()
+			- New lock-free, bounded queues mrpt::synch::CLockFreeQueueSPSC and mrpt::synch::CLockFreeQueueMPMC, with optional blocking wait (see mrpt::synch::CEventCount), and new atomic operations mrpt::synch::atomic_load_acquire(), etc.
+			- New work-stealing thread pool mrpt::system::CThreadPool, and a pool shared by the whole process: mrpt::system::globalThreadPool()
+			- [ABI change] mrpt::utils::CStream can now write objects with a per-stream dictionary of class IDs, so class names are only stored once per stream: see mrpt::utils::CStream::enableClassIDDictionary(). Disabled by default for generic streams, but used by mrpt::obs::CRawlog::saveToRawLogFile() and the output of `rawlog-edit` (new flag `--legacy-format` to write rawlogs readable by older MRPT versions); reading always supports both formats.
+			- Faster (de)serialization of large payloads: mrpt::math::CMatrix and mrpt::math::CMatrixD are read/written in one block, and mrpt::utils::CImage reuses its current buffer when reading an image of the same size.
+			- New class mrpt::utils::CFileMMapInputStream: a file stream mapped in memory, and new method mrpt::utils::CStream::ReadBufferInPlace() to read from memory-based streams without copying. mrpt::maps::CSimpleMap::loadFromFile(), mrpt::obs::CRawlog::loadFromRawLogFile() and mrpt::slam::CMetricMapBuilder::loadCurrentMapFromFile() map uncompressed files in memory (see mrpt::compress::zip::is_gz_file()).
+			- [ABI change] All mrpt::utils::CObject-derived objects (observations, sensory frames, poses,...) are now allocated in a lock-free, size-class based memory pool, mrpt::system::CObjectMemoryPool, which reuses freed blocks instead of calling the system allocator. It can be disabled with the environment variable `MRPT_DISABLE_OBJECT_POOL`.
+			- mrpt::utils::CTimeLogger has a new thread-safe, low-overhead tracing mode with per-thread event buffers, sampling and ring-buffer capture, and export to the Chrome trace format: see mrpt::utils::CTimeLogger::enableTracing(), mrpt::utils::CTimeLogger::saveToChromeTraceFile()
+			- New batch (SSE2-vectorized) point transformations over separate arrays of coordinates: mrpt::poses::CPose3D::composePoints(), mrpt::poses::CPose3D::inverseComposePoints() and the same methods in mrpt::poses::CPose2D and mrpt::poses::CPose3DQuat. Batch pose compositions and Jacobians in mrpt::poses::SE_traits (e.g. mrpt::poses::SE_traits<3>::composePoses()). Used in mrpt::maps::CPointsMap::changeCoordinatesReference(), mrpt::maps::CPointsMap::insertAnotherMap() and 3D point matching.
+			- Externally-stored mrpt::utils::CImage images: decoded images can be kept in a process-wide LRU cache (disabled by default, see mrpt::utils::CImage::setExternalImagesCacheSize()), and they can be decoded in advance in a worker thread with the new method mrpt::utils::CImage::prefetch(). The cache is enabled in camera-calib, track-video-features (for rawlogs) and rawlog-edit (new argument `--image-cache-size`).
+			- New method mrpt::math::CSparseMatrix::getColumnCompressedValues() to refill the values of a sparse matrix with a fixed structure.
+			- New generic, parallel RANSAC engine mrpt::math::RANSAC_Engine, with early termination of hypotheses scoring, batched (SIMD-friendly) sample scoring, optional T(d,d) pre-test and PROSAC sampling. mrpt::math::RANSAC_Template and mrpt::math::ModelSearch::ransacSingleModel() now run on it, and mrpt::math::ransac_detect_3D_planes() and mrpt::math::ransac_detect_2D_lines() use SSE2 to score points.
 			- New method mrpt::poses::CPosePDFParticles::resetAroundSetOfPoses()
 			- Class mrpt::utils::CRobotSimulator renamed ==> mrpt::kinematics::CVehicleSimul_DiffDriven
 			- New twist (linear + angular velocity state) classes: mrpt::math::TTwist2D, mrpt::math::TTwist3D
@@ -46,9 +65,15 @@
 			- Removed support for **named** semaphores in mrpt::synch::CSemaphore
 		- \ref mrpt_bayes_grp
 			-  [API change] `verbose` is no longer a field of mrpt::bayes::CParticleFilter::TParticleFilterOptions. Use the setVerbosityLevel() method of the CParticleFilter class itself.
+			- New Kalman filter method mrpt::bayes::kfCEKF (Compressed EKF), whose per-step cost depends on the size of the "active area" only, not on the size of the whole map. See mrpt::bayes::CKalmanFilterCapable::applyGlobalUpdate()
+			- [ABI & API change] Particles of mrpt::poses::CPosePDFParticles and mrpt::poses::CPose3DPDFParticles (and hence of mrpt::slam::CMonteCarloLocalization2D and mrpt::slam::CMonteCarloLocalization3D) are now stored by value in a contiguous `std::vector`, without one heap allocation per particle: `m_particles[i].d` is now a `CPose2D`/`CPose3D` instead of a pointer. Resampling of these classes is a gather into a reused buffer. See the new template argument mrpt::bayes::TParticleStorageMode of mrpt::bayes::CParticleFilterData and mrpt::bayes::CProbabilityParticle::dataPtr() to write code valid for both storage modes.
+			- mrpt::bayes::CParticleFilterCapable::computeResampling() is now O(N) for all the methods (vectorized cumulative weights and a merge of sorted targets, in parallel if built with TBB), and honors `out_particle_count` for all of them. mrpt::bayes::CParticleFilterCapable::fastDrawSample() draws in O(log N) for a dynamic number of particles.
+			- [Bug fix] mrpt::bayes::CParticleFilterCapable::performResampling() did not reset the particle weights after resampling.
 		- \ref mrpt_gui_grp
 			- mrpt::gui::CMyGLCanvasBase is now derived from mrpt::opengl::CTextMessageCapable so they can draw text labels
 			- New class mrpt::gui::CDisplayWindow3DLocker for exception-safe 3D scene lock in 3D windows.
+		- \ref mrpt_hmtslam_grp
+			- mrpt::hmtslam::CHMTSLAM: the LSLAM thread reports its throughput (observations/s) in the log. Fixed the lock of the topological loop-closure detectors in the TBI thread, which was not held.
 		- \ref mrpt_kinematics_grp
 			- New classes for 2D robot simulation:
 				- mrpt::kinematics::CVehicleSimul_DiffDriven
@@ -56,19 +81,35 @@
 		- \ref mrpt_maps_grp
 			- mrpt::maps::COccupancyGridMap2D::loadFromBitmapFile() correct description of `yCentralPixel` parameter.
 			- mrpt::maps::CPointsMap `liblas` import/export methods are now in a separate header. See \ref mrpt_maps_liblas_grp and \ref dep-liblas
+			- New class mrpt::maps::CTiledOccupancyGridMap2D: an occupancy grid of unbounded size made of lazily-allocated tiles, which never needs resizing and can swap out least recently used tiles to disk. Usable from mrpt::maps::CMultiMetricMap config files as `tiledOccupancyGrid`.
+			- mrpt::maps::COctoMap and mrpt::maps::CColouredOctoMap: faster insertion of dense point clouds:
+				- Rays are cast in parallel (if built with TBB) and voxels are updated in one batched pass in octree order.
+				- New option `TInsertionOptions::discretizeScan` to merge all the rays ending in the same voxel.
+				- [Behavior change] mrpt::maps::COctoMapBase::insertPointCloud() now updates each voxel once per call, like insertObservation() does, instead of once per ray.
+				- computeObservationLikelihood() reuses the tree look-up of consecutive points in the same voxel.
 		- \ref mrpt_obs_grp
 			- [ABI change] mrpt::obs::CObservation3DRangeScan:
 				- Now uses more SSE2 optimized code
 				- Depth filters are now available for mrpt::obs::CObservation3DRangeScan::project3DPointsFromDepthImageInto() and  mrpt::obs::CObservation3DRangeScan::convertTo2DScan()
 				- New switch mrpt::obs::CObservation3DRangeScan::EXTERNALS_AS_TEXT for runtime selection of externals format.
+				- mrpt::obs::CObservation3DRangeScan::project3DPointsFromDepthImageInto() now does range filtering, projection, coloring and 6D transformation in one single pass, in parallel for the different rows (if built with TBB), writing directly into the output point cloud. New option mrpt::obs::T3DPointsProjectionParams::decimation.
+				- mrpt::obs::CObservation3DRangeScan::convertTo2DScan() evaluates range filters once in a single row-major pass.
 			- mrpt::obs::CObservation2DRangeScan now has an optional field for intensity.
+			- New virtual method mrpt::obs::CObservation::prefetch() to start decoding in parallel the delayed-load images of an observation. mrpt::obs::CRawlog calls it for the next entries when read sequentially, and for the entries just read from a rawlog stream.
 			- mrpt::obs::CRawLog can now holds objects of arbitrary type, not only actions/observations. This may be useful for richer logs aimed at debugging.
 		- \ref mrpt_opengl_grp
 			- [ABI change] mrpt::opengl::CAxis now has many new options exposed to configure its look.
+			- [ABI change] mrpt::opengl::CPointCloud and mrpt::opengl::CPointCloudColoured render from OpenGL vertex buffer objects (new class mrpt::opengl::CVertexBufferObject), uploaded only when the cloud changes, instead of issuing all points in immediate mode in each frame. The octree is only used to select the visible nodes and the number of points to draw from each one. Can be disabled with mrpt::global_settings::OPENGL_USE_VERTEX_BUFFER_OBJECTS. New `mrpt-performance` tests with mrpt::opengl::CFBORender.
 		- \ref mrpt_slam_grp
 			- [API change] mrpt::slam::CMetricMapBuilder::TOptions does not have a `verbose` field anymore. It's supersedded now by the verbosity level of the CMetricMapBuilder class itself.
+			- mrpt::slam::data_association_full_covariance() is much faster: each prediction covariance is inverted only once, with fixed-size matrices for 2D/3D features; the KD-tree only returns the predictions close enough to be compatible; the IC matrix and the first level of JCBB branches are evaluated in parallel (if built with TBB).
+			- Particle filters with a KLD-based dynamic number of samples (mrpt::slam::PF_implementation) keep the occupied bins in a hash table instead of a `std::set`.
+			- New class mrpt::slam::CCorrelativeScanMatcher2D: a real-time correlative 2D scan matcher, with an exhaustive search of (x,y,phi) over a lookup table of the last scans, with precomputed rotations of the new scan, followed by ICP against those scans.
+			- [ABI change] mrpt::slam::CMetricMapBuilderICP (and `icp-slam`) can align each scan with mrpt::slam::CCorrelativeScanMatcher2D instead of ICP against the whole map (new option `useCorrelativeScanMatcher`), with a bounded cost per scan regardless of the map size. With map updating disabled, it works as a laser odometry.
 		- \ref mrpt_hwdrivers_grp
 			- mrpt::hwdrivers::CGenericSensor: external image format is now `png` by default instead of `jpg` to avoid losses.
+			- [ABI change] mrpt::hwdrivers::CGenericSensor keeps its grabbed observations in a lock-free queue (mrpt::synch::CLockFreeQueueMPMC) instead of a mutex-protected `std::multimap`. Its length is set by `max_queue_len`: on overflow, the oldest observations are dropped and reported.
+			- [ABI change] mrpt::hwdrivers::CCameraSensor saves external images with tasks in a mrpt::system::CThreadPool instead of its own polling threads.
 			- [ABI change] mrpt::hwdrivers::COpenNI2Generic:
 				- refactored to expose more methods and allow changing parameters via its constructor.
 				- Now supports reading from an IR, RGB and Depth channels independenty.
@@ -88,6 +129,17 @@
 				- Parameters are no longer passed via a mrpt::utils::TParameters class, but via a mrpt::utils::CConfigFileBase which makes parameter passing to PTGs much more maintainable and consistent.
 				- PTGs now have a score_priority field to manually set hints about preferences for path planning.
 				- PTGs are now mrpt::utils::CLoadableOptions classes
+		- \ref mrpt_pbmap_grp
+			- [ABI change] mrpt::pbmap::PbMapMaker finds the candidate planes to be merged or to be neighbors of a new observation with a spatial index (new class mrpt::pbmap::PlanesSpatialIndex) instead of comparing it with all the planes in the map, and keeps its integral-image normal estimator and segmentation between keyframes. Fixed renumbering of plane ids after merging two previous planes.
+			- [Bug fix] mrpt::pbmap::PbMapMaker considered as neighbors two planes with a vertex of one inside the hull of the other, no matter how far behind the other plane it was (signed distance).
+			- mrpt::pbmap::SubgraphMatcher::compareSubgraphs() explores the branches of the interpretation tree in parallel (if built with TBB), sharing the best match as pruning bound. Results are identical to the sequential search.
+		- \ref mrpt_topography_grp
+			- New class mrpt::topography::CGeodeticToENU_WGS84 to convert many geodetic coordinates to ENU around the same origin, which is computed only once, and new overloads of mrpt::topography::geodeticToENU_WGS84(), mrpt::topography::geodeticToGeocentric(), mrpt::topography::GeodeticToUTM(), mrpt::topography::transform7params(), mrpt::topography::transformHelmert2D() and mrpt::topography::transformHelmert3D() for vectors of points.
+			- mrpt::topography::path_from_rtk_gps() estimates the vehicle pose of each timestamp in parallel (if built with TBB).
+		- \ref mrpt_vision_grp
+			- mrpt::vision::bundle_adj_full() is much faster: frame-point Hessian blocks are kept in flat per-observation arrays instead of `std::map`s, Jacobians, landmark blocks and the reduced camera system are evaluated in parallel (if built with TBB), and the symbolic factorization of the reduced camera system is reused between iterations. New option `local_window` for local (windowed) BA over the last keyframes.
+			- New mrpt::vision::pnp::CPnP::solve_batch() to solve many small PnP problems in one call, in parallel, with fixed-size kernels for P3P and EPnP (up to 8 points, also available without OpenCV). New PnP benchmarks in `mrpt-performance`.
+			- [ABI change] mrpt::vision::CDifodo is faster: all the image passes run column by column (in the storage order of Eigen matrices) and in parallel for blocks of columns (if built with TBB), and the weights and the normal equations of each level are computed in one single sweep, with per-task partial 6x6 systems, instead of building the whole overdetermined system. New method mrpt::vision::CDifodo::computeWeightsAndSolveOneLevel() and field mrpt::vision::CDifodo::level_execution_time, reported by DifOdometry-Datasets at the end of a dataset.
 	- Changes in build system:
 		- [Windows only] `DLL`s/`LIB`s now have the signature `lib-${name}${2-digits-version}${compiler-name}_{x32|x64}.{dll/lib}`, allowing several MRPT versions to coexist in the system PATH.
 		- [Visual Studio only] There are no longer `pragma comment(lib...)` in any MRPT header, so it is the user responsibility to correctly tell user projects to link against MRPT libraries.
@@ -106,6 +158,12 @@
 		- Fix mrpt::utils::CMemoryStream::Clear() after assigning read-only memory blocks.
 		- Fix point into polygon checking not working for concave polygons. Now, mrpt::math::TPolygon2D::contains() uses the winding number test which works for any geometry.
 		- Fix inconsistent internal state after externalizing mrpt::obs::CObservation3DRangeScan
+		- Fix mrpt::system::parallel_for() & co. did not build without TBB.
+		- Fix wrong Y,Z coordinates in mrpt::obs::CObservation3DRangeScan::project3DPointsFromDepthImageInto() for `range_is_depth=false`, and wrong points when using the LUT without SSE2 and some pixels were filtered out.
+		- Fix SSE2 and non-SSE2 range image filters did not behave the same for undefined (0) filter values in mrpt::obs::CObservation3DRangeScan.
+		- Fix out-of-bounds access in mrpt::obs::CObservation3DRangeScan::convertTo2DScan() with `use_origin_sensor_pose=true`.
+		- Fix mrpt::topography::geodeticToGeocentric() always used the ellipsoid of its first call.
+		- Fix JCBB in mrpt::slam::data_association_full_covariance() could miss the hypothesis with the best joint distance among those with the largest number of pairings.
 
 <hr>
 <a name="1.4.0">
@@ -28,9 +28,6 @@ namespace bayes
 	{
 		friend class CParticleFilter;
 
-	private:
-		static const unsigned PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS;
-
 	public:
 
 		CParticleFilterCapable() : m_fastDrawAuxiliary()
@@ -80,8 +77,8 @@ namespace bayes
 		  *			the random indexes generated according to the selected resample scheme in TParticleFilterOptions. Those indexes are
 		  *			read sequentially by subsequent calls to fastDrawSample.
 		  *		- <b>DYNAMIC SAMPLE SIZE=YES</b>: Then:
-		  *			- If TParticleFilterOptions.resamplingMethod = prMultinomial, the internal buffers will be filled out (m_fastDrawAuxiliary.CDF, CDF_indexes & PDF) and
-		  *				then fastDrawSample can be called an arbitrary number of times to generate random indexes.
+		  *			- If TParticleFilterOptions.resamplingMethod = prMultinomial, the internal buffers will be filled out (m_fastDrawAuxiliary.CDF & PDF) and
+		  *				then fastDrawSample can be called an arbitrary number of times to generate random indexes, each one in O(log N) time.
 		  *			- For the rest of resampling algorithms, an exception will be raised since they are not appropriate for a dynamic (unknown in advance) number of particles.
 		  *
 		  * The function pointed by "partEvaluator" should take into account the particle filter algorithm selected in "m_PFAlgorithm".
@@ -220,9 +217,9 @@ namespace bayes
 				alreadyDrawnNextOne(0)
 			{ }
 
-			std::vector<double>	CDF;
-			vector_uint		CDF_indexes;
-			std::vector<double>	PDF;
+			std::vector<double>	CDF;         //!< Normalized cumulative probability of each particle (dynamic sample size)
+			vector_uint		CDF_indexes; //!< Unused since MRPT 1.5.0 (fastDrawSample() does a binary search in CDF)
+			std::vector<double>	PDF;         //!< Log-probability of each particle, as given by the particle evaluator (dynamic sample size)
 
 			vector_uint		alreadyDrawnIndexes;
 			size_t			alreadyDrawnNextOne;
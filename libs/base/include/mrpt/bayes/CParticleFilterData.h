@@ -12,8 +12,10 @@
 #include <mrpt/utils/core_defs.h>
 #include <mrpt/bayes/CProbabilityParticle.h>
 #include <mrpt/bayes/CParticleFilterCapable.h>
+#include <mrpt/utils/aligned_containers.h>
 
 #include <deque>
+#include <vector>
 #include <algorithm>
 
 namespace mrpt
@@ -22,6 +24,29 @@ namespace bayes
 {
 	class CParticleFilterCapable;
 
+	namespace detail
+	{
+		template <class PARTICLE,TParticleStorageMode STORAGE> struct TParticleListType { typedef std::deque<PARTICLE> type; };
+		template <class PARTICLE> struct TParticleListType<PARTICLE,psValue> { typedef typename mrpt::aligned_containers<PARTICLE>::vector_t type; }; // Particles may hold fixed-size Eigen members
+
+		template <class T> inline void allocParticleData(CProbabilityParticle<T,psPointer> &p) { if (!p.d) p.d = new T(); }
+		template <class T> inline void allocParticleData(CProbabilityParticle<T,psValue> &) { }
+		template <class T> inline void freeParticleData(CProbabilityParticle<T,psPointer> &p) { delete p.d; p.d = NULL; }
+		template <class T> inline void freeParticleData(CProbabilityParticle<T,psValue> &) { }
+
+		/** Scratch memory for resampling, which is never copied between particle filters. */
+		template <class PARTICLE_LIST>
+		struct TResamplingBuffer
+		{
+			PARTICLE_LIST       particles;
+			std::vector<size_t> indices;
+
+			TResamplingBuffer() { }
+			TResamplingBuffer(const TResamplingBuffer &) { }
+			TResamplingBuffer & operator =(const TResamplingBuffer &) { return *this; }
+		};
+	}
+
 	/** A curiously recurring template pattern (CRTP) approach to providing the basic functionality of any CParticleFilterData<> class.
 	  *  Users should inherit from CParticleFilterData<>, which in turn will automatically inhirit from this base class.
 	  * \sa CParticleFilter, CParticleFilterCapable, CParticleFilterData
@@ -98,6 +123,15 @@ namespace bayes
 		void  performSubstitution( const std::vector<size_t> &indx) MRPT_OVERRIDE
 		{
 			MRPT_START
+			impl_performSubstitution(indx, static_cast<typename Derived::CParticleData*>(NULL));
+			MRPT_END
+		}
+
+	private:
+		/** performSubstitution() for particles in the heap: reuse the data of the first copy of each particle, only clone the next ones. */
+		template <class T>
+		void impl_performSubstitution( const std::vector<size_t> &indx, CProbabilityParticle<T,psPointer> *)
+		{
 			particle_list_t                      parts;
 			typename particle_list_t::iterator   itDest,itSrc;
 			const size_t   M_old = derived().m_particles.size();
@@ -158,7 +192,27 @@ namespace bayes
 				itSrc->d = NULL;
 			}
 			parts.clear();
-			MRPT_END
+		}
+
+		/** performSubstitution() for particles stored by value: a gather into a second buffer, swapped with the particle list.
+		  * That buffer and the sorted indices are kept between calls, so there are no memory allocations once the number of particles is stable. */
+		template <class T>
+		void impl_performSubstitution( const std::vector<size_t> &indx, CProbabilityParticle<T,psValue> *)
+		{
+			particle_list_t     &parts = derived().m_particles;
+			particle_list_t     &buf = derived().m_resamplingBuffer.particles;
+			std::vector<size_t> &sorted_indx = derived().m_resamplingBuffer.indices;
+
+			// Same order of the output particles than for psPointer:
+			sorted_indx.assign(indx.begin(),indx.end());
+			std::sort( sorted_indx.begin(), sorted_indx.end() );
+
+			const size_t M = sorted_indx.size();
+			ASSERT_(M==0 || sorted_indx.back()<parts.size())
+			buf.resize(M);
+			for (size_t i=0;i<M;i++)
+				buf[i] = parts[ sorted_indx[i] ];
+			parts.swap(buf);
 		}
 
 	}; // end CParticleFilterDataImpl<>
@@ -170,19 +224,24 @@ namespace bayes
 	 *   Since CProbabilityParticle implements all the required operators, the member "m_particles" can be safely copied with "=" or copy constructor operators
 	 *    and new objects will be created internally instead of copying the internal pointers, which would lead to memory corruption.
 	 *
+	 *   With STORAGE=mrpt::bayes::psValue, particles are kept by value in a std::vector instead, which is preferred for small particle types.
+	 *
 	 * \sa CParticleFilter, CParticleFilterCapable, CParticleFilterDataImpl
 	 * \ingroup mrpt_base_grp
 	 */
-	template <class T>
+	template <class T, TParticleStorageMode STORAGE = psPointer>
 	class CParticleFilterData
 	{
 	public:
 		typedef T                         CParticleDataContent; 	//!< This is the type inside the corresponding CParticleData class
-		typedef CProbabilityParticle<T>   CParticleData;			//!< Use this to refer to each element in the m_particles array.
-		typedef std::deque<CParticleData> CParticleList;			//!< Use this type to refer to the list of particles m_particles.
+		typedef CProbabilityParticle<T,STORAGE>   CParticleData;	//!< Use this to refer to each element in the m_particles array.
+		typedef typename detail::TParticleListType<CParticleData,STORAGE>::type CParticleList; //!< Use this type to refer to the list of particles m_particles (a std::deque, or a std::vector with an aligned allocator for mrpt::bayes::psValue)
 
 		CParticleList  m_particles;	//!< The array of particles
 
+		/** Used by performSubstitution() in mrpt::bayes::psValue mode (not copied along with the particles). */
+		detail::TResamplingBuffer<CParticleList> m_resamplingBuffer;
+
 		/** Default constructor */
 		CParticleFilterData() : m_particles(0)
 		{ }
@@ -193,7 +252,7 @@ namespace bayes
 		{
 			MRPT_START
 			for (typename CParticleList::iterator it=m_particles.begin();it!=m_particles.end();++it)
-				if (it->d) delete it->d;
+				detail::freeParticleData(*it);
 			m_particles.clear();
 			MRPT_END
 		}
@@ -215,7 +274,7 @@ namespace bayes
 			out << n;
 			typename CParticleList::const_iterator it;
 			for (it=m_particles.begin();it!=m_particles.end();++it)
-				out << it->log_w << (*it->d);
+				out << it->log_w << (*it->dataPtr());
 			MRPT_END
 		}
 
@@ -234,8 +293,8 @@ namespace bayes
 			for (it=m_particles.begin();it!=m_particles.end();++it)
 			{
 				in >> it->log_w;
-				it->d = new T();
-				in >> *it->d;
+				detail::allocParticleData(*it);
+				in >> *it->dataPtr();
 			}
 			MRPT_END
 		}
@@ -13,16 +13,31 @@ namespace mrpt
 {
 namespace bayes
 {
+	/** How the data of each particle is kept in a CProbabilityParticle / CParticleFilterData.
+	 * \ingroup mrpt_base_grp
+	 */
+	enum TParticleStorageMode
+	{
+		psPointer = 0, //!< `T *d`: each particle data is a separate heap object. Cheap substitution of large particles (e.g. the maps of a RBPF).
+		psValue        //!< `T d`: particles are stored by value, contiguously, with no per-particle allocation. Best for small particles (e.g. poses).
+	};
+
 	/** A template class for holding a the data and the weight of a particle.
 	*    Particles are composed of two parts:
 	 *		- A state vector descritor, which in this case can be any user defined CSerializable class
 	 *		- A (logarithmic) weight value.
 	 *
 	 *  This structure is used within CParticleFilterData, see that class for more information.
+	 *  The member \a d is a pointer `T*` (the default, mrpt::bayes::psPointer) or an object `T` (mrpt::bayes::psValue).
+	 *  Use dataPtr() in code which must work with both storage modes.
 	 * \ingroup mrpt_base_grp
 	 */
+	template <class T, TParticleStorageMode STORAGE = psPointer>
+	struct CProbabilityParticle;
+
+	/** Particle with its data stored in the heap (see CProbabilityParticle) */
 	template <class T>
-	struct CProbabilityParticle
+	struct CProbabilityParticle<T,psPointer>
 	{
 	public:
 		/** The data associated with this particle.
@@ -52,7 +67,7 @@ namespace bayes
 
 		/** Copy operator
 		  */
- 		CProbabilityParticle<T> & operator =(const CProbabilityParticle &o)
+ 		CProbabilityParticle<T,psPointer> & operator =(const CProbabilityParticle &o)
 		{
 			if (this == &o) return *this;
 			log_w = o.log_w;
@@ -73,6 +88,23 @@ namespace bayes
 			}
 			return *this;
 		}
+
+		inline       T * dataPtr()       { return d; } //!< The particle data, whatever the storage mode
+		inline const T * dataPtr() const { return d; } //!< The particle data, whatever the storage mode
+	};
+
+	/** Particle with its data stored by value (see CProbabilityParticle) */
+	template <class T>
+	struct CProbabilityParticle<T,psValue>
+	{
+	public:
+		T      d;     //!< The data associated with this particle.
+		double log_w; //!< The (logarithmic) weight value for this particle.
+
+		CProbabilityParticle() : d(), log_w(0) { }
+
+		inline       T * dataPtr()       { return &d; } //!< The particle data, whatever the storage mode
+		inline const T * dataPtr() const { return &d; } //!< The particle data, whatever the storage mode
 	};
 
 	} // end namespace
@@ -72,6 +72,11 @@ namespace mrpt
 				size_t						&outDataActualSize);
 
 			
+			/** Returns true if the file exists and starts with the gzip magic bytes (0x1F 0x8B), regardless of its extension.
+			  * Used to decide whether a file can be read faster with mrpt::utils::CFileMMapInputStream instead of mrpt::utils::CFileGZInputStream.
+			  */
+			bool BASE_IMPEXP  is_gz_file(const std::string &file_path);
+
 			/** Decompress a gzip file (xxxx.gz) into a memory buffer. If the file is not a .gz file, it just read the whole file unmodified.
 			  * \return true on success, false on error.
 			  * \sa compress_gz_file, decompress_gz_data_block
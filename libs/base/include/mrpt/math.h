@@ -24,6 +24,7 @@
 #include <mrpt/math/CQuaternion.h>
 #include <mrpt/math/ransac.h>
 #include <mrpt/math/ransac_applications.h>
+#include <mrpt/math/ransac_engine.h>
 
 #include <mrpt/math/CHistogram.h>
 #include <mrpt/math/CMatrix.h>
@@ -279,6 +279,13 @@ namespace mrpt
 			  */
 			void compressFromTriplet();
 
+			/** ONLY for column-compressed matrices: direct access to the buffer of values of the non-zero entries, in column-compressed order (in each column,
+			  *  entries keep the order in which they were inserted before compressFromTriplet()). It allows refilling the values of a matrix whose sparse
+			  *  structure doesn't change without rebuilding it, e.g. before calling CholeskyDecomp::update().
+			  * \sa isColumnCompressed
+			  */
+			inline double * getColumnCompressedValues() { ASSERT_(isColumnCompressed()); return sparse_matrix.x; }
+
 			/** Return a dense representation of the sparse matrix.
 			  * \sa saveToTextFile_dense
 			  */
@@ -29,7 +29,7 @@ namespace mrpt {
 	  *    - Real testSample( size_t index, const Model& model ) const : return some value that indicates how well a sample fits to the model. This way the thresholding is moved to the searching procedure and the model just tells how good a sample is.
 	  *
 	  *  There are two methods provided in this class to fit a model:
-	  *    - \a ransacSingleModel (RANSAC): Just like mrpt::math::RANSAC_Template
+	  *    - \a ransacSingleModel (RANSAC): Just like mrpt::math::RANSAC_Template, run by mrpt::math::RANSAC_Engine (so fitModel() and testSample() may be called concurrently from several threads)
 	  *
 	  *    - \a geneticSingleModel (Genetic): Provides a mixture of a genetic and the ransac algorithm.
 	  *         Instead of selecting a set of data in each iteration, it takes more (ex. 10) and order these model
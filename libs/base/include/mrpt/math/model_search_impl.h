@@ -14,6 +14,7 @@
 #	include "model_search.h"
 #endif
 
+#include <mrpt/math/ransac_engine.h>
 #include <limits>
 
 namespace mrpt {
@@ -28,64 +29,11 @@ bool ModelSearch::ransacSingleModel( const TModelFit& p_state,
 									 typename TModelFit::Model& p_bestModel,
 									 vector_size_t& p_inliers )
 {
-    size_t bestScore = std::string::npos; // npos will mean "none"
-	size_t iter = 0;
-	size_t softIterLimit = 1; // will be updated by the size of inliers
-	size_t hardIterLimit = 100; // a fixed iteration step
-	p_inliers.clear();
-	size_t nSamples = p_state.getSampleCount();
-	vector_size_t ind( p_kernelSize );
-
-	while ( iter < softIterLimit && iter < hardIterLimit )
-	{
-		bool degenerate = true;
-		typename TModelFit::Model currentModel;
-		size_t i = 0;
-		while ( degenerate )
-		{
-			pickRandomIndex( nSamples, p_kernelSize, ind );
-			degenerate = !p_state.fitModel( ind, currentModel );
-			i++;
-			if( i > 100 )
-				return false;
-		}
-
-		vector_size_t inliers;
-
-		for( size_t i = 0; i < nSamples; i++ )
-		{
-			if( p_state.testSample( i, currentModel ) < p_fitnessThreshold )
-				inliers.push_back( i );
-		}
-		ASSERT_( inliers.size() > 0 );
-
-		// Find the number of inliers to this model.
-		const size_t ninliers = inliers.size();
-        bool  update_estim_num_iters = (iter==0); // Always update on the first iteration, regardless of the result (even for ninliers=0)
-
-        if ( ninliers > bestScore || (bestScore==std::string::npos && ninliers!=0))
-		{
-			bestScore = ninliers;
-			p_bestModel = currentModel;
-			p_inliers = inliers;
-			update_estim_num_iters = true;
-		}
-
-		if (update_estim_num_iters)
-		{
-			// Update the estimation of maxIter to pick dataset with no outliers at propability p
-			double f =  ninliers / static_cast<double>( nSamples );
-			double p = 1 -  pow( f, static_cast<double>( p_kernelSize ) );
-			const double eps = std::numeric_limits<double>::epsilon();
-			p = std::max( eps, p);	// Avoid division by -Inf
-			p = std::min( 1-eps, p);	// Avoid division by 0.
-			softIterLimit = log(1-p) / log(p);
-		}
-
-		iter++;
-	}
-
-	return true;
+	// Hypotheses are evaluated in parallel by the generic RANSAC engine:
+	RANSAC_Engine< TRansacModelSearchAdapter<TModelFit> > engine;
+	engine.params.prob_good_sample = 0.99;
+	engine.params.max_iters = 100; // a fixed iteration step
+	return engine.execute( TRansacModelSearchAdapter<TModelFit>(p_state), p_fitnessThreshold, p_kernelSize, p_bestModel, p_inliers );
 }
 
 //----------------------------------------------------------------------
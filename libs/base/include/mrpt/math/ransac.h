@@ -60,6 +60,9 @@ namespace mrpt
 			  *  \param
 			  *
 			  *  This implementation is highly inspired on Peter Kovesi's MATLAB scripts (http://www.csse.uwa.edu.au/~pk).
+			  *  Since MRPT 1.5.0 it runs on mrpt::math::RANSAC_Engine: hypotheses are evaluated in parallel, so the
+			  *  callbacks may be called concurrently from several threads. \a dist_func is invoked for one model at a time,
+			  *  and possibly with a subset of the columns of \a data (inlier indices must be relative to the matrix it receives).
 			  * \return false if no good solution can be found, true on success.
 			  */
 			bool execute(
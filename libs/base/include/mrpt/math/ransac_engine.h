@@ -0,0 +1,132 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+#ifndef  mrpt_ransac_engine_H
+#define  mrpt_ransac_engine_H
+
+#include <mrpt/utils/utils_defs.h>
+#include <vector>
+
+namespace mrpt
+{
+	namespace math
+	{
+		/** @addtogroup ransac_grp
+		  * @{ */
+
+		/** Parameters of mrpt::math::RANSAC_Engine */
+		struct BASE_IMPEXP TRansacEngineParams
+		{
+			TRansacEngineParams(); //!< Sets the default values
+
+			double prob_good_sample;      //!< Desired probability of drawing at least one outlier-free sample, used to estimate the number of hypotheses (default=0.999)
+			size_t max_iters;             //!< Maximum number of hypotheses to evaluate (default=2000)
+			size_t max_degenerate_trials; //!< Maximum number of attempts to draw a non-degenerate sample for each hypothesis (default=100)
+			size_t hypotheses_per_batch;  //!< Number of hypotheses generated and scored in parallel between updates of the estimated number of hypotheses (default=32)
+			size_t score_chunk_size;      //!< Number of samples scored in each batched call to TModelFit::testSamples(), between checks for early bailout (default=256)
+			/** If >0, T(d,d) pre-test: each hypothesis is first tested against this number of random samples, and it is discarded without
+			  * scoring the rest of samples unless all of them are inliers. The number of hypotheses is increased accordingly. (default=0: disabled) */
+			size_t Tdd_pretest;
+		};
+
+		/** A generic, parallel RANSAC engine for models of any kind.
+		  *
+		  * Hypotheses are generated and scored in parallel (if MRPT is built with TBB), in batches whose size is
+		  * set by TRansacEngineParams::hypotheses_per_batch. After each batch, the number of hypotheses needed to find an
+		  * outlier-free sample with probability TRansacEngineParams::prob_good_sample is re-estimated from the best model so far.
+		  * Each hypothesis is scored in chunks of samples, and its evaluation is abandoned as soon as it can not
+		  * beat the best model found so far by any thread. Optionally, hypotheses can be first checked with a T(d,d) pre-test.
+		  *
+		  * If a quality score is provided for each sample (e.g. a descriptor matching score), PROSAC sampling is used: hypotheses are
+		  * first drawn from the best-scored samples, progressively growing the sampling set up to the whole data set.
+		  *
+		  * Each random sample is drawn with its own random generator, seeded from mrpt::random::randomGenerator, so results
+		  * only depend on the state of that generator, and not on the number of threads.
+		  *
+		  *  The type \a TModelFit is a user-supplied struct/class that implements this interface:
+		  *  - Types:
+		  *    - \a Real : The numeric type of distances (typ: double, float)
+		  *    - \a Model : The type of the model to be fitted (for example: A matrix, a TLine2D, a TPlane, ...)
+		  *  - Methods, which may be called concurrently from several threads:
+		  *    - `size_t getSampleCount() const` : Returns the number of samples.
+		  *    - `bool fitModels( const vector_size_t& useIndices, std::vector<Model>& models ) const` : Fits one or more models to the samples with the given indices. Returns false for degenerate cases.
+		  *    - `void testSamples( const size_t first, const size_t count, const Model& model, Real *out_dists ) const` : Writes
+		  *      the distances from samples first...first+count-1 to the model. This is the place for SIMD code.
+		  *
+		  *  See mrpt::math::TRansacModelSearchAdapter to use a model class written for mrpt::math::ModelSearch.
+		  *
+		  * \sa mrpt::math::RANSAC_Template, mrpt::math::ModelSearch, which are now implemented with this engine.
+		  */
+		template <class TModelFit>
+		class RANSAC_Engine
+		{
+		public:
+			typedef typename TModelFit::Real  Real;
+			typedef typename TModelFit::Model Model;
+
+			TRansacEngineParams  params; //!< Parameters of the search
+
+			/** Runs the RANSAC search.
+			  * \param fit The model & data set.
+			  * \param distanceThreshold Samples closer than this to a model are inliers.
+			  * \param minimumSizeSamplesToFit Number of samples to fit each hypothesis.
+			  * \param out_best_model The best model found.
+			  * \param out_best_inliers The indices of its inliers.
+			  * \param sample_quality Optional: a score for each sample (higher is better), to use PROSAC sampling.
+			  * \param out_num_hypotheses Optional: output the number of hypotheses evaluated.
+			  * \param out_num_degenerate Optional: output the number of hypotheses discarded because no non-degenerate sample could be drawn
+			  *        in TRansacEngineParams::max_degenerate_trials attempts.
+			  * \return false if no model with at least one inlier was found.
+			  */
+			bool execute(
+				const TModelFit     & fit,
+				const Real            distanceThreshold,
+				const size_t          minimumSizeSamplesToFit,
+				Model               & out_best_model,
+				mrpt::vector_size_t & out_best_inliers,
+				const std::vector<double> * sample_quality = NULL,
+				size_t              * out_num_hypotheses = NULL,
+				size_t              * out_num_degenerate = NULL
+				) const;
+		};
+
+		/** Adapts a model class written for mrpt::math::ModelSearch (with methods `fitModel()` and `testSample()`) to the
+		  *  interface expected by mrpt::math::RANSAC_Engine. */
+		template <class TModelFit>
+		struct TRansacModelSearchAdapter
+		{
+			typedef typename TModelFit::Real  Real;
+			typedef typename TModelFit::Model Model;
+
+			const TModelFit &m_fit;
+			TRansacModelSearchAdapter(const TModelFit &fit) : m_fit(fit) {}
+
+			size_t getSampleCount() const { return m_fit.getSampleCount(); }
+			bool fitModels( const mrpt::vector_size_t& useIndices, std::vector<Model>& models ) const
+			{
+				models.resize(1);
+				if (m_fit.fitModel(useIndices,models[0])) return true;
+				models.clear();
+				return false;
+			}
+			void testSamples( const size_t first, const size_t count, const Model& model, Real *out_dists ) const
+			{
+				for (size_t i=0;i<count;i++)
+					out_dists[i] = m_fit.testSample(first+i,model);
+			}
+		};
+
+		/** @} */
+
+	} // End of namespace
+} // End of namespace
+
+// Template implementations:
+#include "ransac_engine_impl.h"
+
+#endif
@@ -0,0 +1,296 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+#ifndef  mrpt_ransac_engine_impl_H
+#define  mrpt_ransac_engine_impl_H
+
+#ifndef mrpt_ransac_engine_H
+#	include "ransac_engine.h"
+#endif
+
+#include <mrpt/random/RandomGenerators.h>
+#include <mrpt/synch/CCriticalSection.h>
+#include <mrpt/synch/atomic_incr.h>
+#include <mrpt/system/parallelization.h>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace mrpt
+{
+	namespace math
+	{
+		namespace detail
+		{
+			/** Shared state of a RANSAC_Engine::execute() run */
+			template <class TModelFit>
+			struct TRansacEngineState
+			{
+				typedef typename TModelFit::Real  Real;
+				typedef typename TModelFit::Model Model;
+
+				TRansacEngineState(const TModelFit &fit_, const TRansacEngineParams &params_, const Real thres_, const size_t m_) :
+					fit(fit_), params(params_), thres(thres_), m(m_), N(fit_.getSampleCount()), seed(0), batch_first(0),
+					best_count(0), best_hyp(0), best_model_idx(0), num_degenerate(0)
+				{}
+
+				const TModelFit           & fit;
+				const TRansacEngineParams & params;
+				const Real                  thres;
+				const size_t                m, N;
+				uint32_t                    seed;        //!< Hypothesis "h" uses a random generator seeded with "seed+h"
+
+				std::vector<size_t>         prosac_order; //!< Sample indices sorted by decreasing quality (empty: no PROSAC)
+				size_t                      batch_first;  //!< Index of the first hypothesis of the current batch
+				std::vector<size_t>         prosac_n;     //!< Size of the PROSAC sampling set of each hypothesis in the current batch
+				std::vector<char>           prosac_nth;   //!< Whether each hypothesis in the current batch must include the n'th sample
+
+				// The best model so far, shared by all threads:
+				mrpt::synch::CCriticalSection  cs_best;
+				volatile size_t             best_count;  //!< Also read without locking cs_best, with atomic_load_acquire()
+				size_t                      best_hyp, best_model_idx;
+				Model                       best_model;
+
+				mrpt::synch::CAtomicCounter num_degenerate; //!< Hypotheses without any non-degenerate sample
+
+				/** Draws "m" different random indices for hypothesis "h" */
+				void drawSample(mrpt::random::CRandomGenerator &rng, const size_t h, mrpt::vector_size_t &ind) const
+				{
+					size_t n = N;
+					bool with_nth = false;
+					if (!prosac_order.empty())
+					{
+						n = prosac_n[h-batch_first];
+						with_nth = prosac_nth[h-batch_first]!=0;
+					}
+					ind.resize(m);
+					const size_t num_random = with_nth ? m-1 : m;
+					const size_t pool = with_nth ? n-1 : n;
+					for (size_t i=0;i<num_random;i++)
+					{
+						bool repeated;
+						do
+						{
+							ind[i] = rng.drawUniform32bit() % pool;
+							repeated = false;
+							for (size_t j=0;j<i && !repeated;j++)
+								repeated = (ind[j]==ind[i]);
+						} while (repeated);
+					}
+					if (with_nth) ind[m-1] = n-1;
+					if (!prosac_order.empty())
+						for (size_t i=0;i<m;i++)
+							ind[i] = prosac_order[ind[i]];
+				}
+			};
+
+			/** Generates and scores the hypotheses within a given range. */
+			template <class TModelFit>
+			struct TRansacHypothesesEvaluator
+			{
+				typedef typename TModelFit::Real  Real;
+				typedef typename TModelFit::Model Model;
+
+				TRansacEngineState<TModelFit> &s;
+				TRansacHypothesesEvaluator(TRansacEngineState<TModelFit> &s_) : s(s_) {}
+
+				void operator()(const mrpt::system::BlockedRange &range) const
+				{
+					mrpt::vector_size_t  ind;
+					std::vector<Model>   models;
+					std::vector<Real>    dists(std::max<size_t>(1,s.params.score_chunk_size));
+
+					for (int h=range.begin();h<range.end();h++)
+					{
+						mrpt::random::CRandomGenerator rng(s.seed + static_cast<uint32_t>(h));
+
+						// Draw a non-degenerate sample and fit the model(s):
+						bool ok = false;
+						for (size_t trial=0;trial<s.params.max_degenerate_trials && !ok;trial++)
+						{
+							s.drawSample(rng,h,ind);
+							models.clear();
+							ok = s.fit.fitModels(ind,models) && !models.empty();
+						}
+						if (!ok)
+						{
+							++s.num_degenerate;
+							continue;
+						}
+
+						for (size_t k=0;k<models.size();k++)
+							evaluateModel(rng,h,k,models[k],dists);
+					}
+				}
+
+			private:
+				void evaluateModel(mrpt::random::CRandomGenerator &rng, const size_t h, const size_t k, const Model &model, std::vector<Real> &dists) const
+				{
+					const size_t N = s.N;
+
+					// T(d,d) pre-test:
+					for (size_t i=0;i<s.params.Tdd_pretest;i++)
+					{
+						Real d;
+						s.fit.testSamples(rng.drawUniform32bit() % N, 1, model, &d);
+						if (!(d<s.thres)) return;
+					}
+
+					// Score in chunks, abandoning as soon as this model can't beat the best one:
+					size_t ninliers = 0;
+					for (size_t first=0;first<N;first+=dists.size())
+					{
+						const size_t count = std::min(dists.size(), N-first);
+						s.fit.testSamples(first,count,model,&dists[0]);
+						for (size_t i=0;i<count;i++)
+							if (dists[i]<s.thres)
+								ninliers++;
+
+						if (ninliers + (N-first-count) < mrpt::synch::atomic_load_acquire(&s.best_count))
+							return;
+					}
+					if (!ninliers) return;
+
+					// Ties are broken by the hypothesis index, so the result doesn't depend on the order of evaluation:
+					mrpt::synch::CCriticalSectionLocker lock(&s.cs_best);
+					if (ninliers > s.best_count || (ninliers==s.best_count && (h<s.best_hyp || (h==s.best_hyp && k<s.best_model_idx))))
+					{
+						s.best_model = model;
+						s.best_hyp = h;
+						s.best_model_idx = k;
+						mrpt::synch::atomic_store_release(&s.best_count, ninliers);
+					}
+				}
+			};
+
+			// Helper for the sort of PROSAC:
+			struct TRansacQualityGreater
+			{
+				const std::vector<double> &q;
+				TRansacQualityGreater(const std::vector<double> &q_) : q(q_) {}
+				bool operator()(const size_t a, const size_t b) const { return q[a]>q[b]; }
+			};
+		} // end namespace detail
+
+		template <class TModelFit>
+		bool RANSAC_Engine<TModelFit>::execute(
+			const TModelFit     & fit,
+			const Real            distanceThreshold,
+			const size_t          minimumSizeSamplesToFit,
+			Model               & out_best_model,
+			mrpt::vector_size_t & out_best_inliers,
+			const std::vector<double> * sample_quality,
+			size_t              * out_num_hypotheses,
+			size_t              * out_num_degenerate ) const
+		{
+			MRPT_START
+
+			const size_t m = minimumSizeSamplesToFit;
+			ASSERT_(m>=1)
+
+			detail::TRansacEngineState<TModelFit> s(fit,params,distanceThreshold,m);
+			const size_t N = s.N;
+
+			out_best_inliers.clear();
+			if (out_num_hypotheses) *out_num_hypotheses = 0;
+			if (out_num_degenerate) *out_num_degenerate = 0;
+			if (N<m) return false;
+
+			// PROSAC growth function (Chum & Matas, CVPR 2005): the sampling set grows from the "m" best samples
+			// to the whole data set, as the number of hypotheses reaches T'_n:
+			const bool use_prosac = (sample_quality!=NULL);
+			double prosac_Tn = 0;
+			size_t prosac_Tn_prime = 1, prosac_cur_n = m;
+			if (use_prosac)
+			{
+				ASSERT_EQUAL_(sample_quality->size(),N)
+				s.prosac_order.resize(N);
+				for (size_t i=0;i<N;i++) s.prosac_order[i]=i;
+				std::stable_sort(s.prosac_order.begin(),s.prosac_order.end(), detail::TRansacQualityGreater(*sample_quality) );
+
+				prosac_Tn = 200000; // T_N
+				for (size_t i=0;i<m;i++)
+					prosac_Tn *= static_cast<double>(m-i)/(N-i);
+			}
+
+			s.seed = mrpt::random::randomGenerator.drawUniform32bit();
+
+			const size_t max_iters = params.max_iters;
+			size_t num_needed = max_iters;
+			size_t iter = 0;
+
+			while (iter<num_needed)
+			{
+				const size_t batch = std::min( std::max<size_t>(1,params.hypotheses_per_batch), num_needed-iter);
+
+				if (use_prosac)
+				{
+					s.prosac_n.resize(batch);
+					s.prosac_nth.resize(batch);
+					for (size_t i=0;i<batch;i++)
+					{
+						const size_t t = iter+i+1;
+						while (t>prosac_Tn_prime && prosac_cur_n<N)
+						{
+							const double Tn_next = prosac_Tn * (prosac_cur_n+1) / (prosac_cur_n+1-m);
+							prosac_Tn_prime += static_cast<size_t>(std::ceil(Tn_next-prosac_Tn));
+							prosac_Tn = Tn_next;
+							prosac_cur_n++;
+						}
+						s.prosac_n[i]   = prosac_cur_n;
+						s.prosac_nth[i] = (prosac_Tn_prime>=t) ? 1:0;
+					}
+				}
+				s.batch_first = iter;
+
+				mrpt::system::parallel_for(
+					mrpt::system::BlockedRange(static_cast<int>(iter),static_cast<int>(iter+batch)),
+					detail::TRansacHypothesesEvaluator<TModelFit>(s) );
+
+				iter+=batch;
+
+				// Update the estimate of the number of hypotheses needed to draw, with probability p, an outlier-free sample
+				// (which must also pass the T(d,d) test, if enabled):
+				if (s.best_count>0)
+				{
+					const double frac_inliers = s.best_count/static_cast<double>(N);
+					double pNoOutliers = 1 - std::pow(frac_inliers, static_cast<double>(m+params.Tdd_pretest));
+					pNoOutliers = std::max( std::numeric_limits<double>::epsilon(), pNoOutliers);  // Avoid division by -Inf
+					pNoOutliers = std::min(1.0 - std::numeric_limits<double>::epsilon() , pNoOutliers); // Avoid division by 0.
+					const double n = std::ceil( std::log(1-params.prob_good_sample)/std::log(pNoOutliers) );
+					num_needed = (n<static_cast<double>(max_iters)) ? static_cast<size_t>(n) : max_iters;
+				}
+			}
+
+			if (out_num_hypotheses) *out_num_hypotheses = iter;
+			if (out_num_degenerate) *out_num_degenerate = static_cast<size_t>(s.num_degenerate);
+
+			if (!s.best_count)
+				return false;
+
+			// Final list of inliers of the best model:
+			out_best_model = s.best_model;
+			out_best_inliers.reserve(s.best_count);
+			std::vector<Real> dists(std::max<size_t>(1,params.score_chunk_size));
+			for (size_t first=0;first<N;first+=dists.size())
+			{
+				const size_t count = std::min(dists.size(), N-first);
+				fit.testSamples(first,count,out_best_model,&dists[0]);
+				for (size_t i=0;i<count;i++)
+					if (dists[i]<distanceThreshold)
+						out_best_inliers.push_back(first+i);
+			}
+			return true;
+
+			MRPT_END
+		}
+
+	} // End of namespace
+} // End of namespace
+
+#endif
@@ -145,6 +145,18 @@ namespace poses
 			inverseComposePoint(g.x,g.y, l.x,l.y);
 		}
 
+		/** Batch version of composePoint() for N 2D points given as separate arrays of coordinates: \f$ G_i = P \oplus L_i \f$.
+		  *  Uses SSE2 instructions if available. Input and output arrays can be the same (in-place transformation).
+		  * \sa inverseComposePoints, CPose3D::composePoints */
+		void composePoints(const size_t N, const float *lx, const float *ly, float *gx, float *gy) const;
+		/** \overload */
+		void composePoints(const size_t N, const double *lx, const double *ly, double *gx, double *gy) const;
+
+		/** Batch version of inverseComposePoint(): \f$ L_i = G_i \ominus P \f$. Input and output arrays can be the same. \sa composePoints */
+		void inverseComposePoints(const size_t N, const float *gx, const float *gy, float *lx, float *ly) const;
+		/** \overload */
+		void inverseComposePoints(const size_t N, const double *gx, const double *gy, double *lx, double *ly) const;
+
 		 /** The operator \f$ u' = this \oplus u \f$ is the pose/point compounding operator. */
 		 CPoint3D operator + (const CPoint3D& u) const ;
 
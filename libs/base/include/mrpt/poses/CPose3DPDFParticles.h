@@ -32,8 +32,8 @@ namespace mrpt
 		 */
 		class BASE_IMPEXP CPose3DPDFParticles :
 			public CPose3DPDF,
-			public mrpt::bayes::CParticleFilterData<CPose3D>,
-			public mrpt::bayes::CParticleFilterDataImpl<CPose3DPDFParticles,mrpt::bayes::CParticleFilterData<CPose3D>::CParticleList>
+			public mrpt::bayes::CParticleFilterData<CPose3D,mrpt::bayes::psValue>,
+			public mrpt::bayes::CParticleFilterDataImpl<CPose3DPDFParticles,mrpt::bayes::CParticleFilterData<CPose3D,mrpt::bayes::psValue>::CParticleList>
 		{
 			// This must be added to any CSerializable derived class:
 			DEFINE_SERIALIZABLE( CPose3DPDFParticles )
@@ -47,7 +47,7 @@ namespace mrpt
 			/** Copy constructor */
 			inline CPose3DPDFParticles( const CPose3DPDFParticles& obj ) :
 				CPose3DPDF(),
-				CParticleFilterData<CPose3D>()
+				CParticleFilterData<CPose3D,mrpt::bayes::psValue>()
 			{
 				copyFrom( obj );
 			}
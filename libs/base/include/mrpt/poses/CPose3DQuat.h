@@ -119,6 +119,16 @@ namespace poses
 			 mrpt::math::CMatrixFixedNumeric<double,3,3>  *out_jacobian_df_dpoint = NULL,
 			 mrpt::math::CMatrixFixedNumeric<double,3,7>  *out_jacobian_df_dpose = NULL ) const;
 
+		/** Batch version of composePoint() for N points given as separate arrays of coordinates. Input and output arrays can be the same.
+		  * \sa CPose3D::composePoints */
+		void composePoints(const size_t N, const float *lx, const float *ly, const float *lz, float *gx, float *gy, float *gz) const;
+		/** \overload */
+		void composePoints(const size_t N, const double *lx, const double *ly, const double *lz, double *gx, double *gy, double *gz) const;
+		/** Batch version of inverseComposePoint(). Input and output arrays can be the same. \sa CPose3D::inverseComposePoints */
+		void inverseComposePoints(const size_t N, const float *gx, const float *gy, const float *gz, float *lx, float *ly, float *lz) const;
+		/** \overload */
+		void inverseComposePoints(const size_t N, const double *gx, const double *gy, const double *gz, double *lx, double *ly, double *lz) const;
+
 		/**  Computes the 3D point G such as \f$ G = this \oplus L \f$.
 		  *  POINT1 and POINT1 can be anything supporing [0],[1],[2].
 		  * \sa composePoint    */
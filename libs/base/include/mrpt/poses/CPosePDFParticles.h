@@ -32,8 +32,8 @@ namespace mrpt
 		 */
 		class BASE_IMPEXP CPosePDFParticles :
 			public CPosePDF,
-			public mrpt::bayes::CParticleFilterData<CPose2D>,
-			public mrpt::bayes::CParticleFilterDataImpl<CPosePDFParticles,mrpt::bayes::CParticleFilterData<CPose2D>::CParticleList>
+			public mrpt::bayes::CParticleFilterData<CPose2D,mrpt::bayes::psValue>,
+			public mrpt::bayes::CParticleFilterDataImpl<CPosePDFParticles,mrpt::bayes::CParticleFilterData<CPose2D,mrpt::bayes::psValue>::CParticleList>
 		{
 			// This must be added to any CSerializable derived class:
 			DEFINE_SERIALIZABLE( CPosePDFParticles )
@@ -56,6 +56,18 @@ namespace mrpt
 				matrix_VxV_t *df_de1,
 				matrix_VxV_t *df_de2);
 
+			/** Batch version of jacobian_dP1DP2inv_depsilon() for the N poses in P1DP2inv[]. Output arrays (with room for N matrices each) can be NULL. */
+			static void jacobians_dP1DP2inv_depsilon(
+				const size_t N,
+				const CPose3D *P1DP2inv,
+				matrix_VxV_t *df_de1,
+				matrix_VxV_t *df_de2);
+
+			/** Batch pose composition: \f$ out_i = A_i \oplus B_i \f$ for i=0..N-1. "out" can be the same array as "A" or "B". \sa inverseComposePoses */
+			static void composePoses(const size_t N, const CPose3D *A, const CPose3D *B, CPose3D *out);
+			/** Batch pose inverse composition: \f$ out_i = A_i \ominus B_i \f$ for i=0..N-1. "out" can be the same array as "A" or "B". \sa composePoses */
+			static void inverseComposePoses(const size_t N, const CPose3D *A, const CPose3D *B, CPose3D *out);
+
 		}; // end SE_traits
 
 		/** Specialization of SE for 2D poses \sa SE_traits */
@@ -90,6 +102,18 @@ namespace mrpt
 				matrix_VxV_t *df_de1,
 				matrix_VxV_t *df_de2);
 
+			/** Batch version of jacobian_dP1DP2inv_depsilon() for the N poses in P1DP2inv[]. Output arrays (with room for N matrices each) can be NULL. */
+			static void jacobians_dP1DP2inv_depsilon(
+				const size_t N,
+				const CPose2D *P1DP2inv,
+				matrix_VxV_t *df_de1,
+				matrix_VxV_t *df_de2);
+
+			/** Batch pose composition: \f$ out_i = A_i \oplus B_i \f$ for i=0..N-1. "out" can be the same array as "A" or "B". \sa inverseComposePoses */
+			static void composePoses(const size_t N, const CPose2D *A, const CPose2D *B, CPose2D *out);
+			/** Batch pose inverse composition: \f$ out_i = A_i \ominus B_i \f$ for i=0..N-1. "out" can be the same array as "A" or "B". \sa composePoses */
+			static void inverseComposePoses(const size_t N, const CPose2D *A, const CPose2D *B, CPose2D *out);
+
 		}; // end SE_traits
 
 		/** @} */ // end of grouping
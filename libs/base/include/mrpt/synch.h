@@ -16,5 +16,6 @@
 #include "synch/MT_buffer.h"
 #include "synch/CThreadSafeVariable.h"
 #include "synch/CPipe.h"
+#include "synch/CLockFreeQueue.h"
 
 #endif
@@ -0,0 +1,289 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+#ifndef  mrpt_synch_CLockFreeQueue_H
+#define  mrpt_synch_CLockFreeQueue_H
+
+#include <mrpt/synch/atomic_incr.h>
+#include <mrpt/synch/CSemaphore.h>
+#include <mrpt/utils/CUncopiable.h>
+#include <mrpt/utils/CTicTac.h>
+#include <vector>
+
+namespace mrpt
+{
+namespace synch
+{
+	/** An "event count": lets threads sleep until some lock-free condition becomes true, without any lock in the fast path.
+	  *  Notifiers only touch a counter unless there is some thread waiting. Waiters must follow this protocol:
+	  * \code
+	  *  if (!try_condition()) {
+	  *    ec.prepareWait();
+	  *    if (try_condition()) ec.cancelWait();  // Avoids a lost wake-up
+	  *    else ec.commitWait(timeout_ms);
+	  *  }
+	  * \endcode
+	  * Wake-ups may be spurious, so the condition must be always re-checked.
+	  * \ingroup synch_grp
+	  */
+	class CEventCount : public mrpt::utils::CUncopiable
+	{
+	public:
+		CEventCount() : m_waiters(0), m_sem(0, 0x7FFFFFFF) { }
+
+		/** Wakes up one waiting thread, if any. Call it after making the condition true. */
+		inline void notifyOne()
+		{
+			atomic_memory_barrier();
+			if (m_waiters>0) m_sem.release(1);
+		}
+		/** Wakes up all the waiting threads, if any. */
+		inline void notifyAll()
+		{
+			atomic_memory_barrier();
+			const long n = m_waiters;
+			if (n>0) m_sem.release(static_cast<unsigned int>(n));
+		}
+
+		inline void prepareWait() { ++m_waiters; atomic_memory_barrier(); }
+		inline void cancelWait() { --m_waiters; }
+		/** Blocks until notified, or timeout (0 means no timeout). \return false on timeout. */
+		inline bool commitWait(unsigned int timeout_ms = 0)
+		{
+			const bool ok = m_sem.waitForSignal(timeout_ms);
+			--m_waiters;
+			return ok;
+		}
+
+	private:
+		CAtomicCounter m_waiters;
+		CSemaphore     m_sem;
+	};
+
+	/** \cond INTERNAL */
+	namespace detail
+	{
+		inline size_t nextPowerOf2(size_t n)
+		{
+			size_t p=2;
+			while (p<n) p<<=1;
+			return p;
+		}
+
+		/** Common implementation of the blocking pop() of the lock-free queues */
+		template <class QUEUE, class T>
+		bool lockFreeQueuePopWait(QUEUE &q, CEventCount &ec, T &val, unsigned int timeout_ms)
+		{
+			if (q.pop(val)) return true;
+			mrpt::utils::CTicTac tictac;
+			for (;;)
+			{
+				ec.prepareWait();
+				if (q.pop(val)) { ec.cancelWait(); return true; }
+
+				unsigned int wait_ms = 0;
+				if (timeout_ms)
+				{
+					const double remain_ms = timeout_ms - 1000*tictac.Tac();
+					if (remain_ms<=0) { ec.cancelWait(); return false; }
+					wait_ms = remain_ms<1 ? 1 : static_cast<unsigned int>(remain_ms);
+				}
+				if (!ec.commitWait(wait_ms))
+					return q.pop(val);
+				if (q.pop(val)) return true;
+			}
+		}
+	}
+	/** \endcond */
+
+	/** A bounded, lock-free FIFO queue for exactly one producer thread and one consumer thread.
+	  *  push() and pop() never block and never allocate memory: the queue is a ring buffer of preallocated elements,
+	  *  whose capacity is rounded up to a power of two.
+	  *  The consumer can also sleep until a new element arrives with pop_wait().
+	  *
+	  * \code
+	  *  CLockFreeQueueSPSC<int> q(1000);
+	  *  // Thread #1:                 // Thread #2:
+	  *  q.push(10);                   int v;
+	  *                                if (q.pop_wait(v, 100)) { ... }
+	  * \endcode
+	  *
+	  * \tparam T Any default-constructible and copiable type. Popped slots are reset to T(), so smart pointers are released as soon as possible.
+	  * \sa CLockFreeQueueMPMC, mrpt::utils::CThreadSafeQueue
+	  * \ingroup synch_grp
+	  */
+	template <class T>
+	class CLockFreeQueueSPSC : public mrpt::utils::CUncopiable
+	{
+	public:
+		/** Creates an empty queue able to hold, at least, `capacity` elements */
+		explicit CLockFreeQueueSPSC(size_t capacity) :
+			m_buf(detail::nextPowerOf2(capacity)),
+			m_mask(m_buf.size()-1),
+			m_head(0), m_tail(0)
+		{ }
+
+		/** Inserts a copy of `val` at the end. Only the producer thread can call this.
+		  * \return false if the queue is full. */
+		bool push(const T &val)
+		{
+			const size_t tail = m_tail; // Only written by this thread
+			if (tail-atomic_load_acquire(&m_head) > m_mask)
+				return false;
+			m_buf[tail & m_mask] = val;
+			atomic_store_release(&m_tail, tail+1);
+			m_ec.notifyOne();
+			return true;
+		}
+
+		/** Takes the first element, if any. Only the consumer thread can call this.
+		  * \return false if the queue is empty. */
+		bool pop(T &val)
+		{
+			const size_t head = m_head; // Only written by this thread
+			if (head==atomic_load_acquire(&m_tail))
+				return false;
+			T &slot = m_buf[head & m_mask];
+			val = slot;
+			slot = T();
+			atomic_store_release(&m_head, head+1);
+			return true;
+		}
+
+		/** Like pop(), but if the queue is empty, blocks until a new element is pushed.
+		  * \param timeout_ms The maximum time to wait, or 0 to wait indefinitely.
+		  * \return false on timeout. */
+		bool pop_wait(T &val, unsigned int timeout_ms = 0)
+		{
+			return detail::lockFreeQueuePopWait(*this, m_ec, val, timeout_ms);
+		}
+
+		/** The number of elements in the queue (it may be already outdated upon return if other threads are using the queue) */
+		size_t size() const { return atomic_load_acquire(&m_tail)-atomic_load_acquire(&m_head); }
+		bool empty() const { return size()==0; }
+		size_t capacity() const { return m_buf.size(); }
+
+	private:
+		std::vector<T> m_buf;
+		const size_t   m_mask;
+		char           m_pad0[64]; // Avoid false sharing between producer & consumer indices
+		volatile size_t m_head;    //!< Index of the next element to pop (written by the consumer only)
+		char           m_pad1[64];
+		volatile size_t m_tail;    //!< Index of the next element to push (written by the producer only)
+		char           m_pad2[64];
+		CEventCount    m_ec;
+	};
+
+	/** A bounded, lock-free FIFO queue for any number of producer and consumer threads.
+	  *  Same interface than CLockFreeQueueSPSC. Based on the bounded MPMC queue design by Dmitry Vyukov:
+	  *  each slot has a sequence number which tells producers and consumers whether it is free or full, so the only
+	  *  contended operation is one compare-and-swap on the push or pop index.
+	  *
+	  * \tparam T Any default-constructible and copiable type. Popped slots are reset to T(), so smart pointers are released as soon as possible.
+	  * \sa CLockFreeQueueSPSC, mrpt::system::CThreadPool
+	  * \ingroup synch_grp
+	  */
+	template <class T>
+	class CLockFreeQueueMPMC : public mrpt::utils::CUncopiable
+	{
+	public:
+		/** Creates an empty queue able to hold, at least, `capacity` elements */
+		explicit CLockFreeQueueMPMC(size_t capacity) :
+			m_cells(detail::nextPowerOf2(capacity)),
+			m_mask(m_cells.size()-1),
+			m_push_pos(0), m_pop_pos(0)
+		{
+			for (size_t i=0;i<m_cells.size();i++)
+				m_cells[i].seq = i;
+		}
+
+		/** Inserts a copy of `val` at the end. \return false if the queue is full. */
+		bool push(const T &val)
+		{
+			size_t pos = atomic_load_acquire(&m_push_pos);
+			TCell *cell;
+			for (;;)
+			{
+				cell = &m_cells[pos & m_mask];
+				const ptrdiff_t dif = static_cast<ptrdiff_t>(atomic_load_acquire(&cell->seq) - pos);
+				if (dif==0)
+				{
+					if (atomic_compare_exchange(&m_push_pos, pos, pos+1))
+						break;
+				}
+				else if (dif<0)
+					return false; // Full
+				pos = atomic_load_acquire(&m_push_pos);
+			}
+			cell->data = val;
+			atomic_store_release(&cell->seq, pos+1);
+			m_ec.notifyOne();
+			return true;
+		}
+
+		/** Takes the first element, if any. \return false if the queue is empty. */
+		bool pop(T &val)
+		{
+			size_t pos = atomic_load_acquire(&m_pop_pos);
+			TCell *cell;
+			for (;;)
+			{
+				cell = &m_cells[pos & m_mask];
+				const ptrdiff_t dif = static_cast<ptrdiff_t>(atomic_load_acquire(&cell->seq) - (pos+1));
+				if (dif==0)
+				{
+					if (atomic_compare_exchange(&m_pop_pos, pos, pos+1))
+						break;
+				}
+				else if (dif<0)
+					return false; // Empty
+				pos = atomic_load_acquire(&m_pop_pos);
+			}
+			val = cell->data;
+			cell->data = T();
+			atomic_store_release(&cell->seq, pos+m_mask+1);
+			return true;
+		}
+
+		/** Like pop(), but if the queue is empty, blocks until a new element is pushed.
+		  * \param timeout_ms The maximum time to wait, or 0 to wait indefinitely.
+		  * \return false on timeout. */
+		bool pop_wait(T &val, unsigned int timeout_ms = 0)
+		{
+			return detail::lockFreeQueuePopWait(*this, m_ec, val, timeout_ms);
+		}
+
+		/** The approximate number of elements in the queue */
+		size_t size() const
+		{
+			const size_t push_pos = atomic_load_acquire(&m_push_pos), pop_pos = atomic_load_acquire(&m_pop_pos);
+			return push_pos>pop_pos ? push_pos-pop_pos : 0;
+		}
+		bool empty() const { return size()==0; }
+		size_t capacity() const { return m_cells.size(); }
+
+	private:
+		struct TCell
+		{
+			volatile size_t seq;
+			T data;
+		};
+		std::vector<TCell> m_cells;
+		const size_t    m_mask;
+		char            m_pad0[64]; // Avoid false sharing between producers & consumers
+		volatile size_t m_push_pos;
+		char            m_pad1[64];
+		volatile size_t m_pop_pos;
+		char            m_pad2[64];
+		CEventCount     m_ec;
+	};
+
+} // End of namespace
+} // End of namespace
+
+#endif
@@ -12,6 +12,7 @@
 #include <mrpt/config.h>
 #include <mrpt/utils/compiler_fixes.h>
 #include <mrpt/base/link_pragmas.h>  // DLL import/export definitions
+#include <cstddef> // size_t
 
 #if defined( __GNUC__ )
 #  include <ext/atomicity.h>
@@ -50,6 +51,26 @@ private:
 	CAtomicCounter & operator=( CAtomicCounter const & ); 	//!< Forbidden method
 }; // end of CAtomicCounter
 
+/** @name Atomic operations on machine words, used to build lock-free data structures.
+  *  All of them act as compiler barriers, and as CPU memory barriers of the given type.
+  * \sa CLockFreeQueueSPSC, CLockFreeQueueMPMC
+  * @{ */
+
+/** Reads a word shared between threads. No later memory access can be reordered before this one ("acquire" semantics). \ingroup synch_grp */
+size_t BASE_IMPEXP atomic_load_acquire( const volatile size_t *ptr );
+
+/** Writes a word shared between threads. No former memory access can be reordered after this one ("release" semantics). \ingroup synch_grp */
+void BASE_IMPEXP atomic_store_release( volatile size_t *ptr, size_t val );
+
+/** Atomically sets `*ptr=desired` only if `*ptr==expected`. It is a full memory barrier.
+  * \return true if the value has been replaced. \ingroup synch_grp */
+bool BASE_IMPEXP atomic_compare_exchange( volatile size_t *ptr, size_t expected, size_t desired );
+
+/** A full memory barrier: no memory access can be reordered across it, in any direction. \ingroup synch_grp */
+void BASE_IMPEXP atomic_memory_barrier();
+
+/** @} */
+
 
 } // End of namespace
 } // End of namespace
@@ -16,8 +16,10 @@
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/memory.h>
 #include <mrpt/system/CGenericMemoryPool.h>
+#include <mrpt/system/CObjectMemoryPool.h>
 #include <mrpt/system/os.h>
 #include <mrpt/system/string_utils.h>
 #include <mrpt/system/threads.h>
+#include <mrpt/system/CThreadPool.h>
 
 #endif
@@ -0,0 +1,102 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+#ifndef  mrpt_system_CObjectMemoryPool_H
+#define  mrpt_system_CObjectMemoryPool_H
+
+#include <mrpt/utils/CUncopiable.h>
+#include <mrpt/base/link_pragmas.h>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace mrpt
+{
+	namespace system
+	{
+		/** A lock-free, size-class based memory pool where all the mrpt::utils::CObject-derived objects are allocated
+		  *  (see MRPT_MAKE_POOLED_OPERATOR_NEW, used by DEFINE_MRPT_OBJECT).
+		  *
+		  *  Requested sizes are rounded up to one of a few size classes (up to 4 KiB; larger objects go straight to the system heap).
+		  *  Freed blocks are kept in a lock-free queue (mrpt::synch::CLockFreeQueueMPMC) of their size class, up to a limit,
+		  *  and handed out again to the next object of a similar size. In high-rate pipelines (e.g. grabbing or deserializing
+		  *  thousands of observations per second, which are destroyed right after being processed) this avoids most calls to the
+		  *  system allocator and the heap fragmentation in long runs. Note that only the objects themselves are pooled, not their
+		  *  dynamic members (e.g. the vectors of ranges of a laser scan).
+		  *
+		  *  Objects may be freed from a different thread than the one which created them. The pool can be disabled at runtime
+		  *  (e.g. to debug memory errors with Valgrind) with setEnabled() or by defining the environment variable
+		  *  `MRPT_DISABLE_OBJECT_POOL`.
+		  *
+		  *  Stats on hits and misses of each size class are available through getStats() and getStatsAsText().
+		  *
+		  * \sa CGenericMemoryPool
+		  * \ingroup mrpt_memory
+		  */
+		class BASE_IMPEXP CObjectMemoryPool : public mrpt::utils::CUncopiable
+		{
+		public:
+			/** Returns the unique instance of the pool, or NULL during the program global destruction phase. */
+			static CObjectMemoryPool * getInstance();
+
+			/** Returns a 16-byte aligned block of, at least, `size` bytes. To be freed with release().
+			  * \exception std::bad_alloc On out of memory. */
+			static void * allocate(size_t size);
+			/** Frees a block returned by allocate(). NULL is ignored. */
+			static void release(void *ptr);
+
+			/** Enables or disables reusing blocks. While disabled, freed blocks are returned to the system heap. Default: enabled */
+			void setEnabled(bool enabled) { m_enabled = enabled; }
+			bool isEnabled() const { return m_enabled; }
+
+			/** Returns all the blocks kept in the pool to the system heap. */
+			void freeCachedMemory();
+
+			struct BASE_IMPEXP TSizeClassStats
+			{
+				size_t block_size;   //!< Size of the blocks in this class, in bytes
+				size_t max_cached;   //!< Maximum number of free blocks kept in the pool
+				size_t n_cached;     //!< Number of free blocks currently in the pool
+				size_t n_allocated;  //!< Number of blocks requested to the system heap
+				size_t n_reused;     //!< Number of blocks served from the pool
+			};
+			/** Returns stats for each size class. */
+			void getStats(std::vector<TSizeClassStats> &stats) const;
+			/** Dumps the stats of all the size classes as a text table. */
+			std::string getStatsAsText() const;
+
+			virtual ~CObjectMemoryPool();
+
+		private:
+			CObjectMemoryPool();
+
+			struct TSizeClass;
+			std::vector<TSizeClass*>   m_classes;
+			std::vector<unsigned char> m_class_of_size; //!< Index in m_classes for each size (in 16 byte units)
+			volatile bool              m_enabled;
+		};
+
+	} // End of namespace
+} // End of namespace
+
+/** Class-specific operators new & delete which allocate the objects of the class in mrpt::system::CObjectMemoryPool.
+  * Returned memory is 16 byte aligned, as with MRPT_MAKE_ALIGNED_OPERATOR_NEW. */
+#define MRPT_MAKE_POOLED_OPERATOR_NEW \
+	void *operator new(size_t size)  { return mrpt::system::CObjectMemoryPool::allocate(size); } \
+	void *operator new[](size_t size){ return mrpt::system::CObjectMemoryPool::allocate(size); } \
+	void operator delete(void * ptr) throw() { mrpt::system::CObjectMemoryPool::release(ptr); } \
+	void operator delete[](void * ptr) throw() { mrpt::system::CObjectMemoryPool::release(ptr); } \
+	/* in-place new and delete: no memory is allocated here. */ \
+	static void *operator new(size_t size, void *ptr) { return ::operator new(size,ptr); } \
+	void operator delete(void * memory, void *ptr) throw() { return ::operator delete(memory,ptr); } \
+	/* nothrow-new (returns zero instead of std::bad_alloc) */ \
+	void* operator new(size_t size, const std::nothrow_t&) throw() { try { return mrpt::system::CObjectMemoryPool::allocate(size); } catch (...) { return 0; } } \
+	void operator delete(void *ptr, const std::nothrow_t&) throw() { mrpt::system::CObjectMemoryPool::release(ptr); }
+
+#endif
@@ -0,0 +1,115 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+#ifndef  mrpt_system_CThreadPool_H
+#define  mrpt_system_CThreadPool_H
+
+#include <mrpt/system/threads.h>
+#include <mrpt/synch/CLockFreeQueue.h>
+#include <mrpt/utils/CUncopiable.h>
+#include <vector>
+
+namespace mrpt
+{
+	namespace system
+	{
+		/** A pool of worker threads which run short tasks, to avoid creating one thread per task with mrpt::system::createThread().
+		  *
+		  *  Each worker has its own lock-free queue of tasks (mrpt::synch::CLockFreeQueueMPMC). Tasks enqueued from outside
+		  *  the pool are distributed among the queues in round-robin order, tasks enqueued from within a task go to the
+		  *  queue of the same worker, and idle workers "steal" tasks from the queues of the others before going to sleep.
+		  *  Sleeping workers are woken up as soon as a new task is enqueued, so no polling is involved.
+		  *
+		  *  Tasks are given as a function (or an object method) and one parameter, just like in mrpt::system::createThread():
+		  *  \code
+		  *   void process(MyData *d);
+		  *   ...
+		  *   mrpt::system::CThreadPool &pool = mrpt::system::globalThreadPool();
+		  *   for (size_t i=0;i<N;i++)
+		  *     pool.enqueue(&process, &data[i]);
+		  *   pool.wait(); // Wait for all the tasks to finish
+		  *  \endcode
+		  *
+		  *  Exceptions thrown by tasks are caught and dumped to std::cerr.
+		  *
+		  * \sa globalThreadPool
+		  * \ingroup mrpt_base_grp
+		  */
+		class BASE_IMPEXP CThreadPool : public mrpt::utils::CUncopiable
+		{
+		public:
+			/** Creates and starts the worker threads.
+			  * \param num_threads The number of workers, or 0 to use mrpt::system::getNumberOfProcessors().
+			  * \param queue_capacity The number of tasks each worker can hold in its queue. If all the queues are full, new tasks run in the calling thread.
+			  */
+			explicit CThreadPool(unsigned int num_threads = 0, size_t queue_capacity = 1024);
+
+			/** Runs all the pending tasks, then ends all the worker threads */
+			virtual ~CThreadPool();
+
+			/** The number of worker threads */
+			inline unsigned int size() const { return static_cast<unsigned int>(m_threads.size()); }
+
+			/** Enqueues the task `func(param)`. It returns immediately. */
+			void enqueue(void (*func)(void *), void *param);
+
+			//! \overload
+			template<typename T> inline void enqueue(void (*func)(T), T param) {
+				enqueue(&detail::ThreadCreateFunctor<T>::createThreadAux, static_cast<void*>(new detail::ThreadCreateFunctor<T>(func,param)) );
+			}
+			/** Enqueues a non-static method of an object as a task, with one parameter (see mrpt::system::createThreadFromObjectMethod()) */
+			template <typename CLASS,typename PARAM> inline void enqueueObjectMethod(CLASS *obj, void (CLASS::*func)(PARAM), PARAM param) {
+				enqueue(&detail::ThreadCreateObjectFunctor<CLASS,PARAM>::createThreadAux, static_cast<void*>(new detail::ThreadCreateObjectFunctor<CLASS,PARAM>(obj,func,param)) );
+			}
+			//! \overload
+			template <typename CLASS> inline void enqueueObjectMethod(CLASS *obj, void (CLASS::*func)(void)) {
+				enqueue(&detail::ThreadCreateObjectFunctorNoParams<CLASS>::createThreadAux, static_cast<void*>(new detail::ThreadCreateObjectFunctorNoParams<CLASS>(obj,func)) );
+			}
+
+			/** Blocks until all the enqueued tasks have finished. The calling thread also runs pending tasks meanwhile.
+			  * \note Do not call it from within a task of this same pool, since the calling task itself would never finish. */
+			void wait();
+
+			/** The number of tasks enqueued or running (it may be already outdated upon return) */
+			size_t pendingTasks() const;
+
+		private:
+			struct TTask
+			{
+				TTask() : func(NULL), param(NULL) { }
+				TTask(void (*f)(void *), void *p) : func(f), param(p) { }
+				void (*func)(void *);
+				void *param;
+			};
+			typedef mrpt::synch::CLockFreeQueueMPMC<TTask> TTaskQueue;
+
+			std::vector<TTaskQueue*>    m_queues;    //!< One per worker
+			std::vector<TThreadHandle>  m_threads;
+			std::vector<unsigned long>  m_thread_ids; //!< getCurrentThreadId() of each worker
+			mrpt::synch::CAtomicCounter m_pending;    //!< Tasks enqueued and not finished yet
+			mrpt::synch::CAtomicCounter m_next_queue; //!< For round-robin distribution of tasks
+			mrpt::synch::CEventCount    m_ec_work;    //!< Idle workers sleep here
+			mrpt::synch::CEventCount    m_ec_done;    //!< Threads in wait() sleep here
+			mrpt::synch::CSemaphore     m_sem_started;
+			volatile bool               m_shutdown;
+
+			int  currentWorkerIndex() const; //!< Index of the calling thread in m_threads, or -1
+			bool anyQueuedTask() const;
+			bool tryRunOneTask(int worker_idx); //!< Pops (or steals) one task and runs it. \return false if all queues were empty.
+			void runTask(const TTask &task);
+			void workerThread(unsigned int idx);
+		};
+
+		/** A pool with as many threads as CPU cores, shared by all MRPT classes, created upon first use.
+		  * \ingroup mrpt_base_grp */
+		CThreadPool BASE_IMPEXP & globalThreadPool();
+
+	} // End of namespace
+} // End of namespace
+
+#endif
@@ -77,7 +77,6 @@ namespace mrpt
         {
             body(range);
         }
-        typedef std::vector<Rect> ConcurrentRectVector;
 
         template<typename Iterator, typename Body> static inline
         void parallel_do( Iterator first, Iterator last, const Body& body )
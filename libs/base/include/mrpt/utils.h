@@ -30,6 +30,7 @@
 #include <mrpt/utils/CFileStream.h>
 
 #include <mrpt/utils/CFileInputStream.h>
+#include <mrpt/utils/CFileMMapInputStream.h>
 #include <mrpt/utils/CFileOutputStream.h>
 #include <mrpt/utils/CFileGZInputStream.h>
 #include <mrpt/utils/CFileGZOutputStream.h>
@@ -0,0 +1,68 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+#ifndef  CFileMMapInputStream_H
+#define  CFileMMapInputStream_H
+
+#include <mrpt/utils/CMemoryStream.h>
+#include <mrpt/utils/CUncopiable.h>
+#include <string>
+
+namespace mrpt
+{
+	namespace utils
+	{
+		/** A read-only, binary stream of a file mapped in memory (with `mmap()` or `MapViewOfFile()`).
+		 *  Opening the file does not read anything: pages are loaded by the OS as they are accessed, and reading does not involve
+		 *  any system call or intermediary buffer. Moreover, CStream::ReadBufferInPlace() returns pointers right into the mapped file,
+		 *  which lets deserialization code (e.g. of compressed images) use the data without copying it at all.
+		 *
+		 *  It is the fastest way to load large, uncompressed files like maps or rawlogs:
+		 *  \code
+		 *   mrpt::utils::CFileMMapInputStream f("big_map.simplemap");
+		 *   mrpt::maps::CSimpleMap sm;
+		 *   f >> sm;
+		 *  \endcode
+		 *
+		 *  Gz-compressed files must be read with CFileGZInputStream instead. If the file cannot be mapped (e.g. it's larger than the
+		 *  address space in 32bit systems), open() fails, so the caller may fall back to CFileInputStream.
+		 *
+		 * \sa CFileInputStream, CMemoryStream
+		 * \ingroup mrpt_base_grp
+		 */
+		class BASE_IMPEXP CFileMMapInputStream : public CMemoryStream, public CUncopiable
+		{
+		protected:
+			size_t  Write(const void *Buffer, size_t Count) MRPT_OVERRIDE;
+		private:
+			void     *m_mmap_data; //!< The start of the mapped view of the file, or NULL
+			uint64_t  m_mmap_size;
+			bool      m_is_open;
+		public:
+			 /** Constructor
+			  * \param fileName The file to be open in this stream
+			  * \exception std::exception On error trying to open or map the file.
+			  */
+			CFileMMapInputStream(const std::string &fileName);
+			 /** Default constructor */
+			CFileMMapInputStream();
+			virtual ~CFileMMapInputStream();
+
+			 /** Opens and maps a file for reading (closing the previous one, if any)
+			  * \param fileName The file to be open in this stream
+			  * \return true on success.
+			  */
+			bool open(const std::string &fileName);
+			void close(); //!< Unmaps and closes the file. Pointers returned by ReadBufferInPlace() become invalid.
+			bool fileOpenCorrectly() const { return m_is_open; } //!< Returns true if the file was open without errors.
+			bool is_open() const { return m_is_open; } //!< Returns true if the file was open without errors.
+			bool checkEOF(); //!< Will be true if EOF has been already reached.
+		}; // End of class def.
+	} // End of namespace
+} // end of namespace
+#endif
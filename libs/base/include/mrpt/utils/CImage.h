@@ -498,6 +498,8 @@ namespace mrpt
 			CImage& operator = (const CImage& o);
 
 			/** Copies from another image, and, if that one is externally stored, the image file will be actually loaded into memory in "this" object.
+			  *  The decoded image is taken from (or kept into) the cache of decoded external images, if enabled (see setExternalImagesCacheSize()).
+			  *  `o` can be this same object, to turn an externally stored image into a normal in-memory image.
 			  * \sa operator =
 			  * \exception CExceptionExternalImageNotFound If the external image couldn't be loaded.
 			  */
@@ -702,6 +704,36 @@ namespace mrpt
 			  */
 			void unload()  const MRPT_NO_THROWS;
 
+			/** For external storage images not loaded yet, starts decoding the image file in a worker thread of mrpt::system::globalThreadPool(),
+			  *  into the cache of decoded external images (see setExternalImagesCacheSize()). It returns immediately.
+			  *  A later access to the image will wait for that decoding to end, if still in progress, instead of loading the file again.
+			  *  Useful to decode the next images while processing the current ones, or the left and right images of a stereo pair in parallel.
+			  *  It has no effect for normal images, already loaded images, or if the cache is disabled.
+			  * \sa mrpt::obs::CObservation::prefetch */
+			void prefetch() const;
+
+			/** Sets the maximum amount of memory (in bytes) of the process-wide cache of decoded external storage images. Default: 0 (disabled).
+			  *  When an external image is loaded, a copy of the decoded pixels is kept in this cache, so unload()ing it and loading it again,
+			  *  or loading the same file from other CImage objects, just copies the pixels instead of reading and decoding the file again.
+			  *  The least recently used images are dropped when the cache is full. A value of 0 disables the cache (and prefetch()).
+			  *  Cached images are checked against the modification time and size of their file, so they are reloaded if the file changes.
+			  * \sa clearExternalImagesCache, getExternalImagesCacheStats */
+			static void setExternalImagesCacheSize(size_t max_bytes);
+			static size_t getExternalImagesCacheSize(); //!< \sa setExternalImagesCacheSize
+			static void clearExternalImagesCache(); //!< Frees all the memory of the cache of decoded external images. \sa setExternalImagesCacheSize
+
+			/** Statistics of the cache of decoded external images \sa getExternalImagesCacheStats */
+			struct BASE_IMPEXP TExternalImagesCacheStats
+			{
+				TExternalImagesCacheStats() : hits(0), misses(0), prefetched(0), num_images(0), bytes(0) { }
+				size_t hits;        //!< Number of image loads served from the cache
+				size_t misses;      //!< Number of image loads which had to read the file
+				size_t prefetched;  //!< Number of images decoded by prefetch()
+				size_t num_images;  //!< Number of images currently in the cache
+				size_t bytes;       //!< Memory currently used by the cached images
+			};
+			static void getExternalImagesCacheStats(TExternalImagesCacheStats &stats);
+
 			/** @}  */
 			// ================================================================
 
@@ -20,7 +20,7 @@ namespace utils
 	 *  This class is useful for storing any required set of variables or objects,
 	 *   and then read them to other objects, or storing them to a file, for example.
 	 *
-	 * \sa CStream
+	 * \sa CStream, CFileMMapInputStream
 	 * \ingroup mrpt_base_grp
 	 */
 	class BASE_IMPEXP CMemoryStream : public CStream
@@ -60,6 +60,9 @@ namespace utils
 		/** Method for getting the current cursor position, where 0 is the first byte and TotalBytesCount-1 the last one */
 		uint64_t getPosition() MRPT_OVERRIDE;
 
+		/** Returns a pointer into the internal buffer, without copying the data (see CStream::ReadBufferInPlace) */
+		const void* ReadBufferInPlace(size_t Count) MRPT_OVERRIDE;
+
 		/** Method for getting a pointer to the raw stored data. The lenght in bytes is given by getTotalBytesCount */
 		void* getRawBufferData();
 
@@ -10,6 +10,7 @@
 #define  MRPT_COBJECT_H
 
 #include <mrpt/system/memory.h>
+#include <mrpt/system/CObjectMemoryPool.h>
 #include <mrpt/utils/safe_pointers.h>
 #include <vector>
 
@@ -161,7 +162,7 @@ namespace mrpt
 			_VIRTUAL_LINKAGE_ mrpt::utils::CObject *duplicate() const MRPT_OVERRIDE; \
 			/*! @} */ \
 		public: \
-			MRPT_MAKE_ALIGNED_OPERATOR_NEW \
+			MRPT_MAKE_POOLED_OPERATOR_NEW \
 
 		/** This declaration must be inserted in all CObject classes definition, within the class declaration. */
 		#define DEFINE_MRPT_OBJECT(class_name) \
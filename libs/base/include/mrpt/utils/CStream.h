@@ -23,6 +23,7 @@ namespace mrpt
 		class CSerializable;
 		struct CSerializablePtr;
 		class CMessage;
+		struct TRuntimeClassId;
 
 		/** This base class is used to provide a unified interface to
 		 *    files,memory buffers,..Please see the derived classes. This class is
@@ -59,10 +60,15 @@ namespace mrpt
 			  * - EXISTING_OBJ=false -> build a new object and return it */
 			template <bool EXISTING_OBJ> CSerializable* internal_ReadObject(CSerializable *existingObj = NULL);
 
+		private:
+			bool m_class_dict_enabled; //!< See enableClassIDDictionary()
+			std::vector<const TRuntimeClassId*> m_class_dict_write; //!< Classes already written with an ID (the index)
+			std::vector<const TRuntimeClassId*> m_class_dict_read;  //!< Classes read so far, indexed by their ID (NULL for unknown IDs)
+
 		public:
 			/* Constructor
 			 */
-			CStream() { }
+			CStream() : m_class_dict_enabled(false) { }
 
 			/* Destructor
 			 */
@@ -112,6 +118,16 @@ namespace mrpt
 			 */
 			virtual size_t  ReadBufferImmediate(void *Buffer, size_t Count) { return ReadBuffer(Buffer, Count); }
 
+			/** Returns a pointer to the next `Count` bytes of the stream and moves the read position after them, without copying them anywhere.
+			 *  Only streams whose contents are already in memory support this (mrpt::utils::CMemoryStream, mrpt::utils::CFileMMapInputStream).
+			 *  The rest of streams return NULL without reading anything, as all streams do if there are less than `Count` bytes left,
+			 *  so the caller must then fall back to ReadBuffer().
+			 *  The returned memory is read-only, it may be not aligned for types other than bytes, and it is only valid while the
+			 *  stream memory is (e.g. until a CMemoryStream is written to or destroyed).
+			 * \note This method is endianness-dependent, like ReadBuffer().
+			 */
+			virtual const void* ReadBufferInPlace(size_t Count) { MRPT_UNUSED_PARAM(Count); return NULL; }
+
 			/** Writes a block of bytes to the stream from Buffer.
 			 *	\exception std::exception On any error
 			 *  \sa Important, see: WriteBufferFixEndianness
@@ -181,6 +197,22 @@ namespace mrpt
 			 */
 			void ReadObject(CSerializable *existingObj);
 
+			/** Enables or disables the per-stream dictionary of class names used by WriteObject() (disabled by default).
+			  * While enabled, the first object written of each class carries its class name together with a short numeric ID,
+			  * and the next objects of the same class only carry the 2-byte ID. This saves the class name in every small object
+			  * (and in every nested object, like the poses or images inside observations), and also the lookup of the class
+			  * by its name while reading.
+			  *
+			  * ReadObject() always understands both formats, but a stream written with the dictionary must be read from its
+			  * beginning (or at least, from a point after the definition of each class ID it uses), and it cannot be read by MRPT versions older than 1.5.0.
+			  * \sa resetClassIDDictionary
+			  */
+			void enableClassIDDictionary(bool enable = true) { m_class_dict_enabled = enable; }
+			bool isClassIDDictionaryEnabled() const { return m_class_dict_enabled; }
+
+			/** Forgets all the class IDs written or read so far. Call it before starting to write or read an independent sequence of objects in the same stream (e.g. after rewinding a CMemoryStream to write new contents). */
+			void resetClassIDDictionary() { m_class_dict_write.clear(); m_class_dict_read.clear(); }
+
 			/** Write an object to a stream in the binary MRPT format. */
 			CStream& operator << (const CSerializablePtr & pObj);
 			/** Write an object to a stream in the binary MRPT format. */
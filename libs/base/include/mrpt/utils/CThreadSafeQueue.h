@@ -48,6 +48,7 @@ namespace mrpt
 		  *   if responsibility of the receiver of this queue as it receives objects with \a get(). However, elements
 		  *   still in the queue upon destruction will be deleted automatically.
 		  *
+		  * \note For a bounded queue without locks, see mrpt::synch::CLockFreeQueueSPSC and mrpt::synch::CLockFreeQueueMPMC
 		  * \sa mrpt::utils::CMessageQueue
 		 * \ingroup mrpt_base_grp
 		  */
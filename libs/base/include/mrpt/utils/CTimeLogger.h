@@ -27,6 +27,23 @@ namespace mrpt
 		 *
 		 *  This class can be also used to monitorize min/mean/max/total stats of any user-provided parameters via the method CTimeLogger::registerUserMeasure()
 		 *
+		 *  <b>Tracing mode:</b> By default, enter() and leave() look up the section name in a map, and they are not thread-safe.
+		 *  After enableTracing(), they just append a timestamped event to a buffer owned by the calling thread instead, without any lock
+		 *  nor string operation, so they can be called from any thread and left enabled in production code. Stats are then computed
+		 *  from the recorded events whenever they are requested (getStats(), getStatsAsText(), saveToCSVFile(),...), and the whole
+		 *  timeline, with the nesting of the sections of each thread, can be exported with saveToChromeTraceFile() and
+		 *  visualized in Chrome's `chrome://tracing`. See also setTracingSampling().
+		 *  \code
+		 *   CTimeLogger tl;
+		 *   tl.enableTracing(true, 1<<20, true); // Ring buffer: keep the last 1M events of each thread
+		 *   ...
+		 *   { CTimeLoggerEntry tle(tl,"my_function"); ... } // From any thread
+		 *   ...
+		 *   tl.saveToChromeTraceFile("trace.json");
+		 *  \endcode
+		 *  In tracing mode, events are identified by the address of their section name, so names must be string literals (or strings which
+		 *  exist until the stats are requested), and registerUserMeasure() is still not thread-safe.
+		 *
 		 * \sa CTimeLoggerEntry
 		 *
 		 * \note The default behavior is dumping all the information at destruction.
@@ -52,8 +69,14 @@ namespace mrpt
 
 			std::map<std::string,TCallData>  m_data;
 
+			struct TTraceData;
+			TTraceData  *m_trace;          //!< Only !=NULL in tracing mode
+			unsigned int m_trace_sampling; //!< See setTracingSampling()
+
 			void do_enter( const char *func_name );
 			double do_leave( const char *func_name );
+			double do_trace( const char *func_name, bool is_enter );
+			void getAllCallData(std::map<std::string,TCallData> &out_data) const; //!< m_data plus the data from the trace events
 
 		public:
 			/** Data of each call section: # of calls, minimum, maximum, average and overall execution time (in seconds) \sa getStats */
@@ -88,6 +111,27 @@ namespace mrpt
 			}
 			/** Return the mean execution time of the given "section", or 0 if it hasn't ever been called "enter" with that section name */
 			double getMeanTime(const std::string &name) const;
+
+			/** \name Tracing mode
+			  * @{ */
+
+			/** Enables or disables the tracing mode (see the description of the class). Events recorded so far are discarded in both cases.
+			  * \param max_events_per_thread The size of the buffer preallocated for each thread (one enter() or leave() is one event).
+			  * \param ring_buffer If false, new events are dropped once the buffer of their thread is full. If true, they overwrite the
+			  *        oldest events instead, so the stats and the trace always refer to the most recent activity ("always-on" capture).
+			  * \note Do not call it (nor clear()) while other threads may be inside enter() or leave() of this object. */
+			void enableTracing(bool enable = true, size_t max_events_per_thread = 100000, bool ring_buffer = false);
+			bool isTracingEnabled() const { return m_trace!=NULL; }
+
+			/** In tracing mode, only record 1 out of every `one_out_of_n` outermost sections of each thread (with all their nested sections).
+			  * Default=1 (record all). */
+			void setTracingSampling(unsigned int one_out_of_n) { m_trace_sampling = one_out_of_n>0 ? one_out_of_n : 1; }
+
+			/** Saves all the sections recorded in tracing mode to a JSON file in the Chrome trace event format (open it in `chrome://tracing`).
+			  * \return false on any error, or if the tracing mode is not enabled. */
+			bool saveToChromeTraceFile(const std::string &json_file) const;
+
+			/** @} */
 		}; // End of class def.
 
 
@@ -12,6 +12,8 @@
 #include <mrpt/bayes/CParticleFilterCapable.h>
 #include <mrpt/random.h>
 #include <mrpt/math/ops_vectors.h>
+#include <mrpt/system/parallelization.h>
+#include <numeric>
 
 using namespace mrpt;
 using namespace mrpt::utils;
@@ -21,8 +23,6 @@ using namespace mrpt::math;
 using namespace std;
 
 
-const unsigned CParticleFilterCapable::PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS = 20;
-
 /*---------------------------------------------------------------
 					performResampling
  ---------------------------------------------------------------*/
@@ -52,12 +52,76 @@ void  CParticleFilterCapable::performResampling(
 	// And perform the particle replacement:
 	performSubstitution( indxs );
 
-	// Finally, equal weights:
-	for (size_t i=0;i<out_particle_count;i++) setW(i, 0 /* Logarithmic weight */ );
+	// Finally, equal weights (note that out_particle_count may be 0, meaning "the same number of particles"):
+	const size_t new_particle_count = particlesCount();
+	for (size_t i=0;i<new_particle_count;i++) setW(i, 0 /* Logarithmic weight */ );
 
 	MRPT_END
 }
 
+namespace
+{
+	/** Q[i] = sum_{k<=i} exp(logW[k]-max(logW)), returns the sum of all the (unnormalized) weights */
+	double computeCumulativeWeights(const vector<double> &in_logWeights, vector<double> &Q)
+	{
+		const size_t M = in_logWeights.size();
+		Q.resize(M);
+		Eigen::Map<const Eigen::ArrayXd> logW(&in_logWeights[0], M);
+		Eigen::Map<Eigen::ArrayXd> linW(&Q[0], M);
+		linW = (logW - logW.maxCoeff()).exp();  // This avoids floating point range problems
+		std::partial_sum(Q.begin(),Q.end(),Q.begin());
+		const double W = Q[M-1];
+		ASSERT_(W>0);
+		MRPT_CHECK_NORMAL_NUMBER(W);
+		return W;
+	}
+
+	/** Draws N sorted samples of U(0,W) in O(N) (normalized sums of exponential variables) */
+	void drawSortedUniforms(const size_t N, const double W, vector<double> &T)
+	{
+		T.resize(N);
+		double S=0;
+		for (size_t i=0;i<N;i++)
+			T[i] = (S -= log(1.0-randomGenerator.drawUniform(0.0,1.0)));
+		S -= log(1.0-randomGenerator.drawUniform(0.0,1.0));
+		const double K = W/S;
+		for (size_t i=0;i<N;i++) T[i]*=K;
+	}
+
+	/** For a range of sorted targets T[i], finds the first index j with Q[j]>T[i], given the cumulative weights Q.
+	  * Each range starts with a binary search, then merges both sorted sequences. */
+	struct TResamplingSearch
+	{
+		const vector<double> &Q;
+		const vector<double> &T;
+		size_t *out_indexes;
+
+		TResamplingSearch(const vector<double> &Q_, const vector<double> &T_, size_t *out_indexes_) :
+			Q(Q_), T(T_), out_indexes(out_indexes_)
+		{ }
+
+		void operator()(const mrpt::system::BlockedRange &range) const
+		{
+			const size_t M = Q.size();
+			size_t j = std::upper_bound(Q.begin(),Q.end(), T[range.begin()]) - Q.begin();
+			for (int i=range.begin();i<range.end();i++)
+			{
+				while (j<M && !(T[i]<Q[j])) j++;
+				out_indexes[i] = j<M ? j : M-1; // (j==M only due to round-off errors)
+			}
+		}
+	};
+
+	void resamplingSearch(const vector<double> &Q, const vector<double> &T, size_t *out_indexes)
+	{
+		const int N = static_cast<int>(T.size());
+		if (!N) return;
+		mrpt::system::parallel_for(
+			mrpt::system::BlockedRange(0,N,4096),
+			TResamplingSearch(Q,T,out_indexes) );
+	}
+}
+
 /*---------------------------------------------------------------
 						resample
  ---------------------------------------------------------------*/
@@ -69,28 +133,20 @@ void CParticleFilterCapable::computeResampling(
 {
 	MRPT_START
 
-	// Compute the normalized linear weights:
-	//  The array "linW" will be the input to the actual
-	//  resampling algorithms.
-	size_t							i,j,M=in_logWeights.size();
+	// All the methods draw a sorted sequence of "targets" T in [0,W), then
+	//  find the particles they fall into in the cumulative sum of weights Q.
+	const size_t M = in_logWeights.size();
 	ASSERT_(M>0)
 
 	if (!out_particle_count)
 		out_particle_count = M;
+	const size_t N = out_particle_count;
 
-	vector<double>					linW( M,0 );
-	vector<double>::const_iterator	inIt;
-	vector<double>::iterator			outIt;
-	double							linW_SUM=0;
-
-	// This is to avoid float point range problems:
-	double max_log_w = math::maximum( in_logWeights );
-	for (i=0,inIt=in_logWeights.begin(),outIt=linW.begin();i<M;i++,inIt++,outIt++)
-		linW_SUM += ( (*outIt) = exp( (*inIt) - max_log_w ) );
+	vector<double> Q;
+	const double W = computeCumulativeWeights(in_logWeights, Q);
 
-	// Normalize weights:
-	ASSERT_(linW_SUM>0);
-	linW *= 1.0 / linW_SUM;
+	vector<double> T;
+	out_indexes.resize(N);
 
 	switch ( method )
 	{
@@ -99,33 +155,8 @@ void CParticleFilterCapable::computeResampling(
 			// ==============================================
 			//   Select with replacement
 			// ==============================================
-			vector<double>	Q;
-			mrpt::math::cumsum_tmpl<vector<double>,vector<double>,double>(linW, Q);
-			Q[M-1] = 1.1;
-
-			vector<double>	T(M);
-			randomGenerator.drawUniformVector(T,0.0, 0.999999);
-			T.push_back(1.0);
-
-			// Sort:
-			// --------------------
-			sort( T.begin(), T.end() );
-
-			out_indexes.resize(out_particle_count);
-			i=j=0;
-
-			while (i < out_particle_count)
-			{
-				if (T[i]<Q[j])
-				{
-					out_indexes[i++] = (unsigned int) j;
-				}
-				else
-				{
-					j++;
-					if (j>=M) j=M-1;
-				}
-			}
+			drawSortedUniforms(N,W,T);
+			resamplingSearch(Q,T,&out_indexes[0]);
 		}
 		break;	// end of "Select with replacement"
 
@@ -134,63 +165,29 @@ void CParticleFilterCapable::computeResampling(
 			// ==============================================
 			//   prResidual
 			// ==============================================
-			// Repetition counts:
-			vector_uint	N(M);
-			size_t 		R=0;	// Remainder or residual count
-			for (i=0;i<M;i++)
+			// Deterministic part: floor(N*w_i) copies of each particle.
+			// Residual part: multinomial resampling with the remainders.
+			const double N_W = N/W;
+			vector<double> Q_res(M);
+			size_t j=0;
+			double prev_Q=0, R_sum=0;
+			for (size_t i=0;i<M;i++)
 			{
-				N[i] = int( M*linW[i] );
-				R+= N[i];
-			}
-			size_t  N_rnd =  out_particle_count>=R ? (out_particle_count-R) : 0; // # of particles to be drawn randomly (the "residual" part)
-
-			// Fillout the deterministic part of the resampling:
-			out_indexes.resize(out_particle_count);
-			for (i=0, j=0 ;i<out_particle_count;i++)
-				for (size_t k=0;k<N[i];k++)
+				const double Nw = N_W*(Q[i]-prev_Q);
+				prev_Q = Q[i];
+				const size_t Ni = std::min(static_cast<size_t>(Nw), N-j);
+				for (size_t k=0;k<Ni;k++)
 					out_indexes[j++] = i;
-
-			size_t M_fixed = j;
-
-			// Prepare a multinomial resampling with the residual part,
-			//  using the modified weights:
-			// ----------------------------------------------------------
+				Q_res[i] = (R_sum += Nw-Ni);
+			}
+			const size_t N_rnd = N-j; // # of particles to be drawn randomly (the "residual" part)
 			if (N_rnd)	// If there are "residual" part (should be virtually always!)
 			{
-				// Compute modified weights:
-				vector<double>	linW_mod(M);
-				const double M_R_1 = 1.0/N_rnd;
-				for (i=0;i<M;i++)
-					linW_mod[i] = M_R_1 * (M*linW[i]-N[i]);
-
-				// perform resampling:
-				vector<double>	Q;
-				mrpt::math::cumsum_tmpl<vector<double>,vector<double>,double>(linW_mod, Q);
-				Q[M-1] = 1.1;
-
-				vector<double>	T(M);
-				randomGenerator.drawUniformVector(T, 0.0 , 0.999999);
-				T.push_back(1.0);
-
-				// Sort:
-				sort( T.begin(), T.end() );
-
-				i=0;
-				j=0;
-
-				while (i < N_rnd)
-				{
-					if (T[i]<Q[j])
-					{
-						out_indexes[M_fixed + i++] = (unsigned int) j;
-					}
-					else
-					{
-						j++;
-						if (j>=M) j=M-1;
-					}
-				}
-			} // end if N_rnd!=0
+				drawSortedUniforms(N_rnd,R_sum,T);
+				resamplingSearch(Q_res,T,&out_indexes[j]);
+				// Both parts are sorted: keep the output sorted as in the other methods.
+				std::inplace_merge(out_indexes.begin(), out_indexes.begin()+j, out_indexes.end());
+			}
 		}
 		break;
 	case CParticleFilter::prStratified:
@@ -198,34 +195,12 @@ void CParticleFilterCapable::computeResampling(
 			// ==============================================
 			//   prStratified
 			// ==============================================
-			vector<double>	Q;
-			mrpt::math::cumsum_tmpl<vector<double>,vector<double>,double>(linW, Q);
-			Q[M-1] = 1.1;
-
-			// Stratified-uniform random vector:
-			vector<double>	T(M+1);
-			const double	_1_M = 1.0 / M;
-			const double	_1_M_eps = _1_M - 0.000001;
-			double   		T_offset = 0;
-			for (i=0;i<M;i++)
-			{
-				T[i] = T_offset + randomGenerator.drawUniform(0.0,_1_M_eps);
-				T_offset+= _1_M;
-			}
-			T[M] = 1;
-
-			out_indexes.resize(out_particle_count);
-			i=j=0;
-			while (i < out_particle_count)
-			{
-				if (T[i]<Q[j])
-					out_indexes[i++] = (unsigned int)j;
-				else
-				{
-					j++;
-					if (j>=M) j=M-1;
-				}
-			}
+			// One uniform sample in each of the N strata:
+			T.resize(N);
+			const double W_N = W / N;
+			for (size_t i=0;i<N;i++)
+				T[i] = W_N * (i + randomGenerator.drawUniform(0.0,0.999999));
+			resamplingSearch(Q,T,&out_indexes[0]);
 		}
 		break;
 	case CParticleFilter::prSystematic:
@@ -233,30 +208,13 @@ void CParticleFilterCapable::computeResampling(
 			// ==============================================
 			//   prSystematic
 			// ==============================================
-			vector<double>	Q;
-			mrpt::math::cumsum_tmpl<vector<double>,vector<double>,double>(linW, Q);
-			Q[M-1] = 1.1;
-
-			// Uniform random vector:
-			vector<double>	T(M+1);
-			double	_1_M = 1.0 / M;
-			T[0] = randomGenerator.drawUniform(0.0,_1_M);
-			for (i=1;i<M;i++)	T[i] = T[i-1] + _1_M;
-			T[M] = 1;
-
-			out_indexes.resize(out_particle_count);
-			i=j=0;
-			while (i < out_particle_count)
-			{
-				if (T[i]<Q[j])
-					out_indexes[i++] = (unsigned int)j;
-				else
-				{
-					j++;
-					if (j>=M) j=M-1;
-				}
-			}
-
+			// The same offset in all the N strata:
+			T.resize(N);
+			const double W_N = W / N;
+			const double u = randomGenerator.drawUniform(0.0,0.999999);
+			for (size_t i=0;i<N;i++)
+				T[i] = W_N * (i + u);
+			resamplingSearch(Q,T,&out_indexes[0]);
 		}
 		break;
 	default:
@@ -362,62 +320,16 @@ void  CParticleFilterCapable::prepareFastDrawSample(
 		if (PF_options.resamplingMethod!=CParticleFilter::prMultinomial)
 			THROW_EXCEPTION("resamplingMethod must be 'prMultinomial' for a dynamic number of particles!");
 
-		size_t	i,j=666666,M = particlesCount();
-
-		MRPT_START
+		const size_t M = particlesCount();
 
-		// Prepare buffers:
-		m_fastDrawAuxiliary.CDF.resize( 1+PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS, 0);
-		m_fastDrawAuxiliary.CDF_indexes.resize( PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS, 0);
-
-		// Compute the vector of each particle's probability (usually
+		// Compute the vector of each particle's (log) probability (usually
 		//  it will be simply the weight, but there are other algorithms)
-		m_fastDrawAuxiliary.PDF.resize( M, 0);
-
-		// This is done to avoid floating point overflow!! (JLBC - SEP 2007)
-		// -------------------------------------------------------------------
-		double	SUM = 0;
-		// Save the log likelihoods:
-		for (i=0;i<M;i++)	m_fastDrawAuxiliary.PDF[i] = partEvaluator(PF_options, this,i,action,observation);
-		// "Normalize":
-		m_fastDrawAuxiliary.PDF += -math::maximum( m_fastDrawAuxiliary.PDF );
-		for (i=0;i<M;i++)	SUM += m_fastDrawAuxiliary.PDF[i] = exp( m_fastDrawAuxiliary.PDF[i] );
-		ASSERT_(SUM>=0);
-		MRPT_CHECK_NORMAL_NUMBER(SUM);
-		m_fastDrawAuxiliary.PDF *= 1.0/SUM;
-
-		// Compute the CDF thresholds:
-		for (i=0;i<PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS;i++)
-			m_fastDrawAuxiliary.CDF[i] = ((double)i) / ((double)PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS);
-		m_fastDrawAuxiliary.CDF[PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS] = 1.0;
-
-		// Compute the CDF and save threshold indexes:
-		double	CDF = 0; // Cumulative density func.
-		for (i=0,j=0;i<M && j<PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS;i++)
-		{
-			double CDF_next = CDF + m_fastDrawAuxiliary.PDF[i];
-			if (i==(M-1)) CDF_next = 1.0;	// rounds fix...
-			if (CDF_next>1.0) CDF_next = 1.0;
-
-			while ( m_fastDrawAuxiliary.CDF[j] < CDF_next )
-				m_fastDrawAuxiliary.CDF_indexes[j++] = (unsigned int)i;
-
-			CDF = CDF_next;
-		}
-
-		ASSERT_( j == PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS );
-
-		// Done!
-#if !defined(_MSC_VER) || (_MSC_VER>1400)  // <=VC2005 doesn't work with this!
-		MRPT_END_WITH_CLEAN_UP( \
-			/* Debug: */ \
-			cout << "j=" << j << "\nm_fastDrawAuxiliary.CDF_indexes:" << m_fastDrawAuxiliary.CDF_indexes << endl; \
-			cout << "m_fastDrawAuxiliary.CDF:" << m_fastDrawAuxiliary.CDF << endl; \
-			);
-#else
-		MRPT_END
-#endif
+		m_fastDrawAuxiliary.PDF.resize(M);
+		for (size_t i=0;i<M;i++)	m_fastDrawAuxiliary.PDF[i] = partEvaluator(PF_options, this,i,action,observation);
 
+		// The normalized CDF, where fastDrawSample() does a binary search:
+		const double SUM = computeCumulativeWeights(m_fastDrawAuxiliary.PDF, m_fastDrawAuxiliary.CDF);
+		m_fastDrawAuxiliary.CDF *= 1.0/SUM;
 	}
 	else
 	{
@@ -464,29 +376,11 @@ size_t  CParticleFilterCapable::fastDrawSample( const bayes::CParticleFilter::TP
 		if (PF_options.resamplingMethod!=CParticleFilter::prMultinomial)
 			THROW_EXCEPTION("resamplingMethod must be 'prMultinomial' for a dynamic number of particles!");
 
-		double draw = randomGenerator.drawUniform(0,0.999999);
-		double CDF_next=-1.;
-		double CDF = -1.;
-
-		MRPT_START
-
-		// Use the look-up table to see the starting index we must start looking from:
-		size_t j = (size_t)floor( draw * ((double)PARTICLE_FILTER_CAPABLE_FAST_DRAW_BINS-0.05) );
-		CDF = m_fastDrawAuxiliary.CDF[j];
-		size_t i = m_fastDrawAuxiliary.CDF_indexes[j];
-
-		// Find the drawn particle!
-		while ( draw > (CDF_next = CDF+m_fastDrawAuxiliary.PDF[i]) )
-		{
-			CDF = CDF_next;
-			i++;
-		}
-
-		return i;
-
-		MRPT_END_WITH_CLEAN_UP( \
-			printf("\n[CParticleFilterCapable::fastDrawSample] DEBUG: draw=%f, CDF=%f CDF_next=%f\n",draw,CDF,CDF_next); \
-			);
+		const std::vector<double> &CDF = m_fastDrawAuxiliary.CDF;
+		ASSERTDEB_(!CDF.empty())
+		const double draw = randomGenerator.drawUniform(0.0,1.0);
+		const size_t i = std::upper_bound(CDF.begin(),CDF.end(),draw) - CDF.begin();
+		return i<CDF.size() ? i : CDF.size()-1;
 	}
 	else
 	{
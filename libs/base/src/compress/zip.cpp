@@ -237,13 +237,19 @@ void  mrpt::compress::zip::decompress(
 	unsigned long	actualOutSize = (unsigned long)outDataBufferSize;
 	std::vector<unsigned char>		inData;
 
-	inData.resize(inDataSize);
-	inStream.ReadBuffer( &inData[0], inDataSize );
+	// Decompress straight from the stream memory, if possible:
+	const unsigned char *inPtr = static_cast<const unsigned char*>(inStream.ReadBufferInPlace(inDataSize));
+	if (!inPtr)
+	{
+		inData.resize(inDataSize);
+		inStream.ReadBuffer( &inData[0], inDataSize );
+		inPtr = &inData[0];
+	}
 
 	ret = ::uncompress(
 		(unsigned char*)outData,
 		&actualOutSize,
-		&inData[0],
+		inPtr,
 		(unsigned long)inDataSize
 		);
 
@@ -257,6 +263,23 @@ void  mrpt::compress::zip::decompress(
 }
 
 
+/*---------------------------------------------------------------
+					is_gz_file
+---------------------------------------------------------------*/
+bool mrpt::compress::zip::is_gz_file(const std::string &file_path)
+{
+	CFileInputStream  f;
+	if (!f.open(file_path))
+		return false;
+	uint8_t  magic[2] = {0,0};
+	try {
+		f.ReadBuffer(magic,2);
+	} catch (std::exception &) {
+		return false; // Empty file
+	}
+	return magic[0]==0x1F && magic[1]==0x8B;
+}
+
 /*---------------------------------------------------------------
 					decompress_gz_file
 ---------------------------------------------------------------*/
@@ -44,9 +44,9 @@ void  CMatrix::writeToStream(mrpt::utils::CStream &out, int *out_Version) const
 		// First, write the number of rows and columns:
 		out << (uint32_t)rows() << (uint32_t)cols();
 
+		// Row-major, contiguous storage: dump all the elements at once.
 		if (rows()>0 && cols()>0)
-			for (Index i=0;i<rows();i++)
-				out.WriteBufferFixEndianness<Scalar>(&coeff(i,0),cols());
+			out.WriteBufferFixEndianness<Scalar>(data(),size());
 	}
 
 }
@@ -65,11 +65,11 @@ void  CMatrix::readFromStream(mrpt::utils::CStream &in, int version)
 			// First, write the number of rows and columns:
 			in >> nRows >> nCols;
 
-			setSize(nRows,nCols);
+			// No need to keep or zero the old contents (as setSize() does), they are overwritten right away:
+			resize(nRows,nCols);
 
 			if (nRows>0 && nCols>0)
-				for (Index i=0;i<rows();i++)
-					in.ReadBufferFixEndianness<Scalar>(&coeffRef(i,0),nCols);
+				in.ReadBufferFixEndianness<Scalar>(data(),size());
 		} break;
 	default:
 		MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version)
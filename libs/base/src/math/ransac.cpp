@@ -10,6 +10,7 @@
 #include "base-precomp.h"  // Precompiled headers
 
 #include <mrpt/math/ransac.h>
+#include <mrpt/math/ransac_engine.h>
 #include <mrpt/math/ops_vectors.h>
 #include <mrpt/math/CMatrix.h>
 #include <mrpt/math/CMatrixD.h>
@@ -23,6 +24,68 @@ using namespace mrpt::math;
 using namespace std;
 
 
+TRansacEngineParams::TRansacEngineParams() :
+	prob_good_sample(0.999),
+	max_iters(2000),
+	max_degenerate_trials(100),
+	hypotheses_per_batch(32),
+	score_chunk_size(256),
+	Tdd_pretest(0)
+{
+}
+
+namespace
+{
+	/** Adapts the callbacks of RANSAC_Template to the interface of RANSAC_Engine.
+	  *  Samples are scored by passing the whole data matrix to the distance callback, which reports inliers with a distance
+	  *  of 0 and outliers with 1, so the engine must be set to score all the samples in one single chunk, without T(d,d) pre-test. */
+	template <typename NUMTYPE>
+	struct TRansacTemplateFit
+	{
+		typedef NUMTYPE                         Real;
+		typedef CMatrixTemplateNumeric<NUMTYPE> Model;
+
+		const CMatrixTemplateNumeric<NUMTYPE>                        &data;
+		typename RANSAC_Template<NUMTYPE>::TRansacFitFunctor          fit_func;
+		typename RANSAC_Template<NUMTYPE>::TRansacDistanceFunctor     dist_func;
+		typename RANSAC_Template<NUMTYPE>::TRansacDegenerateFunctor   degen_func;
+		const NUMTYPE                                                 distanceThreshold;
+
+		TRansacTemplateFit(
+			const CMatrixTemplateNumeric<NUMTYPE> &data_,
+			typename RANSAC_Template<NUMTYPE>::TRansacFitFunctor fit_func_,
+			typename RANSAC_Template<NUMTYPE>::TRansacDistanceFunctor dist_func_,
+			typename RANSAC_Template<NUMTYPE>::TRansacDegenerateFunctor degen_func_,
+			const NUMTYPE distanceThreshold_) :
+			data(data_), fit_func(fit_func_), dist_func(dist_func_), degen_func(degen_func_), distanceThreshold(distanceThreshold_)
+		{}
+
+		size_t getSampleCount() const { return size(data,2); }
+
+		bool fitModels( const vector_size_t& useIndices, std::vector<Model>& models ) const
+		{
+			if (degen_func(data, useIndices))
+				return false;
+			// Note that "models" may represent a set of models that fit the data
+			fit_func(data,useIndices,models);
+			return true;
+		}
+
+		void testSamples( const size_t first, const size_t count, const Model& model, Real *out_dists ) const
+		{
+			ASSERTDEB_(first==0 && count==size(data,2))
+			MRPT_UNUSED_PARAM(first);
+			std::vector<Model> models(1,model);
+			unsigned int bestModelIdx = 0;
+			vector_size_t inliers;
+			dist_func(data,models,distanceThreshold,bestModelIdx,inliers);
+			std::fill(out_dists,out_dists+count, NUMTYPE(1));
+			for (size_t i=0;i<inliers.size();i++)
+				out_dists[inliers[i]] = 0;
+		}
+	};
+}
+
 /*---------------------------------------------------------------
 			ransac generic implementation
  ---------------------------------------------------------------*/
@@ -45,125 +108,40 @@ bool RANSAC_Template<NUMTYPE>::execute(
 
 	ASSERT_(minimumSizeSamplesToFit>=1)
 
-	// Highly inspired on http://www.csse.uwa.edu.au/~pk/
-
 	const size_t D = size(data,1);  //  dimensionality
 	const size_t Npts = size(data,2);
 
 	ASSERT_(D>=1);
 	ASSERT_(Npts>1);
 
-	const size_t maxDataTrials = 100; // Maximum number of attempts to select a non-degenerate data set.
-
 	out_best_model.setSize(0,0);  // Sentinel value allowing detection of solution failure.
 	out_best_inliers.clear();
 
-	size_t trialcount = 0;
-	size_t bestscore = std::string::npos; // npos will mean "none"
-	size_t N = 1;     // Dummy initialisation for number of trials.
+	// Distances reported to the engine are 0 (inlier) or 1 (outlier):
+	const TRansacTemplateFit<NUMTYPE> fit(data,fit_func,dist_func,degen_func,static_cast<NUMTYPE>(distanceThreshold));
+	RANSAC_Engine< TRansacTemplateFit<NUMTYPE> > engine;
+	engine.params.prob_good_sample = p;
+	engine.params.max_iters = maxIter;
+	engine.params.score_chunk_size = Npts; // The distance callback scores all the samples at once
+	engine.params.Tdd_pretest = 0;
 
-	vector_size_t   ind( minimumSizeSamplesToFit );
+	size_t num_hypotheses = 0, num_degenerate = 0;
+	const bool ok = engine.execute(fit, NUMTYPE(0.5), minimumSizeSamplesToFit, out_best_model, out_best_inliers, NULL, &num_hypotheses, &num_degenerate);
 
-	while (N > trialcount)
-	{
-		// Select at random s datapoints to form a trial model, M.
-		// In selecting these points we have to check that they are not in
-		// a degenerate configuration.
-		bool degenerate=true;
-		size_t count = 1;
-		std::vector< CMatrixTemplateNumeric<NUMTYPE> >  MODELS;
-
-		while (degenerate)
-		{
-			// Generate s random indicies in the range 1..npts
-			ind.resize( minimumSizeSamplesToFit );
-
-			// The +0.99... is due to the floor rounding afterwards when converting from random double samples to size_t
-			randomGenerator.drawUniformVector(ind,0.0, Npts-1+0.999999 );
-
-			// Test that these points are not a degenerate configuration.
-			degenerate = degen_func(data, ind);
-
-			if (!degenerate)
-			{
-				// Fit model to this random selection of data points.
-				// Note that M may represent a set of models that fit the data
-				fit_func(data,ind,MODELS);
-
-				// Depending on your problem it might be that the only way you
-				// can determine whether a data set is degenerate or not is to
-				// try to fit a model and see if it succeeds.  If it fails we
-				// reset degenerate to true.
-				degenerate = MODELS.empty();
-			}
-
-			// Safeguard against being stuck in this loop forever
-			if (++count > maxDataTrials)
-			{
-				MRPT_LOG_WARN("Unable to select a nondegenerate data set");
-			}
-		}
+	if (num_degenerate>0)
+		MRPT_LOG_WARN( format("Unable to select a nondegenerate data set for %u out of %u hypotheses\n", (unsigned)num_degenerate, (unsigned)num_hypotheses ));
+	if (num_hypotheses>=maxIter)
+		MRPT_LOG_WARN( format("Warning: maximum number of trials (%u) reached\n", (unsigned)maxIter ));
 
-		// Once we are out here we should have some kind of model...
-		// Evaluate distances between points and model returning the indices
-		// of elements in x that are inliers.  Additionally, if M is a cell
-		// array of possible models 'distfn' will return the model that has
-		// the most inliers.  After this call M will be a non-cell objec
-		// representing only one model.
-		unsigned int bestModelIdx = 1000;
-		mrpt::vector_size_t   inliers;
-		if (!degenerate)
-		{
-			dist_func(data,MODELS, distanceThreshold, bestModelIdx, inliers);
-			ASSERT_( bestModelIdx<MODELS.size() );
-		}
-
-		// Find the number of inliers to this model.
-		const size_t ninliers = inliers.size();
-		bool  update_estim_num_iters = (trialcount==0); // Always update on the first iteration, regardless of the result (even for ninliers=0)
-
-		if (ninliers > bestscore || (bestscore==std::string::npos && ninliers!=0))
-		{
-			bestscore = ninliers;  // Record data for this model
-
-			out_best_model    = MODELS[bestModelIdx];
-			out_best_inliers  = inliers;
-			update_estim_num_iters=true;
-		}
-
-		if (update_estim_num_iters)
-		{
-			// Update estimate of N, the number of trials to ensure we pick,
-			// with probability p, a data set with no outliers.
-			double fracinliers =  ninliers/static_cast<double>(Npts);
-			double pNoOutliers = 1 -  pow(fracinliers,static_cast<double>(minimumSizeSamplesToFit));
-
-			pNoOutliers = std::max( std::numeric_limits<double>::epsilon(), pNoOutliers);  // Avoid division by -Inf
-			pNoOutliers = std::min(1.0 - std::numeric_limits<double>::epsilon() , pNoOutliers); // Avoid division by 0.
-			// Number of
-			N = log(1-p)/log(pNoOutliers);
-			MRPT_LOG_DEBUG( format("Iter #%u Estimated number of iters: %u  pNoOutliers = %f  #inliers: %u\n", (unsigned)trialcount ,(unsigned)N,pNoOutliers, (unsigned)ninliers));
-		}
-
-		++trialcount;
-
-		MRPT_LOG_DEBUG( format("trial %u out of %u \r",(unsigned int)trialcount, (unsigned int)ceil(static_cast<double>(N))) );
-
-		// Safeguard against being stuck in this loop forever
-		if (trialcount > maxIter)
-		{
-			MRPT_LOG_WARN( format("Warning: maximum number of trials (%u) reached\n", (unsigned)maxIter ));
-			break;
-		}
-	}
-
-	if (size(out_best_model,1)>0)
+	if (ok && size(out_best_model,1)>0)
 	{  // We got a solution
-		MRPT_LOG_INFO(format("Finished in %u iterations.\n",(unsigned)trialcount ));
+		MRPT_LOG_INFO(format("Finished in %u iterations.\n",(unsigned)num_hypotheses ));
 		return true;
 	}
 	else
 	{
+		out_best_model.setSize(0,0);
+		out_best_inliers.clear();
 		MRPT_LOG_WARN("Finished without any proper solution!");
 		return false;
 	}
@@ -171,9 +149,6 @@ bool RANSAC_Template<NUMTYPE>::execute(
 	MRPT_END
 }
 
-
-
-
 // Template instantiation:
 template class BASE_IMPEXP mrpt::math::RANSAC_Template<float>;
 template class BASE_IMPEXP mrpt::math::RANSAC_Template<double>;
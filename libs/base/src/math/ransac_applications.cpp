@@ -11,6 +11,8 @@
 
 
 #include <mrpt/math/ransac_applications.h>
+#include <mrpt/math/ransac_engine.h>
+#include <mrpt/utils/SSE_types.h>
 
 using namespace mrpt;
 using namespace mrpt::utils;
@@ -19,85 +21,193 @@ using namespace std;
 
 
 /*---------------------------------------------------------------
-		Aux. functions needed by ransac_detect_3D_planes
+	Aux. functions needed by ransac_detect_3D_planes & ransac_detect_2D_lines
  ---------------------------------------------------------------*/
-namespace mrpt
+namespace
 {
-	namespace math
+	// Distances of points (given as separate x,y,z arrays) to a plane with normalized coefficients k[]: |k0*x+k1*y+k2*z+k3|
+	template <typename T>
+	void planeDistances_scalar(const double *k, const size_t i0, const size_t N, const T *x, const T *y, const T *z, T *out)
 	{
-		template <typename T>
-		void  ransac3Dplane_fit(
-			const CMatrixTemplateNumeric<T> &allData,
-			const vector_size_t  &useIndices,
-			vector< CMatrixTemplateNumeric<T> > &fitModels )
+		for (size_t i=i0;i<N;i++)
+			out[i] = std::abs( static_cast<T>(k[0]*x[i]+k[1]*y[i]+k[2]*z[i]+k[3]) );
+	}
+	void planeDistances(const double *k, const size_t N, const float *x, const float *y, const float *z, float *out)
+	{
+		size_t i=0;
+#if MRPT_HAS_SSE2
+		// 4 points at once. Unaligned loads, since the arrays may start anywhere:
+		const __m128 k0 = _mm_set1_ps(static_cast<float>(k[0])), k1 = _mm_set1_ps(static_cast<float>(k[1]));
+		const __m128 k2 = _mm_set1_ps(static_cast<float>(k[2])), k3 = _mm_set1_ps(static_cast<float>(k[3]));
+		const __m128 sign_mask = _mm_set1_ps(-0.0f);
+		for (;i+4<=N;i+=4)
 		{
-			ASSERT_(useIndices.size()==3);
+			const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(k0,_mm_loadu_ps(x+i)),_mm_mul_ps(k1,_mm_loadu_ps(y+i))),_mm_add_ps(_mm_mul_ps(k2,_mm_loadu_ps(z+i)),k3));
+			_mm_storeu_ps(out+i, _mm_andnot_ps(sign_mask,d));
+		}
+#endif
+		planeDistances_scalar(k,i,N,x,y,z,out);
+	}
+	void planeDistances(const double *k, const size_t N, const double *x, const double *y, const double *z, double *out)
+	{
+		size_t i=0;
+#if MRPT_HAS_SSE2
+		// 2 points at once:
+		const __m128d k0 = _mm_set1_pd(k[0]), k1 = _mm_set1_pd(k[1]), k2 = _mm_set1_pd(k[2]), k3 = _mm_set1_pd(k[3]);
+		const __m128d sign_mask = _mm_set1_pd(-0.0);
+		for (;i+2<=N;i+=2)
+		{
+			const __m128d d = _mm_add_pd(_mm_add_pd(_mm_mul_pd(k0,_mm_loadu_pd(x+i)),_mm_mul_pd(k1,_mm_loadu_pd(y+i))),_mm_add_pd(_mm_mul_pd(k2,_mm_loadu_pd(z+i)),k3));
+			_mm_storeu_pd(out+i, _mm_andnot_pd(sign_mask,d));
+		}
+#endif
+		planeDistances_scalar(k,i,N,x,y,z,out);
+	}
+#ifdef HAVE_LONG_DOUBLE
+	void planeDistances(const double *k, const size_t N, const long double *x, const long double *y, const long double *z, long double *out)
+	{
+		planeDistances_scalar(k,0,N,x,y,z,out);
+	}
+#endif
 
-			TPoint3D  p1( allData(0,useIndices[0]),allData(1,useIndices[0]),allData(2,useIndices[0]) );
-			TPoint3D  p2( allData(0,useIndices[1]),allData(1,useIndices[1]),allData(2,useIndices[1]) );
-			TPoint3D  p3( allData(0,useIndices[2]),allData(1,useIndices[2]),allData(2,useIndices[2]) );
+	// Distances of points to a 2D line with normalized coefficients k[]: |k0*x+k1*y+k2|
+	template <typename T>
+	void lineDistances_scalar(const double *k, const size_t i0, const size_t N, const T *x, const T *y, T *out)
+	{
+		for (size_t i=i0;i<N;i++)
+			out[i] = std::abs( static_cast<T>(k[0]*x[i]+k[1]*y[i]+k[2]) );
+	}
+	void lineDistances(const double *k, const size_t N, const float *x, const float *y, float *out)
+	{
+		size_t i=0;
+#if MRPT_HAS_SSE2
+		const __m128 k0 = _mm_set1_ps(static_cast<float>(k[0])), k1 = _mm_set1_ps(static_cast<float>(k[1])), k2 = _mm_set1_ps(static_cast<float>(k[2]));
+		const __m128 sign_mask = _mm_set1_ps(-0.0f);
+		for (;i+4<=N;i+=4)
+		{
+			const __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(k0,_mm_loadu_ps(x+i)),_mm_mul_ps(k1,_mm_loadu_ps(y+i))),k2);
+			_mm_storeu_ps(out+i, _mm_andnot_ps(sign_mask,d));
+		}
+#endif
+		lineDistances_scalar(k,i,N,x,y,out);
+	}
+	void lineDistances(const double *k, const size_t N, const double *x, const double *y, double *out)
+	{
+		size_t i=0;
+#if MRPT_HAS_SSE2
+		const __m128d k0 = _mm_set1_pd(k[0]), k1 = _mm_set1_pd(k[1]), k2 = _mm_set1_pd(k[2]);
+		const __m128d sign_mask = _mm_set1_pd(-0.0);
+		for (;i+2<=N;i+=2)
+		{
+			const __m128d d = _mm_add_pd(_mm_add_pd(_mm_mul_pd(k0,_mm_loadu_pd(x+i)),_mm_mul_pd(k1,_mm_loadu_pd(y+i))),k2);
+			_mm_storeu_pd(out+i, _mm_andnot_pd(sign_mask,d));
+		}
+#endif
+		lineDistances_scalar(k,i,N,x,y,out);
+	}
+#ifdef HAVE_LONG_DOUBLE
+	void lineDistances(const double *k, const size_t N, const long double *x, const long double *y, long double *out)
+	{
+		lineDistances_scalar(k,0,N,x,y,out);
+	}
+#endif
+
+	// Removes the elements with the given (sorted) indices:
+	template <typename T>
+	void removeIndices(std::vector<T> &v, const vector_size_t &sorted_idxs)
+	{
+		size_t j=0, k=0;
+		for (size_t i=0;i<v.size();i++)
+		{
+			if (k<sorted_idxs.size() && sorted_idxs[k]==i) { k++; continue; }
+			v[j++]=v[i];
+		}
+		v.resize(j);
+	}
+
+	/** The data & model for RANSAC_Engine in ransac_detect_3D_planes(): the remaining points, as separate coordinate arrays. */
+	template <typename NUMTYPE>
+	struct TPlanesRansacFit
+	{
+		typedef NUMTYPE Real;
+		typedef TPlane  Model;
+
+		std::vector<NUMTYPE> xs,ys,zs;
+
+		size_t getSampleCount() const { return xs.size(); }
 
+		bool fitModels( const vector_size_t& useIndices, std::vector<Model>& models ) const
+		{
+			ASSERT_(useIndices.size()==3);
+			const TPoint3D p1( xs[useIndices[0]],ys[useIndices[0]],zs[useIndices[0]] );
+			const TPoint3D p2( xs[useIndices[1]],ys[useIndices[1]],zs[useIndices[1]] );
+			const TPoint3D p3( xs[useIndices[2]],ys[useIndices[2]],zs[useIndices[2]] );
 			try
 			{
-				TPlane  plane( p1,p2,p3 );
-				fitModels.resize(1);
-				CMatrixTemplateNumeric<T> &M = fitModels[0];
-
-				M.setSize(1,4);
-				for (size_t i=0;i<4;i++)
-					M(0,i)=plane.coefs[i];
+				models.assign(1, TPlane(p1,p2,p3) );
+				return true;
 			}
 			catch(exception &)
 			{
-				fitModels.clear();
-				return;
+				return false; // Degenerate case
 			}
 		}
 
+		void testSamples( const size_t first, const size_t count, const Model& model, Real *out_dists ) const
+		{
+			const double inv_norm = 1.0/std::sqrt(square(model.coefs[0])+square(model.coefs[1])+square(model.coefs[2]));
+			const double k[4] = { model.coefs[0]*inv_norm, model.coefs[1]*inv_norm, model.coefs[2]*inv_norm, model.coefs[3]*inv_norm };
+			planeDistances(k,count,&xs[first],&ys[first],&zs[first],out_dists);
+		}
+
+		void removeSamples(const vector_size_t &sorted_idxs)
+		{
+			removeIndices(xs,sorted_idxs);
+			removeIndices(ys,sorted_idxs);
+			removeIndices(zs,sorted_idxs);
+		}
+	};
+
+	/** The data & model for RANSAC_Engine in ransac_detect_2D_lines(). */
+	template <typename NUMTYPE>
+	struct TLinesRansacFit
+	{
+		typedef NUMTYPE Real;
+		typedef TLine2D Model;
+
+		std::vector<NUMTYPE> xs,ys;
 
-		template <typename T>
-		void ransac3Dplane_distance(
-			const CMatrixTemplateNumeric<T> &allData,
-			const vector< CMatrixTemplateNumeric<T> > & testModels,
-			const T distanceThreshold,
-			unsigned int & out_bestModelIndex,
-			vector_size_t & out_inlierIndices )
+		size_t getSampleCount() const { return xs.size(); }
+
+		bool fitModels( const vector_size_t& useIndices, std::vector<Model>& models ) const
 		{
-			ASSERT_( testModels.size()==1 )
-			out_bestModelIndex = 0;
-			const CMatrixTemplateNumeric<T> &M = testModels[0];
-
-			ASSERT_( size(M,1)==1 && size(M,2)==4 )
-
-			TPlane  plane;
-			plane.coefs[0] = M(0,0);
-			plane.coefs[1] = M(0,1);
-			plane.coefs[2] = M(0,2);
-			plane.coefs[3] = M(0,3);
-
-			const size_t N = size(allData,2);
-			out_inlierIndices.clear();
-			out_inlierIndices.reserve(100);
-			for (size_t i=0;i<N;i++)
+			ASSERT_(useIndices.size()==2);
+			const TPoint2D p1( xs[useIndices[0]],ys[useIndices[0]] );
+			const TPoint2D p2( xs[useIndices[1]],ys[useIndices[1]] );
+			try
 			{
-				const double d = plane.distance( TPoint3D( allData.get_unsafe(0,i),allData.get_unsafe(1,i),allData.get_unsafe(2,i) ) );
-				if (d<distanceThreshold)
-					out_inlierIndices.push_back(i);
+				models.assign(1, TLine2D(p1,p2) );
+				return true;
 			}
+			catch(exception &)
+			{
+				return false; // Degenerate case
+			}
+		}
+
+		void testSamples( const size_t first, const size_t count, const Model& model, Real *out_dists ) const
+		{
+			const double inv_norm = 1.0/std::sqrt(square(model.coefs[0])+square(model.coefs[1]));
+			const double k[3] = { model.coefs[0]*inv_norm, model.coefs[1]*inv_norm, model.coefs[2]*inv_norm };
+			lineDistances(k,count,&xs[first],&ys[first],out_dists);
 		}
 
-		/** Return "true" if the selected points are a degenerate (invalid) case.
-		  */
-		template <typename T>
-		bool ransac3Dplane_degenerate(
-			const CMatrixTemplateNumeric<T> &allData,
-			const mrpt::vector_size_t &useIndices )
+		void removeSamples(const vector_size_t &sorted_idxs)
 		{
-			MRPT_UNUSED_PARAM(allData);
-			MRPT_UNUSED_PARAM(useIndices);
-			return false;
+			removeIndices(xs,sorted_idxs);
+			removeIndices(ys,sorted_idxs);
 		}
-	} // end namespace
+	};
 } // end namespace
 
 
@@ -123,49 +233,40 @@ void mrpt::math::ransac_detect_3D_planes(
 	if (x.empty())
 		return;
 
-	// The running lists of remaining points after each plane, as a matrix:
-	CMatrixTemplateNumeric<NUMTYPE> remainingPoints( 3, x.size() );
-	remainingPoints.insertRow(0,x);
-	remainingPoints.insertRow(1,y);
-	remainingPoints.insertRow(2,z);
+	// The running lists of remaining points after each plane:
+	TPlanesRansacFit<NUMTYPE> remainingPoints;
+	remainingPoints.xs.assign(&x[0],&x[0]+x.size());
+	remainingPoints.ys.assign(&y[0],&y[0]+y.size());
+	remainingPoints.zs.assign(&z[0],&z[0]+z.size());
 
+	RANSAC_Engine< TPlanesRansacFit<NUMTYPE> > ransac;
+	ransac.params.prob_good_sample = 0.999;
 
 	// ---------------------------------------------
 	// For each plane:
 	// ---------------------------------------------
-	for (;;)
+	while (remainingPoints.getSampleCount()>=3)
 	{
-		mrpt::vector_size_t				this_best_inliers;
-		CMatrixTemplateNumeric<NUMTYPE> this_best_model;
+		mrpt::vector_size_t  this_best_inliers;
+		TPlane               this_best_model;
 
-		math::RANSAC_Template<NUMTYPE> ransac;
 		ransac.execute(
 			remainingPoints,
-			ransac3Dplane_fit,
-			ransac3Dplane_distance,
-			ransac3Dplane_degenerate,
-			threshold,
+			static_cast<NUMTYPE>(threshold),
 			3,  // Minimum set of points
-			this_best_inliers,
 			this_best_model,
-			true, // Verbose
-			0.999  // Prob. of good result
-			);
+			this_best_inliers );
 
 		// Is this plane good enough?
 		if (this_best_inliers.size()>=min_inliers_for_valid_plane)
 		{
 			// Add this plane to the output list:
-			out_detected_planes.push_back(
-				std::make_pair<size_t,TPlane>(
-					this_best_inliers.size(),
-					TPlane( this_best_model(0,0), this_best_model(0,1),this_best_model(0,2),this_best_model(0,3) )
-					) );
+			out_detected_planes.push_back( std::make_pair( this_best_inliers.size(), this_best_model ) );
 
 			out_detected_planes.rbegin()->second.unitarize();
 
 			// Discard the selected points so they are not used again for finding subsequent planes:
-			remainingPoints.removeColumns(this_best_inliers);
+			remainingPoints.removeSamples(this_best_inliers);
 		}
 		else
 		{
@@ -195,90 +296,6 @@ EXPLICIT_INST_ransac_detect_3D_planes(long double)
 #endif
 
 
-
-/*---------------------------------------------------------------
-		Aux. functions needed by ransac_detect_2D_lines
- ---------------------------------------------------------------*/
-namespace mrpt
-{
-	namespace math
-	{
-		template <typename T>
-		void  ransac2Dline_fit(
-			const CMatrixTemplateNumeric<T> &allData,
-			const vector_size_t  &useIndices,
-			vector< CMatrixTemplateNumeric<T> > &fitModels )
-		{
-			ASSERT_(useIndices.size()==2);
-
-			TPoint2D  p1( allData(0,useIndices[0]),allData(1,useIndices[0]) );
-			TPoint2D  p2( allData(0,useIndices[1]),allData(1,useIndices[1]) );
-
-			try
-			{
-				TLine2D  line(p1,p2);
-				fitModels.resize(1);
-				CMatrixTemplateNumeric<T> &M = fitModels[0];
-
-				M.setSize(1,3);
-				for (size_t i=0;i<3;i++)
-					M(0,i)=line.coefs[i];
-			}
-			catch(exception &)
-			{
-				fitModels.clear();
-				return;
-			}
-		}
-
-
-		template <typename T>
-		void ransac2Dline_distance(
-			const CMatrixTemplateNumeric<T> &allData,
-			const vector< CMatrixTemplateNumeric<T> > & testModels,
-			const T distanceThreshold,
-			unsigned int & out_bestModelIndex,
-			vector_size_t & out_inlierIndices )
-		{
-			out_inlierIndices.clear();
-			out_bestModelIndex = 0;
-
-			if (testModels.empty()) return; // No model, no inliers.
-
-			ASSERTMSG_( testModels.size()==1, format("Expected testModels.size()=1, but it's = %u",static_cast<unsigned int>(testModels.size()) ) )
-			const CMatrixTemplateNumeric<T> &M = testModels[0];
-
-			ASSERT_( size(M,1)==1 && size(M,2)==3 )
-
-			TLine2D  line;
-			line.coefs[0] = M(0,0);
-			line.coefs[1] = M(0,1);
-			line.coefs[2] = M(0,2);
-
-			const size_t N = size(allData,2);
-			out_inlierIndices.reserve(100);
-			for (size_t i=0;i<N;i++)
-			{
-				const double d = line.distance( TPoint2D( allData.get_unsafe(0,i),allData.get_unsafe(1,i) ) );
-				if (d<distanceThreshold)
-					out_inlierIndices.push_back(i);
-			}
-		}
-
-		/** Return "true" if the selected points are a degenerate (invalid) case.
-		  */
-		template <typename T>
-		bool ransac2Dline_degenerate(
-			const CMatrixTemplateNumeric<T> &allData,
-			const mrpt::vector_size_t &useIndices )
-		{
-			MRPT_UNUSED_PARAM(allData);
-			MRPT_UNUSED_PARAM(useIndices);
-			return false;
-		}
-	} // end namespace
-} // end namespace
-
 /*---------------------------------------------------------------
 				ransac_detect_2D_lines
  ---------------------------------------------------------------*/
@@ -300,51 +317,43 @@ void mrpt::math::ransac_detect_2D_lines(
 	if (x.empty())
 		return;
 
-	// The running lists of remaining points after each plane, as a matrix:
-	CMatrixTemplateNumeric<NUMTYPE> remainingPoints( 2, x.size() );
-	remainingPoints.insertRow(0,x);
-	remainingPoints.insertRow(1,y);
+	// The running lists of remaining points after each line:
+	TLinesRansacFit<NUMTYPE> remainingPoints;
+	remainingPoints.xs.assign(&x[0],&x[0]+x.size());
+	remainingPoints.ys.assign(&y[0],&y[0]+y.size());
+
+	RANSAC_Engine< TLinesRansacFit<NUMTYPE> > ransac;
+	ransac.params.prob_good_sample = 0.99999;
 
 	// ---------------------------------------------
 	// For each line:
 	// ---------------------------------------------
-	while (size(remainingPoints,2)>=2)
+	while (remainingPoints.getSampleCount()>=2)
 	{
-		mrpt::vector_size_t				this_best_inliers;
-		CMatrixTemplateNumeric<NUMTYPE> this_best_model;
+		mrpt::vector_size_t  this_best_inliers;
+		TLine2D              this_best_model;
 
-		math::RANSAC_Template<NUMTYPE> ransac;
 		ransac.execute(
 			remainingPoints,
-			ransac2Dline_fit,
-			ransac2Dline_distance,
-			ransac2Dline_degenerate,
-			threshold,
+			static_cast<NUMTYPE>(threshold),
 			2,  // Minimum set of points
-			this_best_inliers,
 			this_best_model,
-			false, // Verbose
-			0.99999  // Prob. of good result
-			);
+			this_best_inliers );
 
-		// Is this plane good enough?
+		// Is this line good enough?
 		if (this_best_inliers.size()>=min_inliers_for_valid_line)
 		{
-			// Add this plane to the output list:
-			out_detected_lines.push_back(
-				std::make_pair<size_t,TLine2D>(
-					this_best_inliers.size(),
-					TLine2D(this_best_model(0,0), this_best_model(0,1),this_best_model(0,2) )
-					) );
+			// Add this line to the output list:
+			out_detected_lines.push_back( std::make_pair( this_best_inliers.size(), this_best_model ) );
 
 			out_detected_lines.rbegin()->second.unitarize();
 
-			// Discard the selected points so they are not used again for finding subsequent planes:
-			remainingPoints.removeColumns(this_best_inliers);
+			// Discard the selected points so they are not used again for finding subsequent lines:
+			remainingPoints.removeSamples(this_best_inliers);
 		}
 		else
 		{
-			break; // Do not search for more planes.
+			break; // Do not search for more lines.
 		}
 	}
 
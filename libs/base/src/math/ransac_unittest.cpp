@@ -0,0 +1,263 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+
+#include <mrpt/math/ransac.h>
+#include <mrpt/math/ransac_applications.h>
+#include <mrpt/math/ransac_engine.h>
+#include <mrpt/math/model_search.h>
+#include <mrpt/random.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::math;
+using namespace mrpt::random;
+using namespace std;
+
+namespace
+{
+	// 1-D "model": samples are inliers if they are close to the model value.
+	struct TValueFit
+	{
+		typedef double Real;
+		typedef double Model;
+
+		std::vector<double> data;
+		double degenerate_above; //!< Samples with a larger absolute value can't be used to fit a model
+
+		TValueFit() : degenerate_above(std::numeric_limits<double>::max()) { }
+
+		size_t getSampleCount() const { return data.size(); }
+		bool fitModel( const vector_size_t& useIndices, Model& model ) const
+		{
+			if (std::abs(data[useIndices[0]])>degenerate_above)
+				return false;
+			model = data[useIndices[0]];
+			return true;
+		}
+		Real testSample( size_t index, const Model& model ) const
+		{
+			return std::abs(data[index]-model);
+		}
+	};
+
+	// N_INLIERS samples around "value", and uniform outliers in [-100,100]:
+	void makeValueData(TValueFit &fit, const double value, const size_t N_INLIERS, const size_t N_OUTLIERS)
+	{
+		fit.data.clear();
+		for (size_t i=0;i<N_INLIERS;i++)
+			fit.data.push_back(value + randomGenerator.drawUniform(-0.01,0.01));
+		for (size_t i=0;i<N_OUTLIERS;i++)
+			fit.data.push_back(randomGenerator.drawUniform(-100,100));
+	}
+}
+
+TEST(RANSAC, EngineFindsModel)
+{
+	randomGenerator.randomize(123);
+	TValueFit fit;
+	makeValueData(fit,5.0, 100, 300);
+
+	RANSAC_Engine< TRansacModelSearchAdapter<TValueFit> > ransac;
+	double model = 0;
+	vector_size_t inliers;
+	EXPECT_TRUE( ransac.execute(TRansacModelSearchAdapter<TValueFit>(fit), 0.05, 1, model, inliers) );
+	EXPECT_NEAR(model, 5.0, 0.01);
+	EXPECT_GE(inliers.size(), 100u);
+	EXPECT_LE(inliers.size(), 103u);
+	for (size_t i=0;i<100;i++)
+		EXPECT_EQ(inliers[i],i);
+}
+
+TEST(RANSAC, EngineIsRepeatable)
+{
+	randomGenerator.randomize(1);
+	TValueFit fit;
+	makeValueData(fit,-3.0, 50, 500);
+
+	RANSAC_Engine< TRansacModelSearchAdapter<TValueFit> > ransac;
+	ransac.params.hypotheses_per_batch = 7;
+	ransac.params.score_chunk_size = 10;
+	double model1=0, model2=0;
+	vector_size_t inliers1, inliers2;
+	size_t nHyps1=0, nHyps2=0;
+
+	randomGenerator.randomize(2);
+	ransac.execute(TRansacModelSearchAdapter<TValueFit>(fit), 0.05, 1, model1, inliers1, NULL, &nHyps1);
+	randomGenerator.randomize(2);
+	ransac.execute(TRansacModelSearchAdapter<TValueFit>(fit), 0.05, 1, model2, inliers2, NULL, &nHyps2);
+
+	EXPECT_EQ(model1,model2);
+	EXPECT_EQ(nHyps1,nHyps2);
+	EXPECT_TRUE(inliers1==inliers2);
+	EXPECT_NEAR(model1, -3.0, 0.01);
+}
+
+TEST(RANSAC, EnginePROSAC)
+{
+	randomGenerator.randomize(321);
+	TValueFit fit;
+	makeValueData(fit,1.0, 20, 1000);
+
+	// Good scores for the inliers: PROSAC must find the model almost immediately
+	std::vector<double> quality(fit.data.size());
+	for (size_t i=0;i<quality.size();i++)
+		quality[i] = (i<20) ? 1.0 : randomGenerator.drawUniform(0.0,0.5);
+
+	RANSAC_Engine< TRansacModelSearchAdapter<TValueFit> > ransac;
+	ransac.params.hypotheses_per_batch = 1;
+	double model = 0;
+	vector_size_t inliers;
+	size_t nHyps = 0;
+	EXPECT_TRUE( ransac.execute(TRansacModelSearchAdapter<TValueFit>(fit), 0.05, 1, model, inliers, &quality, &nHyps) );
+	EXPECT_NEAR(model, 1.0, 0.01);
+	EXPECT_GE(inliers.size(), 20u);
+	EXPECT_LT(nHyps, ransac.params.max_iters);
+}
+
+TEST(RANSAC, EngineReportsDegenerateSamples)
+{
+	randomGenerator.randomize(7);
+	TValueFit fit;
+	makeValueData(fit,200.0, 50, 50);
+	fit.degenerate_above = 150.0; // Only the outliers can be used
+
+	RANSAC_Engine< TRansacModelSearchAdapter<TValueFit> > ransac;
+	ransac.params.max_iters = 40;
+	ransac.params.max_degenerate_trials = 1;
+	double model = 0;
+	vector_size_t inliers;
+	size_t nHyps = 0, nDegenerate = 0;
+	ransac.execute(TRansacModelSearchAdapter<TValueFit>(fit), 0.05, 1, model, inliers, NULL, &nHyps, &nDegenerate);
+	EXPECT_EQ(nHyps, 40u);
+	EXPECT_GT(nDegenerate, 5u);
+	EXPECT_LT(nDegenerate, 35u);
+
+	// No sample can be used at all:
+	fit.degenerate_above = -1.0;
+	ransac.params.max_degenerate_trials = 5;
+	EXPECT_FALSE( ransac.execute(TRansacModelSearchAdapter<TValueFit>(fit), 0.05, 1, model, inliers, NULL, &nHyps, &nDegenerate) );
+	EXPECT_EQ(nDegenerate, nHyps);
+}
+
+namespace
+{
+	// Callbacks for RANSAC_Template: 1xN data, models are 1x1 matrices.
+	void value_fit(const CMatrixDouble &allData, const vector_size_t &useIndices, vector<CMatrixDouble> &fitModels)
+	{
+		fitModels.resize(1);
+		fitModels[0].setSize(1,1);
+		fitModels[0](0,0) = allData(0,useIndices[0]);
+	}
+	void value_distance(const CMatrixDouble &allData, const vector<CMatrixDouble> &testModels, const double distanceThreshold, unsigned int &out_bestModelIndex, vector_size_t &out_inlierIndices)
+	{
+		out_bestModelIndex = 0;
+		out_inlierIndices.clear();
+		for (size_t i=0;i<size(allData,2);i++)
+			if (std::abs(allData(0,i)-testModels[0](0,0))<distanceThreshold)
+				out_inlierIndices.push_back(i);
+	}
+	bool value_degenerate(const CMatrixDouble &, const vector_size_t &) { return false; }
+}
+
+TEST(RANSAC, RANSAC_Template)
+{
+	randomGenerator.randomize(654);
+	TValueFit fit;
+	makeValueData(fit,-7.0, 300, 600);
+	CMatrixDouble data(1,fit.data.size());
+	for (size_t i=0;i<fit.data.size();i++) data(0,i)=fit.data[i];
+
+	RANSAC ransac;
+	vector_size_t inliers;
+	CMatrixDouble model;
+	EXPECT_TRUE( ransac.execute(data, value_fit, value_distance, value_degenerate, 0.05, 1, inliers, model) );
+	ASSERT_EQ(size(model,1), 1u);
+	EXPECT_NEAR(model(0,0), -7.0, 0.01);
+	EXPECT_GE(inliers.size(), 300u);
+	for (size_t i=0;i<300;i++)
+		EXPECT_EQ(inliers[i],i);
+}
+
+TEST(RANSAC, ModelSearch)
+{
+	randomGenerator.randomize(456);
+	TValueFit fit;
+	makeValueData(fit,2.0, 300, 100);
+
+	ModelSearch search;
+	double model = 0;
+	vector_size_t inliers;
+	EXPECT_TRUE( search.ransacSingleModel(fit, 1, 0.05, model, inliers) );
+	EXPECT_NEAR(model, 2.0, 0.01);
+	EXPECT_GE(inliers.size(), 300u);
+}
+
+TEST(RANSAC, detect_2D_lines)
+{
+	randomGenerator.randomize(789);
+
+	// Two lines: y=2x+1, and x=-3 ; plus outliers
+	const size_t N_LINE = 200, N_OUTLIERS = 100;
+	CVectorDouble xs(2*N_LINE+N_OUTLIERS), ys(2*N_LINE+N_OUTLIERS);
+	for (size_t i=0;i<N_LINE;i++)
+	{
+		const double t = randomGenerator.drawUniform(-10,10);
+		xs[i] = t; ys[i] = 2*t+1;
+		xs[N_LINE+i] = -3; ys[N_LINE+i] = t;
+	}
+	for (size_t i=0;i<N_OUTLIERS;i++)
+	{
+		xs[2*N_LINE+i] = randomGenerator.drawUniform(-50,50);
+		ys[2*N_LINE+i] = randomGenerator.drawUniform(-50,50);
+	}
+
+	std::vector<std::pair<size_t,TLine2D> > lines;
+	ransac_detect_2D_lines(xs,ys,lines,0.01,50);
+
+	ASSERT_EQ(lines.size(), 2u);
+	for (size_t i=0;i<lines.size();i++)
+	{
+		EXPECT_GE(lines[i].first, N_LINE-5);  // Points near the intersection may be taken by the first line
+		const TLine2D &l = lines[i].second;
+		const bool is_line1 = std::abs(l.distance(TPoint2D(0,1)))<1e-6 && std::abs(l.distance(TPoint2D(1,3)))<1e-6;
+		const bool is_line2 = std::abs(l.distance(TPoint2D(-3,0)))<1e-6 && std::abs(l.distance(TPoint2D(-3,5)))<1e-6;
+		EXPECT_TRUE(is_line1 || is_line2);
+	}
+}
+
+TEST(RANSAC, detect_3D_planes)
+{
+	randomGenerator.randomize(1000);
+
+	// Plane z=0.5x-y+2, with outliers, in single precision:
+	const size_t N_PLANE = 500, N_OUTLIERS = 200;
+	CVectorFloat xs(N_PLANE+N_OUTLIERS), ys(N_PLANE+N_OUTLIERS), zs(N_PLANE+N_OUTLIERS);
+	for (size_t i=0;i<N_PLANE;i++)
+	{
+		xs[i] = randomGenerator.drawUniform(-5,5);
+		ys[i] = randomGenerator.drawUniform(-5,5);
+		zs[i] = 0.5f*xs[i]-ys[i]+2;
+	}
+	for (size_t i=N_PLANE;i<N_PLANE+N_OUTLIERS;i++)
+	{
+		xs[i] = randomGenerator.drawUniform(-5,5);
+		ys[i] = randomGenerator.drawUniform(-5,5);
+		zs[i] = randomGenerator.drawUniform(-20,20);
+	}
+
+	std::vector<std::pair<size_t,TPlane> > planes;
+	ransac_detect_3D_planes(xs,ys,zs,planes,0.01,100);
+
+	ASSERT_EQ(planes.size(), 1u);
+	EXPECT_GE(planes[0].first, N_PLANE);
+	EXPECT_NEAR(planes[0].second.distance(TPoint3D(0,0,2)), 0, 1e-4);
+	EXPECT_NEAR(planes[0].second.distance(TPoint3D(2,0,3)), 0, 1e-4);
+	EXPECT_NEAR(planes[0].second.distance(TPoint3D(0,1,1)), 0, 1e-4);
+}
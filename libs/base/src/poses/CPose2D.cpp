@@ -15,6 +15,7 @@
 #include <mrpt/poses/CPoint3D.h>
 #include <mrpt/utils/CStream.h>
 #include <mrpt/math/wrap2pi.h>
+#include <mrpt/utils/SSE_types.h>
 #include <limits>
 
 using namespace mrpt;
@@ -213,6 +214,88 @@ void CPose2D::inverseComposePoint(const double gx,const double gy, double &lx,do
 	ly =-Ax * m_sinphi + Ay * m_cosphi;
 }
 
+namespace
+{
+	// Computes G_i = [c -s; s c]*L_i + t for the points i0..N-1. Also used for the tails of the SSE2 versions.
+	template <typename T>
+	void transformPoints2D_scalar(const double c, const double s, const double *t, size_t i0, const size_t N,
+		const T *lx, const T *ly, T *gx, T *gy)
+	{
+		const T cc=T(c), ss=T(s), tx=T(t[0]), ty=T(t[1]);
+		for (size_t i=i0;i<N;i++)
+		{
+			const T x=lx[i], y=ly[i]; // Copies, to allow in-place transformations
+			gx[i] = tx + cc*x - ss*y;
+			gy[i] = ty + ss*x + cc*y;
+		}
+	}
+
+	void transformPoints2D(const double c, const double s, const double *t, const size_t N,
+		const float *lx, const float *ly, float *gx, float *gy)
+	{
+		size_t i=0;
+#if MRPT_HAS_SSE2
+		const __m128 cc = _mm_set1_ps(static_cast<float>(c)), ss = _mm_set1_ps(static_cast<float>(s));
+		const __m128 tx = _mm_set1_ps(static_cast<float>(t[0])), ty = _mm_set1_ps(static_cast<float>(t[1]));
+		for (;i+4<=N;i+=4)
+		{
+			const __m128 x = _mm_loadu_ps(lx+i), y = _mm_loadu_ps(ly+i);
+			_mm_storeu_ps(gx+i, _mm_add_ps(tx,_mm_sub_ps(_mm_mul_ps(cc,x),_mm_mul_ps(ss,y))));
+			_mm_storeu_ps(gy+i, _mm_add_ps(ty,_mm_add_ps(_mm_mul_ps(ss,x),_mm_mul_ps(cc,y))));
+		}
+#endif
+		transformPoints2D_scalar(c,s,t,i,N,lx,ly,gx,gy);
+	}
+
+	void transformPoints2D(const double c, const double s, const double *t, const size_t N,
+		const double *lx, const double *ly, double *gx, double *gy)
+	{
+		size_t i=0;
+#if MRPT_HAS_SSE2
+		const __m128d cc = _mm_set1_pd(c), ss = _mm_set1_pd(s);
+		const __m128d tx = _mm_set1_pd(t[0]), ty = _mm_set1_pd(t[1]);
+		for (;i+2<=N;i+=2)
+		{
+			const __m128d x = _mm_loadu_pd(lx+i), y = _mm_loadu_pd(ly+i);
+			_mm_storeu_pd(gx+i, _mm_add_pd(tx,_mm_sub_pd(_mm_mul_pd(cc,x),_mm_mul_pd(ss,y))));
+			_mm_storeu_pd(gy+i, _mm_add_pd(ty,_mm_add_pd(_mm_mul_pd(ss,x),_mm_mul_pd(cc,y))));
+		}
+#endif
+		transformPoints2D_scalar(c,s,t,i,N,lx,ly,gx,gy);
+	}
+}
+
+/*---------------------------------------------------------------
+		composePoints / inverseComposePoints
+  ---------------------------------------------------------------*/
+void CPose2D::composePoints(const size_t N, const float *lx, const float *ly, float *gx, float *gy) const
+{
+	update_cached_cos_sin();
+	transformPoints2D(m_cosphi,m_sinphi,&m_coords[0],N,lx,ly,gx,gy);
+}
+void CPose2D::composePoints(const size_t N, const double *lx, const double *ly, double *gx, double *gy) const
+{
+	update_cached_cos_sin();
+	transformPoints2D(m_cosphi,m_sinphi,&m_coords[0],N,lx,ly,gx,gy);
+}
+// The inverse pose has rotation -phi and translation -R^t * t:
+void CPose2D::inverseComposePoints(const size_t N, const float *gx, const float *gy, float *lx, float *ly) const
+{
+	update_cached_cos_sin();
+	const double t_inv[2] = {
+		-( m_cosphi*m_coords[0]+m_sinphi*m_coords[1]),
+		-(-m_sinphi*m_coords[0]+m_cosphi*m_coords[1]) };
+	transformPoints2D(m_cosphi,-m_sinphi,t_inv,N,gx,gy,lx,ly);
+}
+void CPose2D::inverseComposePoints(const size_t N, const double *gx, const double *gy, double *lx, double *ly) const
+{
+	update_cached_cos_sin();
+	const double t_inv[2] = {
+		-( m_cosphi*m_coords[0]+m_sinphi*m_coords[1]),
+		-(-m_sinphi*m_coords[0]+m_cosphi*m_coords[1]) };
+	transformPoints2D(m_cosphi,-m_sinphi,t_inv,N,gx,gy,lx,ly);
+}
+
 /*---------------------------------------------------------------
 The operator u'="this"+u is the pose/point compounding operator.
  ---------------------------------------------------------------*/
@@ -21,6 +21,7 @@
 #include <mrpt/math/matrix_serialization.h>
 #include <mrpt/math/ops_matrices.h>
 #include <mrpt/utils/CStream.h>
+#include <mrpt/utils/SSE_types.h>
 #include <mrpt/math/utils_matlab.h>
 #include <iomanip>
 #include <limits>
@@ -489,18 +490,118 @@ void CPose3D::composePoint(double lx,double ly,double lz, double &gx, double &gy
 }
 
 
-// TODO: Use SSE2? OTOH, this forces mem align...
-#if MRPT_HAS_SSE2 && defined(MRPT_USE_SSE2)
-/*static inline __m128 transformSSE(const __m128* matrix, const __m128& in)
+namespace
 {
-    ASSERT_(((size_t)matrix & 15) == 0);
-    __m128 a0 = _mm_mul_ps(_mm_load_ps((float*)(matrix+0)), _mm_shuffle_ps(in,in,_MM_SHUFFLE(0,0,0,0)));
-    __m128 a1 = _mm_mul_ps(_mm_load_ps((float*)(matrix+1)), _mm_shuffle_ps(in,in,_MM_SHUFFLE(1,1,1,1)));
-    __m128 a2 = _mm_mul_ps(_mm_load_ps((float*)(matrix+2)), _mm_shuffle_ps(in,in,_MM_SHUFFLE(2,2,2,2)));
-
-    return _mm_add_ps(_mm_add_ps(a0,a1),a2);
-}*/
-#endif // SSE2
+	// Computes G_i = R*L_i + t for the points i0..N-1 (R in row-major order). Also used for the tails of the SSE2 versions.
+	template <typename T>
+	void transformPoints_scalar(const double *R, const double *t, size_t i0, const size_t N,
+		const T *lx, const T *ly, const T *lz, T *gx, T *gy, T *gz)
+	{
+		const T r00=T(R[0]), r01=T(R[1]), r02=T(R[2]);
+		const T r10=T(R[3]), r11=T(R[4]), r12=T(R[5]);
+		const T r20=T(R[6]), r21=T(R[7]), r22=T(R[8]);
+		const T tx=T(t[0]), ty=T(t[1]), tz=T(t[2]);
+		for (size_t i=i0;i<N;i++)
+		{
+			const T x=lx[i], y=ly[i], z=lz[i]; // Copies, to allow in-place transformations
+			gx[i] = r00*x+r01*y+r02*z+tx;
+			gy[i] = r10*x+r11*y+r12*z+ty;
+			gz[i] = r20*x+r21*y+r22*z+tz;
+		}
+	}
+
+	void transformPoints(const double *R, const double *t, const size_t N,
+		const float *lx, const float *ly, const float *lz, float *gx, float *gy, float *gz)
+	{
+		size_t i=0;
+#if MRPT_HAS_SSE2
+		// 4 points at once. Unaligned loads, since the arrays may start anywhere:
+		__m128 r[9];
+		for (int k=0;k<9;k++) r[k] = _mm_set1_ps(static_cast<float>(R[k]));
+		const __m128 tx = _mm_set1_ps(static_cast<float>(t[0]));
+		const __m128 ty = _mm_set1_ps(static_cast<float>(t[1]));
+		const __m128 tz = _mm_set1_ps(static_cast<float>(t[2]));
+		for (;i+4<=N;i+=4)
+		{
+			const __m128 x = _mm_loadu_ps(lx+i), y = _mm_loadu_ps(ly+i), z = _mm_loadu_ps(lz+i);
+			_mm_storeu_ps(gx+i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(r[0],x),_mm_mul_ps(r[1],y)),_mm_add_ps(_mm_mul_ps(r[2],z),tx)));
+			_mm_storeu_ps(gy+i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(r[3],x),_mm_mul_ps(r[4],y)),_mm_add_ps(_mm_mul_ps(r[5],z),ty)));
+			_mm_storeu_ps(gz+i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(r[6],x),_mm_mul_ps(r[7],y)),_mm_add_ps(_mm_mul_ps(r[8],z),tz)));
+		}
+#endif
+		transformPoints_scalar(R,t,i,N,lx,ly,lz,gx,gy,gz);
+	}
+
+	void transformPoints(const double *R, const double *t, const size_t N,
+		const double *lx, const double *ly, const double *lz, double *gx, double *gy, double *gz)
+	{
+		size_t i=0;
+#if MRPT_HAS_SSE2
+		// 2 points at once:
+		__m128d r[9];
+		for (int k=0;k<9;k++) r[k] = _mm_set1_pd(R[k]);
+		const __m128d tx = _mm_set1_pd(t[0]), ty = _mm_set1_pd(t[1]), tz = _mm_set1_pd(t[2]);
+		for (;i+2<=N;i+=2)
+		{
+			const __m128d x = _mm_loadu_pd(lx+i), y = _mm_loadu_pd(ly+i), z = _mm_loadu_pd(lz+i);
+			_mm_storeu_pd(gx+i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(r[0],x),_mm_mul_pd(r[1],y)),_mm_add_pd(_mm_mul_pd(r[2],z),tx)));
+			_mm_storeu_pd(gy+i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(r[3],x),_mm_mul_pd(r[4],y)),_mm_add_pd(_mm_mul_pd(r[5],z),ty)));
+			_mm_storeu_pd(gz+i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(r[6],x),_mm_mul_pd(r[7],y)),_mm_add_pd(_mm_mul_pd(r[8],z),tz)));
+		}
+#endif
+		transformPoints_scalar(R,t,i,N,lx,ly,lz,gx,gy,gz);
+	}
+
+	// Rotation (row-major) and translation of the pose, or of its inverse:
+	void getRotTrans(const CMatrixDouble33 &ROT, const CArrayDouble<3> &coords, const bool inverse, double *R, double *t)
+	{
+		if (!inverse)
+		{
+			for (int r=0;r<3;r++)
+			{
+				for (int c=0;c<3;c++) R[3*r+c] = ROT.get_unsafe(r,c);
+				t[r] = coords[r];
+			}
+		}
+		else
+		{
+			// R^t, -R^t * t
+			for (int r=0;r<3;r++)
+			{
+				for (int c=0;c<3;c++) R[3*r+c] = ROT.get_unsafe(c,r);
+				t[r] = -(ROT.get_unsafe(0,r)*coords[0]+ROT.get_unsafe(1,r)*coords[1]+ROT.get_unsafe(2,r)*coords[2]);
+			}
+		}
+	}
+}
+
+/*---------------------------------------------------------------
+		composePoints / inverseComposePoints
+---------------------------------------------------------------*/
+void CPose3D::composePoints(const size_t N, const float *lx, const float *ly, const float *lz, float *gx, float *gy, float *gz) const
+{
+	double R[9],t[3];
+	getRotTrans(m_ROT,m_coords,false,R,t);
+	transformPoints(R,t,N,lx,ly,lz,gx,gy,gz);
+}
+void CPose3D::composePoints(const size_t N, const double *lx, const double *ly, const double *lz, double *gx, double *gy, double *gz) const
+{
+	double R[9],t[3];
+	getRotTrans(m_ROT,m_coords,false,R,t);
+	transformPoints(R,t,N,lx,ly,lz,gx,gy,gz);
+}
+void CPose3D::inverseComposePoints(const size_t N, const float *gx, const float *gy, const float *gz, float *lx, float *ly, float *lz) const
+{
+	double R[9],t[3];
+	getRotTrans(m_ROT,m_coords,true,R,t);
+	transformPoints(R,t,N,gx,gy,gz,lx,ly,lz);
+}
+void CPose3D::inverseComposePoints(const size_t N, const double *gx, const double *gy, const double *gz, double *lx, double *ly, double *lz) const
+{
+	double R[9],t[3];
+	getRotTrans(m_ROT,m_coords,true,R,t);
+	transformPoints(R,t,N,gx,gy,gz,lx,ly,lz);
+}
 
 /*---------------------------------------------------------------
 		getAsVector
@@ -552,17 +552,17 @@ void CPose3DInterpolator::filter( unsigned int component, unsigned int samples )
 		for( unsigned int i = 0; it2 != it3; ++it2, ++i )
 		{
 		    particles.m_particles[i].log_w = 0;
-		    particles.m_particles[i].d->setFromValues(
+		    particles.m_particles[i].d.setFromValues(
                         it1->second.x(), it1->second.y(), it1->second.z(),
                         it1->second.yaw(), it1->second.pitch(), it1->second.roll() );
 			switch( component )
 			{
-				case 0:	particles.m_particles[i].d->x(it2->second.x());		break;
-				case 1:	particles.m_particles[i].d->y(it2->second.y());		break;
-				case 2:	particles.m_particles[i].d->z(it2->second.z());		break;
-				case 3:	particles.m_particles[i].d->setYawPitchRoll(it2->second.yaw(),it1->second.pitch(),it1->second.roll()); break;
-				case 4:	particles.m_particles[i].d->setYawPitchRoll(it1->second.yaw(),it2->second.pitch(),it1->second.roll()); 	break;
-				case 5:	particles.m_particles[i].d->setYawPitchRoll(it1->second.yaw(),it1->second.pitch(),it2->second.roll()); 	break;
+				case 0:	particles.m_particles[i].d.x(it2->second.x());		break;
+				case 1:	particles.m_particles[i].d.y(it2->second.y());		break;
+				case 2:	particles.m_particles[i].d.z(it2->second.z());		break;
+				case 3:	particles.m_particles[i].d.setYawPitchRoll(it2->second.yaw(),it1->second.pitch(),it1->second.roll()); break;
+				case 4:	particles.m_particles[i].d.setYawPitchRoll(it1->second.yaw(),it2->second.pitch(),it1->second.roll()); 	break;
+				case 5:	particles.m_particles[i].d.setYawPitchRoll(it1->second.yaw(),it1->second.pitch(),it2->second.roll()); 	break;
 			} // end switch
 		} // end for it2
         particles.getMean( auxPose );
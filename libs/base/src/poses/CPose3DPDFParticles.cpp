@@ -30,12 +30,6 @@ CPose3DPDFParticles::CPose3DPDFParticles( size_t M )
 {
 	m_particles.resize(M);
 
-	for (CPose3DPDFParticles::CParticleList::iterator it=m_particles.begin();it!=m_particles.end();++it)
-	{
-		it->log_w	= 0;
-		it->d		= new CPose3D();
-	}
-
 	static CPose3D	nullPose(0,0,0);
 	resetDeterministic( nullPose );
 }
@@ -47,9 +41,6 @@ void  CPose3DPDFParticles::copyFrom(const CPose3DPDF &o)
 {
 	MRPT_START
 
-	CPose3DPDFParticles::CParticleList::const_iterator	itSrc;
-	CPose3DPDFParticles::CParticleList::iterator		itDest;
-
 	if (this == &o) return;		// It may be used sometimes
 
 	if (o.GetRuntimeClass()==CLASS_ID(CPose3DPDFParticles))
@@ -57,31 +48,7 @@ void  CPose3DPDFParticles::copyFrom(const CPose3DPDF &o)
 		const CPose3DPDFParticles	*pdf = static_cast<const CPose3DPDFParticles*>( &o );
 
 		// Both are m_particles:
-		if (m_particles.size()==pdf->m_particles.size())
-		{
-			for ( itSrc=pdf->m_particles.begin(), itDest = m_particles.begin();
-				   itSrc!=pdf->m_particles.end();
-			      itSrc++, itDest++ )
-			{
-				(*itDest->d) = (*itSrc->d);
-				itDest->log_w = itSrc->log_w;
-			}
-		}
-		else
-		{
-			for ( itDest = m_particles.begin();itDest!=m_particles.end();++itDest )
-				delete itDest->d;
-
-			m_particles.resize( pdf->m_particles.size() );
-
-			for ( itSrc=pdf->m_particles.begin(), itDest = m_particles.begin();
-				   itSrc!=pdf->m_particles.end();
-			      ++itSrc, ++itDest )
-			{
-				itDest->d = new CPose3D( *itSrc->d );
-				itDest->log_w = itSrc->log_w;
-			}
-		}
+		m_particles = pdf->m_particles;
 	}
 	else
 	if (o.GetRuntimeClass()==CLASS_ID(CPose3DPDFGaussian))
@@ -119,7 +86,7 @@ void CPose3DPDFParticles::getMean(CPose3D &p) const
 	for (CPose3DPDFParticles::CParticleList::const_iterator it=m_particles.begin();it!=m_particles.end();++it)
 	{
 		const double w  = exp(it->log_w);
-		se_averager.append( *it->d,w );
+		se_averager.append( it->d,w );
 	}
 	se_averager.get_average(p);
 
@@ -171,13 +138,13 @@ void CPose3DPDFParticles::getCovarianceAndMean(CMatrixDouble66 &cov,CPose3D &mea
 		double w = exp( it->log_w ) / W;
 
 		// Manage 1 PI range:
-		double	err_yaw   = wrapToPi( fabs(it->d->yaw() - mean_yaw) );
-		double	err_pitch = wrapToPi( fabs(it->d->pitch() - mean_pitch) );
-		double	err_roll  = wrapToPi( fabs(it->d->roll() - mean_roll) );
+		double	err_yaw   = wrapToPi( fabs(it->d.yaw() - mean_yaw) );
+		double	err_pitch = wrapToPi( fabs(it->d.pitch() - mean_pitch) );
+		double	err_roll  = wrapToPi( fabs(it->d.roll() - mean_roll) );
 
-		double	err_x	  = it->d->x() - mean.x();
-		double	err_y	  = it->d->y() - mean.y();
-		double	err_z	  = it->d->z() - mean.z();
+		double	err_x	  = it->d.x() - mean.x();
+		double	err_y	  = it->d.y() - mean.y();
+		double	err_z	  = it->d.z() - mean.z();
 
 		vars[0] += square(err_x)*w;
 		vars[1] += square(err_y)*w;
@@ -287,7 +254,7 @@ void  CPose3DPDFParticles::saveToTextFile(const std::string &file) const
  ---------------------------------------------------------------*/
 CPose3D	 CPose3DPDFParticles::getParticlePose(int i) const
 {
-	return *m_particles[i].d;
+	return m_particles[i].d;
 }
 
 /*---------------------------------------------------------------
@@ -296,7 +263,7 @@ CPose3D	 CPose3DPDFParticles::getParticlePose(int i) const
 void  CPose3DPDFParticles::changeCoordinatesReference( const CPose3D &newReferenceBase )
 {
 	for (CParticleList::iterator it=m_particles.begin();it!=m_particles.end();++it)
-		it->d->composeFrom(newReferenceBase, *it->d);
+		it->d.composeFrom(newReferenceBase, it->d);
 }
 
 /*---------------------------------------------------------------
@@ -353,7 +320,7 @@ void CPose3DPDFParticles::inverse(CPose3DPDF  &o) const
 	CPose3D   zero(0,0,0);
 
 	for (it=out->m_particles.begin();it!=out->m_particles.end();++it)
-		*it->d = zero - *it->d;
+		it->d = zero - it->d;
 
 	MRPT_END
 }
@@ -375,7 +342,7 @@ CPose3D	 CPose3DPDFParticles::getMostLikelyParticle() const
 		}
 	}
 
-	return *itMax->d;
+	return itMax->d;
 }
 
 /*---------------------------------------------------------------
@@ -401,13 +368,11 @@ void  CPose3DPDFParticles::resetDeterministic( const CPose3D &location,
 	{
 		clearParticles();
 		m_particles.resize(particlesCount);
-		for (it=m_particles.begin();it!=m_particles.end();++it)
-			it->d = new CPose3D();
 	}
 
 	for (it=m_particles.begin();it!=m_particles.end();++it)
 	{
-		*it->d	= location;
+		it->d	= location;
 		it->log_w	= 0;
 	}
 }
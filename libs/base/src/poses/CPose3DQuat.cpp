@@ -284,6 +284,27 @@ void CPose3DQuat::inverseComposePoint(const double gx,const double gy,const doub
 	m_quat.inverseRotatePoint(gx-m_coords[0],gy-m_coords[1],gz-m_coords[2],  lx,ly,lz);
 }
 
+/*---------------------------------------------------------------
+	composePoints / inverseComposePoints
+  ---------------------------------------------------------------*/
+// The rotation matrix is built once, then the vectorized kernels of CPose3D do the actual work:
+void CPose3DQuat::composePoints(const size_t N, const float *lx, const float *ly, const float *lz, float *gx, float *gy, float *gz) const
+{
+	CPose3D(*this).composePoints(N,lx,ly,lz,gx,gy,gz);
+}
+void CPose3DQuat::composePoints(const size_t N, const double *lx, const double *ly, const double *lz, double *gx, double *gy, double *gz) const
+{
+	CPose3D(*this).composePoints(N,lx,ly,lz,gx,gy,gz);
+}
+void CPose3DQuat::inverseComposePoints(const size_t N, const float *gx, const float *gy, const float *gz, float *lx, float *ly, float *lz) const
+{
+	CPose3D(*this).inverseComposePoints(N,gx,gy,gz,lx,ly,lz);
+}
+void CPose3DQuat::inverseComposePoints(const size_t N, const double *gx, const double *gy, const double *gz, double *lx, double *ly, double *lz) const
+{
+	CPose3D(*this).inverseComposePoints(N,gx,gy,gz,lx,ly,lz);
+}
+
 /*---------------------------------------------------------------
 	*=
   ---------------------------------------------------------------*/
@@ -8,6 +8,7 @@
    +---------------------------------------------------------------------------+ */
 
 #include <mrpt/poses/CPose3D.h>
+#include <mrpt/poses/CPose2D.h>
 #include <mrpt/math/jacobians.h>
 #include <gtest/gtest.h>
 
@@ -697,6 +698,62 @@ TEST_F(Pose3DTests,ComposeAndInvComposeWithPoint)
 	}
 }
 
+TEST_F(Pose3DTests,ComposeAndInvComposePointsBatch)
+{
+	const size_t N = 11; // Not a multiple of the SSE2 packet sizes, to check the tails too
+	vector<double> lx(N),ly(N),lz(N), gx(N),gy(N),gz(N);
+	vector<float> lxf(N),lyf(N),lzf(N);
+	for (size_t k=0;k<N;k++)
+	{
+		lx[k] = 0.5*k-2.0;  ly[k] = 3.0-0.3*k;  lz[k] = 0.1*k*k;
+		lxf[k] = lx[k]; lyf[k] = ly[k]; lzf[k] = lz[k];
+	}
+
+	for (size_t i=0;i<num_ptc;i++)
+	{
+		const CPose3D p(ptc[i][0],ptc[i][1],ptc[i][2], DEG2RAD(ptc[i][3]),DEG2RAD(ptc[i][4]),DEG2RAD(ptc[i][5]));
+
+		p.composePoints(N, &lx[0],&ly[0],&lz[0], &gx[0],&gy[0],&gz[0]);
+		vector<float> xf=lxf, yf=lyf, zf=lzf;
+		p.composePoints(N, &xf[0],&yf[0],&zf[0], &xf[0],&yf[0],&zf[0]); // in-place
+		for (size_t k=0;k<N;k++)
+		{
+			double x,y,z;
+			p.composePoint(lx[k],ly[k],lz[k], x,y,z);
+			EXPECT_NEAR(x,gx[k],1e-9); EXPECT_NEAR(y,gy[k],1e-9); EXPECT_NEAR(z,gz[k],1e-9);
+			EXPECT_NEAR(x,xf[k],1e-4); EXPECT_NEAR(y,yf[k],1e-4); EXPECT_NEAR(z,zf[k],1e-4);
+		}
+
+		// And back:
+		p.inverseComposePoints(N, &gx[0],&gy[0],&gz[0], &gx[0],&gy[0],&gz[0]);
+		p.inverseComposePoints(N, &xf[0],&yf[0],&zf[0], &xf[0],&yf[0],&zf[0]);
+		for (size_t k=0;k<N;k++)
+		{
+			EXPECT_NEAR(lx[k],gx[k],1e-9); EXPECT_NEAR(ly[k],gy[k],1e-9); EXPECT_NEAR(lz[k],gz[k],1e-9);
+			EXPECT_NEAR(lx[k],xf[k],1e-4); EXPECT_NEAR(ly[k],yf[k],1e-4); EXPECT_NEAR(lz[k],zf[k],1e-4);
+		}
+
+		// 2D poses:
+		const CPose2D p2(ptc[i][0],ptc[i][1],DEG2RAD(ptc[i][3]));
+		p2.composePoints(N, &lxf[0],&lyf[0], &xf[0],&yf[0]);
+		p2.composePoints(N, &lx[0],&ly[0], &gx[0],&gy[0]);
+		for (size_t k=0;k<N;k++)
+		{
+			double x,y;
+			p2.composePoint(lx[k],ly[k], x,y);
+			EXPECT_NEAR(x,gx[k],1e-9); EXPECT_NEAR(y,gy[k],1e-9);
+			EXPECT_NEAR(x,xf[k],1e-4); EXPECT_NEAR(y,yf[k],1e-4);
+		}
+		p2.inverseComposePoints(N, &gx[0],&gy[0], &gx[0],&gy[0]);
+		p2.inverseComposePoints(N, &xf[0],&yf[0], &xf[0],&yf[0]);
+		for (size_t k=0;k<N;k++)
+		{
+			EXPECT_NEAR(lx[k],gx[k],1e-9); EXPECT_NEAR(ly[k],gy[k],1e-9);
+			EXPECT_NEAR(lx[k],xf[k],1e-4); EXPECT_NEAR(ly[k],yf[k],1e-4);
+		}
+	}
+}
+
 TEST_F(Pose3DTests,ComposePointJacob)
 {
 	for (size_t i=0;i<num_ptc;i++)
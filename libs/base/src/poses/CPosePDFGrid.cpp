@@ -98,7 +98,7 @@ void CPosePDFGrid::getCovarianceAndMean(CMatrixDouble33 &cov, CPose2D &p) const
 			for (size_t x=0;x<m_sizeX;x++)
 			{
 				auxParts.m_particles[idx].log_w = log( *getByIndex(x,y,phiInd) );
-				*auxParts.m_particles[idx].d = CPose2D( idx2x(x),idx2y(y), idx2phi(phiInd) );
+				auxParts.m_particles[idx].d = CPose2D( idx2x(x),idx2y(y), idx2phi(phiInd) );
 			}
 	}
 	auxParts.getCovarianceAndMean(cov,p);
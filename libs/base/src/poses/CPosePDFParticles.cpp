@@ -37,9 +37,6 @@ CPosePDFParticles::CPosePDFParticles( size_t M )
 {
 	m_particles.resize(M);
 
-	for (CParticleList::iterator it=m_particles.begin();it!=m_particles.end();++it)
-		it->d = new CPose2D();
-
 	static CPose2D	nullPose(0,0,0);
 	resetDeterministic( nullPose );
 }
@@ -52,7 +49,6 @@ void  CPosePDFParticles::copyFrom(const CPosePDF &o)
 	MRPT_START
 
 	CParticleList::iterator			itDest;
-	CParticleList::const_iterator	itSrc;
 
 	if (this == &o) return;		// It may be used sometimes
 
@@ -61,31 +57,7 @@ void  CPosePDFParticles::copyFrom(const CPosePDF &o)
 		const CPosePDFParticles	*pdf = static_cast<const CPosePDFParticles*>( &o );
 
 		// Both are m_particles:
-		if (m_particles.size()==pdf->m_particles.size())
-		{
-			for ( itSrc=pdf->m_particles.begin(), itDest = m_particles.begin();
-				   itSrc!=pdf->m_particles.end();
-			      ++itSrc, ++itDest )
-			{
-				(*itDest->d) = (*itSrc->d);
-				itDest->log_w = itSrc->log_w;
-			}
-		}
-		else
-		{
-			for ( itDest = m_particles.begin();itDest!=m_particles.end();++itDest )
-				delete itDest->d;
-
-			m_particles.resize( pdf->m_particles.size() );
-
-			for ( itSrc=pdf->m_particles.begin(), itDest = m_particles.begin();
-				   itSrc!=pdf->m_particles.end();
-			      ++itSrc, ++itDest )
-			{
-				itDest->d = new CPose2D( *itSrc->d );
-				itDest->log_w = itSrc->log_w;
-			}
-		}
+		m_particles = pdf->m_particles;
 	}
 	else
 	if (o.GetRuntimeClass()==CLASS_ID(CPosePDFGaussian))
@@ -103,10 +75,10 @@ void  CPosePDFParticles::copyFrom(const CPosePDF &o)
 		for ( itDest = m_particles.begin(),partsIt=parts.begin();itDest!=m_particles.end();++itDest,++partsIt )
 		{
 			itDest->log_w = 0;
-            itDest->d = new CPose2D( ( pdf->mean.x() + (*partsIt)[0] ),
-									 ( pdf->mean.y() + (*partsIt)[1] ),
-                                     ( pdf->mean.phi() + (*partsIt)[2] ) );
-			itDest->d->normalizePhi();
+            itDest->d = CPose2D( ( pdf->mean.x() + (*partsIt)[0] ),
+								 ( pdf->mean.y() + (*partsIt)[1] ),
+                                 ( pdf->mean.phi() + (*partsIt)[2] ) );
+			itDest->d.normalizePhi();
 		}
 
 	}
@@ -144,7 +116,7 @@ void CPosePDFParticles::getMean(CPose2D &est_) const
 		mrpt::poses::SE_average<2> se_averager;
 		for (size_t i=0;i<n;i++)
 		{
-			const CPose2D &p  = *m_particles[i].d;
+			const CPose2D &p  = m_particles[i].d;
 			double w  = exp(m_particles[i].log_w);
 			se_averager.append(p,w);
 		}
@@ -180,9 +152,9 @@ void CPosePDFParticles::getCovarianceAndMean(CMatrixDouble33 &cov, CPose2D &mean
 		double w = exp( m_particles[i].log_w ) / lin_w_sum;
 
 		// Manage 1 PI range:
-		double	err_x   = m_particles[i].d->x() - mean.x();
-		double	err_y   = m_particles[i].d->y() - mean.y();
-		double	err_phi = math::wrapToPi( fabs(m_particles[i].d->phi() - mean_phi) );
+		double	err_x   = m_particles[i].d.x() - mean.x();
+		double	err_y   = m_particles[i].d.y() - mean.y();
+		double	err_phi = math::wrapToPi( fabs(m_particles[i].d.phi() - mean_phi) );
 
 		var_x+= square(err_x)*w;
 		var_y+= square(err_y)*w;
@@ -255,13 +227,11 @@ void  CPosePDFParticles::resetDeterministic( const CPose2D &location,
 	{
 		clear();
 		m_particles.resize(particlesCount);
-		for (it=m_particles.begin();it!=m_particles.end();++it)
-			it->d = new CPose2D();
 	}
 
 	for (it=m_particles.begin();it!=m_particles.end();++it)
 	{
-		*it->d	= location;
+		it->d	= location;
 		it->log_w	= 0;
 	}
 }
@@ -284,16 +254,14 @@ void  CPosePDFParticles::resetUniform(
 	{
 		clear();
 		m_particles.resize(particlesCount);
-		for (int i=0;i<particlesCount;i++)
-			m_particles[i].d = new CPose2D();
 	}
 
 	size_t		i,M = m_particles.size();
 	for (i=0;i<M;i++)
 	{
-		m_particles[i].d->x( randomGenerator.drawUniform( x_min, x_max ) );
-		m_particles[i].d->y( randomGenerator.drawUniform( y_min, y_max ) );
-		m_particles[i].d->phi( randomGenerator.drawUniform( phi_min, phi_max ) );
+		m_particles[i].d.x( randomGenerator.drawUniform( x_min, x_max ) );
+		m_particles[i].d.y( randomGenerator.drawUniform( y_min, y_max ) );
+		m_particles[i].d.phi( randomGenerator.drawUniform( phi_min, phi_max ) );
 		m_particles[i].log_w=0;
 	}
 
@@ -321,10 +289,9 @@ void  CPosePDFParticles::resetAroundSetOfPoses(
 		const mrpt::math::TPose2D & p = list_poses[nSpot];
 		for (size_t k=0;k<num_particles_per_pose;k++,i++)
 		{
-			m_particles[i].d = new CPose2D();
-			m_particles[i].d->x( randomGenerator.drawUniform( p.x - spread_x*0.5, p.x + spread_x*0.5 ) );
-			m_particles[i].d->y( randomGenerator.drawUniform( p.y - spread_y*0.5, p.y + spread_y*0.5 ) );
-			m_particles[i].d->phi( randomGenerator.drawUniform( p.phi - spread_phi_rad*0.5, p.phi + spread_phi_rad*0.5 ) );
+			m_particles[i].d.x( randomGenerator.drawUniform( p.x - spread_x*0.5, p.x + spread_x*0.5 ) );
+			m_particles[i].d.y( randomGenerator.drawUniform( p.y - spread_y*0.5, p.y + spread_y*0.5 ) );
+			m_particles[i].d.phi( randomGenerator.drawUniform( p.phi - spread_phi_rad*0.5, p.phi + spread_phi_rad*0.5 ) );
 			m_particles[i].log_w=0;
 		}
 	}
@@ -346,9 +313,9 @@ void  CPosePDFParticles::saveToTextFile(const std::string &file) const
 
 	for (unsigned int i=0;i<m_particles.size();i++)
 		os::fprintf(f,"%f %f %f %e\n",
-				m_particles[i].d->x(),
-				m_particles[i].d->y(),
-				m_particles[i].d->phi(),
+				m_particles[i].d.x(),
+				m_particles[i].d.y(),
+				m_particles[i].d.phi(),
 				m_particles[i].log_w );
 
 	os::fclose(f);
@@ -359,7 +326,7 @@ void  CPosePDFParticles::saveToTextFile(const std::string &file) const
  ---------------------------------------------------------------*/
 CPose2D	 CPosePDFParticles::getParticlePose(size_t i) const
 {
-	return *m_particles[i].d;
+	return m_particles[i].d;
 }
 
 /*---------------------------------------------------------------
@@ -370,7 +337,7 @@ void  CPosePDFParticles::changeCoordinatesReference(const CPose3D &newReferenceB
 	const CPose2D newReferenceBase = CPose2D(newReferenceBase_);
 
 	for (CParticleList::iterator it=m_particles.begin();it!=m_particles.end();++it)
-		it->d->composeFrom(newReferenceBase, *it->d);
+		it->d.composeFrom(newReferenceBase, it->d);
 }
 
 /*---------------------------------------------------------------
@@ -386,13 +353,13 @@ void  CPosePDFParticles::drawSingleSample( CPose2D &outPart ) const
 		cum+= exp(it->log_w);
 		if ( uni<= cum )
 		{
-			outPart= (*it->d);
+			outPart= it->d;
 			return;
 		}
 	}
 
 	// Might not come here normally:
-	outPart = *(m_particles.rbegin())->d;
+	outPart = m_particles.rbegin()->d;
 }
 
 /*---------------------------------------------------------------
@@ -401,7 +368,7 @@ void  CPosePDFParticles::drawSingleSample( CPose2D &outPart ) const
 void  CPosePDFParticles::operator += ( const CPose2D &Ap)
 {
 	for (CParticleList::iterator it=m_particles.begin();it!=m_particles.end();++it)
-		it->d->composeFrom(*it->d, Ap);
+		it->d.composeFrom(it->d, Ap);
 }
 
 /*---------------------------------------------------------------
@@ -411,10 +378,7 @@ void  CPosePDFParticles::append( CPosePDFParticles &o )
 {
 	for (unsigned int i=0;i<o.m_particles.size();i++)
 	{
-		CParticleData		part;
-		part.d = new CPose2D( *o.m_particles[i].d );
-		part.log_w = o.m_particles[i].log_w;
-		m_particles.push_back( part );
+		m_particles.push_back( o.m_particles[i] );
 	}
 
 	normalizeWeights();
@@ -434,7 +398,7 @@ void	 CPosePDFParticles::inverse(CPosePDF  &o) const
 	static CPose2D		nullPose(0,0,0);
 
 	for (unsigned int i=0;i<out->m_particles.size();i++)
-		(*out->m_particles[i].d) = nullPose - (*out->m_particles[i].d);
+		out->m_particles[i].d = nullPose - out->m_particles[i].d;
 
 	MRPT_END
 }
@@ -457,7 +421,7 @@ CPose2D	 CPosePDFParticles::getMostLikelyParticle() const
 		}
 	}
 
-	return *itMax->d;
+	return itMax->d;
 }
 
 /*---------------------------------------------------------------
@@ -484,10 +448,10 @@ double  CPosePDFParticles::evaluatePDF_parzen(
 
 	for (CParticleList::const_iterator	it=m_particles.begin();it!=m_particles.end();++it)
 	{
-		double difPhi = math::wrapToPi( phi - it->d->phi() );
+		double difPhi = math::wrapToPi( phi - it->d.phi() );
 
 		ret += exp(it->log_w) *
-			   math::normalPDF( it->d->distance2DTo(x,y), 0, stdXY ) *
+			   math::normalPDF( it->d.distance2DTo(x,y), 0, stdXY ) *
 			   math::normalPDF( fabs( difPhi ), 0, stdPhi );
 	}
 
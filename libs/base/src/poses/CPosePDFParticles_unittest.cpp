@@ -0,0 +1,153 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/poses/CPosePDFParticles.h>
+#include <mrpt/poses/CPose3DPDFParticles.h>
+#include <mrpt/poses/CPointPDFParticles.h>
+#include <mrpt/bayes/CParticleFilter.h>
+#include <mrpt/utils/CMemoryStream.h>
+#include <mrpt/random.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::bayes;
+using namespace mrpt::poses;
+using namespace mrpt::utils;
+using namespace std;
+
+// Particle i has the pose (i,0,0): resampling must only keep copies of the drawn particles.
+template <class PDF>
+void run_test_particles_resampling(PDF &pdf, const size_t N)
+{
+	pdf.resetDeterministic(typename PDF::CParticleDataContent(), N);
+	for (size_t i=0;i<N;i++)
+	{
+		pdf.m_particles[i].dataPtr()->x( i );
+		pdf.m_particles[i].log_w = (i%3)==0 ? 0 : -100;
+	}
+
+	// Twice, so the reused buffers are also exercised:
+	for (int rep=0;rep<2;rep++)
+	{
+		CParticleFilter::TParticleFilterOptions opts;
+		opts.resamplingMethod = CParticleFilter::prSystematic;
+		pdf.performResampling(opts);
+
+		ASSERT_EQ(pdf.size(), N);
+		double last_x = -1;
+		for (size_t i=0;i<N;i++)
+		{
+			const double x = pdf.m_particles[i].dataPtr()->x();
+			EXPECT_EQ(0, int(x)%3);
+			EXPECT_LE(last_x, x); // The output is sorted by the index of the source particle
+			EXPECT_EQ(0, pdf.m_particles[i].log_w);
+			last_x = x;
+		}
+	}
+}
+
+TEST(CPosePDFParticles, resampling)
+{
+	CPosePDFParticles pdf;
+	run_test_particles_resampling(pdf, 300);
+}
+
+TEST(CPose3DPDFParticles, resampling)
+{
+	CPose3DPDFParticles pdf;
+	run_test_particles_resampling(pdf, 300);
+}
+
+// All the methods must return sorted indexes, only of particles with a non-negligible weight,
+// and honor out_particle_count.
+TEST(CParticleFilterCapable, computeResampling)
+{
+	const size_t M = 1000;
+	std::vector<double> logW(M);
+	for (size_t i=0;i<M;i++)
+		logW[i] = (i%4)==0 ? mrpt::random::randomGenerator.drawUniform(-1,0) : -1000;
+
+	const CParticleFilter::TParticleResamplingAlgorithm methods[] = {
+		CParticleFilter::prMultinomial, CParticleFilter::prResidual,
+		CParticleFilter::prStratified, CParticleFilter::prSystematic };
+	const size_t out_counts[] = { 0, 1, 300, 5000 };
+
+	for (size_t m=0;m<sizeof(methods)/sizeof(methods[0]);m++)
+	{
+		for (size_t k=0;k<sizeof(out_counts)/sizeof(out_counts[0]);k++)
+		{
+			std::vector<size_t> idxs;
+			CParticleFilterCapable::computeResampling(methods[m],logW,idxs,out_counts[k]);
+			ASSERT_EQ(idxs.size(), out_counts[k] ? out_counts[k] : M) << "method=" << methods[m];
+			for (size_t i=0;i<idxs.size();i++)
+			{
+				ASSERT_LT(idxs[i], M);
+				EXPECT_EQ(0u, idxs[i]%4) << "method=" << methods[m];
+				if (i>0)
+				{
+					EXPECT_LE(idxs[i-1], idxs[i]) << "method=" << methods[m];
+				}
+			}
+		}
+	}
+}
+
+TEST(CPosePDFParticles, copyAndSerialization)
+{
+	CPosePDFParticles pdf(100);
+	for (size_t i=0;i<pdf.size();i++)
+	{
+		pdf.m_particles[i].d = CPose2D(i, -1.0*i, 0.01*i);
+		pdf.m_particles[i].log_w = -0.1*i;
+	}
+
+	CPosePDFParticles pdf_copy(pdf);
+	CPosePDFParticles pdf_copyFrom;
+	pdf_copyFrom.copyFrom(pdf);
+
+	CMemoryStream buf;
+	buf << pdf;
+	buf.Seek(0);
+	CPosePDFParticles pdf_read;
+	buf >> pdf_read;
+
+	const CPosePDFParticles *pdfs[] = { &pdf_copy, &pdf_copyFrom, &pdf_read };
+	for (size_t k=0;k<sizeof(pdfs)/sizeof(pdfs[0]);k++)
+	{
+		ASSERT_EQ(pdfs[k]->size(), pdf.size());
+		for (size_t i=0;i<pdf.size();i++)
+		{
+			EXPECT_EQ(pdf.m_particles[i].d, pdfs[k]->m_particles[i].d);
+			EXPECT_EQ(pdf.m_particles[i].log_w, pdfs[k]->m_particles[i].log_w);
+		}
+	}
+
+	// Modifying the copy must not modify the original:
+	pdf_copy.m_particles[0].d.x(1000);
+	EXPECT_EQ(0, pdf.m_particles[0].d.x());
+}
+
+TEST(CPointPDFParticles, resamplingInHeapStorage)
+{
+	const size_t N = 100;
+	CPointPDFParticles pdf(N);
+	for (size_t i=0;i<N;i++)
+	{
+		pdf.m_particles[i].d->x = i;
+		pdf.m_particles[i].log_w = (i<N/2) ? 0 : -100;
+	}
+
+	CParticleFilter::TParticleFilterOptions opts;
+	opts.resamplingMethod = CParticleFilter::prSystematic;
+	pdf.performResampling(opts);
+
+	ASSERT_EQ(pdf.size(), N);
+	for (size_t i=0;i<N;i++)
+		EXPECT_LT(pdf.m_particles[i].d->x, N/2);
+}
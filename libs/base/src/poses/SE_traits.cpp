@@ -154,3 +154,47 @@ void SE_traits<2>::jacobian_dP1DP2inv_depsilon(
 		J2 = CMatrixFixedNumeric<double,3,3>(vals);
 	}
 }
+
+void SE_traits<3>::jacobians_dP1DP2inv_depsilon(
+	const size_t N,
+	const CPose3D *P1DP2inv,
+	matrix_VxV_t *df_de1,
+	matrix_VxV_t *df_de2)
+{
+	for (size_t i=0;i<N;i++)
+		jacobian_dP1DP2inv_depsilon(P1DP2inv[i], df_de1 ? df_de1+i : NULL, df_de2 ? df_de2+i : NULL);
+}
+
+void SE_traits<3>::composePoses(const size_t N, const CPose3D *A, const CPose3D *B, CPose3D *out)
+{
+	for (size_t i=0;i<N;i++)
+		out[i].composeFrom(A[i],B[i]);
+}
+
+void SE_traits<3>::inverseComposePoses(const size_t N, const CPose3D *A, const CPose3D *B, CPose3D *out)
+{
+	for (size_t i=0;i<N;i++)
+		out[i].inverseComposeFrom(A[i],B[i]);
+}
+
+void SE_traits<2>::jacobians_dP1DP2inv_depsilon(
+	const size_t N,
+	const CPose2D *P1DP2inv,
+	matrix_VxV_t *df_de1,
+	matrix_VxV_t *df_de2)
+{
+	for (size_t i=0;i<N;i++)
+		jacobian_dP1DP2inv_depsilon(P1DP2inv[i], df_de1 ? df_de1+i : NULL, df_de2 ? df_de2+i : NULL);
+}
+
+void SE_traits<2>::composePoses(const size_t N, const CPose2D *A, const CPose2D *B, CPose2D *out)
+{
+	for (size_t i=0;i<N;i++)
+		out[i].composeFrom(A[i],B[i]);
+}
+
+void SE_traits<2>::inverseComposePoses(const size_t N, const CPose2D *A, const CPose2D *B, CPose2D *out)
+{
+	for (size_t i=0;i<N;i++)
+		out[i].inverseComposeFrom(A[i],B[i]);
+}
@@ -0,0 +1,117 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/synch/CLockFreeQueue.h>
+#include <mrpt/system/threads.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::synch;
+using namespace mrpt::system;
+using namespace std;
+
+TEST(Synch, CLockFreeQueueSPSC_basic)
+{
+	CLockFreeQueueSPSC<int> q(5);
+	EXPECT_EQ(8u, q.capacity());
+	EXPECT_TRUE(q.empty());
+
+	int v;
+	EXPECT_FALSE(q.pop(v));
+	for (int i=0;i<8;i++)
+		EXPECT_TRUE(q.push(i));
+	EXPECT_FALSE(q.push(100)); // Full
+	EXPECT_EQ(8u, q.size());
+
+	for (int i=0;i<8;i++)
+	{
+		EXPECT_TRUE(q.pop(v));
+		EXPECT_EQ(i, v);
+	}
+	EXPECT_FALSE(q.pop(v));
+	EXPECT_FALSE(q.pop_wait(v,10)); // Timeout
+}
+
+TEST(Synch, CLockFreeQueueMPMC_basic)
+{
+	CLockFreeQueueMPMC<int> q(4);
+	int v;
+	EXPECT_FALSE(q.pop(v));
+	for (int k=0;k<3;k++) // Wrap around the ring several times
+	{
+		for (int i=0;i<4;i++)
+			EXPECT_TRUE(q.push(10*k+i));
+		EXPECT_FALSE(q.push(100));
+		for (int i=0;i<4;i++)
+		{
+			EXPECT_TRUE(q.pop(v));
+			EXPECT_EQ(10*k+i, v);
+		}
+		EXPECT_TRUE(q.empty());
+	}
+}
+
+// Producers push the sequences [id*N, (id+1)*N), consumers check that each sequence arrives in order
+const int QUEUE_TEST_N = 20000;
+
+template <class QUEUE>
+struct TQueueTestData
+{
+	TQueueTestData() : q(64), sum(0), bad_order(false) { }
+	QUEUE   q;
+	int64_t sum;
+	bool    bad_order;
+};
+
+template <class QUEUE>
+void queue_test_producer(std::pair<TQueueTestData<QUEUE>*,int> d)
+{
+	for (int i=0;i<QUEUE_TEST_N;i++)
+		while (!d.first->q.push(d.second*QUEUE_TEST_N+i))
+			mrpt::system::sleep(0);
+}
+
+template <class QUEUE>
+void queue_test_run(int nProducers)
+{
+	TQueueTestData<QUEUE> d;
+
+	std::vector<TThreadHandle> threads;
+	for (int p=0;p<nProducers;p++)
+		threads.push_back( createThread(&queue_test_producer<QUEUE>, std::make_pair(&d,p)) );
+
+	std::vector<int> last(nProducers,-1);
+	for (int i=0;i<nProducers*QUEUE_TEST_N;i++)
+	{
+		int v;
+		ASSERT_TRUE(d.q.pop_wait(v, 5000));
+		const int p = v/QUEUE_TEST_N, k = v%QUEUE_TEST_N;
+		ASSERT_TRUE(p>=0 && p<nProducers);
+		if (k!=last[p]+1) d.bad_order = true;
+		last[p] = k;
+		d.sum += v;
+	}
+	for (size_t i=0;i<threads.size();i++)
+		joinThread(threads[i]);
+
+	const int64_t M = int64_t(nProducers)*QUEUE_TEST_N;
+	EXPECT_FALSE(d.bad_order);
+	EXPECT_EQ(M*(M-1)/2, d.sum);
+	EXPECT_TRUE(d.q.empty());
+}
+
+TEST(Synch, CLockFreeQueueSPSC_threads)
+{
+	queue_test_run< CLockFreeQueueSPSC<int> >(1);
+}
+
+TEST(Synch, CLockFreeQueueMPMC_threads)
+{
+	queue_test_run< CLockFreeQueueMPMC<int> >(4);
+}
@@ -109,3 +109,82 @@ using namespace mrpt::synch;
 	#endif
 #endif
 
+
+/*---------------------------------------------------------------
+		Atomic operations on words (for lock-free structures)
+ ---------------------------------------------------------------*/
+#ifdef MRPT_OS_WINDOWS
+	size_t mrpt::synch::atomic_load_acquire( const volatile size_t *ptr )
+	{
+		const size_t val = *ptr;
+		MemoryBarrier();
+		return val;
+	}
+
+	void mrpt::synch::atomic_store_release( volatile size_t *ptr, size_t val )
+	{
+		MemoryBarrier();
+		*ptr = val;
+	}
+
+	bool mrpt::synch::atomic_compare_exchange( volatile size_t *ptr, size_t expected, size_t desired )
+	{
+	#ifdef _WIN64
+		return static_cast<size_t>(InterlockedCompareExchange64( reinterpret_cast<volatile LONG64*>(ptr), static_cast<LONG64>(desired), static_cast<LONG64>(expected) )) == expected;
+	#else
+		return static_cast<size_t>(InterlockedCompareExchange( reinterpret_cast<volatile LONG*>(ptr), static_cast<LONG>(desired), static_cast<LONG>(expected) )) == expected;
+	#endif
+	}
+
+	void mrpt::synch::atomic_memory_barrier()
+	{
+		MemoryBarrier();
+	}
+
+#elif defined(__clang__) || ( __GNUC__ * 100 + __GNUC_MINOR__ >= 407 )
+	// C++11-like memory model builtins (GCC 4.7+, clang):
+	size_t mrpt::synch::atomic_load_acquire( const volatile size_t *ptr )
+	{
+		return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+	}
+
+	void mrpt::synch::atomic_store_release( volatile size_t *ptr, size_t val )
+	{
+		__atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+	}
+
+	bool mrpt::synch::atomic_compare_exchange( volatile size_t *ptr, size_t expected, size_t desired )
+	{
+		return __atomic_compare_exchange_n(ptr, &expected, desired, false /*strong*/, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	}
+
+	void mrpt::synch::atomic_memory_barrier()
+	{
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	}
+
+#else
+	// Older GCC: legacy "__sync" builtins, all of them are full barriers.
+	size_t mrpt::synch::atomic_load_acquire( const volatile size_t *ptr )
+	{
+		const size_t val = *ptr;
+		__sync_synchronize();
+		return val;
+	}
+
+	void mrpt::synch::atomic_store_release( volatile size_t *ptr, size_t val )
+	{
+		__sync_synchronize();
+		*ptr = val;
+	}
+
+	bool mrpt::synch::atomic_compare_exchange( volatile size_t *ptr, size_t expected, size_t desired )
+	{
+		return __sync_bool_compare_and_swap(ptr, expected, desired);
+	}
+
+	void mrpt::synch::atomic_memory_barrier()
+	{
+		__sync_synchronize();
+	}
+#endif
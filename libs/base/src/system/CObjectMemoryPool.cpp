@@ -0,0 +1,211 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include "base-precomp.h"  // Precompiled headers
+
+#include <mrpt/system/CObjectMemoryPool.h>
+#include <mrpt/system/memory.h>
+#include <mrpt/synch/CLockFreeQueue.h>
+#include <mrpt/utils/mrpt_macros.h>
+#include <cstdlib>
+
+using namespace mrpt::system;
+using namespace mrpt::synch;
+using namespace std;
+
+namespace
+{
+	// Each block starts with a header with the index of its size class, so the
+	// right queue is known upon release(). It's 16 bytes long to keep the alignment.
+	const size_t HEADER_SIZE = 16;
+	const int    NO_SIZE_CLASS = -1; // Blocks larger than the largest class
+
+	// Block sizes (including the header), roughly in steps of x1.25:
+	const size_t CLASS_BLOCK_SIZES[] = {
+		64, 96, 128, 160, 192, 256, 320, 384, 448, 512, 640, 768, 896, 1024,
+		1280, 1536, 1792, 2048, 2560, 3072, 3584, 4096 };
+	const size_t NUM_CLASSES = sizeof(CLASS_BLOCK_SIZES)/sizeof(CLASS_BLOCK_SIZES[0]);
+	const size_t MAX_BLOCK_SIZE = 4096;
+
+	// At most, this amount of memory is kept in the free list of each class:
+	const size_t MAX_CACHED_BYTES_PER_CLASS = 256*1024;
+
+	bool object_pool_destroyed = false; //!< To know when the pool is gone during the global destruction phase
+
+	// Stats counters are size_t, since CAtomicCounter would overflow in long runs:
+	inline void atomic_increment(volatile size_t *v)
+	{
+		size_t old;
+		do { old = atomic_load_acquire(v); }
+		while (!atomic_compare_exchange(v,old,old+1));
+	}
+}
+
+struct CObjectMemoryPool::TSizeClass
+{
+	TSizeClass(size_t block_size_, size_t max_cached_) :
+		block_size(block_size_),
+		free_blocks(max_cached_),
+		n_allocated(0),
+		n_reused(0)
+	{ }
+
+	const size_t                block_size;
+	CLockFreeQueueMPMC<void*>   free_blocks;
+	volatile size_t             n_allocated;
+	volatile size_t             n_reused;
+};
+
+/*---------------------------------------------------------------
+						Constructor
+ ---------------------------------------------------------------*/
+CObjectMemoryPool::CObjectMemoryPool() :
+	m_class_of_size(MAX_BLOCK_SIZE/16+1),
+	m_enabled( ::getenv("MRPT_DISABLE_OBJECT_POOL")==NULL )
+{
+	m_classes.resize(NUM_CLASSES);
+	for (size_t i=0;i<NUM_CLASSES;i++)
+		m_classes[i] = new TSizeClass(CLASS_BLOCK_SIZES[i], std::max<size_t>(16, std::min<size_t>(1024, MAX_CACHED_BYTES_PER_CLASS/CLASS_BLOCK_SIZES[i])));
+
+	// Look-up table: smallest class for each size:
+	size_t c=0;
+	for (size_t i=0;i<m_class_of_size.size();i++)
+	{
+		while (CLASS_BLOCK_SIZES[c]<i*16) c++;
+		m_class_of_size[i] = static_cast<unsigned char>(c);
+	}
+}
+
+/*---------------------------------------------------------------
+						Destructor
+ ---------------------------------------------------------------*/
+CObjectMemoryPool::~CObjectMemoryPool()
+{
+	object_pool_destroyed = true;
+	freeCachedMemory();
+	for (size_t i=0;i<m_classes.size();i++)
+		delete m_classes[i];
+	m_classes.clear();
+}
+
+/*---------------------------------------------------------------
+						getInstance
+ ---------------------------------------------------------------*/
+CObjectMemoryPool * CObjectMemoryPool::getInstance()
+{
+	static CObjectMemoryPool inst;
+	return object_pool_destroyed ? NULL : &inst;
+}
+
+/*---------------------------------------------------------------
+						allocate
+ ---------------------------------------------------------------*/
+void * CObjectMemoryPool::allocate(size_t size)
+{
+	const size_t total_size = size+HEADER_SIZE;
+	CObjectMemoryPool *pool = total_size<=MAX_BLOCK_SIZE ? getInstance() : NULL;
+
+	int   cls = NO_SIZE_CLASS;
+	void *block = NULL;
+	if (pool)
+	{
+		cls = pool->m_class_of_size[(total_size+15)/16];
+		TSizeClass &sc = *pool->m_classes[cls];
+		if (pool->m_enabled && sc.free_blocks.pop(block))
+			atomic_increment(&sc.n_reused);
+		else
+		{
+			block = mrpt::system::os::aligned_malloc(sc.block_size,16);
+			atomic_increment(&sc.n_allocated);
+		}
+	}
+	else block = mrpt::system::os::aligned_malloc(total_size,16);
+
+	if (!block)
+		throw std::bad_alloc();
+
+	*static_cast<int*>(block) = cls;
+	return static_cast<char*>(block)+HEADER_SIZE;
+}
+
+/*---------------------------------------------------------------
+						release
+ ---------------------------------------------------------------*/
+void CObjectMemoryPool::release(void *ptr)
+{
+	if (!ptr) return;
+	void *block = static_cast<char*>(ptr)-HEADER_SIZE;
+	const int cls = *static_cast<int*>(block);
+	if (cls!=NO_SIZE_CLASS)
+	{
+		CObjectMemoryPool *pool = getInstance();
+		if (pool && pool->m_enabled && pool->m_classes[cls]->free_blocks.push(block))
+			return;
+	}
+	mrpt::system::os::aligned_free(block); // Not pooled, or the pool is full
+}
+
+/*---------------------------------------------------------------
+						freeCachedMemory
+ ---------------------------------------------------------------*/
+void CObjectMemoryPool::freeCachedMemory()
+{
+	for (size_t i=0;i<m_classes.size();i++)
+	{
+		void *block;
+		while (m_classes[i]->free_blocks.pop(block))
+			mrpt::system::os::aligned_free(block);
+	}
+}
+
+/*---------------------------------------------------------------
+						getStats
+ ---------------------------------------------------------------*/
+void CObjectMemoryPool::getStats(std::vector<TSizeClassStats> &stats) const
+{
+	stats.resize(m_classes.size());
+	for (size_t i=0;i<m_classes.size();i++)
+	{
+		const TSizeClass &sc = *m_classes[i];
+		TSizeClassStats &s = stats[i];
+		s.block_size  = sc.block_size;
+		s.max_cached  = sc.free_blocks.capacity();
+		s.n_cached    = sc.free_blocks.size();
+		s.n_allocated = atomic_load_acquire(&sc.n_allocated);
+		s.n_reused    = atomic_load_acquire(&sc.n_reused);
+	}
+}
+
+/*---------------------------------------------------------------
+						getStatsAsText
+ ---------------------------------------------------------------*/
+std::string CObjectMemoryPool::getStatsAsText() const
+{
+	std::vector<TSizeClassStats> stats;
+	getStats(stats);
+
+	std::string s;
+	s+="------------------------ mrpt::system::CObjectMemoryPool stats ------------------------\n";
+	s+="  Block size |   Heap allocs |        Reused |  Hit ratio | Cached blocks (max)\n";
+	s+="----------------------------------------------------------------------------------------\n";
+	for (size_t i=0;i<stats.size();i++)
+	{
+		const TSizeClassStats &c = stats[i];
+		if (!c.n_allocated && !c.n_reused) continue;
+		s+=mrpt::format("  %10u | %13lu | %13lu | %9.02f%% | %6u (%u)\n",
+			static_cast<unsigned int>(c.block_size),
+			static_cast<unsigned long>(c.n_allocated),
+			static_cast<unsigned long>(c.n_reused),
+			100.0*c.n_reused/(c.n_allocated+c.n_reused),
+			static_cast<unsigned int>(c.n_cached),
+			static_cast<unsigned int>(c.max_cached) );
+	}
+	s+="----------------------------------------------------------------------------------------\n";
+	return s;
+}
@@ -0,0 +1,98 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/system/CObjectMemoryPool.h>
+#include <mrpt/system/threads.h>
+#include <mrpt/system/memory.h>
+#include <mrpt/poses/CPose3D.h>
+#include <gtest/gtest.h>
+#include <cstring>
+
+using namespace mrpt;
+using namespace mrpt::system;
+using namespace mrpt::poses;
+using namespace std;
+
+namespace
+{
+	size_t totalReused()
+	{
+		vector<CObjectMemoryPool::TSizeClassStats> stats;
+		CObjectMemoryPool::getInstance()->getStats(stats);
+		size_t n=0;
+		for (size_t i=0;i<stats.size();i++) n+=stats[i].n_reused;
+		return n;
+	}
+
+	// Objects created in one thread are freed in another one:
+	void pool_test_thread(vector<CPose3D*> *objs)
+	{
+		for (size_t i=0;i<objs->size();i++)
+		{
+			delete (*objs)[i];
+			(*objs)[i] = new CPose3D(i,0,0,0,0,0);
+		}
+	}
+}
+
+TEST(CObjectMemoryPool, allocateAndReuse)
+{
+	CObjectMemoryPool *pool = CObjectMemoryPool::getInstance();
+	ASSERT_TRUE(pool!=NULL);
+	ASSERT_TRUE(pool->isEnabled());
+
+	// All sizes, including those larger than the largest size class:
+	for (size_t sz=1;sz<10000;sz+=sz/4+1)
+	{
+		void *p = CObjectMemoryPool::allocate(sz);
+		EXPECT_TRUE(mrpt::system::is_aligned<16>(p));
+		::memset(p,0xAA,sz);
+		CObjectMemoryPool::release(p);
+	}
+
+	// A freed block is given again to an object of the same size:
+	void *p1 = CObjectMemoryPool::allocate(200);
+	CObjectMemoryPool::release(p1);
+	const size_t nReused = totalReused();
+	void *p2 = CObjectMemoryPool::allocate(200);
+	EXPECT_EQ(nReused+1, totalReused());
+	CObjectMemoryPool::release(p2);
+
+	// Not while disabled:
+	pool->setEnabled(false);
+	pool->freeCachedMemory();
+	CPose3D *pose = new CPose3D(1,2,3,0,0,0);
+	delete pose;
+	pose = new CPose3D(1,2,3,0,0,0);
+	delete pose;
+	pool->setEnabled(true);
+	EXPECT_EQ(nReused+1, totalReused());
+	EXPECT_FALSE(pool->getStatsAsText().empty());
+}
+
+TEST(CObjectMemoryPool, objectsFromSeveralThreads)
+{
+	vector<CPose3D*> objs[4];
+	for (int k=0;k<4;k++)
+		for (int i=0;i<500;i++)
+			objs[k].push_back(new CPose3D(i,1,2,0,0,0));
+
+	TThreadHandle th[4];
+	for (int k=0;k<4;k++)
+		th[k] = createThread(&pool_test_thread, &objs[(k+1)%4]); // Each thread frees the objects of other one
+	for (int k=0;k<4;k++)
+		joinThread(th[k]);
+
+	for (int k=0;k<4;k++)
+		for (size_t i=0;i<objs[k].size();i++)
+		{
+			EXPECT_EQ(double(i), objs[k][i]->x());
+			delete objs[k][i];
+		}
+}
@@ -0,0 +1,205 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include "base-precomp.h"  // Precompiled headers
+
+#include <mrpt/system/CThreadPool.h>
+#include <iostream>
+
+using namespace mrpt;
+using namespace mrpt::system;
+using namespace mrpt::synch;
+using namespace std;
+
+/*---------------------------------------------------------------
+						Constructor
+ ---------------------------------------------------------------*/
+CThreadPool::CThreadPool(unsigned int num_threads, size_t queue_capacity) :
+	m_pending(0),
+	m_next_queue(0),
+	m_sem_started(0, 0x7FFFFFFF),
+	m_shutdown(false)
+{
+	MRPT_START
+
+	if (!num_threads)
+		num_threads = getNumberOfProcessors();
+	ASSERT_(num_threads>0 && queue_capacity>0)
+
+	m_queues.resize(num_threads);
+	for (unsigned int i=0;i<num_threads;i++)
+		m_queues[i] = new TTaskQueue(queue_capacity);
+
+	m_thread_ids.assign(num_threads, 0);
+	m_threads.resize(num_threads);
+	for (unsigned int i=0;i<num_threads;i++)
+		m_threads[i] = createThreadFromObjectMethod(this, &CThreadPool::workerThread, i);
+
+	// Wait until all the workers know their IDs:
+	for (unsigned int i=0;i<num_threads;i++)
+		m_sem_started.waitForSignal();
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+						Destructor
+ ---------------------------------------------------------------*/
+CThreadPool::~CThreadPool()
+{
+	wait();
+
+	m_shutdown = true;
+	m_ec_work.notifyAll();
+	for (size_t i=0;i<m_threads.size();i++)
+		joinThread(m_threads[i]);
+
+	for (size_t i=0;i<m_queues.size();i++)
+		delete m_queues[i];
+}
+
+/*---------------------------------------------------------------
+						enqueue
+ ---------------------------------------------------------------*/
+void CThreadPool::enqueue(void (*func)(void *), void *param)
+{
+	const TTask task(func,param);
+	++m_pending;
+
+	// From a worker, keep the task in its own queue (better cache locality); otherwise, round-robin:
+	const size_t nQueues = m_queues.size();
+	int first = currentWorkerIndex();
+	if (first<0)
+	{
+		++m_next_queue;
+		first = static_cast<int>( static_cast<size_t>(m_next_queue) % nQueues );
+	}
+
+	for (size_t k=0;k<nQueues;k++)
+	{
+		if (m_queues[(first+k) % nQueues]->push(task))
+		{
+			m_ec_work.notifyOne();
+			return;
+		}
+	}
+
+	// All the queues are full: run it here.
+	runTask(task);
+}
+
+/*---------------------------------------------------------------
+						wait
+ ---------------------------------------------------------------*/
+void CThreadPool::wait()
+{
+	const int my_idx = currentWorkerIndex();
+	while (m_pending>0)
+	{
+		if (tryRunOneTask(my_idx))
+			continue;
+
+		// Nothing to do but waiting for the running tasks:
+		m_ec_done.prepareWait();
+		if (m_pending<=0 || anyQueuedTask())
+			m_ec_done.cancelWait();
+		else m_ec_done.commitWait();
+	}
+}
+
+size_t CThreadPool::pendingTasks() const
+{
+	const long n = m_pending;
+	return n>0 ? static_cast<size_t>(n) : 0;
+}
+
+int CThreadPool::currentWorkerIndex() const
+{
+	const unsigned long id = getCurrentThreadId();
+	for (size_t i=0;i<m_thread_ids.size();i++)
+		if (m_thread_ids[i]==id)
+			return static_cast<int>(i);
+	return -1;
+}
+
+bool CThreadPool::anyQueuedTask() const
+{
+	for (size_t i=0;i<m_queues.size();i++)
+		if (!m_queues[i]->empty())
+			return true;
+	return false;
+}
+
+bool CThreadPool::tryRunOneTask(int worker_idx)
+{
+	// First, our own queue, then try to steal from the others:
+	const size_t nQueues = m_queues.size();
+	const size_t first = worker_idx>=0 ? static_cast<size_t>(worker_idx) : 0;
+	TTask task;
+	for (size_t k=0;k<nQueues;k++)
+	{
+		if (m_queues[(first+k) % nQueues]->pop(task))
+		{
+			runTask(task);
+			return true;
+		}
+	}
+	return false;
+}
+
+void CThreadPool::runTask(const TTask &task)
+{
+	try
+	{
+		task.func(task.param);
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << "[CThreadPool] Exception in task:\n" << e.what() << std::endl;
+	}
+	catch (...)
+	{
+		std::cerr << "[CThreadPool] Untyped exception in task!\n";
+	}
+
+	if (--m_pending==0)
+		m_ec_done.notifyAll();
+}
+
+/*---------------------------------------------------------------
+						workerThread
+ ---------------------------------------------------------------*/
+void CThreadPool::workerThread(unsigned int idx)
+{
+	m_thread_ids[idx] = getCurrentThreadId();
+	m_sem_started.release();
+
+	for (;;)
+	{
+		if (tryRunOneTask(idx))
+			continue;
+		if (m_shutdown)
+			break;
+
+		// Sleep until there is something to do:
+		m_ec_work.prepareWait();
+		if (m_shutdown || anyQueuedTask())
+			m_ec_work.cancelWait();
+		else m_ec_work.commitWait();
+	}
+}
+
+/*---------------------------------------------------------------
+						globalThreadPool
+ ---------------------------------------------------------------*/
+CThreadPool & mrpt::system::globalThreadPool()
+{
+	static CThreadPool pool;
+	return pool;
+}
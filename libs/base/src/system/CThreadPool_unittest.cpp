@@ -0,0 +1,69 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/system/CThreadPool.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::system;
+using namespace std;
+
+struct TPoolTestData
+{
+	TPoolTestData() : counter(0), pool(NULL) { }
+	mrpt::synch::CAtomicCounter counter;
+	CThreadPool *pool;
+
+	void addOne(int n)
+	{
+		for (int i=0;i<n;i++) ++counter;
+	}
+	// A task which enqueues more tasks (they go to the same worker queue, and may be stolen by others):
+	void spawn(int n)
+	{
+		for (int i=0;i<n;i++)
+			pool->enqueueObjectMethod(this, &TPoolTestData::addOne, 1);
+	}
+};
+
+void pool_test_task(TPoolTestData *d)
+{
+	++d->counter;
+}
+
+TEST(CThreadPool, runAllTasks)
+{
+	for (unsigned int nThreads=1;nThreads<=4;nThreads*=2)
+	{
+		CThreadPool pool(nThreads, 16 /* small queues: some tasks will run in the calling thread */);
+		EXPECT_EQ(nThreads, pool.size());
+
+		TPoolTestData d;
+		d.pool = &pool;
+		for (int i=0;i<1000;i++)
+			pool.enqueue(&pool_test_task, &d);
+		for (int i=0;i<10;i++)
+			pool.enqueueObjectMethod(&d, &TPoolTestData::spawn, 10);
+		pool.wait();
+
+		EXPECT_EQ(0u, pool.pendingTasks());
+		EXPECT_EQ(1100, int(d.counter));
+	}
+}
+
+TEST(CThreadPool, destructorRunsPendingTasks)
+{
+	TPoolTestData d;
+	{
+		CThreadPool pool(2);
+		for (int i=0;i<100;i++)
+			pool.enqueueObjectMethod(&d, &TPoolTestData::addOne, 2);
+	}
+	EXPECT_EQ(200, int(d.counter));
+}
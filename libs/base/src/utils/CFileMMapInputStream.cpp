@@ -0,0 +1,167 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include "base-precomp.h"  // Precompiled headers
+
+#include <mrpt/utils/CFileMMapInputStream.h>
+
+#ifdef MRPT_OS_WINDOWS
+	#include <windows.h>
+#else
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+using namespace mrpt::utils;
+using namespace std;
+
+/*---------------------------------------------------------------
+							Constructor
+ ---------------------------------------------------------------*/
+CFileMMapInputStream::CFileMMapInputStream( const string &fileName ) :
+	m_mmap_data(NULL),
+	m_mmap_size(0),
+	m_is_open(false)
+{
+	MRPT_START
+
+	if (!open(fileName))
+		THROW_EXCEPTION_CUSTOM_MSG1( "Error trying to open and map file: '%s'",fileName.c_str() );
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+							Constructor
+ ---------------------------------------------------------------*/
+CFileMMapInputStream::CFileMMapInputStream() :
+	m_mmap_data(NULL),
+	m_mmap_size(0),
+	m_is_open(false)
+{
+}
+
+/*---------------------------------------------------------------
+							Destructor
+ ---------------------------------------------------------------*/
+CFileMMapInputStream::~CFileMMapInputStream()
+{
+	close();
+}
+
+/*---------------------------------------------------------------
+							open
+ ---------------------------------------------------------------*/
+bool CFileMMapInputStream::open( const string &fileName )
+{
+	close();
+
+	// Note: Once the view is mapped, the file handles are not needed anymore.
+#ifdef MRPT_OS_WINDOWS
+	HANDLE hFile = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile==INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile,&fileSize))
+	{
+		CloseHandle(hFile);
+		return false;
+	}
+	m_mmap_size = static_cast<uint64_t>(fileSize.QuadPart);
+
+	if (m_mmap_size>0)
+	{
+		HANDLE hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (hMapping)
+		{
+			m_mmap_data = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(hMapping);
+		}
+	}
+	CloseHandle(hFile);
+#else
+	const int fd = ::open(fileName.c_str(), O_RDONLY);
+	if (fd<0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd,&st)!=0)
+	{
+		::close(fd);
+		return false;
+	}
+	m_mmap_size = static_cast<uint64_t>(st.st_size);
+
+	if (m_mmap_size>0)
+	{
+		void *ptr = mmap(NULL, static_cast<size_t>(m_mmap_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if (ptr!=MAP_FAILED)
+		{
+			m_mmap_data = ptr;
+#	ifdef MADV_SEQUENTIAL
+			// Objects are usually read from the beginning to the end: ask for aggressive read-ahead.
+			madvise(m_mmap_data, static_cast<size_t>(m_mmap_size), MADV_SEQUENTIAL);
+#	endif
+		}
+	}
+	::close(fd);
+#endif
+
+	if (m_mmap_size>0 && !m_mmap_data)
+	{
+		m_mmap_size = 0;
+		return false;
+	}
+
+	this->assignMemoryNotOwn(m_mmap_data, m_mmap_size);
+	m_bytesWritten = m_mmap_size; // All the mapped contents are "valid data"
+	m_is_open = true;
+	return true;
+}
+
+/*---------------------------------------------------------------
+							close
+ ---------------------------------------------------------------*/
+void CFileMMapInputStream::close()
+{
+	this->Clear(); // Forget the pointer to the mapped memory
+
+	if (m_mmap_data)
+	{
+#ifdef MRPT_OS_WINDOWS
+		UnmapViewOfFile(m_mmap_data);
+#else
+		munmap(m_mmap_data, static_cast<size_t>(m_mmap_size));
+#endif
+	}
+	m_mmap_data = NULL;
+	m_mmap_size = 0;
+	m_is_open = false;
+}
+
+/*---------------------------------------------------------------
+							Write
+ ---------------------------------------------------------------*/
+size_t CFileMMapInputStream::Write(const void *Buffer, size_t Count)
+{
+	MRPT_UNUSED_PARAM(Buffer); MRPT_UNUSED_PARAM(Count);
+	THROW_EXCEPTION("Trying to write to a read file stream.");
+}
+
+/*---------------------------------------------------------------
+							checkEOF
+ ---------------------------------------------------------------*/
+bool CFileMMapInputStream::checkEOF()
+{
+	return !m_is_open || m_position>=m_size;
+}
@@ -0,0 +1,78 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/utils/CFileMMapInputStream.h>
+#include <mrpt/utils/CFileOutputStream.h>
+#include <mrpt/utils/CFileGZOutputStream.h>
+#include <mrpt/compress/zip.h>
+#include <mrpt/system/filesystem.h>
+#include <mrpt/poses/CPose3D.h>
+#include <gtest/gtest.h>
+#include <cstring>
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::poses;
+using namespace std;
+
+TEST(CFileMMapInputStream, readObjectsAndInPlace)
+{
+	const string fil = mrpt::system::getTempFileName();
+	const char txt[] = "0123456789";
+	{
+		CFileOutputStream f(fil);
+		f << CPose3D(1,2,3,0.1,0.2,0.3);
+		f.WriteBuffer(txt,10);
+		f << uint32_t(1234);
+	}
+	EXPECT_FALSE(mrpt::compress::zip::is_gz_file(fil));
+
+	{
+		CFileMMapInputStream f(fil);
+		EXPECT_TRUE(f.fileOpenCorrectly());
+		EXPECT_EQ(f.getTotalBytesCount(), mrpt::system::getFileSize(fil));
+
+		CPose3D p;
+		f >> p;
+		EXPECT_NEAR(0, (p.getAsVectorVal()-CPose3D(1,2,3,0.1,0.2,0.3).getAsVectorVal()).array().abs().sum(), 1e-9);
+
+		const char *ptr = static_cast<const char*>(f.ReadBufferInPlace(10));
+		ASSERT_TRUE(ptr!=NULL);
+		EXPECT_EQ(0, memcmp(ptr,txt,10));
+
+		uint32_t v;
+		f >> v;
+		EXPECT_EQ(1234u, v);
+		EXPECT_TRUE(f.checkEOF());
+		EXPECT_TRUE(f.ReadBufferInPlace(1)==NULL); // Past the end
+
+		// Writing is not allowed:
+		EXPECT_THROW(f << v, std::exception);
+	}
+	mrpt::system::deleteFile(fil);
+
+	// A non-existing file:
+	CFileMMapInputStream f;
+	EXPECT_FALSE(f.open(fil));
+	EXPECT_FALSE(f.fileOpenCorrectly());
+}
+
+TEST(CFileMMapInputStream, is_gz_file)
+{
+	const string fil = mrpt::system::getTempFileName();
+	{
+		CFileGZOutputStream f(fil);
+		f << uint32_t(1234);
+	}
+#if MRPT_HAS_GZ_STREAMS
+	EXPECT_TRUE(mrpt::compress::zip::is_gz_file(fil));
+#endif
+	mrpt::system::deleteFile(fil);
+	EXPECT_FALSE(mrpt::compress::zip::is_gz_file(fil));
+}
@@ -32,6 +32,8 @@
 
 // Prototypes of SSE2/SSE3/SSSE3 optimized functions:
 #include "CImage_SSEx.h"
+// Cache of decoded externally-stored images:
+#include "CImage_external_cache.h"
 
 #if MRPT_HAS_WXWIDGETS
 #	include <wx/image.h>
@@ -151,9 +153,14 @@ void CImage::copyFromForceLoad(const CImage &o)
 {
 	if (o.isExternallyStored())
 	{
-		// Load from that file:
-		if (!this->loadFromFile( o.getExternalStorageFileAbsolutePath() ))
-			THROW_TYPED_EXCEPTION_CUSTOM_MSG1("Error loading externally-stored image from: %s", o.getExternalStorageFileAbsolutePath().c_str() ,CExceptionExternalImageNotFound);
+		const std::string wholeFile = o.getExternalStorageFileAbsolutePath(); // (o may be *this)
+
+		// Look first in the cache of decoded images (it may have been prefetched), or load from that file:
+		if (external_images_cache_get(wholeFile,*this))
+			return;
+		if (!this->loadFromFile(wholeFile))
+			THROW_TYPED_EXCEPTION_CUSTOM_MSG1("Error loading externally-stored image from: %s", wholeFile.c_str() ,CExceptionExternalImageNotFound);
+		external_images_cache_put(wholeFile,*this);
 	}
 	else
 	{	// It's not external storage.
@@ -644,12 +651,16 @@ void  CImage::readFromStream(mrpt::utils::CStream &in, int version)
 		}
 	}
 #else
-	releaseIpl();  // First, free current image.
+	// Keep the current IplImage if it's ours, so changeSize() reuses its buffer if the new image has the same size
+	// (the usual case while reading a sequence of observations into the same objects):
+	if (m_imgIsReadOnly || m_imgIsExternalStorage)
+		releaseIpl();
 
 	switch(version)
 	{
 	case 100: // Saved from an MRPT build without OpenCV:
 		{
+			releaseIpl();
 			in >> m_imgIsExternalStorage;
 			if (m_imgIsExternalStorage)
 				in >> m_externalFile;
@@ -697,6 +708,7 @@ void  CImage::readFromStream(mrpt::utils::CStream &in, int version)
 			if (m_imgIsExternalStorage)
 			{
 				// Just the file name:
+				releaseIpl(true /* keep the external storage flag */);
 				in >> m_externalFile;
 			}
 			else
@@ -786,10 +798,18 @@ void  CImage::readFromStream(mrpt::utils::CStream &in, int version)
 
 								const IplImage *ipl = static_cast<const IplImage*>(img);
 								const size_t bytes_per_row = ipl->width * 3;
-								for (int y=0;y<ipl->height;y++)
+								if (static_cast<size_t>(ipl->widthStep)==bytes_per_row)
+								{	// No row padding: read all the pixels at once
+									const size_t nBytes = bytes_per_row*ipl->height;
+									if (nBytes && in.ReadBuffer( &ipl->imageData[0], nBytes)!=nBytes) THROW_EXCEPTION("Error: Truncated data stream while parsing raw image?")
+								}
+								else
 								{
-									const size_t nRead = in.ReadBuffer( &ipl->imageData[y*ipl->widthStep], bytes_per_row);
-									if (nRead!=bytes_per_row) THROW_EXCEPTION("Error: Truncated data stream while parsing raw image?")
+									for (int y=0;y<ipl->height;y++)
+									{
+										const size_t nRead = in.ReadBuffer( &ipl->imageData[y*ipl->widthStep], bytes_per_row);
+										if (nRead!=bytes_per_row) THROW_EXCEPTION("Error: Truncated data stream while parsing raw image?")
+									}
 								}
 							}
 							else
@@ -1944,9 +1964,17 @@ void CImage::makeSureImageIsLoaded() const throw (std::exception,utils::CExcepti
 
 		const std::string tmpFile = m_externalFile;
 
-		bool ret = const_cast<CImage*>(this)->loadFromFile(wholeFile);
+		// Look first in the cache of decoded images, or load the file and keep a copy there:
+		CImage *me = const_cast<CImage*>(this);
+		bool ret = true;
+		if (!external_images_cache_get(wholeFile,*me))
+		{
+			ret = me->loadFromFile(wholeFile);
+			if (ret)
+				external_images_cache_put(wholeFile,*me);
+		}
 
-		// These are removed by "loadFromFile", and that's good, just fix it here and carry on.
+		// These are removed by "loadFromFile" (or the copy from the cache), and that's good, just fix it here and carry on.
 		m_imgIsExternalStorage = true;
 		m_externalFile = tmpFile;
 
@@ -0,0 +1,298 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include "base-precomp.h"  // Precompiled headers
+
+#include <mrpt/utils/CImage.h>
+#include <mrpt/synch/CCriticalSection.h>
+#include <mrpt/synch/CLockFreeQueue.h>  // CEventCount
+#include <mrpt/system/CThreadPool.h>
+#include <mrpt/system/filesystem.h>
+#include <list>
+#include <map>
+
+#include "CImage_external_cache.h"
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::synch;
+using namespace std;
+
+// The process-wide LRU cache of decoded externally-stored images.
+namespace
+{
+	bool external_images_cache_destroyed = false; //!< To know when the cache is gone during the global destruction phase
+
+	class CExternalImagesCache
+	{
+	public:
+		CExternalImagesCache() : m_max_bytes(0), m_bytes(0) { } // Disabled by default
+		~CExternalImagesCache()
+		{
+			external_images_cache_destroyed = true;
+			clear();
+		}
+
+		/** Returns the unique instance, or NULL during the program global destruction phase. */
+		static CExternalImagesCache *getInstance()
+		{
+			static CExternalImagesCache inst;
+			return external_images_cache_destroyed ? NULL : &inst;
+		}
+
+		bool get(const string &path, CImage &out_img)
+		{
+			// To detect changes in the file since it was cached (checked outside of the lock, since it's a system call):
+			const time_t   file_time = mrpt::system::getFileModificationTime(path);
+			const uint64_t file_size = mrpt::system::getFileSize(path);
+			for (;;)
+			{
+				{
+					CCriticalSectionLocker lock(&m_cs);
+					if (lookup(path, file_time, file_size, out_img))
+					{
+						m_stats.hits++;
+						return true;
+					}
+					TPending::iterator it = m_pending.find(path);
+					if (it==m_pending.end() || !it->second)
+					{
+						// Not cached. If a prefetch is queued but not started yet, the caller will decode the file itself
+						// instead of waiting (e.g. the calling thread might be the worker which should run that prefetch).
+						if (it!=m_pending.end()) m_pending.erase(it);
+						m_stats.misses++;
+						return false;
+					}
+				}
+				// Wait for the prefetch of this file (running in other thread) to end:
+				m_ec_done.prepareWait();
+				bool in_progress;
+				{
+					CCriticalSectionLocker lock(&m_cs);
+					in_progress = m_pending.find(path)!=m_pending.end();
+				}
+				if (in_progress)
+				     m_ec_done.commitWait(100);
+				else m_ec_done.cancelWait();
+			}
+		}
+
+		/** Inserts an image (copied, or moved if move==true) */
+		void put(const string &path, CImage &img, bool move)
+		{
+			if (!img.getAs<void>() || img.isExternallyStored()) return;
+			const size_t bytes = img.getRowStride()*img.getHeight();
+			const time_t   file_time = mrpt::system::getFileModificationTime(path);
+			const uint64_t file_size = mrpt::system::getFileSize(path);
+
+			CImage *cached_img = new CImage(UNINITIALIZED_IMAGE);
+			if (move)
+			     cached_img->copyFastFrom(img);
+			else *cached_img = img;
+
+			CCriticalSectionLocker lock(&m_cs);
+			if (bytes>m_max_bytes)
+			{
+				delete cached_img;
+				return;
+			}
+			TIndex::iterator it = m_index.find(path);
+			if (it!=m_index.end()) erase(it);
+
+			// Make room:
+			while (m_bytes+bytes>m_max_bytes && !m_lru.empty())
+				erase(m_index.find(m_lru.back().path));
+
+			m_lru.push_front(TEntry(path,cached_img,bytes,file_time,file_size));
+			m_index[path] = m_lru.begin();
+			m_bytes += bytes;
+		}
+
+		/** \return false if the file is already cached or being decoded */
+		bool startPrefetch(const string &path)
+		{
+			CCriticalSectionLocker lock(&m_cs);
+			if (!m_max_bytes || m_index.find(path)!=m_index.end() || m_pending.find(path)!=m_pending.end())
+				return false;
+			m_pending[path] = false;
+			return true;
+		}
+
+		/** Called by the prefetch task before decoding. \return false if the prefetch was cancelled meanwhile */
+		bool beginPrefetchDecoding(const string &path)
+		{
+			CCriticalSectionLocker lock(&m_cs);
+			TPending::iterator it = m_pending.find(path);
+			if (it==m_pending.end()) return false;
+			it->second = true;
+			return true;
+		}
+
+		void endPrefetch(const string &path, CImage *img)
+		{
+			if (img) put(path,*img,true);
+			{
+				CCriticalSectionLocker lock(&m_cs);
+				m_pending.erase(path);
+				if (img) m_stats.prefetched++;
+			}
+			m_ec_done.notifyAll();
+		}
+
+		void setMaxBytes(size_t max_bytes)
+		{
+			CCriticalSectionLocker lock(&m_cs);
+			m_max_bytes = max_bytes;
+			while (m_bytes>m_max_bytes && !m_lru.empty())
+				erase(m_index.find(m_lru.back().path));
+		}
+		size_t getMaxBytes() const
+		{
+			CCriticalSectionLocker lock(&m_cs);
+			return m_max_bytes;
+		}
+
+		void clear()
+		{
+			CCriticalSectionLocker lock(&m_cs);
+			while (!m_lru.empty())
+				erase(m_index.find(m_lru.back().path));
+		}
+
+		void getStats(CImage::TExternalImagesCacheStats &s) const
+		{
+			CCriticalSectionLocker lock(&m_cs);
+			s = m_stats;
+			s.num_images = m_lru.size();
+			s.bytes = m_bytes;
+		}
+
+	private:
+		struct TEntry
+		{
+			TEntry(const string &path_, CImage *img_, size_t bytes_, time_t file_time_, uint64_t file_size_) :
+				path(path_), img(img_), bytes(bytes_), file_time(file_time_), file_size(file_size_) { }
+			string   path;
+			CImage  *img;       //!< Owned by the cache, deleted in erase()
+			size_t   bytes;
+			time_t   file_time; //!< To detect changes in the file
+			uint64_t file_size;
+		};
+		typedef list<TEntry> TLRUList; //!< Most recently used first
+		typedef map<string,TLRUList::iterator> TIndex;
+		typedef map<string,bool> TPending; //!< Files queued for prefetch(), and whether their decoding has started
+
+		CCriticalSection  m_cs;
+		CEventCount       m_ec_done;  //!< Notified when a prefetch ends
+		TLRUList          m_lru;
+		TIndex            m_index;
+		TPending          m_pending;
+		size_t            m_max_bytes, m_bytes;
+		CImage::TExternalImagesCacheStats m_stats;
+
+		// Must be called with m_cs locked:
+		bool lookup(const string &path, time_t file_time, uint64_t file_size, CImage &out_img)
+		{
+			TIndex::iterator it = m_index.find(path);
+			if (it==m_index.end()) return false;
+			const TEntry &e = *it->second;
+			if (e.file_time!=file_time || e.file_size!=file_size)
+			{
+				// The file has changed since it was cached:
+				erase(it);
+				return false;
+			}
+			m_lru.splice(m_lru.begin(), m_lru, it->second);
+			out_img = *e.img;
+			return true;
+		}
+		void erase(TIndex::iterator it)
+		{
+			m_bytes -= it->second->bytes;
+			delete it->second->img;
+			m_lru.erase(it->second);
+			m_index.erase(it);
+		}
+	};
+
+	// Runs in a worker of the thread pool:
+	void prefetch_task(string *path)
+	{
+		CExternalImagesCache *cache = CExternalImagesCache::getInstance();
+		if (cache && cache->beginPrefetchDecoding(*path))
+		{
+			CImage img(UNINITIALIZED_IMAGE);
+			bool ok = false;
+			try { ok = img.loadFromFile(*path); }
+			catch (std::exception &) { }
+			cache->endPrefetch(*path, ok ? &img : NULL);
+		}
+		delete path;
+	}
+}
+
+/*---------------------------------------------------------------
+				Internal interface for CImage.cpp
+ ---------------------------------------------------------------*/
+bool external_images_cache_get(const std::string &abs_path, CImage &out_img)
+{
+	CExternalImagesCache *cache = CExternalImagesCache::getInstance();
+	return cache && cache->getMaxBytes() && cache->get(abs_path,out_img);
+}
+
+void external_images_cache_put(const std::string &abs_path, const CImage &img)
+{
+	CExternalImagesCache *cache = CExternalImagesCache::getInstance();
+	if (cache && cache->getMaxBytes())
+		cache->put(abs_path,const_cast<CImage&>(img),false /* copy */);
+}
+
+/*---------------------------------------------------------------
+						prefetch
+ ---------------------------------------------------------------*/
+void CImage::prefetch() const
+{
+	if (!m_imgIsExternalStorage || img!=NULL) return;
+
+	CExternalImagesCache *cache = CExternalImagesCache::getInstance();
+	string path;
+	getExternalStorageFileAbsolutePath(path);
+	if (!cache || !cache->startPrefetch(path)) return;
+
+	mrpt::system::globalThreadPool().enqueue(&prefetch_task, new string(path));
+}
+
+/*---------------------------------------------------------------
+				External images cache settings
+ ---------------------------------------------------------------*/
+void CImage::setExternalImagesCacheSize(size_t max_bytes)
+{
+	CExternalImagesCache *cache = CExternalImagesCache::getInstance();
+	if (cache) cache->setMaxBytes(max_bytes);
+}
+
+size_t CImage::getExternalImagesCacheSize()
+{
+	CExternalImagesCache *cache = CExternalImagesCache::getInstance();
+	return cache ? cache->getMaxBytes() : 0;
+}
+
+void CImage::clearExternalImagesCache()
+{
+	CExternalImagesCache *cache = CExternalImagesCache::getInstance();
+	if (cache) cache->clear();
+}
+
+void CImage::getExternalImagesCacheStats(TExternalImagesCacheStats &stats)
+{
+	CExternalImagesCache *cache = CExternalImagesCache::getInstance();
+	if (cache)
+	     cache->getStats(stats);
+	else stats = TExternalImagesCacheStats();
+}
@@ -0,0 +1,23 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+#ifndef CImage_external_cache_H
+#define CImage_external_cache_H
+
+#include <string>
+
+namespace mrpt { namespace utils { class CImage; } }
+
+// See documentation in CImage_external_cache.cpp
+
+/** Copies into "out_img" the cached decoded image of the file, waiting for a prefetch of that file in progress, if any. \return false if not in the cache. */
+bool external_images_cache_get(const std::string &abs_path, mrpt::utils::CImage &out_img);
+/** Stores a copy of a just-loaded image in the cache. */
+void external_images_cache_put(const std::string &abs_path, const mrpt::utils::CImage &img);
+
+#endif
@@ -0,0 +1,175 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/utils/CImage.h>
+#include <mrpt/system/filesystem.h>
+#include <mrpt/system/threads.h>
+#include <gtest/gtest.h>
+
+#ifdef MRPT_OS_WINDOWS
+#	include <sys/utime.h>
+#else
+#	include <utime.h>
+#endif
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::system;
+using namespace std;
+
+#if MRPT_HAS_OPENCV
+
+namespace
+{
+	// Writes a gray image (as an uncompressed BMP, so the file size only depends on the image size):
+	string createTestImageFile(uint8_t value, size_t width=64)
+	{
+		const string fil = getTempFileName()+".bmp";
+		CImage img(width,48,CH_RGB);
+		img.filledRectangle(0,0,width-1,47,TColor(value,value,value));
+		img.saveToFile(fil);
+		return fil;
+	}
+
+	// Loads a delay-load image from the given file (through the cache), and returns its first pixel:
+	uint8_t loadExternalImage(const string &fil)
+	{
+		CImage img;
+		img.setExternalStorage(fil);
+		img.forceLoad();
+		return *img(0,0,0);
+	}
+
+	CImage::TExternalImagesCacheStats cacheStats()
+	{
+		CImage::TExternalImagesCacheStats s;
+		CImage::getExternalImagesCacheStats(s);
+		return s;
+	}
+}
+
+TEST(CImage, ExternalImagesCacheLRUEviction)
+{
+	const string filA = createTestImageFile(10), filB = createTestImageFile(20), filC = createTestImageFile(30);
+
+	// Room for 2 images:
+	CImage tmp;
+	tmp.loadFromFile(filA);
+	const size_t img_bytes = tmp.getRowStride()*tmp.getHeight();
+	CImage::clearExternalImagesCache();
+	CImage::setExternalImagesCacheSize(2*img_bytes + img_bytes/2);
+
+	const CImage::TExternalImagesCacheStats s0 = cacheStats();
+	EXPECT_EQ(10, loadExternalImage(filA));
+	EXPECT_EQ(20, loadExternalImage(filB));
+	EXPECT_EQ(30, loadExternalImage(filC)); // Evicts A
+	CImage::TExternalImagesCacheStats s = cacheStats();
+	EXPECT_EQ(3u, s.misses-s0.misses);
+	EXPECT_EQ(0u, s.hits-s0.hits);
+	EXPECT_EQ(2u, s.num_images);
+	EXPECT_EQ(2*img_bytes, s.bytes);
+
+	EXPECT_EQ(20, loadExternalImage(filB)); // Hit: B is now the most recently used
+	EXPECT_EQ(10, loadExternalImage(filA)); // Miss: evicts C
+	EXPECT_EQ(20, loadExternalImage(filB)); // Hit
+	s = cacheStats();
+	EXPECT_EQ(4u, s.misses-s0.misses);
+	EXPECT_EQ(2u, s.hits-s0.hits);
+	EXPECT_EQ(30, loadExternalImage(filC)); // Miss
+	EXPECT_EQ(5u, cacheStats().misses-s0.misses);
+
+	// Shrinking the budget evicts the least recently used images:
+	CImage::setExternalImagesCacheSize(img_bytes);
+	EXPECT_EQ(1u, cacheStats().num_images);
+	EXPECT_EQ(30, loadExternalImage(filC)); // Hit
+	EXPECT_EQ(3u, cacheStats().hits-s0.hits);
+
+	// Images larger than the whole cache are not kept:
+	CImage::setExternalImagesCacheSize(img_bytes/2);
+	EXPECT_EQ(0u, cacheStats().num_images);
+	EXPECT_EQ(30, loadExternalImage(filC));
+	EXPECT_EQ(0u, cacheStats().num_images);
+
+	CImage::clearExternalImagesCache();
+	CImage::setExternalImagesCacheSize(0);
+	deleteFile(filA); deleteFile(filB); deleteFile(filC);
+}
+
+TEST(CImage, ExternalImagesCacheInvalidatedByFileChanges)
+{
+	CImage::clearExternalImagesCache();
+	CImage::setExternalImagesCacheSize(16*1024*1024);
+	const CImage::TExternalImagesCacheStats s0 = cacheStats();
+
+	const string fil = createTestImageFile(10);
+	EXPECT_EQ(10, loadExternalImage(fil));
+	EXPECT_EQ(10, loadExternalImage(fil));
+	EXPECT_EQ(1u, cacheStats().hits-s0.hits);
+
+	// Same file size, only the modification time changes (moved forward, in case the clock granularity is too coarse):
+	const time_t t_old = getFileModificationTime(fil);
+	{
+		CImage img(64,48,CH_RGB);
+		img.filledRectangle(0,0,63,47,TColor(99,99,99));
+		img.saveToFile(fil);
+	}
+	struct utimbuf times;
+	times.actime = times.modtime = t_old+10;
+	ASSERT_EQ(0, utime(fil.c_str(),&times));
+
+	EXPECT_EQ(99, loadExternalImage(fil));
+	EXPECT_EQ(1u, cacheStats().hits-s0.hits);
+	EXPECT_EQ(2u, cacheStats().misses-s0.misses);
+	EXPECT_EQ(99, loadExternalImage(fil));
+	EXPECT_EQ(2u, cacheStats().hits-s0.hits);
+	EXPECT_EQ(1u, cacheStats().num_images);
+
+	CImage::clearExternalImagesCache();
+	CImage::setExternalImagesCacheSize(0);
+	deleteFile(fil);
+}
+
+TEST(CImage, ExternalImagesCachePrefetchThenHit)
+{
+	CImage::clearExternalImagesCache();
+	CImage::setExternalImagesCacheSize(16*1024*1024);
+	const CImage::TExternalImagesCacheStats s0 = cacheStats();
+
+	const string fil = createTestImageFile(42);
+	CImage img;
+	img.setExternalStorage(fil);
+	img.prefetch();
+
+	// Wait for the worker thread to decode it:
+	for (int i=0;i<500 && cacheStats().prefetched==s0.prefetched;i++)
+		mrpt::system::sleep(10);
+	ASSERT_EQ(1u, cacheStats().prefetched-s0.prefetched);
+	EXPECT_EQ(1u, cacheStats().num_images);
+
+	img.forceLoad();
+	EXPECT_EQ(42, *img(0,0,0));
+	EXPECT_EQ(1u, cacheStats().hits-s0.hits);
+	EXPECT_EQ(0u, cacheStats().misses-s0.misses);
+
+	// Already cached: nothing else to prefetch
+	img.unload();
+	img.prefetch();
+	CImage img2;
+	img2.copyFromForceLoad(img);
+	EXPECT_FALSE(img2.isExternallyStored());
+	EXPECT_EQ(42, *img2(0,0,0));
+	EXPECT_EQ(1u, cacheStats().prefetched-s0.prefetched);
+	EXPECT_EQ(2u, cacheStats().hits-s0.hits);
+
+	CImage::clearExternalImagesCache();
+	CImage::setExternalImagesCacheSize(0);
+	deleteFile(fil);
+}
+
+#endif
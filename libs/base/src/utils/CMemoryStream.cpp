@@ -130,6 +130,19 @@ size_t CMemoryStream::Read(void *Buffer, size_t Count)
 	return nToRead;
 }
 
+/*---------------------------------------------------------------
+						ReadBufferInPlace
+ ---------------------------------------------------------------*/
+const void* CMemoryStream::ReadBufferInPlace(size_t Count)
+{
+	if (!m_memory.get() || m_position+Count>m_size)
+		return NULL;
+
+	const void *ptr = ((const char*)m_memory.get()) + m_position;
+	m_position+=Count;
+	return ptr;
+}
+
 /*---------------------------------------------------------------
 							Write
 			Writes a block of bytes to the stream.
@@ -125,6 +125,53 @@ TEST(SerializeTestBase, WriteReadToMem)
 	}
 }
 
+// Objects written with the class ID dictionary, mixed with regular ones, must be read back:
+TEST(SerializeTestBase, ClassIDDictionary)
+{
+	CMemoryStream  buf;
+	buf << CPose2D(1,2,3); // Regular header
+	buf.enableClassIDDictionary();
+	uint64_t pos_second = 0;
+	for (int i=0;i<10;i++)
+	{
+		if (i==1) pos_second = buf.getPosition();
+		buf << CPose2D(i,0,0) << CPose3D(0,i,0,0,0,0);
+	}
+	const uint64_t len_dict = buf.getTotalBytesCount();
+	buf.enableClassIDDictionary(false);
+	buf << CPose3D(7,8,9,0,0,0);
+
+	// The class names were only written once:
+	CMemoryStream  buf_plain;
+	for (int i=0;i<10;i++)
+		buf_plain << CPose2D(i,0,0) << CPose3D(0,i,0,0,0,0);
+	EXPECT_LT(len_dict, buf_plain.getTotalBytesCount());
+
+	buf.Seek(0);
+	CPose2D p2;
+	buf >> p2;
+	EXPECT_EQ(p2, CPose2D(1,2,3));
+	for (int i=0;i<10;i++)
+	{
+		CSerializablePtr o;
+		buf >> o;
+		ASSERT_TRUE(IS_CLASS(o,CPose2D));
+		EXPECT_EQ(CPose2DPtr(o)->x(), i);
+		CPose3D p3;
+		buf >> p3; // Into an existing object
+		EXPECT_EQ(p3.y(), i);
+	}
+	CPose3D p3;
+	buf >> p3;
+	EXPECT_EQ(p3.x(), 7);
+
+	// A reader starting after the definition of the IDs cannot know them:
+	buf.resetClassIDDictionary();
+	buf.Seek(pos_second);
+	CSerializablePtr o;
+	EXPECT_THROW(buf >> o, std::exception);
+}
+
 // Create a set of classes, then test that copy operators "work" (doesn't crash)
 TEST(SerializeTestBase, CopyOperator)
 {
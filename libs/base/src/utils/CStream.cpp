@@ -25,6 +25,11 @@
 // 8 bits:
 #define SERIALIZATION_END_FLAG  0x88
 
+// Headers of objects written with the class ID dictionary (see CStream::enableClassIDDictionary()).
+// Regular headers have the MSB set plus the class name length (<=120), so these values never collide with them:
+#define SERIALIZATION_CLASSID_DEF_FLAG  0xFE  // Followed by: uint16 ID, uint8 name length, name
+#define SERIALIZATION_CLASSID_REF_FLAG  0xFF  // Followed by: uint16 ID
+
 using namespace mrpt;
 using namespace mrpt::utils;
 using namespace mrpt::system;
@@ -172,12 +177,34 @@ void CStream::WriteObject(const  CSerializable *o )
 	int		version;
 
 	// First, the "classname".
- 	const char *className = o->GetRuntimeClass()->className;
+	const TRuntimeClassId *classId = o->GetRuntimeClass();
+ 	const char *className = classId->className;
 	int8_t  classNamLen = strlen(className);
-	int8_t  classNamLen_mod = classNamLen | 0x80;
 
-	(*this) << classNamLen_mod;
-	this->WriteBuffer( className, classNamLen);
+	// With the class dictionary, the name only goes with the first object of each class:
+	size_t dictId = m_class_dict_write.size();
+	if (m_class_dict_enabled)
+	{
+		for (size_t i=0;i<m_class_dict_write.size();i++)
+			if (m_class_dict_write[i]==classId) { dictId = i; break; }
+	}
+
+	if (m_class_dict_enabled && dictId<m_class_dict_write.size())
+	{
+		(*this) << static_cast<uint8_t>(SERIALIZATION_CLASSID_REF_FLAG) << static_cast<uint16_t>(dictId);
+	}
+	else if (m_class_dict_enabled && dictId<0xFFFF)
+	{
+		m_class_dict_write.push_back(classId);
+		(*this) << static_cast<uint8_t>(SERIALIZATION_CLASSID_DEF_FLAG) << static_cast<uint16_t>(dictId) << static_cast<uint8_t>(classNamLen);
+		this->WriteBuffer( className, classNamLen);
+	}
+	else
+	{
+		int8_t  classNamLen_mod = classNamLen | 0x80;
+		(*this) << classNamLen_mod;
+		this->WriteBuffer( className, classNamLen);
+	}
 
 	// Next, the version number:
 	o->writeToStream(*this, &version);
@@ -355,7 +382,8 @@ CSerializable* CStream::internal_ReadObject(CSerializable *existingObj)
 	registerAllPendingClasses();
 
 	// First, read the class name:
-	uint8_t lengthReadClassName = 255;
+	uint8_t lengthReadClassName = 0;
+	bool    headerRead = false;  // Tells an EOF before the object from an error within it
 	bool    isOldFormat=false;   // < MRPT 0.5.5
 	char    readClassName[260];
 	readClassName[0] = 0;
@@ -365,27 +393,60 @@ CSerializable* CStream::internal_ReadObject(CSerializable *existingObj)
 		// First, read the class name: (exception is raised here if ZERO bytes read -> possibly an EOF)
 		if (sizeof(lengthReadClassName) != ReadBuffer( (void*)&lengthReadClassName, sizeof(lengthReadClassName) ) )
 			THROW_EXCEPTION("Cannot read object header from stream! (EOF?)");
+		headerRead = true;
 
-		// Is in old format (< MRPT 0.5.5)?
-		if (! (lengthReadClassName & 0x80 ))
+		// Class known by its ID in the class dictionary? (MRPT >=1.5.0)
+		const TRuntimeClassId *classId = NULL;
+		if (lengthReadClassName==SERIALIZATION_CLASSID_DEF_FLAG || lengthReadClassName==SERIALIZATION_CLASSID_REF_FLAG)
 		{
-			isOldFormat = true;
-			uint8_t buf[3];
-			if (3 != ReadBuffer( buf, 3 ) ) THROW_EXCEPTION("Cannot read object header from stream! (EOF?)");
-			if (buf[0] || buf[1] || buf[2]) THROW_EXCEPTION("Expecting 0x00 00 00 while parsing old streaming header (Perhaps it's a gz-compressed stream? Use a GZ-stream for reading)");
+			uint16_t dictId;
+			(*this) >> dictId;
+			if (lengthReadClassName==SERIALIZATION_CLASSID_DEF_FLAG)
+			{
+				uint8_t len;
+				(*this) >> len;
+				if (len>120) THROW_EXCEPTION("Class name has more than 120 chars. This probably means a corrupted binary stream.");
+				if (((size_t)len)!=ReadBuffer( readClassName, len ))
+					THROW_EXCEPTION("Cannot read object class name from stream!");
+				readClassName[len]='\0';
+
+				classId = findRegisteredClass( std::string(readClassName) );
+				if (!classId) THROW_EXCEPTION_CUSTOM_MSG1("Stored object has class '%s' which is not registered!",readClassName);
+				if (m_class_dict_read.size()<=dictId)
+					m_class_dict_read.resize(dictId+1, NULL);
+				m_class_dict_read[dictId] = classId;
+			}
+			else
+			{
+				if (dictId>=m_class_dict_read.size() || !m_class_dict_read[dictId])
+					THROW_EXCEPTION_CUSTOM_MSG1("Unknown class ID %u: streams written with a class ID dictionary must be read from their beginning.",static_cast<unsigned int>(dictId));
+				classId = m_class_dict_read[dictId];
+				strcpy(readClassName, classId->className);
+			}
 		}
+		else
+		{
+			// Is in old format (< MRPT 0.5.5)?
+			if (! (lengthReadClassName & 0x80 ))
+			{
+				isOldFormat = true;
+				uint8_t buf[3];
+				if (3 != ReadBuffer( buf, 3 ) ) THROW_EXCEPTION("Cannot read object header from stream! (EOF?)");
+				if (buf[0] || buf[1] || buf[2]) THROW_EXCEPTION("Expecting 0x00 00 00 while parsing old streaming header (Perhaps it's a gz-compressed stream? Use a GZ-stream for reading)");
+			}
 
-		// Remove MSB:
-		lengthReadClassName &= 0x7F;
+			// Remove MSB:
+			lengthReadClassName &= 0x7F;
 
-		// Sensible class name size?
-		if (lengthReadClassName>120)
-			THROW_EXCEPTION("Class name has more than 120 chars. This probably means a corrupted binary stream.");
+			// Sensible class name size?
+			if (lengthReadClassName>120)
+				THROW_EXCEPTION("Class name has more than 120 chars. This probably means a corrupted binary stream.");
 
-		if (((size_t)lengthReadClassName)!=ReadBuffer( readClassName, lengthReadClassName ))
-			THROW_EXCEPTION("Cannot read object class name from stream!");
+			if (((size_t)lengthReadClassName)!=ReadBuffer( readClassName, lengthReadClassName ))
+				THROW_EXCEPTION("Cannot read object class name from stream!");
 
-		readClassName[lengthReadClassName]='\0';
+			readClassName[lengthReadClassName]='\0';
+		}
 
 		// Pass to string class:
 		const std::string strClassName(readClassName);
@@ -418,7 +479,7 @@ CSerializable* CStream::internal_ReadObject(CSerializable *existingObj)
 			// Now, compare to existing class:
 			ASSERT_(existingObj)
 			const TRuntimeClassId	*id  = existingObj->GetRuntimeClass();
-			const TRuntimeClassId	*id2 = findRegisteredClass(strClassName);
+			const TRuntimeClassId	*id2 = classId ? classId : findRegisteredClass(strClassName);
 			if (!id2) THROW_EXCEPTION_CUSTOM_MSG1("Stored object has class '%s' which is not registered!",strClassName.c_str());
 			if ( id!=id2 ) THROW_EXCEPTION(format("Stored class does not match with existing object!!:\n Stored: %s\n Expected: %s", id2->className,id->className ));
 			// It matches, OK
@@ -427,7 +488,8 @@ CSerializable* CStream::internal_ReadObject(CSerializable *existingObj)
 		else
 		{	// (New object)
 			// Get the mapping to the "TRuntimeClassId*" in the registered classes table:
-			const TRuntimeClassId *classId = findRegisteredClass( strClassName );
+			if (!classId)
+				classId = findRegisteredClass( strClassName );
 			if (!classId)
 			{
 				const std::string msg = format("Class '%s' is not registered! Have you called mrpt::registerClass(CLASS)?",readClassName);
@@ -456,7 +518,7 @@ CSerializable* CStream::internal_ReadObject(CSerializable *existingObj)
 	}
 	catch(std::exception &e)
 	{
-		if (lengthReadClassName==255) {
+		if (!headerRead) {
 			THROW_TYPED_EXCEPTION("Cannot read object due to EOF", CExceptionEOF);
 		}
 		else {
@@ -12,8 +12,26 @@
 #include <mrpt/utils/CTimeLogger.h>
 #include <mrpt/utils/CFileOutputStream.h>
 #include <mrpt/system/string_utils.h>
+#include <mrpt/system/threads.h>
+#include <mrpt/synch/CCriticalSection.h>
+#include <mrpt/synch/atomic_incr.h>
 
 #include <iostream>
+#include <algorithm>
+
+#ifdef MRPT_OS_WINDOWS
+#	include <windows.h>
+#else
+#	include <time.h>
+#	include <sys/time.h>
+#endif
+
+// Thread-local storage:
+#if defined(_MSC_VER)
+#	define MRPT_TRACE_TLS  __declspec(thread)
+#else
+#	define MRPT_TRACE_TLS  __thread
+#endif
 
 using namespace mrpt;
 using namespace mrpt::utils;
@@ -22,6 +40,165 @@ using namespace std;
 
 CTimeLogger mrpt::utils::global_profiler;
 
+namespace
+{
+	/** A monotonic timestamp, in seconds. Unlike CTicTac::Tac(), it can be called from several threads. */
+	inline double traceNow()
+	{
+#ifdef MRPT_OS_WINDOWS
+		static LARGE_INTEGER freq = {0};
+		if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+		LARGE_INTEGER t;
+		QueryPerformanceCounter(&t);
+		return t.QuadPart/static_cast<double>(freq.QuadPart);
+#elif defined(CLOCK_MONOTONIC)
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec + 1e-9*ts.tv_nsec;
+#else
+		struct timeval tv;
+		gettimeofday(&tv, NULL);
+		return tv.tv_sec + 1e-6*tv.tv_usec;
+#endif
+	}
+
+	struct TTraceEvent
+	{
+		const char *name;
+		double      t;        //!< Seconds since the tracing started
+		bool        is_enter;
+	};
+
+	/** The events of one thread. Only that thread writes to it. */
+	struct TTraceThreadBuffer
+	{
+		TTraceThreadBuffer(unsigned long id, size_t capacity) : thread_id(id), events(capacity), n_events(0), n_reused(0), skip_depth(0), sample_count(0)
+		{
+			open_calls.reserve(64);
+		}
+
+		unsigned long              thread_id;
+		std::vector<TTraceEvent>   events;
+		volatile size_t            n_events;    //!< Total recorded events (it may exceed the capacity in ring buffer mode)
+		volatile size_t            n_reused;    //!< In ring buffer mode, 1 + the index of the last event whose slot started being reused (events < n_reused-capacity are lost)
+		std::vector<double>        open_calls;  //!< Start time of the open sections (for the return value of leave())
+		size_t                     skip_depth;  //!< >0 while inside an outermost section discarded by sampling
+		unsigned int               sample_count;
+	};
+
+	/** A section found in the trace events, with its start time and duration */
+	struct TTraceSection
+	{
+		unsigned long thread_id;
+		const char   *name;
+		double        t, duration;
+	};
+
+	volatile size_t trace_uid_counter = 0;
+	size_t newTraceUID()
+	{
+		size_t v;
+		do {
+			v = mrpt::synch::atomic_load_acquire(&trace_uid_counter);
+		} while (!mrpt::synch::atomic_compare_exchange(&trace_uid_counter, v, v+1));
+		return v+1;
+	}
+
+	// Cache of the buffers of the current thread, to avoid any lock in the fast path:
+	const size_t TLS_CACHE_SIZE = 4;
+	MRPT_TRACE_TLS size_t               tls_trace_uid[TLS_CACHE_SIZE] = {0,0,0,0};
+	MRPT_TRACE_TLS TTraceThreadBuffer  *tls_trace_buf[TLS_CACHE_SIZE] = {NULL,NULL,NULL,NULL};
+	MRPT_TRACE_TLS unsigned int         tls_trace_next = 0;
+}
+
+struct CTimeLogger::TTraceData
+{
+	TTraceData(size_t capacity, bool ring) : uid(newTraceUID()), capacity(capacity>0 ? capacity:1), ring_buffer(ring), t0(traceNow()) { }
+	~TTraceData()
+	{
+		for (size_t i=0;i<buffers.size();i++)
+			delete buffers[i];
+	}
+
+	const size_t  uid;  //!< Unique among all the tracing sessions of all the loggers (the key in the thread-local cache)
+	const size_t  capacity;
+	const bool    ring_buffer;
+	const double  t0;
+	mutable mrpt::synch::CCriticalSection  cs;  //!< Protects `buffers`
+	std::vector<TTraceThreadBuffer*>   buffers; //!< One per thread
+
+	TTraceThreadBuffer & threadBuffer()
+	{
+		for (size_t i=0;i<TLS_CACHE_SIZE;i++)
+			if (tls_trace_uid[i]==uid)
+				return *tls_trace_buf[i];
+
+		// First time in this thread (or evicted from the cache):
+		const unsigned long thread_id = mrpt::system::getCurrentThreadId();
+		TTraceThreadBuffer *buf = NULL;
+		{
+			mrpt::synch::CCriticalSectionLocker lock(&cs);
+			for (size_t i=0;i<buffers.size() && !buf;i++)
+				if (buffers[i]->thread_id==thread_id)
+					buf = buffers[i];
+			if (!buf)
+			{
+				buf = new TTraceThreadBuffer(thread_id, capacity);
+				buffers.push_back(buf);
+			}
+		}
+		const unsigned int k = (tls_trace_next++) % TLS_CACHE_SIZE;
+		tls_trace_uid[k] = uid;
+		tls_trace_buf[k] = buf;
+		return *buf;
+	}
+
+	/** Matches the enter/leave events of each thread (events whose counterpart was dropped or overwritten are ignored).
+	  * It can be called while the other threads keep tracing: their events are copied first, and those whose slot
+	  * of the ring buffer might have been reused meanwhile are discarded. */
+	void getSections(std::vector<TTraceSection> &out) const
+	{
+		out.clear();
+		mrpt::synch::CCriticalSectionLocker lock(&cs);
+		std::vector<std::pair<const char*,double> > stack;
+		std::vector<TTraceEvent> evs;
+		for (size_t b=0;b<buffers.size();b++)
+		{
+			const TTraceThreadBuffer &buf = *buffers[b];
+			// The writer publishes n_events (release) after filling the event, so [first_copied,n) are complete:
+			const size_t n = mrpt::synch::atomic_load_acquire(&buf.n_events);
+			const size_t first_copied = n>capacity ? n-capacity : 0;
+			evs.resize(n-first_copied);
+			for (size_t i=first_copied;i<n;i++)
+				evs[i-first_copied] = buf.events[i % capacity];
+
+			// Meanwhile, the writer may have wrapped around and overwritten some of the oldest copied events:
+			mrpt::synch::atomic_memory_barrier();
+			const size_t n_reused = mrpt::synch::atomic_load_acquire(&buf.n_reused);
+			const size_t first_valid = n_reused>capacity ? n_reused-capacity : 0;
+			const size_t first = std::min(std::max(first_copied,first_valid),n);
+
+			stack.clear();
+			for (size_t i=first;i<n;i++)
+			{
+				const TTraceEvent &ev = evs[i-first_copied];
+				if (ev.is_enter)
+					stack.push_back(std::make_pair(ev.name,ev.t));
+				else if (!stack.empty())
+				{
+					TTraceSection sec;
+					sec.thread_id = buf.thread_id;
+					sec.name      = stack.back().first;
+					sec.t         = stack.back().second;
+					sec.duration  = ev.t - sec.t;
+					out.push_back(sec);
+					stack.pop_back();
+				}
+			}
+		}
+	}
+};
+
 namespace mrpt
 {
 	namespace utils
@@ -39,7 +216,9 @@ CTimeLogger::CTimeLogger(bool enabled/*=true*/, const std::string& name/*=""*/)
 	COutputLogger("CTimeLogger"),
 	m_tictac(),
 	m_enabled(enabled),
-	m_name(name)
+	m_name(name),
+	m_trace(NULL),
+	m_trace_sampling(1)
 {
 	m_tictac.Tic();
 }
@@ -47,8 +226,9 @@ CTimeLogger::CTimeLogger(bool enabled/*=true*/, const std::string& name/*=""*/)
 CTimeLogger::~CTimeLogger()
 {
 	// Dump all stats:
-    if (!m_data.empty()) // If logging is disabled, do nothing...
-        dumpAllStats();
+	if (!m_data.empty() || m_trace) // If logging is disabled, do nothing...
+		dumpAllStats();
+	delete m_trace;
 }
 
 void CTimeLogger::clear(bool deep_clear)
@@ -60,6 +240,89 @@ void CTimeLogger::clear(bool deep_clear)
 		for (map<string,TCallData>::iterator i=m_data.begin();i!=m_data.end();++i)
 			i->second = TCallData();
 	}
+	if (m_trace)
+	{
+		mrpt::synch::CCriticalSectionLocker lock(&m_trace->cs);
+		for (size_t i=0;i<m_trace->buffers.size();i++)
+		{
+			mrpt::synch::atomic_store_release(&m_trace->buffers[i]->n_events, 0);
+			mrpt::synch::atomic_store_release(&m_trace->buffers[i]->n_reused, 0);
+			m_trace->buffers[i]->open_calls.clear();
+			m_trace->buffers[i]->skip_depth = 0;
+		}
+	}
+}
+
+void CTimeLogger::enableTracing(bool enable, size_t max_events_per_thread, bool ring_buffer)
+{
+	delete m_trace;
+	m_trace = enable ? new TTraceData(max_events_per_thread, ring_buffer) : NULL;
+}
+
+void CTimeLogger::getAllCallData(std::map<std::string,TCallData> &out_data) const
+{
+	out_data = m_data;
+	if (!m_trace) return;
+
+	std::vector<TTraceSection> secs;
+	m_trace->getSections(secs);
+
+	// Group by the section name address first, to create each std::string only once:
+	std::map<const char*,TCallData*> by_ptr;
+	for (size_t i=0;i<secs.size();i++)
+	{
+		TCallData *&pd = by_ptr[secs[i].name];
+		if (!pd) pd = &out_data[std::string(secs[i].name)];
+		TCallData &d = *pd;
+		const double At = secs[i].duration;
+		d.mean_t+=At;
+		if (++d.n_calls==1)
+		{
+			d.min_t= At;
+			d.max_t= At;
+		}
+		else
+		{
+			mrpt::utils::keep_min( d.min_t, At);
+			mrpt::utils::keep_max( d.max_t, At);
+		}
+	}
+}
+
+bool CTimeLogger::saveToChromeTraceFile(const std::string &json_file) const
+{
+	if (!m_trace) return false;
+
+	std::vector<TTraceSection> secs;
+	m_trace->getSections(secs);
+
+	CFileOutputStream f;
+	if (!f.open(json_file)) return false;
+
+	// Escapes a string for JSON:
+	std::map<const char*,std::string> names;
+	for (size_t i=0;i<secs.size();i++)
+	{
+		std::string &s = names[secs[i].name];
+		if (!s.empty()) continue;
+		for (const char *c=secs[i].name;*c;c++)
+		{
+			if (*c=='"' || *c=='\\') s+='\\';
+			if (static_cast<unsigned char>(*c)>=0x20) s+=*c;
+		}
+	}
+
+	f.printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	f.printf("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"%s\"}}", m_name.empty() ? "CTimeLogger" : m_name.c_str());
+	for (size_t i=0;i<secs.size();i++)
+	{
+		// Timestamps in microseconds:
+		f.printf(",\n{\"name\":\"%s\",\"cat\":\"mrpt\",\"ph\":\"X\",\"pid\":0,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}",
+			names[secs[i].name].c_str(), secs[i].thread_id,
+			1e6*(secs[i].t - m_trace->t0), 1e6*secs[i].duration);
+	}
+	f.printf("\n]}\n");
+	return true;
 }
 
 std::string  aux_format_string_multilines(const std::string &s, const size_t len)
@@ -77,8 +340,11 @@ std::string  aux_format_string_multilines(const std::string &s, const size_t len
 
 void CTimeLogger::getStats(std::map<std::string,TCallStats> &out_stats) const
 {
+	std::map<std::string,TCallData> data;
+	getAllCallData(data);
+
 	out_stats.clear();
-	for (map<string,TCallData>::const_iterator i=m_data.begin();i!=m_data.end();++i)
+	for (map<string,TCallData>::const_iterator i=data.begin();i!=data.end();++i)
 	{
 		TCallStats &cs = out_stats[i->first];
 		cs.min_t   = i->second.min_t;
@@ -114,8 +380,11 @@ std::string CTimeLogger::getStatsAsText(const size_t column_width)  const
 	stats_text += middle_header + "\n";
 	stats_text += bottom_header + "\n";
 
+	std::map<std::string,TCallData> data;
+	getAllCallData(data);
+
 	// for all the timed sections
-	for (map<string,TCallData>::const_iterator i=m_data.begin();i!=m_data.end();++i)
+	for (map<string,TCallData>::const_iterator i=data.begin();i!=data.end();++i)
 	{
 		const string sMinT   = unitsFormat(i->second.min_t,1,false);
 		const string sMaxT   = unitsFormat(i->second.max_t,1,false);
@@ -139,9 +408,12 @@ std::string CTimeLogger::getStatsAsText(const size_t column_width)  const
 
 void CTimeLogger::saveToCSVFile(const std::string &csv_file)  const
 {
+	std::map<std::string,TCallData> data;
+	getAllCallData(data);
+
 	std::string s;
 	s+="FUNCTION, #CALLS, MIN.T, MEAN.T, MAX.T, TOTAL.T\n";
-	for (map<string,TCallData>::const_iterator i=m_data.begin();i!=m_data.end();++i)
+	for (map<string,TCallData>::const_iterator i=data.begin();i!=data.end();++i)
 	{
 		s+=format("\"%s\",\"%7u\",\"%e\",\"%e\",\"%e\",\"%e\"\n",
 			i->first.c_str(),
@@ -161,6 +433,12 @@ void CTimeLogger::dumpAllStats(const size_t  column_width) const
 
 void CTimeLogger::do_enter(const char *func_name)
 {
+	if (m_trace)
+	{
+		do_trace(func_name,true);
+		return;
+	}
+
 	const string  s = func_name;
 	TCallData &d = m_data[s];
 
@@ -169,8 +447,66 @@ void CTimeLogger::do_enter(const char *func_name)
 	d.open_calls.top() = m_tictac.Tac(); // to avoid possible delays.
 }
 
+double CTimeLogger::do_trace(const char *func_name, bool is_enter)
+{
+	TTraceThreadBuffer &b = m_trace->threadBuffer();
+	if (is_enter)
+	{
+		// Inside a section discarded by sampling?
+		if (b.skip_depth>0 || (b.open_calls.empty() && m_trace_sampling>1 && (b.sample_count++ % m_trace_sampling)!=0))
+		{
+			b.skip_depth++;
+			return 0;
+		}
+	}
+	else
+	{
+		if (b.skip_depth>0)
+		{
+			b.skip_depth--;
+			return 0;
+		}
+		if (b.open_calls.empty())
+			return 0; // This shouldn't happen!
+	}
+
+	const double t = traceNow() - m_trace->t0;
+
+	const size_t n = b.n_events;
+	if (n<m_trace->capacity || m_trace->ring_buffer)
+	{
+		if (n>=m_trace->capacity)
+		{
+			// Tell getSections() that the slot of the event #n-capacity is about to be overwritten:
+			mrpt::synch::atomic_store_release(&b.n_reused, n+1);
+			mrpt::synch::atomic_memory_barrier();
+		}
+		TTraceEvent &ev = b.events[n % m_trace->capacity];
+		ev.name = func_name;
+		ev.t = t;
+		ev.is_enter = is_enter;
+		mrpt::synch::atomic_store_release(&b.n_events, n+1);
+	}
+	// else: Buffer full, drop the event
+
+	if (is_enter)
+	{
+		b.open_calls.push_back(t);
+		return 0;
+	}
+	else
+	{
+		const double At = t - b.open_calls.back();
+		b.open_calls.pop_back();
+		return At;
+	}
+}
+
 double CTimeLogger::do_leave(const char *func_name)
 {
+	if (m_trace)
+		return do_trace(func_name,false);
+
 	const double tim = m_tictac.Tac();
 
 	const string  s = func_name;
@@ -228,8 +564,12 @@ CTimeLogger::TCallData::TCallData() :
 
 double CTimeLogger::getMeanTime(const std::string &name)  const
 {
-	map<string,TCallData>::const_iterator it = m_data.find(name);
-	if (it==m_data.end())
+	std::map<std::string,TCallData> data;
+	if (m_trace) getAllCallData(data);
+	const std::map<std::string,TCallData> &d = m_trace ? data : m_data;
+
+	map<string,TCallData>::const_iterator it = d.find(name);
+	if (it==d.end())
 		 return 0;
 	else return it->second.n_calls ? it->second.mean_t/it->second.n_calls : 0;
 }
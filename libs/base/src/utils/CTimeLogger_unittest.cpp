@@ -0,0 +1,131 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/utils/CTimeLogger.h>
+#include <mrpt/system/threads.h>
+#include <mrpt/system/filesystem.h>
+#include <mrpt/system/vector_loadsave.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::utils;
+using namespace mrpt::system;
+using namespace std;
+
+namespace
+{
+	CTimeLogger *test_logger = NULL;
+
+	void test_traced_thread(int n)
+	{
+		for (int i=0;i<n;i++)
+		{
+			CTimeLoggerEntry tle(*test_logger,"outer");
+			CTimeLoggerEntry tle2(*test_logger,"inner");
+		}
+	}
+
+	volatile bool test_stop_tracing = false;
+	void test_traced_thread_until_stop(int)
+	{
+		while (!test_stop_tracing)
+			test_traced_thread(10);
+	}
+}
+
+TEST(CTimeLogger, tracingFromSeveralThreads)
+{
+	CTimeLogger tl(true);
+	tl.setMinLoggingLevel(LVL_ERROR); // Don't dump the stats at destruction
+	tl.enableTracing(true, 1000);
+	test_logger = &tl;
+
+	TThreadHandle th[3];
+	for (int k=0;k<3;k++)
+		th[k] = createThread(&test_traced_thread, 100);
+	test_traced_thread(100);
+	for (int k=0;k<3;k++)
+		joinThread(th[k]);
+
+	std::map<std::string,CTimeLogger::TCallStats> stats;
+	tl.getStats(stats);
+	EXPECT_EQ(400u, stats["outer"].n_calls);
+	EXPECT_EQ(400u, stats["inner"].n_calls);
+	EXPECT_GE(stats["outer"].total_t, stats["inner"].total_t);
+
+	const string fil = getTempFileName();
+	EXPECT_TRUE(tl.saveToChromeTraceFile(fil));
+	vector_byte buf;
+	ASSERT_TRUE(loadBinaryFile(buf, fil));
+	const std::string json(buf.begin(),buf.end());
+	EXPECT_EQ(0u, json.find("{\"displayTimeUnit\""));
+	size_t n_events = 0;
+	for (size_t p=json.find("\"ph\":\"X\"");p!=std::string::npos;p=json.find("\"ph\":\"X\"",p+1))
+		n_events++;
+	EXPECT_EQ(800u, n_events);
+	deleteFile(fil);
+}
+
+TEST(CTimeLogger, tracingRingBufferAndSampling)
+{
+	CTimeLogger tl(true);
+	tl.setMinLoggingLevel(LVL_ERROR);
+	test_logger = &tl;
+
+	// Ring buffer: only the last 10 events (=5 pairs) are kept:
+	tl.enableTracing(true, 10, true);
+	for (int i=0;i<50;i++)
+	{
+		tl.enter("x");
+		tl.leave("x");
+	}
+	std::map<std::string,CTimeLogger::TCallStats> stats;
+	tl.getStats(stats);
+	EXPECT_EQ(5u, stats["x"].n_calls);
+
+	// Not a ring buffer: the first 10 events are kept (the 3rd outer/inner pairs are incomplete):
+	tl.enableTracing(true, 10, false);
+	test_traced_thread(50);
+	tl.getStats(stats);
+	EXPECT_EQ(2u, stats["outer"].n_calls);
+	EXPECT_EQ(2u, stats["inner"].n_calls);
+
+	// Sampling: nested sections are always recorded along with their outer section:
+	tl.enableTracing(true, 1000);
+	tl.setTracingSampling(4);
+	test_traced_thread(100);
+	tl.getStats(stats);
+	EXPECT_EQ(25u, stats["outer"].n_calls);
+	EXPECT_EQ(25u, stats["inner"].n_calls);
+}
+
+TEST(CTimeLogger, tracingRingBufferReadWhileWriting)
+{
+	CTimeLogger tl(true);
+	tl.setMinLoggingLevel(LVL_ERROR);
+	test_logger = &tl;
+	tl.enableTracing(true, 16, true);
+
+	// The stats can be read while another thread keeps overwriting its ring buffer:
+	test_stop_tracing = false;
+	TThreadHandle th = createThread(&test_traced_thread_until_stop, 0);
+	for (int i=0;i<2000;i++)
+	{
+		std::map<std::string,CTimeLogger::TCallStats> stats;
+		tl.getStats(stats);
+		for (std::map<std::string,CTimeLogger::TCallStats>::const_iterator it=stats.begin();it!=stats.end();++it)
+		{
+			EXPECT_TRUE(it->first=="outer" || it->first=="inner") << it->first;
+			EXPECT_LE(it->second.n_calls, 8u);
+			EXPECT_GE(it->second.min_t, 0.0);
+		}
+	}
+	test_stop_tracing = true;
+	joinThread(th);
+}
@@ -41,7 +41,8 @@ namespace mrpt
 			kfEKFNaive = 0,
 			kfEKFAlaDavison,
 			kfIKFFull,
-			kfIKF
+			kfIKF,
+			kfCEKF    //!< Compressed EKF: updates are restricted to the "active area" of the map, see CKalmanFilterCapable::applyGlobalUpdate()
 		};
 
 		// Forward declaration:
@@ -60,7 +61,8 @@ namespace mrpt
 				use_analytic_transition_jacobian	(true),
 				use_analytic_observation_jacobian	(true),
 				debug_verify_analytic_jacobians		(false),
-				debug_verify_analytic_jacobians_threshold	(1e-2)
+				debug_verify_analytic_jacobians_threshold	(1e-2),
+				CEKF_max_active_landmarks (50)
 			{
 			}
 
@@ -74,6 +76,7 @@ namespace mrpt
 				MRPT_LOAD_CONFIG_VAR( use_analytic_observation_jacobian, bool    , iniFile, section  );
 				MRPT_LOAD_CONFIG_VAR( debug_verify_analytic_jacobians, bool    , iniFile, section  );
 				MRPT_LOAD_CONFIG_VAR( debug_verify_analytic_jacobians_threshold, double, iniFile, section );
+				MRPT_LOAD_CONFIG_VAR( CEKF_max_active_landmarks, int, iniFile, section );
 			}
 
 			/** This method must display clearly all the contents of the structure in textual form, sending it to a CStream. */
@@ -84,6 +87,7 @@ namespace mrpt
 				out.printf("verbosity_level                         = %s\n", mrpt::utils::TEnumType<mrpt::utils::VerbosityLevel>::value2name(verbosity_level).c_str());
 				out.printf("IKF_iterations                          = %i\n", IKF_iterations);
 				out.printf("enable_profiler                         = %c\n", enable_profiler ? 'Y':'N');
+				out.printf("CEKF_max_active_landmarks               = %i\n", CEKF_max_active_landmarks);
 				out.printf("\n");
 			}
 
@@ -96,6 +100,7 @@ namespace mrpt
 			bool		use_analytic_observation_jacobian;	//!< (default=true) If true, OnObservationJacobians will be called; otherwise, the Jacobian will be estimated from a numeric approximation by calling several times to OnObservationModel.
 			bool		debug_verify_analytic_jacobians; //!< (default=false) If true, will compute all the Jacobians numerically and compare them to the analytical ones, throwing an exception on mismatch.
 			double		debug_verify_analytic_jacobians_threshold; //!< (default-1e-2) Sets the threshold for the difference between the analytic and the numerical jacobians
+			int 		CEKF_max_active_landmarks; //!< (default=50) Only for kfCEKF: when the active area grows beyond this number of landmarks, a global update is done and only the half most recently observed ones are kept active.
 		};
 
 		/** Auxiliary functions, for internal usage of MRPT classes */
@@ -126,6 +131,14 @@ namespace mrpt
 				const typename CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,0 /* FEAT_SIZE=0 */,ACT_SIZE,KFTYPE>::vector_KFArray_OBS & Z,
 				const vector_int       &data_association,
 				const typename CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,0 /* FEAT_SIZE=0 */,ACT_SIZE,KFTYPE>::KFMatrix_OxO		&R);
+
+			/** Sorts landmark indices from the most to the least recently observed (used in kfCEKF) */
+			struct TCEKFLastSeenCmp
+			{
+				const std::vector<size_t> &last_seen;
+				TCEKFLastSeenCmp(const std::vector<size_t> &_last_seen) : last_seen(_last_seen) {}
+				bool operator()(size_t a, size_t b) const { return last_seen[a]>last_seen[b]; }
+			};
 		}
 
 
@@ -211,9 +224,31 @@ namespace mrpt
 			  * \exception std::exception On idx>= getNumberOfLandmarksInTheMap()
 			  */
 			inline void getLandmarkCov(size_t idx, KFMatrix_FxF &feat_cov ) const {
-				m_pkk.extractMatrix(VEH_SIZE+idx*FEAT_SIZE,VEH_SIZE+idx*FEAT_SIZE,feat_cov);
+				if (m_cekf_pending && m_cekf_pos_in_active[idx]<0)
+				     CEKF_recoverPassiveLandmarkCov(idx,feat_cov);
+				else m_pkk.extractMatrix(VEH_SIZE+idx*FEAT_SIZE,VEH_SIZE+idx*FEAT_SIZE,feat_cov);
 			}
 
+			/** Returns the full covariance matrix of the state vector.
+			  *  Normally this is just a copy of the internal covariance, but with kfCEKF the cross-covariances between the active area
+			  *  and the rest of the map are only updated on "global updates", so this method computes the up-to-date matrix without
+			  *  modifying the filter state.
+			  * \sa applyGlobalUpdate
+			  */
+			void getFullCovariance(KFMatrix &out_cov) const;
+
+			/** Only for the kfCEKF method: performs the deferred "global update" of the Compressed EKF, so the internal covariance
+			  *  matrix becomes up-to-date for all the map landmarks. Does nothing if there are no pending updates.
+			  *
+			  *  The Compressed EKF (Guivant & Nebot, 2001) splits the map into an "active area" (the vehicle plus the recently observed landmarks)
+			  *  and the rest of the map. Predictions and updates are then O(A^2) with A the size of the active area, while the effect on the
+			  *  rest of the map is accumulated into two auxiliary matrices which are applied (at O(N^2) cost) only when a landmark out of the
+			  *  active area is observed again, or when the active area grows beyond TKF_options::CEKF_max_active_landmarks.
+			  *  The means of all landmarks are always kept up-to-date, and the covariance of landmarks outside of the active area is
+			  *  recovered on-demand for the data association candidates only.
+			  */
+			void applyGlobalUpdate();
+
 		protected:
 			/** @name Kalman filter state
 				@{ */
@@ -454,6 +489,9 @@ namespace mrpt
 			CKalmanFilterCapable() : 
 				mrpt::utils::COutputLogger("CKalmanFilterCapable"),
 				KF_options(this->m_min_verbosity_level),
+				m_cekf_num_active0(0),
+				m_cekf_iteration(0),
+				m_cekf_pending(false),
 				m_user_didnt_implement_jacobian(true) 
 			{} //!< Default constructor
 			virtual ~CKalmanFilterCapable() {}  //!< Destructor
@@ -479,6 +517,30 @@ namespace mrpt
 			KFMatrix 				dh_dx_full_obs;
 			KFMatrix				aux_K_dh_dx;
 
+			/** @name Compressed EKF (kfCEKF) state
+				@{ */
+			std::vector<size_t> m_cekf_active_lms;    //!< Map landmark indices in the active area, in the same order than the landmark rows of m_cekf_Phi
+			std::vector<int>    m_cekf_pos_in_active; //!< For each map landmark, its position in m_cekf_active_lms, or -1 if it's out of the active area.
+			std::vector<size_t> m_cekf_last_seen;     //!< For each map landmark, the iteration when it was last observed.
+			size_t              m_cekf_num_active0;   //!< The number of landmarks in the active area at the last global update (the first ones in m_cekf_active_lms).
+			size_t              m_cekf_iteration;     //!< Counter of KF iterations.
+			bool                m_cekf_pending;       //!< Whether m_pkk has outstanding deferred updates (see applyGlobalUpdate())
+			KFMatrix            m_cekf_Phi;           //!< Current P_AB = Phi * P_AB(last global update)
+			KFMatrix            m_cekf_Psi;           //!< Current P_BB = P_BB(last global update) - P_BA Psi P_AB (both P_AB at the last global update)
+
+			inline size_t CEKF_activeStateIndex(size_t k) const { //!< Index in the state vector of the k'th element of the active area
+				return k<VEH_SIZE ? k : VEH_SIZE + m_cekf_active_lms[(k-VEH_SIZE)/FEAT_SIZE]*FEAT_SIZE + (k-VEH_SIZE)%FEAT_SIZE;
+			}
+			void CEKF_reset();  //!< (Re)starts the CEKF state with all the current landmarks in the active area.
+			void CEKF_globalUpdate(const std::vector<size_t> &new_active_lms); //!< Applies the pending updates and sets a new active area.
+			void CEKF_applyPendingUpdates(KFMatrix &P) const; //!< Applies the pending P_AB,P_BB updates to P (which must be m_pkk or a copy of it)
+			void CEKF_getPassiveCrossCov(size_t lm_idx, KFMatrix &W) const; //!< Gets P_A0,y (at the last global update) for a landmark out of the active area
+			void CEKF_recoverPassiveLandmarkCov(size_t lm_idx, KFMatrix_FxF &cov) const;
+			void CEKF_recoverCovariance(const vector_size_t &lm_idxs, KFMatrix &P) const; //!< Builds the current covariance of [x_v y_i ...] for the given landmarks.
+			void CEKF_update(const vector_int &data_association); //!< The KF update restricted to the active area.
+			void CEKF_appendLandmark(const KFMatrix_FxV &dyn_dxv);  //!< Adds a just-created landmark to the active area
+			/** @} */
+
 		protected:
 
 			/** The main entry point, executes one complete step: prediction + update.
@@ -519,6 +581,7 @@ namespace mrpt
 				m_map.insert(bayes::kfEKFAlaDavison,     "kfEKFAlaDavison");
 				m_map.insert(bayes::kfIKFFull,           "kfIKFFull");
 				m_map.insert(bayes::kfIKF,               "kfIKF");
+				m_map.insert(bayes::kfCEKF,              "kfCEKF");
 			}
 		};
 	} // End of namespace
@@ -42,6 +42,18 @@ namespace mrpt
 			// Sanity check:
 			if (FEAT_SIZE) { ASSERTDEB_( (((m_xkk.size()-VEH_SIZE)/FEAT_SIZE)*FEAT_SIZE)== (m_xkk.size()-VEH_SIZE) ) }
 
+			// Compressed EKF: (re)build its auxiliary state if the map was changed from outside.
+			const bool use_CEKF = (KF_options.method==kfCEKF && FEAT_SIZE>0);
+			if (use_CEKF)
+			{
+				if (m_cekf_pos_in_active.size()!=getNumberOfLandmarksInTheMap() ||
+					m_cekf_Phi.getRowCount()!=VEH_SIZE+FEAT_SIZE*m_cekf_active_lms.size() )
+					CEKF_reset();
+				m_cekf_iteration++;
+			}
+			else if (m_cekf_pending)
+				applyGlobalUpdate(); // The method was changed since the last iteration.
+
 			// =============================================================
 			//  2. PREDICTION OF NEW POSE xv_{k+1|k}
 			// =============================================================
@@ -112,15 +124,24 @@ namespace mrpt
 				// ====================================
 				//  3.2:  All Pxy_i
 				// ====================================
-				// Now, update the cov. of landmarks, if any:
+				// Now, update the cov. of landmarks, if any (in CEKF, only those in the active area):
 				KFMatrix_VxF aux;
-				for (size_t i=0 ; i<N_map ; i++)
+				const size_t N_lms_pred = use_CEKF ? m_cekf_active_lms.size() : N_map;
+				for (size_t k=0 ; k<N_lms_pred ; k++)
 				{
+					const size_t i = use_CEKF ? m_cekf_active_lms[k] : k;
 					aux = dfv_dxv * Eigen::Block<typename KFMatrix::Base,VEH_SIZE,FEAT_SIZE>(m_pkk,0,VEH_SIZE+i*FEAT_SIZE);
 
 					Eigen::Block<typename KFMatrix::Base,VEH_SIZE,FEAT_SIZE>(m_pkk, 0                    , VEH_SIZE+i*FEAT_SIZE) = aux;
 					Eigen::Block<typename KFMatrix::Base,FEAT_SIZE,VEH_SIZE>(m_pkk, VEH_SIZE+i*FEAT_SIZE , 0                   ) = aux.transpose();
 				}
+				if (use_CEKF)
+				{
+					// The cross-covariances vehicle-rest of the map are deferred: P_vB = Phi_v * P_A0B
+					const size_t nA0 = VEH_SIZE+FEAT_SIZE*m_cekf_num_active0;
+					m_cekf_Phi.block(0,0,VEH_SIZE,nA0) = dfv_dxv * m_cekf_Phi.block(0,0,VEH_SIZE,nA0);
+					m_cekf_pending = true;
+				}
 
 				// =============================================================
 				//  4. NOW WE CAN OVERWRITE THE NEW STATE VECTOR
@@ -292,22 +313,28 @@ namespace mrpt
 
 				if ( FEAT_SIZE>0 )
 				{	// SLAM-like problem:
-					const Eigen::Block<const typename KFMatrix::Base,VEH_SIZE,VEH_SIZE>  Px(m_pkk,0,0);  // Covariance of the vehicle pose
+					// In CEKF, the up-to-date covariance of the predicted landmarks is first recovered into Pkk_subset,
+					//  where the i'th predicted landmark is the i'th one after the vehicle.
+					if (use_CEKF)
+						CEKF_recoverCovariance(predictLMidxs, Pkk_subset);
+					const KFMatrix &P = use_CEKF ? Pkk_subset : m_pkk;
+
+					const Eigen::Block<const typename KFMatrix::Base,VEH_SIZE,VEH_SIZE>  Px(P,0,0);  // Covariance of the vehicle pose
 
 					for (size_t i=0;i<N_pred;++i)
 					{
-						const size_t lm_idx_i = predictLMidxs[i];
-						const Eigen::Block<const typename KFMatrix::Base,FEAT_SIZE,VEH_SIZE>   Pxyi_t(m_pkk,VEH_SIZE+lm_idx_i*FEAT_SIZE,0);  // Pxyi^t
+						const size_t lm_idx_i = use_CEKF ? i : predictLMidxs[i];
+						const Eigen::Block<const typename KFMatrix::Base,FEAT_SIZE,VEH_SIZE>   Pxyi_t(P,VEH_SIZE+lm_idx_i*FEAT_SIZE,0);  // Pxyi^t
 
 						// Only do j>=i (upper triangle), since S is symmetric:
 						for (size_t j=i;j<N_pred;++j)
 						{
-							const size_t lm_idx_j = predictLMidxs[j];
+							const size_t lm_idx_j = use_CEKF ? j : predictLMidxs[j];
 							// Sij block:
 							Eigen::Block<typename KFMatrix::Base, OBS_SIZE, OBS_SIZE> Sij(S,OBS_SIZE*i,OBS_SIZE*j);
 
-							const Eigen::Block<const typename KFMatrix::Base,VEH_SIZE,FEAT_SIZE>   Pxyj(m_pkk,0, VEH_SIZE+lm_idx_j*FEAT_SIZE);
-							const Eigen::Block<const typename KFMatrix::Base,FEAT_SIZE,FEAT_SIZE>  Pyiyj(m_pkk,VEH_SIZE+lm_idx_i*FEAT_SIZE,VEH_SIZE+lm_idx_j*FEAT_SIZE);
+							const Eigen::Block<const typename KFMatrix::Base,VEH_SIZE,FEAT_SIZE>   Pxyj(P,0, VEH_SIZE+lm_idx_j*FEAT_SIZE);
+							const Eigen::Block<const typename KFMatrix::Base,FEAT_SIZE,FEAT_SIZE>  Pyiyj(P,VEH_SIZE+lm_idx_i*FEAT_SIZE,VEH_SIZE+lm_idx_j*FEAT_SIZE);
 
 							Sij = Hxs[i] * Px * Hxs[j].transpose()
 								+ Hys[i] * Pxyi_t * Hxs[j].transpose()
@@ -376,7 +403,10 @@ namespace mrpt
 			{
 				m_timLogger.enter("KF:8.update stage");
 
-				switch (KF_options.method)
+				// CEKF in non-SLAM problems is just a plain EKF:
+				const TKFMethod method = (KF_options.method==kfCEKF && !use_CEKF) ? kfEKFNaive : KF_options.method;
+
+				switch (method)
 				{
 					// -----------------------
 					//  FULL KF- METHOD
@@ -400,7 +430,7 @@ namespace mrpt
 						mapIndicesForKFUpdate.size(); // SLAM: # of observed known landmarks
 
 						// Just one, or several update iterations??
-						const size_t nKF_iterations = (KF_options.method==kfEKFNaive) ?  1 : KF_options.IKF_iterations;
+						const size_t nKF_iterations = (method==kfEKFNaive) ?  1 : KF_options.IKF_iterations;
 
 						const KFVector xkk_0 = m_xkk;
 
@@ -972,6 +1002,17 @@ namespace mrpt
 					}
 					break;
 
+					// --------------------------------------------------------------------
+					// - Compressed EKF: update of the active area only
+					// --------------------------------------------------------------------
+				case kfCEKF:
+					{
+						m_timLogger.enter("KF:8.update stage:CEKF");
+						CEKF_update(data_association);
+						m_timLogger.leave("KF:8.update stage:CEKF");
+					}
+					break;
+
 				default:
 					THROW_EXCEPTION("Invalid value of options.KF_method");
 				} // end switch method
@@ -994,6 +1035,17 @@ namespace mrpt
 				m_timLogger.leave("KF:A.add new landmarks");
 			} // end if data_association!=empty
 
+			// CEKF: Shrink the active area if it grew too much, keeping the most recently observed landmarks:
+			if (use_CEKF && m_cekf_active_lms.size()>size_t(std::max(1,KF_options.CEKF_max_active_landmarks)))
+			{
+				m_timLogger.enter("KF:A.CEKF global update");
+				std::vector<size_t> lms = m_cekf_active_lms;
+				std::stable_sort(lms.begin(),lms.end(), detail::TCEKFLastSeenCmp(m_cekf_last_seen) );
+				lms.resize( std::max(1,KF_options.CEKF_max_active_landmarks/2) );
+				CEKF_globalUpdate(lms);
+				m_timLogger.leave("KF:A.CEKF global update");
+			}
+
 			// Post iteration user code:
 			m_timLogger.enter("KF:B.OnPostIteration");
 			OnPostIteration();
@@ -1056,6 +1108,287 @@ namespace mrpt
 		}
 
 
+		template <size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE, typename KFTYPE>
+		void CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,FEAT_SIZE,ACT_SIZE,KFTYPE>::getFullCovariance(KFMatrix &out_cov) const
+		{
+			out_cov = m_pkk;
+			if (m_cekf_pending)
+				CEKF_applyPendingUpdates(out_cov);
+		}
+
+		template <size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE, typename KFTYPE>
+		void CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,FEAT_SIZE,ACT_SIZE,KFTYPE>::applyGlobalUpdate()
+		{
+			if (!m_cekf_pending) return;
+			m_timLogger.enter("KF:CEKF global update");
+			CEKF_globalUpdate(m_cekf_active_lms);
+			m_timLogger.leave("KF:CEKF global update");
+		}
+
+		template <size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE, typename KFTYPE>
+		void CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,FEAT_SIZE,ACT_SIZE,KFTYPE>::CEKF_reset()
+		{
+			const size_t N = getNumberOfLandmarksInTheMap();
+			m_cekf_last_seen.assign(N, m_cekf_iteration);
+			m_cekf_pending = false;
+			CEKF_globalUpdate( mrpt::math::sequenceStdVec<size_t,1>(0,N) );
+		}
+
+		template <size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE, typename KFTYPE>
+		void CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,FEAT_SIZE,ACT_SIZE,KFTYPE>::CEKF_globalUpdate(const std::vector<size_t> &new_active_lms)
+		{
+			if (m_cekf_pending)
+				CEKF_applyPendingUpdates(m_pkk);
+
+			// Now, m_pkk is up-to-date: any set of landmarks can become the new active area:
+			const size_t N = getNumberOfLandmarksInTheMap();
+			m_cekf_active_lms = new_active_lms;
+			m_cekf_pos_in_active.assign(N,-1);
+			for (size_t k=0;k<m_cekf_active_lms.size();k++)
+				m_cekf_pos_in_active[m_cekf_active_lms[k]] = static_cast<int>(k);
+			m_cekf_num_active0 = m_cekf_active_lms.size();
+
+			const size_t nA = VEH_SIZE+FEAT_SIZE*m_cekf_num_active0;
+			m_cekf_Phi.setIdentity(nA,nA);
+			m_cekf_Psi.zeros(nA,nA);
+			m_cekf_pending = false;
+		}
+
+		template <size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE, typename KFTYPE>
+		void CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,FEAT_SIZE,ACT_SIZE,KFTYPE>::CEKF_applyPendingUpdates(KFMatrix &P) const
+		{
+			const size_t nA  = VEH_SIZE+FEAT_SIZE*m_cekf_active_lms.size();
+			const size_t nA0 = VEH_SIZE+FEAT_SIZE*m_cekf_num_active0;
+			ASSERTDEB_(m_cekf_Phi.getRowCount()==nA && m_cekf_Phi.getColCount()==nA0)
+
+			std::vector<size_t> idxA(nA), idxB;
+			for (size_t k=0;k<nA;k++)
+				idxA[k] = CEKF_activeStateIndex(k);
+			for (size_t lm=0;lm<m_cekf_pos_in_active.size();lm++)
+				if (m_cekf_pos_in_active[lm]<0)
+					for (size_t f=0;f<FEAT_SIZE;f++)
+						idxB.push_back(VEH_SIZE+lm*FEAT_SIZE+f);
+			const size_t nB = idxB.size();
+			if (!nB) return;
+
+			// W = P_A0B at the last global update:
+			KFMatrix W(nA0,nB);
+			for (size_t r=0;r<nA0;r++)
+				for (size_t c=0;c<nB;c++)
+					W.get_unsafe(r,c) = P.get_unsafe(idxA[r],idxB[c]);
+
+			// P_AB = Phi * W
+			const KFMatrix P_AB = m_cekf_Phi * W;
+			for (size_t r=0;r<nA;r++)
+				for (size_t c=0;c<nB;c++)
+					P.get_unsafe(idxA[r],idxB[c]) = P.get_unsafe(idxB[c],idxA[r]) = P_AB.get_unsafe(r,c);
+
+			// P_BB = P_BB - W^t * Psi * W  (column by column, to avoid a temporary nB x nB matrix)
+			const KFMatrix Psi_W = m_cekf_Psi * W;
+			KFVector dP_col;
+			for (size_t c=0;c<nB;c++)
+			{
+				dP_col = W.transpose() * Psi_W.col(c);
+				for (size_t r=0;r<nB;r++)
+					P.get_unsafe(idxB[r],idxB[c]) -= dP_col[r];
+			}
+		}
+
+		template <size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE, typename KFTYPE>
+		void CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,FEAT_SIZE,ACT_SIZE,KFTYPE>::CEKF_getPassiveCrossCov(size_t lm_idx, KFMatrix &W) const
+		{
+			const size_t nA0 = VEH_SIZE+FEAT_SIZE*m_cekf_num_active0;
+			const size_t idx_lm = VEH_SIZE+lm_idx*FEAT_SIZE;
+			W.setSize(nA0,FEAT_SIZE);
+			for (size_t r=0;r<nA0;r++)
+			{
+				const size_t idx_r = CEKF_activeStateIndex(r);
+				for (size_t f=0;f<FEAT_SIZE;f++)
+					W.get_unsafe(r,f) = m_pkk.get_unsafe(idx_r,idx_lm+f);
+			}
+		}
+
+		template <size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE, typename KFTYPE>
+		void CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,FEAT_SIZE,ACT_SIZE,KFTYPE>::CEKF_recoverPassiveLandmarkCov(size_t lm_idx, KFMatrix_FxF &cov) const
+		{
+			KFMatrix W;
+			CEKF_getPassiveCrossCov(lm_idx,W);
+			m_pkk.extractMatrix(VEH_SIZE+lm_idx*FEAT_SIZE,VEH_SIZE+lm_idx*FEAT_SIZE,cov);
+			cov -= W.transpose() * m_cekf_Psi * W;
+		}
+
+		template <size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE, typename KFTYPE>
+		void CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,FEAT_SIZE,ACT_SIZE,KFTYPE>::CEKF_recoverCovariance(const vector_size_t &lm_idxs, KFMatrix &P) const
+		{
+			const size_t n = lm_idxs.size();
+			P.setSize(VEH_SIZE+n*FEAT_SIZE,VEH_SIZE+n*FEAT_SIZE);
+			P.block(0,0,VEH_SIZE,VEH_SIZE) = m_pkk.block(0,0,VEH_SIZE,VEH_SIZE);
+
+			// For landmarks out of the active area: W=P_A0y (at the last global update), Phi*W=P_Ay, Psi*W
+			std::vector<KFMatrix> W(n), Phi_W(n), Psi_W(n);
+			for (size_t j=0;j<n;j++)
+			{
+				if (m_cekf_pos_in_active[lm_idxs[j]]>=0) continue;
+				CEKF_getPassiveCrossCov(lm_idxs[j],W[j]);
+				Phi_W[j] = m_cekf_Phi * W[j];
+				Psi_W[j] = m_cekf_Psi * W[j];
+			}
+
+			for (size_t j=0;j<n;j++)
+			{
+				const size_t lm_j  = lm_idxs[j];
+				const int    pos_j = m_cekf_pos_in_active[lm_j];
+				const size_t off_j = VEH_SIZE+j*FEAT_SIZE, idx_j = VEH_SIZE+lm_j*FEAT_SIZE;
+
+				// Vehicle - landmark:
+				if (pos_j>=0)
+				     P.block(0,off_j,VEH_SIZE,FEAT_SIZE) = m_pkk.block(0,idx_j,VEH_SIZE,FEAT_SIZE);
+				else P.block(0,off_j,VEH_SIZE,FEAT_SIZE) = Phi_W[j].block(0,0,VEH_SIZE,FEAT_SIZE);
+				P.block(off_j,0,FEAT_SIZE,VEH_SIZE) = P.block(0,off_j,VEH_SIZE,FEAT_SIZE).transpose();
+
+				// Landmark - landmark:
+				for (size_t i=0;i<=j;i++)
+				{
+					const size_t lm_i  = lm_idxs[i];
+					const int    pos_i = m_cekf_pos_in_active[lm_i];
+					const size_t off_i = VEH_SIZE+i*FEAT_SIZE, idx_i = VEH_SIZE+lm_i*FEAT_SIZE;
+
+					KFMatrix_FxF Pij(mrpt::math::UNINITIALIZED_MATRIX);
+					if (pos_i>=0 && pos_j>=0)
+						Pij = m_pkk.block(idx_i,idx_j,FEAT_SIZE,FEAT_SIZE);
+					else if (pos_i>=0)
+						Pij = Phi_W[j].block(VEH_SIZE+pos_i*FEAT_SIZE,0,FEAT_SIZE,FEAT_SIZE);
+					else if (pos_j>=0)
+						Pij = Phi_W[i].block(VEH_SIZE+pos_j*FEAT_SIZE,0,FEAT_SIZE,FEAT_SIZE).transpose();
+					else
+						Pij = m_pkk.block(idx_i,idx_j,FEAT_SIZE,FEAT_SIZE) - W[i].transpose() * Psi_W[j];
+
+					P.block(off_i,off_j,FEAT_SIZE,FEAT_SIZE) = Pij;
+					if (i!=j)
+						P.block(off_j,off_i,FEAT_SIZE,FEAT_SIZE) = Pij.transpose();
+				}
+			}
+		}
+
+		template <size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE, typename KFTYPE>
+		void CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,FEAT_SIZE,ACT_SIZE,KFTYPE>::CEKF_update(const vector_int &data_association)
+		{
+			// Observed landmarks out of the active area are brought in, after a global update:
+			std::vector<size_t> lms_to_activate;
+			size_t N_upd = 0;
+			for (size_t i=0;i<data_association.size();++i)
+			{
+				if (data_association[i]<0) continue;
+				const size_t lm_idx = static_cast<size_t>(data_association[i]);
+				m_cekf_last_seen[lm_idx] = m_cekf_iteration;
+				N_upd++;
+				if (m_cekf_pos_in_active[lm_idx]<0 && mrpt::utils::find_in_vector(lm_idx,lms_to_activate)==std::string::npos)
+					lms_to_activate.push_back(lm_idx);
+			}
+			if (!N_upd) return;
+
+			if (!lms_to_activate.empty())
+			{
+				std::vector<size_t> lms = m_cekf_active_lms;
+				lms.insert(lms.end(), lms_to_activate.begin(), lms_to_activate.end());
+				CEKF_globalUpdate(lms);
+			}
+
+			const size_t nA  = VEH_SIZE+FEAT_SIZE*m_cekf_active_lms.size();
+			const size_t nA0 = VEH_SIZE+FEAT_SIZE*m_cekf_num_active0;
+
+			// Build the Jacobian wrt the active area (H), the innovation (ytilde) and its covariance:
+			KFMatrix  H;
+			H.zeros(N_upd*OBS_SIZE, nA);
+			KFVector  ytilde(OBS_SIZE*N_upd);
+			vector_size_t S_idxs;
+			S_idxs.reserve(OBS_SIZE*N_upd);
+			for (size_t i=0;i<data_association.size();++i)
+			{
+				if (data_association[i]<0) continue;
+				const size_t lm_idx = static_cast<size_t>(data_association[i]);
+				const size_t idx_in_pred = mrpt::utils::find_in_vector(lm_idx, predictLMidxs);
+				ASSERTMSG_(idx_in_pred!=std::string::npos, "OnPreComputingPredictions() didn't recommend the prediction of a landmark which has been actually observed!")
+
+				const size_t row = S_idxs.size();
+				Eigen::Block<typename KFMatrix::Base,OBS_SIZE,VEH_SIZE> (H, row,0) = Hxs[idx_in_pred];
+				Eigen::Block<typename KFMatrix::Base,OBS_SIZE,FEAT_SIZE>(H, row, VEH_SIZE+m_cekf_pos_in_active[lm_idx]*FEAT_SIZE ) = Hys[idx_in_pred];
+
+				KFArray_OBS ytilde_i = Z[i];
+				OnSubstractObservationVectors(ytilde_i,all_predictions[lm_idx]);
+				for (size_t k=0;k<OBS_SIZE;k++)
+				{
+					ytilde[row+k] = ytilde_i[k];
+					S_idxs.push_back(idx_in_pred*OBS_SIZE+k);
+				}
+			}
+			KFMatrix S_observed;
+			S.extractSubmatrixSymmetrical(S_idxs,S_observed);
+			S_observed.inv(S_1);
+
+			// Covariance of the active area:
+			KFMatrix P_AA(nA,nA);
+			for (size_t r=0;r<nA;r++)
+				for (size_t c=0;c<nA;c++)
+					P_AA.get_unsafe(r,c) = m_pkk.get_unsafe(CEKF_activeStateIndex(r),CEKF_activeStateIndex(c));
+
+			const KFMatrix P_Ht = P_AA * H.transpose();
+			K = P_Ht * S_1;
+			const KFVector S_1_ytilde = S_1 * ytilde;
+
+			// Mean of the active area:
+			const KFVector dx_A = P_Ht * S_1_ytilde;
+			for (size_t k=0;k<nA;k++)
+				m_xkk[CEKF_activeStateIndex(k)] += dx_A[k];
+
+			// Mean of the rest of the map: x_B += P_BA * H^t * S^-1 * ytilde, with P_BA = (Phi * P_A0B)^t
+			const KFMatrix H_Phi = H * m_cekf_Phi;
+			const KFVector v = H_Phi.transpose() * S_1_ytilde;
+			for (size_t lm=0;lm<m_cekf_pos_in_active.size();lm++)
+			{
+				if (m_cekf_pos_in_active[lm]>=0) continue;
+				for (size_t f=0;f<FEAT_SIZE;f++)
+				{
+					const size_t idx = VEH_SIZE+lm*FEAT_SIZE+f;
+					KFTYPE dx = 0;
+					for (size_t r=0;r<nA0;r++)
+						dx += m_pkk.get_unsafe(CEKF_activeStateIndex(r),idx) * v[r];
+					m_xkk[idx] += dx;
+				}
+			}
+
+			// Accumulate the effect of this update in the deferred covariances:
+			m_cekf_Psi += H_Phi.transpose() * S_1 * H_Phi;
+			m_cekf_Phi -= K * H_Phi;
+
+			// Covariance of the active area: P_AA = P_AA - K * H * P_AA
+			P_AA -= K * P_Ht.transpose();
+			for (size_t r=0;r<nA;r++)
+				for (size_t c=r;c<nA;c++)
+					m_pkk.get_unsafe(CEKF_activeStateIndex(r),CEKF_activeStateIndex(c)) =
+					m_pkk.get_unsafe(CEKF_activeStateIndex(c),CEKF_activeStateIndex(r)) = 0.5*(P_AA.get_unsafe(r,c)+P_AA.get_unsafe(c,r));
+
+			m_cekf_pending = true;
+		}
+
+		template <size_t VEH_SIZE, size_t OBS_SIZE, size_t FEAT_SIZE, size_t ACT_SIZE, typename KFTYPE>
+		void CKalmanFilterCapable<VEH_SIZE,OBS_SIZE,FEAT_SIZE,ACT_SIZE,KFTYPE>::CEKF_appendLandmark(const KFMatrix_FxV &dyn_dxv)
+		{
+			// P_yn,B = dyn_dxv * P_vB = (dyn_dxv * Phi_v) * P_A0B
+			ASSERTDEB_(m_cekf_pos_in_active.size()+1==getNumberOfLandmarksInTheMap())
+			const size_t nA  = VEH_SIZE+FEAT_SIZE*m_cekf_active_lms.size();
+			const size_t nA0 = VEH_SIZE+FEAT_SIZE*m_cekf_num_active0;
+
+			const KFMatrix Phi_yn = dyn_dxv * m_cekf_Phi.block(0,0,VEH_SIZE,nA0);
+			m_cekf_Phi.setSize(nA+FEAT_SIZE,nA0);
+			m_cekf_Phi.block(nA,0,FEAT_SIZE,nA0) = Phi_yn;
+
+			m_cekf_pos_in_active.push_back( static_cast<int>(m_cekf_active_lms.size()) );
+			m_cekf_active_lms.push_back( m_cekf_pos_in_active.size()-1 );
+			m_cekf_last_seen.push_back(m_cekf_iteration);
+			m_cekf_pending = true;
+		}
+
 		namespace detail
 		{
 			// generic version for SLAM. There is a speciation below for NON-SLAM problems.
@@ -1158,6 +1491,10 @@ namespace mrpt
 
 						obj.internal_getPkk().insertMatrix(idx,idx, P_yn_yn );
 
+						// CEKF: the new landmark enters the active area:
+						if (obj.KF_options.method==kfCEKF)
+							obj.CEKF_appendLandmark(dyn_dxv);
+
 						obj.getProfiler().leave("KF:9.create new LMs");
 					}
 				}
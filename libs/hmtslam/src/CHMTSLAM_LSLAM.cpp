@@ -46,6 +46,7 @@ void CHMTSLAM::thread_LSLAM()
 	CHMTSLAM	*obj = this;
 	CTicTac							tictac;
 	unsigned int					nIter = 0;			// For logging purposes only
+	unsigned int					nObsSinceReport = 0;
 
 	// Seems that must be called in each thread??
 	if (obj->m_options.random_seed)
@@ -57,6 +58,7 @@ void CHMTSLAM::thread_LSLAM()
 		// Start thread:
 		// -------------------------
 		obj->logFmt(mrpt::utils::LVL_DEBUG,"[thread_LSLAM] Thread started (ID=0x%08lX)\n", mrpt::system::getCurrentThreadId() );
+		tictac.Tic();
 
 		// --------------------------------------------
 		//    The main loop
@@ -111,8 +113,10 @@ void CHMTSLAM::thread_LSLAM()
 
 				ASSERT_(obj->m_LSLAM_method);
 
+				size_t nLMHs;
 				{
 					CCriticalSectionLocker LMHs_cs_locker( & obj->m_LMHs_cs );
+					nLMHs = obj->m_LMHs.size();
 
 					for (it=obj->m_LMHs.begin();it!=obj->m_LMHs.end();it++)
 					{
@@ -191,6 +195,16 @@ void CHMTSLAM::thread_LSLAM()
 				// Free the object.
 				nextObject.clear_unique();
 
+				// Throughput statistics:
+				if (observations) nObsSinceReport++;
+				const double tReport = tictac.Tac();
+				if (tReport>5.0)
+				{
+					obj->logFmt(mrpt::utils::LVL_INFO,"[thread_LSLAM] Throughput: %.02f observations/s with %u LMHs\n", nObsSinceReport/tReport, static_cast<unsigned int>(nLMHs) );
+					nObsSinceReport = 0;
+					tictac.Tic();
+				}
+
 
 				// -----------------------------------------------------------
 				//					SLAM: Save log files
@@ -1348,7 +1362,7 @@ void CHMTSLAM::LSLAM_process_message_from_AA( const TMessageLSLAMfromAA &myMsg )
 						for (itSrc=poseInfo.pdf.m_particles.begin(), itTrg=LMH->m_particles.begin(); itTrg!=LMH->m_particles.end(); itSrc++,itTrg++)
 						{
 							// log_w: not modified since diff. areas are independent...
-							itTrg->d->robotPoses[ poseID ] = itTrg->d->robotPoses[ refPoseIDAtCurArea ] + Delta_c2a + *itSrc->d;
+							itTrg->d->robotPoses[ poseID ] = itTrg->d->robotPoses[ refPoseIDAtCurArea ] + Delta_c2a + itSrc->d;
 						}
 
 						// Update m_nodeIDmemberships
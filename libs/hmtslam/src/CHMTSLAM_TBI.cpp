@@ -183,18 +183,12 @@ CHMTSLAM::TMessageLSLAMfromTBIPtr CHMTSLAM::TBI_main_method(
 	// ----------------------------------------------------
 	std::set<CHMHMapNode::TNodeID>  lstNodesToErase;
 	{
-		synch::CCriticalSection lock( obj->m_topLCdets_cs );
+		synch::CCriticalSectionLocker lock( &obj->m_topLCdets_cs );
 
 		for ( deque<CTopLCDetectorBase*>::const_iterator it=obj->m_topLCdets.begin();it!=obj->m_topLCdets.end();++it)
 		{
 			for (map< CHMHMapNode::TNodeID, TMessageLSLAMfromTBI::TBI_info >::iterator candidate = msg->loopClosureData.begin();candidate != msg->loopClosureData.end();++candidate)
 			{
-				// If the current log_lik of this area is reaaaally low, we could skip the computation with other LC detectors...
-				// ----------------------------------------------------------------------------------------------------------------
-				// TODO: ...
-
-				// Proceed:
-				// ----------------------------------------------------------------------------------------------------------------
 				const CHMHMapNodePtr refArea = obj->m_map.getNodeByID( candidate->first );
 				double this_log_lik;
 
@@ -935,7 +935,7 @@ void  CHierarchicalMapMHPartition::computeCoordinatesTransformationBetweenNodes(
 	// Compute the pose composition:
 	for (unsigned int i=0;i<particlesCount;i++)
 	{
-		CPose3D		&sample = *posePDF.m_particles[i].d;
+		CPose3D		&sample = posePDF.m_particles[i].d;
 
 		for (unsigned int j=0;j<pathLength;j++)
 		{
@@ -1582,9 +1582,9 @@ double CHierarchicalMapMHPartition::computeOverlapProbabilityBetweenNodes(
 	{
 		if (math::RectanglesIntersection(	r1_x_min, r1_x_max, r1_y_min, r1_y_max,
 											r2_x_min, r2_x_max, r2_y_min, r2_y_max,
-											posePDF.m_particles[i].d->x(),
-											posePDF.m_particles[i].d->y(),
-											posePDF.m_particles[i].d->yaw() ) )
+											posePDF.m_particles[i].d.x(),
+											posePDF.m_particles[i].d.y(),
+											posePDF.m_particles[i].d.yaw() ) )
 		{
 			hits++;
 		}
@@ -430,7 +430,7 @@ void CLocalMetricHypothesis::getPathParticles( std::map< TPoseID, CPose3DPDFPart
 		for ( it = m_particles.begin(), itP = auxPDF.m_particles.begin(); it!=m_particles.end(); it++, itP++ )
 		{
 			itP->log_w = it->log_w;
-			*itP->d    = it->d->robotPoses[ itPoseID->first ];
+			itP->d    = it->d->robotPoses[ itPoseID->first ];
 		}
 
 		// Save PDF:
@@ -458,7 +458,7 @@ void CLocalMetricHypothesis::getPoseParticles( const TPoseID &poseID, CPose3DPDF
 		itP->log_w = it->log_w;
 		TMapPoseID2Pose3D::const_iterator	itPose = it->d->robotPoses.find(poseID);
 		ASSERT_( itPose!=it->d->robotPoses.end() );
-		*itP->d = itPose->second;
+		itP->d = itPose->second;
 	}
 
 	MRPT_END
@@ -532,7 +532,7 @@ void CLocalMetricHypothesis::getRelativePose(
 		ASSERT_( srcPose != it->d->robotPoses.end() )
 		ASSERT_( trgPose != it->d->robotPoses.end() )
 
-		*itP->d = trgPose->second - srcPose->second;
+		itP->d = trgPose->second - srcPose->second;
 	}
 
 	MRPT_END
@@ -555,7 +555,7 @@ void CLocalMetricHypothesis::changeCoordinateOrigin( const TPoseID &newOrigin )
 		const CPose3D  &refPose = refPoseIt->second;
 
 		// Save in pdf to compute mean:
-		*itOrgPDF->d = refPose;
+		itOrgPDF->d = refPose;
 		itOrgPDF->log_w = it->log_w;
 
 		TMapPoseID2Pose3D::iterator   End = it->d->robotPoses.end();
@@ -837,7 +837,7 @@ void CLocalMetricHypothesis::updateAreaFromLMH(
 		CPose3DPDFParticles::CParticleList::iterator orgIt,pdfIt;
 		ASSERT_( it->second.pdf.size() == pdfOriginInv.size() );
 		for ( pdfIt=it->second.pdf.m_particles.begin(), orgIt= pdfOriginInv.m_particles.begin();orgIt!=pdfOriginInv.m_particles.end();orgIt++,pdfIt++)
-			*pdfIt->d = *orgIt->d + *pdfIt->d;
+			pdfIt->d = orgIt->d + pdfIt->d;
 	}
 
 	// 2) One single metric map built from the most likelily robot poses
@@ -15,6 +15,7 @@
 #include <mrpt/utils/COutputLogger.h>
 #include <mrpt/utils/CConfigFileBase.h>
 #include <mrpt/hwdrivers/CGenericSensor.h>
+#include <mrpt/system/CThreadPool.h>
 
 #include <mrpt/hwdrivers/CFFMPEG_InputStream.h>
 #include <mrpt/hwdrivers/CImageGrabber_OpenCV.h>
@@ -398,13 +399,10 @@ namespace mrpt
 			/** @name Stuff related to working threads to save images to disk
 			    @{ */
 			unsigned int		m_external_image_saver_count; //!< Number of working threads. Default:1, set to 2 in quad cores.
-			std::vector<mrpt::system::TThreadHandle>  m_threadImagesSaver;
+			mrpt::system::CThreadPool  *m_threadImagesSaver; //!< The working threads, each observation is saved by one task.
+
+			void task_save_images(mrpt::utils::CSerializablePtr obj); //!< Task (run in m_threadImagesSaver) which saves the images of one observation to files, then appends it to the observations queue.
 
-			bool 	m_threadImagesSaverShouldEnd;
-			mrpt::synch::CCriticalSection	m_csToSaveList;		//!< The critical section for m_toSaveList
-			std::vector<TListObservations>	m_toSaveList;		//!< The queues of objects to be returned by getObservations, one for each working thread.
-			void thread_save_images(unsigned int my_working_thread_index); //!< Thread to save images to files.
-			
 			TPreSaveUserHook  m_hook_pre_save;
 			void            * m_hook_pre_save_param;
 			/**  @} */
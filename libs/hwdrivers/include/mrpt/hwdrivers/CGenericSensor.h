@@ -14,6 +14,7 @@
 #include <mrpt/utils/CUncopiable.h>
 #include <mrpt/obs/CObservation.h>
 #include <mrpt/synch/CCriticalSection.h>
+#include <mrpt/synch/CLockFreeQueue.h>
 #include <mrpt/system/threads.h>
 #include <map>
 
@@ -45,7 +46,7 @@ namespace mrpt
 		  *		- Object constructor
 		  *		- CGenericSensor::loadConfig: The following parameters are common to all sensors in rawlog-grabber (they are automatically loaded by rawlog-grabber) - see each class documentation for additional parameters:
 		  *			- "process_rate": (Mandatory) The rate in Hertz (Hz) at which the sensor thread should invoke "doProcess".
-		  *			- "max_queue_len": (Optional) The maximum number of objects in the observations queue (default is 200). If overflow occurs, an error message will be issued at run-time.
+		  *			- "max_queue_len": (Optional) The maximum number of objects in the observations queue (default is 200, rounded up to a power of two). If overflow occurs, the oldest objects are dropped and an error message will be issued at run-time.
 		  *			- "grab_decimation": (Optional) Grab only 1 out of N observations captured by the sensor (default is 1, i.e. do not decimate).
 		  *		- CGenericSensor::initialize
 		  *		- CGenericSensor::doProcess
@@ -101,8 +102,13 @@ namespace mrpt
 			static void registerClass(const TSensorClassId* pNewClass);
 
 		private:
-			synch::CCriticalSection			m_csObjList;		//!< The critical section for m_objList
-			TListObservations				m_objList;		//!< The queue of objects to be returned by getObservations
+			/** The queue of objects to be returned by getObservations. It is lock-free, since appendObservations() may be
+			  * called from several threads of the sensor while another thread is calling getObservations(). */
+			mrpt::synch::CLockFreeQueueMPMC<TListObsPair>	*m_objList;
+			mrpt::synch::CAtomicCounter		m_dropped_obs;		//!< # of objects dropped due to a full m_objList
+			long							m_dropped_obs_reported;
+
+			void resizeObsQueue(); //!< (Re)creates m_objList with m_max_queue_len elements
 
 			/** Used in registerClass */
 			static std::map< std::string , const TSensorClassId *>	m_knownClasses;
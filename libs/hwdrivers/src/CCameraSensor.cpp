@@ -98,7 +98,7 @@ CCameraSensor::CCameraSensor() :
 	m_camera_grab_decimator_counter(0),
 	m_preview_counter	(0),
 	m_external_image_saver_count( mrpt::system::getNumberOfProcessors() ),
-	m_threadImagesSaverShouldEnd(false),
+	m_threadImagesSaver(NULL),
 	m_hook_pre_save      (NULL),
 	m_hook_pre_save_param(NULL)
 {
@@ -339,17 +339,8 @@ void CCameraSensor::initialize()
 	// Launch independent thread?
 	if (m_external_images_own_thread)
 	{
-		m_threadImagesSaverShouldEnd = false;
-
-		m_threadImagesSaver.clear();
-		m_threadImagesSaver.resize(m_external_image_saver_count);
-
-		m_toSaveList.clear();
-		m_toSaveList.resize(m_external_image_saver_count);
-
-		for (unsigned int i=0;i<m_external_image_saver_count;++i)
-			m_threadImagesSaver[i] = mrpt::system::createThreadFromObjectMethod(this,&CCameraSensor::thread_save_images, i);
-
+		delete_safe(m_threadImagesSaver);
+		m_threadImagesSaver = new mrpt::system::CThreadPool(std::max(1u,m_external_image_saver_count));
 	}
 
 }
@@ -375,13 +366,8 @@ void CCameraSensor::close()
 
 	m_state = CGenericSensor::ssInitializing;
 
-	// Wait for threads:
-	if (!m_threadImagesSaver.empty())
-	{
-		m_threadImagesSaverShouldEnd = true;
-        for (size_t i=0;i<m_threadImagesSaver.size();i++)
-            mrpt::system::joinThread( m_threadImagesSaver[i] );
-	}
+	// Wait for threads (pending images are saved first):
+	delete_safe(m_threadImagesSaver);
 }
 
 /* -----------------------------------------------------
@@ -809,20 +795,25 @@ void CCameraSensor::getNextFrame( vector<CSerializablePtr> & out_obs )
 				const std::string old_dir = CImage::IMAGES_PATH_BASE; // Save current
 				CImage::IMAGES_PATH_BASE = m_rawlog_detected_images_dir;
 
+				// Decode all the images of the observation in parallel, if the cache of decoded images is enabled (see CImage::setExternalImagesCacheSize()):
+				if (obs) obs->prefetch();
+				if (obs3D) obs3D->prefetch();
+				if (stObs) stObs->prefetch();
+
 				if (obs && obs->image.isExternallyStored())
-					obs->image.loadFromFile( obs->image.getExternalStorageFileAbsolutePath() );
+					obs->image.copyFromForceLoad( obs->image );
 
 				if (obs3D && obs3D->hasIntensityImage && obs3D->intensityImage.isExternallyStored())
-					obs3D->intensityImage.loadFromFile( obs3D->intensityImage.getExternalStorageFileAbsolutePath() );
+					obs3D->intensityImage.copyFromForceLoad( obs3D->intensityImage );
 
 				if (stObs && stObs->imageLeft.isExternallyStored())
-					stObs->imageLeft.loadFromFile( stObs->imageLeft.getExternalStorageFileAbsolutePath() );
+					stObs->imageLeft.copyFromForceLoad( stObs->imageLeft );
 
 				if (stObs && stObs->hasImageRight && stObs->imageRight.isExternallyStored())
-					stObs->imageRight.loadFromFile( stObs->imageRight.getExternalStorageFileAbsolutePath() );
+					stObs->imageRight.copyFromForceLoad( stObs->imageRight );
 
 				if (stObs && stObs->hasImageDisparity && stObs->imageDisparity.isExternallyStored())
-					stObs->imageDisparity.loadFromFile( stObs->imageDisparity.getExternalStorageFileAbsolutePath() );
+					stObs->imageDisparity.copyFromForceLoad( stObs->imageDisparity );
 
 				CImage::IMAGES_PATH_BASE = old_dir; // Restore
 			}
@@ -964,20 +955,9 @@ void CCameraSensor::getNextFrame( vector<CSerializablePtr> & out_obs )
 	{
 		if( stObs )			// If we have grabbed an stereo observation ...
 		{	// Stereo obs  -------
-			if (m_external_images_own_thread)
+			if (m_threadImagesSaver)
 			{
-				m_csToSaveList.enter();
-
-				// Select the "m_toSaveList" with the shortest pending queue:
-				size_t idx_min = 0;
-				for (size_t i=0;i<m_toSaveList.size();++i)
-				    if (m_toSaveList[i].size()<m_toSaveList[idx_min].size())
-                        idx_min = i;
-                // Insert:
-				m_toSaveList[idx_min].insert( TListObsPair( stObs->timestamp, stObs ) );
-
-				m_csToSaveList.leave();
-
+				m_threadImagesSaver->enqueueObjectMethod(this, &CCameraSensor::task_save_images, CSerializablePtr(stObs));
 				delayed_insertion_in_obs_queue = true;
 			}
 			else
@@ -1001,20 +981,9 @@ void CCameraSensor::getNextFrame( vector<CSerializablePtr> & out_obs )
 		}
 		else if (obs)
 		{	// Monocular image obs  -------
-			if (m_external_images_own_thread)
+			if (m_threadImagesSaver)
 			{
-				m_csToSaveList.enter();
-
-				// Select the "m_toSaveList" with the shortest pending queue:
-				size_t idx_min = 0;
-				for (size_t i=0;i<m_toSaveList.size();++i)
-				    if (m_toSaveList[i].size()<m_toSaveList[idx_min].size())
-                        idx_min = i;
-
-                // Insert:
-				m_toSaveList[idx_min].insert( TListObsPair( obs->timestamp, obs ) );
-
-				m_csToSaveList.leave();
+				m_threadImagesSaver->enqueueObjectMethod(this, &CCameraSensor::task_save_images, CSerializablePtr(obs));
 				delayed_insertion_in_obs_queue = true;
 			}
 			else
@@ -1313,65 +1282,50 @@ void mrpt::hwdrivers::readConfigIntoVideoSourcePanel(
 
 
 /* -----------------------------------------------------
-		THREAD: Saver of external images
+		TASK: Saver of external images
    ----------------------------------------------------- */
-void CCameraSensor::thread_save_images(unsigned int my_working_thread_index)
+void CCameraSensor::task_save_images(CSerializablePtr obj)
 {
-	while (!m_threadImagesSaverShouldEnd)
+	// Optional user-code hook:
+	if (m_hook_pre_save)
 	{
-		TListObservations newObs;
-
-		// is there any new image?
-		m_csToSaveList.enter();
-		m_toSaveList[my_working_thread_index].swap(newObs);
-		m_csToSaveList.leave();
-
-		for (TListObservations::const_iterator i=newObs.begin();i!=newObs.end();++i)
+		if (IS_DERIVED(obj, CObservation))
 		{
-			// Optional user-code hook:
-			if (m_hook_pre_save)
-			{
-				if (IS_DERIVED(i->second, CObservation))
-				{
-					mrpt::obs::CObservationPtr obs = mrpt::obs::CObservationPtr(i->second);
-					(*m_hook_pre_save)(obs,m_hook_pre_save_param);
-				}
-			}
-
-			if (IS_CLASS(i->second, CObservationImage))
-			{
-				CObservationImagePtr obs = CObservationImagePtr(i->second);
+			mrpt::obs::CObservationPtr obs = mrpt::obs::CObservationPtr(obj);
+			(*m_hook_pre_save)(obs,m_hook_pre_save_param);
+		}
+	}
 
-				string filName = fileNameStripInvalidChars( trim(m_sensorLabel) ) + format( "_%f.%s", (double)timestampTotime_t( obs->timestamp ), m_external_images_format.c_str() );
+	if (IS_CLASS(obj, CObservationImage))
+	{
+		CObservationImagePtr obs = CObservationImagePtr(obj);
 
-				obs->image.saveToFile( m_path_for_external_images + string("/") +filName, m_external_images_jpeg_quality );
-				obs->image.setExternalStorage( filName );
-			}
-			else if (IS_CLASS(i->second, CObservationStereoImages))
-			{
-				CObservationStereoImagesPtr stObs = CObservationStereoImagesPtr(i->second);
+		string filName = fileNameStripInvalidChars( trim(m_sensorLabel) ) + format( "_%f.%s", (double)timestampTotime_t( obs->timestamp ), m_external_images_format.c_str() );
 
-				const string filNameL = fileNameStripInvalidChars( trim(m_sensorLabel) ) + format( "_L_%f.%s", (double)timestampTotime_t( stObs->timestamp ), m_external_images_format.c_str() );
-				const string filNameR = fileNameStripInvalidChars( trim(m_sensorLabel) ) + format( "_R_%f.%s", (double)timestampTotime_t( stObs->timestamp ), m_external_images_format.c_str() );
-				const string filNameD = fileNameStripInvalidChars( trim(m_sensorLabel) ) + format( "_D_%f.%s", (double)timestampTotime_t( stObs->timestamp ), m_external_images_format.c_str() );
+		obs->image.saveToFile( m_path_for_external_images + string("/") +filName, m_external_images_jpeg_quality );
+		obs->image.setExternalStorage( filName );
+	}
+	else if (IS_CLASS(obj, CObservationStereoImages))
+	{
+		CObservationStereoImagesPtr stObs = CObservationStereoImagesPtr(obj);
 
-				stObs->imageLeft.saveToFile( m_path_for_external_images + string("/") + filNameL, m_external_images_jpeg_quality );
-				stObs->imageLeft.setExternalStorage( filNameL );
+		const string filNameL = fileNameStripInvalidChars( trim(m_sensorLabel) ) + format( "_L_%f.%s", (double)timestampTotime_t( stObs->timestamp ), m_external_images_format.c_str() );
+		const string filNameR = fileNameStripInvalidChars( trim(m_sensorLabel) ) + format( "_R_%f.%s", (double)timestampTotime_t( stObs->timestamp ), m_external_images_format.c_str() );
+		const string filNameD = fileNameStripInvalidChars( trim(m_sensorLabel) ) + format( "_D_%f.%s", (double)timestampTotime_t( stObs->timestamp ), m_external_images_format.c_str() );
 
-				if (stObs->hasImageRight) {
-					stObs->imageRight.saveToFile( m_path_for_external_images + string("/") + filNameR, m_external_images_jpeg_quality );
-					stObs->imageRight.setExternalStorage( filNameR );
-				}
-				if (stObs->hasImageDisparity) {
-					stObs->imageDisparity.saveToFile( m_path_for_external_images + string("/") + filNameD, m_external_images_jpeg_quality );
-					stObs->imageDisparity.setExternalStorage( filNameD );
-				}
-			}
+		stObs->imageLeft.saveToFile( m_path_for_external_images + string("/") + filNameL, m_external_images_jpeg_quality );
+		stObs->imageLeft.setExternalStorage( filNameL );
 
-			// Append now:
-			appendObservation(i->second);
+		if (stObs->hasImageRight) {
+			stObs->imageRight.saveToFile( m_path_for_external_images + string("/") + filNameR, m_external_images_jpeg_quality );
+			stObs->imageRight.setExternalStorage( filNameR );
+		}
+		if (stObs->hasImageDisparity) {
+			stObs->imageDisparity.saveToFile( m_path_for_external_images + string("/") + filNameD, m_external_images_jpeg_quality );
+			stObs->imageDisparity.setExternalStorage( filNameD );
 		}
-
-		mrpt::system::sleep(2);
 	}
+
+	// Append now:
+	appendObservation(obj);
 }
@@ -29,6 +29,9 @@ const int dumm = mrpt_hwdrivers_class_reg.do_nothing(); // Avoid compiler removi
 						Constructor
 -------------------------------------------------------------*/
 CGenericSensor::CGenericSensor() :
+	m_objList(NULL),
+	m_dropped_obs(0),
+	m_dropped_obs_reported(0),
 	m_process_rate(0),
 	m_max_queue_len(200),
 	m_grab_decimation(0),
@@ -42,6 +45,7 @@ CGenericSensor::CGenericSensor() :
 {
 	const char * sVerbose = getenv("MRPT_HWDRIVERS_VERBOSE");
 	m_verbose = (sVerbose!=NULL) && atoi(sVerbose)!=0;
+	resizeObsQueue();
 }
 
 /*-------------------------------------------------------------
@@ -50,7 +54,25 @@ CGenericSensor::CGenericSensor() :
 CGenericSensor::~CGenericSensor()
 {
 	// Free objects in list, if any:
-	m_objList.clear();
+	delete_safe(m_objList);
+}
+
+// Not thread-safe: only called from the constructor and loadConfig()
+void CGenericSensor::resizeObsQueue()
+{
+	const size_t capacity = mrpt::synch::detail::nextPowerOf2(m_max_queue_len);
+	if (m_objList && m_objList->capacity()==capacity)
+		return;
+
+	mrpt::synch::CLockFreeQueueMPMC<TListObsPair> *newQueue = new mrpt::synch::CLockFreeQueueMPMC<TListObsPair>(capacity);
+	if (m_objList)
+	{
+		TListObsPair p;
+		while (m_objList->pop(p))
+			newQueue->push(p);
+		delete m_objList;
+	}
+	m_objList = newQueue;
 }
 
 /*-------------------------------------------------------------
@@ -62,8 +84,6 @@ void CGenericSensor::appendObservations( const std::vector<mrpt::utils::CSeriali
 	{
 		m_grab_decimation_counter = 0;
 
-		synch::CCriticalSectionLocker	lock( & m_csObjList );
-
 		for (size_t i=0;i<objs.size();i++)
 		{
 			const CSerializablePtr &obj = objs[i];
@@ -83,8 +103,14 @@ void CGenericSensor::appendObservations( const std::vector<mrpt::utils::CSeriali
 			}
 			else THROW_EXCEPTION("Passed object must be CObservation.");
 
-			// Add it:
-			m_objList.insert( TListObsPair(timestamp, obj) );
+			// Add it, dropping the oldest objects if the queue is full:
+			const TListObsPair p(timestamp, obj);
+			while (!m_objList->push(p))
+			{
+				TListObsPair dropped;
+				if (m_objList->pop(dropped))
+					++m_dropped_obs;
+			}
 		}
 	}
 }
@@ -95,9 +121,18 @@ void CGenericSensor::appendObservations( const std::vector<mrpt::utils::CSeriali
 -------------------------------------------------------------*/
 void CGenericSensor::getObservations( TListObservations	&lstObjects )
 {
-	synch::CCriticalSectionLocker	lock( & m_csObjList );
-	lstObjects = m_objList;
-	m_objList.clear();			// Memory of objects will be freed by invoker.
+	lstObjects.clear();
+	TListObsPair p;
+	while (m_objList->pop(p))
+		lstObjects.insert(lstObjects.end(), p);  // Memory of objects will be freed by invoker.
+
+	const long nDropped = m_dropped_obs;
+	if (nDropped!=m_dropped_obs_reported)
+	{
+		std::cerr << format("[CGenericSensor] Sensor '%s': %li observations dropped since the queue is full (max_queue_len=%u)\n",
+			m_sensorLabel.c_str(), nDropped-m_dropped_obs_reported, static_cast<unsigned int>(m_objList->capacity()) );
+		m_dropped_obs_reported = nDropped;
+	}
 }
 
 
@@ -138,6 +173,7 @@ void  CGenericSensor::loadConfig(
 
 	m_process_rate  = cfg.read_double(sect,"process_rate",0 );  // Leave it to 0 so rawlog-grabber can detect if it's not set by the user.
 	m_max_queue_len = static_cast<size_t>(cfg.read_int(sect,"max_queue_len",int(m_max_queue_len)));
+	resizeObsQueue();
 	m_grab_decimation = static_cast<size_t>(cfg.read_int(sect,"grab_decimation",int(m_grab_decimation)));
 
 	m_sensorLabel	= cfg.read_string( sect, "sensorLabel", m_sensorLabel );
@@ -26,6 +26,7 @@ MRPT_WARNING("Including <mrpt/maps.h> makes compilation much slower, consider in
 #include <mrpt/maps/CHeightGridMap2D_MRF.h>
 #include <mrpt/maps/CReflectivityGridMap2D.h>
 #include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/maps/CTiledOccupancyGridMap2D.h>
 #include <mrpt/maps/CPointsMap.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/maps/CWeightedPointsMap.h>
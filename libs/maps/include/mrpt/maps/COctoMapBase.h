@@ -77,6 +77,7 @@ namespace mrpt
 					// Copy all but the m_parent pointer!
 					maxrange = o.maxrange;
 					pruning  = o.pruning;
+					discretizeScan = o.discretizeScan;
 					const bool o_has_parent = o.m_parent.get()!=NULL;
 					setOccupancyThres( o_has_parent ? o.getOccupancyThres() : o.occupancyThres );
 					setProbHit( o_has_parent ? o.getProbHit() : o.probHit );
@@ -91,6 +92,7 @@ namespace mrpt
 
 				double maxrange;  //!< maximum range for how long individual beams are inserted (default -1: complete beam)
 				bool pruning;     //!< whether the tree is (losslessly) pruned after insertion (default: true)
+				bool discretizeScan; //!< If true, all the points of a scan falling in the same voxel are merged into one single ray towards the voxel center before ray casting. Much faster for dense clouds (e.g. Velodyne, RGBD), at the price of a slightly coarser free-space carving (default: false)
 
 				/// (key name in .ini files: "occupancyThres") sets the threshold for occupancy (sensor model) (Default=0.5)
 				void setOccupancyThres(double prob) { if(m_parent.get()) m_parent->m_octomap.setOccupancyThres(prob); }
@@ -223,6 +225,7 @@ namespace mrpt
 
 			/** Update the octomap with a 2D or 3D scan, given directly as a point cloud and the 3D location of the sensor (the origin of the rays) in this map's frame of reference.
 			  * Insertion parameters can be found in \a insertionOptions.
+			  * As in insertObservation(), each voxel is updated at most once per call (free or occupied, occupied having precedence), so the result does not depend on how many rays traverse it.
 			  * \sa The generic observation insertion method CMetricMap::insertObservation()
 			  */
 			void insertPointCloud(const CPointsMap &ptMap, const float sensor_x,const float sensor_y,const float sensor_z);
@@ -299,6 +302,17 @@ namespace mrpt
 			  */
 			bool internal_build_PointCloud_for_observation(const mrpt::obs::CObservation *obs,const mrpt::poses::CPose3D *robotPose, octomap::point3d &point3d_sensorPt, octomap::Pointcloud &ptr_scan) const;
 
+			/** Computes the sets of free and occupied voxels (disjoint, occupied having precedence) traversed by the rays from \a sensorPt to each point in \a scan.
+			  * Equivalent to octomap's computeUpdate(), but rays are cast in parallel (if MRPT is built with TBB) and \a insertionOptions.discretizeScan is honored.
+			  */
+			void internal_computeUpdate(const octomap::Pointcloud &scan, const octomap::point3d &sensorPt, octomap::KeySet &free_cells, octomap::KeySet &occupied_cells) const;
+
+			/** Updates the log-odds of the given voxels (in octree Morton order), then refreshes the occupancy of each affected inner node only once, bottom-up. */
+			void internal_updateVoxels(const octomap::KeySet &free_cells, const octomap::KeySet &occupied_cells);
+
+			/** internal_computeUpdate() + internal_updateVoxels() + optional pruning: the common scan insertion path of all observation types. */
+			void internal_insertPointCloud(const octomap::Pointcloud &scan, const octomap::point3d &sensorPt);
+
 			OCTREE m_octomap; //!< The actual octo-map object.
 
 		private:
@@ -12,11 +12,101 @@
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/CObservation3DRangeScan.h>
 #include <mrpt/maps/CPointsMap.h>
+#include <mrpt/system/parallelization.h>
+#include <algorithm>
 
 namespace mrpt
 {
 	namespace maps
 	{
+		namespace detail
+		{
+			/** Ray casting of a subset of the points of a scan into its own free/occupied key sets.
+			  * Same logic than octomap's OccupancyOcTreeBase::computeUpdate(), but with a local KeyRay
+			  * instead of the tree's shared one, so several blocks can be processed in parallel. */
+			template <class OCTREE>
+			struct TOctoMapRayCaster
+			{
+				const OCTREE &tree;
+				const octomap::Pointcloud &scan;
+				const octomap::point3d &origin;
+				const double maxrange;
+				const size_t blockLen;
+				std::vector<octomap::KeySet> &free_cells, &occupied_cells; //!< One of each per block
+
+				TOctoMapRayCaster(const OCTREE &tree_, const octomap::Pointcloud &scan_, const octomap::point3d &origin_, const double maxrange_, const size_t blockLen_,
+					std::vector<octomap::KeySet> &free_cells_, std::vector<octomap::KeySet> &occupied_cells_) :
+					tree(tree_), scan(scan_), origin(origin_), maxrange(maxrange_), blockLen(blockLen_),
+					free_cells(free_cells_), occupied_cells(occupied_cells_)
+				{ }
+
+				void operator()(const mrpt::system::BlockedRange &range) const
+				{
+					octomap::KeyRay keyray;
+					for (int b=range.begin();b<range.end();++b)
+					{
+						const size_t i0 = b*blockLen, i1 = std::min(scan.size(), i0+blockLen);
+						octomap::Pointcloud::const_iterator it = scan.begin()+i0;
+						for (size_t i=i0;i<i1;++i, ++it)
+							castRay(*it, keyray, free_cells[b], occupied_cells[b]);
+					}
+				}
+
+				void castRay(const octomap::point3d &p, octomap::KeyRay &keyray, octomap::KeySet &free, octomap::KeySet &occupied) const
+				{
+					const bool in_range = (maxrange < 0.0) || ((p - origin).norm() <= maxrange);
+					octomap::OcTreeKey key;
+					if (!tree.bbxSet())
+					{
+						if (in_range)
+						{
+							if (tree.computeRayKeys(origin, p, keyray))
+								free.insert(keyray.begin(), keyray.end());
+							if (tree.coordToKeyChecked(p, key))
+								occupied.insert(key);
+						}
+						else
+						{
+							// Only carve free space up to maxrange:
+							const octomap::point3d new_end = origin + (p - origin).normalized() * (float) maxrange;
+							if (tree.computeRayKeys(origin, new_end, keyray))
+								free.insert(keyray.begin(), keyray.end());
+						}
+					}
+					else if (in_range && tree.inBBX(p))
+					{
+						if (tree.coordToKeyChecked(p, key))
+							occupied.insert(key);
+						// Free space, from the end point backwards until the bbx limit:
+						if (tree.computeRayKeys(origin, p, keyray))
+						{
+							for (octomap::KeyRay::reverse_iterator rit=keyray.rbegin(); rit != keyray.rend(); ++rit)
+							{
+								if (!tree.inBBX(*rit)) break;
+								free.insert(*rit);
+							}
+						}
+					}
+				}
+			};
+
+			/** Sorts octree keys in the order of a depth-first traversal of the tree (Morton / Z-order, with the child index bits x=1,y=2,z=4 as in octomap). */
+			struct TOctoMapKeyMortonLess
+			{
+				bool operator()(const octomap::OcTreeKey &a, const octomap::OcTreeKey &b) const
+				{
+					// Find the coordinate with the most significant differing bit:
+					unsigned int msd = 2, x = a[2]^b[2];
+					for (int d=1;d>=0;d--)
+					{
+						const unsigned int y = a[d]^b[d];
+						if (x < y && x < (x^y)) { msd = d; x = y; }
+					}
+					return a[msd] < b[msd];
+				}
+			};
+		}
+
 		template <class OCTREE,class OCTREE_NODE>
 		bool COctoMapBase<OCTREE,OCTREE_NODE>::internal_build_PointCloud_for_observation(const mrpt::obs::CObservation *obs,const mrpt::poses::CPose3D *robotPose, octomap::point3d &sensorPt, octomap::Pointcloud &scan) const
 		{
@@ -169,18 +259,26 @@ namespace mrpt
 			if (!internal_build_PointCloud_for_observation(obs,&takenFrom, sensorPt, scan))
 				return 0; // Nothing to do.
 
-			octomap::OcTreeKey key;
+			octomap::OcTreeKey key, last_key;
+			octree_node_t *last_node = NULL;
+			bool last_valid = false;
 			const size_t N=scan.size();
+			const size_t decim = std::max<size_t>(1,likelihoodOptions.decimation);
 
 			double log_lik = 0;
-			for (size_t i=0;i<N;i+=likelihoodOptions.decimation)
+			for (size_t i=0;i<N;i+=decim)
 			{
-				if (m_octomap.coordToKeyChecked(scan.getPoint(i), key))
+				if (!m_octomap.coordToKeyChecked(*(scan.begin()+i), key))
+					continue;
+				// Consecutive points of a scan often fall within the same voxel: reuse the last tree look-up.
+				if (!last_valid || key!=last_key)
 				{
-					octree_node_t *node = m_octomap.search(key,0 /*depth*/);
-					if (node)
-						log_lik += std::log(node->getOccupancy());
+					last_node = m_octomap.search(key,0 /*depth*/);
+					last_key = key;
+					last_valid = true;
 				}
+				if (last_node)
+					log_lik += std::log(last_node->getOccupancy());
 			}
 
 			return log_lik;
@@ -209,11 +307,117 @@ namespace mrpt
 			size_t N;
 			const float *xs,*ys,*zs;
 			ptMap.getPointsBuffer(N,xs,ys,zs);
+			octomap::Pointcloud scan;
+			scan.reserve(N);
 			for (size_t i=0;i<N;i++)
-				m_octomap.insertRay(sensorPt, octomap::point3d(xs[i],ys[i],zs[i]), insertionOptions.maxrange,insertionOptions.pruning);
+				scan.push_back(xs[i],ys[i],zs[i]);
+			internal_insertPointCloud(scan,sensorPt);
 			MRPT_END
 		}
 
+		template <class OCTREE,class OCTREE_NODE>
+		void COctoMapBase<OCTREE,OCTREE_NODE>::internal_computeUpdate(const octomap::Pointcloud &scan_in, const octomap::point3d &sensorPt, octomap::KeySet &free_cells, octomap::KeySet &occupied_cells) const
+		{
+			free_cells.clear();
+			occupied_cells.clear();
+
+			// Optionally, merge all the rays ending in the same voxel into one towards its center:
+			octomap::Pointcloud discretized;
+			if (insertionOptions.discretizeScan)
+			{
+				octomap::KeySet endpoints;
+				octomap::OcTreeKey key;
+				discretized.reserve(scan_in.size());
+				for (octomap::Pointcloud::const_iterator it=scan_in.begin();it!=scan_in.end();++it)
+					if (m_octomap.coordToKeyChecked(*it, key) && endpoints.insert(key).second)
+						discretized.push_back(m_octomap.keyToCoord(key));
+			}
+			const octomap::Pointcloud &scan = insertionOptions.discretizeScan ? discretized : scan_in;
+			if (scan.size()==0)
+				return;
+
+			// Split the scan in blocks, each one cast into its own key sets.
+#if MRPT_HAS_TBB
+			const size_t blockLen = 512;
+#else
+			const size_t blockLen = scan.size(); // Sequential anyway: save the merging of sets.
+#endif
+			const size_t nBlocks = (scan.size()+blockLen-1)/blockLen;
+			std::vector<octomap::KeySet> free_blocks(nBlocks), occupied_blocks(nBlocks);
+
+			mrpt::system::parallel_for(
+				mrpt::system::BlockedRange(0,static_cast<int>(nBlocks)),
+				detail::TOctoMapRayCaster<OCTREE>(m_octomap, scan, sensorPt, insertionOptions.maxrange, blockLen, free_blocks, occupied_blocks) );
+
+			// Merge:
+			free_cells.swap(free_blocks[0]);
+			occupied_cells.swap(occupied_blocks[0]);
+			for (size_t b=1;b<nBlocks;b++)
+			{
+				free_cells.insert(free_blocks[b].begin(),free_blocks[b].end());
+				occupied_cells.insert(occupied_blocks[b].begin(),occupied_blocks[b].end());
+			}
+
+			// Prefer occupied cells over free ones (and make sets disjoint):
+			for (octomap::KeySet::const_iterator it=occupied_cells.begin();it!=occupied_cells.end();++it)
+				free_cells.erase(*it);
+		}
+
+		template <class OCTREE,class OCTREE_NODE>
+		void COctoMapBase<OCTREE,OCTREE_NODE>::internal_updateVoxels(const octomap::KeySet &free_cells, const octomap::KeySet &occupied_cells)
+		{
+			const detail::TOctoMapKeyMortonLess morton_less;
+			std::vector<octomap::OcTreeKey> free_keys(free_cells.begin(),free_cells.end()), occ_keys(occupied_cells.begin(),occupied_cells.end());
+			std::sort(free_keys.begin(),free_keys.end(),morton_less);
+			std::sort(occ_keys.begin(),occ_keys.end(),morton_less);
+
+			// Update the leaves only ("lazy_eval"), instead of refreshing all the inner nodes up to the root after each single voxel:
+			for (size_t i=0;i<free_keys.size();i++)
+				m_octomap.updateNode(free_keys[i], false, true);
+			for (size_t i=0;i<occ_keys.size();i++)
+				m_octomap.updateNode(occ_keys[i], true, true);
+
+			// ... then refresh each touched inner node once, bottom-up. Since keys are in Morton order,
+			// those sharing a parent are contiguous, and so are the parents themselves at every level.
+			std::vector<octomap::OcTreeKey> keys(free_keys.size()+occ_keys.size());
+			std::merge(free_keys.begin(),free_keys.end(),occ_keys.begin(),occ_keys.end(),keys.begin(),morton_less);
+			std::vector<octomap::OcTreeKey>().swap(free_keys);
+			std::vector<octomap::OcTreeKey>().swap(occ_keys);
+
+			const unsigned int tree_depth = m_octomap.getTreeDepth();
+			for (unsigned int depth=tree_depth-1;depth>0;depth--)
+			{
+				const unsigned short mask = static_cast<unsigned short>(0xFFFF << (tree_depth-depth));
+				size_t n = 0;
+				for (size_t i=0;i<keys.size();i++)
+				{
+					const octomap::OcTreeKey k(keys[i][0] & mask, keys[i][1] & mask, keys[i][2] & mask);
+					if (n==0 || k!=keys[n-1])
+						keys[n++] = k;
+				}
+				keys.resize(n);
+
+				for (size_t i=0;i<n;i++)
+				{
+					octree_node_t *node = m_octomap.search(keys[i], depth);
+					if (node && node->hasChildren()) // (a pruned leaf may be found instead, if its update was skipped because it was already at the clamping threshold)
+						node->updateOccupancyChildren();
+				}
+			}
+			if (!keys.empty() && m_octomap.getRoot()->hasChildren())
+				m_octomap.getRoot()->updateOccupancyChildren();
+		}
+
+		template <class OCTREE,class OCTREE_NODE>
+		void COctoMapBase<OCTREE,OCTREE_NODE>::internal_insertPointCloud(const octomap::Pointcloud &scan, const octomap::point3d &sensorPt)
+		{
+			octomap::KeySet free_cells, occupied_cells;
+			internal_computeUpdate(scan, sensorPt, free_cells, occupied_cells);
+			internal_updateVoxels(free_cells, occupied_cells);
+			if (insertionOptions.pruning)
+				m_octomap.prune();
+		}
+
 		template <class OCTREE,class OCTREE_NODE>
 		bool COctoMapBase<OCTREE,OCTREE_NODE>::castRay(const mrpt::math::TPoint3D & origin,const mrpt::math::TPoint3D & direction,mrpt::math::TPoint3D & end,bool ignoreUnknownCells,double maxRange) const
 		{
@@ -239,6 +443,7 @@ namespace mrpt
 		COctoMapBase<OCTREE,OCTREE_NODE>::TInsertionOptions::TInsertionOptions(COctoMapBase<OCTREE,OCTREE_NODE> &parent) :
 			maxrange (-1.),
 			pruning  (true),
+			discretizeScan (false),
 			m_parent (&parent),
 			// Default values from octomap:
 			occupancyThres (0.5),
@@ -253,6 +458,7 @@ namespace mrpt
 		COctoMapBase<OCTREE,OCTREE_NODE>::TInsertionOptions::TInsertionOptions() :
 			maxrange (-1.),
 			pruning  (true),
+			discretizeScan (false),
 			m_parent (NULL),
 			// Default values from octomap:
 			occupancyThres (0.5),
@@ -304,6 +510,7 @@ namespace mrpt
 
 			LOADABLEOPTS_DUMP_VAR(maxrange,double);
 			LOADABLEOPTS_DUMP_VAR(pruning,bool);
+			LOADABLEOPTS_DUMP_VAR(discretizeScan,bool);
 
 			LOADABLEOPTS_DUMP_VAR(getOccupancyThres(),double);
 			LOADABLEOPTS_DUMP_VAR(getProbHit(),double);
@@ -332,6 +539,7 @@ namespace mrpt
 		{
 			MRPT_LOAD_CONFIG_VAR(maxrange,double, iniFile,section);
 			MRPT_LOAD_CONFIG_VAR(pruning,bool, iniFile,section);
+			MRPT_LOAD_CONFIG_VAR(discretizeScan,bool, iniFile,section);
 
 			MRPT_LOAD_CONFIG_VAR(occupancyThres,double, iniFile,section);
 			MRPT_LOAD_CONFIG_VAR(probHit,double, iniFile,section);
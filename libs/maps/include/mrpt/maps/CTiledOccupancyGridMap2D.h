@@ -0,0 +1,225 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#ifndef CTiledOccupancyGridMap2D_H
+#define CTiledOccupancyGridMap2D_H
+
+#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <map>
+
+#include <mrpt/maps/link_pragmas.h>
+
+namespace mrpt
+{
+	namespace utils { class CFileStream; }
+
+namespace maps
+{
+	DEFINE_SERIALIZABLE_PRE_CUSTOM_BASE_LINKAGE( CTiledOccupancyGridMap2D, CMetricMap, MAPS_IMPEXP )
+
+	/** An occupancy grid map of unbounded size, stored as square tiles of TILE_SIZE x TILE_SIZE cells
+	 *  which are only allocated the first time one of their cells is modified.
+	 *
+	 *  Cells hold the same log-odds representation than COccupancyGridMap2D, and cells in tiles not
+	 *  allocated yet read as unknown (p=0.5). Unlike COccupancyGridMap2D, the map never needs to be resized
+	 *  when new observations fall outside its current limits, so there are no reallocations nor copies
+	 *  of the existing contents, no matter how large the mapped area grows.
+	 *
+	 *  For maps which do not fit in RAM, the maximum number of tiles kept in memory can be limited with
+	 *  TPagingOptions::maxLoadedTiles: least recently used tiles are then swapped out to a backing scratch
+	 *  file and transparently loaded back the next time they are accessed.
+	 *
+	 *  Cell (cx,cy) covers the area [cx*resolution,(cx+1)*resolution) x [cy*resolution,(cy+1)*resolution),
+	 *  so cell indices can be negative.
+	 *
+	 *  Supported observations and methods:
+	 *		- Insertion of mrpt::obs::CObservation2DRangeScan, with the same COccupancyGridMap2D::TInsertionOptions (as simple rays; wideningBeamsWithDistance is ignored).
+	 *		- Likelihood of mrpt::obs::CObservation2DRangeScan and mrpt::obs::CObservationRange with the COccupancyGridMap2D::lmLikelihoodField_Thrun method.
+	 *		- Rendering as 3D object: one textured plane per tile.
+	 *		- Conversion of any area into a regular COccupancyGridMap2D, see getAsOccupancyGridMap2D().
+	 *
+	 *  Being a CMetricMap, it can be used within CMultiMetricMap (i.e. in pf-localization or icp-slam) with config blocks like:
+	 *  \code
+	 *  [<sectionName>]
+	 *  tiledOccupancyGrid_count=1
+	 *
+	 *  [<sectionName>_tiledOccupancyGrid_00_creationOpts]
+	 *  resolution     = 0.05
+	 *  maxLoadedTiles = 2000   ; 0: never swap out tiles
+	 *  backingFile    =        ; empty: use a temporary file
+	 *
+	 *  [<sectionName>_tiledOccupancyGrid_00_insertOpts]
+	 *  ; Same parameters than COccupancyGridMap2D::TInsertionOptions
+	 *
+	 *  [<sectionName>_tiledOccupancyGrid_00_likelihoodOpts]
+	 *  ; Same parameters than COccupancyGridMap2D::TLikelihoodOptions
+	 *  \endcode
+	 *
+	 * \sa COccupancyGridMap2D
+	 * \ingroup mrpt_maps_grp
+	 **/
+	class MAPS_IMPEXP CTiledOccupancyGridMap2D :
+		public CMetricMap,
+		public CLogOddsGridMap2D<COccupancyGridMap2D::cellType>
+	{
+		// This must be added to any CSerializable derived class:
+		DEFINE_SERIALIZABLE( CTiledOccupancyGridMap2D )
+	public:
+		typedef COccupancyGridMap2D::cellType cellType; //!< The type of the map cells, the same than in COccupancyGridMap2D
+
+		static const int TILE_SIZE_LOG2 = 7;
+		static const int TILE_SIZE = 1<<TILE_SIZE_LOG2; //!< Number of cells in each side of a tile
+		static const int TILE_CELL_COUNT = TILE_SIZE*TILE_SIZE;
+
+		/** Constructor */
+		CTiledOccupancyGridMap2D( float resolution = 0.05f );
+		/** Copy constructor: all tiles of the copy are kept in memory until its pagingOptions are set */
+		CTiledOccupancyGridMap2D( const CTiledOccupancyGridMap2D &o );
+		/** Copy operator: all tiles of the copy are kept in memory until its pagingOptions are set */
+		CTiledOccupancyGridMap2D & operator =(const CTiledOccupancyGridMap2D &o);
+		/** Destructor: also removes the backing file, if any */
+		virtual ~CTiledOccupancyGridMap2D();
+
+		/** Erases all the map contents and changes the cell size */
+		void setResolution(float resolution);
+		/** Returns the resolution of the grid map */
+		inline float getResolution() const { return m_resolution; }
+
+		/** Transform a coordinate value into a cell index */
+		inline int x2idx(double x) const { return static_cast<int>( floor(x*m_resolution_inv) ); }
+		inline int y2idx(double y) const { return static_cast<int>( floor(y*m_resolution_inv) ); }
+		/** Transform a cell index into the coordinate of the cell center */
+		inline float idx2x(int cx) const { return (cx+0.5f)*m_resolution; }
+		inline float idx2y(int cy) const { return (cy+0.5f)*m_resolution; }
+
+		/** Scales an integer representation of the log-odd into a real valued probability in [0,1], using p=exp(l)/(1+exp(l))  */
+		static inline float l2p(const cellType l) { return COccupancyGridMap2D::l2p(l); }
+		/** Scales an integer representation of the log-odd into a linear scale [0,255], using p=exp(l)/(1+exp(l)) */
+		static inline uint8_t l2p_255(const cellType l) { return COccupancyGridMap2D::l2p_255(l); }
+		/** Scales a real valued probability in [0,1] to an integer representation of: log(p)-log(1-p)  in the valid range of cellType */
+		static inline cellType p2l(const float p) { return COccupancyGridMap2D::p2l(p); }
+
+		/** Read the real valued [0,1] contents of a cell, given its index. Cells in non-allocated tiles are 0.5 */
+		inline float getCell(int cx,int cy) const {
+			const cellType *c = cellPtr(cx,cy,false);
+			return c ? l2p(*c) : 0.5f;
+		}
+		/** Change the contents [0,1] of a cell, given its index, allocating its tile if needed */
+		inline void setCell(int cx,int cy,float value) { *cellPtr(cx,cy,true) = p2l(value); }
+		/** Read the real valued [0,1] contents of a cell, given its coordinates */
+		inline float getPos(float x,float y) const { return getCell(x2idx(x),y2idx(y)); }
+		/** Change the contents [0,1] of a cell, given its coordinates */
+		inline void setPos(float x,float y,float value) { setCell(x2idx(x),y2idx(y),value); }
+		/** Performs the Bayesian fusion of a new observation of a cell, as in COccupancyGridMap2D::updateCell() */
+		void updateCell(int cx,int cy,float v);
+
+		/** Returns the limits of the area covered by allocated tiles (all zeros for an empty map) */
+		void getBoundingBox(float &x_min,float &x_max,float &y_min,float &y_max) const;
+		/** Number of allocated tiles, either in memory or swapped out to the backing file */
+		inline size_t getTileCount() const { return m_tiles.size(); }
+		/** Number of allocated tiles currently held in memory */
+		inline size_t getLoadedTileCount() const { return m_loaded_tiles; }
+
+		/** Copies the area [x_min,x_max]x[y_min,y_max] of this map into a regular occupancy grid with the same resolution (e.g. to use it with planners or Voronoi methods) */
+		void getAsOccupancyGridMap2D(COccupancyGridMap2D &out, float x_min,float x_max,float y_min,float y_max) const;
+		/** Copies the whole allocated area of this map into a regular occupancy grid with the same resolution \sa getBoundingBox */
+		void getAsOccupancyGridMap2D(COccupancyGridMap2D &out) const;
+
+		/** Computes the likelihood of a set of points, as in COccupancyGridMap2D::computeLikelihoodField_Thrun() */
+		double computeLikelihoodField_Thrun( const CPointsMap *pm, const mrpt::poses::CPose2D *relativePose = NULL) const;
+
+		bool isEmpty() const MRPT_OVERRIDE;
+		void saveMetricMapRepresentationToFile(const std::string &filNamePrefix) const MRPT_OVERRIDE;
+		void getAs3DObject(mrpt::opengl::CSetOfObjectsPtr &outObj) const MRPT_OVERRIDE;
+
+		COccupancyGridMap2D::TInsertionOptions  insertionOptions;  //!< Same options than COccupancyGridMap2D
+		COccupancyGridMap2D::TLikelihoodOptions likelihoodOptions; //!< Same options than COccupancyGridMap2D (only lmLikelihoodField_Thrun is supported, without likelihood cache)
+
+		/** Options for swapping out tiles to disk. See setPagingOptions() */
+		struct MAPS_IMPEXP TPagingOptions
+		{
+			TPagingOptions();
+			size_t      maxLoadedTiles; //!< (Default=0: unlimited) Max number of tiles held in memory. The least recently used ones are swapped out to backingFile when exceeded.
+			std::string backingFile;    //!< (Default="") Scratch file where swapped out tiles are stored. If empty, a temporary file is used. It is deleted upon destruction of the map.
+		};
+
+		/** Changes the paging options. Only tiles exceeding the new limit will be swapped out the next time a tile is allocated or loaded */
+		void setPagingOptions(const TPagingOptions &opts);
+		inline const TPagingOptions & getPagingOptions() const { return m_paging_options; }
+
+	protected:
+		/** A tile of cells, with the bookkeeping data for paging */
+		struct TTile
+		{
+			TTile() : file_offset(-1), last_access(0), dirty(true) { }
+			std::vector<cellType> cells;  //!< TILE_CELL_COUNT cells in row-major order, or empty while swapped out
+			int64_t  file_offset;         //!< Offset in the backing file of the last stored version of this tile, or -1 if none
+			uint64_t last_access;         //!< Stamp of the last access, for LRU eviction
+			bool     dirty;               //!< Modified since it was last written to the backing file
+		};
+		typedef std::map<uint64_t,TTile> TTileMap;
+
+		float m_resolution, m_resolution_inv;
+		TPagingOptions m_paging_options;
+
+		// The tile storage & its cache can be modified by const accessors, since they may swap tiles in or out.
+		mutable TTileMap m_tiles;
+		mutable uint64_t m_last_tile_key;
+		mutable TTile   *m_last_tile;     //!< Last accessed tile (or NULL), to avoid a map lookup for consecutive cells
+		mutable uint64_t m_access_counter;
+		mutable size_t   m_loaded_tiles;
+		mutable mrpt::utils::CFileStream *m_backing_file; //!< Created the first time a tile is swapped out
+		mutable std::string m_backing_file_name;
+		mutable uint64_t m_backing_file_size;
+		mutable int m_tile_x_min,m_tile_x_max,m_tile_y_min,m_tile_y_max; //!< Limits of the allocated tiles, in tile indices
+
+		static inline uint64_t tileKey(int tx,int ty) { return (static_cast<uint64_t>(static_cast<uint32_t>(tx))<<32) | static_cast<uint32_t>(ty); }
+		static inline int tileKeyX(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key>>32)); }
+		static inline int tileKeyY(uint64_t key) { return static_cast<int>(static_cast<uint32_t>(key)); }
+
+		/** Returns the tile with the given tile indices, loading it from the backing file if needed.
+		  * If it is not allocated, it is created if \a create is true, otherwise NULL is returned.
+		  * Pointers to other tiles may become invalid after this call, if they are swapped out. */
+		TTile * getTile(int tx,int ty,bool create) const;
+
+		/** Returns a pointer to the cell with the given indices, or NULL if its tile is not allocated and \a create is false.
+		  * Pointers to cells returned by former calls may become invalid if paging is enabled. */
+		inline cellType * cellPtr(int cx,int cy,bool create) const {
+			TTile *t = getTile(cx>>TILE_SIZE_LOG2,cy>>TILE_SIZE_LOG2,create);
+			if (!t) return NULL;
+			if (create) t->dirty = true;
+			return &t->cells[ (cx & (TILE_SIZE-1)) + ((cy & (TILE_SIZE-1))<<TILE_SIZE_LOG2) ];
+		}
+
+		/** Returns the cells of a tile without loading it if it is swapped out: in that case, they are read into \a buf */
+		const cellType * getTileCells(const TTile &t, std::vector<cellType> &buf) const;
+		void swapOutTiles() const; //!< Writes the least recently used tiles to the backing file until there are no more than maxLoadedTiles in memory
+		void closeBackingFile() const;
+		/** Copies the cells in [cx_min,cx_max]x[cy_min,cy_max] (all inclusive) into a regular occupancy grid */
+		void copyCellsToGridMap(COccupancyGridMap2D &out, int cx_min,int cx_max,int cy_min,int cy_max) const;
+
+		void internal_clear() MRPT_OVERRIDE;
+		bool internal_insertObservation( const mrpt::obs::CObservation *obs, const mrpt::poses::CPose3D *robotPose = NULL ) MRPT_OVERRIDE;
+		double internal_computeObservationLikelihood( const mrpt::obs::CObservation *obs, const mrpt::poses::CPose3D &takenFrom ) MRPT_OVERRIDE;
+		bool internal_canComputeObservationLikelihood( const mrpt::obs::CObservation *obs ) MRPT_OVERRIDE;
+
+		MAP_DEFINITION_START(CTiledOccupancyGridMap2D,MAPS_IMPEXP)
+			float       resolution;     //!< See CTiledOccupancyGridMap2D::CTiledOccupancyGridMap2D
+			uint64_t    maxLoadedTiles; //!< See CTiledOccupancyGridMap2D::TPagingOptions
+			std::string backingFile;    //!< See CTiledOccupancyGridMap2D::TPagingOptions
+			mrpt::maps::COccupancyGridMap2D::TInsertionOptions  insertionOpts;  //!< Observations insertion options
+			mrpt::maps::COccupancyGridMap2D::TLikelihoodOptions likelihoodOpts; //!< Probabilistic observation likelihood options
+		MAP_DEFINITION_END(CTiledOccupancyGridMap2D,MAPS_IMPEXP)
+	};
+	DEFINE_SERIALIZABLE_POST_CUSTOM_BASE_LINKAGE( CTiledOccupancyGridMap2D, CMetricMap, MAPS_IMPEXP )
+
+	} // End of namespace
+} // End of namespace
+
+#endif
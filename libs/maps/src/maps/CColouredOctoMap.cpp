@@ -195,7 +195,7 @@ bool CColouredOctoMap::internal_insertObservation(const mrpt::obs::CObservation
 		}
 
 		// Insert rays:
-		m_octomap.insertScan(scan, sensorPt, insertionOptions.maxrange, insertionOptions.pruning);
+		internal_insertPointCloud(scan, sensorPt);
 		return true;
 	}
 	else if ( IS_CLASS(obs,CObservation3DRangeScan) )
@@ -233,15 +233,10 @@ bool CColouredOctoMap::internal_insertObservation(const mrpt::obs::CObservation
 
 		// Insert rays:
 		octomap::KeySet free_cells, occupied_cells;
-		m_octomap.computeUpdate(scan, sensorPt, free_cells, occupied_cells, insertionOptions.maxrange);    
-		
+		internal_computeUpdate(scan, sensorPt, free_cells, occupied_cells);
+
 		// insert data into tree  -----------------------
-		for (octomap::KeySet::iterator it = free_cells.begin(); it != free_cells.end(); ++it) {
-			m_octomap.updateNode(*it, false, false);
-		}
-		for (octomap::KeySet::iterator it = occupied_cells.begin(); it != occupied_cells.end(); ++it) {
-			m_octomap.updateNode(*it, true, false);
-		}
+		internal_updateVoxels(free_cells, occupied_cells);
 
 		// Update color -----------------------
 		const float colF2B = 255.0f;
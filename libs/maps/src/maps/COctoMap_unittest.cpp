@@ -9,6 +9,8 @@
 
 
 #include <mrpt/maps/COctoMap.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/random.h>
 #include <gtest/gtest.h>
 
 using namespace mrpt;
@@ -76,3 +78,74 @@ TEST(COctoMapTests, insert2DScan)
 
 }
 
+
+// Random points on the walls, floor and ceiling of a box-shaped room:
+static void random_room_cloud(CSimplePointsMap &pts, octomap::Pointcloud &cloud)
+{
+	mrpt::random::CRandomGenerator rnd(1234);
+	for (int i=0;i<5000;i++)
+	{
+		float p[3] = { static_cast<float>(rnd.drawUniform(-4.0f,6.0f)), static_cast<float>(rnd.drawUniform(-3.0f,5.0f)), static_cast<float>(rnd.drawUniform(-0.5f,2.5f)) };
+		const int face = i % 6;
+		const float lims[3][2] = { {-4.0f,6.0f}, {-3.0f,5.0f}, {-0.5f,2.5f} };
+		p[face/2] = lims[face/2][face%2];
+		pts.insertPoint(p[0],p[1],p[2]);
+		cloud.push_back(p[0],p[1],p[2]);
+	}
+}
+
+TEST(COctoMapTests, insertPointCloudSameAsOctomap)
+{
+	CSimplePointsMap pts;
+	octomap::Pointcloud cloud;
+	random_room_cloud(pts,cloud);
+
+	for (int use_maxrange=0;use_maxrange<2;use_maxrange++)
+	{
+		COctoMap map(0.1), ref(0.1);
+		map.insertionOptions.maxrange = use_maxrange ? 4.0 : -1.0;
+
+		for (int k=0;k<3;k++)
+		{
+			const float sx = 0.5f*k, sy=-0.3f*k, sz=1.0f;
+			map.insertPointCloud(pts, sx,sy,sz);
+			ref.getOctomap().insertScan(cloud, octomap::point3d(sx,sy,sz), map.insertionOptions.maxrange, true);
+		}
+
+		ASSERT_EQ(ref.size(), map.size());
+		octomap::OcTree &tree = map.getOctomap();
+		size_t nLeafs = 0;
+		for (octomap::OcTree::leaf_iterator it=ref.getOctomap().begin_leafs();it!=ref.getOctomap().end_leafs();++it, ++nLeafs)
+		{
+			const octomap::OcTreeNode *n = tree.search(it.getKey(), it.getDepth());
+			ASSERT_TRUE(n!=NULL);
+			ASSERT_EQ(it->getLogOdds(), n->getLogOdds());
+		}
+		EXPECT_GT(nLeafs, 1000u);
+	}
+}
+
+TEST(COctoMapTests, insertPointCloudDiscretized)
+{
+	CSimplePointsMap pts;
+	octomap::Pointcloud cloud;
+	random_room_cloud(pts,cloud);
+
+	COctoMap map(0.1);
+	map.insertionOptions.discretizeScan = true;
+	map.insertPointCloud(pts, 0.5f,0.5f,1.0f);
+
+	// All scan end points are occupied, and the sensor voxel is free:
+	double occ;
+	for (size_t i=0;i<pts.size();i++)
+	{
+		float x,y,z;
+		pts.getPoint(i,x,y,z);
+		ASSERT_TRUE(map.getPointOccupancy(x,y,z, occ));
+		EXPECT_GT(occ, 0.5);
+	}
+	ASSERT_TRUE(map.getPointOccupancy(0.5f,0.5f,1.0f, occ));
+	EXPECT_LT(occ, 0.5);
+	ASSERT_TRUE(map.getPointOccupancy(2.0f,1.0f,1.2f, occ));
+	EXPECT_LT(occ, 0.5);
+}
@@ -589,13 +589,8 @@ void  CPointsMap::changeCoordinatesReference(const CPose2D	&newBase)
 {
 	const size_t N = x.size();
 
-	const CPose3D	newBase3D(newBase);
-
-	for (size_t i=0;i<N;i++)
-		newBase3D.composePoint(
-			x[i],y[i],z[i],  // In
-			x[i],y[i],z[i]   // Out
-		);
+	if (N)
+		newBase.composePoints(N, &x[0],&y[0], &x[0],&y[0]); // "z" remains unmodified
 
 	mark_as_modified();
 }
@@ -607,11 +602,8 @@ void  CPointsMap::changeCoordinatesReference(const CPose3D	&newBase)
 {
 	const size_t N = x.size();
 
-	for (size_t i=0;i<N;i++)
-		newBase.composePoint(
-			x[i],y[i],z[i],  // In
-			x[i],y[i],z[i]   // Out
-		);
+	if (N)
+		newBase.composePoints(N, &x[0],&y[0],&z[0], &x[0],&y[0],&z[0]);
 
 	mark_as_modified();
 }
@@ -1085,16 +1077,17 @@ void  CPointsMap::determineMatching3D(
 	// Transladar y rotar ya todos los puntos locales
 	vector<float> x_locals(nLocalPoints), y_locals(nLocalPoints), z_locals(nLocalPoints);
 
+	if (params.decimation_other_map_points==1)
+		otherMapPose.composePoints(nLocalPoints, &otherMap->x[0],&otherMap->y[0],&otherMap->z[0], &x_locals[0],&y_locals[0],&z_locals[0]);
+
 	for (unsigned int localIdx=params.offset_other_map_points;localIdx<nLocalPoints;localIdx+=params.decimation_other_map_points)
 	{
-		float x_local,y_local,z_local;
-		otherMapPose.composePoint(
-			otherMap->x[localIdx], otherMap->y[localIdx], otherMap->z[localIdx],
-			x_local,y_local,z_local );
+		if (params.decimation_other_map_points!=1)
+			otherMapPose.composePoint(
+				otherMap->x[localIdx], otherMap->y[localIdx], otherMap->z[localIdx],
+				x_locals[localIdx],y_locals[localIdx],z_locals[localIdx] );
 
-		x_locals[localIdx] = x_local;
-		y_locals[localIdx] = y_local;
-		z_locals[localIdx] = z_local;
+		const float x_local = x_locals[localIdx], y_local = y_locals[localIdx], z_local = z_locals[localIdx];
 
 		// Find the bounding box:
 		local_x_min = min(local_x_min,x_local);
@@ -1686,20 +1679,11 @@ void  CPointsMap::insertAnotherMap(
 	// Set the new size:
 	this->resize( N_this + N_other );
 
-	mrpt::math::TPoint3Df pt;
-	size_t src,dst;
-	for (src=0, dst=N_this; src<N_other; src++, dst++)
-	{
-		// Load the next point:
-		otherMap->getPointFast(src,pt.x,pt.y,pt.z);
-
-		// Translation:
-		double gx,gy,gz;
-		otherPose.composePoint(pt.x,pt.y,pt.z,  gx,gy,gz);
-
-		// Add to this map:
-		this->setPointFast(dst,gx,gy,gz);
-	}
+	// Transform all the points at once, straight into the new room:
+	if (N_other)
+		otherPose.composePoints(N_other,
+			&otherMap->x[0],&otherMap->y[0],&otherMap->z[0],
+			&x[N_this],&y[N_this],&z[N_this]);
 
 	// Also copy other data fields (color, ...)
 	addFrom_classSpecific(*otherMap, N_this);
@@ -146,6 +146,33 @@ void do_test_clipOutOfRange()
 
 }
 
+template <class MAP>
+void do_test_changeCoordinatesReference()
+{
+	MAP  pts0;
+	load_demo_9pts_map(pts0);
+
+	const CPose3D pose(1.0,2.0,3.0, DEG2RAD(20),DEG2RAD(-10),DEG2RAD(5));
+
+	MAP  pts = pts0;
+	pts.changeCoordinatesReference(pose);
+
+	MAP  pts2 = pts0;
+	pts2.insertAnotherMap(&pts0,pose);
+	EXPECT_EQ(pts2.size(),2*demo9_N);
+
+	for (size_t i=0;i<demo9_N;i++)
+	{
+		double gx,gy,gz;
+		pose.composePoint(demo9_xs[i],demo9_ys[i],demo9_zs[i], gx,gy,gz);
+		float x,y,z;
+		pts.getPoint(i,x,y,z);
+		EXPECT_NEAR(x,gx,1e-4); EXPECT_NEAR(y,gy,1e-4); EXPECT_NEAR(z,gz,1e-4);
+
+		pts2.getPoint(demo9_N+i,x,y,z);
+		EXPECT_NEAR(x,gx,1e-4); EXPECT_NEAR(y,gy,1e-4); EXPECT_NEAR(z,gz,1e-4);
+	}
+}
 
 TEST(CSimplePointsMapTests, insertPoints)
 {
@@ -193,3 +220,18 @@ TEST(CColouredPointsMapTests, clipOutOfRange)
 	do_test_clipOutOfRange<CColouredPointsMap>();
 }
 
+
+TEST(CSimplePointsMapTests, changeCoordinatesReference)
+{
+	do_test_changeCoordinatesReference<CSimplePointsMap>();
+}
+
+TEST(CWeightedPointsMapTests, changeCoordinatesReference)
+{
+	do_test_changeCoordinatesReference<CWeightedPointsMap>();
+}
+
+TEST(CColouredPointsMapTests, changeCoordinatesReference)
+{
+	do_test_changeCoordinatesReference<CColouredPointsMap>();
+}
@@ -0,0 +1,869 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include "maps-precomp.h" // Precomp header
+
+#include <mrpt/maps/CTiledOccupancyGridMap2D.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CObservationRange.h>
+#include <mrpt/opengl/CTexturedPlane.h>
+#include <mrpt/opengl/CSetOfObjects.h>
+#include <mrpt/utils/CFileStream.h>
+#include <mrpt/utils/CStream.h>
+#include <mrpt/utils/round.h> // round()
+#include <mrpt/system/filesystem.h>
+#include <algorithm>
+
+using namespace mrpt;
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+using namespace mrpt::math;
+using namespace mrpt::utils;
+using namespace std;
+
+//  =========== Begin of Map definition ============
+MAP_DEFINITION_REGISTER("CTiledOccupancyGridMap2D,tiledOccupancyGrid", mrpt::maps::CTiledOccupancyGridMap2D)
+
+CTiledOccupancyGridMap2D::TMapDefinition::TMapDefinition() :
+	resolution(0.05f),
+	maxLoadedTiles(0)
+{
+}
+
+void CTiledOccupancyGridMap2D::TMapDefinition::loadFromConfigFile_map_specific(const mrpt::utils::CConfigFileBase  &source, const std::string &sectionNamePrefix)
+{
+	// [<sectionNamePrefix>+"_creationOpts"]
+	const std::string sSectCreation = sectionNamePrefix+string("_creationOpts");
+	MRPT_LOAD_CONFIG_VAR(resolution, float,   source,sSectCreation);
+	MRPT_LOAD_CONFIG_VAR(maxLoadedTiles, uint64_t,   source,sSectCreation);
+	MRPT_LOAD_CONFIG_VAR(backingFile, string,   source,sSectCreation);
+
+	insertionOpts.loadFromConfigFile(source, sectionNamePrefix+string("_insertOpts") );
+	likelihoodOpts.loadFromConfigFile(source, sectionNamePrefix+string("_likelihoodOpts") );
+}
+
+void CTiledOccupancyGridMap2D::TMapDefinition::dumpToTextStream_map_specific(mrpt::utils::CStream &out) const
+{
+	LOADABLEOPTS_DUMP_VAR(resolution         , float);
+	LOADABLEOPTS_DUMP_VAR(maxLoadedTiles     , int);
+	LOADABLEOPTS_DUMP_VAR(backingFile        , string);
+
+	this->insertionOpts.dumpToTextStream(out);
+	this->likelihoodOpts.dumpToTextStream(out);
+}
+
+mrpt::maps::CMetricMap* CTiledOccupancyGridMap2D::internal_CreateFromMapDefinition(const mrpt::maps::TMetricMapInitializer &_def)
+{
+	const CTiledOccupancyGridMap2D::TMapDefinition &def = *dynamic_cast<const CTiledOccupancyGridMap2D::TMapDefinition*>(&_def);
+	CTiledOccupancyGridMap2D *obj = new CTiledOccupancyGridMap2D(def.resolution);
+	obj->insertionOptions  = def.insertionOpts;
+	obj->likelihoodOptions = def.likelihoodOpts;
+
+	CTiledOccupancyGridMap2D::TPagingOptions paging;
+	paging.maxLoadedTiles = static_cast<size_t>(def.maxLoadedTiles);
+	paging.backingFile    = def.backingFile;
+	obj->setPagingOptions(paging);
+	return obj;
+}
+//  =========== End of Map definition Block =========
+
+IMPLEMENTS_SERIALIZABLE(CTiledOccupancyGridMap2D, CMetricMap,mrpt::maps)
+
+CTiledOccupancyGridMap2D::TPagingOptions::TPagingOptions() :
+	maxLoadedTiles(0),
+	backingFile()
+{
+}
+
+/*---------------------------------------------------------------
+						Constructor
+  ---------------------------------------------------------------*/
+CTiledOccupancyGridMap2D::CTiledOccupancyGridMap2D( float resolution ) :
+	insertionOptions(),
+	likelihoodOptions(),
+	m_resolution(resolution),
+	m_resolution_inv(1.0f/resolution),
+	m_paging_options(),
+	m_tiles(),
+	m_last_tile_key(0),
+	m_last_tile(NULL),
+	m_access_counter(0),
+	m_loaded_tiles(0),
+	m_backing_file(NULL),
+	m_backing_file_name(),
+	m_backing_file_size(0),
+	m_tile_x_min(0),m_tile_x_max(0),m_tile_y_min(0),m_tile_y_max(0)
+{
+	ASSERT_(resolution>0)
+}
+
+CTiledOccupancyGridMap2D::CTiledOccupancyGridMap2D( const CTiledOccupancyGridMap2D &o ) :
+	CMetricMap(o),
+	m_last_tile(NULL),
+	m_backing_file(NULL)
+{
+	*this = o;
+}
+
+CTiledOccupancyGridMap2D & CTiledOccupancyGridMap2D::operator =(const CTiledOccupancyGridMap2D &o)
+{
+	if (this==&o) return *this;
+
+	internal_clear();
+	CMetricMap::operator =(o);
+	insertionOptions  = o.insertionOptions;
+	likelihoodOptions = o.likelihoodOptions;
+	m_resolution      = o.m_resolution;
+	m_resolution_inv  = o.m_resolution_inv;
+	m_paging_options  = TPagingOptions();
+
+	std::vector<cellType> buf;
+	for (TTileMap::const_iterator it=o.m_tiles.begin();it!=o.m_tiles.end();++it)
+	{
+		const cellType *src = o.getTileCells(it->second,buf);
+		TTile &t = m_tiles[it->first];
+		t.cells.assign(src, src+TILE_CELL_COUNT);
+	}
+	m_loaded_tiles = m_tiles.size();
+	m_tile_x_min = o.m_tile_x_min; m_tile_x_max = o.m_tile_x_max;
+	m_tile_y_min = o.m_tile_y_min; m_tile_y_max = o.m_tile_y_max;
+	return *this;
+}
+
+CTiledOccupancyGridMap2D::~CTiledOccupancyGridMap2D()
+{
+	closeBackingFile();
+}
+
+/*---------------------------------------------------------------
+						clear
+  ---------------------------------------------------------------*/
+void CTiledOccupancyGridMap2D::internal_clear()
+{
+	m_tiles.clear();
+	m_last_tile = NULL;
+	m_access_counter = 0;
+	m_loaded_tiles = 0;
+	m_tile_x_min = m_tile_x_max = m_tile_y_min = m_tile_y_max = 0;
+	closeBackingFile();
+}
+
+bool CTiledOccupancyGridMap2D::isEmpty() const
+{
+	return m_tiles.empty();
+}
+
+void CTiledOccupancyGridMap2D::setResolution(float resolution)
+{
+	ASSERT_(resolution>0)
+	internal_clear();
+	m_resolution = resolution;
+	m_resolution_inv = 1.0f/resolution;
+}
+
+void CTiledOccupancyGridMap2D::setPagingOptions(const TPagingOptions &opts)
+{
+	if (m_backing_file && opts.backingFile!=m_paging_options.backingFile)
+	{
+		// Bring back all swapped out tiles before switching to a different file:
+		for (TTileMap::iterator it=m_tiles.begin();it!=m_tiles.end();++it)
+		{
+			TTile &t = it->second;
+			if (t.cells.empty())
+			{
+				std::vector<cellType> buf;
+				const cellType *src = getTileCells(t,buf);
+				t.cells.swap(buf);
+				ASSERT_(src==&t.cells[0])
+				m_loaded_tiles++;
+			}
+			t.dirty = true;
+			t.file_offset = -1;
+		}
+		closeBackingFile();
+	}
+	m_paging_options = opts;
+}
+
+/*---------------------------------------------------------------
+						Tile management
+  ---------------------------------------------------------------*/
+CTiledOccupancyGridMap2D::TTile * CTiledOccupancyGridMap2D::getTile(int tx,int ty,bool create) const
+{
+	const uint64_t key = tileKey(tx,ty);
+	TTile *t;
+	if (m_last_tile && key==m_last_tile_key)
+	{
+		t = m_last_tile;
+	}
+	else
+	{
+		TTileMap::iterator it = m_tiles.find(key);
+		if (it==m_tiles.end())
+		{
+			if (!create)
+				return NULL;
+
+			// A new tile, initially with all its cells unknown:
+			if (m_tiles.empty())
+			{
+				m_tile_x_min = m_tile_x_max = tx;
+				m_tile_y_min = m_tile_y_max = ty;
+			}
+			else
+			{
+				keep_min(m_tile_x_min,tx); keep_max(m_tile_x_max,tx);
+				keep_min(m_tile_y_min,ty); keep_max(m_tile_y_max,ty);
+			}
+			t = &m_tiles[key];
+			t->cells.assign(TILE_CELL_COUNT, p2l(0.5f));
+			m_loaded_tiles++;
+		}
+		else
+		{
+			t = &it->second;
+			if (t->cells.empty())
+			{
+				// Swap in:
+				std::vector<cellType> buf;
+				getTileCells(*t,buf);
+				t->cells.swap(buf);
+				m_loaded_tiles++;
+			}
+		}
+		m_last_tile_key = key;
+		m_last_tile = t;
+	}
+
+	t->last_access = ++m_access_counter;
+
+	// This never swaps out "t", since it is the most recently used one:
+	if (m_paging_options.maxLoadedTiles && m_loaded_tiles>m_paging_options.maxLoadedTiles)
+		swapOutTiles();
+
+	return t;
+}
+
+const CTiledOccupancyGridMap2D::cellType * CTiledOccupancyGridMap2D::getTileCells(const TTile &t, std::vector<cellType> &buf) const
+{
+	if (!t.cells.empty())
+		return &t.cells[0];
+
+	ASSERT_(m_backing_file!=NULL && t.file_offset>=0)
+	buf.resize(TILE_CELL_COUNT);
+	m_backing_file->Seek(static_cast<uint64_t>(t.file_offset));
+	m_backing_file->ReadBuffer(&buf[0], sizeof(cellType)*TILE_CELL_COUNT);
+	return &buf[0];
+}
+
+void CTiledOccupancyGridMap2D::swapOutTiles() const
+{
+	MRPT_START
+
+	if (!m_backing_file)
+	{
+		m_backing_file_name = m_paging_options.backingFile.empty() ? mrpt::system::getTempFileName() : m_paging_options.backingFile;
+		m_backing_file = new CFileStream();
+		if (!m_backing_file->open(m_backing_file_name, fomRead | fomWrite))
+		{
+			delete m_backing_file;
+			m_backing_file = NULL;
+			THROW_EXCEPTION_CUSTOM_MSG1("Cannot create the tile backing file: '%s'",m_backing_file_name.c_str())
+		}
+		m_backing_file_size = 0;
+	}
+
+	// Swap out tiles down to 3/4 of the limit at once, so the cost of
+	//  finding the least recently used ones is amortized over many tile misses:
+	const size_t nKeep = std::max<size_t>(1, m_paging_options.maxLoadedTiles - m_paging_options.maxLoadedTiles/4);
+
+	std::vector<std::pair<uint64_t,TTile*> > loaded;
+	loaded.reserve(m_loaded_tiles);
+	for (TTileMap::iterator it=m_tiles.begin();it!=m_tiles.end();++it)
+		if (!it->second.cells.empty())
+			loaded.push_back( std::make_pair(it->second.last_access, &it->second) );
+
+	if (loaded.size()<=nKeep)
+		return;
+	const size_t nOut = loaded.size()-nKeep;
+	std::nth_element(loaded.begin(),loaded.begin()+nOut,loaded.end());
+
+	const size_t tileBytes = sizeof(cellType)*TILE_CELL_COUNT;
+	for (size_t i=0;i<nOut;i++)
+	{
+		TTile &t = *loaded[i].second;
+		if (t.dirty || t.file_offset<0)
+		{
+			if (t.file_offset<0)
+			{
+				t.file_offset = static_cast<int64_t>(m_backing_file_size);
+				m_backing_file_size += tileBytes;
+			}
+			m_backing_file->Seek(static_cast<uint64_t>(t.file_offset));
+			m_backing_file->WriteBuffer(&t.cells[0],tileBytes);
+			t.dirty = false;
+		}
+		std::vector<cellType>().swap(t.cells); // Really free the memory
+		m_loaded_tiles--;
+		if (m_last_tile==&t)
+			m_last_tile = NULL;
+	}
+
+	MRPT_END
+}
+
+void CTiledOccupancyGridMap2D::closeBackingFile() const
+{
+	if (!m_backing_file) return;
+
+	delete m_backing_file;
+	m_backing_file = NULL;
+	mrpt::system::deleteFile(m_backing_file_name);
+	m_backing_file_size = 0;
+}
+
+/*---------------------------------------------------------------
+						updateCell
+  ---------------------------------------------------------------*/
+void CTiledOccupancyGridMap2D::updateCell(int cx,int cy,float v)
+{
+	cellType &theCell = *cellPtr(cx,cy,true);
+
+	const cellType obs = p2l(v);  // The observation: will be >0 for free, <0 for occupied.
+	if (obs>0)
+	{
+		if ( theCell>(CELLTYPE_MAX-obs) )
+				theCell = CELLTYPE_MAX; // Saturate
+		else	theCell += obs;
+	}
+	else
+	{
+		if ( theCell<(CELLTYPE_MIN-obs) )
+				theCell = CELLTYPE_MIN; // Saturate
+		else	theCell += obs;
+	}
+}
+
+void CTiledOccupancyGridMap2D::getBoundingBox(float &x_min,float &x_max,float &y_min,float &y_max) const
+{
+	if (m_tiles.empty())
+	{
+		x_min = x_max = y_min = y_max = 0;
+		return;
+	}
+	const float tile_len = TILE_SIZE*m_resolution;
+	x_min = m_tile_x_min*tile_len;
+	x_max = (m_tile_x_max+1)*tile_len;
+	y_min = m_tile_y_min*tile_len;
+	y_max = (m_tile_y_max+1)*tile_len;
+}
+
+/*---------------------------------------------------------------
+					getAsOccupancyGridMap2D
+  ---------------------------------------------------------------*/
+void CTiledOccupancyGridMap2D::copyCellsToGridMap(COccupancyGridMap2D &out, int cx_min,int cx_max,int cy_min,int cy_max) const
+{
+	ASSERT_(cx_max>=cx_min && cy_max>=cy_min)
+
+	out.setSize(cx_min*m_resolution,(cx_max+1)*m_resolution, cy_min*m_resolution,(cy_max+1)*m_resolution, m_resolution, 0.5f);
+	ASSERT_EQUAL_(out.getSizeX(), static_cast<unsigned int>(cx_max-cx_min+1))
+	ASSERT_EQUAL_(out.getSizeY(), static_cast<unsigned int>(cy_max-cy_min+1))
+
+	for (int cy=cy_min;cy<=cy_max;cy++)
+	{
+		COccupancyGridMap2D::cellType *row = out.getRow(cy-cy_min);
+		for (int cx=cx_min;cx<=cx_max;cx++, row++)
+		{
+			const cellType *c = cellPtr(cx,cy,false);
+			if (c) *row = *c;
+		}
+	}
+}
+
+void CTiledOccupancyGridMap2D::getAsOccupancyGridMap2D(COccupancyGridMap2D &out, float x_min,float x_max,float y_min,float y_max) const
+{
+	copyCellsToGridMap(out, x2idx(x_min),x2idx(x_max), y2idx(y_min),y2idx(y_max));
+}
+
+void CTiledOccupancyGridMap2D::getAsOccupancyGridMap2D(COccupancyGridMap2D &out) const
+{
+	if (m_tiles.empty())
+		copyCellsToGridMap(out, 0,TILE_SIZE-1, 0,TILE_SIZE-1);
+	else
+		copyCellsToGridMap(out,
+			m_tile_x_min*TILE_SIZE, (m_tile_x_max+1)*TILE_SIZE-1,
+			m_tile_y_min*TILE_SIZE, (m_tile_y_max+1)*TILE_SIZE-1);
+}
+
+/*---------------------------------------------------------------
+						insertObservation
+  ---------------------------------------------------------------*/
+bool CTiledOccupancyGridMap2D::internal_insertObservation(
+	const CObservation *obs,
+	const CPose3D      *robotPose )
+{
+	MRPT_START
+
+#define FRBITS	9
+
+	if ( CLASS_ID(CObservation2DRangeScan)!=obs->GetRuntimeClass() )
+		return false;
+
+	const CObservation2DRangeScan *o = static_cast<const CObservation2DRangeScan*>( obs );
+
+	CPose3D robotPose3D;
+	if (robotPose)
+		robotPose3D = *robotPose;
+
+	const CPose3D sensorPose3D = robotPose3D + o->sensorPose;
+	const CPose2D laserPose( sensorPose3D );
+
+	// Insert only HORIZONTAL scans, at the altitude of the map (if feature enabled!)
+	if (!o->isPlanarScan( insertionOptions.horizontalTolerance ))
+		return false;
+	if ( insertionOptions.useMapAltitude && fabs(insertionOptions.mapAltitude - sensorPose3D.z() ) > 0.001 )
+		return false;
+
+	// Manage horizontal scans, but with the sensor bottom-up:
+	const bool sensorIsBottomwards = sensorPose3D.getHomogeneousMatrixVal().get_unsafe(2,2) < 0;
+
+	// Parameters values (same update rule than COccupancyGridMap2D):
+	const float maxDistanceInsertion = insertionOptions.maxDistanceInsertion;
+	const bool  invalidAsFree        = insertionOptions.considerInvalidRangesAsFreeSpace;
+
+	cellType logodd_observation = p2l(insertionOptions.maxOccupancyUpdateCertainty);
+	const cellType logodd_observation_occupied = 3*logodd_observation;
+	// Assure minimum change in cells!
+	if (logodd_observation<=0)
+		logodd_observation=1;
+
+	const cellType logodd_thres_occupied = CELLTYPE_MIN+logodd_observation_occupied;
+	const cellType logodd_thres_free     = CELLTYPE_MAX-logodd_observation;
+
+	const size_t nRanges = o->scan.size();
+	const size_t K = std::max<size_t>(1,insertionOptions.decimation);
+
+	double A, dAK;
+	if (o->rightToLeft ^ sensorIsBottomwards )
+	{
+		A  = laserPose.phi() - 0.5 * o->aperture;
+		dAK = K* o->aperture / nRanges;
+	}
+	else
+	{
+		A  = laserPose.phi() + 0.5 * o->aperture;
+		dAK = - (K*o->aperture / nRanges);
+	}
+
+	const float px = laserPose.x(), py = laserPose.y();
+	const int cx0 = x2idx(px), cy0 = y2idx(py);
+	float last_valid_range = maxDistanceInsertion;
+
+	// Since tiles are allocated on demand, there is no need to
+	//  precompute the scan bounding box and resize anything here:
+	for (size_t idx=0;idx<nRanges;idx+=K, A+=dAK)
+	{
+		float R;
+		if ( o->validRange[idx] )
+		{
+			R = min(maxDistanceInsertion,o->scan[idx]);
+			last_valid_range = o->scan[idx];
+		}
+		else if (invalidAsFree)
+			R = min(maxDistanceInsertion,0.5f*last_valid_range);
+		else continue;
+
+		const float scanPoint_x = px + cos(A)* R;
+		const float scanPoint_y = py + sin(A)* R;
+
+		// Target, in cell indexes:
+		const int trg_cx = x2idx(scanPoint_x);
+		const int trg_cy = y2idx(scanPoint_y);
+
+		// Use "fractional integers" to approximate float operations during the ray tracing:
+		const int Acx = trg_cx - cx0;
+		const int Acy = trg_cy - cy0;
+		const int nStepsRay = max( abs(Acx), abs(Acy) );
+		if (!nStepsRay) continue;
+
+		const float N_1 = 1.0f / nStepsRay;
+		const int frAcx = round( (Acx*(1<<FRBITS)) * N_1 );
+		const int frAcy = round( (Acy*(1<<FRBITS)) * N_1 );
+
+		int cx = cx0, cy = cy0;
+		int frCX = cx*(1<<FRBITS);
+		int frCY = cy*(1<<FRBITS);
+
+		for (int nStep = 0;nStep<nStepsRay;nStep++)
+		{
+			updateCell_fast_free(cellPtr(cx,cy,true), logodd_observation, logodd_thres_free);
+
+			frCX += frAcx;
+			frCY += frAcy;
+
+			cx = frCX >> FRBITS;
+			cy = frCY >> FRBITS;
+		}
+
+		// And finally, the occupied cell at the end, only if the ray was valid and not truncated:
+		if ( o->validRange[idx] && o->scan[idx]<maxDistanceInsertion )
+			updateCell_fast_occupied(cellPtr(trg_cx,trg_cy,true), logodd_observation_occupied, logodd_thres_occupied);
+	}
+
+	return true;
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+					computeObservationLikelihood
+  ---------------------------------------------------------------*/
+double CTiledOccupancyGridMap2D::internal_computeObservationLikelihood(
+	const CObservation *obs,
+	const CPose3D      &takenFrom3D )
+{
+	MRPT_START
+
+	ASSERTMSG_(likelihoodOptions.likelihoodMethod==COccupancyGridMap2D::lmLikelihoodField_Thrun, "CTiledOccupancyGridMap2D only implements the lmLikelihoodField_Thrun likelihood method")
+
+	const CPose2D takenFrom = CPose2D(takenFrom3D);  // 3D -> 2D, we are in a gridmap...
+
+	if ( IS_CLASS(obs, CObservation2DRangeScan) )
+	{
+		const CObservation2DRangeScan *o = static_cast<const CObservation2DRangeScan*>( obs );
+
+		// Ignore laser scans if they are not planar or they are not at the altitude of this grid map:
+		if (!o->isPlanarScan(insertionOptions.horizontalTolerance))
+			return -10;
+		if (insertionOptions.useMapAltitude && fabs(insertionOptions.mapAltitude - o->sensorPose.z() ) > 0.01 )
+			return -10;
+
+		CPointsMap::TInsertionOptions opts;
+		opts.minDistBetweenLaserPoints = m_resolution*0.5f;
+		opts.isPlanarMap               = true; // Already filtered above!
+		opts.horizontalTolerance       = insertionOptions.horizontalTolerance;
+
+		return computeLikelihoodField_Thrun( o->buildAuxPointsMap<mrpt::maps::CPointsMap>(&opts), &takenFrom );
+	}
+	else if ( IS_CLASS(obs, CObservationRange) )
+	{
+		// Sonar-like observations:
+		const CObservationRange *o = static_cast<const CObservationRange*>( obs );
+
+		CSimplePointsMap pts;
+		pts.insertionOptions.minDistBetweenLaserPoints = m_resolution*0.5f;
+		pts.insertObservation(o);
+
+		return computeLikelihoodField_Thrun( &pts, &takenFrom );
+	}
+
+	return 0;
+
+	MRPT_END
+}
+
+bool CTiledOccupancyGridMap2D::internal_canComputeObservationLikelihood( const CObservation *obs )
+{
+	if ( IS_CLASS(obs, CObservation2DRangeScan) )
+	{
+		const CObservation2DRangeScan *scan = static_cast<const CObservation2DRangeScan*>( obs );
+		if (!scan->isPlanarScan(insertionOptions.horizontalTolerance))
+			return false;
+		if (insertionOptions.useMapAltitude && fabs(insertionOptions.mapAltitude - scan->sensorPose.z() ) > 0.01 )
+			return false;
+		return true;
+	}
+	return IS_CLASS(obs, CObservationRange);
+}
+
+/*---------------------------------------------------------------
+					computeLikelihoodField_Thrun
+ ---------------------------------------------------------------*/
+double CTiledOccupancyGridMap2D::computeLikelihoodField_Thrun( const CPointsMap *pm, const CPose2D *relativePose ) const
+{
+	MRPT_START
+
+	const size_t N = pm->size();
+	if (!N)
+		return -100; // No way to estimate this likelihood!!
+
+	// The size of the checking area for matchings:
+	const int K = (int)ceil(likelihoodOptions.LF_maxCorrsDistance/*m*/ / m_resolution);
+	const bool Product_T_OrSum_F = !likelihoodOptions.LF_alternateAverageMethod;
+
+	const float zHit        = likelihoodOptions.LF_zHit;
+	const float zRandomTerm = likelihoodOptions.LF_zRandom / likelihoodOptions.LF_maxRange;
+	const float Q           = -0.5f / square(likelihoodOptions.LF_stdHit);
+
+	const double maxCorrDist_sq = square(likelihoodOptions.LF_maxCorrsDistance);
+	const double constDist2DiscrUnits = 100 / (m_resolution * m_resolution);
+	const double constDist2DiscrUnits_INV = 1.0 / constDist2DiscrUnits;
+	const unsigned int maxCorrDistInt = mrpt::utils::round( maxCorrDist_sq * constDist2DiscrUnits );
+
+	const cellType thresholdCellValue = p2l(0.5f);
+	size_t decimation = std::max<size_t>(1,likelihoodOptions.LF_decimation);
+	if (N<10) decimation = 1;
+
+	double ccos = 1, ssin = 0;
+	if (relativePose)
+	{
+		ccos = cos(relativePose->phi());
+		ssin = sin(relativePose->phi());
+	}
+
+	double ret = 0;
+	int    M = 0;
+	TPoint2D pointLocal, pointGlobal;
+
+	for (size_t j=0;j<N;j+=decimation)
+	{
+		// Get the point and pass it to global coordinates:
+		if (relativePose)
+		{
+			pm->getPoint(j,pointLocal);
+			pointGlobal.x = relativePose->x() + pointLocal.x * ccos - pointLocal.y * ssin;
+			pointGlobal.y = relativePose->y() + pointLocal.x * ssin + pointLocal.y * ccos;
+		}
+		else
+		{
+			pm->getPoint(j,pointGlobal);
+		}
+
+		const int cx = x2idx( pointGlobal.x );
+		const int cy = y2idx( pointGlobal.y );
+
+		// Find the closest occupied cell within the window [cx-K,cx+K]x[cy-K,cy+K],
+		//  tile by tile. Non-allocated tiles are skipped, since all their cells are unknown:
+		unsigned int occupiedMinDistInt = maxCorrDistInt;
+
+		const int xx1 = cx-K, xx2 = cx+K;
+		const int yy1 = cy-K, yy2 = cy+K;
+		for (int ty=(yy1>>TILE_SIZE_LOG2);ty<=(yy2>>TILE_SIZE_LOG2);ty++)
+		{
+			for (int tx=(xx1>>TILE_SIZE_LOG2);tx<=(xx2>>TILE_SIZE_LOG2);tx++)
+			{
+				const TTile *t = getTile(tx,ty,false);
+				if (!t) continue;
+
+				const int tile_cx0 = tx*TILE_SIZE, tile_cy0 = ty*TILE_SIZE;
+				const int x1 = std::max(xx1,tile_cx0), x2 = std::min(xx2,tile_cx0+TILE_SIZE-1);
+				const int y1 = std::max(yy1,tile_cy0), y2 = std::min(yy2,tile_cy0+TILE_SIZE-1);
+
+				for (int yy=y1;yy<=y2;yy++)
+				{
+					const cellType *mapPtr = &t->cells[ (x1-tile_cx0) + ((yy-tile_cy0)<<TILE_SIZE_LOG2) ];
+					const int Ay = 10*(yy-cy);
+					const unsigned int Ay2 = Ay*Ay;
+					int Ax = 10*(x1-cx);
+					for (int xx=x1;xx<=x2;xx++, Ax+=10)
+					{
+						if ( *mapPtr++ < thresholdCellValue )
+						{
+							const unsigned int d = Ax*Ax + Ay2;
+							keep_min(occupiedMinDistInt, d);
+						}
+					}
+				}
+			}
+		}
+
+		double occupiedMinDist = occupiedMinDistInt * constDist2DiscrUnits_INV;
+		if (likelihoodOptions.LF_useSquareDist)
+			occupiedMinDist*=occupiedMinDist;
+
+		const double thisLik = zRandomTerm  + zHit * exp( Q * occupiedMinDist );
+
+		// Update the likelihood:
+		if (Product_T_OrSum_F)
+		{
+			ret += log(thisLik);
+		}
+		else
+		{
+			ret += thisLik;
+			M++;
+		}
+	} // end of for each point in the scan
+
+	if (!Product_T_OrSum_F)
+		ret = log( ret / M );
+
+	return ret;
+
+	MRPT_END
+}
+
+/*---------------------------------------------------------------
+  Implements the writing to a CStream capability of CSerializable objects
+ ---------------------------------------------------------------*/
+void CTiledOccupancyGridMap2D::writeToStream(mrpt::utils::CStream &out, int *version) const
+{
+	if (version)
+		*version = 0;
+	else
+	{
+		out << uint8_t(sizeof(cellType)*8) << m_resolution << uint32_t(TILE_SIZE);
+
+		// insertionOptions:
+		out <<	insertionOptions.mapAltitude
+			<<	insertionOptions.useMapAltitude
+			<<	insertionOptions.maxDistanceInsertion
+			<<	insertionOptions.maxOccupancyUpdateCertainty
+			<<	insertionOptions.considerInvalidRangesAsFreeSpace
+			<<	insertionOptions.decimation
+			<<	insertionOptions.horizontalTolerance;
+
+		// Likelihood:
+		out	<<	(int32_t)likelihoodOptions.likelihoodMethod
+			<<	likelihoodOptions.LF_stdHit
+			<<	likelihoodOptions.LF_zHit
+			<<	likelihoodOptions.LF_zRandom
+			<<	likelihoodOptions.LF_maxRange
+			<<	likelihoodOptions.LF_decimation
+			<<	likelihoodOptions.LF_maxCorrsDistance
+			<<	likelihoodOptions.LF_useSquareDist
+			<<	likelihoodOptions.LF_alternateAverageMethod;
+
+		out << genericMapParams;
+
+		// Tiles (swapped out ones are read without loading them back in memory):
+		out << static_cast<uint32_t>(m_tiles.size());
+		std::vector<cellType> buf;
+		for (TTileMap::const_iterator it=m_tiles.begin();it!=m_tiles.end();++it)
+		{
+			out << static_cast<int32_t>(tileKeyX(it->first)) << static_cast<int32_t>(tileKeyY(it->first));
+			const cellType *cells = getTileCells(it->second,buf);
+#ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
+			out.WriteBuffer(cells, sizeof(cellType)*TILE_CELL_COUNT);
+#else
+			out.WriteBufferFixEndianness(cells, TILE_CELL_COUNT);
+#endif
+		}
+	}
+}
+
+/*---------------------------------------------------------------
+  Implements the reading from a CStream capability of CSerializable objects
+ ---------------------------------------------------------------*/
+void CTiledOccupancyGridMap2D::readFromStream(mrpt::utils::CStream &in, int version)
+{
+	switch(version)
+	{
+	case 0:
+		{
+			uint8_t bitsPerCell;
+			uint32_t tileSize;
+			float resolution;
+			in >> bitsPerCell >> resolution >> tileSize;
+			if (bitsPerCell!=sizeof(cellType)*8)
+				THROW_EXCEPTION("Cannot load a tiled gridmap saved with a different cell size (see OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS).")
+			ASSERT_EQUAL_(tileSize, static_cast<uint32_t>(TILE_SIZE))
+
+			setResolution(resolution);
+
+			// insertionOptions:
+			in	>>	insertionOptions.mapAltitude
+				>>	insertionOptions.useMapAltitude
+				>>	insertionOptions.maxDistanceInsertion
+				>>	insertionOptions.maxOccupancyUpdateCertainty
+				>>	insertionOptions.considerInvalidRangesAsFreeSpace
+				>>	insertionOptions.decimation
+				>>	insertionOptions.horizontalTolerance;
+
+			// Likelihood:
+			int32_t i;
+			in >> i;
+			likelihoodOptions.likelihoodMethod = static_cast<COccupancyGridMap2D::TLikelihoodMethod>(i);
+			in	>>	likelihoodOptions.LF_stdHit
+				>>	likelihoodOptions.LF_zHit
+				>>	likelihoodOptions.LF_zRandom
+				>>	likelihoodOptions.LF_maxRange
+				>>	likelihoodOptions.LF_decimation
+				>>	likelihoodOptions.LF_maxCorrsDistance
+				>>	likelihoodOptions.LF_useSquareDist
+				>>	likelihoodOptions.LF_alternateAverageMethod;
+
+			in >> genericMapParams;
+
+			uint32_t nTiles;
+			in >> nTiles;
+			for (uint32_t k=0;k<nTiles;k++)
+			{
+				int32_t tx,ty;
+				in >> tx >> ty;
+				TTile *t = getTile(tx,ty,true);
+#ifdef OCCUPANCY_GRIDMAP_CELL_SIZE_8BITS
+				in.ReadBuffer(&t->cells[0], sizeof(cellType)*TILE_CELL_COUNT);
+#else
+				in.ReadBufferFixEndianness(&t->cells[0], TILE_CELL_COUNT);
+#endif
+			}
+		} break;
+	default:
+		MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version)
+	};
+}
+
+/*---------------------------------------------------------------
+					saveMetricMapRepresentationToFile
+  ---------------------------------------------------------------*/
+void CTiledOccupancyGridMap2D::saveMetricMapRepresentationToFile(const std::string &filNamePrefix) const
+{
+	COccupancyGridMap2D grid;
+	getAsOccupancyGridMap2D(grid);
+	grid.saveMetricMapRepresentationToFile(filNamePrefix);
+}
+
+/*---------------------------------------------------------------
+						getAs3DObject
+---------------------------------------------------------------*/
+void CTiledOccupancyGridMap2D::getAs3DObject( mrpt::opengl::CSetOfObjectsPtr &outSetOfObj ) const
+{
+	if (!genericMapParams.enableSaveAs3DObject) return;
+
+	MRPT_START
+
+	// One textured plane per tile, so the size of textures does not grow with the map:
+	const float tile_len = TILE_SIZE*m_resolution;
+	std::vector<cellType> buf;
+	for (TTileMap::const_iterator it=m_tiles.begin();it!=m_tiles.end();++it)
+	{
+		const int tx = tileKeyX(it->first), ty = tileKeyY(it->first);
+
+		opengl::CTexturedPlanePtr outObj = opengl::CTexturedPlane::Create();
+		outObj->setPlaneCorners(tx*tile_len,(tx+1)*tile_len, ty*tile_len,(ty+1)*tile_len);
+		outObj->setLocation(0,0, insertionOptions.mapAltitude );
+
+		// Create the color & transparecy (alpha) images:
+		CImage imgColor(TILE_SIZE,TILE_SIZE,1);
+		CImage imgTrans(TILE_SIZE,TILE_SIZE,1);
+
+		const cellType *srcPtr = getTileCells(it->second,buf);
+		for (int y=0;y<TILE_SIZE;y++)
+		{
+			unsigned char *destPtr_color = imgColor(0,y);
+			unsigned char *destPtr_trans = imgTrans(0,y);
+			for (int x=0;x<TILE_SIZE;x++)
+			{
+				uint8_t  cell255 = l2p_255(*srcPtr++);
+				*destPtr_color++ = cell255;
+
+				int8_t   auxC = (int8_t)((signed short)cell255)-127;
+				*destPtr_trans++ = auxC>0 ? (auxC << 1) : ((-auxC) << 1);
+			}
+		}
+
+		outObj->assignImage_fast( imgColor,imgTrans );
+		outSetOfObj->insert( outObj );
+	}
+
+	MRPT_END
+}
@@ -0,0 +1,130 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+
+#include <mrpt/maps/CTiledOccupancyGridMap2D.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/utils/CMemoryStream.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::utils;
+using namespace mrpt::poses;
+using namespace mrpt::math;
+using namespace std;
+
+// A scan taken from "pose" inside the rectangular room [x0,x1]x[y0,y1]:
+static void simulate_room_scan(const CPose2D &pose, CObservation2DRangeScan &scan)
+{
+	const double x0=-5.03, x1=7.07, y0=-3.96, y1=6.02; // Walls not aligned with cell boundaries
+	const size_t N = 361;
+	scan.aperture = M_PIf;
+	scan.rightToLeft = true;
+	scan.maxRange = 20;
+	scan.scan.resize(N);
+	scan.validRange.resize(N);
+	for (size_t i=0;i<N;i++)
+	{
+		const double a = pose.phi() - 0.5*M_PI + i*M_PI/N;
+		const double c = cos(a), s = sin(a);
+		double r = 1e9;
+		if (c>1e-9)  r = std::min(r, (x1-pose.x())/c);
+		if (c<-1e-9) r = std::min(r, (x0-pose.x())/c);
+		if (s>1e-9)  r = std::min(r, (y1-pose.y())/s);
+		if (s<-1e-9) r = std::min(r, (y0-pose.y())/s);
+		scan.scan[i] = static_cast<float>(r);
+		scan.validRange[i] = (i%50)!=7; // Some invalid ranges, too
+	}
+}
+
+static void insert_test_scans(CMetricMap &map)
+{
+	const CPose2D poses[] = { CPose2D(0.03,0.02,0), CPose2D(2.1,1.3,DEG2RAD(60)), CPose2D(-3,-2,DEG2RAD(-150)), CPose2D(5.2,4.1,DEG2RAD(200)) };
+	for (size_t i=0;i<sizeof(poses)/sizeof(poses[0]);i++)
+	{
+		CObservation2DRangeScan scan;
+		simulate_room_scan(poses[i],scan);
+		const CPose3D p(poses[i]);
+		map.insertObservation(&scan,&p);
+	}
+}
+
+TEST(CTiledOccupancyGridMap2D, sameAsOccupancyGridMap2D)
+{
+	// A resolution exactly representable in binary, so both maps share cell boundaries:
+	const float res = 0.125f;
+	COccupancyGridMap2D grid(-16,16,-16,16,res);
+	CTiledOccupancyGridMap2D tiled(res);
+
+	insert_test_scans(grid);
+	insert_test_scans(tiled);
+
+	EXPECT_EQ(tiled.getTileCount(), 4u);
+	for (float y=-15.9375f;y<16;y+=res)
+		for (float x=-15.9375f;x<16;x+=res)
+			ASSERT_EQ(grid.getPos(x,y), tiled.getPos(x,y)) << "x=" << x << " y=" << y;
+
+	// Same likelihood values:
+	CObservation2DRangeScan scan;
+	simulate_room_scan(CPose2D(1,0.5,DEG2RAD(10)),scan);
+	for (double dx=-0.4;dx<=0.4;dx+=0.2)
+	{
+		const CPose3D p(1+dx,0.5,0, DEG2RAD(10),0,0);
+		EXPECT_NEAR(grid.computeObservationLikelihood(&scan,p), tiled.computeObservationLikelihood(&scan,p), 1e-6);
+	}
+
+	// Conversion back to a regular gridmap:
+	COccupancyGridMap2D grid2;
+	tiled.getAsOccupancyGridMap2D(grid2);
+	for (float y=-7.9375f;y<8;y+=res)
+		for (float x=-7.9375f;x<8;x+=res)
+			ASSERT_EQ(grid.getPos(x,y), grid2.getPos(x,y));
+}
+
+TEST(CTiledOccupancyGridMap2D, paging)
+{
+	CTiledOccupancyGridMap2D ref(0.05f), paged(0.05f);
+
+	CTiledOccupancyGridMap2D::TPagingOptions po;
+	po.maxLoadedTiles = 2;
+	paged.setPagingOptions(po);
+
+	insert_test_scans(ref);
+	insert_test_scans(paged);
+
+	ASSERT_EQ(ref.getTileCount(), paged.getTileCount());
+	EXPECT_EQ(paged.getTileCount(), 6u);
+	EXPECT_LE(paged.getLoadedTileCount(), 2u);
+
+	for (float y=-6;y<8;y+=0.05f)
+		for (float x=-7;x<9;x+=0.05f)
+		{
+			ASSERT_EQ(ref.getPos(x,y), paged.getPos(x,y));
+			ASSERT_LE(paged.getLoadedTileCount(), 2u);
+		}
+
+	// Serialization includes the swapped out tiles:
+	CMemoryStream buf;
+	buf << paged;
+	buf.Seek(0);
+	CTiledOccupancyGridMap2D loaded;
+	buf >> loaded;
+	EXPECT_EQ(loaded.getTileCount(), paged.getTileCount());
+
+	// And so do copies:
+	const CTiledOccupancyGridMap2D copy(paged);
+	for (float y=-6;y<8;y+=0.05f)
+		for (float x=-7;x<9;x+=0.05f)
+		{
+			ASSERT_EQ(ref.getPos(x,y), loaded.getPos(x,y));
+			ASSERT_EQ(ref.getPos(x,y), copy.getPos(x,y));
+		}
+}
@@ -41,6 +41,7 @@ void registerAllClasses_mrpt_maps()
 	registerClass( CLASS_ID( CHeightGridMap2D ) );
 	registerClass( CLASS_ID( CHeightGridMap2D_MRF ) );
 	registerClass( CLASS_ID( CReflectivityGridMap2D ) );
+	registerClass( CLASS_ID( CTiledOccupancyGridMap2D ) );
 
 	registerClass( CLASS_ID( COctoMap ) );
 	registerClass( CLASS_ID( CColouredOctoMap ) );
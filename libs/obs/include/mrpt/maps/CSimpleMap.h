@@ -49,7 +49,8 @@ namespace maps
 		  * \return false on any error. */
 		bool saveToFile(const std::string &filName) const;
 
-		/** Load the contents of this object from a .simplemap binary file (possibly compressed with gzip)
+		/** Load the contents of this object from a .simplemap binary file (possibly compressed with gzip).
+		  * Uncompressed files are read through mrpt::utils::CFileMMapInputStream.
 		  * \sa saveToFile
 		  * \return false on any error. */
 		bool loadFromFile(const std::string &filName);
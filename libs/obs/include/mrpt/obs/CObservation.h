@@ -127,6 +127,11 @@ namespace mrpt
 		  * \sa load
 		  */
 		virtual void unload() { /* Default implementation: do nothing */ }
+		/** Starts decoding all the externally stored images of this observation in background threads, so they are (or are being) already decoded
+		  *  when accessed. It returns immediately. See mrpt::utils::CImage::prefetch(). Called by mrpt::obs::CRawlog while iterating a dataset sequentially.
+		  * \sa load
+		  */
+		virtual void prefetch() const { /* Default implementation: do nothing */ }
 
 		/** @} */
 
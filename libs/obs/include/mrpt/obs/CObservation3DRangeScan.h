@@ -34,7 +34,8 @@ namespace obs
 		const mrpt::poses::CPose3D *robotPoseInTheWorld; //!< (Default: NULL) Read takeIntoAccountSensorPoseOnRobot
 		bool PROJ3D_USE_LUT; //!< (Default:true) [Only used when `range_is_depth`=true] Whether to use a Look-up-table (LUT) to speed up the conversion. It's thread safe in all situations <b>except</b> when you call this method from different threads <b>and</b> with different camera parameter matrices. In all other cases, it is a good idea to left it enabled.
 		bool USE_SSE2; //!< (Default:true) If possible, use SSE2 optimized code.
-		T3DPointsProjectionParams() :  takeIntoAccountSensorPoseOnRobot(false), robotPoseInTheWorld(NULL), PROJ3D_USE_LUT(true),USE_SSE2(true)
+		int  decimation; //!< (Default:1) If >1, only one out of every `decimation` rows and columns of the range image is projected.
+		T3DPointsProjectionParams() :  takeIntoAccountSensorPoseOnRobot(false), robotPoseInTheWorld(NULL), PROJ3D_USE_LUT(true),USE_SSE2(true),decimation(1)
 		{}
 	};
 	/** Used in CObservation3DRangeScan::convertTo2DScan() */
@@ -56,6 +57,19 @@ namespace obs
 		// Implemented in CObservation3DRangeScan_project3D_impl.h
 		template <class POINTMAP>
 		void project3DPointsFromDepthImageInto(mrpt::obs::CObservation3DRangeScan & src_obs,POINTMAP & dest_pointcloud, const mrpt::obs::T3DPointsProjectionParams & projectParams, const mrpt::obs::TRangeImageFilterParams &filterParams);
+
+		/** Evaluates the range filters for all pixels of a range image (or only one out of every `decimation` rows and columns), in parallel for the different rows.
+		  * \param[out] valid_mask One byte per pixel (0:invalid, 1:valid), for row `k*decimation` and column `c` at `valid_mask[k*W+c]`. Pixels not in a decimated column are left undefined.
+		  * \param[out] row_offsets For each decimated row `k`, the number of valid pixels in all the previous rows. It has one extra entry at the end with the total number of valid pixels.
+		  * \note Implemented in CObservation3DRangeScan.cpp
+		  */
+		void OBS_IMPEXP evaluateRangeImageFilter(
+			const mrpt::math::CMatrix &rangeImage,
+			const mrpt::obs::TRangeImageFilterParams &filterParams,
+			const int decimation,
+			const bool use_SSE2,
+			std::vector<uint8_t> &valid_mask,
+			std::vector<size_t> &row_offsets);
 	}
 
 	DEFINE_SERIALIZABLE_PRE_CUSTOM_BASE_LINKAGE( CObservation3DRangeScan, CObservation,OBS_IMPEXP )
@@ -164,6 +178,8 @@ namespace obs
 		  * \sa load
 		  */
 		virtual void unload() MRPT_OVERRIDE;
+		/** Starts decoding the external intensity and confidence images in background threads (see CObservation::prefetch) */
+		virtual void prefetch() const MRPT_OVERRIDE;
 		/** @} */
 
 		/** Project the RGB+D images into a 3D point cloud (with color if the target map supports it) and optionally at a given 3D pose.
@@ -198,6 +214,9 @@ namespace obs
 		  *  By default the local (sensor-centric) coordinates of points are directly stored into the local map, but if indicated so in \a takeIntoAccountSensorPoseOnRobot
 		  *  the points are transformed with \a sensorPose. Furthermore, if provided, those coordinates are transformed with \a robotPoseInTheWorld
 		  *
+		  *  Range filtering, projection, coloring and the 6D transformation are all done in one single pass, writing directly into the output point cloud.
+		  *  Rows are processed in parallel if MRPT is built with TBB.
+		  *
 		  * \tparam POINTMAP Supported maps are all those covered by mrpt::utils::PointCloudAdapter (mrpt::maps::CPointsMap and derived, mrpt::opengl::CPointCloudColoured, PCL point clouds,...)
 		  *
 		  * \note In MRPT < 0.9.5, this method always assumes that ranges were in Kinect-like format.
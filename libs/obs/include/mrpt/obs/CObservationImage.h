@@ -65,6 +65,7 @@ namespace obs
 		void getSensorPose( mrpt::poses::CPose3D &out_sensorPose ) const MRPT_OVERRIDE { out_sensorPose = cameraPose; }
 		void setSensorPose( const mrpt::poses::CPose3D &newSensorPose ) MRPT_OVERRIDE { cameraPose = newSensorPose; }
 		void getDescriptionAsText(std::ostream &o) const MRPT_OVERRIDE;
+		void prefetch() const MRPT_OVERRIDE { image.prefetch(); }
 
 	}; // End of class def.
 	DEFINE_SERIALIZABLE_POST_CUSTOM_BASE_LINKAGE( CObservationImage , CObservation,OBS_IMPEXP )
@@ -111,6 +111,7 @@ namespace obs
 		void getSensorPose( mrpt::poses::CPose3D &out_sensorPose ) const MRPT_OVERRIDE { out_sensorPose = cameraPose; }
 		void setSensorPose( const mrpt::poses::CPose3D &newSensorPose ) MRPT_OVERRIDE { cameraPose = mrpt::poses::CPose3DQuat(newSensorPose); }
 		void getDescriptionAsText(std::ostream &o) const MRPT_OVERRIDE;
+		void prefetch() const MRPT_OVERRIDE;
 
 		void swap( CObservationStereoImages &o); //!< Do an efficient swap of all data members of this object with "o".
 
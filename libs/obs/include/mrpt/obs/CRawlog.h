@@ -60,6 +60,9 @@ namespace mrpt
 
 			CObservationComment		m_commentTexts;	//!< Comments of the rawlog.
 
+			mutable volatile size_t	m_last_accessed;	//!< Index of the last entry returned by getAsObservations() or getAsObservation(), used to detect sequential reads. Only accessed with atomic operations, since these const methods may be called from several threads.
+			void prefetchAfter(size_t index) const;		//!< Called from getAsObservations()/getAsObservation() to start decoding in advance the delayed-load images of the next entries, if the rawlog is being read sequentially.
+
 		public:
 			void getCommentText( std::string &t) const;	//!< Returns the block of comment text for the rawlog
 			std::string getCommentText() const;			//!< Returns the block of comment text for the rawlog
@@ -132,6 +135,8 @@ namespace mrpt
 
 			/** Saves the contents to a rawlog-file, compatible with RawlogViewer (As the sequence of internal objects).
 			  *  The file is saved with gz-commpressed if MRPT has gz-streams.
+			  *  Objects are written with the class ID dictionary enabled (see mrpt::utils::CStream::enableClassIDDictionary()), so the
+			  *  file must be read sequentially from its beginning, as done by loadFromRawLogFile() and all the MRPT apps.
 			  * \returns It returns false if any error is found while writing/creating the target file.
 			  */
 			bool saveToRawLogFile( const std::string &fileName ) const;
@@ -163,6 +168,7 @@ namespace mrpt
 
 			/** Returns the i'th element in the sequence, as being an action, where index=0 is the first object.
 			  *  If it is not an CSensoryFrame, it throws an exception. Do neighter modify nor delete the returned pointer.
+			  *  If the entries are being read sequentially, the delayed-load images of the next few entries are decoded in advance (see mrpt::obs::CObservation::prefetch() and mrpt::utils::CImage::setExternalImagesCacheSize()).
 			  * \sa size, isAction, getAsAction, getAsObservation
 			  * \exception std::exception If index is out of bounds
 			  */
@@ -177,6 +183,7 @@ namespace mrpt
 			/** Returns the i'th element in the sequence, as being an observation, where index=0 is the first object.
 			  *  If it is not an CObservation, it throws an exception. Do neighter modify nor delete the returned pointer.
 			  *  This is the proper method to obtain the objects stored in a "only observations"-rawlog file (named "format #2" above.
+			  *  If the entries are being read sequentially, the delayed-load images of the next few entries are decoded in advance (see mrpt::obs::CObservation::prefetch() and mrpt::utils::CImage::setExternalImagesCacheSize()).
 			  * \sa size, isAction, getAsAction
 			  * \exception std::exception If index is out of bounds
 			  */
@@ -230,17 +230,17 @@ void  CActionRobotMovement3D::computeFromOdometry_model6DOF(
 		float Ayaw2_draw=Ayaw2 +(o.mm6DOFModel.a9*Ayaw2+o.mm6DOFModel.a10*Atrans)* randomGenerator.drawGaussian1D_normalized();
 
 		// Output:
-		aux->m_particles[i].d->x( Atrans_draw * sin( Apitch1_draw )*cos(Ayaw1_draw) + motionModelConfiguration.mm6DOFModel.additional_std_XYZ * randomGenerator.drawGaussian1D_normalized() );
-		aux->m_particles[i].d->y( Atrans_draw * sin( Apitch1_draw )*sin(Ayaw1_draw) + motionModelConfiguration.mm6DOFModel.additional_std_XYZ * randomGenerator.drawGaussian1D_normalized() );
-		aux->m_particles[i].d->z( Atrans_draw * cos( Apitch1_draw ) + motionModelConfiguration.mm6DOFModel.additional_std_XYZ * randomGenerator.drawGaussian1D_normalized() );
+		aux->m_particles[i].d.x( Atrans_draw * sin( Apitch1_draw )*cos(Ayaw1_draw) + motionModelConfiguration.mm6DOFModel.additional_std_XYZ * randomGenerator.drawGaussian1D_normalized() );
+		aux->m_particles[i].d.y( Atrans_draw * sin( Apitch1_draw )*sin(Ayaw1_draw) + motionModelConfiguration.mm6DOFModel.additional_std_XYZ * randomGenerator.drawGaussian1D_normalized() );
+		aux->m_particles[i].d.z( Atrans_draw * cos( Apitch1_draw ) + motionModelConfiguration.mm6DOFModel.additional_std_XYZ * randomGenerator.drawGaussian1D_normalized() );
 
 
 		double new_yaw= Ayaw1_draw + Ayaw2_draw + motionModelConfiguration.mm6DOFModel.additional_std_angle * randomGenerator.drawGaussian1D_normalized();
 		double new_pitch=	Apitch1_draw + Apitch2_draw + motionModelConfiguration.mm6DOFModel.additional_std_angle * randomGenerator.drawGaussian1D_normalized() ;
 		double new_roll = Aroll_draw + motionModelConfiguration.mm6DOFModel.additional_std_angle * randomGenerator.drawGaussian1D_normalized() ;
 
-		aux->m_particles[i].d->setYawPitchRoll(new_yaw,new_pitch,new_roll);
-		aux->m_particles[i].d->normalizeAngles();
+		aux->m_particles[i].d.setYawPitchRoll(new_yaw,new_pitch,new_roll);
+		aux->m_particles[i].d.normalizeAngles();
 
 	}
 
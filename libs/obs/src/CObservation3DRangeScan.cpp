@@ -23,6 +23,8 @@
 #include <mrpt/utils/CConfigFileMemory.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/string_utils.h>
+#include <mrpt/system/parallelization.h>
+#include <mrpt/utils/SSE_types.h>
 
 #include <limits>
 
@@ -458,6 +460,12 @@ void CObservation3DRangeScan::unload()
 	confidenceImage.unload();
 }
 
+void CObservation3DRangeScan::prefetch() const
+{
+	if (hasIntensityImage) intensityImage.prefetch();
+	if (hasConfidenceImage) confidenceImage.prefetch();
+}
+
 void CObservation3DRangeScan::rangeImage_getExternalStorageFileAbsolutePath(std::string &out_path) const
 {
 	ASSERT_(m_rangeImage_external_file.size()>2);
@@ -894,6 +902,152 @@ void CObservation3DRangeScan::convertTo2DScan(
 	convertTo2DScan(out_scan2d, sp,fp);
 }
 
+namespace mrpt {
+namespace obs {
+namespace detail {
+	/** Evaluates the range filters for a range of (decimated) rows. See evaluateRangeImageFilter() */
+	struct TRangeImageFilterRows
+	{
+		const mrpt::math::CMatrix &rangeImage;
+		const TRangeImageFilterParams &fp;
+		const int decimation;
+		const bool use_SSE2;
+		uint8_t *valid_mask;
+		size_t  *row_counts;
+
+		TRangeImageFilterRows(const mrpt::math::CMatrix &rangeImage_, const TRangeImageFilterParams &fp_, const int decimation_, const bool use_SSE2_, uint8_t *valid_mask_, size_t *row_counts_) :
+			rangeImage(rangeImage_), fp(fp_), decimation(decimation_), use_SSE2(use_SSE2_), valid_mask(valid_mask_), row_counts(row_counts_)
+		{ }
+
+		void operator()(const mrpt::system::BlockedRange &range) const
+		{
+			const int W = rangeImage.cols();
+			const TRangeImageFilter rif(fp);
+
+			for (int k=range.begin();k<range.end();k++)
+			{
+				const int r = k*decimation;
+				uint8_t *valid = valid_mask + k*W;
+				size_t nValid = 0;
+				int c = 0;
+#if MRPT_HAS_SSE2
+				if (use_SSE2 && decimation==1)
+				{
+					// Same conditions than TRangeImageFilter::do_range_filter(), for 4 pixels at once:
+					const float *D_ptr = &rangeImage.coeffRef(r,0);
+					const float *Dmin_ptr = !fp.rangeMask_min ? NULL : &fp.rangeMask_min->coeffRef(r,0);
+					const float *Dmax_ptr = !fp.rangeMask_max ? NULL : &fp.rangeMask_max->coeffRef(r,0);
+					const __m128 zeros = _mm_setzero_ps();
+					const __m128 ones  = _mm_cmpeq_ps(zeros,zeros);
+					for (;c+4<=W;c+=4)
+					{
+						const __m128 D = _mm_loadu_ps(D_ptr+c);
+						__m128 valid_range_mask = _mm_cmpgt_ps(D, zeros); // Skip D=0 points
+						if (Dmin_ptr || Dmax_ptr)
+						{
+							__m128 pass_gt = ones, pass_lt = ones, has_min = zeros, has_max = zeros;
+							if (Dmin_ptr) {
+								const __m128 Dmin = _mm_loadu_ps(Dmin_ptr+c);
+								has_min = _mm_cmpneq_ps(Dmin, zeros);
+								pass_gt = _mm_or_ps(_mm_cmpge_ps(D,Dmin), _mm_cmpeq_ps(Dmin, zeros));
+							}
+							if (Dmax_ptr) {
+								const __m128 Dmax = _mm_loadu_ps(Dmax_ptr+c);
+								has_max = _mm_cmpneq_ps(Dmax, zeros);
+								pass_lt = _mm_or_ps(_mm_cmple_ps(D,Dmax), _mm_cmpeq_ps(Dmax, zeros));
+							}
+							__m128 pass = _mm_and_ps(pass_gt,pass_lt);
+							if (!fp.rangeCheckBetween) // Invert the selection only where both filters are defined:
+								pass = _mm_xor_ps(pass, _mm_and_ps(has_min,has_max));
+							valid_range_mask = _mm_and_ps(valid_range_mask, pass);
+						}
+						const int valid_bits = _mm_movemask_ps(valid_range_mask);
+						for (int q=0;q<4;q++)
+						{
+							const uint8_t v = (valid_bits>>q) & 1;
+							valid[c+q] = v;
+							nValid += v;
+						}
+					}
+				}
+#else
+				MRPT_UNUSED_PARAM(use_SSE2);
+#endif
+				for (;c<W;c+=decimation)
+				{
+					const uint8_t v = rif.do_range_filter(r,c,rangeImage.coeff(r,c)) ? 1:0;
+					valid[c] = v;
+					nValid += v;
+				}
+				row_counts[k] = nValid;
+			}
+		}
+	};
+
+	/** For a range of columns, finds the closest valid depth within a vertical FOV. Used in convertTo2DScan() */
+	struct TRangeImageColumnsMinDepth
+	{
+		const mrpt::math::CMatrix &rangeImage;
+		const std::vector<uint8_t> &valid_mask;
+		const std::vector<float> &vert_ang_tan;
+		const float tan_min, tan_max;
+		std::vector<float> &col_closest_range;
+		std::vector<uint8_t> &col_any_valid;
+
+		TRangeImageColumnsMinDepth(const mrpt::math::CMatrix &rangeImage_, const std::vector<uint8_t> &valid_mask_, const std::vector<float> &vert_ang_tan_, const float tan_min_, const float tan_max_, std::vector<float> &col_closest_range_, std::vector<uint8_t> &col_any_valid_) :
+			rangeImage(rangeImage_), valid_mask(valid_mask_), vert_ang_tan(vert_ang_tan_), tan_min(tan_min_), tan_max(tan_max_), col_closest_range(col_closest_range_), col_any_valid(col_any_valid_)
+		{ }
+
+		void operator()(const mrpt::system::BlockedRange &range) const
+		{
+			const int W = rangeImage.cols(), H = rangeImage.rows();
+			for (int r=0;r<H;r++)
+			{
+				const uint8_t *valid = &valid_mask[r*W];
+				for (int c=range.begin();c<range.end();c++)
+				{
+					if (!valid[c]) continue;
+					// All filters passed:
+					const float D = rangeImage.coeff(r,c);
+					const float this_point_tan = vert_ang_tan[r] * D;
+					if (this_point_tan>tan_min && this_point_tan<tan_max)
+					{
+						col_any_valid[c] = 1;
+						mrpt::utils::keep_min(col_closest_range[c], D);
+					}
+				}
+			}
+		}
+	};
+
+	void evaluateRangeImageFilter(
+		const mrpt::math::CMatrix &rangeImage,
+		const TRangeImageFilterParams &filterParams,
+		const int decimation,
+		const bool use_SSE2,
+		std::vector<uint8_t> &valid_mask,
+		std::vector<size_t> &row_offsets)
+	{
+		const int W = rangeImage.cols(), H = rangeImage.rows();
+		ASSERT_(W!=0 && H!=0 && decimation>0);
+		const int nRows = (H+decimation-1)/decimation;
+
+		valid_mask.resize(nRows*W);
+		row_offsets.resize(nRows+1);
+		row_offsets[0] = 0;
+
+		mrpt::system::parallel_for(
+			mrpt::system::BlockedRange(0,nRows),
+			TRangeImageFilterRows(rangeImage, filterParams, decimation, use_SSE2, &valid_mask[0], &row_offsets[1]) );
+
+		// Row counts -> offsets:
+		for (int k=0;k<nRows;k++)
+			row_offsets[k+1]+=row_offsets[k];
+	}
+}
+}
+}
+
 void CObservation3DRangeScan::convertTo2DScan(mrpt::obs::CObservation2DRangeScan & out_scan2d, const T3DPointsTo2DScanParams &sp, const TRangeImageFilterParams &fp )
 {
 	out_scan2d.sensorLabel = sensorLabel;
@@ -968,11 +1122,19 @@ void CObservation3DRangeScan::convertTo2DScan(mrpt::obs::CObservation2DRangeScan
 		double ang  = -FOV_equiv*0.5;
 		const double A_ang = FOV_equiv/(nLaserRays-1);
 
-		TRangeImageFilter rif(fp);
+		// Go thru the range image in one single pass, keeping the minimum distance (along the +X axis, not 3D distance!)
+		// for each column which also lies within the vertical FOV passed by the user.
+		std::vector<uint8_t> valid_mask;
+		std::vector<size_t>  row_offsets;
+		detail::evaluateRangeImageFilter(rangeImage, fp, 1 /*decimation*/, true /*SSE2*/, valid_mask, row_offsets);
+
+		std::vector<float>   col_closest_range(nCols, out_scan2d.maxRange);
+		std::vector<uint8_t> col_any_valid(nCols, 0);
+
+		mrpt::system::parallel_for(
+			mrpt::system::BlockedRange(0,static_cast<int>(nCols), 64),
+			detail::TRangeImageColumnsMinDepth(rangeImage, valid_mask, vert_ang_tan, tan_min, tan_max, col_closest_range, col_any_valid) );
 
-		// Go thru columns, and keep the minimum distance (along the +X axis, not 3D distance!)
-		// for each direction (i.e. for each column) which also lies within the vertical FOV passed
-		// by the user.
 		for (size_t i=0;i<nLaserRays;i++, ang+=A_ang )
 		{
 			// Equivalent column in the range image for the "i'th" ray:
@@ -980,29 +1142,11 @@ void CObservation3DRangeScan::convertTo2DScan(mrpt::obs::CObservation2DRangeScan
 			// make sure we don't go out of range (just in case):
 			const size_t c = std::min(static_cast<size_t>(std::max(0.0,cx + fx*tan_ang)),nCols-1);
 
-			bool any_valid = false;
-			float closest_range = out_scan2d.maxRange;
-
-			for (size_t r=0;r<nRows;r++)
-			{
-				const float D = this->rangeImage.coeff(r,c);
-				if (!rif.do_range_filter(r,c,D))
-					continue;
-
-				// All filters passed:
-				const float this_point_tan = vert_ang_tan[r] * D;
-				if (this_point_tan>tan_min && this_point_tan<tan_max)
-				{
-					any_valid = true;
-					mrpt::utils::keep_min(closest_range, D);
-				}
-			}
-
-			if (any_valid)
+			if (col_any_valid[c])
 			{
 				out_scan2d.validRange[i] = true;
 				// Compute the distance in 2D from the "depth" in closest_range:
-				out_scan2d.scan[i] = closest_range*std::sqrt(1.0+tan_ang*tan_ang);
+				out_scan2d.scan[i] = col_closest_range[c]*std::sqrt(1.0+tan_ang*tan_ang);
 			}
 		} // end for columns
 	}
@@ -1032,7 +1176,7 @@ void CObservation3DRangeScan::convertTo2DScan(mrpt::obs::CObservation2DRangeScan
 			const double phi_wrt_origin = atan2(ys[i], xs[i]);
 
 			int i_range = (phi_wrt_origin-ang0)/A_ang;
-			if (i_range<0 || i_range>=int(N))
+			if (i_range<0 || i_range>=int(nLaserRays))
 				continue;
 
 			const float  r_wrt_origin = ::hypotf(xs[i],ys[i]);
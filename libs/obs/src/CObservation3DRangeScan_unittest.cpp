@@ -177,3 +177,67 @@ TEST(CObservation3DRangeScan, Project3D_filterMax)
 		EXPECT_EQ(o.points3D_x.size(), 3U ) << " testcase flags: i=" << i << std::endl;
 	}
 }
+
+TEST(CObservation3DRangeScan, Project3D_decimation)
+{
+	mrpt::obs::T3DPointsProjectionParams pp;
+	mrpt::obs::TRangeImageFilterParams fp;
+
+	for (int i=0;i<8;i++) // test all combinations of flags
+	{
+		mrpt::obs::CObservation3DRangeScan  o;
+		fillSampleObs(o,pp,i);
+		pp.decimation = 2;
+
+		o.project3DPointsFromDepthImageInto(o,pp,fp);
+		// Points in rows {10,12,14}, columns 10<=c<=r, c even: 1+2+3
+		EXPECT_EQ(o.points3D_x.size(),6U) << " testcase flags: i=" << i << std::endl;
+		for (size_t k=0;k<o.points3D_x.size();k++) {
+			EXPECT_EQ(o.points3D_idxs_x[k] % 2, 0);
+			EXPECT_EQ(o.points3D_idxs_y[k] % 2, 0);
+		}
+	}
+}
+
+TEST(CObservation3DRangeScan, Project3D_sameResultsAllPaths)
+{
+	// Range filters with all possible combinations of pass/fail/undefined:
+	mrpt::math::CMatrix fMax(TEST_RANGEIMG_HEIGHT,TEST_RANGEIMG_WIDTH),fMin(TEST_RANGEIMG_HEIGHT,TEST_RANGEIMG_WIDTH);
+	for (int r=0;r<TEST_RANGEIMG_HEIGHT;r++)
+		for (int c=0;c<TEST_RANGEIMG_WIDTH;c++)
+		{
+			fMin(r,c) = (c%3==0) ? 0.0f : r-0.5f*(c%2);
+			fMax(r,c) = (c%5==0) ? 0.0f : r+0.5f*(c%3);
+		}
+
+	mrpt::obs::TRangeImageFilterParams fp;
+	fp.rangeMask_min = &fMin;
+	fp.rangeMask_max = &fMax;
+
+	for (int between=0;between<2;between++)
+	{
+		fp.rangeCheckBetween = between!=0;
+
+		mrpt::obs::T3DPointsProjectionParams pp;
+		mrpt::obs::CObservation3DRangeScan o_ref;
+		fillSampleObs(o_ref,pp,0 /* no LUT, no SSE2 */);
+		o_ref.project3DPointsFromDepthImageInto(o_ref,pp,fp);
+
+		for (int i=1;i<4;i++)
+		{
+			mrpt::obs::CObservation3DRangeScan  o;
+			fillSampleObs(o,pp,i);
+			o.project3DPointsFromDepthImageInto(o,pp,fp);
+
+			ASSERT_EQ(o.points3D_x.size(),o_ref.points3D_x.size()) << " testcase flags: i=" << i << std::endl;
+			for (size_t k=0;k<o.points3D_x.size();k++)
+			{
+				EXPECT_EQ(o.points3D_idxs_x[k],o_ref.points3D_idxs_x[k]);
+				EXPECT_EQ(o.points3D_idxs_y[k],o_ref.points3D_idxs_y[k]);
+				EXPECT_NEAR(o.points3D_x[k],o_ref.points3D_x[k],1e-4);
+				EXPECT_NEAR(o.points3D_y[k],o_ref.points3D_y[k],1e-4);
+				EXPECT_NEAR(o.points3D_z[k],o_ref.points3D_z[k],1e-4);
+			}
+		}
+	}
+}
@@ -251,6 +251,14 @@ void CObservationStereoImages::swap( CObservationStereoImages &o)
 	std::swap(rightCameraPose, o.rightCameraPose);
 }
 
+// Left and right images are decoded in parallel:
+void CObservationStereoImages::prefetch() const
+{
+	imageLeft.prefetch();
+	if (hasImageRight) imageRight.prefetch();
+	if (hasImageDisparity) imageDisparity.prefetch();
+}
+
 void CObservationStereoImages::getDescriptionAsText(std::ostream &o) const
 {
 	using namespace std;
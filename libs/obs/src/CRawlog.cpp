@@ -13,8 +13,11 @@
 #include <mrpt/obs/CRawlog.h>
 #include <mrpt/utils/CFileInputStream.h>
 #include <mrpt/utils/CFileGZInputStream.h>
+#include <mrpt/utils/CFileMMapInputStream.h>
+#include <mrpt/compress/zip.h>
 #include <mrpt/utils/CFileGZOutputStream.h>
 #include <mrpt/utils/CStream.h>
+#include <mrpt/synch/atomic_incr.h>
 
 using namespace mrpt;
 using namespace mrpt::obs;
@@ -26,10 +29,42 @@ using namespace mrpt::system;
 IMPLEMENTS_SERIALIZABLE(CRawlog, CSerializable,mrpt::obs)
 
 // ctor
-CRawlog::CRawlog() : m_seqOfActObs(), m_commentTexts()
+CRawlog::CRawlog() : m_seqOfActObs(), m_commentTexts(), m_last_accessed(static_cast<size_t>(-1))
 {
 }
 
+namespace
+{
+	// Starts the decoding in a worker thread of the delayed-load images of an entry:
+	void prefetch_entry(const CSerializablePtr &obj)
+	{
+		if (!obj) return;
+		if (IS_CLASS(obj,CSensoryFrame))
+		{
+			const CSensoryFramePtr sf = CSensoryFramePtr(obj);
+			for (CSensoryFrame::const_iterator it=sf->begin();it!=sf->end();++it)
+				if (*it) (*it)->prefetch();
+		}
+		else if (IS_DERIVED(obj,CObservation))
+			CObservationPtr(obj)->prefetch();
+	}
+}
+
+void CRawlog::prefetchAfter(size_t index) const
+{
+	const size_t NUM_ENTRIES_AHEAD = 2;
+	// Atomically exchange the last accessed index, since several threads may be reading this same (const) rawlog:
+	size_t prev_index;
+	do {
+		prev_index = mrpt::synch::atomic_load_acquire(&m_last_accessed);
+	} while (!mrpt::synch::atomic_compare_exchange(&m_last_accessed,prev_index,index));
+
+	// Only for sequential reads:
+	if (index==prev_index+1)
+		for (size_t i=index+1;i<=index+NUM_ENTRIES_AHEAD && i<m_seqOfActObs.size();i++)
+			prefetch_entry(m_seqOfActObs[i]);
+}
+
 // dtor
 CRawlog::~CRawlog()
 {
@@ -40,6 +75,7 @@ void  CRawlog::clear()
 {
 	m_seqOfActObs.clear();
 	m_commentTexts.text.clear();
+	m_last_accessed = static_cast<size_t>(-1);
 }
 
 void  CRawlog::addObservations(CSensoryFrame		&observations )
@@ -110,7 +146,10 @@ CObservationPtr  CRawlog::getAsObservation( size_t index ) const
 	CSerializablePtr obj = m_seqOfActObs[index];
 
 	if ( obj->GetRuntimeClass()->derivedFrom( CLASS_ID(CObservation) ) )
-			return CObservationPtr( obj );
+	{
+		prefetchAfter(index);
+		return CObservationPtr( obj );
+	}
 	else	THROW_EXCEPTION_CUSTOM_MSG1("Element at index %i is not a CObservation",(int)index);
 	MRPT_END
 }
@@ -153,7 +192,10 @@ CSensoryFramePtr  CRawlog::getAsObservations( size_t index ) const
 	CSerializablePtr obj = m_seqOfActObs[index];
 
 	if ( obj->GetRuntimeClass()->derivedFrom( CLASS_ID(CSensoryFrame) ))
-			return CSensoryFramePtr( obj );
+	{
+		prefetchAfter(index);
+		return CSensoryFramePtr( obj );
+	}
 	else	THROW_EXCEPTION_CUSTOM_MSG1("Element at index %i is not a CSensoryFrame",(int)index);
 	MRPT_END
 }
@@ -203,9 +245,17 @@ void  CRawlog::readFromStream(mrpt::utils::CStream &in,int version)
 
 bool  CRawlog::loadFromRawLogFile( const std::string &fileName, bool non_obs_objects_are_legal )
 {
-	// Open for read.
-	CFileGZInputStream fs(fileName);
-	if (!fs.fileOpenCorrectly()) return false;
+	// Open for read. Uncompressed files are mapped in memory, which is faster:
+	CFileMMapInputStream fs_mmap;
+	CFileGZInputStream   fs_gz;
+	CStream *fs = NULL;
+	if (!mrpt::compress::zip::is_gz_file(fileName) && fs_mmap.open(fileName))
+		fs = &fs_mmap;
+	else
+	{
+		if (!fs_gz.open(fileName)) return false;
+		fs = &fs_gz;
+	}
 
 	clear();  // Clear first
 
@@ -216,7 +266,7 @@ bool  CRawlog::loadFromRawLogFile( const std::string &fileName, bool non_obs_obj
 		CSerializablePtr newObj;
 		try
 		{
-			fs >> newObj;
+			(*fs) >> newObj;
 			bool add_obj = false;
 			// Check type:
 			if ( newObj->GetRuntimeClass() == CLASS_ID(CRawlog))
@@ -294,6 +344,7 @@ bool CRawlog::saveToRawLogFile( const std::string &fileName ) const
 	try
 	{
 		CFileGZOutputStream	f(fileName);
+		f.enableClassIDDictionary(); // Each class name is only written once
 		if (!m_commentTexts.text.empty())
 			f << m_commentTexts;
 		for (size_t i=0;i<m_seqOfActObs.size();i++)
@@ -366,6 +417,8 @@ bool CRawlog::readActionObservationPair(
 			}
 			rawlogEntry++;
 		}
+		// Start decoding in parallel all the delayed-load images of the SF (e.g. both stereo images):
+		prefetch_entry(observations);
 		return true;
 	}
 	catch ( CExceptionEOF &)
@@ -411,6 +464,7 @@ bool CRawlog::getActionObservationPairOrObservation(
 			else if (IS_DERIVED(obj,CObservation ) )
 			{
 				observation = CObservationPtr(obj);
+				observation->prefetch();
 				rawlogEntry++;
 				return true;
 			}
@@ -431,6 +485,7 @@ bool CRawlog::getActionObservationPairOrObservation(
 			}
 			rawlogEntry++;
 		}
+		prefetch_entry(observations);
 		return true;
 	}
 	catch ( CExceptionEOF &)
@@ -0,0 +1,91 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/obs/CRawlog.h>
+#include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CObservationOdometry.h>
+#include <mrpt/obs/CActionRobotMovement2D.h>
+#include <mrpt/obs/CActionCollection.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/compress/zip.h>
+#include <mrpt/utils/CMemoryStream.h>
+#include <mrpt/system/filesystem.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::obs;
+using namespace mrpt::utils;
+using namespace mrpt::poses;
+using namespace std;
+
+// A rawlog saved with the class ID dictionary (the default of saveToRawLogFile()) must be read back entirely,
+// with several objects of each class, nested objects (poses, PDFs) and both formats of rawlogs mixed:
+TEST(CRawlog, SaveLoadWithClassIDDictionary)
+{
+	const size_t N = 20;
+	CRawlog rawlog;
+	for (size_t i=0;i<N;i++)
+	{
+		CActionCollection acts;
+		CActionRobotMovement2D act;
+		CActionRobotMovement2D::TMotionModelOptions opts;
+		act.computeFromOdometry(CPose2D(0.1*i,0,0.01*i),opts);
+		acts.insert(act);
+		rawlog.addActions(acts);
+
+		CSensoryFrame sf;
+		CObservation2DRangeScanPtr scan = CObservation2DRangeScan::Create();
+		scan->sensorLabel = format("SCAN%u",static_cast<unsigned>(i));
+		for (size_t k=0;k<10;k++)
+		{
+			scan->scan.push_back(1.0f+i+0.1f*k);
+			scan->validRange.push_back(1);
+		}
+		sf.insert(scan);
+		rawlog.addObservations(sf);
+
+		CObservationOdometryPtr odo = CObservationOdometry::Create();
+		odo->odometry = CPose2D(i,2*i,0);
+		rawlog.addObservationMemoryReference(odo);
+	}
+
+	const string fil = mrpt::system::getTempFileName();
+	ASSERT_TRUE(rawlog.saveToRawLogFile(fil));
+
+	// The class names were not written in every object:
+	{
+		mrpt::vector_byte file_contents;
+		ASSERT_TRUE(mrpt::compress::zip::decompress_gz_file(fil,file_contents));
+		CMemoryStream buf;
+		for (size_t i=0;i<rawlog.size();i++)
+			buf << *rawlog.getAsGeneric(i);
+		EXPECT_LT(file_contents.size(), buf.getTotalBytesCount());
+	}
+
+	CRawlog rawlog2;
+	ASSERT_TRUE(rawlog2.loadFromRawLogFile(fil));
+	mrpt::system::deleteFile(fil);
+
+	ASSERT_EQ(rawlog2.size(), rawlog.size());
+	for (size_t i=0;i<N;i++)
+	{
+		CActionRobotMovement2DPtr act = rawlog2.getAsAction(3*i)->getBestMovementEstimation();
+		ASSERT_TRUE(act.present());
+		EXPECT_NEAR(act->rawOdometryIncrementReading.x(), 0.1*i, 1e-9);
+
+		CObservation2DRangeScanPtr scan = rawlog2.getAsObservations(3*i+1)->getObservationByClass<CObservation2DRangeScan>();
+		ASSERT_TRUE(scan.present());
+		EXPECT_EQ(scan->sensorLabel, format("SCAN%u",static_cast<unsigned>(i)));
+		ASSERT_EQ(scan->scan.size(), 10u);
+		EXPECT_FLOAT_EQ(scan->scan[9], 1.0f+i+0.9f);
+
+		CObservationOdometryPtr odo = CObservationOdometryPtr(rawlog2.getAsObservation(3*i+2));
+		EXPECT_EQ(odo->odometry, CPose2D(i,2*i,0));
+	}
+}
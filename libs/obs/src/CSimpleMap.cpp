@@ -11,6 +11,8 @@
 
 #include <mrpt/maps/CSimpleMap.h>
 #include <mrpt/utils/CFileGZInputStream.h>
+#include <mrpt/utils/CFileMMapInputStream.h>
+#include <mrpt/compress/zip.h>
 #include <mrpt/utils/CFileGZOutputStream.h>
 #include <mrpt/utils/CStream.h>
 
@@ -347,6 +349,16 @@ bool CSimpleMap::loadFromFile(const std::string &filName)
 {
 	try
 	{
+		// Uncompressed files are mapped in memory instead, which is much faster for big maps:
+		if (!mrpt::compress::zip::is_gz_file(filName))
+		{
+			mrpt::utils::CFileMMapInputStream  f;
+			if (f.open(filName))
+			{
+				f >> *this;
+				return true;
+			}
+		}
 		mrpt::utils::CFileGZInputStream  f(filName);
 		f >> *this;
 		return true;
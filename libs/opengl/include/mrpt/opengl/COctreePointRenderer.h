@@ -14,6 +14,7 @@
 #include <mrpt/opengl/CBox.h>
 #include <mrpt/opengl/gl_utils.h>
 #include <mrpt/utils/aligned_containers.h>
+#include <mrpt/utils/round.h>
 
 namespace mrpt
 {
@@ -78,17 +79,8 @@ namespace mrpt
 			  */
 			void octree_render(const mrpt::opengl::gl_utils::TRenderInfo &ri ) const
 			{
-				m_visible_octree_nodes_ongoing = 0;
-
 				// Stage 1: Build list of visible octrees
-				m_render_queue.clear();
-				m_render_queue.reserve(m_octree_nodes.size());
-
-				mrpt::utils::TPixelCoordf cr_px[8];
-				float        cr_z[8];
-				octree_recursive_render(OCTREE_ROOT_NODE,ri, cr_px, cr_z, false /* corners are not computed for this first iteration */ );
-
-				m_visible_octree_nodes = m_visible_octree_nodes_ongoing;
+				octree_build_render_queue(ri);
 
 				// Stage 2: Render them all
 				for (size_t i=0;i<m_render_queue.size();i++)
@@ -98,6 +90,68 @@ namespace mrpt
 				}
 			}
 
+			/** Like octree_render(), for derived classes which render from an array of point indices sorted by octree
+			  * nodes, as built by octree_build_node_ordered_indices() (e.g. uploaded to a CVertexBufferObject).
+			  * For each visible node, calls `Derived::render_index_range(first,count)` to render elements [first,first+count-1]
+			  * of that array. The number of points of large nodes on the screen is reduced by rendering only
+			  * the first elements of each node, which are a uniform subsample of the node (see octree_build_node_ordered_indices()).
+			  */
+			void octree_render_index_ranges(const mrpt::opengl::gl_utils::TRenderInfo &ri ) const
+			{
+				octree_build_render_queue(ri);
+
+				for (size_t i=0;i<m_render_queue.size();i++)
+				{
+					const TNode & node = m_octree_nodes[ m_render_queue[i].node_id ];
+					if (node.all)
+					{
+						octree_derived().render_index_range(node.idx_first, octree_derived().size() );
+					}
+					else
+					{
+						const size_t N = node.pts.size();
+						const size_t decimation = mrpt::utils::round( std::max(1.0f, static_cast<float>(N / (mrpt::global_settings::OCTREE_RENDER_MAX_DENSITY_POINTS_PER_SQPIXEL * m_render_queue[i].render_area_sqpixels)) ) );
+						octree_derived().render_index_range(node.idx_first, (N+decimation-1)/decimation );
+					}
+				}
+			}
+
+			/** Builds the list of indices of all points, sorted by octree (leaf) node, for use with octree_render_index_ranges().
+			  * Within each node, points are stored in "bit-reversed" order, so any prefix of the list of a node
+			  * is a subsample evenly spread over all its points.
+			  */
+			void octree_build_node_ordered_indices(std::vector<uint32_t> &idxs) const
+			{
+				octree_assure_uptodate();
+				idxs.clear();
+				idxs.reserve(octree_derived().size());
+				for (size_t i=0;i<m_octree_nodes.size();i++)
+				{
+					const TNode & node = m_octree_nodes[i];
+					if (!node.is_leaf) continue;
+					node.idx_first = idxs.size();
+					if (node.all)
+					{
+						const size_t N = octree_derived().size();
+						for (size_t k=0;k<N;k++)
+							idxs.push_back(static_cast<uint32_t>(k));
+					}
+					else
+					{
+						const size_t N = node.pts.size();
+						unsigned int nbits = 0;
+						while ((size_t(1)<<nbits)<N) nbits++;
+						for (size_t k=0;k<(size_t(1)<<nbits);k++)
+						{
+							size_t j = 0; // j = bit-reverse(k)
+							for (unsigned int b=0;b<nbits;b++)
+								if (k & (size_t(1)<<b)) j |= size_t(1)<<(nbits-1-b);
+							if (j<N)
+								idxs.push_back(static_cast<uint32_t>(node.pts[j]));
+						}
+					}
+				}
+			}
 
 			void octree_getBoundingBox(mrpt::math::TPoint3D &bb_min, mrpt::math::TPoint3D &bb_max) const
 			{
@@ -118,7 +172,8 @@ namespace mrpt
 			{
 				TNode() :
 					bb_min( std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() ),
-					bb_max(-std::numeric_limits<float>::max(),-std::numeric_limits<float>::max(),-std::numeric_limits<float>::max() )
+					bb_max(-std::numeric_limits<float>::max(),-std::numeric_limits<float>::max(),-std::numeric_limits<float>::max() ),
+					idx_first(0)
 				{ }
 
 				bool                  is_leaf;     //!< true: it's a leaf and \a pts has valid indices; false: \a children is valid.
@@ -129,6 +184,7 @@ namespace mrpt
 				// Fields used if is_leaf=true
 				std::vector<size_t>   pts;         //!< Point indices in the derived class that fall into this node.
 				bool                  all;         //!< true: All elements in the reference object; false: only those in \a pts
+				mutable size_t        idx_first;   //!< Index of the first point of this node in the list built by octree_build_node_ordered_indices()
 
 				// Fields used if is_leaf=false
 				mrpt::math::TPoint3Df center;      //!< [is_leaf=false] The center of the node, whose coordinates are used to decide between the 8 children nodes.
@@ -212,6 +268,20 @@ namespace mrpt
 			// Counters of visible octrees for each render:
 			volatile mutable size_t m_visible_octree_nodes, m_visible_octree_nodes_ongoing;
 
+			/** Build the list \a m_render_queue of visible nodes */
+			void octree_build_render_queue(const mrpt::opengl::gl_utils::TRenderInfo &ri) const
+			{
+				m_visible_octree_nodes_ongoing = 0;
+				m_render_queue.clear();
+				m_render_queue.reserve(m_octree_nodes.size());
+
+				mrpt::utils::TPixelCoordf cr_px[8];
+				float        cr_z[8];
+				octree_recursive_render(OCTREE_ROOT_NODE,ri, cr_px, cr_z, false /* corners are not computed for this first iteration */ );
+
+				m_visible_octree_nodes = m_visible_octree_nodes_ongoing;
+			}
+
 			/** Render a given node. */
 			void octree_recursive_render(
 				size_t node_idx,
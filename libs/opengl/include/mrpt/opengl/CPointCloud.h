@@ -12,6 +12,7 @@
 
 #include <mrpt/opengl/CRenderizable.h>
 #include <mrpt/opengl/COctreePointRenderer.h>
+#include <mrpt/opengl/CVertexBufferObject.h>
 #include <mrpt/utils/PLY_import_export.h>
 #include <mrpt/utils/adapters.h>
 
@@ -206,9 +207,9 @@ namespace mrpt
 
 			/** @name Modify the appearance of the rendered points
 			    @{ */
-			inline void enableColorFromX(bool v=true) { m_colorFromDepth = v ? CPointCloud::colX : CPointCloud::colNone;  }
-			inline void enableColorFromY(bool v=true) { m_colorFromDepth = v ? CPointCloud::colY : CPointCloud::colNone; }
-			inline void enableColorFromZ(bool v=true) { m_colorFromDepth = v ? CPointCloud::colZ : CPointCloud::colNone; }
+			inline void enableColorFromX(bool v=true) { m_colorFromDepth = v ? CPointCloud::colX : CPointCloud::colNone; m_vbo_colors.invalidate(); }
+			inline void enableColorFromY(bool v=true) { m_colorFromDepth = v ? CPointCloud::colY : CPointCloud::colNone; m_vbo_colors.invalidate(); }
+			inline void enableColorFromZ(bool v=true) { m_colorFromDepth = v ? CPointCloud::colZ : CPointCloud::colNone; m_vbo_colors.invalidate(); }
 
 			inline void setPointSize(float p) { m_pointSize=p; }  //!< By default is 1.0
 			inline float getPointSize() const { return m_pointSize; }
@@ -228,6 +229,9 @@ namespace mrpt
 			/** Render a subset of points (required by octree renderer) */
 			void  render_subset(const bool all, const std::vector<size_t>& idxs, const float render_area_sqpixels ) const;
 
+			/** Render a range of the points stored in graphics memory (required by octree renderer, see COctreePointRenderer::octree_render_index_ranges()) */
+			void  render_index_range(const size_t first, const size_t count) const;
+
 		private:
 			/** Constructor */
 			CPointCloud();
@@ -241,7 +245,14 @@ namespace mrpt
 
 			mrpt::utils::TColorf	m_colorFromDepth_min, m_colorFromDepth_max;	//!< The colors used to interpolate when m_colorFromDepth is true.
 
+			mutable CVertexBufferObject  m_vbo_xyz;    //!< Cached (X,Y,Z) coordinates in graphics memory
+			mutable CVertexBufferObject  m_vbo_colors; //!< Cached RGBA colors in graphics memory, if m_colorFromDepth is enabled
+			mutable CVertexBufferObject  m_vbo_idxs;   //!< Point indices sorted by octree node
+			mutable uint8_t              m_vbo_colors_alpha; //!< The alpha value used to build \a m_vbo_colors
+
 			inline void internal_render_one_point(size_t i) const;
+			/** Uploads the points (and colors) to graphics memory if needed. \return false if rendering from buffer objects is not possible. */
+			bool internal_update_vbos() const;
 		};
 		DEFINE_SERIALIZABLE_POST_CUSTOM_BASE_LINKAGE( CPointCloud, CRenderizable, OPENGL_IMPEXP )
 
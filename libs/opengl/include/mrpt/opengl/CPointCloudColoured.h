@@ -12,6 +12,7 @@
 
 #include <mrpt/opengl/CRenderizable.h>
 #include <mrpt/opengl/COctreePointRenderer.h>
+#include <mrpt/opengl/CVertexBufferObject.h>
 #include <mrpt/utils/PLY_import_export.h>
 #include <mrpt/utils/adapters.h>
 #include <mrpt/utils/color_maps.h>
@@ -71,6 +72,9 @@ namespace mrpt
 			bool				m_pointSmooth; //!< Default: false
 			mutable volatile size_t	m_last_rendered_count, m_last_rendered_count_ongoing;
 
+			mutable CVertexBufferObject  m_vbo_points; //!< Cached copy of \a m_points in graphics memory
+			mutable CVertexBufferObject  m_vbo_idxs;   //!< Point indices sorted by octree node
+
 			/** Constructor
 			  */
 			CPointCloudColoured( ) :
@@ -78,7 +82,9 @@ namespace mrpt
 				m_pointSize(1),
 				m_pointSmooth(false),
 				m_last_rendered_count(0),
-				m_last_rendered_count_ongoing(0)
+				m_last_rendered_count_ongoing(0),
+				m_vbo_points(CVertexBufferObject::vboVertexData),
+				m_vbo_idxs(CVertexBufferObject::vboIndexData)
 			{
 			}
 			/** Private, virtual destructor: only can be deleted from smart pointers */
@@ -152,6 +158,7 @@ namespace mrpt
 				m_points[index].R=R;
 				m_points[index].G=G;
 				m_points[index].B=B;
+				m_vbo_points.invalidate();
 			}
 			/** Like \c getPointColor but without checking for out-of-index erors */
 			inline void getPointColor_fast( size_t index, float &R, float &G, float &B ) const
@@ -196,6 +203,9 @@ namespace mrpt
 			/** Render a subset of points (required by octree renderer) */
 			void  render_subset(const bool all, const std::vector<size_t>& idxs, const float render_area_sqpixels ) const;
 
+			/** Render a range of the points stored in graphics memory (required by octree renderer, see COctreePointRenderer::octree_render_index_ranges()) */
+			void  render_index_range(const size_t first, const size_t count) const;
+
 		protected:
 			/** @name PLY Import virtual methods to implement in base classes
 			    @{ */
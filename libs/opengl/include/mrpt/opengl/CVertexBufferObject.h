@@ -0,0 +1,89 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+#ifndef opengl_CVertexBufferObject_H
+#define opengl_CVertexBufferObject_H
+
+#include <mrpt/opengl/link_pragmas.h>
+#include <cstddef>
+
+namespace mrpt
+{
+	namespace global_settings
+	{
+		/** Default value = true. Set to false to disable the use of OpenGL buffer objects (see mrpt::opengl::CVertexBufferObject)
+		  * and render with the legacy immediate mode (glBegin()/glEnd()). Affects to these classes:
+		  *		- mrpt::opengl::CPointCloud
+		  *		- mrpt::opengl::CPointCloudColoured
+		  * \ingroup mrpt_opengl_grp
+		  */
+		extern OPENGL_IMPEXP bool OPENGL_USE_VERTEX_BUFFER_OBJECTS;
+	}
+
+	namespace opengl
+	{
+		/** A buffer of vertex data (coordinates, colors,...) or vertex indices held in graphics memory as an OpenGL
+		  *  "vertex buffer object" (VBO), to be used by CRenderizable-derived classes for retained-mode rendering:
+		  *  the data is uploaded once with upload() and, until the owner object changes and calls invalidate(),
+		  *  each render only needs to bind() the buffer and issue glDrawArrays() / glDrawElements().
+		  *
+		  *  Buffers are created on first upload and freed on destruction. As with display lists (see CRenderizableDisplayList),
+		  *  the actual deletion of the OpenGL buffer is deferred until the next upload() of any buffer, so it's safe
+		  *  to destroy objects from threads without an OpenGL context. Copies of an object never share the OpenGL buffer.
+		  *
+		  *  All methods except invalidate() and isUpToDate() must be called with a valid OpenGL context (i.e. from a render() method).
+		  *
+		  * \sa mrpt::global_settings::OPENGL_USE_VERTEX_BUFFER_OBJECTS
+		  * \ingroup mrpt_opengl_grp
+		  */
+		class OPENGL_IMPEXP CVertexBufferObject
+		{
+		public:
+			enum TBufferType
+			{
+				vboVertexData = 0, //!< Vertex attributes, used with glVertexPointer(), glColorPointer(),... (GL_ARRAY_BUFFER)
+				vboIndexData       //!< Vertex indices, used with glDrawElements() (GL_ELEMENT_ARRAY_BUFFER)
+			};
+
+			CVertexBufferObject(TBufferType type = vboVertexData);
+			CVertexBufferObject(const CVertexBufferObject &o); //!< Copy ctor: the new object has no data (it's not up to date)
+			CVertexBufferObject & operator =(const CVertexBufferObject &o); //!< Marks this buffer as outdated, its contents are not copied
+			~CVertexBufferObject();
+
+			/** Returns true if buffer objects can be used in the current OpenGL context (OpenGL>=1.5) and they are not
+			  *  disabled via mrpt::global_settings::OPENGL_USE_VERTEX_BUFFER_OBJECTS */
+			static bool isSupported();
+
+			/** false if the buffer has never been uploaded or the owner called invalidate() since then */
+			inline bool isUpToDate() const { return m_uptodate; }
+			/** Must be called by the owner object whenever the data to render changes */
+			inline void invalidate() { m_uptodate = false; }
+
+			/** Creates the buffer if needed and uploads \a num_bytes bytes from \a data to graphics memory.
+			  *  The buffer is left bound. \return false on any OpenGL error (e.g. out of graphics memory), in which case
+			  *  the caller should fall back to immediate-mode rendering. */
+			bool upload(const void *data, const size_t num_bytes);
+
+			void bind() const;   //!< Bind this buffer to its target, so next gl*Pointer() or glDrawElements() calls use it.
+			void unbind() const; //!< Restores the default (no buffer) for this buffer's target
+
+			inline size_t getSizeInBytes() const { return m_size; } //!< Size of the last uploaded data
+
+		private:
+			TBufferType   m_type;
+			unsigned int  m_id;  //!< The OpenGL buffer name (0=none)
+			bool          m_uptodate;
+			size_t        m_size;
+
+			void releaseBuffer(); //!< Enqueues the buffer for deletion
+		};
+
+	} // end namespace
+} // End of namespace
+
+#endif
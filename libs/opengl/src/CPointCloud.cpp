@@ -45,7 +45,11 @@ CPointCloud::CPointCloud( ) :
 	m_max_m_min_inv(0),
 	m_minmax_valid(false),
 	m_colorFromDepth_min(0,0,0),
-	m_colorFromDepth_max(0,0,1)
+	m_colorFromDepth_max(0,0,1),
+	m_vbo_xyz(CVertexBufferObject::vboVertexData),
+	m_vbo_colors(CVertexBufferObject::vboVertexData),
+	m_vbo_idxs(CVertexBufferObject::vboIndexData),
+	m_vbo_colors_alpha(0)
 {
 	markAllPointsAsNew();
 }
@@ -116,10 +120,35 @@ void   CPointCloud::render() const
 	// Disable lighting for point clouds:
 	glDisable(GL_LIGHTING);
 
-    glBegin( GL_POINTS );
-    glColor4ub(m_color.R,m_color.G,m_color.B,m_color.A); // The default if m_colorFromDepth=false
-	octree_render(ri); // Render all points recursively:
-    glEnd();
+	glColor4ub(m_color.R,m_color.G,m_color.B,m_color.A); // The default if m_colorFromDepth=false
+	if (internal_update_vbos())
+	{
+		const bool with_colors = m_colorFromDepth!=colNone;
+		m_vbo_xyz.bind();
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glVertexPointer(3, GL_FLOAT, 0, reinterpret_cast<const GLvoid*>(0) );
+		if (with_colors)
+		{
+			m_vbo_colors.bind();
+			glEnableClientState(GL_COLOR_ARRAY);
+			glColorPointer(4, GL_FLOAT, 0, reinterpret_cast<const GLvoid*>(0) );
+		}
+		m_vbo_idxs.bind();
+
+		octree_render_index_ranges(ri); // Render visible nodes
+
+		m_vbo_idxs.unbind();
+		if (with_colors)
+			glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		m_vbo_xyz.unbind();
+	}
+	else
+	{
+		glBegin( GL_POINTS );
+		octree_render(ri); // Render all points recursively:
+		glEnd();
+	}
 
 	glEnable(GL_LIGHTING);
 
@@ -159,6 +188,77 @@ inline void CPointCloud::internal_render_one_point(size_t i) const
 }
 
 
+/** Uploads the points (and colors) to graphics memory if needed */
+bool CPointCloud::internal_update_vbos() const
+{
+#if MRPT_HAS_OPENGL_GLUT
+	if (!CVertexBufferObject::isSupported())
+		return false;
+
+	const size_t N = m_xs.size();
+	if (!m_vbo_xyz.isUpToDate() || !m_vbo_idxs.isUpToDate())
+	{
+		std::vector<float> xyz(3*N);
+		for (size_t i=0;i<N;i++)
+		{
+			xyz[3*i+0] = m_xs[i];
+			xyz[3*i+1] = m_ys[i];
+			xyz[3*i+2] = m_zs[i];
+		}
+		std::vector<uint32_t> idxs;
+		octree_build_node_ordered_indices(idxs);
+
+		if (!m_vbo_xyz.upload(xyz.empty() ? NULL : &xyz[0], sizeof(float)*xyz.size()) ||
+			!m_vbo_idxs.upload(idxs.empty() ? NULL : &idxs[0], sizeof(uint32_t)*idxs.size()))
+			return false;
+	}
+
+	if (m_colorFromDepth!=colNone && (!m_vbo_colors.isUpToDate() || m_vbo_colors_alpha!=m_color.A))
+	{
+		// Same colors than internal_render_one_point():
+		const float A = m_color.A * (1.0f/255.f);
+		std::vector<float> rgba(4*N);
+		for (size_t i=0;i<N;i++)
+		{
+			float *c = &rgba[4*i];
+			if (m_max_m_min>0)
+			{
+				const float depthCol = (m_colorFromDepth==colX ? m_xs[i] : (m_colorFromDepth==colY ? m_ys[i] : m_zs[i]));
+				float	f = (depthCol - m_min) * m_max_m_min_inv;
+				f=std::max(0.0f,min(1.0f,f));
+				c[0] = m_colorFromDepth_min.R + f*m_col_slop_inv.R;
+				c[1] = m_colorFromDepth_min.G + f*m_col_slop_inv.G;
+				c[2] = m_colorFromDepth_min.B + f*m_col_slop_inv.B;
+			}
+			else
+			{
+				c[0] = m_color.R * (1.0f/255.f);
+				c[1] = m_color.G * (1.0f/255.f);
+				c[2] = m_color.B * (1.0f/255.f);
+			}
+			c[3] = A;
+		}
+		if (!m_vbo_colors.upload(rgba.empty() ? NULL : &rgba[0], sizeof(float)*rgba.size()))
+			return false;
+		m_vbo_colors_alpha = m_color.A;
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+/** Render a range of the points stored in graphics memory (required by octree renderer) */
+void  CPointCloud::render_index_range(const size_t first, const size_t count) const
+{
+#if MRPT_HAS_OPENGL_GLUT
+	m_last_rendered_count_ongoing += count;
+	glDrawElements(GL_POINTS, static_cast<GLsizei>(count), GL_UNSIGNED_INT, reinterpret_cast<const GLvoid*>(first*sizeof(uint32_t)) );
+#else
+	MRPT_UNUSED_PARAM(first); MRPT_UNUSED_PARAM(count);
+#endif
+}
+
 /** Render a subset of points (required by octree renderer) */
 void  CPointCloud::render_subset(const bool all, const std::vector<size_t>& idxs, const float render_area_sqpixels ) const
 {
@@ -322,6 +422,7 @@ void  CPointCloud::setGradientColors( const mrpt::utils::TColorf &colorMin, cons
 {
 	m_colorFromDepth_min = colorMin;
 	m_colorFromDepth_max = colorMax;
+	m_vbo_colors.invalidate();
 }
 
 // Do needed internal work if all points are new (octree rebuilt,...)
@@ -329,6 +430,9 @@ void CPointCloud::markAllPointsAsNew()
 {
 	m_minmax_valid = false;
 	octree_mark_as_outdated();
+	m_vbo_xyz.invalidate();
+	m_vbo_colors.invalidate();
+	m_vbo_idxs.invalidate();
 }
 
 /** In a base class, reserve memory to prepare subsequent calls to PLY_import_set_vertex */
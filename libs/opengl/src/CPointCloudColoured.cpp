@@ -55,9 +55,39 @@ void   CPointCloudColoured::render() const
 	// Disable lighting for point clouds:
 	glDisable(GL_LIGHTING);
 
-	glBegin( GL_POINTS );
-	octree_render(ri); // Render all points recursively:
-	glEnd();
+	// Points and colors in graphics memory are only used for opaque clouds, since the per-point colors have no alpha channel:
+	bool use_vbo = (m_color.A==255 && CVertexBufferObject::isSupported());
+	if (use_vbo && (!m_vbo_points.isUpToDate() || !m_vbo_idxs.isUpToDate()))
+	{
+		std::vector<uint32_t> idxs;
+		octree_build_node_ordered_indices(idxs);
+		use_vbo =
+			m_vbo_points.upload(m_points.empty() ? NULL : &m_points[0], sizeof(TPointColour)*m_points.size()) &&
+			m_vbo_idxs.upload(idxs.empty() ? NULL : &idxs[0], sizeof(uint32_t)*idxs.size());
+	}
+
+	if (use_vbo)
+	{
+		m_vbo_points.bind();
+		m_vbo_idxs.bind();
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glEnableClientState(GL_COLOR_ARRAY);
+		glVertexPointer(3, GL_FLOAT, sizeof(TPointColour), reinterpret_cast<const GLvoid*>(0) );
+		glColorPointer (3, GL_FLOAT, sizeof(TPointColour), reinterpret_cast<const GLvoid*>(3*sizeof(float)) );
+
+		octree_render_index_ranges(ri); // Render visible nodes
+
+		glDisableClientState(GL_COLOR_ARRAY);
+		glDisableClientState(GL_VERTEX_ARRAY);
+		m_vbo_idxs.unbind();
+		m_vbo_points.unbind();
+	}
+	else
+	{
+		glBegin( GL_POINTS );
+		octree_render(ri); // Render all points recursively:
+		glEnd();
+	}
 
 	glEnable(GL_LIGHTING);
 
@@ -108,6 +138,17 @@ void  CPointCloudColoured::render_subset(const bool all, const std::vector<size_
 #endif
 }
 
+/** Render a range of the points stored in graphics memory (required by octree renderer) */
+void  CPointCloudColoured::render_index_range(const size_t first, const size_t count) const
+{
+#if MRPT_HAS_OPENGL_GLUT
+	m_last_rendered_count_ongoing += count;
+	glDrawElements(GL_POINTS, static_cast<GLsizei>(count), GL_UNSIGNED_INT, reinterpret_cast<const GLvoid*>(first*sizeof(uint32_t)) );
+#else
+	MRPT_UNUSED_PARAM(first); MRPT_UNUSED_PARAM(count);
+#endif
+}
+
 
 /*---------------------------------------------------------------
    Implements the writing to a CStream capability of
@@ -204,6 +245,8 @@ void CPointCloudColoured::push_back(float x,float y,float z, float R, float G, f
 void CPointCloudColoured::markAllPointsAsNew()
 {
 	octree_mark_as_outdated();
+	m_vbo_points.invalidate();
+	m_vbo_idxs.invalidate();
 }
 
 /** In a base class, reserve memory to prepare subsequent calls to PLY_import_set_vertex */
@@ -0,0 +1,174 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include "opengl-precomp.h"  // Precompiled header
+
+#include <mrpt/opengl/CVertexBufferObject.h>
+#include <mrpt/synch/CCriticalSection.h>
+#include <vector>
+#include <cstdio>
+
+#include "opengl_internals.h"
+
+using namespace mrpt;
+using namespace mrpt::opengl;
+
+bool mrpt::global_settings::OPENGL_USE_VERTEX_BUFFER_OBJECTS = true;
+
+namespace
+{
+	// Buffers must be deleted from a thread with the OpenGL context: keep a list of
+	// pending deletions, processed in the next upload(). Never destroyed, since buffers may be released
+	// from destructors of static objects.
+	struct TAuxVBOData
+	{
+		std::vector<unsigned int>      vbos_to_delete;
+		mrpt::synch::CCriticalSection  vbos_to_delete_cs;
+
+		static TAuxVBOData& getSingleton()
+		{
+			static TAuxVBOData *obj = new TAuxVBOData;
+			return *obj;
+		}
+	};
+
+#if MRPT_HAS_OPENGL_GLUT
+	inline GLenum vbo_target(CVertexBufferObject::TBufferType t)
+	{
+		return t==CVertexBufferObject::vboIndexData ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+	}
+#endif
+}
+
+CVertexBufferObject::CVertexBufferObject(TBufferType type) :
+	m_type(type),
+	m_id(0),
+	m_uptodate(false),
+	m_size(0)
+{
+}
+
+CVertexBufferObject::CVertexBufferObject(const CVertexBufferObject &o) :
+	m_type(o.m_type),
+	m_id(0),
+	m_uptodate(false),
+	m_size(0)
+{
+}
+
+CVertexBufferObject & CVertexBufferObject::operator =(const CVertexBufferObject &o)
+{
+	if (this!=&o)
+	{
+		m_type = o.m_type;
+		m_uptodate = false;
+	}
+	return *this;
+}
+
+CVertexBufferObject::~CVertexBufferObject()
+{
+	releaseBuffer();
+}
+
+void CVertexBufferObject::releaseBuffer()
+{
+	if (!m_id) return;
+	TAuxVBOData & obj = TAuxVBOData::getSingleton();
+	obj.vbos_to_delete_cs.enter();
+		obj.vbos_to_delete.push_back(m_id);
+	obj.vbos_to_delete_cs.leave();
+	m_id = 0;
+	m_size = 0;
+	m_uptodate = false;
+}
+
+bool CVertexBufferObject::isSupported()
+{
+#if MRPT_HAS_OPENGL_GLUT
+	if (!mrpt::global_settings::OPENGL_USE_VERTEX_BUFFER_OBJECTS)
+		return false;
+
+	// -1: not checked yet. Buffer objects are core since OpenGL 1.5:
+	static int supported = -1;
+	if (supported<0)
+	{
+		const char *ver = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+		if (!ver) return false; // No context yet: don't cache the result
+		int major=0, minor=0;
+		supported = (::sscanf(ver,"%d.%d",&major,&minor)==2 && (major>1 || (major==1 && minor>=5))) ? 1:0;
+
+#ifdef MRPT_OS_WINDOWS
+		// In win32 we have to load the pointers to the functions:
+		if (supported)
+		{
+			glGenBuffers    = (PFNGLGENBUFFERSPROC)wglGetProcAddress("glGenBuffers");
+			glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)wglGetProcAddress("glDeleteBuffers");
+			glBindBuffer    = (PFNGLBINDBUFFERPROC)wglGetProcAddress("glBindBuffer");
+			glBufferData    = (PFNGLBUFFERDATAPROC)wglGetProcAddress("glBufferData");
+			if (!glGenBuffers || !glDeleteBuffers || !glBindBuffer || !glBufferData)
+				supported = 0;
+		}
+#endif
+	}
+	return supported!=0;
+#else
+	return false;
+#endif
+}
+
+bool CVertexBufferObject::upload(const void *data, const size_t num_bytes)
+{
+#if MRPT_HAS_OPENGL_GLUT
+	// Free pending buffers, now that we are in the rendering thread:
+	TAuxVBOData & obj = TAuxVBOData::getSingleton();
+	if (!obj.vbos_to_delete.empty())
+	{
+		obj.vbos_to_delete_cs.enter();
+		if (!obj.vbos_to_delete.empty())
+			glDeleteBuffers(static_cast<GLsizei>(obj.vbos_to_delete.size()), &obj.vbos_to_delete[0]);
+		obj.vbos_to_delete.clear();
+		obj.vbos_to_delete_cs.leave();
+	}
+
+	glGetError(); // Clear previous error flags, not related to us
+	if (!m_id)
+		glGenBuffers(1, &m_id);
+
+	const GLenum target = vbo_target(m_type);
+	glBindBuffer(target, m_id);
+	glBufferData(target, num_bytes, data, GL_STATIC_DRAW);
+	if (glGetError()!=GL_NO_ERROR)
+	{
+		glBindBuffer(target, 0);
+		releaseBuffer();
+		return false;
+	}
+	m_size = num_bytes;
+	m_uptodate = true;
+	return true;
+#else
+	MRPT_UNUSED_PARAM(data); MRPT_UNUSED_PARAM(num_bytes);
+	return false;
+#endif
+}
+
+void CVertexBufferObject::bind() const
+{
+#if MRPT_HAS_OPENGL_GLUT
+	glBindBuffer(vbo_target(m_type), m_id);
+#endif
+}
+
+void CVertexBufferObject::unbind() const
+{
+#if MRPT_HAS_OPENGL_GLUT
+	glBindBuffer(vbo_target(m_type), 0);
+#endif
+}
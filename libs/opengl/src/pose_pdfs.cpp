@@ -106,7 +106,7 @@ CSetOfObjectsPtr CSetOfObjects::posePDF2opengl(const CPosePDF &o)
 
 		for (size_t i=0;i<p->size();++i)
 		{
-			const mrpt::poses::CPose2D *po = p->m_particles[i].d;
+			const mrpt::poses::CPose2D *po = &p->m_particles[i].d;
 			pnts->insertPoint(po->x(), po->y(), 0);
 			lins->appendLine(
 				po->x(), po->y(), 0,
@@ -238,7 +238,7 @@ CSetOfObjectsPtr CSetOfObjects::posePDF2opengl(const CPose3DPDF &o)
 		for (size_t i=0;i<p->size();i++)
 		{
 			opengl::CSetOfObjectsPtr axes = opengl::stock_objects::CornerXYZSimple(POSE_AXIS_SCALE);
-			axes->setPose(*p->m_particles[i].d);
+			axes->setPose(p->m_particles[i].d);
 			outObj->insert(axes);
 		}
 
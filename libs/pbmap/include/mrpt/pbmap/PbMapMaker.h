@@ -26,6 +26,7 @@
 #include <mrpt/pbmap/PlaneInferredInfo.h>
 #include <mrpt/pbmap/PbMap.h>
 #include <mrpt/pbmap/PbMapLocaliser.h>
+#include <mrpt/pbmap/PlanesSpatialIndex.h>
 #include <mrpt/pbmap/SemanticClustering.h>
 #include <mrpt/pbmap/link_pragmas.h>
 #include <set>
@@ -119,6 +120,9 @@ namespace pbmap {
     /*!The current PbMap.*/
     PbMap mPbMap;
 
+    /*!Spatial index of the planes in mPbMap, to find the candidates to be merged with or to be near a plane.*/
+    PlanesSpatialIndex planesIndex;
+
     /*!List of planes observed in that last frame introduced.*/
     std::set<unsigned> observedPlanes;
 
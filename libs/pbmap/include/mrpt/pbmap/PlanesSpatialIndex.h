@@ -0,0 +1,103 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+/*  Plane-based Map (PbMap) library
+ *  Construction of plane-based maps and localization in it from RGBD Images.
+ *  Writen by Eduardo Fernandez-Moral. See docs for <a href="group__mrpt__pbmap__grp.html" >mrpt-pbmap</a>
+ */
+
+#ifndef __PLANESSPATIALINDEX_H
+#define __PLANESSPATIALINDEX_H
+
+#include <mrpt/config.h>
+#if MRPT_HAS_PCL
+
+#include <mrpt/utils/types_math.h> // Eigen
+#include <mrpt/pbmap/link_pragmas.h>
+#include <mrpt/pbmap/Plane.h>
+#include <map>
+#include <vector>
+#include <cmath>
+
+namespace mrpt {
+namespace pbmap {
+
+  /*! A spatial index of the planes of a PbMap, used to find the candidates to be merged with or to be near a given plane
+   *  without comparing it with all the planes of the map.
+   *  Each plane is represented by the axis-aligned bounding box of its center and its polygonal contour, which is registered in the cells of
+   *  a uniform 3D grid. getCandidates() returns exactly the planes whose bounding box overlaps that of the query plane once enlarged by a
+   *  given distance. Thus, it returns all the planes with a vertex, an edge or the center closer than such distance to a vertex, an edge or
+   *  the center of the query plane. Note that PbMapMaker::arePlanesNearby() also accepts a vertex close to the supporting plane of the other
+   *  polygon and inside its hull projected onto the XY plane, which for steep planes may be farther than the distance from its bounding box.
+   *
+   *  Planes are identified by their "id", i.e. their index in PbMap::vPlanes. The index must be rebuilt when these indices change.
+   *
+   * \ingroup mrpt_pbmap_grp
+   */
+  class PBMAP_IMPEXP PlanesSpatialIndex
+  {
+   public:
+
+    /*!Constructor, with the size of the grid cells (in meters).*/
+    PlanesSpatialIndex(const float cell_size = 1.0f);
+
+    /*!Remove all the planes.*/
+    void clear();
+
+    /*!Insert the plane, or update its bounding box if it was already in the index (e.g. after merging it with a new observation).*/
+    void insert(const Plane &plane);
+
+    /*!Rebuild the index from scratch with all the planes in "vPlanes".*/
+    void rebuild(const std::vector<Plane> &vPlanes);
+
+    /*!Get the ids (in ascending order) of the planes whose bounding box is closer than "distThreshold" to the bounding box of "plane".
+     * The query plane itself is also returned if it is in the index.*/
+    void getCandidates(const Plane &plane, const float distThreshold, std::vector<unsigned> &candidates) const;
+
+    /*!Number of planes in the index.*/
+    inline size_t size() const {return m_num_planes;}
+
+   private:
+
+    struct TBoundingBox
+    {
+      TBoundingBox() : valid(false) {}
+      Eigen::Vector3f min, max;
+      bool valid;
+    };
+
+    typedef uint64_t cell_key_t;
+
+    float m_cell_size;
+    size_t m_num_planes;
+
+    /*!The bounding box of each plane, indexed by the plane id.*/
+    std::vector<TBoundingBox> m_boxes;
+
+    /*!The ids of the planes overlapping each non-empty cell.*/
+    std::map<cell_key_t, std::vector<unsigned> > m_cells;
+
+    static TBoundingBox getBoundingBox(const Plane &plane);
+
+    inline int cellIndex(const float x) const {return static_cast<int>(std::floor(x / m_cell_size));}
+
+    static inline cell_key_t cellKey(const int cx, const int cy, const int cz)
+    {
+      const cell_key_t mask = (1 << 21) - 1; // 21 bits per coordinate
+      return ((static_cast<cell_key_t>(cx) & mask) << 42) | ((static_cast<cell_key_t>(cy) & mask) << 21) | (static_cast<cell_key_t>(cz) & mask);
+    }
+
+    /*!Insert (add=true) or remove (add=false) the plane "id" in the cells overlapped by "box".*/
+    void updateCells(const unsigned id, const TBoundingBox &box, const bool add);
+  };
+
+} } // End of namespaces
+
+#endif
+#endif
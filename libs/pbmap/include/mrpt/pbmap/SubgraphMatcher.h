@@ -64,7 +64,10 @@ namespace pbmap {
     /*!Set target subgraph.*/
     void inline setTargetSubgraph(Subgraph &subgTrg){subgraphTrg = &subgTrg;}
 
-    /*!Returns a list with plane matches from subgraphSrc to subgraphTrg.*/
+    /*!Returns a list with plane matches from subgraphSrc to subgraphTrg.
+     * The interpretation tree is explored as in exploreSubgraphTreeR(), but the branches hanging from its root (one for each candidate
+     * pair of planes) are explored in parallel, sharing the pruning bound given by the best match found so far. The result is the same
+     * as that of the sequential search.*/
 //    std::map<unsigned,unsigned> compareSubgraphs(Subgraph &subgraphSource, Subgraph &subgraphTarget);
     std::map<unsigned,unsigned> compareSubgraphs(Subgraph &subgraphSource, Subgraph &subgraphTarget, const int option=0); // Options are
 
@@ -97,6 +100,15 @@ namespace pbmap {
 
     float calcAreaUnmatched(std::set<unsigned> &unmatched_planes);
 
+    /*!Auxiliary structures for the parallel search of compareSubgraphs().*/
+    struct TSearchState;
+    struct TSearchBranch;
+    struct TSearchBranchesEvaluator;
+
+    /*!Explores one branch of the interpretation tree for compareSubgraphs(): same as exploreSubgraphTreeR(), but the branch keeps its own winner
+     * and prunes against the best match found by any branch.*/
+    void exploreSubgraphBranchR(std::set<unsigned> &sourcePlanes, std::set<unsigned> &targetPlanes, std::map<unsigned, unsigned> &matched, TSearchState &state, TSearchBranch &branch);
+
   };
 
 } } // End of namespaces
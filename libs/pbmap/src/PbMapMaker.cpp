@@ -48,6 +48,28 @@ using namespace mrpt::pbmap;
 
 mrpt::synch::CCriticalSection CS_visualize;
 
+namespace
+{
+  // Renumber the plane ids of a set of planes after erasing the plane "erased_id" from the map
+  void shiftIdsAfterErase(set<unsigned> &ids, const unsigned erased_id)
+  {
+    set<unsigned> shifted;
+    for(set<unsigned>::iterator it = ids.begin(); it != ids.end(); it++)
+      if(*it != erased_id)
+        shifted.insert(*it > erased_id ? *it-1 : *it);
+    ids.swap(shifted);
+  }
+
+  void shiftIdsAfterErase(map<unsigned,unsigned> &ids, const unsigned erased_id)
+  {
+    map<unsigned,unsigned> shifted;
+    for(map<unsigned,unsigned>::iterator it = ids.begin(); it != ids.end(); it++)
+      if(it->first != erased_id)
+        shifted[it->first > erased_id ? it->first-1 : it->first] = it->second;
+    ids.swap(shifted);
+  }
+}
+
 // Bhattacharyya histogram distance function
 double BhattacharyyaDist(std::vector<float> &hist1, std::vector<float> &hist2)
 {
@@ -210,12 +232,12 @@ bool PbMapMaker::arePlanesNearby(Plane &plane1, Plane &plane2, const float distT
 
   // c)
   for(unsigned i=1; i < plane1.polygonContourPtr->size(); i++)
-    if( plane2.v3normal.dot(getVector3fromPointXYZ(plane1.polygonContourPtr->points[i]) - plane2.v3center) < distThreshold )
+    if( fabs(plane2.v3normal.dot(getVector3fromPointXYZ(plane1.polygonContourPtr->points[i]) - plane2.v3center)) < distThreshold )
       if(isInHull(plane1.polygonContourPtr->points[i], plane2.polygonContourPtr) )
         return true;
 
   for(unsigned j=1; j < plane2.polygonContourPtr->size(); j++)
-    if( plane1.v3normal.dot(getVector3fromPointXYZ(plane2.polygonContourPtr->points[j]) - plane1.v3center) < distThreshold )
+    if( fabs(plane1.v3normal.dot(getVector3fromPointXYZ(plane2.polygonContourPtr->points[j]) - plane1.v3center)) < distThreshold )
       if(isInHull(plane2.polygonContourPtr->points[j], plane1.polygonContourPtr) )
         return true;
 
@@ -242,18 +264,24 @@ bool PbMapMaker::arePlanesNearby(Plane &plane1, Plane &plane2, const float distT
 
 void PbMapMaker::checkProximity(Plane &plane, float proximity)
 {
-  for(unsigned i=0; i < mPbMap.vPlanes.size(); i++ )
+  // Only the planes whose bounding box is closer than proximity may be near this one
+  vector<unsigned> candidates;
+  planesIndex.getCandidates(plane, proximity, candidates);
+
+  for(unsigned c=0; c < candidates.size(); c++ )
   {
-    if(plane.id == mPbMap.vPlanes[i].id)
+    Plane &candidatePlane = mPbMap.vPlanes[candidates[c]];
+
+    if(plane.id == candidatePlane.id)
       continue;
 
-    if(plane.nearbyPlanes.count(mPbMap.vPlanes[i].id))
+    if(plane.nearbyPlanes.count(candidatePlane.id))
       continue;
 
-    if(arePlanesNearby(plane, mPbMap.vPlanes[i], proximity) ) // If the planes are closer than proximity (in meters), then mark them as neighbors
+    if(arePlanesNearby(plane, candidatePlane, proximity) ) // If the planes are closer than proximity (in meters), then mark them as neighbors
     {
-      plane.nearbyPlanes.insert(mPbMap.vPlanes[i].id);
-      mPbMap.vPlanes[i].nearbyPlanes.insert(plane.id);
+      plane.nearbyPlanes.insert(candidatePlane.id);
+      candidatePlane.nearbyPlanes.insert(plane.id);
     }
   }
 }
@@ -532,13 +560,14 @@ void PbMapMaker::detectPlanesCloud( pcl::PointCloud<PointT>::Ptr &pointCloudPtr_
     *mPbMap.globalMapPtr = globalMap;
   } // End CS
 
-  pcl::IntegralImageNormalEstimation<PointT, pcl::Normal> ne;
+  // The normal estimator and the segmentation are kept between keyframes to reuse their integral images and buffers
+  static pcl::IntegralImageNormalEstimation<PointT, pcl::Normal> ne;
   ne.setNormalEstimationMethod (ne.COVARIANCE_MATRIX);
   ne.setMaxDepthChangeFactor (0.02f); // For VGA: 0.02f, 10.0f
   ne.setNormalSmoothingSize (10.0f);
   ne.setDepthDependentSmoothing (true);
 
-  pcl::OrganizedMultiPlaneSegmentation<PointT, pcl::Normal, pcl::Label> mps;
+  static pcl::OrganizedMultiPlaneSegmentation<PointT, pcl::Normal, pcl::Label> mps;
   mps.setMinInliers (minInliers); cout << "Params " << minInliers << " " << angleThreshold << " " << distThreshold << endl;
   mps.setAngularThreshold (angleThreshold); // (0.017453 * 2.0) // 3 degrees
   mps.setDistanceThreshold (distThreshold); //2cm
@@ -644,12 +673,14 @@ void PbMapMaker::detectPlanesCloud( pcl::PointCloud<PointT>::Ptr &pointCloudPtr_
  { mrpt::synch::CCriticalSectionLocker csl(&CS_visualize);
   for (size_t i = 0; i < detectedPlanes.size (); i++)
   {
-    // Check similarity with previous planes detected
+    // Check similarity with previous planes detected (only those near the new plane can be the same)
     bool isSamePlane = false;
-    vector<Plane>::iterator itPlane = mPbMap.vPlanes.begin();
+    vector<unsigned> candidates;
+    planesIndex.getCandidates(detectedPlanes[i], configPbMap.proximity_threshold, candidates);
 //  if(frameQueue.size() != 12)
-    for(size_t j = 0; j < numPrevPlanes; j++, itPlane++) // numPrevPlanes
+    for(size_t c = 0; c < candidates.size() && candidates[c] < numPrevPlanes; c++) // numPrevPlanes
     {
+      const size_t j = candidates[c];
       if( areSamePlane(mPbMap.vPlanes[j], detectedPlanes[i], configPbMap.max_cos_normal, configPbMap.max_dist_center_plane, configPbMap.proximity_threshold) ) // The planes are merged if they are the same
       {
 //        if (j==2 && frameQueue.size() == 12)
@@ -698,6 +729,7 @@ void PbMapMaker::detectPlanesCloud( pcl::PointCloud<PointT>::Ptr &pointCloudPtr_
         isSamePlane = true;
 
         mergePlanes(mPbMap.vPlanes[j], detectedPlanes[i]);
+        planesIndex.insert(mPbMap.vPlanes[j]);
 
         // Update proximity graph
         checkProximity(mPbMap.vPlanes[j], configPbMap.proximity_neighbor_planes); // Detect neighbors
@@ -730,51 +762,52 @@ void PbMapMaker::detectPlanesCloud( pcl::PointCloud<PointT>::Ptr &pointCloudPtr_
           cout << "Same plane\n";
         #endif
 
-        itPlane++;
-        for(size_t k = j+1; k < numPrevPlanes; k++, itPlane++) // numPrevPlanes
-          if( areSamePlane(mPbMap.vPlanes[j], mPbMap.vPlanes[k], configPbMap.max_cos_normal, configPbMap.max_dist_center_plane, configPbMap.proximity_threshold) ) // The planes are merged if they are the same
+        // The grown plane may now join other previous planes: merge them too
+        bool mergedPrevPlanes = true;
+        while(mergedPrevPlanes)
+        {
+          mergedPrevPlanes = false;
+          planesIndex.getCandidates(mPbMap.vPlanes[j], configPbMap.proximity_threshold, candidates);
+          for(size_t c2 = 0; c2 < candidates.size() && candidates[c2] < numPrevPlanes; c2++) // numPrevPlanes
           {
-            mergePlanes(mPbMap.vPlanes[j], mPbMap.vPlanes[k]);
+            const size_t k = candidates[c2];
+            if(k <= j)
+              continue;
 
-            mPbMap.vPlanes[j].numObservations += mPbMap.vPlanes[k].numObservations;
+            if( areSamePlane(mPbMap.vPlanes[j], mPbMap.vPlanes[k], configPbMap.max_cos_normal, configPbMap.max_dist_center_plane, configPbMap.proximity_threshold) ) // The planes are merged if they are the same
+            {
+              mergePlanes(mPbMap.vPlanes[j], mPbMap.vPlanes[k]);
 
-            for(set<unsigned>::iterator it = mPbMap.vPlanes[k].nearbyPlanes.begin(); it != mPbMap.vPlanes[k].nearbyPlanes.end(); it++)
-              mPbMap.vPlanes[*it].nearbyPlanes.erase(mPbMap.vPlanes[k].id);
+              mPbMap.vPlanes[j].numObservations += mPbMap.vPlanes[k].numObservations;
 
-            for(map<unsigned,unsigned>::iterator it = mPbMap.vPlanes[k].neighborPlanes.begin(); it != mPbMap.vPlanes[k].neighborPlanes.end(); it++)
-              mPbMap.vPlanes[it->first].neighborPlanes.erase(mPbMap.vPlanes[k].id);
+              for(set<unsigned>::iterator it = mPbMap.vPlanes[k].nearbyPlanes.begin(); it != mPbMap.vPlanes[k].nearbyPlanes.end(); it++)
+                mPbMap.vPlanes[*it].nearbyPlanes.erase(mPbMap.vPlanes[k].id);
 
-            // Update plane index
-            for(size_t h = k+1; h < numPrevPlanes; h++)
-              --mPbMap.vPlanes[h].id;
+              for(map<unsigned,unsigned>::iterator it = mPbMap.vPlanes[k].neighborPlanes.begin(); it != mPbMap.vPlanes[k].neighborPlanes.end(); it++)
+                mPbMap.vPlanes[it->first].neighborPlanes.erase(mPbMap.vPlanes[k].id);
 
-            for(size_t h = 0; h < numPrevPlanes; h++)
-            {
-              if(k==h)
-                continue;
-
-              for(set<unsigned>::iterator it = mPbMap.vPlanes[h].nearbyPlanes.begin(); it != mPbMap.vPlanes[h].nearbyPlanes.end(); it++)
-                if(*it > mPbMap.vPlanes[k].id)
-                {
-                  mPbMap.vPlanes[h].nearbyPlanes.insert(*it-1);
-                  mPbMap.vPlanes[h].nearbyPlanes.erase(*it);
-                }
-
-              for(map<unsigned,unsigned>::iterator it = mPbMap.vPlanes[h].neighborPlanes.begin(); it != mPbMap.vPlanes[h].neighborPlanes.end(); it++)
-                if(it->first > mPbMap.vPlanes[k].id)
-                {
-                  mPbMap.vPlanes[h].neighborPlanes[it->first-1] = it->second;
-                  mPbMap.vPlanes[h].neighborPlanes.erase(it);
-                }
-            }
+              mPbMap.vPlanes.erase(mPbMap.vPlanes.begin() + k);
+              --numPrevPlanes;
+
+              // Update plane index (also of the planes added in this keyframe)
+              for(size_t h = 0; h < mPbMap.vPlanes.size(); h++)
+              {
+                mPbMap.vPlanes[h].id = h;
+                shiftIdsAfterErase(mPbMap.vPlanes[h].nearbyPlanes, k);
+                shiftIdsAfterErase(mPbMap.vPlanes[h].neighborPlanes, k);
+              }
+              shiftIdsAfterErase(observedPlanes, k);
+              planesIndex.rebuild(mPbMap.vPlanes);
 
-            mPbMap.vPlanes.erase(itPlane);
-            --numPrevPlanes;
+              mergedPrevPlanes = true;
 
-            #ifdef _VERBOSE
-              cout << "MERGE TWO PREVIOUS PLANES WHEREBY THE INCORPORATION OF A NEW REGION \n";
-            #endif
+              #ifdef _VERBOSE
+                cout << "MERGE TWO PREVIOUS PLANES WHEREBY THE INCORPORATION OF A NEW REGION \n";
+              #endif
+              break;
+            }
           }
+        }
 
         break;
       }
@@ -809,6 +842,7 @@ void PbMapMaker::detectPlanesCloud( pcl::PointCloud<PointT>::Ptr &pointCloudPtr_
       observedPlanes.insert(detectedPlanes[i].id);
 
       mPbMap.vPlanes.push_back(detectedPlanes[i]);
+      planesIndex.insert(mPbMap.vPlanes.back());
     }
   }
  }
@@ -0,0 +1,144 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+/*  Plane-based Map (PbMap) library
+ *  Construction of plane-based maps and localization in it from RGBD Images.
+ *  Writen by Eduardo Fernandez-Moral. See docs for <a href="group__mrpt__pbmap__grp.html" >mrpt-pbmap</a>
+ */
+
+#include "pbmap-precomp.h"  // Precompiled headers
+
+#if MRPT_HAS_PCL
+
+#include <mrpt/pbmap/PlanesSpatialIndex.h>
+#include <mrpt/pbmap/Miscellaneous.h>
+#include <algorithm>
+
+using namespace std;
+using namespace mrpt::pbmap;
+
+PlanesSpatialIndex::PlanesSpatialIndex(const float cell_size) :
+  m_cell_size(cell_size),
+  m_num_planes(0)
+{
+  ASSERT_(cell_size > 0);
+}
+
+void PlanesSpatialIndex::clear()
+{
+  m_boxes.clear();
+  m_cells.clear();
+  m_num_planes = 0;
+}
+
+PlanesSpatialIndex::TBoundingBox PlanesSpatialIndex::getBoundingBox(const Plane &plane)
+{
+  TBoundingBox box;
+  box.min = box.max = plane.v3center;
+  for(size_t i = 0; i < plane.polygonContourPtr->size(); i++)
+  {
+    const Eigen::Vector3f pt = getVector3fromPointXYZ(plane.polygonContourPtr->points[i]);
+    box.min = box.min.cwiseMin(pt);
+    box.max = box.max.cwiseMax(pt);
+  }
+  box.valid = true;
+  return box;
+}
+
+void PlanesSpatialIndex::updateCells(const unsigned id, const TBoundingBox &box, const bool add)
+{
+  const int x0 = cellIndex(box.min[0]), x1 = cellIndex(box.max[0]);
+  const int y0 = cellIndex(box.min[1]), y1 = cellIndex(box.max[1]);
+  const int z0 = cellIndex(box.min[2]), z1 = cellIndex(box.max[2]);
+  for(int cx = x0; cx <= x1; cx++)
+    for(int cy = y0; cy <= y1; cy++)
+      for(int cz = z0; cz <= z1; cz++)
+      {
+        if(add)
+          m_cells[cellKey(cx,cy,cz)].push_back(id);
+        else
+        {
+          map<cell_key_t, vector<unsigned> >::iterator itCell = m_cells.find(cellKey(cx,cy,cz));
+          if(itCell == m_cells.end())
+            continue;
+          itCell->second.erase(std::remove(itCell->second.begin(), itCell->second.end(), id), itCell->second.end());
+          if(itCell->second.empty())
+            m_cells.erase(itCell);
+        }
+      }
+}
+
+void PlanesSpatialIndex::insert(const Plane &plane)
+{
+  if(plane.id >= m_boxes.size())
+    m_boxes.resize(plane.id+1);
+
+  TBoundingBox &box = m_boxes[plane.id];
+  if(box.valid)
+    updateCells(plane.id, box, false);
+  else
+    m_num_planes++;
+
+  box = getBoundingBox(plane);
+  updateCells(plane.id, box, true);
+}
+
+void PlanesSpatialIndex::rebuild(const std::vector<Plane> &vPlanes)
+{
+  clear();
+  for(size_t i = 0; i < vPlanes.size(); i++)
+    insert(vPlanes[i]);
+}
+
+void PlanesSpatialIndex::getCandidates(const Plane &plane, const float distThreshold, std::vector<unsigned> &candidates) const
+{
+  candidates.clear();
+
+  TBoundingBox query = getBoundingBox(plane);
+  query.min.array() -= distThreshold;
+  query.max.array() += distThreshold;
+
+  const int x0 = cellIndex(query.min[0]), x1 = cellIndex(query.max[0]);
+  const int y0 = cellIndex(query.min[1]), y1 = cellIndex(query.max[1]);
+  const int z0 = cellIndex(query.min[2]), z1 = cellIndex(query.max[2]);
+  const double num_query_cells = double(x1-x0+1) * double(y1-y0+1) * double(z1-z0+1);
+
+  if(num_query_cells > m_cells.size())
+  {
+    // The query covers more cells than those occupied: it's faster to check all the planes
+    for(size_t id = 0; id < m_boxes.size(); id++)
+      if(m_boxes[id].valid)
+        candidates.push_back(id);
+  }
+  else
+  {
+    for(int cx = x0; cx <= x1; cx++)
+      for(int cy = y0; cy <= y1; cy++)
+        for(int cz = z0; cz <= z1; cz++)
+        {
+          map<cell_key_t, vector<unsigned> >::const_iterator itCell = m_cells.find(cellKey(cx,cy,cz));
+          if(itCell != m_cells.end())
+            candidates.insert(candidates.end(), itCell->second.begin(), itCell->second.end());
+        }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+  }
+
+  // Keep only the planes whose bounding box overlaps the query
+  size_t n = 0;
+  for(size_t i = 0; i < candidates.size(); i++)
+  {
+    const TBoundingBox &box = m_boxes[candidates[i]];
+    if( (box.min.array() <= query.max.array()).all() && (query.min.array() <= box.max.array()).all() )
+      candidates[n++] = candidates[i];
+  }
+  candidates.resize(n);
+}
+
+#endif
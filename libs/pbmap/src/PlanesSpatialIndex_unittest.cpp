@@ -0,0 +1,131 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/config.h>
+#if MRPT_HAS_PCL
+
+#include <mrpt/pbmap/PlanesSpatialIndex.h>
+#include <mrpt/pbmap/Miscellaneous.h>
+#include <mrpt/random.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <functional>
+
+using namespace mrpt::pbmap;
+using namespace std;
+
+namespace
+{
+	PointT makePoint(const Eigen::Vector3f &v)
+	{
+		PointT p;
+		p.x = v[0]; p.y = v[1]; p.z = v[2];
+		return p;
+	}
+
+	// A random convex polygon (a closed contour, as those of PbMapMaker) of some size, orientation and position:
+	void makeRandomPlane(mrpt::random::CRandomGenerator &rng, const unsigned id, Plane &plane)
+	{
+		plane.id = id;
+		plane.v3center = Eigen::Vector3d(rng.drawUniform(-10,10), rng.drawUniform(-10,10), rng.drawUniform(-3,3)).cast<float>();
+		plane.v3normal = Eigen::Vector3d(rng.drawGaussian1D_normalized(), rng.drawGaussian1D_normalized(), rng.drawGaussian1D_normalized()).cast<float>().normalized();
+
+		const Eigen::Vector3f u = plane.v3normal.unitOrthogonal(), v = plane.v3normal.cross(u);
+		const float radius = static_cast<float>(rng.drawUniform(0.1,2.0));
+		const size_t nVertices = rng.drawUniform32bit() % 5 + 3;
+		plane.polygonContourPtr.reset(new pcl::PointCloud<PointT>); // Not shared with the plane it was copied from
+		for (size_t k=0;k<=nVertices;k++)
+		{
+			const float ang = static_cast<float>(M_2PI*(k % nVertices)/nVertices);
+			plane.polygonContourPtr->push_back(makePoint(plane.v3center + radius*(cos(ang)*u + sin(ang)*v)));
+		}
+	}
+
+	void getBox(const Plane &plane, Eigen::Vector3f &bbMin, Eigen::Vector3f &bbMax)
+	{
+		bbMin = bbMax = plane.v3center;
+		for (size_t k=0;k<plane.polygonContourPtr->size();k++)
+		{
+			const Eigen::Vector3f pt = getVector3fromPointXYZ(plane.polygonContourPtr->points[k]);
+			bbMin = bbMin.cwiseMin(pt);
+			bbMax = bbMax.cwiseMax(pt);
+		}
+	}
+
+	// Brute force: the squared minimum distance between the centers, vertices and edges of both planes
+	float minSquaredDistance(const Plane &p1, const Plane &p2)
+	{
+		const pcl::PointCloud<PointT> &c1 = *p1.polygonContourPtr, &c2 = *p2.polygonContourPtr;
+		float d2 = (p1.v3center - p2.v3center).squaredNorm();
+		for (size_t i=0;i<c1.size();i++)
+			d2 = std::min(d2, (getVector3fromPointXYZ(c1.points[i]) - p2.v3center).squaredNorm());
+		for (size_t j=0;j<c2.size();j++)
+			d2 = std::min(d2, (p1.v3center - getVector3fromPointXYZ(c2.points[j])).squaredNorm());
+		for (size_t i=1;i<c1.size();i++)
+			for (size_t j=1;j<c2.size();j++)
+				d2 = std::min(d2, dist3D_Segment_to_Segment2(Segment(c1.points[i],c1.points[i-1]), Segment(c2.points[j],c2.points[j-1])));
+		return d2;
+	}
+
+	// Compares getCandidates() with the brute force search over all the planes, for each plane:
+	void checkAllCandidates(const PlanesSpatialIndex &index, const vector<Plane> &planes, const float distThreshold)
+	{
+		vector<unsigned> candidates;
+		for (size_t q=0;q<planes.size();q++)
+		{
+			index.getCandidates(planes[q], distThreshold, candidates);
+			EXPECT_TRUE(std::adjacent_find(candidates.begin(), candidates.end(), std::greater_equal<unsigned>()) == candidates.end()) << "Not in ascending order";
+
+			Eigen::Vector3f qMin, qMax;
+			getBox(planes[q], qMin, qMax);
+			for (size_t i=0;i<planes.size();i++)
+			{
+				const bool is_candidate = std::binary_search(candidates.begin(), candidates.end(), static_cast<unsigned>(i));
+
+				// Exactly the planes whose box overlaps the enlarged box of the query:
+				Eigen::Vector3f bbMin, bbMax;
+				getBox(planes[i], bbMin, bbMax);
+				const bool overlap = (bbMin.array() <= qMax.array()+distThreshold).all() && (qMin.array()-distThreshold <= bbMax.array()).all();
+				EXPECT_EQ(overlap, is_candidate) << "query: " << q << " plane: " << i << " dist: " << distThreshold;
+
+				// No near plane is missed:
+				if (minSquaredDistance(planes[q], planes[i]) < distThreshold*distThreshold)
+					EXPECT_TRUE(is_candidate) << "query: " << q << " plane: " << i << " dist: " << distThreshold;
+			}
+		}
+	}
+}
+
+TEST(PlanesSpatialIndex, getCandidatesEqualsBruteForce)
+{
+	mrpt::random::CRandomGenerator rng(1234);
+	vector<Plane> planes(200);
+	for (size_t i=0;i<planes.size();i++)
+		makeRandomPlane(rng, i, planes[i]);
+
+	PlanesSpatialIndex index(1.0f);
+	index.rebuild(planes);
+	EXPECT_EQ(planes.size(), index.size());
+
+	const float thresholds[] = { 0.05f, 0.3f, 1.0f, 4.0f };
+	for (size_t k=0;k<sizeof(thresholds)/sizeof(thresholds[0]);k++)
+		checkAllCandidates(index, planes, thresholds[k]);
+
+	// Update some planes in place (e.g. after merging them with new observations), as PbMapMaker does:
+	for (size_t i=0;i<planes.size();i+=3)
+	{
+		makeRandomPlane(rng, i, planes[i]);
+		index.insert(planes[i]);
+	}
+	EXPECT_EQ(planes.size(), index.size());
+	for (size_t k=0;k<sizeof(thresholds)/sizeof(thresholds[0]);k++)
+		checkAllCandidates(index, planes, thresholds[k]);
+}
+
+#endif
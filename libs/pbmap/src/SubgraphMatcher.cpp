@@ -15,6 +15,9 @@
 #include "pbmap-precomp.h"  // Precompiled headers
 #include <mrpt/utils/utils_defs.h>
 #include <mrpt/pbmap/SubgraphMatcher.h>
+#include <mrpt/system/parallelization.h>
+#include <mrpt/synch/CCriticalSection.h>
+#include <mrpt/synch/atomic_incr.h>
 
 //#define _VERBOSE 1
 
@@ -1052,6 +1055,133 @@ void SubgraphMatcher::exploreSubgraphTreeR_Area(set<unsigned> &sourcePlanes, set
     winnerMatch = matched;}
 }
 
+/*!Pruning bound shared by all the branches of the interpretation tree explored in parallel by compareSubgraphs().
+ * The best match is encoded as the key "size*num_branches + (num_branches-1-branch)", so that the branches found earlier by the
+ * sequential search win the ties: a branch only prunes the subtrees which could not beat the best key, and the final result does not
+ * depend on the order in which the branches are evaluated.*/
+struct SubgraphMatcher::TSearchState
+{
+  TSearchState(const size_t num_branches_, const unsigned min_planes) :
+    num_branches(num_branches_), best_key(key(min_planes,0))
+  {}
+
+  const size_t num_branches;
+
+  mrpt::synch::CCriticalSection cs_best;
+  volatile size_t best_key; //!< Also read without locking cs_best, with atomic_load_acquire()
+
+  inline size_t key(const size_t num_matches, const size_t branch) const { return num_matches*num_branches + (num_branches-1-branch); }
+
+  /*!True if a subtree of "branch" with at most "max_matches" matches cannot improve the best match found so far.*/
+  inline bool canPrune(const size_t max_matches, const size_t branch) const
+  {
+    return key(max_matches,branch) <= mrpt::synch::atomic_load_acquire(&best_key);
+  }
+
+  void update(const size_t num_matches, const size_t branch)
+  {
+    const size_t k = key(num_matches,branch);
+    if( k <= mrpt::synch::atomic_load_acquire(&best_key) )
+      return;
+    mrpt::synch::CCriticalSectionLocker lock(&cs_best);
+    if( k > best_key )
+      mrpt::synch::atomic_store_release(&best_key, k);
+  }
+};
+
+/*!A branch of the interpretation tree hanging from its root: the source plane sourcePlanes[src_pos] is matched to the target plane trg.*/
+struct SubgraphMatcher::TSearchBranch
+{
+  size_t idx; //!< Index of this branch in the order of the sequential search
+  size_t src_pos;
+  unsigned trg;
+
+  std::map<unsigned, unsigned> winner; //!< Best match found in this branch
+  std::vector<std::map<unsigned,unsigned> > explored; //!< Combinations explored in this branch
+};
+
+struct SubgraphMatcher::TSearchBranchesEvaluator
+{
+  SubgraphMatcher &matcher;
+  TSearchState &state;
+  const std::vector<unsigned> &sourcePlanes;
+  const std::set<unsigned> &targetPlanes;
+  std::vector<TSearchBranch> &branches;
+
+  TSearchBranchesEvaluator(SubgraphMatcher &matcher_, TSearchState &state_, const std::vector<unsigned> &sourcePlanes_, const std::set<unsigned> &targetPlanes_, std::vector<TSearchBranch> &branches_) :
+    matcher(matcher_), state(state_), sourcePlanes(sourcePlanes_), targetPlanes(targetPlanes_), branches(branches_)
+  {}
+
+  void operator()(const mrpt::system::BlockedRange &range) const
+  {
+    for(int i = range.begin(); i != range.end(); i++)
+    {
+      TSearchBranch &branch = branches[i];
+
+      // The bound checked at the root of the tree before matching the source plane sourcePlanes[src_pos]
+      if( state.canPrune(min(sourcePlanes.size() - branch.src_pos, targetPlanes.size()), branch.idx) )
+        continue;
+
+      set<unsigned> nextSrcPlanes(sourcePlanes.begin() + branch.src_pos + 1, sourcePlanes.end());
+      set<unsigned> nextTrgPlanes = targetPlanes;
+      nextTrgPlanes.erase(branch.trg);
+      map<unsigned, unsigned> nextMatched;
+      nextMatched[sourcePlanes[branch.src_pos]] = branch.trg;
+
+      branch.explored.push_back(nextMatched);
+
+      matcher.exploreSubgraphBranchR(nextSrcPlanes, nextTrgPlanes, nextMatched, state, branch);
+    }
+  }
+};
+
+void SubgraphMatcher::exploreSubgraphBranchR(set<unsigned> &sourcePlanes, set<unsigned> &targetPlanes, map<unsigned, unsigned> &matched, TSearchState &state, TSearchBranch &branch)
+{
+  while(!sourcePlanes.empty())
+  {
+    set<unsigned>::iterator it1 = sourcePlanes.begin();
+
+    if( state.canPrune(matched.size() + min(sourcePlanes.size(),targetPlanes.size()), branch.idx) )
+      return;
+
+    for(set<unsigned>::iterator it2 = targetPlanes.begin(); it2 != targetPlanes.end(); it2++)
+    {
+      // Check that it1 and it2 correspond to the same plane
+      if( hashUnaryConstraints[*it1][*it2] != 1 )
+        continue;
+
+      bool binaryFail = false;
+      for(map<unsigned, unsigned>::iterator it_matched = matched.begin(); it_matched != matched.end(); it_matched++)
+        if( !evalBinaryConstraints(subgraphSrc->pPBM->vPlanes[*it1], subgraphSrc->pPBM->vPlanes[it_matched->first], subgraphTrg->pPBM->vPlanes[*it2], subgraphTrg->pPBM->vPlanes[it_matched->second]) )
+        {
+          binaryFail = true;
+          break;
+        }
+      if(binaryFail)
+        continue;
+
+      // If this point is reached, the planes it1 and it2 are candidates to be the same
+      set<unsigned> nextSrcPlanes = sourcePlanes;
+      nextSrcPlanes.erase(*it1);
+      set<unsigned> nextTrgPlanes = targetPlanes;
+      nextTrgPlanes.erase(*it2);
+      map<unsigned, unsigned> nextMatched = matched;
+      nextMatched[*it1] = *it2;
+
+      branch.explored.push_back(nextMatched);
+
+      exploreSubgraphBranchR(nextSrcPlanes, nextTrgPlanes, nextMatched, state, branch);
+    }
+    sourcePlanes.erase(it1);
+  } // End while
+
+  if(matched.size() > branch.winner.size())
+  {
+    branch.winner = matched;
+    state.update(matched.size(), branch.idx);
+  }
+}
+
 float SubgraphMatcher::calcAreaMatched(std::map<unsigned,unsigned> &matched_planes)
 {
   float areaMatched = 0;
@@ -1102,7 +1232,6 @@ std::map<unsigned,unsigned> SubgraphMatcher::compareSubgraphs(Subgraph &subgraph
 //cout << "SubgraphMatcher::compareSubgraphs... \n";
   subgraphSrc = &subgraphSource;
   subgraphTrg = &subgraphTarget;
-  map<unsigned, unsigned> matched;
 
   areaWinnerMatch = 0;
   winnerMatch.clear();
@@ -1140,7 +1269,38 @@ std::map<unsigned,unsigned> SubgraphMatcher::compareSubgraphs(Subgraph &subgraph
       for(set<unsigned>::iterator it2 = targetPlanes.begin(); it2 != targetPlanes.end(); it2++)
         hashUnaryConstraints[*it1][*it2] = (evalUnaryConstraintsOdometry2D(subgraphSrc->pPBM->vPlanes[*it1], subgraphTrg->pPBM->vPlanes[*it2], *subgraphTrg->pPBM, false ) ? 1 : 0);
 
-  exploreSubgraphTreeR(sourcePlanes, targetPlanes, matched);
+  // The first level of the interpretation tree: each branch matches a source plane (in the order of the sequential search, once the
+  // previous source planes have been discarded) to one of its candidate target planes
+  const std::vector<unsigned> vSourcePlanes(sourcePlanes.begin(), sourcePlanes.end());
+  std::vector<TSearchBranch> branches;
+  for(size_t k = 0; k < vSourcePlanes.size(); k++)
+    for(set<unsigned>::iterator it2 = targetPlanes.begin(); it2 != targetPlanes.end(); it2++)
+      if( hashUnaryConstraints[vSourcePlanes[k]][*it2] == 1 )
+      {
+        branches.push_back(TSearchBranch());
+        branches.back().idx = branches.size()-1;
+        branches.back().src_pos = k;
+        branches.back().trg = *it2;
+      }
+
+  if(!branches.empty())
+  {
+    TSearchState state(branches.size(), configLocaliser.min_planes_recognition);
+    mrpt::system::parallel_for(
+      mrpt::system::BlockedRange(0,static_cast<int>(branches.size()),1),
+      TSearchBranchesEvaluator(*this, state, vSourcePlanes, targetPlanes, branches) );
+
+    // Largest match, and the first one found by the sequential search in case of a tie
+    for(size_t i = 0; i < branches.size(); i++)
+    {
+      if(branches[i].winner.size() > winnerMatch.size())
+        winnerMatch = branches[i].winner;
+      alreadyExplored.insert(alreadyExplored.end(), branches[i].explored.begin(), branches[i].explored.end());
+    }
+    if(!winnerMatch.empty())
+      areaWinnerMatch = calcAreaMatched(winnerMatch);
+  }
+//  exploreSubgraphTreeR(sourcePlanes, targetPlanes, matched);
 //  exploreSubgraphTreeR_Area(sourcePlanes, targetPlanes, matched);
 #if _VERBOSE
   cout << "Area winnerMatch " << areaWinnerMatch << endl;
@@ -35,6 +35,7 @@ MRPT_WARNING("Including <mrpt/slam.h> makes compilation much slower, consider in
 #include <mrpt/slam/CMonteCarloLocalization2D.h>
 #include <mrpt/slam/CMonteCarloLocalization3D.h>
 #include <mrpt/slam/CICP.h>
+#include <mrpt/slam/CCorrelativeScanMatcher2D.h>
 #include <mrpt/slam/CGridMapAligner.h>
 #include <mrpt/slam/CIncrementalMapPartitioner.h>
 #include <mrpt/slam/CRejectionSamplingRangeOnlyLocalization.h>
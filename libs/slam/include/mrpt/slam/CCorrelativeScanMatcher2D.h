@@ -0,0 +1,137 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+#ifndef CCorrelativeScanMatcher2D_H
+#define CCorrelativeScanMatcher2D_H
+
+#include <mrpt/slam/CICP.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/poses/CPose2D.h>
+#include <mrpt/poses/CPosePDF.h>
+#include <mrpt/math/lightweight_geom_data.h>
+#include <mrpt/utils/CLoadableOptions.h>
+#include <deque>
+#include <vector>
+
+#include <mrpt/slam/link_pragmas.h>
+
+namespace mrpt
+{
+	namespace slam
+	{
+		/** A real-time correlative 2D scan matcher, which aligns each new scan with the last few scans (the "submap") instead of the whole map.
+		 *
+		 *  The points of the submap are rasterized into a lookup table of matching scores (a Gaussian blur around each point), and all
+		 *  the poses in a (x,y,phi) search window around the initial estimation are evaluated exhaustively: the scan is rotated once for each
+		 *  candidate heading and each translation is just an integer offset in the lookup table. The best pose is then refined with ICP against
+		 *  the points of the submap, which also gives the covariance of the estimation.
+		 *
+		 *  Unlike ICP alone, it copes with large errors (e.g. fast rotations) in the initial estimation, within the search window.
+		 *  The cost of each match depends on the size of the search window and of the submap (TOptions::submap_max_scans), but not on the size of the map.
+		 *  With a submap of a single scan, this is a scan-to-scan laser odometry.
+		 *
+		 *  The evaluation of the different headings runs in parallel (if built with TBB).
+		 *
+		 *  See: E. Olson, "Real-Time Correlative Scan Matching", ICRA 2009.
+		 *
+		 * \sa CMetricMapBuilderICP, CICP
+		 * \ingroup mrpt_slam_grp
+		 */
+		class SLAM_IMPEXP CCorrelativeScanMatcher2D
+		{
+		public:
+			/** The configuration of the correlative matcher */
+			struct SLAM_IMPEXP TOptions : public mrpt::utils::CLoadableOptions
+			{
+				TOptions();	//!< Initializer for default values
+
+				void loadFromConfigFile(const mrpt::utils::CConfigFileBase &source,const std::string &section) MRPT_OVERRIDE; // See base docs
+				void dumpToTextStream(mrpt::utils::CStream &out) const MRPT_OVERRIDE; // See base docs
+
+				double resolution;          //!< Cell size of the lookup table and step of the search in X,Y (meters) (default=0.05)
+				double search_window_xy;    //!< Half the size of the search window in X and Y (meters) (default=0.30)
+				double search_window_phi;   //!< Half the size of the search window in heading (rad, deg when loaded from the .ini) (default=20deg)
+				double search_step_phi;     //!< Step of the search in heading (rad, deg when loaded from the .ini) (default=1deg)
+				double sigma;               //!< Std. deviation of the matching score around each point of the submap (meters) (default=0.05)
+				double lut_max_size;        //!< Max. side of the lookup table (meters), centered at the last scan of the submap. Points beyond it are only used by ICP (default=40)
+				unsigned int scan_decimation;  //!< Use one out of N points of the new scan in the exhaustive search (default=1)
+
+				unsigned int submap_max_scans;            //!< Number of scans in the submap: the oldest one is dropped when a new one is inserted (default=10)
+				double       submap_insertion_lin_distance;  //!< Min. robot displacement (meters) from the last scan in the submap to insert a new one (default=0.10)
+				double       submap_insertion_ang_distance;  //!< Min. robot rotation (rad, deg when loaded from the .ini) from the last scan in the submap to insert a new one (default=5deg)
+			};
+
+			TOptions  options; //!< The options of the correlative matcher
+
+			/** The information returned by match() */
+			struct SLAM_IMPEXP TReturnInfo
+			{
+				TReturnInfo() : score(0), runningTime(0) { }
+				mrpt::math::TPose2D  correlative_pose; //!< The best pose of the exhaustive search (before ICP)
+				double               score;            //!< The matching score of correlative_pose, in the range [0,1]
+				CICP::TReturnInfo    icp;              //!< The information returned by the ICP refinement
+				double               runningTime;      //!< Total time (seconds)
+			};
+
+			CCorrelativeScanMatcher2D();
+
+			/** Empty the submap */
+			void clear();
+
+			/** Insert a new scan into the submap, if the robot moved enough since the last one (see TOptions), or if \a force=true or the submap is empty.
+			  * \param scan The points of the scan, in local coordinates of the robot.
+			  * \param robotPose The robot pose for the scan.
+			  * \return true if the scan has been inserted.
+			  */
+			bool insertScan(const mrpt::maps::CPointsMap &scan, const mrpt::poses::CPose2D &robotPose, const bool force = false);
+
+			inline bool   isSubmapEmpty() const { return m_scans.empty(); }
+			inline size_t getSubmapScansCount() const { return m_scans.size(); }
+
+			/** Returns all the points of the submap, in global coordinates */
+			const mrpt::maps::CSimplePointsMap & getSubmapPoints() const;
+
+			/** Align a scan with the submap.
+			  * \param scan The points of the scan, in local coordinates of the robot.
+			  * \param initialEstimation The initial estimation of the robot pose, the center of the search window.
+			  * \param icp_params The parameters of the ICP refinement.
+			  * \param info If not NULL, additional information of the matching is returned here.
+			  * \return The estimated robot pose (from the ICP refinement).
+			  * \exception std::exception If the submap is empty.
+			  */
+			mrpt::poses::CPosePDFPtr match(
+				const mrpt::maps::CPointsMap   &scan,
+				const mrpt::poses::CPose2D     &initialEstimation,
+				const CICP::TConfigParams      &icp_params,
+				TReturnInfo                    *info = NULL ) const;
+
+		private:
+			/** A scan of the submap */
+			struct TSubmapScan
+			{
+				mrpt::math::TPose2D   pose;
+				std::vector<float>    xs,ys;  //!< Points, in global coordinates
+			};
+			std::deque<TSubmapScan>  m_scans;
+
+			/** Lookup table of matching scores, rebuilt from the scans of the submap when needed: */
+			mutable bool                         m_lut_valid;
+			mutable std::vector<uint8_t>         m_lut;
+			mutable double                       m_lut_x0, m_lut_y0; //!< Coordinates of the center of the cell (0,0)
+			mutable int                          m_lut_size_x, m_lut_size_y;
+			mutable double                       m_lut_resolution, m_lut_sigma, m_lut_window_xy; //!< The options used to build the lookup table
+			mutable bool                         m_submap_points_valid;
+			mutable mrpt::maps::CSimplePointsMap m_submap_points;
+
+			void updateLookupTable() const;
+		};
+
+	} // End of namespace
+} // End of namespace
+
+#endif
@@ -11,6 +11,7 @@
 
 #include <mrpt/slam/CMetricMapBuilder.h>
 #include <mrpt/slam/CICP.h>
+#include <mrpt/slam/CCorrelativeScanMatcher2D.h>
 #include <mrpt/poses/CRobot2DPoseEstimator.h>
 
 #include <mrpt/slam/link_pragmas.h>
@@ -23,6 +24,10 @@ namespace slam
 	/** A class for very simple 2D SLAM based on ICP. This is a non-probabilistic pose tracking algorithm.
 	 *   Map are stored as in files as binary dumps of "mrpt::maps::CSimpleMap" objects. The methods are
 	 *	 thread-safe.
+	 *
+	 *  By default, each observation is aligned with ICP against the whole map. With TConfigParams::useCorrelativeScanMatcher, it is aligned
+	 *  instead against the last scans with a CCorrelativeScanMatcher2D, which copes with larger odometry errors and has a bounded cost per scan
+	 *  regardless of the map size. In this mode, disabling CMetricMapBuilder::TOptions::enableMapUpdating turns this class into a laser odometry.
 	 * \ingroup metric_slam_grp
 	 */
 	class SLAM_IMPEXP  CMetricMapBuilderICP : public mrpt::slam::CMetricMapBuilder
@@ -49,6 +54,12 @@ namespace slam
 			/** (default:false) Match against the occupancy grid or the points map? The former is quicker but less precise. */
 			bool	matchAgainstTheGrid;
 
+			/** (default:false) Align each observation against the last scans with a correlative scan matcher (exhaustive search plus ICP against a local submap),
+			  * instead of ICP against the whole map. Its parameters are in \a correlativeMatcherOptions, loaded from the section `<section>_correlativeMatcher`.
+			  * \sa CCorrelativeScanMatcher2D */
+			bool	useCorrelativeScanMatcher;
+			CCorrelativeScanMatcher2D::TOptions correlativeMatcherOptions; //!< Used if \a useCorrelativeScanMatcher=true
+
 			double insertionLinDistance;	//!< Minimum robot linear (m) displacement for a new observation to be inserted in the map.
 			double insertionAngDistance;	//!< Minimum robot angular (rad, deg when loaded from the .ini) displacement for a new observation to be inserted in the map.
 			double localizationLinDistance;	//!< Minimum robot linear (m) displacement for a new observation to be used to do ICP-based localization (otherwise, dead-reckon with odometry).
@@ -135,6 +146,9 @@ namespace slam
 		 /** Current map file. */
 		 std::string				currentMapFile;
 
+		 /** The recent scans, to align new observations with if ICP_options.useCorrelativeScanMatcher=true. */
+		 CCorrelativeScanMatcher2D				m_correlativeMatcher;
+
 		 /** The pose estimation by the alignment algorithm (ICP). */
 		 mrpt::poses::CRobot2DPoseEstimator		m_lastPoseEst;  //!< Last pose estimation (Mean)
 		 mrpt::math::CMatrixDouble33			m_lastPoseEst_cov; //!< Last pose estimation (covariance)
@@ -33,7 +33,7 @@ namespace mrpt
 		 */
 		class SLAM_IMPEXP CMonteCarloLocalization2D :
 			public mrpt::poses::CPosePDFParticles,
-			public PF_implementation<mrpt::poses::CPose2D,CMonteCarloLocalization2D>
+			public PF_implementation<mrpt::poses::CPose2D,CMonteCarloLocalization2D,mrpt::bayes::psValue>
 		{
 		public:
 			TMonteCarloLocalizationParams	options; //!< MCL parameters
@@ -30,7 +30,7 @@ namespace mrpt
 		 */
 		class SLAM_IMPEXP CMonteCarloLocalization3D :
 			public mrpt::poses::CPose3DPDFParticles,
-			public PF_implementation<mrpt::poses::CPose3D,CMonteCarloLocalization3D>
+			public PF_implementation<mrpt::poses::CPose3D,CMonteCarloLocalization3D,mrpt::bayes::psValue>
 		{
 		public:
 			TMonteCarloLocalizationParams	options; //!< MCL parameters
@@ -13,6 +13,7 @@
 #include <vector>
 #include <iostream>
 #include <iterator>
+#include <algorithm>
 
 #include <mrpt/slam/link_pragmas.h>
 
@@ -33,6 +34,13 @@ namespace mrpt
 
 				int	x,y,phi; //!< Bin indices
 
+				inline bool operator ==(const TPoseBin2D &o) const { return x==o.x && y==o.y && phi==o.phi; }
+
+				/** The bin indices packed into one integer (21 bits each), for hashing. */
+				inline uint64_t key() const {
+					return (uint64_t(uint32_t(x)) & 0x1FFFFF) | ((uint64_t(uint32_t(y)) & 0x1FFFFF)<<21) | ((uint64_t(uint32_t(phi)) & 0x1FFFFF)<<42);
+				}
+
 				/** less-than ordering of bins for usage in STL containers */
 				struct SLAM_IMPEXP lt_operator
 				{
@@ -52,6 +60,16 @@ namespace mrpt
 			{
 				std::vector<TPoseBin2D> bins;
 
+				inline bool operator ==(const TPathBin2D &o) const { return bins==o.bins; }
+
+				/** The packed keys of all the bins along the path, combined into one integer for hashing. */
+				inline uint64_t key() const {
+					uint64_t k = 0;
+					for (size_t i=0;i<bins.size();i++)
+						k = (k ^ bins[i].key()) * UINT64_C(0x100000001B3);
+					return k;
+				}
+
 				/** less-than ordering of bins for usage in STL containers */
 				struct SLAM_IMPEXP lt_operator
 				{
@@ -80,6 +98,14 @@ namespace mrpt
 
 				int	x,y,z,yaw,pitch,roll; //!< Bin indices
 
+				inline bool operator ==(const TPoseBin3D &o) const { return x==o.x && y==o.y && z==o.z && yaw==o.yaw && pitch==o.pitch && roll==o.roll; }
+
+				/** The bin indices packed into one integer (13 bits for each coordinate, 8 for each angle), for hashing. */
+				inline uint64_t key() const {
+					return  (uint64_t(uint32_t(x)) & 0x1FFF)            | ((uint64_t(uint32_t(y)) & 0x1FFF)<<13) | ((uint64_t(uint32_t(z)) & 0x1FFF)<<26) |
+					       ((uint64_t(uint32_t(yaw)) & 0xFF)<<39) | ((uint64_t(uint32_t(pitch)) & 0xFF)<<47) | ((uint64_t(uint32_t(roll)) & 0xFF)<<55);
+				}
+
 				/** less-than ordering of bins for usage in STL containers */
 				struct SLAM_IMPEXP lt_operator
 				{
@@ -100,6 +126,87 @@ namespace mrpt
 				};
 			};
 
+			/** A set of KLD-sampling bins (TPoseBin2D, TPoseBin3D, TPathBin2D,...) which also assigns consecutive indices to the bins in insertion order.
+			  *  It is an open-addressing hash table on BINTYPE::key(), so insertions and look-ups take constant time and,
+			  *  once the number of bins is stable, no memory allocations. BINTYPE must also implement operator ==.
+			  */
+			template <class BINTYPE>
+			class TKLDBinsHashSet
+			{
+			public:
+				TKLDBinsHashSet() : m_bins(), m_table(), m_num_bins(0)
+				{ }
+
+				/** Removes all the bins, but keeps the reserved memory */
+				void clear()
+				{
+					m_num_bins = 0;
+					std::fill(m_table.begin(),m_table.end(), EMPTY);
+				}
+
+				/** Number of different bins */
+				inline size_t size() const { return m_num_bins; }
+
+				/** The i'th bin, in insertion order */
+				inline const BINTYPE & operator [](size_t i) const { return m_bins[i]; }
+
+				/** Inserts a bin, if not already in the set.
+				  * \return The index of the bin, in insertion order.
+				  * \param[out] is_new Set to true if the bin was not in the set before.
+				  */
+				size_t insert(const BINTYPE &b, bool &is_new)
+				{
+					if (2*(m_num_bins+1) > m_table.size())
+						rehash( m_table.empty() ? 64 : 2*m_table.size() );
+
+					const size_t mask = m_table.size()-1;
+					for (size_t pos = hash(b.key()) & mask; ; pos = (pos+1) & mask)
+					{
+						const uint32_t idx = m_table[pos];
+						if (idx==EMPTY)
+						{
+							is_new = true;
+							m_table[pos] = static_cast<uint32_t>(m_num_bins);
+							if (m_num_bins<m_bins.size())
+								m_bins[m_num_bins] = b;
+							else	m_bins.push_back(b);
+							return m_num_bins++;
+						}
+						if (m_bins[idx]==b)
+						{
+							is_new = false;
+							return idx;
+						}
+					}
+				}
+
+			private:
+				static const uint32_t EMPTY = 0xFFFFFFFF;
+
+				std::vector<BINTYPE>  m_bins;  //!< The bins, in insertion order (elements beyond m_num_bins are stale)
+				std::vector<uint32_t> m_table; //!< Indices in m_bins, or EMPTY (the size is always a power of two)
+				size_t                m_num_bins;
+
+				static inline size_t hash(uint64_t key)
+				{
+					key ^= key >> 31;
+					key *= UINT64_C(0x9E3779B97F4A7C15);
+					return static_cast<size_t>(key ^ (key >> 29));
+				}
+
+				void rehash(size_t new_size)
+				{
+					m_table.assign(new_size, EMPTY);
+					const size_t mask = new_size-1;
+					for (size_t i=0;i<m_num_bins;i++)
+					{
+						size_t pos = hash(m_bins[i].key()) & mask;
+						while (m_table[pos]!=EMPTY) pos = (pos+1) & mask;
+						m_table[pos] = static_cast<uint32_t>(i);
+					}
+				}
+			};
+			template <class BINTYPE> const uint32_t TKLDBinsHashSet<BINTYPE>::EMPTY;
 
 		} // End of namespace
 	} // End of namespace
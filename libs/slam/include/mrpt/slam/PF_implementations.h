@@ -22,6 +22,7 @@
 #include <mrpt/math/data_utils.h>  // averageLogLikelihood()
 
 #include <mrpt/slam/PF_implementations_data.h>
+#include <mrpt/slam/PF_aux_structs.h>
 
 #include <mrpt/slam/link_pragmas.h>
 
@@ -39,9 +40,9 @@ namespace mrpt
 		  *  This method is smart enough to accumulate CActionRobotMovement2D or CActionRobotMovement3D, whatever comes in.
 		  *   \ingroup mrpt_slam_grp 
 		  */
-		template <class PARTICLE_TYPE,class MYSELF>
+		template <class PARTICLE_TYPE,class MYSELF,mrpt::bayes::TParticleStorageMode STORAGE>
 		template <class BINTYPE>
-		bool PF_implementation<PARTICLE_TYPE,MYSELF>::PF_SLAM_implementation_gatherActionsCheckBothActObs(
+		bool PF_implementation<PARTICLE_TYPE,MYSELF,STORAGE>::PF_SLAM_implementation_gatherActionsCheckBothActObs(
 			const mrpt::obs::CActionCollection	* actions,
 			const mrpt::obs::CSensoryFrame		* sf )
 		{
@@ -123,9 +124,9 @@ namespace mrpt
 		  *     Robot Localization," in Proc. IEEE International Conference on Robotics
 		  *     and Automation (ICRA'08), 2008, pp. 461466.
 		  */
-		template <class PARTICLE_TYPE,class MYSELF>
+		template <class PARTICLE_TYPE,class MYSELF,mrpt::bayes::TParticleStorageMode STORAGE>
 		template <class BINTYPE>
-		void PF_implementation<PARTICLE_TYPE,MYSELF>::PF_SLAM_implementation_pfAuxiliaryPFOptimal(
+		void PF_implementation<PARTICLE_TYPE,MYSELF,STORAGE>::PF_SLAM_implementation_pfAuxiliaryPFOptimal(
 			const mrpt::obs::CActionCollection	* actions,
 			const mrpt::obs::CSensoryFrame		* sf,
 			const mrpt::bayes::CParticleFilter::TParticleFilterOptions &PF_options,
@@ -141,16 +142,16 @@ namespace mrpt
 		  *
 		  * - BINTYPE: TPoseBin or whatever to discretize the sample space for KLD-sampling.
 		  */
-		template <class PARTICLE_TYPE,class MYSELF>
+		template <class PARTICLE_TYPE,class MYSELF,mrpt::bayes::TParticleStorageMode STORAGE>
 		template <class BINTYPE>
-		void PF_implementation<PARTICLE_TYPE,MYSELF>::PF_SLAM_implementation_pfStandardProposal(
+		void PF_implementation<PARTICLE_TYPE,MYSELF,STORAGE>::PF_SLAM_implementation_pfStandardProposal(
 			const mrpt::obs::CActionCollection	* actions,
 			const mrpt::obs::CSensoryFrame		* sf,
 			const mrpt::bayes::CParticleFilter::TParticleFilterOptions &PF_options,
 			const TKLDParams &KLD_options)
 		{
 			MRPT_START
-			typedef std::set<BINTYPE,typename BINTYPE::lt_operator> 	TSetStateSpaceBins;
+			typedef mrpt::slam::detail::TKLDBinsHashSet<BINTYPE> 	TSetStateSpaceBins;
 
 			MYSELF *me = static_cast<MYSELF*>(this);
 
@@ -199,7 +200,7 @@ namespace mrpt
 						CPose3D finalPose = CPose3D(*getLastPose(i)) + incrPose;
 
 						// Update the particle with the new pose: this part is caller-dependant and must be implemented there:
-						PF_SLAM_implementation_custom_update_particle_with_new_pose( me->m_particles[i].d, TPose3D(finalPose) );
+						PF_SLAM_implementation_custom_update_particle_with_new_pose( me->m_particles[i].dataPtr(), TPose3D(finalPose) );
 					}
 				}
 				else
@@ -245,14 +246,13 @@ namespace mrpt
 						// Now, look if the particle falls in a new bin or not:
 						// --------------------------------------------------------
 						BINTYPE	p;
-						KLF_loadBinFromParticle<PARTICLE_TYPE,BINTYPE>(p,KLD_options, me->m_particles[drawn_idx].d, &newPose_s);
+						KLF_loadBinFromParticle<PARTICLE_TYPE,BINTYPE>(p,KLD_options, me->m_particles[drawn_idx].dataPtr(), &newPose_s);
 
-						if (stateSpaceBins.find( p )==stateSpaceBins.end())
+						bool is_new_bin;
+						stateSpaceBins.insert( p, is_new_bin );
+						if (is_new_bin)
 						{
 							// It falls into a new bin:
-							// Add to the stateSpaceBins:
-							stateSpaceBins.insert( p );
-
 							// K = K + 1
 							size_t	K = stateSpaceBins.size();
 							if ( K>1) //&& newParticles.size() > options.KLD_minSampleSize )
@@ -308,9 +308,9 @@ namespace mrpt
 		  *    Journal of the American Statistical Association 94 (446): 590-591. doi:10.2307/2670179.
 		  *
 		  */
-		template <class PARTICLE_TYPE,class MYSELF>
+		template <class PARTICLE_TYPE,class MYSELF,mrpt::bayes::TParticleStorageMode STORAGE>
 		template <class BINTYPE>
-		void PF_implementation<PARTICLE_TYPE,MYSELF>::PF_SLAM_implementation_pfAuxiliaryPFStandard(
+		void PF_implementation<PARTICLE_TYPE,MYSELF,STORAGE>::PF_SLAM_implementation_pfAuxiliaryPFStandard(
 			const mrpt::obs::CActionCollection	* actions,
 			const mrpt::obs::CSensoryFrame		* sf,
 			const mrpt::bayes::CParticleFilter::TParticleFilterOptions &PF_options,
@@ -323,9 +323,9 @@ namespace mrpt
 		/*---------------------------------------------------------------
 					PF_SLAM_particlesEvaluator_AuxPFOptimal
 		 ---------------------------------------------------------------*/
-		template <class PARTICLE_TYPE,class MYSELF>
+		template <class PARTICLE_TYPE,class MYSELF,mrpt::bayes::TParticleStorageMode STORAGE>
 		template <class BINTYPE>
-		double  PF_implementation<PARTICLE_TYPE,MYSELF>::PF_SLAM_particlesEvaluator_AuxPFOptimal(
+		double  PF_implementation<PARTICLE_TYPE,MYSELF,STORAGE>::PF_SLAM_particlesEvaluator_AuxPFOptimal(
 			const mrpt::bayes::CParticleFilter::TParticleFilterOptions &PF_options,
 			const mrpt::bayes::CParticleFilterCapable	*obj,
 			size_t					index,
@@ -397,9 +397,9 @@ namespace mrpt
 		  * \param action MUST be a "const CPose3D*"
 		  * \param observation MUST be a "const CSensoryFrame*"
 		  */
-		template <class PARTICLE_TYPE,class MYSELF>
+		template <class PARTICLE_TYPE,class MYSELF,mrpt::bayes::TParticleStorageMode STORAGE>
 		template <class BINTYPE>
-		double  PF_implementation<PARTICLE_TYPE,MYSELF>::PF_SLAM_particlesEvaluator_AuxPFStandard(
+		double  PF_implementation<PARTICLE_TYPE,MYSELF,STORAGE>::PF_SLAM_particlesEvaluator_AuxPFStandard(
 			const mrpt::bayes::CParticleFilter::TParticleFilterOptions &PF_options,
 			const mrpt::bayes::CParticleFilterCapable	*obj,
 			size_t					index,
@@ -488,9 +488,9 @@ namespace mrpt
 		// USE_OPTIMAL_SAMPLING:
 		//   true -> PF_SLAM_implementation_pfAuxiliaryPFOptimal
 		//  false -> PF_SLAM_implementation_pfAuxiliaryPFStandard
-		template <class PARTICLE_TYPE,class MYSELF>
+		template <class PARTICLE_TYPE,class MYSELF,mrpt::bayes::TParticleStorageMode STORAGE>
 		template <class BINTYPE>
-		void PF_implementation<PARTICLE_TYPE,MYSELF>::PF_SLAM_implementation_pfAuxiliaryPFStandardAndOptimal(
+		void PF_implementation<PARTICLE_TYPE,MYSELF,STORAGE>::PF_SLAM_implementation_pfAuxiliaryPFStandardAndOptimal(
 			const mrpt::obs::CActionCollection	* actions,
 			const mrpt::obs::CSensoryFrame		* sf,
 			const mrpt::bayes::CParticleFilter::TParticleFilterOptions &PF_options,
@@ -498,7 +498,7 @@ namespace mrpt
 			const bool USE_OPTIMAL_SAMPLING  )
 		{
 			MRPT_START
-			typedef std::set<BINTYPE,typename BINTYPE::lt_operator> 	TSetStateSpaceBins;
+			typedef mrpt::slam::detail::TKLDBinsHashSet<BINTYPE> 	TSetStateSpaceBins;
 
 			MYSELF *me = static_cast<MYSELF*>(this);
 
@@ -533,7 +533,7 @@ namespace mrpt
 			m_movementDrawer.getSamplingMean3D(meanRobotMovement);
 
 			// Prepare data for executing "fastDrawSample"
-			typedef PF_implementation<PARTICLE_TYPE,MYSELF> TMyClass; // Use this longer declaration to avoid errors in old GCC.
+			typedef PF_implementation<PARTICLE_TYPE,MYSELF,STORAGE> TMyClass; // Use this longer declaration to avoid errors in old GCC.
 			CParticleFilterCapable::TParticleProbabilityEvaluator funcOpt = &TMyClass::template PF_SLAM_particlesEvaluator_AuxPFOptimal<BINTYPE>;
 			CParticleFilterCapable::TParticleProbabilityEvaluator funcStd = &TMyClass::template PF_SLAM_particlesEvaluator_AuxPFStandard<BINTYPE>;
 
@@ -651,18 +651,17 @@ namespace mrpt
 				{
 					// Load the bin from the path data:
 					BINTYPE	p;
-					KLF_loadBinFromParticle<PARTICLE_TYPE,BINTYPE>(p, KLD_options,partIt->d );
+					KLF_loadBinFromParticle<PARTICLE_TYPE,BINTYPE>(p, KLD_options,partIt->dataPtr() );
 
 					// Is it a new bin?
-					typename TSetStateSpaceBins::iterator posFound=stateSpaceBinsLastTimestep.find(p);
-					if ( posFound == stateSpaceBinsLastTimestep.end() )
+					bool is_new_bin;
+					const size_t idx = stateSpaceBinsLastTimestep.insert( p, is_new_bin );
+					if ( is_new_bin )
 					{	// Yes, create a new pair <bin,index_list> in the list:
-						stateSpaceBinsLastTimestep.insert( p );
 						stateSpaceBinsLastTimestepParticles.push_back( vector_uint(1,partIndex) );
 					}
 					else
 					{ // No, add the particle's index to the existing entry:
-						const size_t idx = std::distance(stateSpaceBinsLastTimestep.begin(),posFound);
 						stateSpaceBinsLastTimestepParticles[idx].push_back( partIndex );
 					}
 				}
@@ -774,7 +773,7 @@ namespace mrpt
 					// ----------------------------------------------------------------
 					BINTYPE	p;
 					const TPose3D  newPose_s = newPose;
-					KLF_loadBinFromParticle<PARTICLE_TYPE,BINTYPE>( p,KLD_options, me->m_particles[k].d, &newPose_s );
+					KLF_loadBinFromParticle<PARTICLE_TYPE,BINTYPE>( p,KLD_options, me->m_particles[k].dataPtr(), &newPose_s );
 
 					// -----------------------------------------------------------------------------
 					// Look for the bin "p" into "stateSpaceBins": If it is not yet into the set,
@@ -782,11 +781,11 @@ namespace mrpt
 					// -----------------------------------------------------------------------------
 
 					// Found?
-					if ( stateSpaceBins.find(p)==stateSpaceBins.end() )
+					bool is_new_bin;
+					stateSpaceBins.insert( p, is_new_bin );
+					if ( is_new_bin )
 					{
-						// It falls into a new bin: add to the stateSpaceBins:
-						stateSpaceBins.insert( p );
-
+						// It falls into a new bin (already added to the stateSpaceBins):
 						// K = K + 1
 						int K = stateSpaceBins.size();
 						if ( K>1 )
@@ -827,9 +826,9 @@ namespace mrpt
 		/* ------------------------------------------------------------------------
 							PF_SLAM_aux_perform_one_rejection_sampling_step
 		   ------------------------------------------------------------------------ */
-		template <class PARTICLE_TYPE,class MYSELF>
+		template <class PARTICLE_TYPE,class MYSELF,mrpt::bayes::TParticleStorageMode STORAGE>
 		template <class BINTYPE>
-		void PF_implementation<PARTICLE_TYPE,MYSELF>::PF_SLAM_aux_perform_one_rejection_sampling_step(
+		void PF_implementation<PARTICLE_TYPE,MYSELF,STORAGE>::PF_SLAM_aux_perform_one_rejection_sampling_step(
 			const bool		USE_OPTIMAL_SAMPLING,
 			const bool		doResample,
 			const double	maxMeanLik,
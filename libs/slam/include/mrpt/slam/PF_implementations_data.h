@@ -35,9 +35,10 @@ namespace mrpt
 
 
 		/** A set of common data shared by PF implementations for both SLAM and localization
+		  *  STORAGE must be the storage mode of the particles in the MYSELF class (see mrpt::bayes::TParticleStorageMode).
 		  *   \ingroup mrpt_slam_grp
 		  */
-		template <class PARTICLE_TYPE, class MYSELF>
+		template <class PARTICLE_TYPE, class MYSELF, mrpt::bayes::TParticleStorageMode STORAGE = mrpt::bayes::psPointer>
 		class PF_implementation :
 			public mrpt::utils::COutputLogger
 		{
@@ -156,16 +157,29 @@ namespace mrpt
 				const mrpt::math::TPose3D &newPose) const = 0;
 
 			/** This is the default algorithm to efficiently replace one old set of samples by another new set.
-			  *  The method uses pointers to make fast copies the first time each particle is duplicated, then
-			  *   makes real copies for the next ones.
+			  *  With particles in the heap (mrpt::bayes::psPointer), the method uses pointers to make fast copies
+			  *   the first time each particle is duplicated, then makes real copies for the next ones.
+			  *  With particles stored by value (mrpt::bayes::psValue), the new set is gathered from the old one.
 			  *
 			  *  Note that more efficient specializations might exist for specific particle data structs.
 			  */
 			virtual void PF_SLAM_implementation_replaceByNewParticleSet(
-				typename mrpt::bayes::CParticleFilterData<PARTICLE_TYPE>::CParticleList	 &old_particles,
+				typename mrpt::bayes::CParticleFilterData<PARTICLE_TYPE,STORAGE>::CParticleList	 &old_particles,
 				const std::vector<mrpt::math::TPose3D>		&newParticles,
 				const std::vector<double>		&newParticlesWeight,
 				const std::vector<size_t>		&newParticlesDerivedFromIdx ) const
+			{
+				PF_SLAM_implementation_replaceByNewParticleSet_default(old_particles,newParticles,newParticlesWeight,newParticlesDerivedFromIdx,
+					static_cast<mrpt::bayes::CProbabilityParticle<PARTICLE_TYPE,STORAGE>*>(NULL) );
+			}
+
+			/** PF_SLAM_implementation_replaceByNewParticleSet() for mrpt::bayes::psPointer */
+			void PF_SLAM_implementation_replaceByNewParticleSet_default(
+				typename mrpt::bayes::CParticleFilterData<PARTICLE_TYPE,STORAGE>::CParticleList	 &old_particles,
+				const std::vector<mrpt::math::TPose3D>		&newParticles,
+				const std::vector<double>		&newParticlesWeight,
+				const std::vector<size_t>		&newParticlesDerivedFromIdx,
+				mrpt::bayes::CProbabilityParticle<PARTICLE_TYPE,mrpt::bayes::psPointer> * ) const
 			{
 				// ---------------------------------------------------------------------------------
 				// Substitute old by new particle set:
@@ -222,12 +236,31 @@ namespace mrpt
 					trgPartIt->log_w = newPartIt->log_w;
 					trgPartIt->d = newPartIt->d;
 				}
+			}
+
+			/** PF_SLAM_implementation_replaceByNewParticleSet() for mrpt::bayes::psValue */
+			void PF_SLAM_implementation_replaceByNewParticleSet_default(
+				typename mrpt::bayes::CParticleFilterData<PARTICLE_TYPE,STORAGE>::CParticleList	 &old_particles,
+				const std::vector<mrpt::math::TPose3D>		&newParticles,
+				const std::vector<double>		&newParticlesWeight,
+				const std::vector<size_t>		&newParticlesDerivedFromIdx,
+				mrpt::bayes::CProbabilityParticle<PARTICLE_TYPE,mrpt::bayes::psValue> * ) const
+			{
+				const size_t N = newParticles.size();
+				typename MYSELF::CParticleList newParticlesArray(N);
+				for (size_t i=0;i<N;i++)
+				{
+					newParticlesArray[i].log_w = newParticlesWeight[i];
+					newParticlesArray[i].d = old_particles[ newParticlesDerivedFromIdx[i] ].d;
+					PF_SLAM_implementation_custom_update_particle_with_new_pose( &newParticlesArray[i].d, newParticles[i] );
+				}
+				old_particles.swap(newParticlesArray);
 			} // end of PF_SLAM_implementation_replaceByNewParticleSet
 
 
 
 			virtual bool PF_SLAM_implementation_doWeHaveValidObservations(
-				const typename mrpt::bayes::CParticleFilterData<PARTICLE_TYPE>::CParticleList	&particles,
+				const typename mrpt::bayes::CParticleFilterData<PARTICLE_TYPE,STORAGE>::CParticleList	&particles,
 				const mrpt::obs::CSensoryFrame *sf) const
 			{
 				MRPT_UNUSED_PARAM(particles); MRPT_UNUSED_PARAM(sf);
@@ -110,6 +110,11 @@ namespace mrpt
 		  * \param use_kd_tree [IN, optional] Build a KD-tree to speed-up the evaluation of individual compatibility (IC). It's perhaps more efficient to disable it for a small number of features. (default=true).
 		  * \param predictions_IDs [IN, optional] (default:none) An N-vector. If provided, the resulting associations in "results.associations" will not contain prediction indices "i", but "predictions_IDs[i]".
 		  *
+		  * \note The KD-tree is only used to discard those predictions which are too far away from an observation to pass the IC test, hence
+		  *  the IC matrix and the associations are the same with or without it. Entries of "results.indiv_distances" for the discarded pairings keep their default values.
+		  * \note If MRPT is built with TBB, the IC matrix is evaluated in parallel for the different observations, and the first level of branches of the JCBB
+		  *  interpretation tree are explored in parallel, sharing the bound of the best hypothesis found so far. The results are identical to the sequential version.
+		  *
 		  * \sa data_association_independent_predictions, data_association_independent_2d_points, data_association_independent_3d_points
 		  */
 		void SLAM_IMPEXP data_association_full_covariance(
@@ -0,0 +1,385 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include "slam-precomp.h"   // Precompiled headers
+
+#include <mrpt/slam/CCorrelativeScanMatcher2D.h>
+#include <mrpt/math/wrap2pi.h>
+#include <mrpt/system/parallelization.h>
+#include <mrpt/utils/CTicTac.h>
+#include <mrpt/utils/CConfigFileBase.h>
+#include <mrpt/utils/CStream.h>
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+using namespace mrpt::slam;
+using namespace mrpt::maps;
+using namespace mrpt::utils;
+using namespace mrpt::poses;
+using namespace mrpt::math;
+
+/*---------------------------------------------------------------
+							TOptions
+  ---------------------------------------------------------------*/
+CCorrelativeScanMatcher2D::TOptions::TOptions() :
+	resolution(0.05),
+	search_window_xy(0.30),
+	search_window_phi(DEG2RAD(20)),
+	search_step_phi(DEG2RAD(1)),
+	sigma(0.05),
+	lut_max_size(40),
+	scan_decimation(1),
+	submap_max_scans(10),
+	submap_insertion_lin_distance(0.10),
+	submap_insertion_ang_distance(DEG2RAD(5))
+{
+}
+
+void  CCorrelativeScanMatcher2D::TOptions::loadFromConfigFile(
+	const mrpt::utils::CConfigFileBase  &source,
+	const std::string &section)
+{
+	MRPT_LOAD_CONFIG_VAR(resolution, double, source,section)
+	MRPT_LOAD_CONFIG_VAR(search_window_xy, double, source,section)
+	MRPT_LOAD_CONFIG_VAR_DEGREES(search_window_phi, source,section)
+	MRPT_LOAD_CONFIG_VAR_DEGREES(search_step_phi, source,section)
+	MRPT_LOAD_CONFIG_VAR(sigma, double, source,section)
+	MRPT_LOAD_CONFIG_VAR(lut_max_size, double, source,section)
+	MRPT_LOAD_CONFIG_VAR(scan_decimation, int, source,section)
+	MRPT_LOAD_CONFIG_VAR(submap_max_scans, int, source,section)
+	MRPT_LOAD_CONFIG_VAR(submap_insertion_lin_distance, double, source,section)
+	MRPT_LOAD_CONFIG_VAR_DEGREES(submap_insertion_ang_distance, source,section)
+}
+
+void  CCorrelativeScanMatcher2D::TOptions::dumpToTextStream(mrpt::utils::CStream	&out) const
+{
+	out.printf("\n----------- [CCorrelativeScanMatcher2D::TOptions] ------------ \n\n");
+
+	out.printf("resolution                              = %f m\n", resolution);
+	out.printf("search_window_xy                        = %f m\n", search_window_xy);
+	out.printf("search_window_phi                       = %f deg\n", RAD2DEG(search_window_phi));
+	out.printf("search_step_phi                         = %f deg\n", RAD2DEG(search_step_phi));
+	out.printf("sigma                                   = %f m\n", sigma);
+	out.printf("lut_max_size                            = %f m\n", lut_max_size);
+	out.printf("scan_decimation                         = %u\n", scan_decimation);
+	out.printf("submap_max_scans                        = %u\n", submap_max_scans);
+	out.printf("submap_insertion_lin_distance           = %f m\n", submap_insertion_lin_distance);
+	out.printf("submap_insertion_ang_distance           = %f deg\n", RAD2DEG(submap_insertion_ang_distance));
+	out.printf("\n");
+}
+
+/*---------------------------------------------------------------
+							Constructor
+  ---------------------------------------------------------------*/
+CCorrelativeScanMatcher2D::CCorrelativeScanMatcher2D() :
+	m_lut_valid(false),
+	m_lut_x0(0), m_lut_y0(0),
+	m_lut_size_x(0), m_lut_size_y(0),
+	m_lut_resolution(0), m_lut_sigma(0), m_lut_window_xy(0),
+	m_submap_points_valid(false)
+{
+}
+
+void CCorrelativeScanMatcher2D::clear()
+{
+	m_scans.clear();
+	m_lut_valid = false;
+	m_submap_points_valid = false;
+}
+
+/*---------------------------------------------------------------
+							insertScan
+  ---------------------------------------------------------------*/
+bool CCorrelativeScanMatcher2D::insertScan(const CPointsMap &scan, const CPose2D &robotPose, const bool force)
+{
+	if (!force && !m_scans.empty())
+	{
+		const CPose2D Ap = robotPose - CPose2D(m_scans.back().pose);
+		if (Ap.norm()<options.submap_insertion_lin_distance && std::abs(Ap.phi())<options.submap_insertion_ang_distance)
+			return false;
+	}
+
+	m_scans.push_back(TSubmapScan());
+	TSubmapScan &s = m_scans.back();
+	s.pose = TPose2D(robotPose);
+
+	const std::vector<float> &xs = scan.getPointsBufferRef_x();
+	const std::vector<float> &ys = scan.getPointsBufferRef_y();
+	const size_t N = xs.size();
+	const double ccos = cos(robotPose.phi()), csin = sin(robotPose.phi());
+	s.xs.resize(N);
+	s.ys.resize(N);
+	for (size_t i=0;i<N;i++)
+	{
+		s.xs[i] = static_cast<float>(robotPose.x() + ccos*xs[i] - csin*ys[i]);
+		s.ys[i] = static_cast<float>(robotPose.y() + csin*xs[i] + ccos*ys[i]);
+	}
+
+	while (m_scans.size()>std::max(1u,options.submap_max_scans))
+		m_scans.pop_front();
+
+	m_lut_valid = false;
+	m_submap_points_valid = false;
+	return true;
+}
+
+/*---------------------------------------------------------------
+							getSubmapPoints
+  ---------------------------------------------------------------*/
+const CSimplePointsMap & CCorrelativeScanMatcher2D::getSubmapPoints() const
+{
+	if (!m_submap_points_valid)
+	{
+		size_t N = 0;
+		for (std::deque<TSubmapScan>::const_iterator it=m_scans.begin();it!=m_scans.end();++it)
+			N+=it->xs.size();
+
+		m_submap_points.clear();
+		m_submap_points.reserve(N);
+		for (std::deque<TSubmapScan>::const_iterator it=m_scans.begin();it!=m_scans.end();++it)
+			for (size_t i=0;i<it->xs.size();i++)
+				m_submap_points.insertPointFast(it->xs[i],it->ys[i],0);
+		m_submap_points.mark_as_modified();
+
+		m_submap_points_valid = true;
+	}
+	return m_submap_points;
+}
+
+/*---------------------------------------------------------------
+							updateLookupTable
+  ---------------------------------------------------------------*/
+void CCorrelativeScanMatcher2D::updateLookupTable() const
+{
+	if (m_lut_valid &&
+		m_lut_resolution==options.resolution &&
+		m_lut_sigma==options.sigma &&
+		m_lut_window_xy==options.search_window_xy)
+		return;
+
+	ASSERT_(!m_scans.empty())
+	ASSERT_(options.resolution>0 && options.sigma>0 && options.lut_max_size>0)
+
+	const double res = options.resolution;
+
+	// Precomputed score kernel, up to 3 sigmas:
+	const int R = static_cast<int>(ceil(3*options.sigma/res));
+	std::vector<uint8_t> kernel((2*R+1)*(2*R+1));
+	for (int dy=-R;dy<=R;dy++)
+		for (int dx=-R;dx<=R;dx++)
+			kernel[(dy+R)*(2*R+1)+dx+R] = static_cast<uint8_t>( round(255*exp(-0.5*square(res)*(dx*dx+dy*dy)/square(options.sigma))) );
+
+	// Area of the table: the bounding box of the submap, up to lut_max_size around its last scan:
+	const TPose2D &center = m_scans.back().pose;
+	const double half_size = 0.5*options.lut_max_size;
+	double x_min = std::numeric_limits<double>::max(), x_max = -x_min;
+	double y_min = x_min, y_max = -x_min;
+	for (std::deque<TSubmapScan>::const_iterator it=m_scans.begin();it!=m_scans.end();++it)
+	{
+		for (size_t i=0;i<it->xs.size();i++)
+		{
+			const double x = it->xs[i], y = it->ys[i];
+			if (std::abs(x-center.x)>half_size || std::abs(y-center.y)>half_size) continue;
+			mrpt::utils::keep_min(x_min,x); mrpt::utils::keep_max(x_max,x);
+			mrpt::utils::keep_min(y_min,y); mrpt::utils::keep_max(y_max,y);
+		}
+	}
+	if (x_min>x_max)
+	{	// No points: a 1x1 empty table
+		x_min = x_max = center.x;
+		y_min = y_max = center.y;
+	}
+
+	// Leave room for the kernel and the search window around the points:
+	const int margin = R + static_cast<int>(ceil(options.search_window_xy/res)) + 1;
+	m_lut_x0 = x_min - margin*res;
+	m_lut_y0 = y_min - margin*res;
+	m_lut_size_x = static_cast<int>(round((x_max-x_min)/res)) + 2*margin + 1;
+	m_lut_size_y = static_cast<int>(round((y_max-y_min)/res)) + 2*margin + 1;
+	m_lut.assign(size_t(m_lut_size_x)*m_lut_size_y, 0);
+
+	for (std::deque<TSubmapScan>::const_iterator it=m_scans.begin();it!=m_scans.end();++it)
+	{
+		for (size_t i=0;i<it->xs.size();i++)
+		{
+			const double x = it->xs[i], y = it->ys[i];
+			if (std::abs(x-center.x)>half_size || std::abs(y-center.y)>half_size) continue;
+			const int cx = static_cast<int>(round((x-m_lut_x0)/res));
+			const int cy = static_cast<int>(round((y-m_lut_y0)/res));
+			for (int dy=-R;dy<=R;dy++)
+			{
+				uint8_t *row = &m_lut[size_t(cy+dy)*m_lut_size_x + cx];
+				const uint8_t *krow = &kernel[(dy+R)*(2*R+1)+R];
+				for (int dx=-R;dx<=R;dx++)
+					mrpt::utils::keep_max(row[dx],krow[dx]);
+			}
+		}
+	}
+
+	m_lut_resolution = options.resolution;
+	m_lut_sigma = options.sigma;
+	m_lut_window_xy = options.search_window_xy;
+	m_lut_valid = true;
+}
+
+namespace
+{
+	/** The best translation of the exhaustive search for one heading */
+	struct TBestOffset
+	{
+		TBestOffset() : score(0), dx(0), dy(0) { }
+		uint64_t score; //!< Sum of the scores of all the points
+		int dx,dy;      //!< Offset, in cells
+	};
+
+	/** Evaluates all the translations of the search window, for each heading of a range */
+	struct TCorrelativeSearch
+	{
+		const std::vector<uint8_t> &lut;
+		const int                   size_x, size_y;
+		const double                x0,y0,res;
+		const std::vector<float>   &lx,&ly;   //!< Scan points, in local coordinates
+		const TPose2D              &initial;
+		const int                   nW, nPhi;
+		const double                step_phi;
+		std::vector<TBestOffset>   &best;     //!< For each heading
+
+		TCorrelativeSearch(
+			const std::vector<uint8_t> &_lut, const int _size_x, const int _size_y, const double _x0, const double _y0, const double _res,
+			const std::vector<float> &_lx, const std::vector<float> &_ly, const TPose2D &_initial, const int _nW, const int _nPhi, const double _step_phi,
+			std::vector<TBestOffset> &_best) :
+			lut(_lut), size_x(_size_x), size_y(_size_y), x0(_x0), y0(_y0), res(_res),
+			lx(_lx), ly(_ly), initial(_initial), nW(_nW), nPhi(_nPhi), step_phi(_step_phi),
+			best(_best)
+		{ }
+
+		void operator()(const mrpt::system::BlockedRange &r) const
+		{
+			std::vector<int> cells; // Base cell index of each rotated point
+			cells.reserve(lx.size());
+
+			for (int k=r.begin();k!=r.end();++k)
+			{
+				// The scan rotated to this heading, discretized once for all the translations:
+				const double phi = initial.phi + (k-nPhi)*step_phi;
+				const double ccos = cos(phi), csin = sin(phi);
+				cells.clear();
+				for (size_t i=0;i<lx.size();i++)
+				{
+					const int cx = static_cast<int>(round((initial.x + ccos*lx[i] - csin*ly[i] - x0)/res));
+					const int cy = static_cast<int>(round((initial.y + csin*lx[i] + ccos*ly[i] - y0)/res));
+					// Points out of the table for any translation only add zeros:
+					if (cx-nW<0 || cx+nW>=size_x || cy-nW<0 || cy+nW>=size_y) continue;
+					cells.push_back(cy*size_x+cx);
+				}
+
+				TBestOffset &b = best[k];
+				int best_d2 = std::numeric_limits<int>::max();
+				const size_t nCells = cells.size();
+				const uint8_t *lut_ptr = &lut[0];
+				for (int dy=-nW;dy<=nW;dy++)
+				{
+					for (int dx=-nW;dx<=nW;dx++)
+					{
+						const uint8_t *p = lut_ptr + dy*size_x + dx;
+						uint64_t score = 0;
+						for (size_t i=0;i<nCells;i++)
+							score+=p[cells[i]];
+
+						// Ties: keep the offset closest to the initial estimation
+						const int d2 = dx*dx+dy*dy;
+						if (score>b.score || (score==b.score && d2<best_d2))
+						{
+							b.score = score;
+							b.dx = dx;
+							b.dy = dy;
+							best_d2 = d2;
+						}
+					}
+				}
+			}
+		}
+	};
+}
+
+/*---------------------------------------------------------------
+							match
+  ---------------------------------------------------------------*/
+CPosePDFPtr CCorrelativeScanMatcher2D::match(
+	const CPointsMap            &scan,
+	const CPose2D               &initialEstimation,
+	const CICP::TConfigParams   &icp_params,
+	TReturnInfo                 *info ) const
+{
+	MRPT_START
+
+	ASSERTMSG_(!m_scans.empty(), "The submap is empty: insert some scan first")
+	ASSERT_(options.search_step_phi>0)
+
+	CTicTac	tictac;
+	tictac.Tic();
+
+	updateLookupTable();
+
+	// Decimated scan:
+	std::vector<float> lx,ly;
+	{
+		const std::vector<float> &xs = scan.getPointsBufferRef_x();
+		const std::vector<float> &ys = scan.getPointsBufferRef_y();
+		const size_t decim = std::max(1u,options.scan_decimation);
+		lx.reserve(xs.size()/decim+1);
+		ly.reserve(xs.size()/decim+1);
+		for (size_t i=0;i<xs.size();i+=decim)
+		{
+			lx.push_back(xs[i]);
+			ly.push_back(ys[i]);
+		}
+	}
+
+	// Exhaustive search, in parallel for the different headings:
+	const int nW = static_cast<int>(round(options.search_window_xy/options.resolution));
+	const int nPhi = static_cast<int>(round(options.search_window_phi/options.search_step_phi));
+	const TPose2D initial(initialEstimation);
+
+	std::vector<TBestOffset> best(2*nPhi+1);
+	mrpt::system::parallel_for(
+		mrpt::system::BlockedRange(0,2*nPhi+1),
+		TCorrelativeSearch(m_lut,m_lut_size_x,m_lut_size_y,m_lut_x0,m_lut_y0,options.resolution, lx,ly, initial, nW,nPhi,options.search_step_phi, best) );
+
+	// Best heading (ties: the closest one to the initial estimation):
+	int best_k = nPhi;
+	for (int k=0;k<2*nPhi+1;k++)
+	{
+		if (best[k].score>best[best_k].score ||
+			(best[k].score==best[best_k].score && std::abs(k-nPhi)<std::abs(best_k-nPhi)))
+			best_k = k;
+	}
+
+	const TPose2D corr_pose(
+		initial.x + best[best_k].dx*options.resolution,
+		initial.y + best[best_k].dy*options.resolution,
+		mrpt::math::wrapToPi(initial.phi + (best_k-nPhi)*options.search_step_phi) );
+
+	// ICP refinement against the points of the submap:
+	CICP  icp(icp_params);
+	CICP::TReturnInfo  icp_info;
+	CPosePDFPtr pdf = icp.Align(&getSubmapPoints(), &scan, CPose2D(corr_pose), NULL, &icp_info);
+
+	if (info)
+	{
+		info->correlative_pose = corr_pose;
+		info->score = lx.empty() ? 0 : best[best_k].score/(255.0*lx.size());
+		info->icp = icp_info;
+		info->runningTime = tictac.Tac();
+	}
+	return pdf;
+
+	MRPT_END
+}
@@ -0,0 +1,101 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/slam/CCorrelativeScanMatcher2D.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/poses/CPosePDF.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::slam;
+using namespace mrpt::maps;
+using namespace mrpt::utils;
+using namespace mrpt::poses;
+using namespace mrpt::math;
+using namespace std;
+
+// An irregular room, with a column, sampled every 2cm:
+static void generateRoom(CSimplePointsMap &room)
+{
+	const double corners[][2] = { {-4,-3}, {5,-3}, {5,1}, {3,1}, {3,4}, {-4,4} };
+	const size_t nCorners = sizeof(corners)/sizeof(corners[0]);
+	for (size_t i=0;i<nCorners;i++)
+	{
+		const double *a = corners[i], *b = corners[(i+1)%nCorners];
+		const double L = std::sqrt(square(b[0]-a[0])+square(b[1]-a[1]));
+		for (double d=0;d<L;d+=0.02)
+			room.insertPoint(a[0]+(b[0]-a[0])*d/L, a[1]+(b[1]-a[1])*d/L);
+	}
+	for (double ang=0;ang<2*M_PI;ang+=0.05)
+		room.insertPoint(-1.5+0.3*cos(ang), 1+0.3*sin(ang));
+}
+
+// The points of the room, in local coordinates of a robot at "pose":
+static void observeRoom(const CSimplePointsMap &room, const CPose2D &pose, CSimplePointsMap &scan)
+{
+	scan.clear();
+	const double ccos = cos(pose.phi()), csin = sin(pose.phi());
+	for (size_t i=0;i<room.size();i++)
+	{
+		float x,y;
+		room.getPoint(i,x,y);
+		const double dx = x-pose.x(), dy = y-pose.y();
+		scan.insertPoint(ccos*dx + csin*dy, -csin*dx + ccos*dy);
+	}
+}
+
+TEST(CCorrelativeScanMatcher2D, AlignWithLargeInitialError)
+{
+	CSimplePointsMap room;
+	generateRoom(room);
+
+	CCorrelativeScanMatcher2D matcher;
+	CICP::TConfigParams icp_params;
+	icp_params.maxIterations = 50;
+	icp_params.thresholdDist = 0.1f;
+	icp_params.smallestThresholdDist = 0.02f;
+	icp_params.corresponding_points_decimation = 1;
+
+	// First scan:
+	const CPose2D pose1(0,0,0);
+	CSimplePointsMap scan;
+	observeRoom(room,pose1,scan);
+	EXPECT_TRUE(matcher.insertScan(scan,pose1));
+	EXPECT_EQ(matcher.getSubmapScansCount(),1u);
+
+	// Second scan, with a wrong initial estimation (too large for ICP alone):
+	const CPose2D pose2(0.5,0.3,DEG2RAD(12.0));
+	observeRoom(room,pose2,scan);
+	const CPose2D initialEstimation(0.3,0.5,DEG2RAD(-3.0));
+
+	CCorrelativeScanMatcher2D::TReturnInfo info;
+	CPosePDFPtr pdf = matcher.match(scan,initialEstimation,icp_params,&info);
+	ASSERT_TRUE(pdf.present());
+	const CPose2D est = pdf->getMeanVal();
+
+	EXPECT_NEAR(info.correlative_pose.x,pose2.x(), 0.05);
+	EXPECT_NEAR(info.correlative_pose.y,pose2.y(), 0.05);
+	EXPECT_NEAR(info.correlative_pose.phi,pose2.phi(), DEG2RAD(1.0));
+	EXPECT_GT(info.score,0.5);
+
+	EXPECT_NEAR(est.x(),pose2.x(), 0.01);
+	EXPECT_NEAR(est.y(),pose2.y(), 0.01);
+	EXPECT_NEAR(est.phi(),pose2.phi(), DEG2RAD(0.5));
+
+	// Submap insertion thresholds:
+	EXPECT_FALSE(matcher.insertScan(scan,CPose2D(0.01,0,0)));
+	EXPECT_TRUE(matcher.insertScan(scan,CPose2D(0.01,0,0),true));
+	EXPECT_TRUE(matcher.insertScan(scan,est));
+	EXPECT_EQ(matcher.getSubmapScansCount(),3u);
+
+	matcher.options.submap_max_scans = 1;
+	EXPECT_TRUE(matcher.insertScan(scan,CPose2D(1,0,0)));
+	EXPECT_EQ(matcher.getSubmapScansCount(),1u);
+	EXPECT_EQ(matcher.getSubmapPoints().size(),scan.size());
+}
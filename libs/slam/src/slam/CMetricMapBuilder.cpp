@@ -61,10 +61,9 @@ void  CMetricMapBuilder::loadCurrentMapFromFile(const std::string &fileName)
 	if ( mrpt::system::fileExists( fileName ) )
 	{
 		MRPT_LOG_INFO_STREAM << "[CMetricMapBuilder::loadCurrentMapFromFile] Loading current map from '" << fileName << "' ..." << std::endl;
-		CFileGZInputStream		f( fileName);
-
-		// Load from file:
-		f >> map;
+		// Load from file (memory-mapped, if it's not gz-compressed):
+		if (!map.loadFromFile(fileName))
+			THROW_EXCEPTION_CUSTOM_MSG1("Error loading map from file: '%s'",fileName.c_str());
 	}
 	else
 	{	// Is a new file, start with an empty map:
@@ -55,6 +55,8 @@ CMetricMapBuilderICP::~CMetricMapBuilderICP()
   ---------------------------------------------------------------*/
 CMetricMapBuilderICP::TConfigParams::TConfigParams(mrpt::utils::VerbosityLevel &parent_verbosity_level) :
 	matchAgainstTheGrid( false ),
+	useCorrelativeScanMatcher( false ),
+	correlativeMatcherOptions(),
 	insertionLinDistance(1.0),
 	insertionAngDistance(DEG2RAD(30)),
 	localizationLinDistance(0.20),
@@ -67,6 +69,8 @@ CMetricMapBuilderICP::TConfigParams::TConfigParams(mrpt::utils::VerbosityLevel &
 
 CMetricMapBuilderICP::TConfigParams &CMetricMapBuilderICP::TConfigParams::operator=(const CMetricMapBuilderICP::TConfigParams &other){
 	matchAgainstTheGrid     = other.matchAgainstTheGrid;
+	useCorrelativeScanMatcher = other.useCorrelativeScanMatcher;
+	correlativeMatcherOptions = other.correlativeMatcherOptions;
 	insertionLinDistance    = other.insertionLinDistance;
 	insertionAngDistance    = other.insertionAngDistance;
 	localizationLinDistance = other.localizationLinDistance;
@@ -91,6 +95,8 @@ void  CMetricMapBuilderICP::TConfigParams::loadFromConfigFile(
 
 	MRPT_LOAD_CONFIG_VAR(minICPgoodnessToAccept, double	,source,section)
 
+	MRPT_LOAD_CONFIG_VAR(useCorrelativeScanMatcher, bool	,source,section)
+	correlativeMatcherOptions.loadFromConfigFile(source,section+string("_correlativeMatcher"));
 
 	mapInitializers.loadFromConfigFile(source,section);
 }
@@ -104,6 +110,9 @@ void  CMetricMapBuilderICP::TConfigParams::dumpToTextStream( CStream	&out) const
 	out.printf("localizationLinDistance                 = %f m\n", localizationLinDistance );
 	out.printf("localizationAngDistance                 = %f deg\n", RAD2DEG(localizationAngDistance) );
 	out.printf("verbosity_level                         = %s\n", mrpt::utils::TEnumType<mrpt::utils::VerbosityLevel>::value2name(verbosity_level).c_str());
+	out.printf("useCorrelativeScanMatcher               = %s\n", useCorrelativeScanMatcher ? "YES":"NO");
+	if (useCorrelativeScanMatcher)
+		correlativeMatcherOptions.dumpToTextStream(out);
 
 	out.printf("  Now showing 'mapsInitializers':\n");
 	mapInitializers.dumpToTextStream(out);
@@ -193,6 +202,10 @@ void  CMetricMapBuilderICP::processObservation(const CObservationPtr &obs)
 		CICP::TReturnInfo	icpReturn;
 		bool				can_do_icp=false;
 
+		const bool use_correlative = ICP_options.useCorrelativeScanMatcher;
+		if (use_correlative)
+			m_correlativeMatcher.options = ICP_options.correlativeMatcherOptions;
+
 		// Select the map to match with ....
 		CMetricMap   *matchWith = NULL;
 		if (ICP_options.matchAgainstTheGrid && !metricMap.m_gridMaps.empty() )
@@ -241,7 +254,14 @@ void  CMetricMapBuilderICP::processObservation(const CObservationPtr &obs)
 				can_do_icp = sensedPoints.insertObservationPtr(obs);
 			}
 
-			if (IS_DERIVED(matchWith,CPointsMap) && static_cast<CPointsMap*>(matchWith)->empty())
+			const bool sensed_any_point = can_do_icp;
+
+			if (use_correlative)
+			{
+				if (m_correlativeMatcher.isSubmapEmpty())
+					can_do_icp = false;	// No previous scans yet!
+			}
+			else if (IS_DERIVED(matchWith,CPointsMap) && static_cast<CPointsMap*>(matchWith)->empty())
 				can_do_icp = false;	// The reference map is empty!
 
 			if (can_do_icp)
@@ -249,18 +269,36 @@ void  CMetricMapBuilderICP::processObservation(const CObservationPtr &obs)
 				// We DO HAVE points with this observation:
 				// Execute ICP over the current points map and the sensed points:
 				// ----------------------------------------------------------------------
-				CICP	ICP;
+				CPosePDFPtr pestPose;
 				float	runningTime;
 
-				ICP.options = ICP_params;
-
-				CPosePDFPtr pestPose= ICP.Align(
-					matchWith,					// Map 1
-					&sensedPoints,				// Map 2
-					initialEstimatedRobotPose,	// a first gross estimation of map 2 relative to map 1.
-					&runningTime,				// Running time
-					&icpReturn					// Returned information
-					);
+				if (use_correlative)
+				{
+					// Exhaustive search + ICP against the last scans:
+					CCorrelativeScanMatcher2D::TReturnInfo corrReturn;
+					pestPose = m_correlativeMatcher.match(
+						sensedPoints,
+						initialEstimatedRobotPose,
+						ICP_params,
+						&corrReturn);
+					icpReturn = corrReturn.icp;
+					runningTime = static_cast<float>(corrReturn.runningTime);
+
+					MRPT_LOG_DEBUG_STREAM << "processObservation(): correlative matcher score=" << corrReturn.score << " pose=" << CPose2D(corrReturn.correlative_pose);
+				}
+				else
+				{
+					CICP	ICP;
+					ICP.options = ICP_params;
+
+					pestPose= ICP.Align(
+						matchWith,					// Map 1
+						&sensedPoints,				// Map 2
+						initialEstimatedRobotPose,	// a first gross estimation of map 2 relative to map 1.
+						&runningTime,				// Running time
+						&icpReturn					// Returned information
+						);
+				}
 
 				if (icpReturn.goodness> ICP_options.minICPgoodnessToAccept)
 				{
@@ -298,6 +336,15 @@ void  CMetricMapBuilderICP::processObservation(const CObservationPtr &obs)
 				MRPT_LOG_WARN_STREAM << "Cannot do ICP: empty pointmap or not suitable gridmap...\n";
 			}
 
+			// Update the submap of the correlative matcher with good matches (or the first scan):
+			if (use_correlative && sensed_any_point &&
+				(!can_do_icp || icpReturn.goodness>ICP_options.minICPgoodnessToAccept))
+			{
+				CPose2D  currentKnownRobotPose;
+				m_lastPoseEst.getLatestRobotPose(currentKnownRobotPose);
+				m_correlativeMatcher.insertScan(sensedPoints, currentKnownRobotPose);
+			}
+
 		} // else, we do ICP pose correction
 
 
@@ -450,6 +497,8 @@ void  CMetricMapBuilderICP::initialize(
 
 	m_there_has_been_an_odometry = false;
 
+	m_correlativeMatcher.clear();
+
 	// Init path & map:
 	mrpt::synch::CCriticalSectionLocker lock_cs( &critZoneChangingMap );
 
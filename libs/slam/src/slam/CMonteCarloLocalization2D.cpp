@@ -90,8 +90,7 @@ const TPose3D* CMonteCarloLocalization2D::getLastPose(const size_t i) const
 {
 	if (i>=m_particles.size()) THROW_EXCEPTION("Particle index out of bounds!");
 	static TPose3D auxHolder;
-	ASSERTDEB_(m_particles[i].d!=NULL)
-	auxHolder = TPose3D( TPose2D(*m_particles[i].d));
+	auxHolder = TPose3D( TPose2D(m_particles[i].d));
 	return &auxHolder;
 }
 
@@ -217,17 +216,13 @@ void CMonteCarloLocalization2D::PF_SLAM_implementation_replaceByNewParticleSet(
 	//   Old are in "m_particles"
 	//   New are in "newParticles", "newParticlesWeight","newParticlesDerivedFromIdx"
 	// ---------------------------------------------------------------------------------
-	// Free old m_particles:
-	for (size_t i=0;i<old_particles.size();i++)
-			mrpt::utils::delete_safe( old_particles[ i ].d );
-
-	// Copy into "m_particles"
+	// Copy into "m_particles" (reusing its memory):
 	const size_t N = newParticles.size();
 	old_particles.resize(N);
 	for (size_t i=0;i<N;i++)
 	{
 		old_particles[i].log_w = newParticlesWeight[i];
-		old_particles[i].d = new CPose2D( TPose2D( newParticles[i] ));
+		old_particles[i].d = CPose2D( TPose2D( newParticles[i] ));
 	}
 }
 
@@ -289,8 +284,6 @@ void  CMonteCarloLocalization2D::resetUniformFreeSpace(
 	{
 		clear();
 		m_particles.resize(particlesCount);
-		for (int i=0;i<particlesCount;i++)
-			m_particles[i].d = new CPose2D();
 	}
 
 	const size_t M = m_particles.size();
@@ -300,9 +293,9 @@ void  CMonteCarloLocalization2D::resetUniformFreeSpace(
 	{
 		int idx = round(randomGenerator.drawUniform(0.0,nFreeCells-1.001));
 
-		m_particles[i].d->x( freeCells_x[idx] + randomGenerator.drawUniform( -gridRes, gridRes ) );
-		m_particles[i].d->y( freeCells_y[idx] + randomGenerator.drawUniform( -gridRes, gridRes ) );
-		m_particles[i].d->phi( randomGenerator.drawUniform( phi_min, phi_max ) );
+		m_particles[i].d.x( freeCells_x[idx] + randomGenerator.drawUniform( -gridRes, gridRes ) );
+		m_particles[i].d.y( freeCells_y[idx] + randomGenerator.drawUniform( -gridRes, gridRes ) );
+		m_particles[i].d.phi( randomGenerator.drawUniform( phi_min, phi_max ) );
 		m_particles[i].log_w=0;
 	}
 
@@ -94,8 +94,7 @@ const TPose3D* CMonteCarloLocalization3D::getLastPose(const size_t i) const
 {
 	if (i>=m_particles.size()) THROW_EXCEPTION("Particle index out of bounds!");
 	static TPose3D auxHolder;
-	ASSERTDEB_(m_particles[i].d!=NULL)
-	auxHolder = TPose3D(*m_particles[i].d);
+	auxHolder = TPose3D(m_particles[i].d);
 	return &auxHolder;
 }
 
@@ -223,17 +222,13 @@ void CMonteCarloLocalization3D::PF_SLAM_implementation_replaceByNewParticleSet(
 	//   Old are in "m_particles"
 	//   New are in "newParticles", "newParticlesWeight","newParticlesDerivedFromIdx"
 	// ---------------------------------------------------------------------------------
-	// Free old m_particles:
-	for (size_t i=0;i<old_particles.size();i++)
-			mrpt::utils::delete_safe( old_particles[ i ].d );
-
-	// Copy into "m_particles"
+	// Copy into "m_particles" (reusing its memory):
 	const size_t N = newParticles.size();
 	old_particles.resize(N);
 	for (size_t i=0;i<N;i++)
 	{
 		old_particles[i].log_w = newParticlesWeight[i];
-		old_particles[i].d = new CPose3D( newParticles[i] );
+		old_particles[i].d = CPose3D( newParticles[i] );
 	}
 }
 
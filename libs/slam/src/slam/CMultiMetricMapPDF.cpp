@@ -141,7 +141,7 @@ void  CMultiMetricMapPDF::getEstimatedPosePDFAtTime(
 	out_estimation.m_particles.resize(n);
 	for (i=0;i<n;i++)
 	{
-		out_estimation.m_particles[i].d = new CPose3D( m_particles[i].d->robotPath[ timeStep ] );
+		out_estimation.m_particles[i].d = CPose3D( m_particles[i].d->robotPath[ timeStep ] );
 		out_estimation.m_particles[i].log_w = m_particles[i].log_w;
 	}
 
@@ -180,7 +180,7 @@ void CRangeBearingKFSLAM::getCurrentState(
 		out_fullState[i] = m_xkk[i];
 
 	// Full cov:
-	out_fullCovariance = m_pkk;
+	this->getFullCovariance(out_fullCovariance);
 
 	MRPT_END
 }
@@ -961,8 +961,9 @@ void  CRangeBearingKFSLAM::getAs3DObject( mrpt::opengl::CSetOfObjectsPtr	&outObj
         pointGauss.mean.x( m_xkk[get_vehicle_size()+get_feature_size()*i+0] );
         pointGauss.mean.y( m_xkk[get_vehicle_size()+get_feature_size()*i+1] );
         pointGauss.mean.z( m_xkk[get_vehicle_size()+get_feature_size()*i+2] );
-        m_pkk.extractMatrix(get_vehicle_size()+get_feature_size()*i,get_vehicle_size()+get_feature_size()*i,get_feature_size(),get_feature_size(), COV);
-        pointGauss.cov = COV;
+        KFMatrix_FxF lm_cov;
+        this->getLandmarkCov(i,lm_cov);
+        pointGauss.cov = lm_cov;
 
 		opengl::CEllipsoidPtr ellip = opengl::CEllipsoid::Create();
 
@@ -1122,7 +1123,8 @@ double CRangeBearingKFSLAM::computeOffDiagonalBlocksApproximationError(
     MRPT_START
 
     // Compute the information matrix:
-    CMatrixTemplateNumeric<kftype> fullCov( m_pkk );
+    CMatrixTemplateNumeric<kftype> fullCov;
+    this->getFullCovariance(fullCov);
 	size_t i;
     for (i=0;i<get_vehicle_size();i++)
         fullCov(i,i) = max(fullCov(i,i), 1e-6);
@@ -1203,9 +1205,11 @@ void CRangeBearingKFSLAM::saveMapAndPath2DRepresentationAsMATLABFile(
 	{
 		size_t idx = get_vehicle_size()+i*get_feature_size();
 
-		cov(0,0) = m_pkk(idx+0,idx+0);
-		cov(1,1) = m_pkk(idx+1,idx+1);
-		cov(0,1) = cov(1,0) = m_pkk(idx+0,idx+1);
+		KFMatrix_FxF lm_cov;
+		this->getLandmarkCov(i,lm_cov);
+		cov(0,0) = lm_cov(0,0);
+		cov(1,1) = lm_cov(1,1);
+		cov(0,1) = cov(1,0) = lm_cov(0,1);
 
 		mean[0] = m_xkk[idx+0];
 		mean[1] = m_xkk[idx+1];
@@ -137,7 +137,7 @@ void CRangeBearingKFSLAM2D::getCurrentState(
 		out_fullState[i] = m_xkk[i];
 
 	// Full cov:
-	out_fullCovariance = m_pkk;
+	this->getFullCovariance(out_fullCovariance);
 
 	MRPT_END
 }
@@ -908,8 +908,9 @@ void  CRangeBearingKFSLAM2D::getAs3DObject( mrpt::opengl::CSetOfObjectsPtr	&outO
 	{
         pointGauss.mean.x( m_xkk[3+2*i+0] );
         pointGauss.mean.y( m_xkk[3+2*i+1] );
-        m_pkk.extractMatrix(3+2*i,3+2*i,2,2, COV);
-        pointGauss.cov = COV;
+        KFMatrix_FxF lm_cov;
+        this->getLandmarkCov(i,lm_cov);
+        pointGauss.cov = lm_cov;
 
 		opengl::CEllipsoidPtr ellip = opengl::CEllipsoid::Create();
 
@@ -964,9 +965,11 @@ void CRangeBearingKFSLAM2D::saveMapAndPath2DRepresentationAsMATLABFile(
 	{
 		size_t idx = get_vehicle_size()+i*get_feature_size();
 
-		cov(0,0) = m_pkk(idx+0,idx+0);
-		cov(1,1) = m_pkk(idx+1,idx+1);
-		cov(0,1) = cov(1,0) = m_pkk(idx+0,idx+1);
+		KFMatrix_FxF lm_cov;
+		this->getLandmarkCov(i,lm_cov);
+		cov(0,0) = lm_cov(0,0);
+		cov(1,1) = lm_cov(1,1);
+		cov(0,1) = cov(1,0) = lm_cov(0,1);
 
 		mean[0] = m_xkk[idx+0];
 		mean[1] = m_xkk[idx+1];
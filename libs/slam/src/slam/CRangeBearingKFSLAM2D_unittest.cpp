@@ -0,0 +1,99 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+
+#include <mrpt/slam/CRangeBearingKFSLAM2D.h>
+#include <mrpt/obs/CActionRobotMovement2D.h>
+#include <mrpt/obs/CObservationBearingRange.h>
+#include <mrpt/random.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::bayes;
+using namespace mrpt::slam;
+using namespace mrpt::maps;
+using namespace mrpt::obs;
+using namespace mrpt::poses;
+using namespace mrpt::math;
+using namespace mrpt::random;
+using namespace mrpt::utils;
+using namespace std;
+
+// Runs a synthetic 2D range-bearing SLAM experiment with the given KF method:
+void run_test_kf_slam2d(TKFMethod method, CVectorDouble &xkk, CMatrixDouble &Pkk)
+{
+	randomGenerator.randomize(1234);
+
+	CRangeBearingKFSLAM2D kf;
+	kf.KF_options.method = method;
+	kf.KF_options.CEKF_max_active_landmarks = 6; // Small, to force many global updates.
+
+	// Landmarks in a grid:
+	std::vector<TPoint2D> lms;
+	for (int ix=-5;ix<=5;ix++)
+		for (int iy=-5;iy<=5;iy++)
+			lms.push_back(TPoint2D(1.5*ix+0.1*iy,1.5*iy-0.2*ix));
+
+	const double max_range = 3.0;
+	CActionRobotMovement2D::TMotionModelOptions odo_opts;
+	CPose2D gt_pose;
+
+	for (size_t step=0;step<120;step++)
+	{
+		// A circular path which revisits the initial landmarks:
+		const CPose2D incr(0.2,0,DEG2RAD(4.0));
+		gt_pose = gt_pose + incr;
+
+		CActionCollectionPtr acts = CActionCollection::Create();
+		CActionRobotMovement2D act;
+		act.computeFromOdometry(incr,odo_opts);
+		acts->insert(act);
+
+		CSensoryFramePtr sf = CSensoryFrame::Create();
+		CObservationBearingRangePtr obs = CObservationBearingRange::Create();
+		obs->maxSensorDistance = max_range;
+		obs->fieldOfView_yaw = 2*M_PI;
+		obs->fieldOfView_pitch = 0;
+		for (size_t i=0;i<lms.size();i++)
+		{
+			double lx,ly;
+			gt_pose.inverseComposePoint(lms[i].x,lms[i].y, lx,ly);
+			const double r = std::sqrt(lx*lx+ly*ly);
+			if (r>max_range) continue;
+
+			CObservationBearingRange::TMeasurement m;
+			m.range = r + randomGenerator.drawGaussian1D(0,0.01);
+			m.yaw   = atan2(ly,lx) + randomGenerator.drawGaussian1D(0,DEG2RAD(0.1));
+			m.pitch = 0;
+			m.landmarkID = i;
+			obs->sensedData.push_back(m);
+		}
+		sf->insert(obs);
+
+		kf.processActionObservation(acts,sf);
+	}
+
+	CPosePDFGaussian robotPose;
+	std::vector<TPoint2D> LMs;
+	std::map<unsigned int,CLandmark::TLandmarkID> LM_IDs;
+	kf.getCurrentState(robotPose,LMs,LM_IDs,xkk,Pkk);
+}
+
+TEST(CRangeBearingKFSLAM2D, CEKF_same_as_EKF)
+{
+	CVectorDouble xkk_ekf, xkk_cekf;
+	CMatrixDouble Pkk_ekf, Pkk_cekf;
+	run_test_kf_slam2d(kfEKFNaive, xkk_ekf, Pkk_ekf);
+	run_test_kf_slam2d(kfCEKF, xkk_cekf, Pkk_cekf);
+
+	ASSERT_EQ(xkk_ekf.size(), xkk_cekf.size());
+	ASSERT_GT(xkk_ekf.size(), 3+2*10);
+	EXPECT_NEAR( (xkk_ekf-xkk_cekf).array().abs().maxCoeff(), 0.0, 1e-6);
+	EXPECT_NEAR( (Pkk_ekf-Pkk_cekf).array().abs().maxCoeff(), 0.0, 1e-6);
+}
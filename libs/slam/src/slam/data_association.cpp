@@ -26,6 +26,10 @@
 #include <mrpt/math/data_utils.h>
 #include <mrpt/poses/CPointPDFGaussian.h>
 #include <mrpt/poses/CPoint2DPDFGaussian.h>
+#include <mrpt/synch/CCriticalSection.h>
+#include <mrpt/synch/atomic_incr.h>
+#include <mrpt/system/parallelization.h>
+#include <mrpt/utils/aligned_containers.h>
 
 #include <set>
 #include <numeric>  // accumulate
@@ -46,10 +50,45 @@ namespace mrpt
 {
 namespace slam
 {
+	/** The size of the best hypothesis found so far by any of the JCBB branches which are run in parallel,
+	  * used as a common bound to prune the interpretation tree.
+	  * It's read without locking (in the hot path of the search) and only updated under the critical section.
+	  */
+	struct TJCBBSharedBound
+	{
+		TJCBBSharedBound() : m_best_size(0) { }
+
+		inline size_t get() const { return mrpt::synch::atomic_load_acquire(&m_best_size); }
+
+		void update(const size_t new_size)
+		{
+			if (new_size<=get()) return;
+			mrpt::synch::CCriticalSectionLocker lock(&m_cs);
+			if (new_size>m_best_size)
+				mrpt::synch::atomic_store_release(&m_best_size,new_size);
+		}
+	private:
+		mrpt::synch::CCriticalSection m_cs;
+		volatile size_t m_best_size;
+	};
+
+	/** The best hypothesis found by one JCBB branch */
+	struct TJCBBBestHypothesis
+	{
+		TJCBBBestHypothesis() : distance(0), nNodesExplored(0) { }
+
+		std::map<size_t,size_t>	associations;
+		double	distance;
+		size_t	nNodesExplored;
+	};
+
 	struct TAuxDataRecursiveJCBB
 	{
+		TAuxDataRecursiveJCBB() : nPredictions(0), nObservations(0), length_O(0), shared_bound(NULL) { }
+
 		size_t nPredictions, nObservations, length_O; //!< Just to avoid recomputing them all the time.
 		std::map<size_t,size_t>	currentAssociation;
+		TJCBBSharedBound *shared_bound; //!< May be NULL if there is only one branch.
 	};
 
 /**  Computes the joint distance metric (mahalanobis or matching likelihood) between two  a set of associations
@@ -149,7 +188,8 @@ void JCBB_recursive(
 	const mrpt::math::CMatrixTemplateNumeric<T>		&Z_observations_mean,
 	const mrpt::math::CMatrixTemplateNumeric<T>		&Y_predictions_mean,
 	const mrpt::math::CMatrixTemplateNumeric<T>		&Y_predictions_cov,
-	TDataAssociationResults			&results,
+	const TDataAssociationResults	&results,
+	TJCBBBestHypothesis				&best,
 	const TAuxDataRecursiveJCBB		&info,
 	const observation_index_t		curObsIdx
 	)
@@ -157,17 +197,19 @@ void JCBB_recursive(
 	// End of iteration?
 	if (curObsIdx>=info.nObservations)
 	{
-		if (info.currentAssociation.size()>results.associations.size())
+		if (info.currentAssociation.size()>best.associations.size())
 		{
 			// It's a better choice since more features are matched.
-			results.associations = info.currentAssociation;
-			results.distance = joint_pdf_metric<T,METRIC>(
+			best.associations = info.currentAssociation;
+			best.distance = joint_pdf_metric<T,METRIC>(
 				Z_observations_mean,
 				Y_predictions_mean,  Y_predictions_cov,
 				info,
 				results);
+			if (info.shared_bound)
+				info.shared_bound->update(best.associations.size());
 		}
-		else if ( !info.currentAssociation.empty() && info.currentAssociation.size()==results.associations.size() )
+		else if ( !info.currentAssociation.empty() && info.currentAssociation.size()==best.associations.size() )
 		{
 			// The same # of features matched than the previous best one... decide by better distance:
 			const double d2 = joint_pdf_metric<T,METRIC>(
@@ -176,10 +218,10 @@ void JCBB_recursive(
 				info,
 				results);
 
-			if (isCloser<METRIC>(d2,results.distance))
+			if (isCloser<METRIC>(d2,best.distance))
 			{
-				results.associations = info.currentAssociation;
-				results.distance = d2;
+				best.associations = info.currentAssociation;
+				best.distance = d2;
 			}
 		}
 	}
@@ -190,14 +232,19 @@ void JCBB_recursive(
 
 		const size_t nPreds = results.indiv_compatibility.getRowCount();
 
-		// Can we do it better than the current "results.associations"?
+		// Can we do it better than the current best hypothesis (ours, or any other branch's)?
 		// This can be checked by counting the potential new pairings+the so-far established ones.
 		//    Matlab: potentials  = pairings(compatibility.AL(i+1:end))
 		// Moved up by Kasra Khosoussi
+		// Only hypotheses which can not reach the size of the best one are pruned, so the result
+		// does not depend on the order in which branches are explored.
 		const size_t potentials = std::accumulate( results.indiv_compatibility_counts.begin()+(obsIdx+1), results.indiv_compatibility_counts.end(),0 );
+		// The bound of the other branches is read once per node:
+		const size_t shared_best_size = info.shared_bound ? info.shared_bound->get() : 0;
 		for (prediction_index_t predIdx=0;predIdx<nPreds;predIdx++)
 		{
-			if ((info.currentAssociation.size() + potentials) >= results.associations.size())
+			const size_t best_size = std::max(best.associations.size(),shared_best_size);
+			if ((info.currentAssociation.size() + 1 + potentials) >= best_size)
 			{
 				// Only if predIdx is NOT already assigned:
 				if ( results.indiv_compatibility(predIdx,obsIdx) )
@@ -219,31 +266,309 @@ void JCBB_recursive(
 						TAuxDataRecursiveJCBB new_info = info;
 						new_info.currentAssociation[ curObsIdx ] = predIdx;
 
-						results.nNodesExploredInJCBB++;
+						best.nNodesExplored++;
 
 						JCBB_recursive<T,METRIC>(
 							Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
-							results, new_info, curObsIdx+1);
+							results, best, new_info, curObsIdx+1);
 					}
 				}
 			}
 		}
 
-		// Can we do it better than the current "results.associations"?
-		if ((info.currentAssociation.size() + potentials) >= results.associations.size() )
+		// Can we do it better than the current best hypothesis?
+		const size_t best_size = std::max(best.associations.size(),shared_best_size);
+		if ((info.currentAssociation.size() + potentials) >= best_size )
 		{
 			// Yes we can </obama>
 
 			// star node: Ei not paired
-			results.nNodesExploredInJCBB++;
+			best.nNodesExplored++;
 			JCBB_recursive<T,METRIC>(
 				Z_observations_mean,  Y_predictions_mean, Y_predictions_cov,
-				results, info, curObsIdx+1);
+				results, best, info, curObsIdx+1);
 		}
 	}
 }
 
+/** Runs the JCBB branches hanging from the first observation with any individually compatible prediction.
+  * Branches are independent except for the shared bound, so they are explored in parallel (if MRPT is built with TBB).
+  */
+template <typename T, TDataAssociationMetric METRIC>
+struct TJCBBParallelBranches
+{
+	const mrpt::math::CMatrixTemplateNumeric<T>	&Z_observations_mean;
+	const mrpt::math::CMatrixTemplateNumeric<T>	&Y_predictions_mean;
+	const mrpt::math::CMatrixTemplateNumeric<T>	&Y_predictions_cov;
+	const TDataAssociationResults		&results;
+	const TAuxDataRecursiveJCBB			&root_info;
+	const observation_index_t			root_obs_idx;
+	const std::vector<int>				&branch_preds;    //!< The prediction paired to "root_obs_idx" in each branch (-1: star node)
+	std::vector<TJCBBBestHypothesis>	&branch_results;
+
+	TJCBBParallelBranches(
+		const mrpt::math::CMatrixTemplateNumeric<T>	&Z_observations_mean_,
+		const mrpt::math::CMatrixTemplateNumeric<T>	&Y_predictions_mean_,
+		const mrpt::math::CMatrixTemplateNumeric<T>	&Y_predictions_cov_,
+		const TDataAssociationResults		&results_,
+		const TAuxDataRecursiveJCBB			&root_info_,
+		const observation_index_t			root_obs_idx_,
+		const std::vector<int>				&branch_preds_,
+		std::vector<TJCBBBestHypothesis>	&branch_results_) :
+			Z_observations_mean(Z_observations_mean_),
+			Y_predictions_mean(Y_predictions_mean_),
+			Y_predictions_cov(Y_predictions_cov_),
+			results(results_),
+			root_info(root_info_),
+			root_obs_idx(root_obs_idx_),
+			branch_preds(branch_preds_),
+			branch_results(branch_results_)
+	{ }
+
+	void operator()(const mrpt::system::BlockedRange &range) const
+	{
+		for (int b=range.begin();b<range.end();++b)
+		{
+			TAuxDataRecursiveJCBB new_info = root_info;
+			if (branch_preds[b]>=0)
+				new_info.currentAssociation[root_obs_idx] = static_cast<prediction_index_t>(branch_preds[b]);
+
+			TJCBBBestHypothesis &best = branch_results[b];
+			best.nNodesExplored++;
+			JCBB_recursive<T,METRIC>(
+				Z_observations_mean, Y_predictions_mean, Y_predictions_cov,
+				results, best, new_info, root_obs_idx+1);
+		}
+	}
+};
 
+template <typename T, TDataAssociationMetric METRIC>
+void JCBB_parallel(
+	const mrpt::math::CMatrixTemplateNumeric<T>		&Z_observations_mean,
+	const mrpt::math::CMatrixTemplateNumeric<T>		&Y_predictions_mean,
+	const mrpt::math::CMatrixTemplateNumeric<T>		&Y_predictions_cov,
+	TDataAssociationResults			&results,
+	const TAuxDataRecursiveJCBB		&info
+	)
+{
+	// Observations without any IC pairing only have the star branch:
+	observation_index_t root_obs_idx = 0;
+	while (root_obs_idx<info.nObservations && results.indiv_compatibility_counts[root_obs_idx]==0)
+		root_obs_idx++;
+	if (root_obs_idx>=info.nObservations)
+		return; // No possible pairing at all.
+
+	// One branch per IC prediction, plus the star node:
+	std::vector<int> branch_preds;
+	for (prediction_index_t predIdx=0;predIdx<info.nPredictions;predIdx++)
+		if (results.indiv_compatibility(predIdx,root_obs_idx))
+			branch_preds.push_back(static_cast<int>(predIdx));
+	branch_preds.push_back(-1);
+
+	TJCBBBestHypothesis init_best;
+	init_best.distance = results.distance; // The worst possible distance
+	std::vector<TJCBBBestHypothesis> branch_results(branch_preds.size(), init_best);
+
+	TJCBBSharedBound shared_bound;
+	TAuxDataRecursiveJCBB root_info = info;
+	root_info.shared_bound = &shared_bound;
+
+	mrpt::system::parallel_for(
+		mrpt::system::BlockedRange(0,static_cast<int>(branch_preds.size())),
+		TJCBBParallelBranches<T,METRIC>(Z_observations_mean, Y_predictions_mean, Y_predictions_cov, results, root_info, root_obs_idx, branch_preds, branch_results) );
+
+	// Merge in the same order than the sequential algorithm would have found them:
+	results.nNodesExploredInJCBB = root_obs_idx;
+	for (size_t b=0;b<branch_results.size();b++)
+	{
+		const TJCBBBestHypothesis &br = branch_results[b];
+		results.nNodesExploredInJCBB += br.nNodesExplored;
+
+		if (br.associations.size()>results.associations.size() ||
+			(!br.associations.empty() && br.associations.size()==results.associations.size() && isCloser<METRIC>(br.distance,results.distance)) )
+		{
+			results.associations = br.associations;
+			results.distance = br.distance;
+		}
+	}
+}
+
+/** The marginal Gaussian of one prediction, prepared for the fast evaluation of individual compatibilities. */
+template <int DIM>
+struct TPredictionGaussian
+{
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	Eigen::Matrix<double,DIM,DIM> cov_inv;
+	double log_pdf_cte;    //!< The constant term in the log of the PDF: O*log(2*pi)+log(det(COV))
+};
+
+/** Evaluates the individual compatibility between all observations within the given range and all
+  * (or only the nearby ones, if a KD-tree is provided) predictions. Different observations
+  * only write to different columns of the output matrices, so they can be evaluated in parallel.
+  * Fixed-size matrices are used when DIM!=Eigen::Dynamic.
+  */
+template <int DIM>
+struct TIndivCompatibilityEvaluator
+{
+	typedef nanoflann::KDTreeEigenMatrixAdaptor<CMatrixDouble> kdtree_t;
+	typedef typename mrpt::aligned_containers<TPredictionGaussian<DIM> >::vector_t pred_gaussians_t;
+
+	const CMatrixDouble		&Z_observations_mean;
+	const CMatrixDouble		&Y_predictions_mean;
+	const pred_gaussians_t	&pred_gaussians;
+	const kdtree_t			*kd_tree; //!< May be NULL
+	const double			kd_search_radius_sq;
+	TDataAssociationResults	&results;
+	const TDataAssociationMetric metric;
+	const double			chi2thres;
+	const TDataAssociationMetric compatibilityTestMetric;
+	const double			log_ML_compat_test_threshold;
+
+	TIndivCompatibilityEvaluator(
+		const CMatrixDouble		&Z_observations_mean_,
+		const CMatrixDouble		&Y_predictions_mean_,
+		const pred_gaussians_t	&pred_gaussians_,
+		const kdtree_t			*kd_tree_,
+		const double			kd_search_radius_sq_,
+		TDataAssociationResults	&results_,
+		const TDataAssociationMetric metric_,
+		const double			chi2thres_,
+		const TDataAssociationMetric compatibilityTestMetric_,
+		const double			log_ML_compat_test_threshold_ ) :
+			Z_observations_mean(Z_observations_mean_),
+			Y_predictions_mean(Y_predictions_mean_),
+			pred_gaussians(pred_gaussians_),
+			kd_tree(kd_tree_),
+			kd_search_radius_sq(kd_search_radius_sq_),
+			results(results_),
+			metric(metric_),
+			chi2thres(chi2thres_),
+			compatibilityTestMetric(compatibilityTestMetric_),
+			log_ML_compat_test_threshold(log_ML_compat_test_threshold_)
+	{ }
+
+	inline void evaluate(const size_t i, const size_t j, Eigen::Matrix<double,DIM,1> &diff_means_i_j) const
+	{
+		const size_t length_O = diff_means_i_j.size();
+		for (size_t k=0;k<length_O;k++)
+			diff_means_i_j[k] = Z_observations_mean.get_unsafe(j,k) - Y_predictions_mean.get_unsafe(i,k);
+
+		const TPredictionGaussian<DIM> &pred_i = pred_gaussians[i];
+		const double d2 = diff_means_i_j.dot(pred_i.cov_inv * diff_means_i_j);
+		const double ml = -0.5*(d2 + pred_i.log_pdf_cte);
+
+		// The distance according to the metric
+		results.indiv_distances(i,j) = (metric==metricMaha) ? d2 : ml;
+
+		// Individual compatibility
+		const bool IC =  (compatibilityTestMetric==metricML) ? (ml > log_ML_compat_test_threshold) : (d2 < chi2thres);
+		results.indiv_compatibility(i,j)=IC;
+		if (IC)
+			results.indiv_compatibility_counts[j]++;
+	}
+
+	void operator()(const mrpt::system::BlockedRange &range) const
+	{
+		const size_t nPredictions = Y_predictions_mean.getRowCount();
+		const size_t length_O = Z_observations_mean.getColCount();
+
+		Eigen::Matrix<double,DIM,1>  diff_means_i_j(length_O);
+		std::vector<double>	kd_queryPoint(length_O);
+		std::vector<std::pair<CMatrixDouble::Index,double> > kd_results;
+
+		for (int j=range.begin();j<range.end();++j)
+		{
+			if (!kd_tree)
+			{
+				// Compute all the distances w/o a KD-tree
+				for (size_t i=0;i<nPredictions;++i)
+					evaluate(i,j,diff_means_i_j);
+			}
+			else
+			{
+				// Use a kd-tree and compute only the distances of those predictions close enough to be compatible:
+				for (size_t k=0;k<length_O;k++)
+					kd_queryPoint[k] = Z_observations_mean.get_unsafe(j,k);
+
+				kd_results.clear();
+				kd_tree->index->radiusSearch(&kd_queryPoint[0], kd_search_radius_sq, kd_results, nanoflann::SearchParams(32,0,false /*sorted*/) );
+
+				for (size_t w=0;w<kd_results.size();w++)
+					evaluate(kd_results[w].first,j,diff_means_i_j);
+			}
+		}
+	}
+};
+
+/** Computes the individual compatibility matrix, with fixed-size matrices if DIM!=Eigen::Dynamic */
+template <int DIM>
+void compute_indiv_compatibility(
+	const CMatrixDouble		&Z_observations_mean,
+	const CMatrixDouble		&Y_predictions_mean,
+	const CMatrixDouble		&Y_predictions_cov,
+	TDataAssociationResults	&results,
+	const TDataAssociationMetric metric,
+	const double			chi2thres,
+	const bool				DAT_ASOC_USE_KDTREE,
+	const TDataAssociationMetric compatibilityTestMetric,
+	const double			log_ML_compat_test_threshold)
+{
+	using nanoflann::KDTreeEigenMatrixAdaptor;
+
+	const size_t nPredictions  = Y_predictions_mean.getRowCount();
+	const size_t nObservations = Z_observations_mean.getRowCount();
+	const size_t length_O = Z_observations_mean.getColCount();
+
+	// Invert the marginal covariance of each prediction only once, instead of once per pairing:
+	typename TIndivCompatibilityEvaluator<DIM>::pred_gaussians_t pred_gaussians(nPredictions);
+	double kd_search_radius_sq = 0;
+	Eigen::Matrix<double,DIM,DIM> pred_i_cov(length_O,length_O);
+	for (size_t i=0;i<nPredictions;++i)
+	{
+		const size_t pred_cov_idx = i*length_O;  // Extract the submatrix from the diagonal:
+		for (size_t r=0;r<length_O;r++)
+			for (size_t c=0;c<length_O;c++)
+				pred_i_cov(r,c) = Y_predictions_cov.get_unsafe(pred_cov_idx+r,pred_cov_idx+c);
+
+		TPredictionGaussian<DIM> &pred_i = pred_gaussians[i];
+		pred_i.cov_inv = pred_i_cov.inverse();
+		pred_i.log_pdf_cte = length_O*::log(M_2PI) + ::log(pred_i_cov.determinant());
+
+		// A pairing can only be compatible if: |z-y|^2 <= d2 * max_eigenvalue(COV) <= d2 * trace(COV),
+		// with d2 the maximum Mahalanobis distance which passes the compatibility test:
+		if (DAT_ASOC_USE_KDTREE)
+		{
+			const double max_d2 = (compatibilityTestMetric==metricML) ?
+				-2*log_ML_compat_test_threshold - pred_i.log_pdf_cte
+				:
+				chi2thres;
+			if (max_d2>0)
+				mrpt::utils::keep_max(kd_search_radius_sq, max_d2 * pred_i_cov.trace());
+		}
+	}
+	kd_search_radius_sq*=1.01; // Just a safety margin against round-off errors.
+
+	// ------------------------------------------------------------
+	// Build a KD-tree of the predictions for quick look-up:
+	// ------------------------------------------------------------
+#if MRPT_HAS_CXX11
+	typedef std::unique_ptr<KDTreeEigenMatrixAdaptor<CMatrixDouble> > KDTreeMatrixPtr;
+#else
+	typedef std::auto_ptr<KDTreeEigenMatrixAdaptor<CMatrixDouble> > KDTreeMatrixPtr;
+#endif
+	KDTreeMatrixPtr  kd_tree;
+	if (DAT_ASOC_USE_KDTREE)
+	{
+		// Construct kd-tree for the predictions:
+		kd_tree = KDTreeMatrixPtr( new KDTreeEigenMatrixAdaptor<CMatrixDouble>(length_O, Y_predictions_mean) );
+	}
+
+	mrpt::system::parallel_for(
+		mrpt::system::BlockedRange(0,static_cast<int>(nObservations)),
+		TIndivCompatibilityEvaluator<DIM>(
+			Z_observations_mean, Y_predictions_mean, pred_gaussians, kd_tree.get(), kd_search_radius_sq,
+			results, metric, chi2thres, compatibilityTestMetric, log_ML_compat_test_threshold) );
+}
 
 } // end namespace
 } // end namespace
@@ -286,8 +611,6 @@ void mrpt::slam::data_association_full_covariance(
 {
 	// For details on the theory, see the papers cited at the beginning of this file.
 
-	using nanoflann::KDTreeEigenMatrixAdaptor;
-
 	MRPT_START
 
 	results.clear();
@@ -308,26 +631,6 @@ void mrpt::slam::data_association_full_covariance(
 
 	const double chi2thres = mrpt::math::chi2inv( chi2quantile, length_O );
 
-	// ------------------------------------------------------------
-	// Build a KD-tree of the predictions for quick look-up:
-	// ------------------------------------------------------------
-#if MRPT_HAS_CXX11
-	typedef std::unique_ptr<KDTreeEigenMatrixAdaptor<CMatrixDouble> > KDTreeMatrixPtr;
-#else
-	typedef std::auto_ptr<KDTreeEigenMatrixAdaptor<CMatrixDouble> > KDTreeMatrixPtr;
-#endif
-	KDTreeMatrixPtr  kd_tree;
-	const size_t N_KD_RESULTS = nPredictions;
-	std::vector<double>	kd_result_distances(DAT_ASOC_USE_KDTREE ? N_KD_RESULTS : 0);
-	std::vector<CMatrixDouble::Index> kd_result_indices(DAT_ASOC_USE_KDTREE ? N_KD_RESULTS : 0);
-	std::vector<double>	kd_queryPoint(DAT_ASOC_USE_KDTREE ? length_O : 0);
-
-	if (DAT_ASOC_USE_KDTREE)
-	{
-		// Construct kd-tree for the predictions:
-		kd_tree = KDTreeMatrixPtr( new KDTreeEigenMatrixAdaptor<CMatrixDouble>(length_O, Y_predictions_mean) );
-	}
-
 	// Initialize with the worst possible distance:
 	results.distance = (metric==metricML) ? 0 : std::numeric_limits<double>::max();
 
@@ -344,79 +647,18 @@ void mrpt::slam::data_association_full_covariance(
 			-1000 /*A very small log-likelihoo   */ );
 	results.indiv_compatibility.fillAll(false);
 
-	CMatrixDouble pred_i_cov(length_O,length_O);
-
-	Eigen::VectorXd  diff_means_i_j(length_O);
-
-	for (size_t j=0;j<nObservations;++j)
+	switch (length_O)
 	{
-		if (!DAT_ASOC_USE_KDTREE)
-		{
-			// Compute all the distances w/o a KD-tree
-			for (size_t i=0;i<nPredictions;++i)
-			{
-				// Evaluate sqr. mahalanobis distance of obs_j -> pred_i:
-				const size_t pred_cov_idx = i*length_O;  // Extract the submatrix from the diagonal:
-				Y_predictions_cov.extractMatrix(pred_cov_idx,pred_cov_idx,length_O,length_O, pred_i_cov);
-
-				for (size_t k=0;k<length_O;k++)
-					diff_means_i_j[k] = Z_observations_mean.get_unsafe(j,k) - Y_predictions_mean.get_unsafe(i,k);
-
-				double d2, ml;
-				//mrpt::math::productIntegralAndMahalanobisTwoGaussians(diff_means_i_j,pred_i_cov,obs_j_cov, d2,ml);
-				mrpt::math::mahalanobisDistance2AndLogPDF(diff_means_i_j,pred_i_cov, d2,ml);
-
-				// The distance according to the metric
-				double val =  (metric==metricMaha) ? d2 : ml;
-
-				results.indiv_distances(i,j) = val;
-
-				// Individual compatibility
-				const bool IC =  (compatibilityTestMetric==metricML) ? (ml > log_ML_compat_test_threshold) : (d2 < chi2thres);
-				results.indiv_compatibility(i,j)=IC;
-				if (IC)
-					results.indiv_compatibility_counts[j]++;
-			}
-		}
-		else
-		{
-			// Use a kd-tree and compute only the N closest ones:
-			for (size_t k=0;k<length_O;k++)
-				kd_queryPoint[k] = Z_observations_mean.get_unsafe(j,k);
-
-			kd_tree->query(&kd_queryPoint[0], N_KD_RESULTS, &kd_result_indices[0], &kd_result_distances[0] );
-
-			// Only compute the distances for these ones:
-			for (size_t w=0;w<N_KD_RESULTS;w++)
-			{
-				const size_t i = kd_result_indices[w];  // This is the index of the prediction in "predictions_mean"
-
-				// Build the PDF of the prediction:
-				const size_t pred_cov_idx = i*length_O;  // Extract the submatrix from the diagonal:
-				Y_predictions_cov.extractMatrix(pred_cov_idx,pred_cov_idx,length_O,length_O, pred_i_cov);
-
-				for (size_t k=0;k<length_O;k++)
-					diff_means_i_j[k] = Z_observations_mean.get_unsafe(j,k) - Y_predictions_mean.get_unsafe(i,k);
-
-				double d2, ml;
-//				mrpt::math::productIntegralAndMahalanobisTwoGaussians(diff_means_i_j,pred_i_cov,obs_j_cov, d2,ml);
-				mrpt::math::mahalanobisDistance2AndLogPDF(diff_means_i_j,pred_i_cov, d2,ml);
-
-				if (d2>6*chi2thres) break; // Since kd-tree returns the landmarks by distance order, we can skip the rest
-
-				// The distance according to the metric
-				double val =  (metric==metricMaha) ? d2 : ml;
-
-				results.indiv_distances(i,j) = val;
-
-				// Individual compatibility
-				const bool IC =  (compatibilityTestMetric==metricML) ? (ml > log_ML_compat_test_threshold) : (d2 < chi2thres);
-				results.indiv_compatibility(i,j) = IC;
-				if (IC)
-					results.indiv_compatibility_counts[j]++;
-			}
-		} // end use KD-Tree
-	} // end for
+	case 2:
+		compute_indiv_compatibility<2>(Z_observations_mean,Y_predictions_mean,Y_predictions_cov, results, metric, chi2thres, DAT_ASOC_USE_KDTREE, compatibilityTestMetric, log_ML_compat_test_threshold);
+		break;
+	case 3:
+		compute_indiv_compatibility<3>(Z_observations_mean,Y_predictions_mean,Y_predictions_cov, results, metric, chi2thres, DAT_ASOC_USE_KDTREE, compatibilityTestMetric, log_ML_compat_test_threshold);
+		break;
+	default:
+		compute_indiv_compatibility<Eigen::Dynamic>(Z_observations_mean,Y_predictions_mean,Y_predictions_cov, results, metric, chi2thres, DAT_ASOC_USE_KDTREE, compatibilityTestMetric, log_ML_compat_test_threshold);
+		break;
+	};
 
 #if 0
 	cout << "Distances: " << endl << results.indiv_distances << endl;
@@ -491,16 +733,16 @@ void mrpt::slam::data_association_full_covariance(
 		// ------------------------------------
 	case assocJCBB:
 		{
-			// Call to the recursive method:
+			// Call to the recursive method, with its first level of branches run in parallel:
 			TAuxDataRecursiveJCBB	info;
 			info.nPredictions	= nPredictions;
 			info.nObservations	= nObservations;
 			info.length_O		= length_O;
 
 			if (metric==metricMaha)
-				JCBB_recursive<CMatrixDouble::Scalar,metricMaha>(Z_observations_mean,  Y_predictions_mean, Y_predictions_cov,results, info, 0 );
+				JCBB_parallel<CMatrixDouble::Scalar,metricMaha>(Z_observations_mean,  Y_predictions_mean, Y_predictions_cov,results, info );
 			else
-				JCBB_recursive<CMatrixDouble::Scalar,metricML>(Z_observations_mean,  Y_predictions_mean, Y_predictions_cov,results, info, 0 );
+				JCBB_parallel<CMatrixDouble::Scalar,metricML>(Z_observations_mean,  Y_predictions_mean, Y_predictions_cov,results, info );
 		}
 		break;
 
@@ -9,6 +9,7 @@
 
 
 #include <mrpt/slam/data_association.h>
+#include <mrpt/random.h>
 #include <gtest/gtest.h>
 
 using namespace mrpt;
@@ -53,3 +54,137 @@ TEST(DataAssociation, TestNoICs)
 	}
 
 }
+
+// Generates a random DA problem, with 2D landmarks and full prediction cross-covariances:
+void generate_random_DA_problem(
+	const size_t nPreds, const size_t nObs, const double lm_spacing,
+	CMatrixDouble &y, CMatrixDouble &y_cov, CMatrixDouble &z)
+{
+	mrpt::random::randomGenerator.randomize(123);
+
+	y.setSize(nPreds,2);
+	for (size_t i=0;i<nPreds;i++)
+	{
+		y(i,0) = lm_spacing * (i % 10) + mrpt::random::randomGenerator.drawUniform(-0.1,0.1)*lm_spacing;
+		y(i,1) = lm_spacing * (i / 10) + mrpt::random::randomGenerator.drawUniform(-0.1,0.1)*lm_spacing;
+	}
+
+	// A random positive-definite covariance with cross-correlations: A*A^t + diag
+	CMatrixDouble A(2*nPreds,4);
+	mrpt::random::randomGenerator.drawGaussian1DMatrix(A, 0, 0.1);
+	y_cov.multiply_AAt(A);
+	for (size_t i=0;i<2*nPreds;i++)
+		y_cov(i,i)+= 0.01 + mrpt::random::randomGenerator.drawUniform(0,0.02);
+
+	// Observations: Most of them are noisy versions of a prediction, the rest are spurious:
+	z.setSize(nObs,2);
+	for (size_t j=0;j<nObs;j++)
+	{
+		if (j%5==4)
+		{
+			z(j,0) = mrpt::random::randomGenerator.drawUniform(0,10*lm_spacing);
+			z(j,1) = mrpt::random::randomGenerator.drawUniform(0,(nPreds/10)*lm_spacing);
+		}
+		else
+		{
+			const size_t i = (j*7) % nPreds;
+			z(j,0) = y(i,0) + mrpt::random::randomGenerator.drawGaussian1D(0,0.1);
+			z(j,1) = y(i,1) + mrpt::random::randomGenerator.drawGaussian1D(0,0.1);
+		}
+	}
+}
+
+TEST(DataAssociation, SameResultsWithKDTree)
+{
+	CMatrixDouble y, y_cov, z;
+	generate_random_DA_problem(80,30, 1.0, y,y_cov,z);
+
+	const TDataAssociationMethod dams[2]   = { assocNN, assocJCBB };
+	const TDataAssociationMetric damets[2] = { metricMaha, metricML };
+
+	for (unsigned int da_metric=0;da_metric<2;++da_metric)
+	{
+		for (unsigned int da_method=0;da_method<2;++da_method)
+		{
+			for (unsigned int ic_metric=0;ic_metric<2;++ic_metric)
+			{
+				TDataAssociationResults	res_kd, res_no_kd;
+				data_association_full_covariance(z, y, y_cov, res_kd,    dams[da_method], damets[da_metric], 0.99, true,  std::vector<prediction_index_t>(), damets[ic_metric], -2.0);
+				data_association_full_covariance(z, y, y_cov, res_no_kd, dams[da_method], damets[da_metric], 0.99, false, std::vector<prediction_index_t>(), damets[ic_metric], -2.0);
+
+				for (size_t i=0;i<res_kd.indiv_compatibility.getRowCount();i++)
+					for (size_t j=0;j<res_kd.indiv_compatibility.getColCount();j++)
+						EXPECT_EQ(res_kd.indiv_compatibility(i,j),res_no_kd.indiv_compatibility(i,j))
+							<< "For da_method="<< da_method << " da_metric="<<da_metric<< " ic_metric="<<ic_metric<< endl;
+				EXPECT_TRUE(res_kd.indiv_compatibility_counts==res_no_kd.indiv_compatibility_counts);
+				EXPECT_TRUE(res_kd.associations==res_no_kd.associations)
+					<< "For da_method="<< da_method << " da_metric="<<da_metric<< " ic_metric="<<ic_metric<< endl;
+				EXPECT_GT(res_kd.associations.size(), 10u);
+				EXPECT_DOUBLE_EQ(res_kd.distance,res_no_kd.distance);
+			}
+		}
+	}
+}
+
+// Exhaustive search of the best hypothesis: the largest number of pairings, then the smallest joint Mahalanobis distance.
+void brute_force_JCBB(
+	const CMatrixDouble &y, const CMatrixDouble &y_cov, const CMatrixDouble &z,
+	const CMatrixBool &IC, size_t obsIdx, std::map<size_t,size_t> &cur,
+	std::map<size_t,size_t> &best, double &best_d2)
+{
+	if (obsIdx==size_t(z.getRowCount()))
+	{
+		if (cur.empty() || cur.size()<best.size()) return;
+
+		const size_t N = cur.size();
+		Eigen::VectorXd innov(2*N);
+		Eigen::MatrixXd COV(2*N,2*N);
+		size_t a=0;
+		for (std::map<size_t,size_t>::const_iterator ia=cur.begin();ia!=cur.end();++ia,++a)
+		{
+			for (int k=0;k<2;k++) innov[2*a+k] = y(ia->second,k)-z(ia->first,k);
+			size_t b=0;
+			for (std::map<size_t,size_t>::const_iterator ib=cur.begin();ib!=cur.end();++ib,++b)
+				COV.block<2,2>(2*a,2*b) = y_cov.block<2,2>(2*ia->second,2*ib->second);
+		}
+		const double d2 = innov.dot(COV.inverse()*innov);
+		if (cur.size()>best.size() || d2<best_d2)
+		{
+			best = cur;
+			best_d2 = d2;
+		}
+		return;
+	}
+
+	for (size_t i=0;i<size_t(y.getRowCount());i++)
+	{
+		if (!IC(i,obsIdx)) continue;
+		bool taken = false;
+		for (std::map<size_t,size_t>::const_iterator it=cur.begin();it!=cur.end();++it)
+			if (it->second==i) taken=true;
+		if (taken) continue;
+
+		cur[obsIdx] = i;
+		brute_force_JCBB(y,y_cov,z,IC,obsIdx+1,cur,best,best_d2);
+		cur.erase(obsIdx);
+	}
+	brute_force_JCBB(y,y_cov,z,IC,obsIdx+1,cur,best,best_d2);
+}
+
+TEST(DataAssociation, JCBBFindsBestHypothesis)
+{
+	// Closely spaced landmarks, so there are many ambiguous pairings:
+	CMatrixDouble y, y_cov, z;
+	generate_random_DA_problem(10,6, 0.15, y,y_cov,z);
+
+	TDataAssociationResults	res;
+	data_association_full_covariance(z, y, y_cov, res, assocJCBB, metricMaha, 0.99, true);
+
+	std::map<size_t,size_t> cur, best;
+	double best_d2 = std::numeric_limits<double>::max();
+	brute_force_JCBB(y,y_cov,z,res.indiv_compatibility,0,cur,best,best_d2);
+
+	EXPECT_GT(best.size(), 3u);
+	EXPECT_TRUE(res.associations==best);
+	EXPECT_NEAR(res.distance, best_d2, 1e-6);
+}
@@ -61,6 +61,63 @@ namespace mrpt
 			std::vector<mrpt::math::TPoint3D>       &out_ENU_points,
 			const TGeodeticCoords       &in_coords_origin );
 
+		/** \overload Converts many points given as separate arrays of latitudes, longitudes (degrees) and heights (meters), with a CGeodeticToENU_WGS84 object.
+		  *  The output vectors are resized as needed. */
+		void TOPO_IMPEXP geodeticToENU_WGS84(
+			const std::vector<double>  &in_lat_deg,
+			const std::vector<double>  &in_lon_deg,
+			const std::vector<double>  &in_height,
+			std::vector<double>        &out_x,
+			std::vector<double>        &out_y,
+			std::vector<double>        &out_z,
+			const TGeodeticCoords      &in_coords_origin );
+
+		/** Coordinates transformation from longitude/latitude/height to ENU (East-North-Up) X/Y/Z coordinates relative to a fixed origin, as geodeticToENU_WGS84(),
+		  *  but much faster when converting many points (e.g. all the readings of the GNSS receivers in a dataset):
+		  *  - The geocentric coordinates and the ENU axes of the origin are computed only once, in the constructor or setOrigin().
+		  *  - The sines and cosines of the latitude and longitude of each point are obtained from those of the origin and the sine and cosine of the offset angles,
+		  *    which are evaluated with their Taylor polynomials (up to 9th order) for offsets smaller than MAX_POLY_OFFSET_RAD (0.05 rad, ~300km). In that range the
+		  *    truncation error of the polynomials is below 1e-17, so the results are those of geodeticToENU_WGS84() up to floating point round-off (well below 1 micrometer).
+		  *    Farther points are converted with the standard trigonometric functions.
+		  *
+		  * \sa geodeticToENU_WGS84
+		  */
+		class TOPO_IMPEXP CGeodeticToENU_WGS84
+		{
+		public:
+			static const double MAX_POLY_OFFSET_RAD; //!< Max. offset (in radians) from the origin latitude and longitude for the polynomial approximations (=0.05)
+
+			CGeodeticToENU_WGS84(); //!< Default ctor: origin at lat=lon=height=0
+			explicit CGeodeticToENU_WGS84(const TGeodeticCoords &in_coords_origin);
+
+			void setOrigin(const TGeodeticCoords &in_coords_origin); //!< Changes the origin and recomputes the cached ENU axes
+			inline const TGeodeticCoords & getOrigin() const { return m_origin; }
+			inline const mrpt::math::TPoint3D & getOriginGeocentric() const { return m_P0; } //!< Geocentric coordinates of the origin
+
+			/** Converts one point. Optionally, also returns its geocentric coordinates (as in geodeticToGeocentric_WGS84()) */
+			void convert(
+				const TGeodeticCoords  &in_coords,
+				mrpt::math::TPoint3D   &out_ENU_point,
+				mrpt::math::TPoint3D   *out_geocentric_point = NULL ) const;
+
+			/** Converts many points given as separate arrays of latitudes, longitudes (degrees) and heights (meters). The output vectors are resized as needed. */
+			void convert(
+				const std::vector<double>  &in_lat_deg,
+				const std::vector<double>  &in_lon_deg,
+				const std::vector<double>  &in_height,
+				std::vector<double>        &out_x,
+				std::vector<double>        &out_y,
+				std::vector<double>        &out_z ) const;
+
+		private:
+			TGeodeticCoords       m_origin;
+			double                m_lat0, m_lon0; //!< Origin, in radians
+			double                m_slat0, m_clat0, m_slon0, m_clon0;
+			mrpt::math::TPoint3D  m_P0; //!< Origin, in geocentric coordinates
+
+			void convertPoint(const double lat_deg, const double lon_deg, const double height, double &x, double &y, double &z, mrpt::math::TPoint3D *out_geocentric_point) const;
+		};
+
 		/** Coordinates transformation from longitude/latitude/height to geocentric X/Y/Z coordinates (with a WGS84 geoid).
 		  *  The WGS84 ellipsoid is used for the transformation. The coordinates are in 3D
 		  *   where the reference is the center of the Earth.
@@ -79,6 +136,16 @@ namespace mrpt
 			TGeocentricCoords		&out_point,
 			const TEllipsoid		&ellip );
 
+		/** \overload Converts many points given as separate arrays of latitudes, longitudes (degrees) and heights (meters). The output vectors are resized as needed. */
+		void  TOPO_IMPEXP geodeticToGeocentric(
+			const std::vector<double>  &in_lat_deg,
+			const std::vector<double>  &in_lon_deg,
+			const std::vector<double>  &in_height,
+			std::vector<double>        &out_x,
+			std::vector<double>        &out_y,
+			std::vector<double>        &out_z,
+			const TEllipsoid           &ellip = TEllipsoid::Ellipsoid_WGS84() );
+
 		/** Coordinates transformation from geocentric X/Y/Z coordinates to longitude/latitude/height.
 		  * \sa geodeticToGeocentric
 		  */
@@ -96,6 +163,12 @@ namespace mrpt
 			const TDatum7Params			&in_datum,
 			mrpt::math::TPoint3D		&out_point);
 
+		/** \overload More efficient for converting a pointcloud */
+		void  TOPO_IMPEXP transform7params(
+			const std::vector<mrpt::math::TPoint3D>	&in_points,
+			const TDatum7Params						&in_datum,
+			std::vector<mrpt::math::TPoint3D>		&out_points);
+
 		void  TOPO_IMPEXP transform7params_TOPCON(
 			const mrpt::math::TPoint3D	&in_point,
 			const TDatum7Params_TOPCON	&in_datum,
@@ -119,6 +192,12 @@ namespace mrpt
 			const TDatumHelmert2D		&d,
 			mrpt::math::TPoint2D		&o);
 
+		/** \overload More efficient for converting many points: the rotation is computed only once */
+		void  TOPO_IMPEXP transformHelmert2D(
+			const std::vector<mrpt::math::TPoint2D>	&p,
+			const TDatumHelmert2D					&d,
+			std::vector<mrpt::math::TPoint2D>		&o);
+
 		void  TOPO_IMPEXP transformHelmert2D_TOPCON(
 			const mrpt::math::TPoint2D		&p,
 			const TDatumHelmert2D_TOPCON	&d,
@@ -133,6 +212,12 @@ namespace mrpt
 			const TDatumHelmert3D		&d,
 			mrpt::math::TPoint3D		&o);
 
+		/** \overload More efficient for converting a pointcloud */
+		void  TOPO_IMPEXP transformHelmert3D(
+			const std::vector<mrpt::math::TPoint3D>	&p,
+			const TDatumHelmert3D					&d,
+			std::vector<mrpt::math::TPoint3D>		&o);
+
 		void  TOPO_IMPEXP transformHelmert3D_TOPCON(
 			const mrpt::math::TPoint3D		&p,
 			const TDatumHelmert3D_TOPCON	&d,
@@ -220,6 +305,17 @@ namespace mrpt
 			char    				&UTMLatitudeBand,
 			const TEllipsoid		&ellip = TEllipsoid::Ellipsoid_WGS84());
 
+		/** \overload Converts many points given as separate arrays of latitudes and longitudes (degrees), as GeodeticToUTM() (the same formulas),
+		  *  with the constants of the ellipsoid computed only once. The output vectors are resized as needed. */
+		void  TOPO_IMPEXP GeodeticToUTM(
+			const std::vector<double>  &in_latitude_degrees,
+			const std::vector<double>  &in_longitude_degrees,
+			std::vector<double>        &out_UTM_x,
+			std::vector<double>        &out_UTM_y,
+			std::vector<int>           &out_UTM_zone,
+			std::vector<char>          &out_UTM_latitude_band,
+			const TEllipsoid           &ellip = TEllipsoid::Ellipsoid_WGS84());
+
 
 		/** Convert latitude and longitude coordinates into UTM coordinates, computing the corresponding UTM zone and latitude band.
 		  *   This method is based on public code by Gabriel Ruiz Martinez and Rafael Palacios.
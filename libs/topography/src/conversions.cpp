@@ -14,6 +14,7 @@
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/math/utils.h>
 #include <mrpt/math/geometry.h>
+#include <mrpt/math/wrap2pi.h>
 #include <mrpt/utils/CStartUpClassesRegister.h>
 
 using namespace std;
@@ -127,6 +128,130 @@ void  mrpt::topography::geodeticToENU_WGS84(
 	geocentricToENU_WGS84(P_geocentric,out_ENU_point,in_coords_origin);
 }
 
+void mrpt::topography::geodeticToENU_WGS84(
+	const std::vector<double>  &in_lat_deg,
+	const std::vector<double>  &in_lon_deg,
+	const std::vector<double>  &in_height,
+	std::vector<double>        &out_x,
+	std::vector<double>        &out_y,
+	std::vector<double>        &out_z,
+	const TGeodeticCoords      &in_coords_origin )
+{
+	const CGeodeticToENU_WGS84 conv(in_coords_origin);
+	conv.convert(in_lat_deg,in_lon_deg,in_height, out_x,out_y,out_z);
+}
+
+/*---------------------------------------------------------------
+				CGeodeticToENU_WGS84
+ ---------------------------------------------------------------*/
+namespace
+{
+	// sin(x) and cos(x) from their Taylor polynomials, for |x|<=CGeodeticToENU_WGS84::MAX_POLY_OFFSET_RAD:
+	//  the remainders are below x^11/11! and x^10/10!, respectively (<1e-17).
+	inline void sincos_small_angle(const double x, double &s, double &c)
+	{
+		const double x2 = x*x;
+		s = x*(1 - x2/6*(1 - x2/20*(1 - x2/42*(1 - x2/72))));
+		c = 1 - x2/2*(1 - x2/12*(1 - x2/30*(1 - x2/56)));
+	}
+}
+
+const double mrpt::topography::CGeodeticToENU_WGS84::MAX_POLY_OFFSET_RAD = 0.05;
+
+mrpt::topography::CGeodeticToENU_WGS84::CGeodeticToENU_WGS84()
+{
+	setOrigin(TGeodeticCoords(0,0,0));
+}
+
+mrpt::topography::CGeodeticToENU_WGS84::CGeodeticToENU_WGS84(const TGeodeticCoords &in_coords_origin)
+{
+	setOrigin(in_coords_origin);
+}
+
+void mrpt::topography::CGeodeticToENU_WGS84::setOrigin(const TGeodeticCoords &in_coords_origin)
+{
+	m_origin = in_coords_origin;
+	m_lat0 = DEG2RAD(in_coords_origin.lat);
+	m_lon0 = DEG2RAD(in_coords_origin.lon);
+	m_slat0 = sin(m_lat0); m_clat0 = cos(m_lat0);
+	m_slon0 = sin(m_lon0); m_clon0 = cos(m_lon0);
+	geodeticToGeocentric_WGS84(in_coords_origin,m_P0);
+}
+
+void mrpt::topography::CGeodeticToENU_WGS84::convertPoint(
+	const double lat_deg, const double lon_deg, const double height,
+	double &x, double &y, double &z,
+	mrpt::math::TPoint3D *out_geocentric_point) const
+{
+	// Same constants than geodeticToGeocentric_WGS84():
+	static const precnum_t a = 6378137L;		// Semi-major axis of the Earth (meters)
+	static const precnum_t b = 6356752.3142L;	// Semi-minor axis:
+	static const precnum_t ae = acos(b/a);  	// eccentricity:
+	static const precnum_t cos2_ae_earth =  square(cos(ae)); // The cos^2 of the angular eccentricity of the Earth
+	static const precnum_t sin2_ae_earth = square(sin(ae));  // The sin^2 of the angular eccentricity of the Earth
+
+	const double lat = DEG2RAD(lat_deg), lon = DEG2RAD(lon_deg);
+	const double dlat = lat - m_lat0;
+	const double dlon = mrpt::math::wrapToPi(lon - m_lon0);
+
+	double slat,clat,slon,clon;
+	if (std::abs(dlat)<=MAX_POLY_OFFSET_RAD && std::abs(dlon)<=MAX_POLY_OFFSET_RAD)
+	{
+		// sin/cos of (origin+offset) from those of the origin:
+		double sd,cd;
+		sincos_small_angle(dlat,sd,cd);
+		slat = m_slat0*cd + m_clat0*sd;
+		clat = m_clat0*cd - m_slat0*sd;
+		sincos_small_angle(dlon,sd,cd);
+		slon = m_slon0*cd + m_clon0*sd;
+		clon = m_clon0*cd - m_slon0*sd;
+	}
+	else
+	{
+		slat = sin(lat); clat = cos(lat);
+		slon = sin(lon); clon = cos(lon);
+	}
+
+	// The radius of curvature in the prime vertical:
+	const precnum_t N = a / std::sqrt( 1 - sin2_ae_earth*square(slat) );
+
+	// Geocentric coordinates:
+	const double gx = (N+height)*clat*clon;
+	const double gy = (N+height)*clat*slon;
+	const double gz = (cos2_ae_earth*N+height)*slat;
+	if (out_geocentric_point)
+		*out_geocentric_point = TPoint3D(gx,gy,gz);
+
+	// Relative to the origin, rotated to the ENU axes (as in geocentricToENU_WGS84):
+	const double px = gx-m_P0.x, py = gy-m_P0.y, pz = gz-m_P0.z;
+	x = -m_slon0*px + m_clon0*py;
+	y = -m_clon0*m_slat0*px -m_slon0*m_slat0*py + m_clat0*pz;
+	z = m_clon0*m_clat0*px + m_slon0*m_clat0*py + m_slat0*pz;
+}
+
+void mrpt::topography::CGeodeticToENU_WGS84::convert(
+	const TGeodeticCoords  &in_coords,
+	mrpt::math::TPoint3D   &out_ENU_point,
+	mrpt::math::TPoint3D   *out_geocentric_point ) const
+{
+	convertPoint(in_coords.lat,in_coords.lon,in_coords.height, out_ENU_point.x,out_ENU_point.y,out_ENU_point.z, out_geocentric_point);
+}
+
+void mrpt::topography::CGeodeticToENU_WGS84::convert(
+	const std::vector<double>  &in_lat_deg,
+	const std::vector<double>  &in_lon_deg,
+	const std::vector<double>  &in_height,
+	std::vector<double>        &out_x,
+	std::vector<double>        &out_y,
+	std::vector<double>        &out_z ) const
+{
+	const size_t N = in_lat_deg.size();
+	ASSERT_(in_lon_deg.size()==N && in_height.size()==N);
+	out_x.resize(N); out_y.resize(N); out_z.resize(N);
+	for (size_t i=0;i<N;i++)
+		convertPoint(in_lat_deg[i],in_lon_deg[i],in_height[i], out_x[i],out_y[i],out_z[i], NULL);
+}
+
 /*---------------------------------------------------------------
 					ENU_axes_from_WGS84
  ---------------------------------------------------------------*/
@@ -202,12 +327,13 @@ void  mrpt::topography::geodeticToGeocentric(
 	TGeocentricCoords		&out_point,
 	const TEllipsoid		&ellip )
 {
-	static const precnum_t a = ellip.sa;		// Semi-major axis of the Earth (meters)
-	static const precnum_t b = ellip.sb;	// Semi-minor axis:
+	// Not "static": they depend on the ellipsoid
+	const precnum_t a = ellip.sa;		// Semi-major axis of the Earth (meters)
+	const precnum_t b = ellip.sb;	// Semi-minor axis:
 
-	static const precnum_t ae = acos(b/a);  	// eccentricity:
-	static const precnum_t cos2_ae_earth =  square(cos(ae)); // The cos^2 of the angular eccentricity of the Earth: // 0.993305619995739L;
-	static const precnum_t sin2_ae_earth = square(sin(ae));  // The sin^2 of the angular eccentricity of the Earth: // 0.006694380004261L;
+	const precnum_t ae = acos(b/a);  	// eccentricity:
+	const precnum_t cos2_ae_earth =  square(cos(ae)); // The cos^2 of the angular eccentricity of the Earth: // 0.993305619995739L;
+	const precnum_t sin2_ae_earth = square(sin(ae));  // The sin^2 of the angular eccentricity of the Earth: // 0.006694380004261L;
 
 	const precnum_t lon  = DEG2RAD( precnum_t(in_coords.lon) );
 	const precnum_t lat  = DEG2RAD( precnum_t(in_coords.lat) );
@@ -221,6 +347,39 @@ void  mrpt::topography::geodeticToGeocentric(
 	out_point.z = (cos2_ae_earth*N+in_coords.height)*sin(lat);
 }
 
+void  mrpt::topography::geodeticToGeocentric(
+	const std::vector<double>  &in_lat_deg,
+	const std::vector<double>  &in_lon_deg,
+	const std::vector<double>  &in_height,
+	std::vector<double>        &out_x,
+	std::vector<double>        &out_y,
+	std::vector<double>        &out_z,
+	const TEllipsoid           &ellip )
+{
+	const size_t nPts = in_lat_deg.size();
+	ASSERT_(in_lon_deg.size()==nPts && in_height.size()==nPts);
+	out_x.resize(nPts); out_y.resize(nPts); out_z.resize(nPts);
+
+	const precnum_t a = ellip.sa;
+	const precnum_t b = ellip.sb;
+	const precnum_t ae = acos(b/a);
+	const precnum_t cos2_ae_earth =  square(cos(ae));
+	const precnum_t sin2_ae_earth = square(sin(ae));
+
+	for (size_t i=0;i<nPts;i++)
+	{
+		const precnum_t lon  = DEG2RAD( precnum_t(in_lon_deg[i]) );
+		const precnum_t lat  = DEG2RAD( precnum_t(in_lat_deg[i]) );
+		const precnum_t slat = sin(lat), clat = cos(lat);
+
+		const precnum_t N = a / std::sqrt( 1 - sin2_ae_earth*square(slat) );
+
+		out_x[i] = (N+in_height[i])*clat*cos(lon);
+		out_y[i] = (N+in_height[i])*clat*sin(lon);
+		out_z[i] = (cos2_ae_earth*N+in_height[i])*slat;
+	}
+}
+
 /*---------------------------------------------------------------
 			geocentricToGeodetic
  ---------------------------------------------------------------*/
@@ -450,6 +609,76 @@ void  mrpt::topography::GeodeticToUTM(
 	out_UTM_latitude_band = Letra;
 }
 
+void  mrpt::topography::GeodeticToUTM(
+	const std::vector<double>  &in_latitude_degrees,
+	const std::vector<double>  &in_longitude_degrees,
+	std::vector<double>        &out_UTM_x,
+	std::vector<double>        &out_UTM_y,
+	std::vector<int>           &out_UTM_zone,
+	std::vector<char>          &out_UTM_latitude_band,
+	const TEllipsoid           &ellip )
+{
+	const size_t nPts = in_latitude_degrees.size();
+	ASSERT_(in_longitude_degrees.size()==nPts);
+	out_UTM_x.resize(nPts);
+	out_UTM_y.resize(nPts);
+	out_UTM_zone.resize(nPts);
+	out_UTM_latitude_band.resize(nPts);
+
+	// Latitude bands, 8 degrees each from -80 (the first and last ones are open):
+	static const char bands[] = "CDEFGHJKLMNPQRSTUVWX";
+
+	// Constants of the ellipsoid (see the single point version):
+	const double sa = ellip.sa;
+	const double sb = ellip.sb;
+	const double e2 = (sqrt((sa*sa) - (sb*sb)))/sb;
+	const double e2cuadrada = e2*e2;
+	const double c = ( sa*sa )/sb;
+	const double alfa = 0.75  * e2cuadrada;
+	const double beta = (5.0/3.0) * alfa*alfa;
+	const double gama = (35.0/27.0) * alfa*alfa*alfa;
+
+	for (size_t i=0;i<nPts;i++)
+	{
+		const double la = in_latitude_degrees[i], lo = in_longitude_degrees[i];
+
+		int band = static_cast<int>(std::floor((la+80)/8));
+		if (band<0) band=0;
+		if (band>19) band=19;
+		// Exact limits, despite round-off in the division:
+		if (band>0 && la<-80+8*band) band--;
+		else if (band<19 && la>=-80+8*(band+1)) band++;
+
+		const int Huso = mrpt::utils::fix( ( lo / 6 ) + 31);
+		const double lat = DEG2RAD(la);
+		const double deltaS = DEG2RAD(lo) - DEG2RAD(double( ( Huso * 6 ) - 183 ));
+
+		const double slat = sin(lat), clat = cos(lat), clat2 = clat*clat;
+		const double sDS = sin(deltaS), cDS = cos(deltaS);
+
+		const double a = clat * sDS;
+		const double epsilon = 0.5 * log( ( 1 +  a) / ( 1 - a ) );
+		const double nu = atan( (slat/clat) / cDS ) - lat;
+		const double v = ( c / sqrt( 1 + e2cuadrada * clat2 ) ) * 0.9996;
+		const double ta = 0.5 * e2cuadrada * square(epsilon) * clat2;
+		const double a1 = 2*slat*clat; // sin(2*lat)
+		const double a2 = a1 * clat2;
+		const double j2 = lat + 0.5*a1;
+		const double j4 = ( ( 3.0 * j2 ) + a2 ) / 4.0;
+		const double j6 = ( ( 5.0 * j4 ) + ( a2 * clat2 ) ) / 3.0;
+		const double Bm = 0.9996 * c * ( lat - alfa * j2 + beta * j4 - gama * j6 );
+
+		double yy = nu * v * ( 1 + ta ) + Bm;
+		if (yy<0)
+		   yy += 9999999;
+
+		out_UTM_x[i] = epsilon * v * ( 1 + ( ta / 3.0 ) ) + 500000;
+		out_UTM_y[i] = yy;
+		out_UTM_zone[i] = Huso;
+		out_UTM_latitude_band[i] = bands[band];
+	}
+}
+
 /**  7-parameter Bursa-Wolf transformation:
   *   [ X Y Z ]_WGS84 = [ dX dY dZ ] + ( 1 + dS ) [ 1 RZ -RY; -RZ 1 RX; RY -RX 1 ] [ X Y Z ]_local
   * \sa transform10params
@@ -466,6 +695,17 @@ void  mrpt::topography::transform7params(
 	o.z = d.dZ + scale*( p.x*d.Ry - p.y * d.Rx + p.z);
 }
 
+void  mrpt::topography::transform7params(
+	const std::vector<mrpt::math::TPoint3D>	&in_points,
+	const TDatum7Params						&d,
+	std::vector<mrpt::math::TPoint3D>		&out_points)
+{
+	const size_t N = in_points.size();
+	out_points.resize(N);
+	for (size_t i=0;i<N;i++)
+		transform7params(in_points[i],d,out_points[i]);
+}
+
 /**  7-parameter Bursa-Wolf transformation TOPCON:
   *   [ X Y Z ]_WGS84 = [ dX dY dZ ] + ( 1 + dS ) [ 1 RZ -RY; -RZ 1 RX; RY -RX 1 ] [ X Y Z ]_local
   * \sa transform10params
@@ -521,6 +761,26 @@ void  mrpt::topography::transformHelmert2D(
 	o.y = d.dY + scale*( px*sin(d.alpha) + py*cos(d.alpha)) + d.Yp;
 }
 
+void  mrpt::topography::transformHelmert2D(
+	const std::vector<mrpt::math::TPoint2D>	&p,
+	const TDatumHelmert2D					&d,
+	std::vector<mrpt::math::TPoint2D>		&o)
+{
+	const double scale = (1+d.dS);
+	const double sca = scale*cos(d.alpha), ssa = scale*sin(d.alpha);
+
+	const size_t N = p.size();
+	o.resize(N);
+	for (size_t i=0;i<N;i++)
+	{
+		const double px = p[i].x - d.Xp;
+		const double py = p[i].y - d.Yp;
+
+		o[i].x = d.dX + ( px*sca - py*ssa) + d.Xp;
+		o[i].y = d.dY + ( px*ssa + py*sca) + d.Yp;
+	}
+}
+
 /**  Helmert 2D transformation:
   *   [ X Y ]_WGS84 = [ dX dY ] + ( 1 + dS ) [ cos(alpha) -sin(alpha); sin(alpha) cos(alpha) ] [ X-Xp Y-Yp Z-Zp ]_local + [Xp Yp Zp]
   * \sa transformHelmert3D
@@ -547,6 +807,15 @@ void  mrpt::topography::transformHelmert3D(
 	transform7params( p, d2, o );
 }
 
+void  mrpt::topography::transformHelmert3D(
+	const std::vector<mrpt::math::TPoint3D>	&p,
+	const TDatumHelmert3D					&d,
+	std::vector<mrpt::math::TPoint3D>		&o)
+{
+	const TDatum7Params d2( d.dX, d.dY, d.dZ, -1*d.Rx, -1*d.Ry, -1*d.Rz, d.dS );
+	transform7params( p, d2, o );
+}
+
 /**  Helmert 3D transformation:
   *   [ X Y ]_WGS84 = [ dX dY ] + ( 1 + dS ) [ cos(alpha) -sin(alpha); sin(alpha) cos(alpha) ] [ X-Xp Y-Yp Z-Zp ]_local + [Xp Yp Zp]
   * \sa transformHelmert3D
@@ -75,3 +75,111 @@ TEST(TopographyConversion, geodeticToENU_WGS84 )
 	EXPECT_NEAR(P.z,A_height, 0.1e-3);
 
 }
+
+TEST(TopographyConversion, CGeodeticToENU_WGS84_vs_geodeticToENU_WGS84 )
+{
+	const TGeodeticCoords gps_ref(36.714459075,-4.4789588283333330,38.8887);
+	const mrpt::topography::CGeodeticToENU_WGS84 conv(gps_ref);
+
+	// Points near the origin (polynomial approximations) and far from it (exact trigonometric functions),
+	// including longitudes across the +-180deg meridian:
+	const double lats[] = { 36.716411055, 36.7, 36.75, 37.5, 10.0, -60.0 };
+	const double lons[] = { -4.475828390, -4.5, -4.44, -4.0, 175.0, -179.0 };
+	std::vector<double> vlat,vlon,vh;
+	for (size_t i=0;i<sizeof(lats)/sizeof(lats[0]);i++)
+	{
+		const TGeodeticCoords c(lats[i],lons[i],20.0+i);
+		vlat.push_back(c.lat); vlon.push_back(c.lon); vh.push_back(c.height);
+
+		TPoint3D P, P_true, geo;
+		TGeocentricCoords geo_true;
+		conv.convert(c,P,&geo);
+		mrpt::topography::geodeticToENU_WGS84(c,P_true,gps_ref);
+		mrpt::topography::geodeticToGeocentric_WGS84(c,geo_true);
+
+		EXPECT_NEAR(P.x,P_true.x, 1e-6);
+		EXPECT_NEAR(P.y,P_true.y, 1e-6);
+		EXPECT_NEAR(P.z,P_true.z, 1e-6);
+		EXPECT_NEAR(geo.x,geo_true.x, 1e-6);
+		EXPECT_NEAR(geo.y,geo_true.y, 1e-6);
+		EXPECT_NEAR(geo.z,geo_true.z, 1e-6);
+	}
+
+	std::vector<double> xs,ys,zs;
+	mrpt::topography::geodeticToENU_WGS84(vlat,vlon,vh, xs,ys,zs, gps_ref);
+	ASSERT_EQUAL_(xs.size(),vlat.size());
+	for (size_t i=0;i<vlat.size();i++)
+	{
+		TPoint3D P_true;
+		mrpt::topography::geodeticToENU_WGS84(TGeodeticCoords(vlat[i],vlon[i],vh[i]),P_true,gps_ref);
+		EXPECT_NEAR(xs[i],P_true.x, 1e-6);
+		EXPECT_NEAR(ys[i],P_true.y, 1e-6);
+		EXPECT_NEAR(zs[i],P_true.z, 1e-6);
+	}
+}
+
+TEST(TopographyConversion, BatchVsSinglePoint )
+{
+	std::vector<double> vlat,vlon,vh;
+	for (int i=-85;i<=85;i+=5)
+	{
+		vlat.push_back(i+0.123);
+		vlon.push_back(-179.5+2.1*(i+85));
+		vh.push_back(100.0+i);
+	}
+	const size_t N = vlat.size();
+
+	// Geocentric, with a non-WGS84 ellipsoid:
+	const TEllipsoid ellip = TEllipsoid::Ellipsoid_Hayford_1909();
+	std::vector<double> xs,ys,zs;
+	mrpt::topography::geodeticToGeocentric(vlat,vlon,vh, xs,ys,zs, ellip);
+	for (size_t i=0;i<N;i++)
+	{
+		TGeocentricCoords geo;
+		mrpt::topography::geodeticToGeocentric(TGeodeticCoords(vlat[i],vlon[i],vh[i]),geo,ellip);
+		EXPECT_NEAR(xs[i],geo.x, 1e-6);
+		EXPECT_NEAR(ys[i],geo.y, 1e-6);
+		EXPECT_NEAR(zs[i],geo.z, 1e-6);
+	}
+
+	// UTM:
+	std::vector<int> zones;
+	std::vector<char> bands;
+	mrpt::topography::GeodeticToUTM(vlat,vlon, xs,ys,zones,bands);
+	for (size_t i=0;i<N;i++)
+	{
+		double x,y;
+		int zone;
+		char band;
+		mrpt::topography::GeodeticToUTM(vlat[i],vlon[i], x,y,zone,band);
+		EXPECT_NEAR(xs[i],x, 1e-6);
+		EXPECT_NEAR(ys[i],y, 1e-6);
+		EXPECT_EQ(zones[i],zone);
+		EXPECT_EQ(bands[i],band);
+	}
+
+	// Helmert transformations:
+	std::vector<TPoint2D> pts2d, pts2d_out;
+	std::vector<TPoint3D> pts3d, pts3d_out;
+	for (size_t i=0;i<N;i++)
+	{
+		pts2d.push_back(TPoint2D(xs[i],ys[i]));
+		pts3d.push_back(TPoint3D(xs[i],ys[i],vh[i]));
+	}
+	const TDatumHelmert2D d2(10.0,-20.0,0.01,5e-6,1000.0,2000.0);
+	const TDatumHelmert3D d3(10.0,-20.0,5.0,1.0,-2.0,3.0,4.0);
+	mrpt::topography::transformHelmert2D(pts2d,d2,pts2d_out);
+	mrpt::topography::transformHelmert3D(pts3d,d3,pts3d_out);
+	for (size_t i=0;i<N;i++)
+	{
+		TPoint2D p2;
+		TPoint3D p3;
+		mrpt::topography::transformHelmert2D(pts2d[i],d2,p2);
+		mrpt::topography::transformHelmert3D(pts3d[i],d3,p3);
+		EXPECT_NEAR(pts2d_out[i].x,p2.x, 1e-6);
+		EXPECT_NEAR(pts2d_out[i].y,p2.y, 1e-6);
+		EXPECT_NEAR(pts3d_out[i].x,p3.x, 1e-6);
+		EXPECT_NEAR(pts3d_out[i].y,p3.y, 1e-6);
+		EXPECT_NEAR(pts3d_out[i].z,p3.z, 1e-6);
+	}
+}
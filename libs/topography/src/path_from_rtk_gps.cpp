@@ -15,6 +15,8 @@
 #include <mrpt/topography/data_types.h>
 #include <mrpt/topography/conversions.h>
 #include <mrpt/topography/path_from_rtk_gps.h>
+#include <mrpt/system/parallelization.h>
+#include <mrpt/utils/aligned_containers.h>
 
 #if MRPT_HAS_WXWIDGETS
 	#include <wx/app.h>
@@ -44,6 +46,144 @@ std::set<T> make_set( const T& v0, const T& v1 )
 	return s;
 }
 
+namespace
+{
+	// The list with all time ordered gps's in valid RTK mode
+	typedef std::map< mrpt::system::TTimeStamp, std::map<std::string,CObservationGPSPtr> > TListGPSs;
+
+	/** The vehicle pose estimated from the GPSs of one timestamp */
+	struct TRTKPoseEstimate
+	{
+		TRTKPoseEstimate() : valid(false), has_mahaD(false), mahaD(0) { }
+
+		bool            valid;     //!< false if there were less than 3 GPSs
+		CPose3DQuat     pose;
+		bool            has_mahaD;
+		double          mahaD;     //!< The consistency test Mahalanobis distance, if has_mahaD
+		CMatrixDouble66 cov;       //!< The pose uncertainty, if W_star was given
+
+		MRPT_MAKE_ALIGNED_OPERATOR_NEW
+	};
+	typedef mrpt::aligned_containers<TRTKPoseEstimate>::vector_t TRTKPoseEstimates;
+
+	/** Estimates the vehicle poses of a block of timestamps, independent of each other. */
+	struct TRTKPoseEstimator
+	{
+		const std::vector<TListGPSs::const_iterator> &entries;
+		const CGeodeticToENU_WGS84              &enu;
+		const std::map<std::string,TPoint3D>    &offsets;      //!< Sensor label -> offset correction (from "OFFSET_<label>")
+		const bool                               doConsistencyCheck;
+		const std::vector<std::string>          &D_cov_labels; //!< Sensor labels in the order of the D_cov matrix
+		const CVectorDouble                     &D_mean;
+		const CMatrixDouble                     &D_cov_1;
+		const bool                               doUncertaintyCovs;
+		const CMatrixDouble66                   &W_star;
+		TRTKPoseEstimates                       &estimates;
+
+		TRTKPoseEstimator(
+			const std::vector<TListGPSs::const_iterator> &_entries, const CGeodeticToENU_WGS84 &_enu, const std::map<std::string,TPoint3D> &_offsets,
+			const bool _doConsistencyCheck, const std::vector<std::string> &_D_cov_labels, const CVectorDouble &_D_mean, const CMatrixDouble &_D_cov_1,
+			const bool _doUncertaintyCovs, const CMatrixDouble66 &_W_star, TRTKPoseEstimates &_estimates) :
+			entries(_entries), enu(_enu), offsets(_offsets),
+			doConsistencyCheck(_doConsistencyCheck), D_cov_labels(_D_cov_labels), D_mean(_D_mean), D_cov_1(_D_cov_1),
+			doUncertaintyCovs(_doUncertaintyCovs), W_star(_W_star), estimates(_estimates)
+		{ }
+
+		void operator()(const mrpt::system::BlockedRange &r) const
+		{
+			for (int j=r.begin();j!=r.end();++j)
+				estimate(entries[j]->second, estimates[j]);
+		}
+
+		void estimate(const std::map<std::string, CObservationGPSPtr> &GPS, TRTKPoseEstimate &out) const
+		{
+			// Now check if we have 3 gps with the same time stamp:
+			const size_t N = GPS.size();
+			if (N<3) return;
+
+			CVectorDouble X(N),Y(N),Z(N); 	// Global XYZ coordinates
+			std::map<string,size_t> XYZidxs;  // Sensor label -> indices in X Y Z
+
+			// Compute the XYZ coordinates of all sensors:
+			TMatchingPairList corrs;
+			corrs.reserve(N);
+			unsigned int k;
+			std::map<std::string, CObservationGPSPtr>::const_iterator g_it;
+
+			for (k=0,g_it=GPS.begin();g_it!=GPS.end();++g_it,++k)
+			{
+				TPoint3D P;
+				enu.convert(g_it->second->getMsgByClass<gnss::Message_NMEA_GGA>().getAsStruct<TGeodeticCoords>(), P );
+
+				// Correction of offsets:
+				const std::map<std::string,TPoint3D>::const_iterator it_off = offsets.find(g_it->second->sensorLabel);
+				if (it_off!=offsets.end())
+				{
+					P.x += it_off->second.x;
+					P.y += it_off->second.y;
+					P.z += it_off->second.z;
+				}
+
+				XYZidxs[g_it->second->sensorLabel] = k; // Save index correspondence
+
+				// Create the correspondence:
+				corrs.push_back( TMatchingPair(
+					k,k, 	// Indices
+					P.x,P.y,P.z, // "This"/Global coords
+					g_it->second->sensorPose.x(),g_it->second->sensorPose.y(),g_it->second->sensorPose.z() // "other"/local coordinates
+					));
+
+				X[k] = P.x;
+				Y[k] = P.y;
+				Z[k] = P.z;
+			}
+
+			if (doConsistencyCheck && N==3)
+			{
+				// XYZ[k] have the k'd final coordinates of each GPS
+				// GPS[k] are the CObservations:
+
+				// Compute the inter-GPS square distances:
+				CVectorDouble iGPSdist2(3);
+
+				// [0]: sq dist between: D_cov_labels[0],D_cov_labels[1]
+				const size_t i0 = XYZidxs[D_cov_labels[0]], i1 = XYZidxs[D_cov_labels[1]], i2 = XYZidxs[D_cov_labels[2]];
+				TPoint3D   P0( X[i0], Y[i0], Z[i0] );
+				TPoint3D   P1( X[i1], Y[i1], Z[i1] );
+				TPoint3D   P2( X[i2], Y[i2], Z[i2] );
+
+				iGPSdist2[0] = P0.sqrDistanceTo(P1);
+				iGPSdist2[1] = P0.sqrDistanceTo(P2);
+				iGPSdist2[2] = P1.sqrDistanceTo(P2);
+
+				out.mahaD = mrpt::math::mahalanobisDistance( iGPSdist2, D_mean, D_cov_1 );
+				out.has_mahaD = true;
+			} // end consistency
+
+			// Use a 6D matching method to estimate the location of the vehicle:
+			double  optimal_scale;
+
+			// "this" (reference map) -> GPS global coordinates
+			// "other" -> GPS local coordinates on the vehicle
+			mrpt::tfest::se3_l2( corrs,out.pose,optimal_scale, true ); // Force scale=1
+			out.valid = true;
+
+			// If we have W_star, compute the pose uncertainty:
+			if (doUncertaintyCovs)
+			{
+				CPose3DPDFGaussian	final_veh_uncert;
+				final_veh_uncert.mean.setFromValues(0,0,0,0,0,0);
+				final_veh_uncert.cov = W_star;
+
+				// Rotate the covariance according to the real vehicle pose:
+				final_veh_uncert.changeCoordinatesReference(CPose3D(out.pose));
+
+				out.cov = final_veh_uncert.cov;
+			}
+		}
+	}; // end of TRTKPoseEstimator
+}
+
 /*---------------------------------------------------------------
 					path_from_rtk_gps
  ---------------------------------------------------------------*/
@@ -136,7 +276,6 @@ void  mrpt::topography::path_from_rtk_gps(
 #endif
 
 	// The list with all time ordered gps's in valid RTK mode
-	typedef std::map< mrpt::system::TTimeStamp, std::map<std::string,CObservationGPSPtr> > TListGPSs;
 	TListGPSs	list_gps_obs;
 
 	map<string,size_t>  GPS_RTK_reads;	// label-># of RTK readings
@@ -368,128 +507,100 @@ void  mrpt::topography::path_from_rtk_gps(
 	}
 #endif
 
-		int	idx_in_GPSs = 0;
-
-		for (TListGPSs::iterator i=list_gps_obs.begin();i!=list_gps_obs.end();++i, idx_in_GPSs++)
+		// Get the reference lat/lon, if it's not set from rawlog configuration block:
+		//  the first GPS of the first timestamp with at least 3 GPSs.
+		if (!ref_valid)
 		{
-			// Now check if we have 3 gps with the same time stamp:
-			if (i->second.size()>=3)
+			for (TListGPSs::const_iterator i=list_gps_obs.begin();i!=list_gps_obs.end();++i)
 			{
-				const size_t N = i->second.size();
-				std::map<std::string, CObservationGPSPtr> & GPS = i->second;
-				CVectorDouble X(N),Y(N),Z(N); 	// Global XYZ coordinates
-				std::map<string,size_t> XYZidxs;  // Sensor label -> indices in X Y Z
-
-				if (!ref_valid)	// get the reference lat/lon, if it's not set from rawlog configuration block.
+				if (i->second.size()>=3)
 				{
 					ref_valid 	= true;
-					ref = GPS.begin()->second->getMsgByClass<gnss::Message_NMEA_GGA>().getAsStruct<TGeodeticCoords>();
+					ref = i->second.begin()->second->getMsgByClass<gnss::Message_NMEA_GGA>().getAsStruct<TGeodeticCoords>();
+					break;
 				}
+			}
+		}
+		const CGeodeticToENU_WGS84 enu(ref);
 
-				// Compute the XYZ coordinates of all sensors:
-				TMatchingPairList corrs;
-				unsigned int k;
-				std::map<std::string, CObservationGPSPtr>::iterator g_it;
+		// Correction of offsets of each sensor:
+		map<string,TPoint3D>  GPS_offsets;
+		for (set<string>::const_iterator l=lstGPSLabels.begin();l!=lstGPSLabels.end();++l)
+		{
+			const string sect = string("OFFSET_")+*l;
+			GPS_offsets[*l] = TPoint3D(
+				memFil.read_double( sect, "x", 0 ),
+				memFil.read_double( sect, "y", 0 ),
+				memFil.read_double( sect, "z", 0 ) );
+		}
 
-				for (k=0,g_it=GPS.begin();g_it!=GPS.end();++g_it,++k)
-				{
-					TPoint3D P;
-					mrpt::topography::geodeticToENU_WGS84(
-						g_it->second->getMsgByClass<gnss::Message_NMEA_GGA>().getAsStruct<TGeodeticCoords>(),
-						P,
-						ref );
-
-					// Correction of offsets:
-					const string sect = string("OFFSET_")+g_it->second->sensorLabel;
-					P.x += memFil.read_double( sect, "x", 0 );
-					P.y += memFil.read_double( sect, "y", 0 );
-					P.z += memFil.read_double( sect, "z", 0 );
-
-					XYZidxs[g_it->second->sensorLabel] = k; // Save index correspondence
-
-					// Create the correspondence:
-					corrs.push_back( TMatchingPair(
-						k,k, 	// Indices
-						P.x,P.y,P.z, // "This"/Global coords
-						g_it->second->sensorPose.x(),g_it->second->sensorPose.y(),g_it->second->sensorPose.z() // "other"/local coordinates
-						));
-
-					X[k] = P.x;
-					Y[k] = P.y;
-					Z[k] = P.z;
-				}
+		vector<string> D_cov_labels;
+		for (map<size_t,string>::const_iterator it=D_cov_rev_indexes.begin();it!=D_cov_rev_indexes.end();++it)
+			D_cov_labels.push_back(it->second);
 
-				if (doConsistencyCheck && GPS.size()==3)
-				{
-					// XYZ[k] have the k'd final coordinates of each GPS
-					// GPS[k] are the CObservations:
-
-					// Compute the inter-GPS square distances:
-					CVectorDouble iGPSdist2(3);
-
-					// [0]: sq dist between: D_cov_rev_indexes[0],D_cov_rev_indexes[1]
-					TPoint3D   P0( X[XYZidxs[D_cov_rev_indexes[0]]], Y[XYZidxs[D_cov_rev_indexes[0]]], Z[XYZidxs[D_cov_rev_indexes[0]]] );
-					TPoint3D   P1( X[XYZidxs[D_cov_rev_indexes[1]]], Y[XYZidxs[D_cov_rev_indexes[1]]], Z[XYZidxs[D_cov_rev_indexes[1]]] );
-					TPoint3D   P2( X[XYZidxs[D_cov_rev_indexes[2]]], Y[XYZidxs[D_cov_rev_indexes[2]]], Z[XYZidxs[D_cov_rev_indexes[2]]] );
-
-					iGPSdist2[0] = P0.sqrDistanceTo(P1);
-					iGPSdist2[1] = P0.sqrDistanceTo(P2);
-					iGPSdist2[2] = P1.sqrDistanceTo(P2);
-
-					double mahaD = mrpt::math::mahalanobisDistance( iGPSdist2, D_mean, D_cov_1 );
-					outInfoTemp.mahalabis_quality_measure[i->first] = mahaD;
-
-					//cout << "x: " << iGPSdist2 << " MU: " <<  D_mean << " -> " << mahaD  << endl;
-				} // end consistency
-
-				// Use a 6D matching method to estimate the location of the vehicle:
-				CPose3DQuat optimal_pose;
-				double  optimal_scale;
-
-				// "this" (reference map) -> GPS global coordinates
-				// "other" -> GPS local coordinates on the vehicle
-				mrpt::tfest::se3_l2( corrs,optimal_pose,optimal_scale, true ); // Force scale=1
-				//cout << "optimal pose: " << optimal_pose << " " << optimal_scale << endl;
-				MRPT_CHECK_NORMAL_NUMBER( optimal_pose.x() );
-				MRPT_CHECK_NORMAL_NUMBER( optimal_pose.y() );
-				MRPT_CHECK_NORMAL_NUMBER( optimal_pose.z() );
-				MRPT_CHECK_NORMAL_NUMBER( optimal_pose.quat().x() );
-				MRPT_CHECK_NORMAL_NUMBER( optimal_pose.quat().y() );
-				MRPT_CHECK_NORMAL_NUMBER( optimal_pose.quat().z() );
-				MRPT_CHECK_NORMAL_NUMBER( optimal_pose.quat().r() );
-
-				// Final vehicle pose:
-				const CPose3D veh_pose= optimal_pose;
-
-				// Add to the interpolator:
-				robot_path.insert( i->first, veh_pose );
-
-				// If we have W_star, compute the pose uncertainty:
-				if (doUncertaintyCovs)
-				{
-					CPose3DPDFGaussian	final_veh_uncert;
-					final_veh_uncert.mean.setFromValues(0,0,0,0,0,0);
-					final_veh_uncert.cov = outInfoTemp.W_star;
+		CMatrixDouble66 W_star;
+		if (doUncertaintyCovs)
+			W_star = outInfoTemp.W_star;
 
-					// Rotate the covariance according to the real vehicle pose:
-					final_veh_uncert.changeCoordinatesReference(veh_pose);
+		// The pose of each timestamp only depends on its own GPSs: estimate them in parallel, in blocks
+		//  so the progress dialog can be updated in between.
+		const size_t BLOCK_SIZE = 500;
+		vector<TListGPSs::const_iterator> block_entries;
+		block_entries.reserve(BLOCK_SIZE);
+		TRTKPoseEstimates block_estimates;
 
-					outInfoTemp.vehicle_uncertainty[ i->first ] = final_veh_uncert.cov;
+		int	idx_in_GPSs = 0;
+
+		for (TListGPSs::const_iterator i=list_gps_obs.begin();i!=list_gps_obs.end(); )
+		{
+			block_entries.clear();
+			for ( ;i!=list_gps_obs.end() && block_entries.size()<BLOCK_SIZE;++i)
+				block_entries.push_back(i);
+
+			block_estimates.assign(block_entries.size(), TRTKPoseEstimate());
+			mrpt::system::parallel_for(
+				mrpt::system::BlockedRange(0,static_cast<int>(block_entries.size())),
+				TRTKPoseEstimator(block_entries,enu,GPS_offsets, doConsistencyCheck,D_cov_labels,D_mean,D_cov_1, doUncertaintyCovs,W_star, block_estimates) );
+
+			// Collect the results, in time order:
+			for (size_t j=0;j<block_entries.size();j++, idx_in_GPSs++)
+			{
+				const TRTKPoseEstimate &est = block_estimates[j];
+				const TTimeStamp t = block_entries[j]->first;
+				if (est.valid)
+				{
+					if (est.has_mahaD)
+						outInfoTemp.mahalabis_quality_measure[t] = est.mahaD;
+
+					const CPose3DQuat &optimal_pose = est.pose;
+					MRPT_CHECK_NORMAL_NUMBER( optimal_pose.x() );
+					MRPT_CHECK_NORMAL_NUMBER( optimal_pose.y() );
+					MRPT_CHECK_NORMAL_NUMBER( optimal_pose.z() );
+					MRPT_CHECK_NORMAL_NUMBER( optimal_pose.quat().x() );
+					MRPT_CHECK_NORMAL_NUMBER( optimal_pose.quat().y() );
+					MRPT_CHECK_NORMAL_NUMBER( optimal_pose.quat().z() );
+					MRPT_CHECK_NORMAL_NUMBER( optimal_pose.quat().r() );
+
+					// Final vehicle pose:
+					const CPose3D veh_pose= optimal_pose;
+
+					// Add to the interpolator:
+					robot_path.insert( t, veh_pose );
+
+					if (doUncertaintyCovs)
+						outInfoTemp.vehicle_uncertainty[ t ] = est.cov;
 				}
 			}
 
 			// Show progress:
-			if ((count++ % 100)==0)
-			{
 #if MRPT_HAS_WXWIDGETS
-				if (progDia3)
-				{
-					if (!progDia3->Update(idx_in_GPSs))
-						abort = true;
-					wxTheApp->Yield();
-				}
-#endif
+			if (progDia3)
+			{
+				if (!progDia3->Update(idx_in_GPSs))
+					abort = true;
+				wxTheApp->Yield();
 			}
+#endif
 		} // end for i
 
 #if MRPT_HAS_WXWIDGETS
@@ -574,14 +685,14 @@ void  mrpt::topography::path_from_rtk_gps(
 		const double off_Z = memFil.read_double( sect, "z", 0 );
 
 		// map<TTimeStamp,TPoint3D> best_gps_path;		// time -> 3D local coords
+		const CGeodeticToENU_WGS84 enu(ref);
 		for (map<TTimeStamp,TPoint3D>::iterator i=outInfoTemp.best_gps_path.begin();i!=outInfoTemp.best_gps_path.end();++i)
 		{
 			TPoint3D P;
 			TPoint3D &pl = i->second;
-			mrpt::topography::geodeticToENU_WGS84(
+			enu.convert(
 				TGeodeticCoords(pl.x,pl.y,pl.z),  // i->second.x,i->second.y,i->second.z, // lat, lon, heigh
-				P, // X Y Z
-				ref );
+				P ); // X Y Z
 
 			pl.x = P.x + off_X;
 			pl.y = P.y + off_Y;
@@ -156,6 +156,11 @@ namespace mrpt
 			  * It also calculates the least-square covariance matrix */
 			void solveOneLevel();
 
+			/** Computes the weights (like computeWeights()) and solves the odometry at the current level (like solveOneLevel()) in one single
+			  * sweep over the image, accumulating the normal equations of the least squares problem in parallel for blocks of columns.
+			  * The system is only solved if there are enough valid points. */
+			void computeWeightsAndSolveOneLevel();
+
 			/** Method to filter the velocity at each level of the pyramid. */
 			void filterLevelSolution();
 
@@ -182,6 +187,10 @@ namespace mrpt
 			/** Execution time (ms) */
 			float execution_time;
 
+			/** Execution time (ms) of each coarse-to-fine level in the last call to odometryCalculation(), from the coarsest to the finest one.
+			  * The difference between their sum and execution_time is the time spent building the image pyramid and updating the pose. */
+			std::vector<float> level_execution_time;
+
 			/** Camera poses */
 			mrpt::poses::CPose3D cam_pose;		//!< Last camera pose
 			mrpt::poses::CPose3D cam_oldpose;	//!< Previous camera pose
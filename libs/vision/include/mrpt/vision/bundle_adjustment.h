@@ -56,8 +56,15 @@ namespace mrpt
 		  *		- "mu": Initial mu for LevMarq (default=-1 -> autoguess)
 		  *		- "num_fix_frames": Number of first frame poses to don't optimize (keep unmodified as they come in)  (default=1: the first pose is the reference and is not modified)
 		  *		- "num_fix_points": Idem, for the landmarks positions (default=0: optimize all)
+		  *		- "local_window": If >0, local (windowed) BA: only the last "local_window" frame poses (those with the highest IDs) and the landmarks observed from them
+		  *		   are optimized, while all the other frames and landmarks are kept fixed, although their observations of the optimized landmarks are still used.
+		  *		   The returned error, and the data passed to \a user_feedback, only refer to the observations of the optimized landmarks. (default=0: optimize all)
 		  *		- "profiler": If !=0, displays profiling information to the console at return.
 		  *
+		  * The frame-point blocks of the Hessian are stored in flat arrays indexed by observation, the Jacobians, the landmark blocks and the Schur complement
+		  *  (the reduced camera system) are evaluated in parallel (if MRPT is built with TBB), and the symbolic Cholesky factorization of the reduced camera system
+		  *  is computed once and reused in all the iterations.
+		  *
 		  * \note In this function, all coordinates are absolute. Camera frames are such that +Z points forward from the focal point (see the figure in mrpt::obs::CObservationImage).
 		  * \note The first frame pose will be not updated since at least one frame must remain fixed.
 		  *
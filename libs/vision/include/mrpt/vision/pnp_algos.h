@@ -13,6 +13,7 @@
 
 #include <Eigen/Core>
 #include <Eigen/Dense>
+#include <vector>
 
 namespace mrpt
 {
@@ -152,6 +153,36 @@ namespace mrpt
                      * @return 
                      */
                     bool so3(const Eigen::Ref<Eigen::MatrixXd> obj_pts, const Eigen::Ref<Eigen::MatrixXd> img_pts, int n, const Eigen::Ref<Eigen::MatrixXd> cam_intrinsic, Eigen::Ref<Eigen::MatrixXd> pose_mat);
+
+                    /** The PnP algorithms, for solve_batch() */
+                    enum TAlgorithm
+                    {
+                        DLS = 0,
+                        EPNP,
+                        UPNP,
+                        P3P,
+                        RPNP,
+                        PPNP,
+                        POSIT,
+                        LHM,
+                        SO3
+                    };
+
+                    /**
+                     * @brief Solves K independent PnP problems with the same number of correspondences, in parallel (if MRPT is built with TBB).
+                     *        P3P, and EPnP with n<=8 (which then does not require OpenCV), are solved with specialized kernels which work on
+                     *        fixed-size matrices on the stack; the rest of algorithms use the same code than their single-problem methods.
+                     *
+                     * @param[in] algo The algorithm to use
+                     * @param[in] obj_pts Object points of all problems, 3X(K*n) array: columns k*n to (k+1)*n-1 are the points of the k'th problem
+                     * @param[in] img_pts Image points of all problems, 3X(K*n) array [u, v, 1], with the same layout than obj_pts
+                     * @param[in] n number of 2D-3D correspondences of each problem
+                     * @param[in] cam_intrinsic Camera Intrinsic matrix, common to all problems
+                     * @param[out] pose_mats Output pose vectors 6XK, one column per problem with the same format than pose_mat in the single-problem methods
+                     * @param[out] out_success If not NULL, it is resized to K and filled with the success flag of each problem
+                     * @return number of problems solved successfully
+                     */
+                    int solve_batch(TAlgorithm algo, const Eigen::Ref<Eigen::MatrixXd> obj_pts, const Eigen::Ref<Eigen::MatrixXd> img_pts, int n, const Eigen::Ref<Eigen::MatrixXd> cam_intrinsic, Eigen::Ref<Eigen::MatrixXd> pose_mats, std::vector<bool> *out_success = NULL);
             };
             
             /** @}  */ // end of grouping
@@ -13,6 +13,7 @@
 #include <mrpt/utils/utils_defs.h>
 #include <mrpt/utils/CTicTac.h>
 #include <mrpt/utils/round.h>
+#include <mrpt/system/parallelization.h>
 
 using namespace mrpt;
 using namespace mrpt::vision;
@@ -103,43 +104,137 @@ CDifodo::CDifodo()
 			g_mask[i][j] = v_mask2[i]*v_mask2[j]/256.f;
 }
 
-void CDifodo::buildCoordinatesPyramid()
+namespace
 {
-	const float max_depth_dif = 0.1f;
+	/** The images of the level being solved, shared by the per-column tasks below. All the loops run column by column,
+	  *  since Eigen matrices are stored in column-major order. */
+	struct TLevelImages
+	{
+		const MatrixXf *depth_old, *xx_old, *yy_old;
+		const MatrixXf *depth_warped, *xx_warped, *yy_warped;
+		MatrixXf *depth_inter, *xx_inter, *yy_inter;
+		Matrix<bool, Dynamic, Dynamic> *null;
+		MatrixXf *du, *dv, *dt;
+		MatrixXf *weights;
+		unsigned int rows, cols;
+	};
+
+	TLevelImages makeLevelImages(
+		const std::vector<MatrixXf> &depth_old, const std::vector<MatrixXf> &xx_old, const std::vector<MatrixXf> &yy_old,
+		const std::vector<MatrixXf> &depth_warped, const std::vector<MatrixXf> &xx_warped, const std::vector<MatrixXf> &yy_warped,
+		std::vector<MatrixXf> &depth_inter, std::vector<MatrixXf> &xx_inter, std::vector<MatrixXf> &yy_inter,
+		const unsigned int image_level, Matrix<bool, Dynamic, Dynamic> &null,
+		MatrixXf &du, MatrixXf &dv, MatrixXf &dt, MatrixXf &weights, unsigned int rows_i, unsigned int cols_i)
+	{
+		const TLevelImages im = {
+			&depth_old[image_level], &xx_old[image_level], &yy_old[image_level],
+			&depth_warped[image_level], &xx_warped[image_level], &yy_warped[image_level],
+			&depth_inter[image_level], &xx_inter[image_level], &yy_inter[image_level],
+			&null, &du, &dv, &dt, &weights, rows_i, cols_i };
+		return im;
+	}
 
-	//Push coordinates back
-	depth_old.swap(depth);
-	xx_old.swap(xx);
-	yy_old.swap(yy);
+	/** Velocity associated to the rigid transformation estimated up to the given level */
+	Matrix<float,6,1> velocityUpToLevel(const Matrix<float,6,1> &kai_loc_old, const std::vector<MatrixXf> &transformations, const unsigned int level, const float fps)
+	{
+		Matrix<float,6,1> kai_level = kai_loc_old;
+
+		Matrix4f acu_trans;
+		acu_trans.setIdentity();
+		for (unsigned int i=0; i<level; i++)
+			acu_trans = transformations[i]*acu_trans;
+
+		//Alternative way to compute the log
+		CMatrixDouble44 mat_aux = acu_trans.cast<double>();
+		poses::CPose3D aux(mat_aux);
+		CArrayDouble<6> kai_level_acu = aux.ln()*fps;
+		kai_level -= kai_level_acu.cast<float>();
+		return kai_level;
+	}
 
-	//The number of levels of the pyramid does not match the number of levels used
-	//in the odometry computation (because we might want to finish with lower resolutions)
+	/** Solves the weighted least squares problem from its augmented normal equations (see TWeightsAndNormalEquations),
+	  *  and gets the least-square covariance matrix */
+	void solveNormalEquations(const Matrix<double,8,8,DontAlign> &M, const unsigned int num_valid_points, Matrix<float,6,1> &kai_loc_level, Matrix<float,6,6> &est_cov)
+	{
+		const Matrix<double,6,6> AtA = M.topLeftCorner<6,6>();
+		const Matrix<double,6,1> AtB = M.block<6,1>(0,6);
+		const Matrix<double,6,1> Var = AtA.ldlt().solve(AtB);
 
-	unsigned int pyr_levels = round(log(float(width/cols))/log(2.f)) + ctf_levels;
+		//Covariance matrix calculation: |A*Var-B|^2 = B^T*B - Var^T*A^T*B, since A^T*A*Var = A^T*B
+		const double res2 = std::max(0.0, M(6,6) - Var.dot(AtB));
+		est_cov = ((res2/double(num_valid_points-6))*AtA.inverse()).cast<float>();
 
-	//Generate levels
-	for (unsigned int i = 0; i<pyr_levels; i++)
+		//Update last velocity in local coordinates
+		kai_loc_level = Var.cast<float>();
+	}
+
+	/** Columns are processed in blocks of this size by each task */
+	const int COLUMNS_GRAIN_SIZE = 8;
+
+	/** Coordinates "xy" of the points of a pyramid level, from their depths */
+	inline void computeCoordinates(const MatrixXf &depth, MatrixXf &xx, MatrixXf &yy, unsigned int u, unsigned int rows_i, float inv_f_i, float disp_u_i, float disp_v_i)
 	{
-		unsigned int s = pow(2.f,int(i));
-		cols_i = width/s;
-		rows_i = height/s;
-		const int rows_i2 = 2*rows_i;
-		const int cols_i2 = 2*cols_i;
-		const int i_1 = i-1;
+		const float x_factor = (u - disp_u_i)*inv_f_i;
+		for (unsigned int v = 0; v < rows_i; v++)
+		{
+			const float z = depth(v,u);
+			if (z > 0.f)
+			{
+				xx(v,u) = x_factor*z;
+				yy(v,u) = (v - disp_v_i)*z*inv_f_i;
+			}
+			else
+			{
+				xx(v,u) = 0.f;
+				yy(v,u) = 0.f;
+			}
+		}
+	}
 
-		if (i == 0)
-			depth[i].swap(depth_wf);
+	/** Computes one level of the pyramid (depths and coordinates) from the previous one (src=NULL: only the coordinates) */
+	struct TPyramidLevel
+	{
+		const MatrixXf *src;
+		MatrixXf &depth, &xx, &yy;
+		const bool fast;
+		const Matrix4f &f_mask;
+		const float (*g_mask)[5];
+		const unsigned int rows_i, cols_i;
+		const float inv_f_i, disp_u_i, disp_v_i;
+
+		TPyramidLevel(const MatrixXf *src_, MatrixXf &depth_, MatrixXf &xx_, MatrixXf &yy_, bool fast_, const Matrix4f &f_mask_, const float (*g_mask_)[5], unsigned int rows_i_, unsigned int cols_i_, float fovh) :
+			src(src_), depth(depth_), xx(xx_), yy(yy_), fast(fast_), f_mask(f_mask_), g_mask(g_mask_), rows_i(rows_i_), cols_i(cols_i_),
+			inv_f_i(2.f*tan(0.5f*fovh)/float(cols_i_)),
+			disp_u_i(0.5f*(cols_i_-1)),
+			disp_v_i(0.5f*(rows_i_-1))
+		{
+		}
 
-		//                              Downsampling
-		//-----------------------------------------------------------------------------
-		else
+		void operator()(const mrpt::system::BlockedRange &range) const
+		{
+			for (unsigned int u = range.begin(); u < static_cast<unsigned int>(range.end()); u++)
+			{
+				if (src)
+				{
+					if (fast)	downsampleColumnFast(u);
+					else		downsampleColumn(u);
+				}
+				computeCoordinates(depth,xx,yy,u,rows_i,inv_f_i,disp_u_i,disp_v_i);
+			}
+		}
+
+		void downsampleColumn(const unsigned int u) const
 		{
-			for (unsigned int u = 0; u < cols_i; u++)
+			const float max_depth_dif = 0.1f;
+			const int rows_i2 = 2*rows_i;
+			const int cols_i2 = 2*cols_i;
+			const MatrixXf &d_src = *src;
+
 			for (unsigned int v = 0; v < rows_i; v++)
 			{
 				const int u2 = 2*u;
 				const int v2 = 2*v;
-				const float dcenter = depth[i_1](v2,u2);
+				const float dcenter = d_src(v2,u2);
 
 				//Inner pixels
 				if ((v>0)&&(v<rows_i-1)&&(u>0)&&(u<cols_i-1))
@@ -152,15 +247,15 @@ void CDifodo::buildCoordinatesPyramid()
 						for (int l = -2; l<3; l++)
 						for (int k = -2; k<3; k++)
 						{
-							const float abs_dif = abs(depth[i_1](v2+k,u2+l)-dcenter);
+							const float abs_dif = abs(d_src(v2+k,u2+l)-dcenter);
 							if (abs_dif < max_depth_dif)
 							{
 								const float aux_w = g_mask[2+k][2+l]*(max_depth_dif - abs_dif);
 								weight += aux_w;
-								sum += aux_w*depth[i_1](v2+k,u2+l);
+								sum += aux_w*d_src(v2+k,u2+l);
 							}
 						}
-						depth[i](v,u) = sum/weight;
+						depth(v,u) = sum/weight;
 					}
 					else
 					{
@@ -168,15 +263,15 @@ void CDifodo::buildCoordinatesPyramid()
 						for (int l = -2; l<3; l++)
 						for (int k = -2; k<3; k++)
 						{
-							const float d = depth[i_1](v2+k,u2+l);
+							const float d = d_src(v2+k,u2+l);
 							if ((d > 0.f)&&(d < min_depth))
 								min_depth = d;
 						}
 
 						if (min_depth < 10.f)
-							depth[i](v,u) = min_depth;
+							depth(v,u) = min_depth;
 						else
-							depth[i](v,u) = 0.f;
+							depth(v,u) = 0.f;
 					}
 				}
 
@@ -194,16 +289,16 @@ void CDifodo::buildCoordinatesPyramid()
 							const int indv = v2+k,indu = u2+l;
 							if ((indv>=0)&&(indv<rows_i2)&&(indu>=0)&&(indu<cols_i2))
 							{
-								const float abs_dif = abs(depth[i_1](indv,indu)-dcenter);
+								const float abs_dif = abs(d_src(indv,indu)-dcenter);
 								if (abs_dif < max_depth_dif)
 								{
 									const float aux_w = g_mask[2+k][2+l]*(max_depth_dif - abs_dif);
 									weight += aux_w;
-									sum += aux_w*depth[i_1](indv,indu);
+									sum += aux_w*d_src(indv,indu);
 								}
 							}
 						}
-						depth[i](v,u) = sum/weight;
+						depth(v,u) = sum/weight;
 					}
 					else
 					{
@@ -214,45 +309,344 @@ void CDifodo::buildCoordinatesPyramid()
 							const int indv = v2+k,indu = u2+l;
 							if ((indv>=0)&&(indv<rows_i2)&&(indu>=0)&&(indu<cols_i2))
 							{
-								const float d = depth[i_1](indv,indu);
+								const float d = d_src(indv,indu);
 								if ((d > 0.f)&&(d < min_depth))
 									min_depth = d;
 							}
 						}
 
 						if (min_depth < 10.f)
-							depth[i](v,u) = min_depth;
+							depth(v,u) = min_depth;
 						else
-							depth[i](v,u) = 0.f;
+							depth(v,u) = 0.f;
 					}
 				}
 			}
 		}
 
-		//Calculate coordinates "xy" of the points
-		const float inv_f_i = 2.f*tan(0.5f*fovh)/float(cols_i);
-		const float disp_u_i = 0.5f*(cols_i-1);
-		const float disp_v_i = 0.5f*(rows_i-1);
+		void downsampleColumnFast(const unsigned int u) const
+		{
+			const float max_depth_dif = 0.1f;
+			const MatrixXf &d_src = *src;
 
-		for (unsigned int u = 0; u < cols_i; u++)
-		for (unsigned int v = 0; v < rows_i; v++)
-		if (depth[i](v,u) > 0.f)
+			for (unsigned int v = 0; v < rows_i; v++)
+			{
+				const int u2 = 2*u;
+				const int v2 = 2*v;
+
+				//Inner pixels
+				if ((v>0)&&(v<rows_i-1)&&(u>0)&&(u<cols_i-1))
+				{
+					const Matrix4f d_block = d_src.block<4,4>(v2-1,u2-1);
+					float depths[4] = {d_block(5),d_block(6),d_block(9),d_block(10)};
+					float dcenter;
+
+					//Sort the array (try to find a good/representative value)
+					for (signed char k = 2; k>=0; k--)
+					if (depths[k+1] < depths[k])
+						std::swap(depths[k+1],depths[k]);
+					for (unsigned char k = 1; k<3; k++)
+					if (depths[k] > depths[k+1])
+						std::swap(depths[k+1],depths[k]);
+					if (depths[2] < depths[1])
+						dcenter = depths[1];
+					else
+						dcenter = depths[2];
+
+					if (dcenter > 0.f)
+					{
+						float sum = 0.f;
+						float weight = 0.f;
+
+						for (unsigned char k = 0; k<16; k++)
+						{
+							const float abs_dif = abs(d_block(k) - dcenter);
+							if (abs_dif < max_depth_dif)
+							{
+								const float aux_w = f_mask(k)*(max_depth_dif - abs_dif);
+								weight += aux_w;
+								sum += aux_w*d_block(k);
+							}
+						}
+						depth(v,u) = sum/weight;
+					}
+					else
+						depth(v,u) = 0.f;
+				}
+
+				//Boundary
+				else
+				{
+					const Matrix2f d_block = d_src.block<2,2>(v2,u2);
+					const float new_d = 0.25f*d_block.sumAll();
+					if (new_d < 0.4f)
+						depth(v,u) = 0.f;
+					else
+						depth(v,u) = new_d;
+				}
+			}
+		}
+	};
+
+	/** "Average" coordinates between the old and the warped images, and null measurements. Counts the valid (not null) inner points. */
+	struct TCalculateCoord
+	{
+		const TLevelImages &im;
+		unsigned int num_valid_points;
+
+		TCalculateCoord(const TLevelImages &im_) : im(im_), num_valid_points(0) { }
+		TCalculateCoord(TCalculateCoord &o, mrpt::system::Split) : im(o.im), num_valid_points(0) { }
+		void join(const TCalculateCoord &o) { num_valid_points += o.num_valid_points; }
+
+		void operator()(const mrpt::system::BlockedRange &range)
 		{
-			xx[i](v,u) = (u - disp_u_i)*depth[i](v,u)*inv_f_i;
-			yy[i](v,u) = (v - disp_v_i)*depth[i](v,u)*inv_f_i;
+			const MatrixXf &depth_old = *im.depth_old, &depth_warped = *im.depth_warped;
+			MatrixXf &depth_inter = *im.depth_inter, &xx_inter = *im.xx_inter, &yy_inter = *im.yy_inter;
+			Matrix<bool, Dynamic, Dynamic> &null = *im.null;
+
+			for (unsigned int u = range.begin(); u < static_cast<unsigned int>(range.end()); u++)
+				for (unsigned int v = 0; v < im.rows; v++)
+				{
+					if ((depth_old(v,u) == 0.f) || (depth_warped(v,u) == 0.f))
+					{
+						depth_inter(v,u) = 0.f;
+						xx_inter(v,u) = 0.f;
+						yy_inter(v,u) = 0.f;
+						null(v,u) = true;
+					}
+					else
+					{
+						depth_inter(v,u) = 0.5f*(depth_old(v,u) + depth_warped(v,u));
+						xx_inter(v,u) = 0.5f*((*im.xx_old)(v,u) + (*im.xx_warped)(v,u));
+						yy_inter(v,u) = 0.5f*((*im.yy_old)(v,u) + (*im.yy_warped)(v,u));
+						null(v,u) = false;
+						if ((u>0)&&(v>0)&&(u<im.cols-1)&&(v<im.rows-1))
+							num_valid_points++;
+					}
+				}
 		}
-		else
+	};
+
+	/** Depth derivatives respect to u,v and t. The connectivity along rows of each column is only kept for the
+	  *  previous column, so each task only needs the columns in its range (plus the previous one). */
+	struct TDepthDerivatives
+	{
+		const TLevelImages &im;
+		const float fps;
+
+		TDepthDerivatives(const TLevelImages &im_, float fps_) : im(im_), fps(fps_) { }
+
+		/** Connectivity between the pixels (v,u) and (v,u+1) */
+		void computeRowConnectivity(const unsigned int u, std::vector<float> &rx_ninv) const
 		{
-			xx[i](v,u) = 0.f;
-			yy[i](v,u) = 0.f;
+			const MatrixXf &depth_inter = *im.depth_inter, &xx_inter = *im.xx_inter;
+			for (unsigned int v = 0; v < im.rows; v++)
+			{
+				if ((u+1 < im.cols) && ((*im.null)(v,u) == false))
+						rx_ninv[v] = sqrtf(square(xx_inter(v,u+1) - xx_inter(v,u)) + square(depth_inter(v,u+1) - depth_inter(v,u)));
+				else	rx_ninv[v] = 1.f;
+			}
 		}
-	}
+
+		void operator()(const mrpt::system::BlockedRange &range) const
+		{
+			const unsigned int rows = im.rows, cols = im.cols;
+			const MatrixXf &depth_inter = *im.depth_inter, &yy_inter = *im.yy_inter;
+			const MatrixXf &depth_old = *im.depth_old, &depth_warped = *im.depth_warped;
+			const Matrix<bool, Dynamic, Dynamic> &null = *im.null;
+			MatrixXf &du = *im.du, &dv = *im.dv, &dt = *im.dt;
+
+			std::vector<float> rx_ninv_prev(rows), rx_ninv(rows);
+			if (range.begin()>0)
+				computeRowConnectivity(range.begin()-1,rx_ninv_prev);
+
+			for (unsigned int u = range.begin(); u < static_cast<unsigned int>(range.end()); u++)
+			{
+				computeRowConnectivity(u,rx_ninv);
+				const bool inner_u = (u>0)&&(u<cols-1);
+
+				float ry_ninv_prev = 1.f;
+				for (unsigned int v = 0; v < rows; v++)
+				{
+					const bool is_null = null(v,u);
+					const float d = depth_inter(v,u);
+
+					//Connectivity between (v,u) and (v+1,u)
+					const float ry_ninv = ((v+1 < rows) && !is_null) ? sqrtf(square(yy_inter(v+1,u) - yy_inter(v,u)) + square(depth_inter(v+1,u) - d)) : 1.f;
+
+					if (is_null)
+					{
+						if (inner_u) du(v,u) = 0.f;
+						dv(v,u) = 0.f;
+						dt(v,u) = 0.f;
+					}
+					else
+					{
+						//Spatial derivatives
+						if (inner_u)
+							du(v,u) = (rx_ninv_prev[v]*(depth_inter(v,u+1) - d) + rx_ninv[v]*(d - depth_inter(v,u-1)))/(rx_ninv[v] + rx_ninv_prev[v]);
+						if ((v>0)&&(v<rows-1))
+								dv(v,u) = (ry_ninv_prev*(depth_inter(v+1,u) - d) + ry_ninv*(d - depth_inter(v-1,u)))/(ry_ninv + ry_ninv_prev);
+						else	dv(v,u) = 0.f;
+
+						//Temporal derivative
+						dt(v,u) = fps*(depth_warped(v,u) - depth_old(v,u));
+					}
+					ry_ninv_prev = ry_ninv;
+				}
+
+				dv(0,u) = dv(1,u);
+				dv(rows-1,u) = dv(rows-2,u);
+
+				rx_ninv_prev.swap(rx_ninv);
+			}
+		}
+	};
+
+	/** Weights of the range flow constraint equations and/or accumulation of the normal equations of the
+	  *  weighted least squares problem, in one sweep over the inner pixels.
+	  *  Each equation is stored as the augmented row [A_i B_i 0], so the 8x8 matrix M = sum([A_i B_i 0]^T * [A_i B_i 0])
+	  *  holds A^T*A, A^T*B and B^T*B, and its accumulation is a SIMD-friendly rank-1 update. */
+	struct TWeightsAndNormalEquations
+	{
+		const TLevelImages &im;
+		const bool compute_weights, accumulate;
+		const float f_inv, fps;
+		const Matrix<float,6,1,DontAlign> kai_level;
+
+		float max_weight;
+		Matrix<double,8,8,DontAlign> M;
+
+		TWeightsAndNormalEquations(const TLevelImages &im_, bool compute_weights_, bool accumulate_, float f_inv_, float fps_, const Matrix<float,6,1> &kai_level_) :
+			im(im_), compute_weights(compute_weights_), accumulate(accumulate_), f_inv(f_inv_), fps(fps_), kai_level(kai_level_),
+			max_weight(0)
+		{
+			M.setZero();
+		}
+		TWeightsAndNormalEquations(TWeightsAndNormalEquations &o, mrpt::system::Split) :
+			im(o.im), compute_weights(o.compute_weights), accumulate(o.accumulate), f_inv(o.f_inv), fps(o.fps), kai_level(o.kai_level),
+			max_weight(0)
+		{
+			M.setZero();
+		}
+		void join(const TWeightsAndNormalEquations &o)
+		{
+			max_weight = std::max(max_weight, o.max_weight);
+			M += o.M;
+		}
+
+		/** This method computes the weighting fuction associated to measurement and linearization errors */
+		float computeWeight(const unsigned int v, const unsigned int u) const
+		{
+			const MatrixXf &depth_old = *im.depth_old, &depth_warped = *im.depth_warped;
+			const MatrixXf &du = *im.du, &dv = *im.dv, &dt = *im.dt;
+
+			//Parameters for the measurement error
+			const float kz2 = 8.122e-12f;  //square(1.425e-5) / 25
+
+			//Parameters for linearization error
+			const float kduv = 20e-5f;
+			const float kdt = kduv/square(fps);
+			const float k2dt = 5e-6f;
+			const float k2duv = 5e-6f;
+
+			//					Compute measurment error (simplified)
+			//-----------------------------------------------------------------------
+			const float z = (*im.depth_inter)(v,u);
+			const float x = (*im.xx_inter)(v,u);
+			const float y = (*im.yy_inter)(v,u);
+			const float inv_d = 1.f/z;
+			const float z2 = z*z;
+			const float z4 = z2*z2;
+
+			const float var44 = kz2*z4*square(fps);
+			const float var55 = kz2*z4*0.25f;
+			const float var66 = var55;
+
+			const float j4 = 1.f;
+			const float j5 =  x*inv_d*inv_d*f_inv*(kai_level[0] + y*kai_level[4] - x*kai_level[5])
+						   + inv_d*f_inv*(-kai_level[1] - z*kai_level[5] + y*kai_level[3]);
+			const float j6 = y*inv_d*inv_d*f_inv*(kai_level[0] + y*kai_level[4] - x*kai_level[5])
+						   + inv_d*f_inv*(-kai_level[2] + z*kai_level[4] - x*kai_level[3]);
+
+			const float error_m = j4*j4*var44 + j5*j5*var55 + j6*j6*var66;
+
+			//					Compute linearization error
+			//-----------------------------------------------------------------------
+			const float ini_du = depth_old(v,u+1) - depth_old(v,u-1);
+			const float ini_dv = depth_old(v+1,u) - depth_old(v-1,u);
+			const float final_du = depth_warped(v,u+1) - depth_warped(v,u-1);
+			const float final_dv = depth_warped(v+1,u) - depth_warped(v-1,u);
+
+			const float dut = ini_du - final_du;
+			const float dvt = ini_dv - final_dv;
+			const float duu = du(v,u+1) - du(v,u-1);
+			const float dvv = dv(v+1,u) - dv(v-1,u);
+			const float dvu = dv(v,u+1) - dv(v,u-1); //Completely equivalent to compute duv
+
+			const float error_l = kdt*square(dt(v,u)) + kduv*(square(du(v,u)) + square(dv(v,u))) + k2dt*(square(dut) + square(dvt))
+										+ k2duv*(square(duu) + square(dvv) + square(dvu));
+
+			//Weight
+			return sqrt(1.f/(error_m + error_l));
+		}
+
+		void operator()(const mrpt::system::BlockedRange &range)
+		{
+			const unsigned int rows = im.rows, cols = im.cols;
+			const Matrix<bool, Dynamic, Dynamic> &null = *im.null;
+			MatrixXf &weights = *im.weights;
+
+			Matrix<float,8,8> M_col;   // The equations of one column, added up in single precision
+			Matrix<float,8,1> eq;
+			eq.setZero();
+
+			for (unsigned int u = std::max(1,range.begin()); u < std::min(cols-1,static_cast<unsigned int>(range.end())); u++)
+			{
+				M_col.setZero();
+				for (unsigned int v = 1; v < rows-1; v++)
+				{
+					if (null(v,u)) continue;
+
+					float tw;
+					if (compute_weights)
+					{
+						tw = computeWeight(v,u);
+						weights(v,u) = tw;
+						if (tw > max_weight) max_weight = tw;
+					}
+					else tw = weights(v,u);
+
+					if (!accumulate) continue;
+
+					// Precomputed expressions
+					//The order of the unknowns is (vz, vx, vy, wz, wx, wy)
+					const float d = (*im.depth_inter)(v,u);
+					const float inv_d = 1.f/d;
+					const float x = (*im.xx_inter)(v,u);
+					const float y = (*im.yy_inter)(v,u);
+					const float dycomp = (*im.du)(v,u)*f_inv*inv_d;
+					const float dzcomp = (*im.dv)(v,u)*f_inv*inv_d;
+
+					eq[0] = tw*(1.f + dycomp*x*inv_d + dzcomp*y*inv_d);
+					eq[1] = tw*(-dycomp);
+					eq[2] = tw*(-dzcomp);
+					eq[3] = tw*(dycomp*y - dzcomp*x);
+					eq[4] = tw*(y + dycomp*inv_d*y*x + dzcomp*(y*y*inv_d + d));
+					eq[5] = tw*(-x - dycomp*(x*x*inv_d + d) - dzcomp*inv_d*y*x);
+					eq[6] = tw*(-(*im.dt)(v,u));
+
+					M_col.noalias() += eq*eq.transpose();
+				}
+				if (accumulate)
+					M += M_col.cast<double>();
+			}
+		}
+	};
 }
 
-void CDifodo::buildCoordinatesPyramidFast()
+void CDifodo::buildCoordinatesPyramid()
 {
-	const float max_depth_dif = 0.1f;
-	
 	//Push coordinates back
 	depth_old.swap(depth);
 	xx_old.swap(xx);
@@ -263,101 +657,48 @@ void CDifodo::buildCoordinatesPyramidFast()
 
 	unsigned int pyr_levels = round(log(float(width/cols))/log(2.f)) + ctf_levels;
 
-	//Generate levels
+	//Generate levels: downsampling and coordinates "xy" of the points, in parallel for blocks of columns
 	for (unsigned int i = 0; i<pyr_levels; i++)
 	{
 		unsigned int s = pow(2.f,int(i));
 		cols_i = width/s;
 		rows_i = height/s;
-		//const int rows_i2 = 2*rows_i;
-		//const int cols_i2 = 2*cols_i;
-		const int i_1 = i-1;
 
 		if (i == 0)
 			depth[i].swap(depth_wf);
 
-		//                              Downsampling
-		//-----------------------------------------------------------------------------
-		else
-		{
-			for (unsigned int u = 0; u < cols_i; u++)
-				for (unsigned int v = 0; v < rows_i; v++)
-				{
-					const int u2 = 2*u;
-					const int v2 = 2*v;
-					
-					//Inner pixels
-					if ((v>0)&&(v<rows_i-1)&&(u>0)&&(u<cols_i-1))
-					{
-						const Matrix4f d_block = depth[i_1].block<4,4>(v2-1,u2-1);
-						float depths[4] = {d_block(5),d_block(6),d_block(9),d_block(10)};
-						float dcenter;
-
-						//Sort the array (try to find a good/representative value)
-						for (signed char k = 2; k>=0; k--)
-						if (depths[k+1] < depths[k])
-							std::swap(depths[k+1],depths[k]);
-						for (unsigned char k = 1; k<3; k++)
-						if (depths[k] > depths[k+1])
-							std::swap(depths[k+1],depths[k]);
-						if (depths[2] < depths[1])
-							dcenter = depths[1];
-						else
-							dcenter = depths[2];
-						
-						if (dcenter > 0.f)
-						{	
-							float sum = 0.f;
-							float weight = 0.f;
-
-							for (unsigned char k = 0; k<16; k++)
-							{
-								const float abs_dif = abs(d_block(k) - dcenter);
-								if (abs_dif < max_depth_dif)
-								{
-									const float aux_w = f_mask(k)*(max_depth_dif - abs_dif);
-									weight += aux_w;
-									sum += aux_w*d_block(k);
-								}
-							}
-							depth[i](v,u) = sum/weight;
-						}
-						else
-							depth[i](v,u) = 0.f;
+		mrpt::system::parallel_for(
+			mrpt::system::BlockedRange(0,cols_i,COLUMNS_GRAIN_SIZE),
+			TPyramidLevel(i==0 ? NULL : &depth[i-1], depth[i], xx[i], yy[i], false, f_mask, g_mask, rows_i, cols_i, fovh) );
+	}
+}
 
-                    }
+void CDifodo::buildCoordinatesPyramidFast()
+{
+	//Push coordinates back
+	depth_old.swap(depth);
+	xx_old.swap(xx);
+	yy_old.swap(yy);
 
-                    //Boundary
-					else
-					{
-						const Matrix2f d_block = depth[i_1].block<2,2>(v2,u2);
-						const float new_d = 0.25f*d_block.sumAll();
-						if (new_d < 0.4f)
-							depth[i](v,u) = 0.f;
-						else
-							depth[i](v,u) = new_d;
-					}
-				}
-        }
+	//The number of levels of the pyramid does not match the number of levels used
+	//in the odometry computation (because we might want to finish with lower resolutions)
 
-        //Calculate coordinates "xy" of the points
-		const float inv_f_i = 2.f*tan(0.5f*fovh)/float(cols_i);
-        const float disp_u_i = 0.5f*(cols_i-1);
-        const float disp_v_i = 0.5f*(rows_i-1);
+	unsigned int pyr_levels = round(log(float(width/cols))/log(2.f)) + ctf_levels;
 
-        for (unsigned int u = 0; u < cols_i; u++) 
-			for (unsigned int v = 0; v < rows_i; v++)
-                if (depth[i](v,u) > 0.f)
-				{
-					xx[i](v,u) = (u - disp_u_i)*depth[i](v,u)*inv_f_i;
-					yy[i](v,u) = (v - disp_v_i)*depth[i](v,u)*inv_f_i;
-				}
-				else
-				{
-					xx[i](v,u) = 0.f;
-					yy[i](v,u) = 0.f;
-				}
-    }
+	//Generate levels: downsampling and coordinates "xy" of the points, in parallel for blocks of columns
+	for (unsigned int i = 0; i<pyr_levels; i++)
+	{
+		unsigned int s = pow(2.f,int(i));
+		cols_i = width/s;
+		rows_i = height/s;
+
+		if (i == 0)
+			depth[i].swap(depth_wf);
+
+		mrpt::system::parallel_for(
+			mrpt::system::BlockedRange(0,cols_i,COLUMNS_GRAIN_SIZE),
+			TPyramidLevel(i==0 ? NULL : &depth[i-1], depth[i], xx[i], yy[i], true, f_mask, g_mask, rows_i, cols_i, fovh) );
+	}
 }
 
 void CDifodo::performWarping()
@@ -459,87 +800,26 @@ void CDifodo::performWarping()
 }
 
 void CDifodo::calculateCoord()
-{	
+{
 	null.resize(rows_i, cols_i);
-	null.assign(false);
-	num_valid_points = 0;
-	
-	for (unsigned int u = 0; u < cols_i; u++)
-		for (unsigned int v = 0; v < rows_i; v++)
-		{
-			if ((depth_old[image_level](v,u)) == 0.f || (depth_warped[image_level](v,u) == 0.f))
-			{
-				depth_inter[image_level](v,u) = 0.f;
-				xx_inter[image_level](v,u) = 0.f;
-				yy_inter[image_level](v,u) = 0.f;
-				null(v, u) = true;
-			}
-			else
-			{
-				depth_inter[image_level](v,u) = 0.5f*(depth_old[image_level](v,u) + depth_warped[image_level](v,u));
-				xx_inter[image_level](v,u) = 0.5f*(xx_old[image_level](v,u) + xx_warped[image_level](v,u));
-				yy_inter[image_level](v,u) = 0.5f*(yy_old[image_level](v,u) + yy_warped[image_level](v,u));
-				null(v, u) = false;
-				if ((u>0)&&(v>0)&&(u<cols_i-1)&&(v<rows_i-1))
-					num_valid_points++;
-			}
-		}
+
+	const TLevelImages im = makeLevelImages(depth_old,xx_old,yy_old,depth_warped,xx_warped,yy_warped,depth_inter,xx_inter,yy_inter,image_level,null,du,dv,dt,weights,rows_i,cols_i);
+	TCalculateCoord calc(im);
+	mrpt::system::parallel_reduce(mrpt::system::BlockedRange(0,cols_i,COLUMNS_GRAIN_SIZE), calc);
+	num_valid_points = calc.num_valid_points;
 }
 
 void CDifodo::calculateDepthDerivatives()
 {
-	dt.resize(rows_i,cols_i); dt.assign(0.f);
-	du.resize(rows_i,cols_i); du.assign(0.f);
-	dv.resize(rows_i,cols_i); dv.assign(0.f);
-
-    //Compute connectivity
-	MatrixXf rx_ninv(rows_i,cols_i);
-	MatrixXf ry_ninv(rows_i,cols_i);
-    rx_ninv.assign(1.f); ry_ninv.assign(1.f);
-
-	for (unsigned int u = 0; u < cols_i-1; u++)
-        for (unsigned int v = 0; v < rows_i; v++)
-			if (null(v,u) == false)
-			{
-				rx_ninv(v,u) = sqrtf(square(xx_inter[image_level](v,u+1) - xx_inter[image_level](v,u))
-									+ square(depth_inter[image_level](v,u+1) - depth_inter[image_level](v,u)));
-			}
-
-	for (unsigned int u = 0; u < cols_i; u++)
-        for (unsigned int v = 0; v < rows_i-1; v++)
-			if (null(v,u) == false)
-			{
-				ry_ninv(v,u) = sqrtf(square(yy_inter[image_level](v+1,u) - yy_inter[image_level](v,u))
-									+ square(depth_inter[image_level](v+1,u) - depth_inter[image_level](v,u)));
-			}
-
+	dt.resize(rows_i,cols_i);
+	du.resize(rows_i,cols_i);
+	dv.resize(rows_i,cols_i);
 
-    //Spatial derivatives
-    for (unsigned int v = 0; v < rows_i; v++)
-    {
-        for (unsigned int u = 1; u < cols_i-1; u++)
-			if (null(v,u) == false)
-				du(v,u) = (rx_ninv(v,u-1)*(depth_inter[image_level](v,u+1)-depth_inter[image_level](v,u)) + rx_ninv(v,u)*(depth_inter[image_level](v,u) - depth_inter[image_level](v,u-1)))/(rx_ninv(v,u)+rx_ninv(v,u-1));
-
-		du(v,0) = du(v,1);
-		du(v,cols_i-1) = du(v,cols_i-2);
-    }
-
-    for (unsigned int u = 0; u < cols_i; u++)
-    {
-        for (unsigned int v = 1; v < rows_i-1; v++)
-			if (null(v,u) == false)
-				dv(v,u) = (ry_ninv(v-1,u)*(depth_inter[image_level](v+1,u)-depth_inter[image_level](v,u)) + ry_ninv(v,u)*(depth_inter[image_level](v,u) - depth_inter[image_level](v-1,u)))/(ry_ninv(v,u)+ry_ninv(v-1,u));
-
-		dv(0,u) = dv(1,u);
-		dv(rows_i-1,u) = dv(rows_i-2,u);
-    }
+	const TLevelImages im = makeLevelImages(depth_old,xx_old,yy_old,depth_warped,xx_warped,yy_warped,depth_inter,xx_inter,yy_inter,image_level,null,du,dv,dt,weights,rows_i,cols_i);
+	mrpt::system::parallel_for(mrpt::system::BlockedRange(0,cols_i,COLUMNS_GRAIN_SIZE), TDepthDerivatives(im,fps));
 
-	//Temporal derivative
-	for (unsigned int u = 0; u < cols_i; u++)
-		for (unsigned int v = 0; v < rows_i; v++)
-			if (null(v,u) == false)
-				dt(v,u) = fps*(depth_warped[image_level](v,u) - depth_old[image_level](v,u));
+	du.col(0) = du.col(1);
+	du.col(cols_i-1) = du.col(cols_i-2);
 }
 
 void CDifodo::computeWeights()
@@ -547,147 +827,46 @@ void CDifodo::computeWeights()
 	weights.resize(rows_i, cols_i);
 	weights.assign(0.f);
 
-	//Obtain the velocity associated to the rigid transformation estimated up to the present level
-	Matrix<float,6,1> kai_level = kai_loc_old;
-
-	Matrix4f acu_trans;
-	acu_trans.setIdentity();
-	for (unsigned int i=0; i<level; i++)
-		acu_trans = transformations[i]*acu_trans;
-
-	//Alternative way to compute the log
-	CMatrixDouble44 mat_aux = acu_trans.cast<double>();
-	poses::CPose3D aux(mat_aux);
-	CArrayDouble<6> kai_level_acu = aux.ln()*fps;
-	kai_level -= kai_level_acu.cast<float>();
-
-	//Parameters for the measurement error
+	const TLevelImages im = makeLevelImages(depth_old,xx_old,yy_old,depth_warped,xx_warped,yy_warped,depth_inter,xx_inter,yy_inter,image_level,null,du,dv,dt,weights,rows_i,cols_i);
 	const float f_inv = float(cols_i)/(2.f*tan(0.5f*fovh));
-	const float kz2 = 8.122e-12f;  //square(1.425e-5) / 25
-	
-	//Parameters for linearization error
-	const float kduv = 20e-5f;
-	const float kdt = kduv/square(fps);
-	const float k2dt = 5e-6f;
-	const float k2duv = 5e-6f;
-	
-	for (unsigned int u = 1; u < cols_i-1; u++)
-		for (unsigned int v = 1; v < rows_i-1; v++)
-			if (null(v,u) == false)
-			{
-				//					Compute measurment error (simplified)
-				//-----------------------------------------------------------------------
-				const float z = depth_inter[image_level](v,u);
-				const float inv_d = 1.f/z;
-				//const float dycomp = du2(v,u)*f_inv_y*inv_d;
-				//const float dzcomp = dv2(v,u)*f_inv_z*inv_d;
-				const float z2 = z*z;
-				const float z4 = z2*z2;
-
-				//const float var11 = kz2*z4;
-				//const float var12 = kz2*xx_inter[image_level](v,u)*z2*depth_inter[image_level](v,u);
-				//const float var13 = kz2*yy_inter[image_level](v,u)*z2*depth_inter[image_level](v,u);
-				//const float var22 = kz2*square(xx_inter[image_level](v,u))*z2;
-				//const float var23 = kz2*xx_inter[image_level](v,u)*yy_inter[image_level](v,u)*z2;
-				//const float var33 = kz2*square(yy_inter[image_level](v,u))*z2;
-				const float var44 = kz2*z4*square(fps);
-				const float var55 = kz2*z4*0.25f;
-				const float var66 = var55;
-
-				//const float j1 = -2.f*inv_d*inv_d*(xx_inter[image_level](v,u)*dycomp + yy_inter[image_level](v,u)*dzcomp)*(kai_level[0] + yy_inter[image_level](v,u)*kai_level[4] - xx_inter[image_level](v,u)*kai_level[5])
-				//				+ inv_d*dycomp*(kai_level[1] - yy_inter[image_level](v,u)*kai_level[3]) + inv_d*dzcomp*(kai_level[2] + xx_inter[image_level](v,u)*kai_level[3]);
-				//const float j2 = inv_d*dycomp*(kai_level[0] + yy_inter[image_level](v,u)*kai_level[4] - 2.f*xx_inter[image_level](v,u)*kai_level[5]) - dzcomp*kai_level[3];
-				//const float j3 = inv_d*dzcomp*(kai_level[0] + 2.f*yy_inter[image_level](v,u)*kai_level[4] - xx_inter[image_level](v,u)*kai_level[5]) + dycomp*kai_level[3];
-
-				const float j4 = 1.f;
-				const float j5 =  xx_inter[image_level](v,u)*inv_d*inv_d*f_inv*(kai_level[0] + yy_inter[image_level](v,u)*kai_level[4] - xx_inter[image_level](v,u)*kai_level[5]) 
-							   + inv_d*f_inv*(-kai_level[1] - z*kai_level[5] + yy_inter[image_level](v,u)*kai_level[3]);
-				const float j6 = yy_inter[image_level](v,u)*inv_d*inv_d*f_inv*(kai_level[0] + yy_inter[image_level](v,u)*kai_level[4] - xx_inter[image_level](v,u)*kai_level[5])
-							   + inv_d*f_inv*(-kai_level[2] + z*kai_level[4] - xx_inter[image_level](v,u)*kai_level[3]);
-
-				//error_measurement(v,u) = j1*(j1*var11+j2*var12+j3*var13) + j2*(j1*var12+j2*var22+j3*var23)
-				//						+j3*(j1*var13+j2*var23+j3*var33) + j4*j4*var44 + j5*j5*var55 + j6*j6*var66;
-
-				const float error_m = j4*j4*var44 + j5*j5*var55 + j6*j6*var66;
-
-				
-				//					Compute linearization error
-				//-----------------------------------------------------------------------
-				const float ini_du = depth_old[image_level](v,u+1) - depth_old[image_level](v,u-1);
-				const float ini_dv = depth_old[image_level](v+1,u) - depth_old[image_level](v-1,u);
-				const float final_du = depth_warped[image_level](v,u+1) - depth_warped[image_level](v,u-1);
-				const float final_dv = depth_warped[image_level](v+1,u) - depth_warped[image_level](v-1,u);
-
-				const float dut = ini_du - final_du;
-				const float dvt = ini_dv - final_dv;
-				const float duu = du(v,u+1) - du(v,u-1);
-				const float dvv = dv(v+1,u) - dv(v-1,u);
-				const float dvu = dv(v,u+1) - dv(v,u-1); //Completely equivalent to compute duv
-
-				const float error_l = kdt*square(dt(v,u)) + kduv*(square(du(v,u)) + square(dv(v,u))) + k2dt*(square(dut) + square(dvt))
-											+ k2duv*(square(duu) + square(dvv) + square(dvu));
-
-				//Weight
-				weights(v,u) = sqrt(1.f/(error_m + error_l));
-			}
+	TWeightsAndNormalEquations calc(im, true, false, f_inv, fps, velocityUpToLevel(kai_loc_old,transformations,level,fps));
+	mrpt::system::parallel_reduce(mrpt::system::BlockedRange(0,cols_i,COLUMNS_GRAIN_SIZE), calc);
 
 	//Normalize weights in the range [0,1]
-	const float inv_max = 1.f/weights.maximum();
+	const float inv_max = 1.f/calc.max_weight;
 	weights = inv_max*weights;
 }
 
 void CDifodo::solveOneLevel()
 {
-	MatrixXf A(num_valid_points,6);
-	MatrixXf B(num_valid_points,1);
-	unsigned int cont = 0;
-
-	//Fill the matrix A and the vector B
-	//The order of the unknowns is (vz, vx, vy, wz, wx, wy)
-	//The points order will be (1,1), (1,2)...(1,cols-1), (2,1), (2,2)...(row-1,cols-1).
-
+	//Accumulate the normal equations of all the valid points, with the current weights
+	const TLevelImages im = makeLevelImages(depth_old,xx_old,yy_old,depth_warped,xx_warped,yy_warped,depth_inter,xx_inter,yy_inter,image_level,null,du,dv,dt,weights,rows_i,cols_i);
 	const float f_inv = float(cols_i)/(2.f*tan(0.5f*fovh));
+	TWeightsAndNormalEquations calc(im, false, true, f_inv, fps, Matrix<float,6,1>::Zero());
+	mrpt::system::parallel_reduce(mrpt::system::BlockedRange(0,cols_i,COLUMNS_GRAIN_SIZE), calc);
 
-	for (unsigned int u = 1; u < cols_i-1; u++)
-		for (unsigned int v = 1; v < rows_i-1; v++)
-			if (null(v,u) == false)
-			{
-				// Precomputed expressions
-				const float d = depth_inter[image_level](v,u);
-				const float inv_d = 1.f/d;
-				const float x = xx_inter[image_level](v,u);
-				const float y = yy_inter[image_level](v,u);
-				const float dycomp = du(v,u)*f_inv*inv_d;
-				const float dzcomp = dv(v,u)*f_inv*inv_d;
-				const float tw = weights(v,u);
-
-				//Fill the matrix A
-				A(cont, 0) = tw*(1.f + dycomp*x*inv_d + dzcomp*y*inv_d);
-				A(cont, 1) = tw*(-dycomp);
-				A(cont, 2) = tw*(-dzcomp);
-				A(cont, 3) = tw*(dycomp*y - dzcomp*x);
-				A(cont, 4) = tw*(y + dycomp*inv_d*y*x + dzcomp*(y*y*inv_d + d));
-				A(cont, 5) = tw*(-x - dycomp*(x*x*inv_d + d) - dzcomp*inv_d*y*x);
-				B(cont,0) = tw*(-dt(v,u));
-
-				cont++;
-			}
-	
 	//Solve the linear system of equations using weighted least squares
-	MatrixXf AtA, AtB;
-	AtA.multiply_AtA(A);
-	AtB.multiply_AtB(A,B);
-	MatrixXf Var = AtA.ldlt().solve(AtB);
+	solveNormalEquations(calc.M, num_valid_points, kai_loc_level, est_cov);
+}
 
-	//Covariance matrix calculation 
-	MatrixXf res = -B;
-	for (unsigned int k = 0; k<6; k++)
-		res += Var(k)*A.col(k);
+void CDifodo::computeWeightsAndSolveOneLevel()
+{
+	weights.resize(rows_i, cols_i);
+	weights.assign(0.f);
 
-	est_cov = (1.f/float(num_valid_points-6))*AtA.inverse()*res.squaredNorm();
+	//Weights and normal equations in one sweep. The equations are accumulated before normalizing the weights:
+	// the solution and its covariance don't change if all the weights are scaled by the same factor.
+	const TLevelImages im = makeLevelImages(depth_old,xx_old,yy_old,depth_warped,xx_warped,yy_warped,depth_inter,xx_inter,yy_inter,image_level,null,du,dv,dt,weights,rows_i,cols_i);
+	const float f_inv = float(cols_i)/(2.f*tan(0.5f*fovh));
+	TWeightsAndNormalEquations calc(im, true, true, f_inv, fps, velocityUpToLevel(kai_loc_old,transformations,level,fps));
+	mrpt::system::parallel_reduce(mrpt::system::BlockedRange(0,cols_i,COLUMNS_GRAIN_SIZE), calc);
+
+	//Normalize weights in the range [0,1]
+	const float inv_max = 1.f/calc.max_weight;
+	weights = inv_max*weights;
 
-	//Update last velocity in local coordinates
-	kai_loc_level = Var;
+	if (num_valid_points > 6)
+		solveNormalEquations(calc.M, num_valid_points, kai_loc_level, est_cov);
 }
 
 void CDifodo::odometryCalculation()
@@ -701,8 +880,12 @@ void CDifodo::odometryCalculation()
 	else				buildCoordinatesPyramid();
 
 	//Coarse-to-fines scheme
+	level_execution_time.resize(ctf_levels);
     for (unsigned int i=0; i<ctf_levels; i++)
     {
+		utils::CTicTac level_clock;
+		level_clock.Tic();
+
 		//Previous computations
 		transformations[i].setIdentity();
 
@@ -727,15 +910,13 @@ void CDifodo::odometryCalculation()
 		//3. Compute derivatives
 		calculateDepthDerivatives();
 
-		//4. Compute weights
-		computeWeights();
-
-		//5. Solve odometry
-		if (num_valid_points > 6)
-			solveOneLevel();
+		//4. Compute weights and 5. solve odometry
+		computeWeightsAndSolveOneLevel();
 
 		//6. Filter solution
 		filterLevelSolution();
+
+		level_execution_time[i] = 1000.f*level_clock.Tac();
 	}
 
 	//Update poses
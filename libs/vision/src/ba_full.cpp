@@ -13,8 +13,10 @@
 #include <mrpt/utils/CTimeLogger.h>
 #include <mrpt/math/CSparseMatrix.h>
 #include <mrpt/math/ops_containers.h>
+#include <mrpt/system/parallelization.h>
 
 #include <memory>  // std::auto_ptr, unique_ptr
+#include <algorithm>
 
 #include "ba_internals.h"
 
@@ -35,6 +37,313 @@ using mrpt::aligned_containers;
 #	define INV_POSES_BOOL  false
 #endif
 
+namespace
+{
+	static const unsigned int FrameDof = 6; // Poses: x y z yaw pitch roll
+	static const unsigned int PointDof = 3; // Landmarks: x y z
+
+	typedef CArrayDouble<FrameDof>             Array_F;
+	typedef CArrayDouble<PointDof>             Array_P;
+	typedef CMatrixFixedNumeric<double,FrameDof,FrameDof> Matrix_FxF;
+	typedef CMatrixFixedNumeric<double,PointDof,PointDof> Matrix_PxP;
+	typedef CMatrixFixedNumeric<double,FrameDof,PointDof> Matrix_FxP;
+
+	typedef aligned_containers<Matrix_FxF>::vector_t  Matrix_FxF_vec;
+	typedef aligned_containers<Matrix_PxP>::vector_t  Matrix_PxP_vec;
+	typedef aligned_containers<Matrix_FxP>::vector_t  Matrix_FxP_vec;
+	typedef aligned_containers<Array_F>::vector_t     Array_F_vec;
+	typedef aligned_containers<Array_P>::vector_t     Array_P_vec;
+
+	// The 6x6 block of the reduced camera system at the given position within the buffer of values of
+	// the column-compressed sparse matrix (see TSchurStructure):
+	typedef Eigen::Map<Eigen::Matrix<double,FrameDof,FrameDof>,0,Eigen::OuterStride<> > BlockMap;
+
+	/** The sparse structure of the BA problem, which does not change between iterations.
+	  * Only observations of a free point from a free frame have a frame-point block W in the Hessian: they are
+	  * stored in flat arrays indexed by "observation number", referenced from per-point and per-frame CSR-like index lists.
+	  * The reduced camera matrix is stored in column-compressed form with only its upper triangle of 6x6 blocks: the
+	  * values of the b'th block of block-column k start at entry 36*col_blk_start[k]+6*b of the values buffer, with a
+	  * stride of 6*(number of blocks in that column) between consecutive columns. */
+	struct TSchurStructure
+	{
+		vector<size_t> obs_frame;       //!< Free frame index of each observation with a W block
+		vector<size_t> obs_point;       //!< Free point index of each observation with a W block
+		vector<size_t> obs_jac;         //!< Index in the list of observations (and Jacobians) of each observation with a W block
+		vector<size_t> point_obs_start; //!< The observations of the i'th free point are point_obs[point_obs_start[i]:point_obs_start[i+1]-1]
+		vector<size_t> point_obs;
+		vector<size_t> frame_obs_start; //!< The observations from the k'th free frame are frame_obs[frame_obs_start[k]:frame_obs_start[k+1]-1]
+		vector<size_t> frame_obs;
+		vector<size_t> col_blk_start;   //!< The block-rows of the non-zero blocks in the k'th block-column are col_blk_row[col_blk_start[k]:col_blk_start[k+1]-1]
+		vector<size_t> col_blk_row;     //!< Sorted, the last one being always the diagonal block
+
+		void build(
+			const TSequenceFeatureObservations & observations,
+			const size_t num_fix_frames, const size_t num_fix_points,
+			const size_t num_free_frames, const size_t num_free_points)
+		{
+			obs_frame.clear(); obs_point.clear(); obs_jac.clear();
+			for (size_t i=0;i<observations.size();i++)
+			{
+				const TCameraPoseID  i_f = observations[i].id_frame;
+				const TLandmarkID    i_p = observations[i].id_feature;
+				if (i_f<num_fix_frames || i_p<num_fix_points) continue;
+				obs_frame.push_back(i_f-num_fix_frames);
+				obs_point.push_back(i_p-num_fix_points);
+				obs_jac.push_back(i);
+			}
+			buildIndex(obs_point, num_free_points, point_obs_start, point_obs);
+			buildIndex(obs_frame, num_free_frames, frame_obs_start, frame_obs);
+
+			// Non-zero blocks (j,k), j<=k, of the reduced camera matrix: pairs of frames observing a common point.
+			col_blk_start.assign(num_free_frames+1, 0);
+			col_blk_row.clear();
+			vector<size_t> rows;
+			for (size_t k=0;k<num_free_frames;k++)
+			{
+				rows.clear();
+				rows.push_back(k);
+				for (size_t io=frame_obs_start[k];io<frame_obs_start[k+1];io++)
+				{
+					const size_t i = obs_point[frame_obs[io]];
+					for (size_t jo=point_obs_start[i];jo<point_obs_start[i+1];jo++)
+					{
+						const size_t j = obs_frame[point_obs[jo]];
+						if (j<k) rows.push_back(j);
+					}
+				}
+				std::sort(rows.begin(),rows.end());
+				rows.erase(std::unique(rows.begin(),rows.end()), rows.end());
+				col_blk_row.insert(col_blk_row.end(), rows.begin(),rows.end());
+				col_blk_start[k+1] = col_blk_row.size();
+			}
+		}
+
+		/** Returns the index within the k'th block-column of the block (j,k) */
+		inline size_t blockIndex(const size_t j, const size_t k) const
+		{
+			const vector<size_t>::const_iterator first = col_blk_row.begin()+col_blk_start[k];
+			return std::lower_bound(first, col_blk_row.begin()+col_blk_start[k+1], j) - first;
+		}
+
+	private:
+		static void buildIndex(const vector<size_t> &keys, const size_t num_keys, vector<size_t> &start, vector<size_t> &idxs)
+		{
+			start.assign(num_keys+1, 0);
+			for (size_t i=0;i<keys.size();i++) start[keys[i]+1]++;
+			for (size_t k=0;k<num_keys;k++) start[k+1]+=start[k];
+			idxs.resize(keys.size());
+			vector<size_t> next(start.begin(),start.end()-1);
+			for (size_t i=0;i<keys.size();i++) idxs[next[keys[i]]++] = i;
+		}
+	};
+
+	// W_ij = J_f^T * J_p, for each observation in the given range:
+	struct TComputeW
+	{
+		const TSchurStructure  & st;
+		const aligned_containers<JacData<6,3,2> >::vector_t & jac_data_vec;
+		Matrix_FxP_vec         & W;
+
+		TComputeW(const TSchurStructure &st_, const aligned_containers<JacData<6,3,2> >::vector_t &jac_data_vec_, Matrix_FxP_vec &W_) :
+			st(st_), jac_data_vec(jac_data_vec_), W(W_)
+		{}
+
+		void operator()(const mrpt::system::BlockedRange &range) const
+		{
+			for (int o=range.begin();o<range.end();o++)
+			{
+				const JacData<6,3,2> &D = jac_data_vec[st.obs_jac[o]];
+				W[o].multiply_AtB(D.J_frame, D.J_point);
+			}
+		}
+	};
+
+	// V_i^{-1} = (H_p_i + mu*I)^{-1} and Y_ij = W_ij * V_i^{-1}, for each free point in the given range:
+	struct TComputeVinvY
+	{
+		const TSchurStructure  & st;
+		const Matrix_PxP_vec   & H_p;
+		const Matrix_FxP_vec   & W;
+		const double             mu;
+		Matrix_PxP_vec         & V_inv;
+		Matrix_FxP_vec         & Y;
+
+		TComputeVinvY(const TSchurStructure &st_, const Matrix_PxP_vec &H_p_, const Matrix_FxP_vec &W_, const double mu_, Matrix_PxP_vec &V_inv_, Matrix_FxP_vec &Y_) :
+			st(st_), H_p(H_p_), W(W_), mu(mu_), V_inv(V_inv_), Y(Y_)
+		{}
+
+		void operator()(const mrpt::system::BlockedRange &range) const
+		{
+			for (int i=range.begin();i<range.end();i++)
+			{
+				Matrix_PxP V = H_p[i];
+				for (size_t d=0;d<PointDof;d++) V(d,d)+=mu;
+				V.inv_fast(V_inv[i]);
+
+				for (size_t io=st.point_obs_start[i];io<st.point_obs_start[i+1];io++)
+				{
+					const size_t o = st.point_obs[io];
+					Y[o].multiply_AB(W[o], V_inv[i]);
+				}
+			}
+		}
+	};
+
+	// Fills the block-columns in the given range of the reduced camera system S * delta_frames = e, with:
+	//  S_jk = U_j + mu*I - \sum_i Y_ij * W_ik^T  (the sum only for j==k)
+	//  e_k  = eps_frame_k - \sum_i Y_ik * eps_point_i
+	// Each block-column is only written by one range, so they can be filled in parallel.
+	struct TFillReducedSystem
+	{
+		const TSchurStructure  & st;
+		const Matrix_FxF_vec   & H_f;
+		const Array_F_vec      & eps_frame;
+		const Array_P_vec      & eps_point;
+		const Matrix_FxP_vec   & W;
+		const Matrix_FxP_vec   & Y;
+		const double             mu;
+		double                 * S_vals;
+		CVectorDouble          & e;
+
+		TFillReducedSystem(const TSchurStructure &st_, const Matrix_FxF_vec &H_f_, const Array_F_vec &eps_frame_, const Array_P_vec &eps_point_,
+			const Matrix_FxP_vec &W_, const Matrix_FxP_vec &Y_, const double mu_, double *S_vals_, CVectorDouble &e_) :
+			st(st_), H_f(H_f_), eps_frame(eps_frame_), eps_point(eps_point_), W(W_), Y(Y_), mu(mu_), S_vals(S_vals_), e(e_)
+		{}
+
+		void operator()(const mrpt::system::BlockedRange &range) const
+		{
+			for (int k=range.begin();k<range.end();k++)
+			{
+				const size_t num_blks = st.col_blk_start[k+1]-st.col_blk_start[k];
+				double *col_vals = S_vals + FrameDof*FrameDof*st.col_blk_start[k];
+				const Eigen::OuterStride<> stride(FrameDof*num_blks);
+
+				std::fill(col_vals, col_vals+FrameDof*FrameDof*num_blks, 0.0);
+				BlockMap S_kk(col_vals+FrameDof*(num_blks-1), stride);
+				S_kk = H_f[k];
+				S_kk.diagonal().array() += mu;
+
+				Eigen::Map<Eigen::Matrix<double,FrameDof,1> > e_k(&e[k*FrameDof]);
+				e_k = eps_frame[k];
+
+				for (size_t ko=st.frame_obs_start[k];ko<st.frame_obs_start[k+1];ko++)
+				{
+					const size_t o_k = st.frame_obs[ko];
+					const size_t i = st.obs_point[o_k];
+
+					e_k.noalias() -= Y[o_k] * eps_point[i];
+
+					for (size_t jo=st.point_obs_start[i];jo<st.point_obs_start[i+1];jo++)
+					{
+						const size_t o_j = st.point_obs[jo];
+						const size_t j = st.obs_frame[o_j];
+						if (j>static_cast<size_t>(k)) continue; // Upper triangle only
+
+						BlockMap S_jk(col_vals+FrameDof*st.blockIndex(j,k), stride);
+						S_jk.noalias() -= Y[o_j] * W[o_k].transpose();
+					}
+				}
+			}
+		}
+	};
+
+	// Back-substitution for the free points in the given range:
+	//  delta_point_i = V_i^{-1} * ( eps_point_i - \sum_j W_ij^T * delta_frame_j )
+	struct TBackSubstitutePoints
+	{
+		const TSchurStructure  & st;
+		const Array_P_vec      & eps_point;
+		const Matrix_FxP_vec   & W;
+		const Matrix_PxP_vec   & V_inv;
+		const size_t             len_free_frames;
+		CVectorDouble          & delta;
+		CVectorDouble          & g;
+
+		TBackSubstitutePoints(const TSchurStructure &st_, const Array_P_vec &eps_point_, const Matrix_FxP_vec &W_, const Matrix_PxP_vec &V_inv_,
+			const size_t len_free_frames_, CVectorDouble &delta_, CVectorDouble &g_) :
+			st(st_), eps_point(eps_point_), W(W_), V_inv(V_inv_), len_free_frames(len_free_frames_), delta(delta_), g(g_)
+		{}
+
+		void operator()(const mrpt::system::BlockedRange &range) const
+		{
+			for (int i=range.begin();i<range.end();i++)
+			{
+				Array_P tmp = eps_point[i];
+				for (size_t io=st.point_obs_start[i];io<st.point_obs_start[i+1];io++)
+				{
+					const size_t o = st.point_obs[io];
+					const Array_F v( &delta[st.obs_frame[o]*FrameDof] );
+					Array_P r;
+					W[o].multiply_Atb(v, r); // r= A^t * v
+					tmp-=r;
+				}
+				Array_P Vi_tmp;
+				V_inv[i].multiply_Ab(tmp, Vi_tmp); // Vi_tmp = V_inv[i] * tmp
+
+				::memcpy(&delta[len_free_frames + i*PointDof], &Vi_tmp[0], sizeof(Vi_tmp[0])*PointDof );
+				::memcpy(&g[len_free_frames + i*PointDof], &eps_point[i][0], sizeof(eps_point[0][0])*PointDof );
+			}
+		}
+	};
+
+	/** Local (windowed) BA: solves the subproblem with only the last "local_window" frames and the landmarks seen from them. */
+	double bundle_adj_local_window(
+		const TSequenceFeatureObservations   & observations,
+		const TCamera                        & camera_params,
+		TFramePosesVec                       & frame_poses,
+		TLandmarkLocationsVec                & landmark_points,
+		const mrpt::utils::TParametersDouble & extra_params,
+		const TBundleAdjustmentFeedbackFunctor user_feedback,
+		const size_t                           first_free_frame,
+		const size_t                           num_fix_points )
+	{
+		// Landmarks seen from the window, the fixed ones first:
+		const size_t num_points = landmark_points.size();
+		vector<bool> in_window(num_points,false);
+		for (TSequenceFeatureObservations::const_iterator it=observations.begin();it!=observations.end();++it)
+			if (it->id_frame>=first_free_frame)
+				in_window[it->id_feature] = true;
+
+		vector<TLandmarkID> local2global;
+		vector<size_t>      global2local(num_points, string::npos);
+		for (int pass=0;pass<2;pass++)
+			for (size_t i = (pass==0 ? 0:num_fix_points); i < (pass==0 ? num_fix_points:num_points); i++)
+				if (in_window[i])
+				{
+					global2local[i] = local2global.size();
+					local2global.push_back(i);
+				}
+		if (local2global.empty())
+			return 0;
+
+		size_t local_num_fix_points = 0;
+		TLandmarkLocationsVec local_points(local2global.size());
+		for (size_t i=0;i<local2global.size();i++)
+		{
+			local_points[i] = landmark_points[local2global[i]];
+			if (local2global[i]<num_fix_points) local_num_fix_points++;
+		}
+
+		// All the observations of those landmarks, including those from the fixed frames:
+		TSequenceFeatureObservations local_obs;
+		local_obs.reserve(observations.size());
+		for (TSequenceFeatureObservations::const_iterator it=observations.begin();it!=observations.end();++it)
+			if (in_window[it->id_feature])
+				local_obs.push_back( TFeatureObservation(global2local[it->id_feature], it->id_frame, it->px) );
+
+		TParametersDouble local_params = extra_params;
+		local_params["local_window"]   = 0;
+		local_params["num_fix_frames"] = first_free_frame;
+		local_params["num_fix_points"] = local_num_fix_points;
+
+		const double res = mrpt::vision::bundle_adj_full(local_obs, camera_params, frame_poses, local_points, local_params, user_feedback);
+
+		for (size_t i=0;i<local2global.size();i++)
+			landmark_points[local2global[i]] = local_points[i];
+		return res;
+	}
+}
+
 /* ----------------------------------------------------------
                     bundle_adj_full
 
@@ -59,8 +368,6 @@ double mrpt::vision::bundle_adj_full(
 	MRPT_START
 
 	// Generic BA problem dimension numbers:
-	static const unsigned int FrameDof = 6; // Poses: x y z yaw pitch roll
-	static const unsigned int PointDof = 3; // Landmarks: x y z
 	static const unsigned int ObsDim   = 2; // Obs: x y (pixels)
 
 	// Typedefs for this specific BA problem:
@@ -68,11 +375,6 @@ double mrpt::vision::bundle_adj_full(
 	typedef aligned_containers<MyJacData>::vector_t  MyJacDataVec;
 
 	typedef CArray<double,ObsDim>              Array_O;
-	typedef CArrayDouble<FrameDof>             Array_F;
-	typedef CArrayDouble<PointDof>             Array_P;
-	typedef CMatrixFixedNumeric<double,FrameDof,FrameDof> Matrix_FxF;
-	typedef CMatrixFixedNumeric<double,PointDof,PointDof> Matrix_PxP;
-	typedef CMatrixFixedNumeric<double,FrameDof,PointDof> Matrix_FxP;
 
 	// Extra params:
 	const bool use_robust_kernel  = 0!=extra_params.getWithDefaultVal("robust_kernel",1);
@@ -82,25 +384,29 @@ double mrpt::vision::bundle_adj_full(
 	const size_t num_fix_frames   = extra_params.getWithDefaultVal("num_fix_frames",1);
 	const size_t num_fix_points   = extra_params.getWithDefaultVal("num_fix_points",0);
 	const double kernel_param     = extra_params.getWithDefaultVal("kernel_param",3.0);
+	const size_t local_window     = extra_params.getWithDefaultVal("local_window",0);
 
 	const bool   enable_profiler  = 0!=extra_params.getWithDefaultVal("profiler",0);
 
-	mrpt::utils::CTimeLogger  profiler(enable_profiler);
-
-	profiler.enter("bundle_adj_full (complete run)");
-
 	// Input data sizes:
 	const size_t num_points = landmark_points.size();
 	const size_t num_frames = frame_poses.size();
 	const size_t num_obs    = observations.size();
 
-
 	ASSERT_ABOVE_(num_frames,0)
 	ASSERT_ABOVE_(num_points,0)
 	ASSERT_(num_fix_frames>=1)
 	ASSERT_ABOVEEQ_(num_frames,num_fix_frames);
 	ASSERT_ABOVEEQ_(num_points,num_fix_points);
 
+	// Local BA: fix everything outside the last "local_window" frames:
+	if (local_window>0 && num_fix_frames+local_window<num_frames)
+		return bundle_adj_local_window(observations,camera_params,frame_poses,landmark_points,extra_params,user_feedback, num_frames-local_window, num_fix_points);
+
+	mrpt::utils::CTimeLogger  profiler(enable_profiler);
+
+	profiler.enter("bundle_adj_full (complete run)");
+
 #ifdef USE_INVERSE_POSES
 	// *Warning*: This implementation assumes inverse camera poses: inverse them at the entrance and at exit:
 	profiler.enter("invert_poses");
@@ -152,15 +458,41 @@ double mrpt::vision::bundle_adj_full(
 	const size_t len_free_frames = FrameDof * num_free_frames;
 	const size_t len_free_points = PointDof * num_free_points;
 
-	aligned_containers<Matrix_FxF>::vector_t    H_f         (num_free_frames);
-	aligned_containers<Array_F>::vector_t       eps_frame (num_free_frames, arrF_zeros);
-	aligned_containers<Matrix_PxP>::vector_t    H_p         (num_free_points);
-	aligned_containers<Array_P>::vector_t       eps_point (num_free_points, arrP_zeros);
+	Matrix_FxF_vec    H_f         (num_free_frames);
+	Array_F_vec       eps_frame (num_free_frames, arrF_zeros);
+	Matrix_PxP_vec    H_p         (num_free_points);
+	Array_P_vec       eps_point (num_free_points, arrP_zeros);
 
 	profiler.enter("build_gradient_Hessians");
 	ba_build_gradient_Hessians(observations,residual_vec,jac_data_vec, H_f,eps_frame,H_p,eps_point, num_fix_frames, num_fix_points, use_robust_kernel ? &kernel_1st_deriv : NULL  );
 	profiler.leave("build_gradient_Hessians");
 
+	// The sparse structure of the problem, and the reduced camera matrix with that structure
+	// (its values are overwritten at each iteration, and its symbolic Cholesky factorization reused):
+	profiler.enter("build_structure");
+	TSchurStructure  st;
+	st.build(observations, num_fix_frames, num_fix_points, num_free_frames, num_free_points);
+
+	CSparseMatrix sS(len_free_frames, len_free_frames);
+	for (size_t k=0;k<num_free_frames;k++)
+		for (size_t c=0;c<FrameDof;c++)
+			for (size_t b=st.col_blk_start[k];b<st.col_blk_start[k+1];b++)
+				for (size_t r=0;r<FrameDof;r++)
+					sS.insert_entry_fast(st.col_blk_row[b]*FrameDof+r, k*FrameDof+c, 0);
+	sS.compressFromTriplet();
+	double *sS_vals = sS.getColumnCompressedValues();
+	profiler.leave("build_structure");
+
+	VERBOSE_COUT << "Blocks in the reduced camera matrix:" << st.col_blk_row.size() << endl;
+
+	const size_t num_W = st.obs_jac.size();
+	Matrix_FxP_vec  W(num_W), Y(num_W);
+	Matrix_PxP_vec  V_inv(num_free_points);
+
+	profiler.enter("compute_W");
+	mrpt::system::parallel_for(mrpt::system::BlockedRange(0,static_cast<int>(num_W)), TComputeW(st,jac_data_vec,W) );
+	profiler.leave("compute_W");
+
 	double nu = 2;
 	double eps = 1e-16; // 0.000000000000001;
 	bool   stop = false;
@@ -181,9 +513,6 @@ double mrpt::vision::bundle_adj_full(
 		mu = tau*norm_max_A;
 	}
 
-	Matrix_FxF   I_muFrame(UNINITIALIZED_MATRIX);
-	Matrix_PxP   I_muPoint(UNINITIALIZED_MATRIX);
-
 	// Cholesky object, as a pointer to reuse it between iterations:
 #if MRPT_HAS_CXX11
 	typedef std::unique_ptr<CSparseMatrix::CholeskyDecomp> SparseCholDecompPtr;
@@ -207,119 +536,22 @@ double mrpt::vision::bundle_adj_full(
 
 			VERBOSE_COUT << "mu: " <<mu<< endl;
 
-			I_muFrame.unit(FrameDof,mu);
-			I_muPoint.unit(PointDof,mu);
-
-			aligned_containers<Matrix_FxF>::vector_t   U_star(num_free_frames, I_muFrame);
-			aligned_containers<Matrix_PxP>::vector_t   V_inv (num_free_points);
-
-			for (size_t i=0; i<U_star.size(); ++i)
-				U_star[i] += H_f[i];
-
-			for (size_t i=0; i<H_p.size(); ++i)
-				(H_p[i]+I_muPoint).inv_fast( V_inv[i] );
-
-
-			typedef aligned_containers<pair<TCameraPoseID,TLandmarkID>,Matrix_FxP>::map_t  WMap;
-			WMap   W,Y;
-
-			// For quick look-up of entries in W affecting a given point ID:
-			vector<vector<WMap::iterator> >   W_entries(num_points);  // Index is "TLandmarkID"
-
-			MyJacDataVec::const_iterator jac_iter = jac_data_vec.begin();
-			for (TSequenceFeatureObservations::const_iterator it_obs=observations.begin(); it_obs!=observations.end(); ++it_obs)
-			{
-				const TFeatureID feat_id     = it_obs->id_feature;
-				const TCameraPoseID frame_id = it_obs->id_frame;
-
-				if (jac_iter->J_frame_valid && jac_iter->J_point_valid)
-				{
-					const CMatrixFixedNumeric<double,ObsDim,FrameDof> & J_frame = jac_iter->J_frame;
-					const CMatrixFixedNumeric<double,ObsDim,PointDof> & J_point = jac_iter->J_point;
-					const pair<TCameraPoseID,TLandmarkID> id_pair = make_pair(frame_id, feat_id);
-
-					Matrix_FxP tmp(UNINITIALIZED_MATRIX);
-					tmp.multiply_AtB(J_frame, J_point);
-
-					// W[ids] = J_f^T * J_p
-					// Was: W[id_pair] = tmp;
-					const pair<WMap::iterator,bool> &retInsert = W.insert( make_pair(id_pair,tmp) );
-					ASSERT_(retInsert.second==true)
-					W_entries[feat_id].push_back(retInsert.first); // Keep the iterator
-
-					// Y[ids] = W[ids] * H_p^{-1}
-					Y[id_pair].multiply_AB(tmp, V_inv[feat_id-num_fix_points]);
-				}
-				++jac_iter;
-			}
-
-			aligned_containers<pair<TCameraPoseID,TLandmarkID>,Matrix_FxF>::map_t  YW_map;
-			for (size_t i=0; i<H_f.size(); ++i)
-				YW_map[std::pair<TCameraPoseID,TLandmarkID>(i,i)] = U_star[i];
+			profiler.enter("Schur.V_inv.Y");
+			mrpt::system::parallel_for(
+				mrpt::system::BlockedRange(0,static_cast<int>(num_free_points)),
+				TComputeVinvY(st,H_p,W,mu,V_inv,Y) );
+			profiler.leave("Schur.V_inv.Y");
 
 			CVectorDouble  delta( len_free_frames + len_free_points ); // The optimal step
 			CVectorDouble  e    ( len_free_frames );
 
-
 			profiler.enter("Schur.build.reduced.frames");
-			for (size_t j=0; j<num_free_frames; ++j)
-				::memcpy( &e[j*FrameDof], &eps_frame[j][0], sizeof(e[0])*FrameDof ); // e.slice(j*FrameDof,FrameDof) = AT(eps_frame,j);
-
-			for (WMap::iterator Y_ij=Y.begin(); Y_ij!=Y.end(); ++Y_ij)
-			{
-				const TLandmarkID  point_id = Y_ij->first.second;
-				const size_t i = Y_ij->first.second - num_fix_points; // point index
-				const size_t j = Y_ij->first.first  - num_fix_frames; // frame index
-
-				const vector<WMap::iterator> &iters = W_entries[point_id]; //->second;
-
-				for (size_t itIdx=0; itIdx<iters.size(); itIdx++)
-					//for (size_t k=0; k<num_free_frames; ++k)
-				{
-					const WMap::iterator &W_ik = iters[itIdx];
-					const TLandmarkID k = W_ik->first.first-num_fix_frames;
-
-					Matrix_FxF  YWt(UNINITIALIZED_MATRIX);		//-(Y_ij->second) * (W_ik->second).T();
-					YWt.multiply_ABt( Y_ij->second, W_ik->second );
-					//YWt*=-1.0; // The "-" sign is taken into account below:
-
-					const pair<TCameraPoseID,TLandmarkID> ids_jk = pair<TCameraPoseID,TLandmarkID>(j,k);
-
-					aligned_containers<pair<TCameraPoseID,TLandmarkID>,Matrix_FxF>::map_t::iterator it = YW_map.find(ids_jk);
-					if(it!=YW_map.end())
-						it->second -= YWt;  // += (-YWt);
-					else
-						YW_map[ids_jk] = YWt*(-1.0);
-				}
-
-				CArrayDouble<FrameDof>  r;
-				Y_ij->second.multiply_Ab( eps_point[i] ,r);
-				for (size_t k=0; k<FrameDof; k++)
-					e[j*FrameDof+k]-=r[k];
-			}
+			mrpt::system::parallel_for(
+				mrpt::system::BlockedRange(0,static_cast<int>(num_free_frames)),
+				TFillReducedSystem(st,H_f,eps_frame,eps_point,W,Y,mu,sS_vals,e) );
 			profiler.leave("Schur.build.reduced.frames");
 
-
 			profiler.enter("sS:ALL");
-			profiler.enter("sS:fill");
-
-			VERBOSE_COUT << "Entries in YW_map:" << YW_map.size() << endl;
-
-			CSparseMatrix sS(len_free_frames, len_free_frames);
-
-			for (aligned_containers<pair<TCameraPoseID,TLandmarkID>,Matrix_FxF>::map_t::const_iterator it= YW_map.begin(); it!=YW_map.end(); ++it)
-			{
-				const pair<TCameraPoseID,TLandmarkID> & ids = it->first;
-				const Matrix_FxF & YW = it->second;
-				sS.insert_submatrix(ids.first*FrameDof,ids.second*FrameDof, YW);
-			}
-			profiler.leave("sS:fill");
-
-			// Compress the sparse matrix:
-			profiler.enter("sS:compress");
-			sS.compressFromTriplet();
-			profiler.leave("sS:compress");
-
 			try
 			{
 				profiler.enter("sS:chol");
@@ -337,7 +569,9 @@ double mrpt::vision::bundle_adj_full(
 			}
 			catch (CExceptionNotDefPos &)
 			{
+				profiler.leave("sS:chol");
 				profiler.leave("sS:ALL");
+				profiler.leave("COMPLETE_ITER");
 				// not positive definite so increase mu and try again
 				mu *= nu;
 				nu *= 2.;
@@ -350,30 +584,10 @@ double mrpt::vision::bundle_adj_full(
 			CVectorDouble g(len_free_frames+len_free_points);
 			::memcpy(&g[0],&e[0],len_free_frames*sizeof(g[0])); //g.slice(0,FrameDof*(num_frames-num_fix_frames)) = e;
 
-			for (size_t i=0; i<num_free_points; ++i)
-			{
-				Array_P tmp = eps_point[i]; // eps_point.slice(PointDof*i,PointDof);
-
-				for (size_t j=0; j<num_free_frames; ++j)
-				{
-					WMap::iterator W_ij;
-					W_ij = W.find(make_pair<TCameraPoseID,TLandmarkID>(j+num_fix_frames,i+num_fix_points));
+			mrpt::system::parallel_for(
+				mrpt::system::BlockedRange(0,static_cast<int>(num_free_points)),
+				TBackSubstitutePoints(st,eps_point,W,V_inv,len_free_frames,delta,g) );
 
-					if (W_ij!=W.end())
-					{
-						//tmp -= W_ij->second.T() * delta.slice(j*FrameDof,FrameDof);
-						const Array_F  v( &delta[j*FrameDof] );
-						Array_P  r;
-						W_ij->second.multiply_Atb(v, r); // r= A^t * v
-						tmp-=r;
-					}
-				}
-				Array_P Vi_tmp;
-				V_inv[i].multiply_Ab(tmp, Vi_tmp); // Vi_tmp = V_inv[i] * tmp
-
-				::memcpy(&delta[len_free_frames + i*PointDof], &Vi_tmp[0], sizeof(Vi_tmp[0])*PointDof );
-				::memcpy(&g[len_free_frames + i*PointDof], &eps_point[i][0], sizeof(eps_point[0][0])*PointDof );
-			}
 			profiler.leave("PostSchur.landmarks");
 
 
@@ -431,6 +645,9 @@ double mrpt::vision::bundle_adj_full(
 				ba_compute_Jacobians<INV_POSES_BOOL>(frame_poses, landmark_points, camera_params, jac_data_vec, num_fix_frames, num_fix_points);
 				profiler.leave("compute_Jacobians");
 
+				profiler.enter("compute_W");
+				mrpt::system::parallel_for(mrpt::system::BlockedRange(0,static_cast<int>(num_W)), TComputeW(st,jac_data_vec,W) );
+				profiler.leave("compute_W");
 
 				// Reset to zeros:
 				H_f.assign(num_free_frames,Matrix_FxF() );
@@ -0,0 +1,167 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include <mrpt/vision/bundle_adjustment.h>
+#include <mrpt/vision/pinhole.h>
+#include <mrpt/random.h>
+#include <gtest/gtest.h>
+
+using namespace mrpt;
+using namespace mrpt::vision;
+using namespace mrpt::utils;
+using namespace mrpt::poses;
+using namespace mrpt::math;
+using namespace std;
+
+// A small BA problem: a camera moving along a line, looking at a cloud of landmarks, with noisy
+// observations and a noisy initial estimation.
+static void generateBAProblem(
+	TCamera &camera_params,
+	TSequenceFeatureObservations &obs,
+	TFramePosesVec &frame_poses,
+	TLandmarkLocationsVec &landmark_points)
+{
+	random::CRandomGenerator rg(1234);
+
+	camera_params.ncols = 800;
+	camera_params.nrows = 600;
+	camera_params.fx(400); camera_params.fy(400);
+	camera_params.cx(400); camera_params.cy(300);
+
+	const size_t nPts = 80, nFrames = 8;
+	TLandmarkLocationsVec landmark_points_real(nPts);
+	for (size_t i=0;i<nPts;i++)
+	{
+		landmark_points_real[i].x = rg.drawUniform(-20.0,20.0);
+		landmark_points_real[i].y = rg.drawUniform(-4.0,4.0);
+		landmark_points_real[i].z = rg.drawUniform(-4.0,4.0);
+	}
+
+	// Cameras with +Z pointing to the landmarks:
+	TFramePosesVec frame_poses_real;
+	for (size_t i=0;i<nFrames;i++)
+	{
+		const double x = -14.0 + 4.0*i;
+		frame_poses_real.push_back( CPose3D(x,16,0, DEG2RAD(-90)-DEG2RAD(1.5*x),0,0) + CPose3D(0,0,0,DEG2RAD(-90),0,DEG2RAD(-90)) );
+	}
+
+	obs.clear();
+	for (size_t i=0;i<nFrames;i++)
+		for (size_t j=0;j<nPts;j++)
+		{
+			TPixelCoordf px = mrpt::vision::pinhole::projectPoint_no_distortion<false>(camera_params, frame_poses_real[i], landmark_points_real[j]);
+			if (px.x<0 || px.y<0 || px.x>camera_params.ncols || px.y>camera_params.nrows)
+				continue;
+			px.x += rg.drawGaussian1D(0,0.5);
+			px.y += rg.drawGaussian1D(0,0.5);
+			obs.push_back( TFeatureObservation(j,i,px) );
+		}
+
+	landmark_points = landmark_points_real;
+	for (size_t i=0;i<nPts;i++)
+		landmark_points[i] += TPoint3D( rg.drawGaussian1D(0,0.05),rg.drawGaussian1D(0,0.05),rg.drawGaussian1D(0,0.05) );
+	frame_poses = frame_poses_real;
+	for (size_t i=1;i<nFrames;i++) // The first frame is the reference
+		frame_poses[i].setFromValues(
+			frame_poses[i].x() + rg.drawGaussian1D(0,0.05),
+			frame_poses[i].y() + rg.drawGaussian1D(0,0.05),
+			frame_poses[i].z() + rg.drawGaussian1D(0,0.05),
+			frame_poses[i].yaw()   + rg.drawGaussian1D(0,DEG2RAD(1.0)),
+			frame_poses[i].pitch() + rg.drawGaussian1D(0,DEG2RAD(1.0)),
+			frame_poses[i].roll()  + rg.drawGaussian1D(0,DEG2RAD(1.0)) );
+}
+
+TEST(bundle_adj_full, LocalWindowEqualsFullBAWithFixedFrames)
+{
+	TCamera camera_params;
+	TSequenceFeatureObservations obs;
+	TFramePosesVec frame_poses_init;
+	TLandmarkLocationsVec landmark_points_init;
+	generateBAProblem(camera_params,obs,frame_poses_init,landmark_points_init);
+
+	const size_t nFrames = frame_poses_init.size(), nPts = landmark_points_init.size();
+	const size_t WINDOW = 3, first_free_frame = nFrames-WINDOW;
+
+	TParametersDouble params;
+	params["max_iterations"] = 200;
+	params["robust_kernel"]  = 0;
+
+	// Local BA, only with the last frames:
+	TFramePosesVec        frame_poses_local     = frame_poses_init;
+	TLandmarkLocationsVec landmark_points_local = landmark_points_init;
+	params["local_window"] = WINDOW;
+	bundle_adj_full(obs,camera_params,frame_poses_local,landmark_points_local,params);
+
+	// Full BA, with the same frames fixed:
+	TFramePosesVec        frame_poses_full     = frame_poses_init;
+	TLandmarkLocationsVec landmark_points_full = landmark_points_init;
+	params["local_window"]   = 0;
+	params["num_fix_frames"] = first_free_frame;
+	bundle_adj_full(obs,camera_params,frame_poses_full,landmark_points_full,params);
+
+	// Both must reach the same optimum for the frames of the window and the landmarks seen from them,
+	// while the local BA must not touch anything else:
+	vector<bool> in_window(nPts,false);
+	for (size_t k=0;k<obs.size();k++)
+		if (obs[k].id_frame>=first_free_frame)
+			in_window[obs[k].id_feature] = true;
+
+	for (size_t i=0;i<nFrames;i++)
+	{
+		if (i<first_free_frame)
+		{
+			// Only changed by the round-off of the pose inversions at the entrance and exit of bundle_adj_full():
+			EXPECT_NEAR(0, (frame_poses_local[i].getHomogeneousMatrixVal()-frame_poses_init[i].getHomogeneousMatrixVal()).array().abs().maxCoeff(), 1e-12) << "frame: " << i;
+		}
+		else
+		{
+			EXPECT_NEAR(0, (frame_poses_local[i].getHomogeneousMatrixVal()-frame_poses_full[i].getHomogeneousMatrixVal()).array().abs().maxCoeff(), 1e-5) << "frame: " << i;
+			EXPECT_GT((frame_poses_local[i].getHomogeneousMatrixVal()-frame_poses_init[i].getHomogeneousMatrixVal()).array().abs().maxCoeff(), 1e-4) << "frame: " << i;
+		}
+	}
+	size_t nPtsInWindow = 0;
+	for (size_t j=0;j<nPts;j++)
+	{
+		if (in_window[j])
+		{
+			nPtsInWindow++;
+			EXPECT_NEAR(0, landmark_points_local[j].distanceTo(landmark_points_full[j]), 1e-4) << "landmark: " << j;
+		}
+		else
+		{
+			EXPECT_EQ(landmark_points_local[j],landmark_points_init[j]) << "landmark: " << j;
+		}
+	}
+	EXPECT_GT(nPtsInWindow,0u);
+	EXPECT_LT(nPtsInWindow,nPts);
+}
+
+TEST(bundle_adj_full, LocalWindowCoveringAllFramesEqualsFullBA)
+{
+	TCamera camera_params;
+	TSequenceFeatureObservations obs;
+	TFramePosesVec frame_poses_full;
+	TLandmarkLocationsVec landmark_points_full;
+	generateBAProblem(camera_params,obs,frame_poses_full,landmark_points_full);
+
+	TFramePosesVec        frame_poses_local     = frame_poses_full;
+	TLandmarkLocationsVec landmark_points_local = landmark_points_full;
+
+	TParametersDouble params;
+	params["robust_kernel"] = 0;
+	const double err_full = bundle_adj_full(obs,camera_params,frame_poses_full,landmark_points_full,params);
+	params["local_window"] = frame_poses_full.size();
+	const double err_local = bundle_adj_full(obs,camera_params,frame_poses_local,landmark_points_local,params);
+
+	EXPECT_DOUBLE_EQ(err_full,err_local);
+	for (size_t i=0;i<frame_poses_full.size();i++)
+		EXPECT_EQ(frame_poses_full[i],frame_poses_local[i]) << "frame: " << i;
+	for (size_t j=0;j<landmark_points_full.size();j++)
+		EXPECT_EQ(landmark_points_full[j],landmark_points_local[j]) << "landmark: " << j;
+}
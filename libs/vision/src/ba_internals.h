@@ -14,6 +14,7 @@
 #include <mrpt/math/CArray.h>
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/utils/aligned_containers.h>
+#include <mrpt/system/parallelization.h>
 #include <mrpt/vision/types.h>
 
 // Declarations shared between ba_*.cpp files, but which are private to MRPT
@@ -158,10 +159,57 @@ namespace mrpt
 			out_J.multiply_AB(tmp, dp_point);
 		}
 
+		// Computes the Jacobians of the observations within a given range. Each observation only writes its own
+		// JacData entry, so different ranges can be evaluated in parallel.
+		template <bool POSES_ARE_INVERSE>
+		struct TJacobiansEvaluator
+		{
+			const TFramePosesVec         & frame_poses;
+			const TLandmarkLocationsVec  & landmark_points;
+			const mrpt::utils::TCamera   & camera_params;
+			mrpt::aligned_containers<JacData<6,3,2> >::vector_t & jac_data_vec;
+			const size_t                   num_fix_frames;
+			const size_t                   num_fix_points;
+
+			TJacobiansEvaluator(
+				const TFramePosesVec & frame_poses_, const TLandmarkLocationsVec & landmark_points_, const mrpt::utils::TCamera & camera_params_,
+				mrpt::aligned_containers<JacData<6,3,2> >::vector_t & jac_data_vec_, const size_t num_fix_frames_, const size_t num_fix_points_) :
+				frame_poses(frame_poses_), landmark_points(landmark_points_), camera_params(camera_params_),
+				jac_data_vec(jac_data_vec_), num_fix_frames(num_fix_frames_), num_fix_points(num_fix_points_)
+			{}
+
+			void operator()(const mrpt::system::BlockedRange &range) const
+			{
+				for (int i=range.begin();i<range.end();i++)
+				{
+					JacData<6,3,2> &D = jac_data_vec[i];
+
+					const TCameraPoseID  i_f = D.frame_id;
+					const TLandmarkID    i_p = D.point_id;
+
+					ASSERTDEB_(i_f<frame_poses.size())
+					ASSERTDEB_(i_p<landmark_points.size())
+
+					if (i_f>=num_fix_frames)
+					{
+						frameJac<POSES_ARE_INVERSE>(camera_params, frame_poses[i_f], landmark_points[i_p], D.J_frame);
+						D.J_frame_valid = true;
+					}
+
+					if (i_p>=num_fix_points)
+					{
+						pointJac<POSES_ARE_INVERSE>(camera_params, frame_poses[i_f], landmark_points[i_p], D.J_point);
+						D.J_point_valid = true;
+					}
+				}
+			}
+		};
+
 		// === Compute sparse Jacobians ====
 		// Case: 6D poses + 3D points + 2D (x,y) observations
 		// For the case of *inverse* or *normal* frame poses being estimated.
 		// Made inline so immediate values in "poses_are_inverses" are propragated by the compiler
+		// Observations are processed in parallel (if MRPT is built with TBB).
 		template <bool POSES_ARE_INVERSE>
 		void ba_compute_Jacobians(
 			const TFramePosesVec         & frame_poses,
@@ -176,30 +224,10 @@ namespace mrpt
 			// num_fix_frames & num_fix_points: Are relative to the order in frame_poses & landmark_points
 			ASSERT_(!frame_poses.empty() && !landmark_points.empty())
 
-			const size_t N = jac_data_vec.size();
-
-			for (size_t i=0;i<N;i++)
-			{
-				JacData<6,3,2> &D = jac_data_vec[i];
-
-				const TCameraPoseID  i_f = D.frame_id;
-				const TLandmarkID    i_p = D.point_id;
-
-				ASSERTDEB_(i_f<frame_poses.size())
-				ASSERTDEB_(i_p<landmark_points.size())
+			mrpt::system::parallel_for(
+				mrpt::system::BlockedRange(0,static_cast<int>(jac_data_vec.size())),
+				TJacobiansEvaluator<POSES_ARE_INVERSE>(frame_poses, landmark_points, camera_params, jac_data_vec, num_fix_frames, num_fix_points) );
 
-				if (i_f>=num_fix_frames)
-				{
-					frameJac<POSES_ARE_INVERSE>(camera_params, frame_poses[i_f], landmark_points[i_p], D.J_frame);
-					D.J_frame_valid = true;
-				}
-
-				if (i_p>=num_fix_points)
-				{
-					pointJac<POSES_ARE_INVERSE>(camera_params, frame_poses[i_f], landmark_points[i_p], D.J_point);
-					D.J_point_valid = true;
-				}
-			}
 			MRPT_END
 		}
 
@@ -0,0 +1,442 @@
+/* +---------------------------------------------------------------------------+
+   |                     Mobile Robot Programming Toolkit (MRPT)               |
+   |                          http://www.mrpt.org/                             |
+   |                                                                           |
+   | Copyright (c) 2005-2016, Individual contributors, see AUTHORS file        |
+   | See: http://www.mrpt.org/Authors - All rights reserved.                   |
+   | Released under BSD License. See details in http://www.mrpt.org/License    |
+   +---------------------------------------------------------------------------+ */
+
+#include "vision-precomp.h"   // Precompiled headers
+
+#include <mrpt/utils/types_math.h> // Eigen must be included first via MRPT to enable the plugin system
+#include <mrpt/utils/mrpt_macros.h>
+#include <mrpt/system/parallelization.h>
+#include <mrpt/vision/pnp_algos.h>
+#include <Eigen/Dense>
+
+#include "p3p.h"
+
+using namespace mrpt::vision::pnp;
+
+namespace
+{
+	// Max. number of correspondences of the fixed-size EPnP kernel:
+	const int EPNP_FIXED_MAX_N = 8;
+
+	// Camera parameters, read as in the single-problem methods (which take the transpose of cam_intrinsic):
+	struct TCamParams
+	{
+		double fx,fy,cx,cy;
+		TCamParams(const Eigen::Ref<Eigen::MatrixXd> &cam_intrinsic)
+		{
+			fx = cam_intrinsic(0,0);
+			fy = cam_intrinsic(1,1);
+			cx = cam_intrinsic(2,0);
+			cy = cam_intrinsic(2,1);
+		}
+	};
+
+	/** P3P kernel: same computation than CPnP::p3p(), without any dynamic matrix.
+	  *  obj/img: pointers to the first of the (3-vector) points of this problem, with a column stride. */
+	bool p3p_kernel(const TCamParams &cam, const double *obj, const double *img, const Eigen::DenseIndex obj_stride, const Eigen::DenseIndex img_stride, double *pose)
+	{
+		double pts[20];
+		for (int i=0;i<4;i++)
+		{
+			pts[i*5+0] = img[i*img_stride+0]*cam.fx + cam.cx;
+			pts[i*5+1] = img[i*img_stride+1]*cam.fy + cam.cy;
+			pts[i*5+2] = obj[i*obj_stride+0];
+			pts[i*5+3] = obj[i*obj_stride+1];
+			pts[i*5+4] = obj[i*obj_stride+2];
+		}
+		double R[3][3], t[3];
+		p3p p(cam.fx,cam.fy,cam.cx,cam.cy);
+		const bool ret = p.solve(R,t,
+			pts[0],pts[1],pts[2],pts[3],pts[4],     pts[5],pts[6],pts[7],pts[8],pts[9],
+			pts[10],pts[11],pts[12],pts[13],pts[14], pts[15],pts[16],pts[17],pts[18],pts[19]);
+
+		// Same conversion than p3p::solve(Eigen...):
+		const Eigen::Matrix3d R_eig = Eigen::Map<Eigen::Matrix3d>(&R[0][0]);
+		const Eigen::Quaterniond q(R_eig);
+		pose[0]=t[0]; pose[1]=t[1]; pose[2]=t[2];
+		pose[3]=q.x(); pose[4]=q.y(); pose[5]=q.z();
+		return ret;
+	}
+
+	/** EPnP (Lepetit et al.) on fixed-size matrices, for n<=EPNP_FIXED_MAX_N. Same steps than the class epnp. */
+	class epnp_fixed
+	{
+	public:
+		typedef Eigen::Matrix<double,Eigen::Dynamic,3,Eigen::RowMajor,EPNP_FIXED_MAX_N,3> PointsMat;
+		typedef Eigen::Matrix<double,Eigen::Dynamic,2,Eigen::RowMajor,EPNP_FIXED_MAX_N,2> PixelsMat;
+		typedef Eigen::Matrix<double,Eigen::Dynamic,4,Eigen::RowMajor,EPNP_FIXED_MAX_N,4> AlphasMat;
+		typedef Eigen::Matrix<double,6,10> L6x10;
+		typedef Eigen::Matrix<double,6,1>  Vector6d;
+
+		epnp_fixed(const TCamParams &cam, const double *obj, const double *img, const Eigen::DenseIndex obj_stride, const Eigen::DenseIndex img_stride, const int n_) :
+			fu(cam.fx), fv(cam.fy), uc(cam.cx), vc(cam.cy), n(n_), pws(n_,3), us(n_,2), alphas(n_,4), pcs(n_,3)
+		{
+			for (int i=0;i<n;i++)
+			{
+				for (int j=0;j<3;j++) pws(i,j) = obj[i*obj_stride+j];
+				us(i,0) = img[i*img_stride+0]*fu + uc;
+				us(i,1) = img[i*img_stride+1]*fv + vc;
+			}
+		}
+
+		void compute_pose(Eigen::Matrix3d &R, Eigen::Vector3d &t)
+		{
+			choose_control_points();
+			compute_barycentric_coordinates();
+
+			// M^t*M, accumulated from the two rows of each correspondence:
+			Eigen::Matrix<double,12,12> MtM = Eigen::Matrix<double,12,12>::Zero();
+			for (int i=0;i<n;i++)
+			{
+				Eigen::Matrix<double,12,1> M1, M2;
+				for (int k=0;k<4;k++)
+				{
+					M1[3*k] = alphas(i,k)*fu; M1[3*k+1] = 0;               M1[3*k+2] = alphas(i,k)*(uc-us(i,0));
+					M2[3*k] = 0;              M2[3*k+1] = alphas(i,k)*fv;  M2[3*k+2] = alphas(i,k)*(vc-us(i,1));
+				}
+				MtM.selfadjointView<Eigen::Lower>().rankUpdate(M1);
+				MtM.selfadjointView<Eigen::Lower>().rankUpdate(M2);
+			}
+			// Eigenvectors of the 4 smallest eigenvalues (increasing order), i.e. the last 4 singular vectors:
+			const Eigen::SelfAdjointEigenSolver< Eigen::Matrix<double,12,12> > eig(MtM);
+			const Eigen::Matrix<double,12,12> &V = eig.eigenvectors();
+
+			L6x10 L;
+			Vector6d rho;
+			compute_L_6x10(V,L);
+			compute_rho(rho);
+
+			Eigen::Vector4d Betas[4];
+			double rep_errors[4];
+			Eigen::Matrix3d Rs[4];
+			Eigen::Vector3d ts[4];
+
+			find_betas_approx_1(L,rho,Betas[1]);
+			gauss_newton(L,rho,Betas[1]);
+			rep_errors[1] = compute_R_and_t(V,Betas[1],Rs[1],ts[1]);
+
+			find_betas_approx_2(L,rho,Betas[2]);
+			gauss_newton(L,rho,Betas[2]);
+			rep_errors[2] = compute_R_and_t(V,Betas[2],Rs[2],ts[2]);
+
+			find_betas_approx_3(L,rho,Betas[3]);
+			gauss_newton(L,rho,Betas[3]);
+			rep_errors[3] = compute_R_and_t(V,Betas[3],Rs[3],ts[3]);
+
+			int N = 1;
+			if (rep_errors[2] < rep_errors[1]) N = 2;
+			if (rep_errors[3] < rep_errors[N]) N = 3;
+
+			R = Rs[N];
+			t = ts[N];
+		}
+
+	private:
+		const double fu, fv, uc, vc;
+		const int n;
+		PointsMat pws; //!< Object points
+		PixelsMat us;  //!< Image points (pixels)
+		AlphasMat alphas;
+		PointsMat pcs;
+		Eigen::Matrix<double,4,3> cws, ccs; //!< Control points, in the world and camera frames
+
+		void choose_control_points()
+		{
+			// Take C0 as the reference points centroid:
+			cws.row(0) = pws.colwise().mean();
+
+			// Take C1, C2, and C3 from PCA on the reference points:
+			const PointsMat PW0 = pws.rowwise() - cws.row(0);
+			const Eigen::Matrix3d PW0tPW0 = PW0.transpose()*PW0;
+			const Eigen::JacobiSVD<Eigen::Matrix3d> svd(PW0tPW0, Eigen::ComputeFullU);
+			for (int i=1;i<4;i++)
+			{
+				const double k = std::sqrt(svd.singularValues()[i-1]/n);
+				cws.row(i) = cws.row(0) + k * svd.matrixU().col(i-1).transpose();
+			}
+		}
+
+		void compute_barycentric_coordinates()
+		{
+			Eigen::Matrix3d CC;
+			for (int j=1;j<4;j++)
+				CC.col(j-1) = (cws.row(j)-cws.row(0)).transpose();
+
+			// Pseudo-inverse, since CC is singular for planar configurations:
+			const Eigen::JacobiSVD<Eigen::Matrix3d> svd(CC, Eigen::ComputeFullU | Eigen::ComputeFullV);
+			const double tol = 1e-10*svd.singularValues()[0];
+			Eigen::Vector3d inv_sv;
+			for (int i=0;i<3;i++) inv_sv[i] = svd.singularValues()[i]>tol ? 1.0/svd.singularValues()[i] : 0.0;
+			const Eigen::Matrix3d CC_inv = svd.matrixV() * inv_sv.asDiagonal() * svd.matrixU().transpose();
+
+			for (int i=0;i<n;i++)
+			{
+				const Eigen::Vector3d a = CC_inv * (pws.row(i)-cws.row(0)).transpose();
+				alphas(i,1) = a[0]; alphas(i,2) = a[1]; alphas(i,3) = a[2];
+				alphas(i,0) = 1.0 - a[0] - a[1] - a[2];
+			}
+		}
+
+		void compute_L_6x10(const Eigen::Matrix<double,12,12> &V, L6x10 &L) const
+		{
+			Eigen::Vector3d dv[4][6];
+			for (int i=0;i<4;i++)
+			{
+				int a = 0, b = 1;
+				for (int j=0;j<6;j++)
+				{
+					dv[i][j] = V.col(i).segment<3>(3*a) - V.col(i).segment<3>(3*b);
+					b++;
+					if (b>3) { a++; b = a+1; }
+				}
+			}
+			for (int i=0;i<6;i++)
+			{
+				L(i,0) =     dv[0][i].dot(dv[0][i]);
+				L(i,1) = 2 * dv[0][i].dot(dv[1][i]);
+				L(i,2) =     dv[1][i].dot(dv[1][i]);
+				L(i,3) = 2 * dv[0][i].dot(dv[2][i]);
+				L(i,4) = 2 * dv[1][i].dot(dv[2][i]);
+				L(i,5) =     dv[2][i].dot(dv[2][i]);
+				L(i,6) = 2 * dv[0][i].dot(dv[3][i]);
+				L(i,7) = 2 * dv[1][i].dot(dv[3][i]);
+				L(i,8) = 2 * dv[2][i].dot(dv[3][i]);
+				L(i,9) =     dv[3][i].dot(dv[3][i]);
+			}
+		}
+
+		void compute_rho(Vector6d &rho) const
+		{
+			rho[0] = (cws.row(0)-cws.row(1)).squaredNorm();
+			rho[1] = (cws.row(0)-cws.row(2)).squaredNorm();
+			rho[2] = (cws.row(0)-cws.row(3)).squaredNorm();
+			rho[3] = (cws.row(1)-cws.row(2)).squaredNorm();
+			rho[4] = (cws.row(1)-cws.row(3)).squaredNorm();
+			rho[5] = (cws.row(2)-cws.row(3)).squaredNorm();
+		}
+
+		// betas10        = [B11 B12 B22 B13 B23 B33 B14 B24 B34 B44]
+		// betas_approx_1 = [B11 B12     B13         B14]
+		static void find_betas_approx_1(const L6x10 &L, const Vector6d &rho, Eigen::Vector4d &betas)
+		{
+			Eigen::Matrix<double,6,4> L_6x4;
+			L_6x4 << L.col(0), L.col(1), L.col(3), L.col(6);
+			const Eigen::Vector4d b4 = L_6x4.jacobiSvd(Eigen::ComputeFullU | Eigen::ComputeFullV).solve(rho);
+
+			if (b4[0] < 0) {
+				betas[0] = std::sqrt(-b4[0]);
+				betas[1] = -b4[1] / betas[0];
+				betas[2] = -b4[2] / betas[0];
+				betas[3] = -b4[3] / betas[0];
+			} else {
+				betas[0] = std::sqrt(b4[0]);
+				betas[1] = b4[1] / betas[0];
+				betas[2] = b4[2] / betas[0];
+				betas[3] = b4[3] / betas[0];
+			}
+		}
+
+		// betas10        = [B11 B12 B22 B13 B23 B33 B14 B24 B34 B44]
+		// betas_approx_2 = [B11 B12 B22                            ]
+		static void find_betas_approx_2(const L6x10 &L, const Vector6d &rho, Eigen::Vector4d &betas)
+		{
+			const Eigen::Matrix<double,6,3> L_6x3 = L.leftCols<3>();
+			const Eigen::Vector3d b3 = L_6x3.jacobiSvd(Eigen::ComputeFullU | Eigen::ComputeFullV).solve(rho);
+
+			if (b3[0] < 0) {
+				betas[0] = std::sqrt(-b3[0]);
+				betas[1] = (b3[2] < 0) ? std::sqrt(-b3[2]) : 0.0;
+			} else {
+				betas[0] = std::sqrt(b3[0]);
+				betas[1] = (b3[2] > 0) ? std::sqrt(b3[2]) : 0.0;
+			}
+			if (b3[1] < 0) betas[0] = -betas[0];
+			betas[2] = 0.0;
+			betas[3] = 0.0;
+		}
+
+		// betas10        = [B11 B12 B22 B13 B23 B33 B14 B24 B34 B44]
+		// betas_approx_3 = [B11 B12 B22 B13 B23                    ]
+		static void find_betas_approx_3(const L6x10 &L, const Vector6d &rho, Eigen::Vector4d &betas)
+		{
+			const Eigen::Matrix<double,6,5> L_6x5 = L.leftCols<5>();
+			const Eigen::Matrix<double,5,1> b5 = L_6x5.jacobiSvd(Eigen::ComputeFullU | Eigen::ComputeFullV).solve(rho);
+
+			if (b5[0] < 0) {
+				betas[0] = std::sqrt(-b5[0]);
+				betas[1] = (b5[2] < 0) ? std::sqrt(-b5[2]) : 0.0;
+			} else {
+				betas[0] = std::sqrt(b5[0]);
+				betas[1] = (b5[2] > 0) ? std::sqrt(b5[2]) : 0.0;
+			}
+			if (b5[1] < 0) betas[0] = -betas[0];
+			betas[2] = b5[3] / betas[0];
+			betas[3] = 0.0;
+		}
+
+		static void gauss_newton(const L6x10 &L, const Vector6d &rho, Eigen::Vector4d &betas)
+		{
+			const int iterations_number = 5;
+			for (int k=0;k<iterations_number;k++)
+			{
+				Eigen::Matrix<double,6,4> A;
+				Vector6d b;
+				for (int i=0;i<6;i++)
+				{
+					A(i,0) = 2 * L(i,0) * betas[0] +     L(i,1) * betas[1] +     L(i,3) * betas[2] +     L(i,6) * betas[3];
+					A(i,1) =     L(i,1) * betas[0] + 2 * L(i,2) * betas[1] +     L(i,4) * betas[2] +     L(i,7) * betas[3];
+					A(i,2) =     L(i,3) * betas[0] +     L(i,4) * betas[1] + 2 * L(i,5) * betas[2] +     L(i,8) * betas[3];
+					A(i,3) =     L(i,6) * betas[0] +     L(i,7) * betas[1] +     L(i,8) * betas[2] + 2 * L(i,9) * betas[3];
+					b[i] = rho[i] - (
+						L(i,0) * betas[0] * betas[0] + L(i,1) * betas[0] * betas[1] + L(i,2) * betas[1] * betas[1] +
+						L(i,3) * betas[0] * betas[2] + L(i,4) * betas[1] * betas[2] + L(i,5) * betas[2] * betas[2] +
+						L(i,6) * betas[0] * betas[3] + L(i,7) * betas[1] * betas[3] + L(i,8) * betas[2] * betas[3] +
+						L(i,9) * betas[3] * betas[3] );
+				}
+				betas += A.householderQr().solve(b);
+			}
+		}
+
+		double compute_R_and_t(const Eigen::Matrix<double,12,12> &V, const Eigen::Vector4d &betas, Eigen::Matrix3d &R, Eigen::Vector3d &t)
+		{
+			// Control points in the camera frame:
+			ccs.setZero();
+			for (int i=0;i<4;i++)
+				for (int j=0;j<4;j++)
+					ccs.row(j) += betas[i] * V.col(i).segment<3>(3*j).transpose();
+
+			pcs = alphas * ccs;
+
+			// Solve for sign:
+			if (pcs(0,2) < 0)
+			{
+				ccs = -ccs;
+				pcs = -pcs;
+			}
+
+			// Estimate R & t by absolute orientation:
+			const Eigen::RowVector3d pc0 = pcs.colwise().mean(), pw0 = pws.colwise().mean();
+			const Eigen::Matrix3d ABt = (pcs.rowwise()-pc0).transpose() * (pws.rowwise()-pw0);
+			const Eigen::JacobiSVD<Eigen::Matrix3d> svd(ABt, Eigen::ComputeFullU | Eigen::ComputeFullV);
+			R = svd.matrixU() * svd.matrixV().transpose();
+			if (R.determinant() < 0)
+				R.row(2) = -R.row(2);
+			t = pc0.transpose() - R*pw0.transpose();
+
+			// Reprojection error:
+			double sum2 = 0.0;
+			for (int i=0;i<n;i++)
+			{
+				const Eigen::Vector3d pc = R*pws.row(i).transpose() + t;
+				const double inv_Zc = 1.0/pc[2];
+				const double ue = uc + fu * pc[0] * inv_Zc, ve = vc + fv * pc[1] * inv_Zc;
+				sum2 += std::sqrt( (us(i,0)-ue)*(us(i,0)-ue) + (us(i,1)-ve)*(us(i,1)-ve) );
+			}
+			return sum2 / n;
+		}
+	};
+
+	bool epnp_fixed_kernel(const TCamParams &cam, const double *obj, const double *img, const Eigen::DenseIndex obj_stride, const Eigen::DenseIndex img_stride, const int n, double *pose)
+	{
+		Eigen::Matrix3d R;
+		Eigen::Vector3d t;
+		epnp_fixed e(cam,obj,img,obj_stride,img_stride,n);
+		e.compute_pose(R,t);
+		if (!R.allFinite() || !t.allFinite())
+			return false;
+
+		const Eigen::Quaterniond q(R);
+		pose[0]=t[0]; pose[1]=t[1]; pose[2]=t[2];
+		pose[3]=q.x(); pose[4]=q.y(); pose[5]=q.z();
+		return true;
+	}
+
+	// Solves the problems in a range of indices:
+	struct TPnPBatchSolver
+	{
+		const CPnP::TAlgorithm               algo;
+		const Eigen::Ref<Eigen::MatrixXd>  & obj_pts;
+		const Eigen::Ref<Eigen::MatrixXd>  & img_pts;
+		const int                            n;
+		const Eigen::Ref<Eigen::MatrixXd>  & cam_intrinsic;
+		Eigen::Ref<Eigen::MatrixXd>        & pose_mats;
+		std::vector<char>                  & success;
+
+		TPnPBatchSolver(CPnP::TAlgorithm algo_, const Eigen::Ref<Eigen::MatrixXd> &obj_pts_, const Eigen::Ref<Eigen::MatrixXd> &img_pts_, int n_,
+			const Eigen::Ref<Eigen::MatrixXd> &cam_intrinsic_, Eigen::Ref<Eigen::MatrixXd> &pose_mats_, std::vector<char> &success_) :
+			algo(algo_), obj_pts(obj_pts_), img_pts(img_pts_), n(n_), cam_intrinsic(cam_intrinsic_), pose_mats(pose_mats_), success(success_)
+		{}
+
+		void operator()(const mrpt::system::BlockedRange &r) const
+		{
+			const TCamParams cam(cam_intrinsic);
+			const bool use_fixed_epnp = (algo==CPnP::EPNP && n<=EPNP_FIXED_MAX_N);
+
+			CPnP pnp;
+			Eigen::MatrixXd obj, img, K, pose(6,1);
+			Eigen::Matrix<double,6,1> pose_fixed;
+
+			for (int k=r.begin();k<r.end();k++)
+			{
+				const double *o = obj_pts.data() + k*n*obj_pts.outerStride(), *im = img_pts.data() + k*n*img_pts.outerStride();
+				bool ok;
+				if (algo==CPnP::P3P)
+					ok = p3p_kernel(cam,o,im,obj_pts.outerStride(),img_pts.outerStride(),&pose_fixed[0]);
+				else if (use_fixed_epnp)
+					ok = epnp_fixed_kernel(cam,o,im,obj_pts.outerStride(),img_pts.outerStride(),n,&pose_fixed[0]);
+				else
+				{
+					// Generic algorithms: the same method than for a single problem
+					obj = obj_pts.middleCols(k*n,n);
+					img = img_pts.middleCols(k*n,n);
+					K = cam_intrinsic;
+					switch (algo)
+					{
+					case CPnP::DLS:   ok = pnp.dls  (obj,img,n,K,pose); break;
+					case CPnP::EPNP:  ok = pnp.epnp (obj,img,n,K,pose); break;
+					case CPnP::UPNP:  ok = pnp.upnp (obj,img,n,K,pose); break;
+					case CPnP::RPNP:  ok = pnp.rpnp (obj,img,n,K,pose); break;
+					case CPnP::PPNP:  ok = pnp.ppnp (obj,img,n,K,pose); break;
+					case CPnP::POSIT: ok = pnp.posit(obj,img,n,K,pose); break;
+					case CPnP::LHM:   ok = pnp.lhm  (obj,img,n,K,pose); break;
+					case CPnP::SO3:   ok = pnp.so3  (obj,img,n,K,pose); break;
+					default:
+						THROW_EXCEPTION("Unknown PnP algorithm")
+					};
+					pose_fixed = pose;
+				}
+				pose_mats.col(k) = pose_fixed;
+				success[k] = ok ? 1:0;
+			}
+		}
+	};
+}
+
+int mrpt::vision::pnp::CPnP::solve_batch(TAlgorithm algo, const Eigen::Ref<Eigen::MatrixXd> obj_pts, const Eigen::Ref<Eigen::MatrixXd> img_pts, int n, const Eigen::Ref<Eigen::MatrixXd> cam_intrinsic, Eigen::Ref<Eigen::MatrixXd> pose_mats, std::vector<bool> *out_success)
+{
+	ASSERT_(n>0)
+	ASSERT_(obj_pts.rows()==3 && img_pts.rows()==3)
+	ASSERT_(obj_pts.cols()==img_pts.cols() && obj_pts.cols() % n == 0)
+	const int K = static_cast<int>(obj_pts.cols()/n);
+	ASSERT_(pose_mats.rows()==6 && pose_mats.cols()==K)
+	if ((algo==P3P || algo==EPNP) && n<4)
+		THROW_EXCEPTION("P3P and EPnP require at least 4 correspondences")
+
+	std::vector<char> success(K,0);
+	mrpt::system::parallel_for(
+		mrpt::system::BlockedRange(0,K),
+		TPnPBatchSolver(algo,obj_pts,img_pts,n,cam_intrinsic,pose_mats,success) );
+
+	int num_ok = 0;
+	for (int k=0;k<K;k++)
+		if (success[k]) num_ok++;
+	if (out_success)
+		out_success->assign(success.begin(),success.end());
+	return num_ok;
+}
@@ -115,6 +115,65 @@ TEST_F(CPnPTest, so3_TEST)
     EXPECT_LE(err_t, 2);
 }
 
+TEST_F(CPnPTest, epnp_fixed_batch_TEST)
+{
+    // EPnP with n<=8 uses a fixed-size kernel in solve_batch(), which does not require OpenCV
+    Eigen::MatrixXd pose_mats(6,1);
+    
+    EXPECT_EQ(cpnp.solve_batch(mrpt::vision::pnp::CPnP::EPNP, obj_pts, img_pts, n, I3, pose_mats), 1);
+    
+    t_est<<pose_mats(0,0), pose_mats(1,0), pose_mats(2,0);
+    
+    double err_t = (t-t_est).norm();
+    
+    EXPECT_LE(err_t, 2);
+}
+
+TEST_F(CPnPTest, batch_TEST)
+{
+    // K copies of the problem, with different translations:
+    const int K = 20;
+    Eigen::MatrixXd obj_batch(3,K*n), img_batch(3,K*n), pose_mats(6,K);
+    Eigen::MatrixXd t_batch(3,K);
+    
+    for (int k = 0; k < K; k++)
+    {
+        t_batch.col(k) = t + Eigen::Vector3d(k, -0.5*k, 2*k);
+        for (int i = 0; i < n; i++)
+        {
+            obj_batch.col(k*n+i) = obj_pts.col(i);
+            img_batch.col(k*n+i) = (R * obj_pts.col(i) + t_batch.col(k));
+            img_batch.col(k*n+i) /= img_batch(2,k*n+i);
+        }
+    }
+    
+    const mrpt::vision::pnp::CPnP::TAlgorithm algos[] = { mrpt::vision::pnp::CPnP::P3P, mrpt::vision::pnp::CPnP::LHM, mrpt::vision::pnp::CPnP::EPNP };
+    for (size_t a = 0; a < sizeof(algos)/sizeof(algos[0]); a++)
+    {
+        std::vector<bool> success;
+        pose_mats.setZero();
+        cpnp.solve_batch(algos[a], obj_batch, img_batch, n, I3, pose_mats, &success);
+        ASSERT_EQ(success.size(), size_t(K));
+        
+        for (int k = 0; k < K; k++)
+        {
+            // Same result than solving each problem alone:
+            if (algos[a] == mrpt::vision::pnp::CPnP::P3P || algos[a] == mrpt::vision::pnp::CPnP::LHM)
+            {
+                Eigen::MatrixXd obj_k = obj_batch.middleCols(k*n,n), img_k = img_batch.middleCols(k*n,n);
+                if (algos[a] == mrpt::vision::pnp::CPnP::P3P)
+                    cpnp.p3p(obj_k, img_k, n, I3, pose_est);
+                else
+                    cpnp.lhm(obj_k, img_k, n, I3, pose_est);
+                EXPECT_NEAR((pose_est - pose_mats.col(k)).norm(), 0, 1e-9);
+            }
+            
+            t_est = pose_mats.block<3,1>(0,k);
+            EXPECT_LE((t_batch.col(k) - t_est).norm(), 2);
+        }
+    }
+}
+
 #if MRPT_HAS_OPENCV
 
     TEST_F(CPnPTest, dls_TEST)
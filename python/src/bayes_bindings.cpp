@@ -4,7 +4,7 @@
 /* MRPT */
 #include <mrpt/utils/CLoadableOptions.h>
 
-#include <mrpt/bayes/CProbabilityParticle.h>
+#include <mrpt/bayes/CParticleFilterData.h>
 #include <mrpt/bayes/CParticleFilter.h>
 #include <mrpt/bayes/CParticleFilterCapable.h>
 #include <mrpt/bayes/CKalmanFilterCapable.h>
@@ -25,8 +25,8 @@ using namespace mrpt::utils;
 
 // aux typedefs
 namespace mrpt { namespace bayes {
-    typedef std::deque<CProbabilityParticle<CPose2D> > CParticle2DList;
-    typedef std::deque<CProbabilityParticle<CPose3D> > CParticle3DList;
+    typedef CParticleFilterData<CPose2D,psValue>::CParticleList CParticle2DList;
+    typedef CParticleFilterData<CPose3D,psValue>::CParticleList CParticle3DList;
 } }
 
 // CParticleFilter